@@ -1168,6 +1168,37 @@ class Workbook:
         - Output is generated from the in-memory workbook model; original XLSX styling
           and package metadata are not preserved by the Python binding.
         """
+    @classmethod
+    def open_snapshot(cls, path: builtins.str, *, mode: typing.Optional[WorkbookMode] = None, config: typing.Optional[WorkbookConfig] = None, span_evaluation: typing.Optional[builtins.bool] = None) -> Workbook:
+        r"""
+        Class method: open a workbook from a snapshot written by `save_snapshot`.
+        
+        Cell data is memory-mapped from the file rather than parsed, so opening a large
+        snapshot is much faster than reloading the original XLSX.
+        
+        Args:
+            path: Path to the snapshot file.
+            mode/config: Optional workbook configuration. The snapshot's date system
+                takes precedence over the configured one.
+        
+        Example:
+        ```python
+            import formualizer as fz
+        
+            wb = fz.Workbook.load_path("model.xlsx")
+            wb.save_snapshot("model.fzsnap")
+            wb = fz.Workbook.open_snapshot("model.fzsnap")
+        ```
+        """
+    def save_snapshot(self, path: builtins.str) -> None:
+        r"""
+        Save the workbook to a snapshot file that `Workbook.open_snapshot` can reopen.
+        
+        Notes:
+        - Snapshots hold values, formulas and defined names; tables, hidden rows and
+          custom functions are not included.
+        - The format is specific to this version of formualizer and is not an XLSX file.
+        """
     def add_sheet(self, name: builtins.str) -> None:
         r"""
         Add a sheet to the workbook.
@@ -397,6 +397,75 @@ impl PyWorkbook {
         }
     }
 
+    /// Class method: open a workbook from a snapshot written by `save_snapshot`.
+    ///
+    /// Cell data is memory-mapped from the file rather than parsed, so opening a large
+    /// snapshot is much faster than reloading the original XLSX.
+    ///
+    /// Args:
+    ///     path: Path to the snapshot file.
+    ///     mode/config: Optional workbook configuration. The snapshot's date system
+    ///         takes precedence over the configured one.
+    ///
+    /// Example:
+    /// ```python
+    ///     import formualizer as fz
+    ///
+    ///     wb = fz.Workbook.load_path("model.xlsx")
+    ///     wb.save_snapshot("model.fzsnap")
+    ///     wb = fz.Workbook.open_snapshot("model.fzsnap")
+    /// ```
+    #[classmethod]
+    #[pyo3(signature = (path, *, mode=None, config=None, span_evaluation=None))]
+    pub fn open_snapshot(
+        _cls: &Bound<'_, pyo3::types::PyType>,
+        path: &str,
+        mode: Option<PyWorkbookMode>,
+        config: Option<PyWorkbookConfig>,
+        span_evaluation: Option<bool>,
+    ) -> PyResult<Self> {
+        let cfg = resolve_workbook_config(mode, config, span_evaluation)?;
+        #[cfg(target_os = "emscripten")]
+        {
+            let _ = (path, cfg);
+            Err(PyErr::new::<pyo3::exceptions::PyNotImplementedError, _>(
+                "workbook snapshots are unavailable in the Pyodide build",
+            ))
+        }
+        #[cfg(not(target_os = "emscripten"))]
+        {
+            let wb = formualizer::workbook::Workbook::open_snapshot(path, cfg).map_err(|e| {
+                PyErr::new::<pyo3::exceptions::PyIOError, _>(format!("open failed: {e}"))
+            })?;
+            Ok(Self::from_inner_workbook(wb))
+        }
+    }
+
+    /// Save the workbook to a snapshot file that `Workbook.open_snapshot` can reopen.
+    ///
+    /// Notes:
+    /// - Snapshots hold values, formulas and defined names; tables, hidden rows and
+    ///   custom functions are not included.
+    /// - The format is specific to this version of formualizer and is not an XLSX file.
+    pub fn save_snapshot(&self, path: &str) -> PyResult<()> {
+        #[cfg(target_os = "emscripten")]
+        {
+            let _ = path;
+            Err(PyErr::new::<pyo3::exceptions::PyNotImplementedError, _>(
+                "workbook snapshots are unavailable in the Pyodide build",
+            ))
+        }
+        #[cfg(not(target_os = "emscripten"))]
+        {
+            let wb = self.inner.read().map_err(|e| {
+                PyErr::new::<pyo3::exceptions::PyRuntimeError, _>(format!("lock: {e}"))
+            })?;
+            wb.save_snapshot(path).map_err(|e| {
+                PyErr::new::<pyo3::exceptions::PyIOError, _>(format!("save failed: {e}"))
+            })
+        }
+    }
+
     /// Add a sheet to the workbook.
     ///
     /// This is idempotent: adding an existing sheet name is a no-op.
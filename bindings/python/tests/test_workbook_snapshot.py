@@ -0,0 +1,29 @@
+import pytest
+
+import formualizer as fz
+
+
+def test_snapshot_round_trip(tmp_path):
+    wb = fz.Workbook()
+    wb.add_sheet("Sheet1")
+    wb.set_value("Sheet1", 1, 1, 21)
+    wb.set_value("Sheet1", 2, 1, "label")
+    wb.set_formula("Sheet1", 1, 2, "=A1*2")
+
+    path = tmp_path / "book.fzsnap"
+    wb.save_snapshot(str(path))
+
+    opened = fz.Workbook.open_snapshot(str(path))
+    assert opened.sheet_names == ["Sheet1"]
+    assert opened.evaluate_cell("Sheet1", 1, 2) == 42.0
+    assert opened.evaluate_cell("Sheet1", 2, 1) == "label"
+
+    opened.set_value("Sheet1", 1, 1, 5)
+    assert opened.evaluate_cell("Sheet1", 1, 2) == 10.0
+
+
+def test_open_snapshot_rejects_other_files(tmp_path):
+    path = tmp_path / "not-a-snapshot.fzsnap"
+    path.write_bytes(b"this is not a formualizer snapshot")
+    with pytest.raises(IOError):
+        fz.Workbook.open_snapshot(str(path))
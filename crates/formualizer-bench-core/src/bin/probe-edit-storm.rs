@@ -15,7 +15,10 @@
 //!   (a) per-cell loop:  K × `wb.set_value(...)`        (edit_ms)
 //!   (b) batch:          one  `wb.set_values(...)` call (edit_ms)
 //! plus the recalc after each edit storm, with value self-checks (rollup
-//! root and chain tail must reflect the new inputs).
+//! root and chain tail must reflect the new inputs). The per-cell arm also
+//! reports p50/p99/max single-edit latency, where inline overlay compaction
+//! shows up as a tail; `--background-compaction` defers it to evaluation
+//! boundaries (`EvalConfig::background_overlay_compaction`).
 //!
 //! Run (release):
 //! ```bash
@@ -70,6 +73,10 @@ struct Cli {
     #[arg(long, default_value_t = false)]
     skip_per_cell: bool,
 
+    /// Compact overlays between evaluation passes instead of on the edit path.
+    #[arg(long, default_value_t = false)]
+    background_compaction: bool,
+
     #[arg(long, default_value = "phase-candidate")]
     label: String,
 }
@@ -101,6 +108,10 @@ struct ArmReport {
     initial_eval_ms: f64,
     /// Wall time of the edit storm itself (the measured quantity).
     edit_ms: f64,
+    /// Single-edit latency percentiles (per-cell arm only).
+    edit_p50_us: Option<f64>,
+    edit_p99_us: Option<f64>,
+    edit_max_us: Option<f64>,
     /// Wall time of the recalc that consumes the dirtied component.
     recalc_ms: f64,
     /// Root of the rollup tree after the edit recalc (must equal 2K).
@@ -223,15 +234,29 @@ fn check_fixture(wb: &Workbook, fx: &Fixture, input_value: f64) -> Result<(f64,
 }
 
 #[cfg(feature = "formualizer_runner")]
-fn make_workbook(changelog: bool) -> Workbook {
+fn make_workbook(changelog: bool, background_compaction: bool) -> Workbook {
     let mut config = WorkbookConfig::ephemeral();
     config.enable_changelog = changelog;
+    config.eval.background_overlay_compaction = background_compaction;
     Workbook::new_with_config(config)
 }
 
 #[cfg(feature = "formualizer_runner")]
-fn run_arm(k: usize, changelog: bool, arm: &'static str) -> Result<(ArmReport, usize)> {
-    let mut wb = make_workbook(changelog);
+/// Nearest-rank percentile of an ascending slice.
+#[cfg(feature = "formualizer_runner")]
+fn percentile(sorted: &[f64], p: f64) -> f64 {
+    let rank = ((p / 100.0) * sorted.len() as f64).ceil() as usize;
+    sorted[rank.clamp(1, sorted.len()) - 1]
+}
+
+#[cfg(feature = "formualizer_runner")]
+fn run_arm(
+    k: usize,
+    changelog: bool,
+    background_compaction: bool,
+    arm: &'static str,
+) -> Result<(ArmReport, usize)> {
+    let mut wb = make_workbook(changelog, background_compaction);
     let build_start = Instant::now();
     let fx = build_fixture(&mut wb, k)?;
     let build_ms = build_start.elapsed().as_secs_f64() * 1000.0;
@@ -243,12 +268,16 @@ fn run_arm(k: usize, changelog: bool, arm: &'static str) -> Result<(ArmReport, u
     check_fixture(&wb, &fx, 1.0)?;
 
     // Edit storm: rewrite every input to 2.
+    let mut edit_us: Vec<f64> = Vec::new();
     let edit_ms = match arm {
         "per_cell" => {
+            edit_us.reserve(k);
             let start = Instant::now();
             for r in 1..=k as u32 {
+                let edit_start = Instant::now();
                 wb.set_value(SHEET, r, 1, LiteralValue::Number(2.0))
                     .map_err(|e| anyhow::anyhow!("per-cell set_value: {e}"))?;
+                edit_us.push(edit_start.elapsed().as_secs_f64() * 1e6);
             }
             start.elapsed().as_secs_f64() * 1000.0
         }
@@ -269,12 +298,18 @@ fn run_arm(k: usize, changelog: bool, arm: &'static str) -> Result<(ArmReport, u
     let recalc_ms = recalc_start.elapsed().as_secs_f64() * 1000.0;
     let (root_after, chain_tail_after) = check_fixture(&wb, &fx, 2.0)?;
 
+    edit_us.sort_by(f64::total_cmp);
+    let edit_pct = |p: f64| (!edit_us.is_empty()).then(|| percentile(&edit_us, p));
+
     Ok((
         ArmReport {
             arm,
             build_ms,
             initial_eval_ms,
             edit_ms,
+            edit_p50_us: edit_pct(50.0),
+            edit_p99_us: edit_pct(99.0),
+            edit_max_us: edit_us.last().copied(),
             recalc_ms,
             root_after,
             chain_tail_after,
@@ -312,9 +347,13 @@ fn run_probe(cli: &Cli) -> Result<EditStormProbeReport> {
                 &["per_cell", "batch"]
             };
             for &arm in arm_names {
-                let (report, formulas) = run_arm(k, changelog, arm)?;
+                let (report, formulas) = run_arm(k, changelog, cli.background_compaction, arm)?;
+                let tail = match (report.edit_p99_us, report.edit_max_us) {
+                    (Some(p99), Some(max)) => format!(" [p99 {p99:.1} us, max {max:.1} us]"),
+                    _ => String::new(),
+                };
                 eprintln!(
-                    "[edit-storm] k={k} changelog={changelog} arm={arm}: edit {:.1} ms, recalc {:.1} ms (build {:.1} ms, initial eval {:.1} ms)",
+                    "[edit-storm] k={k} changelog={changelog} arm={arm}: edit {:.1} ms{tail}, recalc {:.1} ms (build {:.1} ms, initial eval {:.1} ms)",
                     report.edit_ms, report.recalc_ms, report.build_ms, report.initial_eval_ms
                 );
                 component_formulas = formulas;
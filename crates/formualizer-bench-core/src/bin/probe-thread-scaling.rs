@@ -0,0 +1,214 @@
+//! Thread-scaling probe for parallel layer evaluation and NUMA placement.
+//!
+//! Builds `--sheets` sheets of `--rows` independent formula rows (one wide
+//! layer per sheet, each cell summing a short window of its sheet's inputs)
+//! and measures a cold `evaluate_all` plus `--recalcs` full-edit recalcs at
+//! every thread count from 1 to `--max-threads`, under each requested
+//! `ThreadPlacement`. Reports per-point timings, speedup over the 1-thread
+//! point of the same placement, and parallel efficiency.
+//!
+//! Run (release):
+//! ```bash
+//! cargo run --release -p formualizer-bench-core --features formualizer_runner \
+//!   --bin probe-thread-scaling -- --rows 50000 --sheets 4
+//! cargo run --release -p formualizer-bench-core --features formualizer_runner \
+//!   --bin probe-thread-scaling -- --placement unpinned --placement per-node
+//! ```
+
+#[cfg(feature = "formualizer_runner")]
+use std::time::Instant;
+
+#[cfg(feature = "formualizer_runner")]
+use anyhow::Result;
+#[cfg(feature = "formualizer_runner")]
+use clap::{Parser, ValueEnum};
+#[cfg(feature = "formualizer_runner")]
+use formualizer_eval::engine::{EvalConfig, NumaTopology, ThreadPlacement};
+#[cfg(feature = "formualizer_runner")]
+use formualizer_workbook::{LiteralValue, Workbook, WorkbookConfig};
+#[cfg(feature = "formualizer_runner")]
+use serde::Serialize;
+
+#[cfg(not(feature = "formualizer_runner"))]
+fn main() {
+    eprintln!(
+        "This binary requires feature `formualizer_runner`: cargo run -p formualizer-bench-core --features formualizer_runner --bin probe-thread-scaling -- ..."
+    );
+    std::process::exit(2);
+}
+
+#[cfg(feature = "formualizer_runner")]
+fn main() -> Result<()> {
+    let cli = Cli::parse();
+    let report = run_probe(&cli)?;
+    println!("{}", serde_json::to_string(&report)?);
+    Ok(())
+}
+
+#[cfg(feature = "formualizer_runner")]
+#[derive(Debug, Clone, Copy, PartialEq, Eq, ValueEnum)]
+enum Placement {
+    Unpinned,
+    Pinned,
+    PerNode,
+}
+
+#[cfg(feature = "formualizer_runner")]
+impl Placement {
+    fn thread_placement(self) -> ThreadPlacement {
+        match self {
+            Placement::Unpinned => ThreadPlacement::Unpinned,
+            Placement::Pinned => ThreadPlacement::Pinned,
+            Placement::PerNode => ThreadPlacement::PerNode,
+        }
+    }
+}
+
+#[cfg(feature = "formualizer_runner")]
+#[derive(Debug, Parser)]
+#[command(about = "Parallel layer evaluation thread-scaling probe (1..N threads per placement)")]
+struct Cli {
+    /// Formula rows per sheet.
+    #[arg(long, default_value_t = 20_000)]
+    rows: u32,
+    /// Number of sheets (each gets its own NUMA base node under per-node).
+    #[arg(long, default_value_t = 2)]
+    sheets: u32,
+    /// Input window summed by each formula.
+    #[arg(long, default_value_t = 16)]
+    window: u32,
+    /// Highest thread count; defaults to the detected CPU count.
+    #[arg(long)]
+    max_threads: Option<usize>,
+    /// Full-edit recalcs timed after the cold evaluation.
+    #[arg(long, default_value_t = 3)]
+    recalcs: u32,
+    /// Placements to measure (repeatable).
+    #[arg(long, value_enum, default_values_t = [Placement::Unpinned, Placement::PerNode])]
+    placement: Vec<Placement>,
+}
+
+#[cfg(feature = "formualizer_runner")]
+#[derive(Debug, Serialize)]
+struct ScalingPoint {
+    threads: usize,
+    eval_cold_ms: f64,
+    recalc_ms_avg: f64,
+    speedup: f64,
+    efficiency: f64,
+}
+
+#[cfg(feature = "formualizer_runner")]
+#[derive(Debug, Serialize)]
+struct PlacementReport {
+    placement: String,
+    points: Vec<ScalingPoint>,
+}
+
+#[cfg(feature = "formualizer_runner")]
+#[derive(Debug, Serialize)]
+struct ProbeReport {
+    rows: u32,
+    sheets: u32,
+    window: u32,
+    numa_nodes: usize,
+    cpus: usize,
+    placements: Vec<PlacementReport>,
+}
+
+#[cfg(feature = "formualizer_runner")]
+fn sheet_name(idx: u32) -> String {
+    format!("Sheet{}", idx + 1)
+}
+
+#[cfg(feature = "formualizer_runner")]
+fn build_workbook(cli: &Cli, threads: usize, placement: Placement) -> Result<Workbook> {
+    let mut config = WorkbookConfig::ephemeral();
+    config.eval = EvalConfig::default()
+        .with_parallel(threads > 1)
+        .with_thread_placement(placement.thread_placement());
+    config.eval.max_threads = Some(threads);
+    let mut wb = Workbook::new_with_config(config);
+    let last = cli.rows + cli.window;
+    for s in 0..cli.sheets {
+        let sheet = sheet_name(s);
+        if s > 0 {
+            wb.add_sheet(&sheet)?;
+        }
+        for r in 1..=last {
+            wb.set_value(&sheet, r, 1, LiteralValue::Number(f64::from(r)))?;
+        }
+        for r in 1..=cli.rows {
+            let end = r + cli.window - 1;
+            wb.set_formula(&sheet, r, 2, &format!("=SUM(A{r}:A{end})*SQRT(A{r})"))?;
+        }
+    }
+    Ok(wb)
+}
+
+#[cfg(feature = "formualizer_runner")]
+fn measure(cli: &Cli, threads: usize, placement: Placement) -> Result<(f64, f64)> {
+    let mut wb = build_workbook(cli, threads, placement)?;
+    let cold = Instant::now();
+    wb.evaluate_all()?;
+    let eval_cold_ms = cold.elapsed().as_secs_f64() * 1000.0;
+
+    let mut recalc_total = 0.0;
+    for round in 0..cli.recalcs {
+        // Bump every input so each recalc re-dirties every formula row.
+        for s in 0..cli.sheets {
+            let sheet = sheet_name(s);
+            for r in 1..=cli.rows + cli.window {
+                let v = f64::from(r) + f64::from(round + 1);
+                wb.set_value(&sheet, r, 1, LiteralValue::Number(v))?;
+            }
+        }
+        let start = Instant::now();
+        wb.evaluate_all()?;
+        recalc_total += start.elapsed().as_secs_f64() * 1000.0;
+    }
+    let recalc_ms_avg = if cli.recalcs == 0 {
+        0.0
+    } else {
+        recalc_total / f64::from(cli.recalcs)
+    };
+    Ok((eval_cold_ms, recalc_ms_avg))
+}
+
+#[cfg(feature = "formualizer_runner")]
+fn run_probe(cli: &Cli) -> Result<ProbeReport> {
+    let topology = NumaTopology::detect();
+    let max_threads = cli.max_threads.unwrap_or(topology.cpu_count()).max(1);
+    let mut placements = Vec::new();
+    for &placement in &cli.placement {
+        let mut points: Vec<ScalingPoint> = Vec::new();
+        for threads in 1..=max_threads {
+            let (eval_cold_ms, recalc_ms_avg) = measure(cli, threads, placement)?;
+            let baseline = points.first().map_or(eval_cold_ms, |p| p.eval_cold_ms);
+            let speedup = if eval_cold_ms > 0.0 {
+                baseline / eval_cold_ms
+            } else {
+                0.0
+            };
+            points.push(ScalingPoint {
+                threads,
+                eval_cold_ms,
+                recalc_ms_avg,
+                speedup,
+                efficiency: speedup / threads as f64,
+            });
+        }
+        placements.push(PlacementReport {
+            placement: format!("{placement:?}"),
+            points,
+        });
+    }
+    Ok(ProbeReport {
+        rows: cli.rows,
+        sheets: cli.sheets,
+        window: cli.window,
+        numa_nodes: topology.node_count(),
+        cpus: topology.cpu_count(),
+        placements,
+    })
+}
@@ -142,6 +142,74 @@ pub unsafe extern "C" fn fz_workbook_open_xlsx_with_span_evaluation(
     fz_workbook_h(Box::into_raw(opaque) as *mut std::ffi::c_void)
 }
 
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn fz_workbook_open_snapshot(
+    path: *const c_char,
+    status: *mut fz_status,
+) -> fz_workbook_h {
+    if path.is_null() {
+        if !status.is_null() {
+            unsafe {
+                *status = fz_status::error("invalid arguments".to_string());
+            }
+        }
+        return fz_workbook_h(ptr::null_mut());
+    }
+
+    let path_str = unsafe { CStr::from_ptr(path).to_string_lossy() };
+    let wb = match Workbook::open_snapshot(path_str.as_ref(), WorkbookConfig::interactive()) {
+        Ok(wb) => wb,
+        Err(e) => {
+            if !status.is_null() {
+                unsafe {
+                    *status = fz_status::error(e.to_string());
+                }
+            }
+            return fz_workbook_h(ptr::null_mut());
+        }
+    };
+
+    let opaque = Box::new(OpaqueWorkbook(Arc::new(RwLock::new(wb))));
+    if !status.is_null() {
+        unsafe {
+            *status = fz_status::ok();
+        }
+    }
+    fz_workbook_h(Box::into_raw(opaque) as *mut std::ffi::c_void)
+}
+
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn fz_workbook_save_snapshot(
+    wb: fz_workbook_h,
+    path: *const c_char,
+    status: *mut fz_status,
+) {
+    if wb.0.is_null() || path.is_null() {
+        if !status.is_null() {
+            unsafe {
+                *status = fz_status::error("invalid arguments".to_string());
+            }
+        }
+        return;
+    }
+
+    let opaque = unsafe { &*(wb.0 as *mut OpaqueWorkbook) };
+    let path_str = unsafe { CStr::from_ptr(path).to_string_lossy() };
+
+    let wb_lock = opaque.0.read().unwrap();
+    if let Err(e) = wb_lock.save_snapshot(path_str.as_ref()) {
+        if !status.is_null() {
+            unsafe {
+                *status = fz_status::error(e.to_string());
+            }
+        }
+    } else if !status.is_null() {
+        unsafe {
+            *status = fz_status::ok();
+        }
+    }
+}
+
 #[unsafe(no_mangle)]
 pub unsafe extern "C" fn fz_workbook_free(wb: fz_workbook_h) {
     if !wb.0.is_null() {
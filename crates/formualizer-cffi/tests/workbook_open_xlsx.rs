@@ -76,3 +76,63 @@ fn cffi_open_xlsx_update_evaluate() {
 
     unsafe { fz_workbook_free(wb) };
 }
+
+#[test]
+fn cffi_snapshot_round_trip() {
+    let tmp = tempfile::tempdir().expect("tempdir");
+    let path = tmp.path().join("cffi.fzsnap");
+    let path_c = CString::new(path.to_string_lossy().as_ref()).expect("cstr path");
+    let sheet = CString::new("Sheet1").unwrap();
+    let formula = CString::new("=A1*2").unwrap();
+    let value_json = "{\"Number\":21.0}";
+
+    let mut status = fz_status::ok();
+    unsafe {
+        let wb = fz_workbook_create(&mut status);
+        fz_workbook_add_sheet(wb, sheet.as_ptr(), &mut status);
+        fz_workbook_set_cell_value(
+            wb,
+            sheet.as_ptr(),
+            1,
+            1,
+            value_json.as_ptr(),
+            value_json.len(),
+            fz_encoding_format::FZ_ENCODING_JSON,
+            &mut status,
+        );
+        fz_workbook_set_cell_formula(wb, sheet.as_ptr(), 1, 2, formula.as_ptr(), &mut status);
+        fz_workbook_save_snapshot(wb, path_c.as_ptr(), &mut status);
+        assert_eq!(status.code, fz_status_code::FZ_STATUS_OK);
+        fz_workbook_free(wb);
+    }
+
+    let wb = unsafe { fz_workbook_open_snapshot(path_c.as_ptr(), &mut status) };
+    assert_eq!(status.code, fz_status_code::FZ_STATUS_OK);
+    assert!(!wb.0.is_null());
+
+    let eval_buffer =
+        unsafe { fz_workbook_evaluate_all(wb, fz_encoding_format::FZ_ENCODING_JSON, &mut status) };
+    assert_eq!(status.code, fz_status_code::FZ_STATUS_OK);
+    unsafe { fz_buffer_free(eval_buffer) };
+
+    let value_buffer = unsafe {
+        fz_workbook_get_cell_value(
+            wb,
+            sheet.as_ptr(),
+            1,
+            2,
+            fz_encoding_format::FZ_ENCODING_JSON,
+            &mut status,
+        )
+    };
+    assert_eq!(status.code, fz_status_code::FZ_STATUS_OK);
+    let bytes = unsafe { std::slice::from_raw_parts(value_buffer.data, value_buffer.len).to_vec() };
+    let value: LiteralValue = serde_json::from_slice(&bytes).expect("value json");
+    unsafe { fz_buffer_free(value_buffer) };
+    match value {
+        LiteralValue::Number(n) => assert!((n - 42.0).abs() < 1e-9),
+        other => panic!("expected number result, got {other:?}"),
+    }
+
+    unsafe { fz_workbook_free(wb) };
+}
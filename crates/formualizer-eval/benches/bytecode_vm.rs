@@ -0,0 +1,62 @@
+use criterion::{BenchmarkId, Criterion, criterion_group, criterion_main};
+use formualizer_common::LiteralValue;
+use formualizer_eval::engine::EvalConfig;
+use formualizer_eval::engine::eval::Engine;
+use formualizer_eval::test_workbook::TestWorkbook;
+
+const ROWS: u32 = 10_000;
+
+/// Small arithmetic-and-reference formulas, the shape the VM targets, plus a
+/// function-call row so resolved calls are measured too. Every row reads Z1,
+/// so one edit re-dirties the whole sheet.
+fn setup(vm: bool) -> Engine<TestWorkbook> {
+    let config = EvalConfig::default()
+        .with_parallel(false)
+        .with_bytecode_vm(vm);
+    let mut engine = Engine::new(TestWorkbook::default(), config);
+    engine
+        .set_cell_value("Sheet1", 1, 26, LiteralValue::Number(2.0))
+        .unwrap();
+    for r in 1..=ROWS {
+        engine
+            .set_cell_value("Sheet1", r, 1, LiteralValue::Number(f64::from(r)))
+            .unwrap();
+        engine
+            .set_cell_value("Sheet1", r, 2, LiteralValue::Number(f64::from(r % 7)))
+            .unwrap();
+        for (col, formula) in [
+            (3, format!("=A{r}*$Z$1+B{r}/4-1")),
+            (4, format!("=IF(C{r}>A{r},C{r}-A{r},-(A{r}-C{r}))^2")),
+            (5, format!("=ABS(D{r}-$Z$1)+MAX(A{r},B{r})")),
+        ] {
+            let ast = formualizer_parse::parse(&formula).unwrap();
+            engine.set_cell_formula("Sheet1", r, col, ast).unwrap();
+        }
+    }
+    engine.evaluate_all().unwrap();
+    engine
+}
+
+fn bench_recalc(c: &mut Criterion) {
+    let mut group = c.benchmark_group("arena_formula_recalc");
+    group.sample_size(20);
+    for (label, vm) in [("tree", false), ("bytecode_vm", true)] {
+        let mut engine = setup(vm);
+        let mut tick = 0.0;
+        group.bench_function(BenchmarkId::new(label, ROWS), |b| {
+            b.iter(|| {
+                // The single-cell edit is identical in both modes; the
+                // recalc of every row dominates.
+                tick += 1.0;
+                engine
+                    .set_cell_value("Sheet1", 1, 26, LiteralValue::Number(tick))
+                    .unwrap();
+                engine.evaluate_all().unwrap()
+            })
+        });
+    }
+    group.finish();
+}
+
+criterion_group!(benches, bench_recalc);
+criterion_main!(benches);
@@ -0,0 +1,86 @@
+use criterion::{BenchmarkId, Criterion, criterion_group, criterion_main};
+use formualizer_common::LiteralValue;
+use formualizer_eval::engine::EvalConfig;
+use formualizer_eval::engine::eval::Engine;
+use formualizer_eval::test_workbook::TestWorkbook;
+
+const ROWS: u32 = 5_000_000;
+const CHUNK_ROWS: usize = 32 * 1024;
+/// Rows per day, so one day's dates fill a contiguous block.
+const ROWS_PER_DAY: u32 = 2_000;
+const FIRST_DAY: f64 = 45_000.0;
+
+/// Data!A holds dates and Data!B amounts. With `partitioned` the dates ascend, so each
+/// chunk covers a narrow date window and zone maps skip nearly all of them; otherwise the
+/// same dates are scattered and every chunk spans the whole range.
+fn setup(partitioned: bool) -> Engine<TestWorkbook> {
+    let config = EvalConfig {
+        arrow_storage_enabled: true,
+        delta_overlay_enabled: true,
+        write_formula_overlay_enabled: true,
+        ..Default::default()
+    }
+    .with_parallel(false);
+    let mut engine = Engine::new(TestWorkbook::default(), config);
+    let days = ROWS / ROWS_PER_DAY;
+    {
+        let mut ab = engine.begin_bulk_ingest_arrow();
+        ab.add_sheet("Data", 2, CHUNK_ROWS);
+        for i in 0..ROWS {
+            let day = if partitioned {
+                i / ROWS_PER_DAY
+            } else {
+                i.wrapping_mul(2_654_435_761) % days
+            };
+            ab.append_row(
+                "Data",
+                &[
+                    LiteralValue::Number(FIRST_DAY + f64::from(day)),
+                    LiteralValue::Number(f64::from(i % 997)),
+                ],
+            )
+            .unwrap();
+        }
+        ab.finish().unwrap();
+    }
+    let end = ROWS;
+    engine
+        .set_cell_value("Sheet1", 1, 1, LiteralValue::Number(FIRST_DAY + 100.0))
+        .unwrap();
+    for (row, formula) in [
+        (
+            2,
+            format!("=SUMIFS(Data!B1:B{end},Data!A1:A{end},\">=\"&A1,Data!A1:A{end},\"<\"&(A1+7))"),
+        ),
+        (3, format!("=MAXIFS(Data!B1:B{end},Data!A1:A{end},A1)")),
+        (4, format!("=MATCH(A1,Data!A1:A{end},1)")),
+    ] {
+        let ast = formualizer_parse::parse(&formula).unwrap();
+        engine.set_cell_formula("Sheet1", row, 1, ast).unwrap();
+    }
+    engine.evaluate_all().unwrap();
+    engine
+}
+
+fn bench_date_window(c: &mut Criterion) {
+    let mut group = c.benchmark_group("zone_map_date_window");
+    group.sample_size(10);
+    for (label, partitioned) in [("partitioned", true), ("scattered", false)] {
+        let mut engine = setup(partitioned);
+        let mut day = 0.0;
+        group.bench_function(BenchmarkId::new(label, ROWS), |b| {
+            b.iter(|| {
+                // Move the window so every iteration recomputes all three formulas.
+                day = (day + 1.0) % 2_000.0;
+                engine
+                    .set_cell_value("Sheet1", 1, 1, LiteralValue::Number(FIRST_DAY + day))
+                    .unwrap();
+                engine.evaluate_all().unwrap()
+            })
+        });
+    }
+    group.finish();
+}
+
+criterion_group!(benches, bench_date_window);
+criterion_main!(benches);
@@ -0,0 +1,236 @@
+//! Cold chunk tier: spill compacted base lanes to memory-mapped Arrow IPC files.
+//!
+//! Reference sheets are often loaded in full but read by a handful of lookups. When the
+//! heap bytes held by base lanes exceed `RetainedResourceBudget::resident_chunk_bytes`,
+//! [`spill_cold_chunks`] writes the least recently read chunks that have no overlay
+//! entries to a temporary IPC file, maps it read-only, and swaps each chunk's lanes for
+//! zero-copy arrays over the mapping. Readers see the same arrays; the OS pages them in
+//! and out. The file is removed once the last array over it is dropped, and rewriting a
+//! chunk's lanes (compaction, structural edits) makes it heap-resident again.
+
+use super::{ColumnChunk, SheetStore};
+
+/// Outcome of the last residency check plus running totals.
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct ColdTierStats {
+    /// Heap bytes of base lanes after the last check.
+    pub resident_bytes: usize,
+    /// Chunks currently served from spill files.
+    pub cold_chunks: usize,
+    /// Chunks spilled since the engine was created.
+    pub spilled_chunks: u64,
+    /// Heap lane bytes released by those spills.
+    pub spilled_bytes: u64,
+    /// Spill attempts that failed; the chunks stayed on the heap.
+    pub spill_errors: u64,
+}
+
+/// Where a chunk lives inside a column.
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
+enum ChunkSlot {
+    Dense(usize),
+    Sparse(usize),
+}
+
+fn for_each_chunk(store: &SheetStore, mut f: impl FnMut((usize, usize, ChunkSlot), &ColumnChunk)) {
+    for (s, sheet) in store.sheets.iter().enumerate() {
+        for (c, column) in sheet.columns.iter().enumerate() {
+            for (i, ch) in column.chunks.iter().enumerate() {
+                f((s, c, ChunkSlot::Dense(i)), ch);
+            }
+            for (&i, ch) in &column.sparse_chunks {
+                f((s, c, ChunkSlot::Sparse(i)), ch);
+            }
+        }
+    }
+}
+
+/// A chunk can be spilled when its base lanes are its whole content.
+fn spillable(ch: &ColumnChunk) -> bool {
+    !ch.is_cold()
+        && !ch.is_empty()
+        && ch.runs.is_none()
+        && ch.overlay.is_empty()
+        && ch.computed_overlay.is_empty()
+}
+
+/// Spill the least recently read spillable chunks until base lanes fit `resident_limit`
+/// heap bytes, updating `stats`. Chunks read in epoch `protected_since` or later are
+/// never spilled.
+pub(crate) fn spill_cold_chunks(
+    store: &mut SheetStore,
+    resident_limit: usize,
+    protected_since: u64,
+    stats: &mut ColdTierStats,
+) {
+    let mut resident = 0usize;
+    let mut cold = 0usize;
+    let mut candidates = Vec::new();
+    for_each_chunk(store, |key, ch| {
+        let bytes = ch.resident_lane_bytes();
+        resident = resident.saturating_add(bytes);
+        cold += usize::from(ch.is_cold());
+        if spillable(ch) && ch.last_access_epoch() < protected_since {
+            candidates.push((ch.last_access_epoch(), bytes, key));
+        }
+    });
+    stats.resident_bytes = resident;
+    stats.cold_chunks = cold;
+    if resident <= resident_limit || candidates.is_empty() {
+        return;
+    }
+
+    candidates
+        .sort_by_key(|&(epoch, bytes, key)| (epoch, std::cmp::Reverse(bytes), key_order(key)));
+    let mut picked = rustc_hash::FxHashSet::default();
+    let mut remaining = resident;
+    for (_, bytes, key) in candidates {
+        if remaining <= resident_limit {
+            break;
+        }
+        remaining = remaining.saturating_sub(bytes);
+        picked.insert(key);
+    }
+
+    let mut chunks: Vec<&mut ColumnChunk> = Vec::with_capacity(picked.len());
+    for (s, sheet) in store.sheets.iter_mut().enumerate() {
+        for (c, column) in sheet.columns.iter_mut().enumerate() {
+            for (i, ch) in column.chunks.iter_mut().enumerate() {
+                if picked.contains(&(s, c, ChunkSlot::Dense(i))) {
+                    chunks.push(ch);
+                }
+            }
+            for (&i, ch) in column.sparse_chunks.iter_mut() {
+                if picked.contains(&(s, c, ChunkSlot::Sparse(i))) {
+                    chunks.push(ch);
+                }
+            }
+        }
+    }
+    let outcome = spill(chunks);
+    stats.spilled_chunks = stats.spilled_chunks.saturating_add(outcome.chunks as u64);
+    stats.spilled_bytes = stats.spilled_bytes.saturating_add(outcome.freed as u64);
+    stats.spill_errors = stats.spill_errors.saturating_add(outcome.errors as u64);
+    stats.resident_bytes = resident.saturating_sub(outcome.freed);
+    stats.cold_chunks += outcome.chunks;
+}
+
+/// Result of one [`spill`] call.
+#[derive(Debug, Default)]
+pub(crate) struct SpillOutcome {
+    /// Chunks now served from a spill file.
+    pub(crate) chunks: usize,
+    /// Heap lane bytes those chunks released.
+    pub(crate) freed: usize,
+    /// Spill files that could not be written or mapped; their chunks stay on the heap.
+    pub(crate) errors: usize,
+}
+
+fn key_order((s, c, slot): (usize, usize, ChunkSlot)) -> (usize, usize, usize) {
+    match slot {
+        ChunkSlot::Dense(i) | ChunkSlot::Sparse(i) => (s, c, i),
+    }
+}
+
+#[cfg(not(target_arch = "wasm32"))]
+pub(crate) use native::spill;
+
+/// Without a file system there is nothing to spill to; chunks stay on the heap.
+#[cfg(target_arch = "wasm32")]
+pub(crate) fn spill(chunks: Vec<&mut ColumnChunk>) -> SpillOutcome {
+    SpillOutcome {
+        errors: usize::from(!chunks.is_empty()),
+        ..SpillOutcome::default()
+    }
+}
+
+#[cfg(not(target_arch = "wasm32"))]
+mod native {
+    use std::fs::{File, OpenOptions};
+    use std::path::PathBuf;
+    use std::sync::atomic::{AtomicU64, Ordering};
+
+    use rustc_hash::FxHashMap;
+
+    use super::{ColumnChunk, SpillOutcome};
+    use crate::arrow_store::ipc::{self, DecodedLanes, LaneLayout, MappedFile};
+
+    static NEXT_SEGMENT: AtomicU64 = AtomicU64::new(0);
+
+    fn create_spill_file() -> std::io::Result<(File, PathBuf)> {
+        for _ in 0..32 {
+            let path = std::env::temp_dir().join(format!(
+                "formualizer-cold-{}-{}.arrow",
+                std::process::id(),
+                NEXT_SEGMENT.fetch_add(1, Ordering::Relaxed)
+            ));
+            match OpenOptions::new()
+                .read(true)
+                .write(true)
+                .create_new(true)
+                .open(&path)
+            {
+                Ok(file) => return Ok((file, path)),
+                Err(error) if error.kind() == std::io::ErrorKind::AlreadyExists => continue,
+                Err(error) => return Err(error),
+            }
+        }
+        Err(std::io::Error::new(
+            std::io::ErrorKind::AlreadyExists,
+            "could not allocate unique cold chunk spill file",
+        ))
+    }
+
+    /// Write the chunks' lanes to spill files (one per lane layout), map them, and swap
+    /// in the mapped arrays.
+    pub(crate) fn spill(chunks: Vec<&mut ColumnChunk>) -> SpillOutcome {
+        let mut groups: FxHashMap<LaneLayout, Vec<&mut ColumnChunk>> = FxHashMap::default();
+        for ch in chunks {
+            groups.entry(LaneLayout::of(ch)).or_default().push(ch);
+        }
+        let mut outcome = SpillOutcome::default();
+        for (layout, group) in groups {
+            let count = group.len();
+            match spill_group(&layout, group) {
+                Ok(freed) => {
+                    outcome.chunks += count;
+                    outcome.freed = outcome.freed.saturating_add(freed);
+                }
+                Err(_) => outcome.errors += 1,
+            }
+        }
+        outcome
+    }
+
+    /// Spill one lane layout's chunks to a single file, removed once the last array over
+    /// it is dropped. Lanes are only swapped once the whole file decodes, so a failure
+    /// leaves every chunk as it was.
+    fn spill_group(layout: &LaneLayout, group: Vec<&mut ColumnChunk>) -> std::io::Result<usize> {
+        let (file, path) = create_spill_file()?;
+        let file = match ipc::write_lane_file(file, layout, group.iter().map(|ch| &**ch)) {
+            Ok(file) => file,
+            Err(error) => {
+                let _ = std::fs::remove_file(&path);
+                return Err(error);
+            }
+        };
+        let mapped = MappedFile::map(&file, Some(path))?;
+        drop(file);
+        let batches = ipc::read_lane_file(&mapped.buffer()?)?;
+        drop(mapped);
+        if batches.len() != group.len() {
+            return Err(ipc::io_error("spill file batch count mismatch"));
+        }
+
+        let mut decoded = Vec::with_capacity(batches.len());
+        for batch in &batches {
+            decoded.push(DecodedLanes::from_batch(layout, batch)?);
+        }
+        let mut freed = 0usize;
+        for (ch, lanes) in group.into_iter().zip(decoded) {
+            freed = freed.saturating_add(ch.resident_lane_bytes());
+            lanes.install(ch);
+        }
+        Ok(freed)
+    }
+}
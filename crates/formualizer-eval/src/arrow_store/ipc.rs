@@ -0,0 +1,303 @@
+//! Arrow IPC files of chunk base lanes, read back zero-copy from a memory mapping.
+//!
+//! Shared by the cold tier (`cold`) and workbook snapshots (`snapshot`). Chunks with the
+//! same [`LaneLayout`] are written as consecutive record batches of one IPC file; reading
+//! decodes every batch over a [`MappedFile`] buffer, so the resulting arrays point into
+//! the mapping and keep it alive.
+
+use std::fs::File;
+use std::io::Write;
+use std::path::PathBuf;
+use std::ptr::NonNull;
+use std::sync::Arc;
+
+use arrow::buffer::Buffer;
+use arrow::ipc::convert::fb_to_schema;
+use arrow::ipc::reader::{FileDecoder, read_footer_length};
+use arrow::ipc::root_as_footer;
+use arrow::ipc::writer::FileWriter;
+use arrow::record_batch::RecordBatch;
+use arrow_array::{Array, ArrayRef, BooleanArray, Float64Array, UInt8Array, UInt32Array};
+use arrow_schema::{DataType, Field, Schema};
+use once_cell::sync::OnceCell;
+
+use super::{
+    ColumnChunk, ColumnChunkMeta, Overlay, TextDictionary, TypeTag, uniform_tags, uniform_type_tag,
+};
+
+pub(super) fn io_error(e: impl std::fmt::Display) -> std::io::Error {
+    std::io::Error::new(std::io::ErrorKind::InvalidData, e.to_string())
+}
+
+/// A read-only mapping of a whole file. Arrays decoded from it hold it alive.
+pub(super) struct MappedFile {
+    map: Option<memmap2::Mmap>,
+    /// Removed once the mapping is dropped (spill files); `None` for files the caller owns.
+    remove: Option<PathBuf>,
+}
+
+impl MappedFile {
+    /// Map `file` read-only.
+    ///
+    /// The file must not be truncated or rewritten in place while the mapping lives;
+    /// spill files are private to the process and snapshots are replaced by rename.
+    pub(super) fn map(file: &File, remove: Option<PathBuf>) -> std::io::Result<Arc<Self>> {
+        // SAFETY: see above; the mapping is never written through.
+        match unsafe { memmap2::Mmap::map(file) } {
+            Ok(map) => Ok(Arc::new(Self {
+                map: Some(map),
+                remove,
+            })),
+            Err(error) => {
+                if let Some(path) = &remove {
+                    let _ = std::fs::remove_file(path);
+                }
+                Err(error)
+            }
+        }
+    }
+
+    /// The whole mapping as an Arrow buffer that keeps `self` alive.
+    pub(super) fn buffer(self: &Arc<Self>) -> std::io::Result<Buffer> {
+        let map = self.map.as_ref().expect("file is mapped");
+        let ptr = NonNull::new(map.as_ptr() as *mut u8).ok_or_else(|| io_error("empty map"))?;
+        // SAFETY: `ptr..ptr + len` is the live mapping owned by `self`, which the buffer
+        // keeps alive; the mapping is read-only and never mutated.
+        Ok(unsafe { Buffer::from_custom_allocation(ptr, map.len(), self.clone()) })
+    }
+}
+
+impl Drop for MappedFile {
+    fn drop(&mut self) {
+        // Unmap first: some platforms refuse to remove a mapped file.
+        drop(self.map.take());
+        if let Some(path) = &self.remove {
+            let _ = std::fs::remove_file(path);
+        }
+    }
+}
+
+/// The lanes a chunk carries, in schema order after the type tags.
+fn chunk_lanes(ch: &ColumnChunk) -> Vec<ArrayRef> {
+    let mut out: Vec<ArrayRef> = vec![ch.type_tag.clone()];
+    out.extend(ch.numbers.clone().map(|a| a as ArrayRef));
+    out.extend(ch.booleans.clone().map(|a| a as ArrayRef));
+    out.extend(ch.text.clone());
+    out.extend(ch.text_codes.clone().map(|a| a as ArrayRef));
+    out.extend(ch.errors.clone().map(|a| a as ArrayRef));
+    out
+}
+
+/// Which lanes a dense chunk carries; chunks written to one IPC file share it.
+#[derive(Clone, Debug, PartialEq, Eq, Hash)]
+pub(super) struct LaneLayout {
+    numbers: bool,
+    booleans: bool,
+    text: Option<DataType>,
+    text_codes: bool,
+    errors: bool,
+}
+
+impl LaneLayout {
+    pub(super) fn of(ch: &ColumnChunk) -> Self {
+        Self {
+            numbers: ch.numbers.is_some(),
+            booleans: ch.booleans.is_some(),
+            text: ch.text.as_ref().map(|t| t.data_type().clone()),
+            text_codes: ch.text_codes.is_some(),
+            errors: ch.errors.is_some(),
+        }
+    }
+
+    /// Layout of a batch written by [`write_lane_file`], from its field names.
+    pub(super) fn of_batch(batch: &RecordBatch) -> Self {
+        let schema = batch.schema();
+        let field = |name: &str| {
+            schema
+                .field_with_name(name)
+                .ok()
+                .map(|f| f.data_type().clone())
+        };
+        Self {
+            numbers: field("numbers").is_some(),
+            booleans: field("booleans").is_some(),
+            text: field("text"),
+            text_codes: field("text_codes").is_some(),
+            errors: field("errors").is_some(),
+        }
+    }
+
+    fn schema(&self) -> Schema {
+        let mut fields = vec![Field::new("type_tag", DataType::UInt8, true)];
+        if self.numbers {
+            fields.push(Field::new("numbers", DataType::Float64, true));
+        }
+        if self.booleans {
+            fields.push(Field::new("booleans", DataType::Boolean, true));
+        }
+        if let Some(dt) = &self.text {
+            fields.push(Field::new("text", dt.clone(), true));
+        }
+        if self.text_codes {
+            fields.push(Field::new("text_codes", DataType::UInt32, true));
+        }
+        if self.errors {
+            fields.push(Field::new("errors", DataType::UInt8, true));
+        }
+        Schema::new(fields)
+    }
+}
+
+/// Write `chunks` (all of `layout`) to `out` as one IPC file, one record batch per chunk.
+pub(super) fn write_lane_file<'a, W: Write>(
+    out: W,
+    layout: &LaneLayout,
+    chunks: impl IntoIterator<Item = &'a ColumnChunk>,
+) -> std::io::Result<W> {
+    let schema = Arc::new(layout.schema());
+    let mut writer = FileWriter::try_new(out, &schema).map_err(io_error)?;
+    for ch in chunks {
+        let batch = RecordBatch::try_new(schema.clone(), chunk_lanes(ch)).map_err(io_error)?;
+        writer.write(&batch).map_err(io_error)?;
+    }
+    writer.into_inner().map_err(io_error)
+}
+
+/// Zero-copy decode of every record batch of the IPC file held in `buffer`.
+pub(super) fn read_lane_file(buffer: &Buffer) -> std::io::Result<Vec<RecordBatch>> {
+    let trailer_start = buffer
+        .len()
+        .checked_sub(10)
+        .ok_or_else(|| io_error("lane file too short"))?;
+    let trailer: [u8; 10] = buffer[trailer_start..].try_into().map_err(io_error)?;
+    let footer_len = read_footer_length(trailer).map_err(io_error)?;
+    let footer_start = trailer_start
+        .checked_sub(footer_len)
+        .ok_or_else(|| io_error("lane file footer out of range"))?;
+    let footer = root_as_footer(&buffer[footer_start..trailer_start]).map_err(io_error)?;
+    let schema = footer
+        .schema()
+        .ok_or_else(|| io_error("lane file has no schema"))?;
+    let decoder = FileDecoder::new(Arc::new(fb_to_schema(schema)), footer.version());
+
+    let mut out = Vec::new();
+    for block in footer.recordBatches().into_iter().flatten() {
+        let start = usize::try_from(block.offset()).map_err(io_error)?;
+        let len = block.bodyLength() as usize + block.metaDataLength() as usize;
+        if start.checked_add(len).is_none_or(|end| end > buffer.len()) {
+            return Err(io_error("lane file block out of range"));
+        }
+        let data = buffer.slice_with_length(start, len);
+        let batch = decoder
+            .read_record_batch(block, &data)
+            .map_err(io_error)?
+            .ok_or_else(|| io_error("missing lane batch"))?;
+        out.push(batch);
+    }
+    Ok(out)
+}
+
+fn column<T: Array + Clone + 'static>(batch: &RecordBatch, idx: usize) -> std::io::Result<Arc<T>> {
+    batch
+        .column(idx)
+        .as_any()
+        .downcast_ref::<T>()
+        .map(|a| Arc::new(a.clone()))
+        .ok_or_else(|| io_error("lane type mismatch"))
+}
+
+/// One chunk's lanes as decoded from a record batch.
+pub(super) struct DecodedLanes {
+    type_tag: Arc<UInt8Array>,
+    numbers: Option<Arc<Float64Array>>,
+    booleans: Option<Arc<BooleanArray>>,
+    text: Option<ArrayRef>,
+    text_codes: Option<Arc<UInt32Array>>,
+    errors: Option<Arc<UInt8Array>>,
+}
+
+impl DecodedLanes {
+    pub(super) fn from_batch(layout: &LaneLayout, batch: &RecordBatch) -> std::io::Result<Self> {
+        let mut idx = 0;
+        let mut next = || {
+            idx += 1;
+            idx
+        };
+        Ok(Self {
+            type_tag: column(batch, 0)?,
+            numbers: layout.numbers.then(|| column(batch, next())).transpose()?,
+            booleans: layout.booleans.then(|| column(batch, next())).transpose()?,
+            text: layout.text.as_ref().map(|_| batch.column(next()).clone()),
+            text_codes: layout
+                .text_codes
+                .then(|| column(batch, next()))
+                .transpose()?,
+            errors: layout.errors.then(|| column(batch, next())).transpose()?,
+        })
+    }
+
+    #[inline]
+    pub(super) fn len(&self) -> usize {
+        self.type_tag.len()
+    }
+
+    /// Use the shared lane for the tag of the first row; for chunks recorded as uniform.
+    pub(super) fn with_uniform_tags(mut self) -> Self {
+        if let Some(&tag) = self.type_tag.values().first() {
+            self.type_tag = Arc::new(uniform_tags(TypeTag::from_u8(tag), self.len()));
+        }
+        self
+    }
+
+    /// Swap these lanes in as `ch`'s base lanes and mark them as file-backed.
+    pub(super) fn install(self, ch: &mut ColumnChunk) {
+        // A shared uniform tag lane costs no heap and keeps the chunk recognisably uniform.
+        let tags = if uniform_type_tag(&ch.type_tag).is_some() {
+            ch.type_tag.clone()
+        } else {
+            self.type_tag
+        };
+        ch.cold_type_tag = Some(tags.clone());
+        ch.type_tag = tags;
+        ch.numbers = self.numbers;
+        ch.booleans = self.booleans;
+        ch.text = self.text;
+        ch.text_codes = self.text_codes;
+        ch.errors = self.errors;
+        // Derived caches would keep heap copies of the mapped lanes.
+        ch.lowered_text = OnceCell::new();
+        ch.decoded_text = OnceCell::new();
+    }
+
+    /// A file-backed chunk over these lanes with the given `meta`, and no overlay entries.
+    pub(super) fn into_chunk(
+        self,
+        meta: ColumnChunkMeta,
+        text_dict: Option<Arc<TextDictionary>>,
+    ) -> ColumnChunk {
+        let mut ch = ColumnChunk {
+            numbers: None,
+            booleans: None,
+            text: None,
+            text_codes: None,
+            text_dict,
+            errors: None,
+            type_tag: self.type_tag.clone(),
+            formula_id: None,
+            meta,
+            runs: None,
+            lazy_null_numbers: OnceCell::new(),
+            lazy_null_booleans: OnceCell::new(),
+            lazy_null_text: OnceCell::new(),
+            lazy_null_errors: OnceCell::new(),
+            lowered_text: OnceCell::new(),
+            decoded_text: OnceCell::new(),
+            overlay: Overlay::new(),
+            computed_overlay: Overlay::new(),
+            access: Default::default(),
+            cold_type_tag: None,
+        };
+        self.install(&mut ch);
+        ch
+    }
+}
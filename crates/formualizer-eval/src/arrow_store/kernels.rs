@@ -0,0 +1,682 @@
+//! Aggregate kernels over numeric lanes: masked sum, count, min/max and moments.
+//!
+//! Reductions hand these kernels a lane's `f64` values and a row mask: the lane's
+//! validity, less any rows an overlay replaces (those are folded in separately as a sparse
+//! correction). Values are consumed in blocks of 64 rows against one mask word, so a
+//! block with no selected rows costs one compare. Each call runs on the widest
+//! instruction set the CPU reports ([`SimdLevel::detect`]): AVX-512 with mask registers,
+//! AVX2 with lane masks expanded from the word, or a portable loop over eight
+//! accumulators that the compiler vectorises for the baseline target. Sums are
+//! reassociated across lanes, so results may differ between levels in the last bits.
+
+use std::iter::Zip;
+use std::slice::Chunks;
+use std::sync::OnceLock;
+
+use arrow_buffer::BooleanBuffer;
+use arrow_buffer::bit_chunk_iterator::BitChunkIterator;
+
+/// Rows per mask word.
+const BLOCK: usize = 64;
+
+/// Count, sum and centred second moment of a set of numbers.
+///
+/// Partial moments merge exactly (Chan et al.), so variance and DEVSQ take one pass over
+/// the data instead of a pass for the mean and another for the deviations.
+#[derive(Clone, Copy, Debug, Default, PartialEq)]
+pub struct Moments {
+    pub count: usize,
+    pub sum: f64,
+    mean: f64,
+    m2: f64,
+}
+
+impl Moments {
+    /// `count` copies of `value`.
+    pub fn repeated(value: f64, count: usize) -> Self {
+        if count == 0 {
+            return Self::default();
+        }
+        Self {
+            count,
+            sum: value * count as f64,
+            mean: value,
+            m2: 0.0,
+        }
+    }
+
+    #[inline]
+    pub fn push(&mut self, value: f64) {
+        self.merge(Self::repeated(value, 1));
+    }
+
+    pub fn merge(&mut self, other: Moments) {
+        if other.count == 0 {
+            return;
+        }
+        if self.count == 0 {
+            *self = other;
+            return;
+        }
+        let (na, nb) = (self.count as f64, other.count as f64);
+        let n = na + nb;
+        let delta = other.mean - self.mean;
+        self.m2 += other.m2 + delta * delta * (na * nb / n);
+        self.mean += delta * (nb / n);
+        self.count += other.count;
+        self.sum += other.sum;
+    }
+
+    /// Arithmetic mean; `None` for an empty set.
+    pub fn mean(&self) -> Option<f64> {
+        (self.count > 0).then(|| self.sum / self.count as f64)
+    }
+
+    /// Sum of squared deviations from the mean (DEVSQ).
+    #[inline]
+    pub fn devsq(&self) -> f64 {
+        self.m2
+    }
+
+    /// Population variance (divide by n); `None` for an empty set.
+    pub fn variance_population(&self) -> Option<f64> {
+        (self.count > 0).then(|| self.m2 / self.count as f64)
+    }
+
+    /// Sample variance (divide by n - 1); `None` below two values.
+    pub fn variance_sample(&self) -> Option<f64> {
+        (self.count > 1).then(|| self.m2 / (self.count - 1) as f64)
+    }
+}
+
+/// Instruction set the kernels run on, ordered from narrowest to widest.
+#[derive(Clone, Copy, Debug, PartialEq, Eq, PartialOrd, Ord)]
+pub enum SimdLevel {
+    Portable,
+    Avx2,
+    Avx512,
+}
+
+impl SimdLevel {
+    /// The widest level this CPU supports, detected once per process.
+    pub fn detect() -> Self {
+        static LEVEL: OnceLock<SimdLevel> = OnceLock::new();
+        *LEVEL.get_or_init(|| {
+            #[cfg(target_arch = "x86_64")]
+            {
+                if std::arch::is_x86_feature_detected!("avx512f") {
+                    return SimdLevel::Avx512;
+                }
+                if std::arch::is_x86_feature_detected!("avx2")
+                    && std::arch::is_x86_feature_detected!("fma")
+                {
+                    return SimdLevel::Avx2;
+                }
+            }
+            SimdLevel::Portable
+        })
+    }
+
+    /// `self`, lowered to what this CPU supports.
+    #[inline]
+    fn supported(self) -> Self {
+        self.min(Self::detect())
+    }
+
+    /// Sum and count of the rows of `values` set in `mask` (every row when `None`).
+    pub fn sum_count(self, values: &[f64], mask: Option<&BooleanBuffer>) -> (f64, usize) {
+        let count = mask.map_or(values.len(), BooleanBuffer::count_set_bits);
+        if count == 0 {
+            return (0.0, 0);
+        }
+        let blocks = blocks(values, mask);
+        let sum = match self.supported() {
+            // SAFETY (both arms): `supported` only returns levels the CPU reports.
+            #[cfg(target_arch = "x86_64")]
+            SimdLevel::Avx512 => unsafe { x86::sum_avx512(blocks) },
+            #[cfg(target_arch = "x86_64")]
+            SimdLevel::Avx2 => unsafe { x86::sum_avx2(blocks) },
+            _ => portable::sum(blocks),
+        };
+        (sum, count)
+    }
+
+    /// Smallest and largest of the rows of `values` set in `mask`; `None` when no row is.
+    pub fn min_max(self, values: &[f64], mask: Option<&BooleanBuffer>) -> Option<(f64, f64)> {
+        if mask.map_or(values.len(), BooleanBuffer::count_set_bits) == 0 {
+            return None;
+        }
+        let blocks = blocks(values, mask);
+        Some(match self.supported() {
+            // SAFETY (both arms): `supported` only returns levels the CPU reports.
+            #[cfg(target_arch = "x86_64")]
+            SimdLevel::Avx512 => unsafe { x86::min_max_avx512(blocks) },
+            #[cfg(target_arch = "x86_64")]
+            SimdLevel::Avx2 => unsafe { x86::min_max_avx2(blocks) },
+            _ => portable::min_max(blocks),
+        })
+    }
+
+    /// [`Moments`] of the rows of `values` set in `mask`.
+    pub fn moments(self, values: &[f64], mask: Option<&BooleanBuffer>) -> Moments {
+        let blocks = blocks(values, mask);
+        match self.supported() {
+            // SAFETY (both arms): `supported` only returns levels the CPU reports.
+            #[cfg(target_arch = "x86_64")]
+            SimdLevel::Avx512 => unsafe { x86::moments_avx512(blocks) },
+            #[cfg(target_arch = "x86_64")]
+            SimdLevel::Avx2 => unsafe { x86::moments_avx2(blocks) },
+            _ => portable::moments(blocks),
+        }
+    }
+}
+
+/// [`SimdLevel::sum_count`] at the detected level.
+#[inline]
+pub fn sum_count(values: &[f64], mask: Option<&BooleanBuffer>) -> (f64, usize) {
+    SimdLevel::detect().sum_count(values, mask)
+}
+
+/// [`SimdLevel::min_max`] at the detected level.
+#[inline]
+pub fn min_max(values: &[f64], mask: Option<&BooleanBuffer>) -> Option<(f64, f64)> {
+    SimdLevel::detect().min_max(values, mask)
+}
+
+/// [`SimdLevel::moments`] at the detected level.
+#[inline]
+pub fn moments(values: &[f64], mask: Option<&BooleanBuffer>) -> Moments {
+    SimdLevel::detect().moments(values, mask)
+}
+
+/// Mask words of 64 rows each, least significant bit first; all rows when there is no
+/// mask. Bits past the end of the mask are unset.
+enum MaskWords<'a> {
+    All,
+    Bits(BitChunkIterator<'a>, Option<u64>),
+}
+
+impl Iterator for MaskWords<'_> {
+    type Item = u64;
+
+    #[inline]
+    fn next(&mut self) -> Option<u64> {
+        match self {
+            MaskWords::All => Some(u64::MAX),
+            MaskWords::Bits(words, remainder) => words.next().or_else(|| remainder.take()),
+        }
+    }
+}
+
+/// Blocks of up to [`BLOCK`] values with their mask words; only the last may be shorter.
+type Blocks<'a> = Zip<Chunks<'a, f64>, MaskWords<'a>>;
+
+fn blocks<'a>(values: &'a [f64], mask: Option<&'a BooleanBuffer>) -> Blocks<'a> {
+    let words = match mask {
+        None => MaskWords::All,
+        Some(mask) => {
+            debug_assert_eq!(mask.len(), values.len());
+            let chunks = mask.inner().bit_chunks(mask.offset(), mask.len());
+            MaskWords::Bits(chunks.iter(), Some(chunks.remainder_bits()))
+        }
+    };
+    values.chunks(BLOCK).zip(words)
+}
+
+/// `word` restricted to the rows of a block of `len` rows.
+#[inline]
+fn block_word(len: usize, word: u64) -> u64 {
+    if len < BLOCK {
+        word & ((1u64 << len) - 1)
+    } else {
+        word
+    }
+}
+
+/// Moments of one block from its masked sum and the masked sum of squared deviations
+/// from the block mean.
+#[inline]
+fn block_moments(
+    block: &[f64],
+    word: u64,
+    sum: impl FnOnce() -> f64,
+    sq_dev: impl FnOnce(f64) -> f64,
+) -> Moments {
+    let count = block_word(block.len(), word).count_ones() as usize;
+    if count == 0 {
+        return Moments::default();
+    }
+    let sum = sum();
+    let mean = sum / count as f64;
+    Moments {
+        count,
+        sum,
+        mean,
+        m2: sq_dev(mean),
+    }
+}
+
+/// Scalar code the compiler vectorises for the build target; also finishes the short
+/// last block for the wider levels.
+mod portable {
+    use super::{Blocks, Moments, block_moments, block_word};
+
+    const LANES: usize = 8;
+
+    #[inline(always)]
+    fn pick(word: u64, i: usize, value: f64, otherwise: f64) -> f64 {
+        if word >> i & 1 != 0 { value } else { otherwise }
+    }
+
+    /// Per-lane fold of the selected rows of one block.
+    #[inline(always)]
+    fn fold_block(
+        block: &[f64],
+        word: u64,
+        acc: &mut [f64; LANES],
+        f: impl Fn(f64, f64, bool) -> f64,
+    ) {
+        let word = block_word(block.len(), word);
+        let lanes = block.chunks_exact(LANES);
+        let tail = lanes.remainder();
+        for (k, lane) in lanes.enumerate() {
+            for j in 0..LANES {
+                acc[j] = f(acc[j], lane[j], word >> (k * LANES + j) & 1 != 0);
+            }
+        }
+        let base = block.len() - tail.len();
+        for (j, &v) in tail.iter().enumerate() {
+            acc[j] = f(acc[j], v, word >> (base + j) & 1 != 0);
+        }
+    }
+
+    #[inline]
+    pub(super) fn sum_block(block: &[f64], word: u64) -> f64 {
+        let mut acc = [0.0; LANES];
+        fold_block(block, word, &mut acc, |a, v, on| {
+            a + if on { v } else { 0.0 }
+        });
+        acc.iter().sum()
+    }
+
+    #[inline]
+    pub(super) fn sq_dev_block(block: &[f64], word: u64, mean: f64) -> f64 {
+        let mut acc = [0.0; LANES];
+        fold_block(block, word, &mut acc, |a, v, on| {
+            let d = if on { v - mean } else { 0.0 };
+            a + d * d
+        });
+        acc.iter().sum()
+    }
+
+    #[inline]
+    pub(super) fn min_max_block(block: &[f64], word: u64, min: &mut f64, max: &mut f64) {
+        let word = block_word(block.len(), word);
+        for (i, &v) in block.iter().enumerate() {
+            *min = min.min(pick(word, i, v, f64::INFINITY));
+            *max = max.max(pick(word, i, v, f64::NEG_INFINITY));
+        }
+    }
+
+    pub(super) fn sum(blocks: Blocks<'_>) -> f64 {
+        let mut acc = [0.0; LANES];
+        for (block, word) in blocks {
+            if word != 0 {
+                fold_block(block, word, &mut acc, |a, v, on| {
+                    a + if on { v } else { 0.0 }
+                });
+            }
+        }
+        acc.iter().sum()
+    }
+
+    pub(super) fn min_max(blocks: Blocks<'_>) -> (f64, f64) {
+        let mut lo = [f64::INFINITY; LANES];
+        let mut hi = [f64::NEG_INFINITY; LANES];
+        for (block, word) in blocks {
+            if word == 0 {
+                continue;
+            }
+            fold_block(block, word, &mut lo, |a, v, on| {
+                a.min(if on { v } else { f64::INFINITY })
+            });
+            fold_block(block, word, &mut hi, |a, v, on| {
+                a.max(if on { v } else { f64::NEG_INFINITY })
+            });
+        }
+        (
+            lo.into_iter().fold(f64::INFINITY, f64::min),
+            hi.into_iter().fold(f64::NEG_INFINITY, f64::max),
+        )
+    }
+
+    pub(super) fn moments(blocks: Blocks<'_>) -> Moments {
+        let mut total = Moments::default();
+        for (block, word) in blocks {
+            if word != 0 {
+                total.merge(block_moments(
+                    block,
+                    word,
+                    || sum_block(block, word),
+                    |mean| sq_dev_block(block, word, mean),
+                ));
+            }
+        }
+        total
+    }
+}
+
+#[cfg(target_arch = "x86_64")]
+mod x86 {
+    use std::arch::x86_64::*;
+
+    use super::{BLOCK, Blocks, Moments, block_moments, portable};
+
+    /// Lane masks for four rows from the low four bits of `bits`.
+    #[inline]
+    #[target_feature(enable = "avx2")]
+    fn mask4(bits: u64) -> __m256d {
+        let lanes = _mm256_setr_epi64x(1, 2, 4, 8);
+        let set = _mm256_and_si256(_mm256_set1_epi64x(bits as i64), lanes);
+        _mm256_castsi256_pd(_mm256_cmpeq_epi64(set, lanes))
+    }
+
+    /// Four rows of a full block starting at `4 * k`.
+    #[inline]
+    #[target_feature(enable = "avx2")]
+    fn load4(block: &[f64], k: usize) -> __m256d {
+        debug_assert!(block.len() == BLOCK && k < BLOCK / 4);
+        // SAFETY: callers pass full blocks and `k < 16`, so all four rows are in bounds.
+        unsafe { _mm256_loadu_pd(block.as_ptr().add(4 * k)) }
+    }
+
+    #[inline]
+    #[target_feature(enable = "avx2")]
+    fn lanes4(v: __m256d) -> [f64; 4] {
+        let mut out = [0.0; 4];
+        // SAFETY: `out` holds four f64.
+        unsafe { _mm256_storeu_pd(out.as_mut_ptr(), v) };
+        out
+    }
+
+    #[inline]
+    #[target_feature(enable = "avx2")]
+    fn hsum4(acc: [__m256d; 4]) -> f64 {
+        let v = _mm256_add_pd(_mm256_add_pd(acc[0], acc[1]), _mm256_add_pd(acc[2], acc[3]));
+        lanes4(v).iter().sum()
+    }
+
+    #[inline]
+    #[target_feature(enable = "avx2")]
+    fn sum_block_avx2(block: &[f64], word: u64) -> f64 {
+        let mut acc = [_mm256_setzero_pd(); 4];
+        for k in 0..BLOCK / 4 {
+            let v = _mm256_and_pd(load4(block, k), mask4(word >> (4 * k)));
+            acc[k % 4] = _mm256_add_pd(acc[k % 4], v);
+        }
+        hsum4(acc)
+    }
+
+    #[target_feature(enable = "avx2,fma")]
+    pub(super) fn sum_avx2(blocks: Blocks<'_>) -> f64 {
+        let mut acc = [_mm256_setzero_pd(); 4];
+        let mut tail = 0.0;
+        for (block, word) in blocks {
+            if word == 0 {
+                continue;
+            }
+            if block.len() < BLOCK {
+                tail += portable::sum_block(block, word);
+                continue;
+            }
+            for k in 0..BLOCK / 4 {
+                let v = _mm256_and_pd(load4(block, k), mask4(word >> (4 * k)));
+                acc[k % 4] = _mm256_add_pd(acc[k % 4], v);
+            }
+        }
+        hsum4(acc) + tail
+    }
+
+    #[target_feature(enable = "avx2,fma")]
+    pub(super) fn min_max_avx2(blocks: Blocks<'_>) -> (f64, f64) {
+        let pos_inf = _mm256_set1_pd(f64::INFINITY);
+        let neg_inf = _mm256_set1_pd(f64::NEG_INFINITY);
+        let (mut lo, mut hi) = (pos_inf, neg_inf);
+        let (mut tail_lo, mut tail_hi) = (f64::INFINITY, f64::NEG_INFINITY);
+        for (block, word) in blocks {
+            if word == 0 {
+                continue;
+            }
+            if block.len() < BLOCK {
+                portable::min_max_block(block, word, &mut tail_lo, &mut tail_hi);
+                continue;
+            }
+            for k in 0..BLOCK / 4 {
+                let v = load4(block, k);
+                let m = mask4(word >> (4 * k));
+                lo = _mm256_min_pd(lo, _mm256_blendv_pd(pos_inf, v, m));
+                hi = _mm256_max_pd(hi, _mm256_blendv_pd(neg_inf, v, m));
+            }
+        }
+        (
+            lanes4(lo).into_iter().fold(tail_lo, f64::min),
+            lanes4(hi).into_iter().fold(tail_hi, f64::max),
+        )
+    }
+
+    #[target_feature(enable = "avx2,fma")]
+    pub(super) fn moments_avx2(blocks: Blocks<'_>) -> Moments {
+        let mut total = Moments::default();
+        for (block, word) in blocks {
+            if word == 0 {
+                continue;
+            }
+            if block.len() < BLOCK {
+                total.merge(block_moments(
+                    block,
+                    word,
+                    || portable::sum_block(block, word),
+                    |mean| portable::sq_dev_block(block, word, mean),
+                ));
+                continue;
+            }
+            total.merge(block_moments(
+                block,
+                word,
+                || sum_block_avx2(block, word),
+                |mean| {
+                    let mean = _mm256_set1_pd(mean);
+                    let mut acc = [_mm256_setzero_pd(); 4];
+                    for k in 0..BLOCK / 4 {
+                        let d = _mm256_sub_pd(load4(block, k), mean);
+                        let d = _mm256_and_pd(d, mask4(word >> (4 * k)));
+                        acc[k % 4] = _mm256_fmadd_pd(d, d, acc[k % 4]);
+                    }
+                    hsum4(acc)
+                },
+            ));
+        }
+        total
+    }
+
+    /// Eight rows of a full block starting at `8 * k`; unselected rows read as zero.
+    #[inline]
+    #[target_feature(enable = "avx512f")]
+    fn load8(block: &[f64], k: usize, word: u64) -> __m512d {
+        debug_assert!(block.len() == BLOCK && k < BLOCK / 8);
+        // SAFETY: callers pass full blocks and `k < 8`, so all eight rows are in bounds.
+        unsafe { _mm512_maskz_loadu_pd((word >> (8 * k)) as __mmask8, block.as_ptr().add(8 * k)) }
+    }
+
+    #[inline]
+    #[target_feature(enable = "avx512f")]
+    fn sum_block_avx512(block: &[f64], word: u64) -> f64 {
+        let mut acc = [_mm512_setzero_pd(); 2];
+        for k in 0..BLOCK / 8 {
+            acc[k % 2] = _mm512_add_pd(acc[k % 2], load8(block, k, word));
+        }
+        _mm512_reduce_add_pd(_mm512_add_pd(acc[0], acc[1]))
+    }
+
+    #[target_feature(enable = "avx512f")]
+    pub(super) fn sum_avx512(blocks: Blocks<'_>) -> f64 {
+        let mut acc = [_mm512_setzero_pd(); 4];
+        let mut tail = 0.0;
+        for (block, word) in blocks {
+            if word == 0 {
+                continue;
+            }
+            if block.len() < BLOCK {
+                tail += portable::sum_block(block, word);
+                continue;
+            }
+            for k in 0..BLOCK / 8 {
+                acc[k % 4] = _mm512_add_pd(acc[k % 4], load8(block, k, word));
+            }
+        }
+        let v = _mm512_add_pd(_mm512_add_pd(acc[0], acc[1]), _mm512_add_pd(acc[2], acc[3]));
+        _mm512_reduce_add_pd(v) + tail
+    }
+
+    #[target_feature(enable = "avx512f")]
+    pub(super) fn min_max_avx512(blocks: Blocks<'_>) -> (f64, f64) {
+        let mut lo = _mm512_set1_pd(f64::INFINITY);
+        let mut hi = _mm512_set1_pd(f64::NEG_INFINITY);
+        let (mut tail_lo, mut tail_hi) = (f64::INFINITY, f64::NEG_INFINITY);
+        for (block, word) in blocks {
+            if word == 0 {
+                continue;
+            }
+            if block.len() < BLOCK {
+                portable::min_max_block(block, word, &mut tail_lo, &mut tail_hi);
+                continue;
+            }
+            for k in 0..BLOCK / 8 {
+                let m = (word >> (8 * k)) as __mmask8;
+                let v = load8(block, k, word);
+                lo = _mm512_mask_min_pd(lo, m, lo, v);
+                hi = _mm512_mask_max_pd(hi, m, hi, v);
+            }
+        }
+        (
+            _mm512_reduce_min_pd(lo).min(tail_lo),
+            _mm512_reduce_max_pd(hi).max(tail_hi),
+        )
+    }
+
+    #[target_feature(enable = "avx512f")]
+    pub(super) fn moments_avx512(blocks: Blocks<'_>) -> Moments {
+        let mut total = Moments::default();
+        for (block, word) in blocks {
+            if word == 0 {
+                continue;
+            }
+            if block.len() < BLOCK {
+                total.merge(block_moments(
+                    block,
+                    word,
+                    || portable::sum_block(block, word),
+                    |mean| portable::sq_dev_block(block, word, mean),
+                ));
+                continue;
+            }
+            total.merge(block_moments(
+                block,
+                word,
+                || sum_block_avx512(block, word),
+                |mean| {
+                    let mean = _mm512_set1_pd(mean);
+                    let mut acc = [_mm512_setzero_pd(); 2];
+                    for k in 0..BLOCK / 8 {
+                        let m = (word >> (8 * k)) as __mmask8;
+                        let d = _mm512_maskz_sub_pd(m, load8(block, k, word), mean);
+                        acc[k % 2] = _mm512_fmadd_pd(d, d, acc[k % 2]);
+                    }
+                    _mm512_reduce_add_pd(_mm512_add_pd(acc[0], acc[1]))
+                },
+            ));
+        }
+        total
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    const LEVELS: [SimdLevel; 3] = [SimdLevel::Portable, SimdLevel::Avx2, SimdLevel::Avx512];
+
+    fn sample(len: usize) -> (Vec<f64>, BooleanBuffer) {
+        // Integer values keep every partial sum exact, so all levels agree bit for bit.
+        let values = (0..len).map(|i| ((i * 37) % 101) as f64 - 50.0).collect();
+        let mask = BooleanBuffer::collect_bool(len, |i| i % 3 != 1 && i % 64 != 5);
+        (values, mask)
+    }
+
+    fn reference(values: &[f64], mask: &BooleanBuffer) -> Vec<f64> {
+        values
+            .iter()
+            .zip(mask.iter())
+            .filter_map(|(&v, on)| on.then_some(v))
+            .collect()
+    }
+
+    #[test]
+    fn levels_agree_with_a_scalar_fold() {
+        for len in [0, 1, 7, 63, 64, 65, 200, 1000] {
+            let (values, mask) = sample(len);
+            let picked = reference(&values, &mask);
+            let sum: f64 = picked.iter().sum();
+            let mean = sum / picked.len().max(1) as f64;
+            let devsq: f64 = picked.iter().map(|v| (v - mean) * (v - mean)).sum();
+            let lo = picked.iter().copied().reduce(f64::min);
+            let hi = picked.iter().copied().reduce(f64::max);
+            for level in LEVELS {
+                assert_eq!(level.sum_count(&values, Some(&mask)), (sum, picked.len()));
+                assert_eq!(level.min_max(&values, Some(&mask)), lo.zip(hi));
+                let m = level.moments(&values, Some(&mask));
+                assert_eq!((m.count, m.sum), (picked.len(), sum));
+                assert!((m.devsq() - devsq).abs() <= 1e-9 * devsq.max(1.0), "{len}");
+
+                let all: f64 = values.iter().sum();
+                assert_eq!(level.sum_count(&values, None), (all, len));
+            }
+        }
+    }
+
+    #[test]
+    fn masks_at_an_offset_and_unselected_garbage_are_ignored() {
+        let (mut values, mask) = sample(300);
+        let shifted = mask.slice(3, 297);
+        for (v, on) in values[3..].iter_mut().zip(shifted.iter()) {
+            if !on {
+                *v = f64::NAN;
+            }
+        }
+        let values = &values[3..];
+        let picked = reference(values, &shifted);
+        for level in LEVELS {
+            let (sum, count) = level.sum_count(values, Some(&shifted));
+            assert_eq!((sum, count), (picked.iter().sum(), picked.len()));
+            assert!(level.moments(values, Some(&shifted)).devsq().is_finite());
+            let (lo, hi) = level.min_max(values, Some(&shifted)).unwrap();
+            assert!(lo.is_finite() && hi.is_finite());
+        }
+    }
+
+    #[test]
+    fn merged_moments_match_a_single_pass() {
+        let values: Vec<f64> = (0..500).map(|i| 1e9 + f64::from(i % 17)).collect();
+        let whole = moments(&values, None);
+        let mut parts = moments(&values[..123], None);
+        parts.merge(moments(&values[123..], None));
+        parts.merge(Moments::default());
+        assert_eq!(parts.count, 500);
+        assert!((parts.devsq() - whole.devsq()).abs() < 1e-6 * whole.devsq());
+        let mean = whole.mean().unwrap();
+        let direct: f64 = values.iter().map(|v| (v - mean) * (v - mean)).sum();
+        assert!((whole.devsq() - direct).abs() < 1e-6 * direct);
+        assert_eq!(Moments::repeated(2.5, 4).variance_sample(), Some(0.0));
+        assert_eq!(Moments::default().variance_population(), None);
+    }
+}
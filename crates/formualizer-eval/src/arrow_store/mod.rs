@@ -2,14 +2,33 @@ use arrow_array::Array;
 use arrow_array::new_null_array;
 use arrow_schema::DataType;
 use std::sync::Arc;
+use std::sync::atomic::{AtomicU32, AtomicU64, Ordering};
 
-use arrow_array::builder::{BooleanBuilder, Float64Builder, StringBuilder, UInt8Builder};
+use arrow_array::builder::{
+    BooleanBuilder, Float64Builder, StringBuilder, UInt8Builder, UInt32Builder,
+};
 use arrow_array::{ArrayRef, BooleanArray, Float64Array, StringArray, UInt8Array, UInt32Array};
+use arrow_buffer::{BooleanBuffer, BooleanBufferBuilder};
 use once_cell::sync::OnceCell;
 
 use formualizer_common::{ExcelError, ExcelErrorKind, LiteralValue};
 use rustc_hash::FxHashMap;
-use std::collections::{BTreeMap, HashMap};
+use std::collections::BTreeMap;
+
+mod cold;
+#[cfg(not(target_arch = "wasm32"))]
+mod ipc;
+pub mod kernels;
+mod rebalance;
+#[cfg(not(target_arch = "wasm32"))]
+pub mod snapshot;
+mod tags;
+pub use cold::ColdTierStats;
+pub(crate) use cold::spill_cold_chunks;
+pub use kernels::{Moments, SimdLevel};
+pub use rebalance::{MAX_TARGET_CHUNK_ROWS, RebalanceJob, RebalancedChunks};
+pub(crate) use tags::share_uniform_tags;
+pub use tags::{tag_mask, uniform_tags, uniform_type_tag};
 
 /// Compact type tag per row (UInt8 backing)
 #[repr(u8)]
@@ -67,15 +86,765 @@ pub struct ColumnChunkMeta {
     pub non_null_bool: usize,
     pub non_null_text: usize,
     pub non_null_err: usize,
+    /// Value statistics of the base lanes; overlays keep their own (see `ColumnChunk::zone_map`).
+    pub zone: ZoneMap,
+}
+
+/// Per-chunk value statistics ("zone map") used to skip chunks that cannot match a
+/// predicate or lookup key.
+///
+/// Statistics are conservative: they may over-approximate the values present (overlay
+/// writes only widen them until the next compaction), but never miss one. The default is
+/// `ZoneMap::UNKNOWN`, which matches everything.
+#[derive(Debug, Clone, Copy, PartialEq)]
+pub struct ZoneMap {
+    /// Smallest value in the numeric lane (numbers, dates, durations); `+inf` when none.
+    pub num_min: f64,
+    /// Largest value in the numeric lane; `-inf` when none.
+    pub num_max: f64,
+    /// Two-bit-per-string bloom filter over lowercased text values.
+    pub text_bloom: u64,
+    /// Any empty (or pending) cell.
+    pub has_blank: bool,
+    pub has_bool: bool,
+    pub has_text: bool,
+    pub has_error: bool,
+    /// Every row is a plain number and the values never decrease in row order.
+    pub numbers_ascending: bool,
+}
+
+impl Default for ZoneMap {
+    fn default() -> Self {
+        Self::UNKNOWN
+    }
+}
+
+impl ZoneMap {
+    /// Statistics of no values at all; the starting point for accumulation.
+    pub const EMPTY: ZoneMap = ZoneMap {
+        num_min: f64::INFINITY,
+        num_max: f64::NEG_INFINITY,
+        text_bloom: 0,
+        has_blank: false,
+        has_bool: false,
+        has_text: false,
+        has_error: false,
+        numbers_ascending: true,
+    };
+
+    /// Statistics that admit every value.
+    pub const UNKNOWN: ZoneMap = ZoneMap {
+        num_min: f64::NEG_INFINITY,
+        num_max: f64::INFINITY,
+        text_bloom: u64::MAX,
+        has_blank: true,
+        has_bool: true,
+        has_text: true,
+        has_error: true,
+        numbers_ascending: false,
+    };
+
+    /// Statistics of dense base lanes. Flags come from the lane counts in `meta`.
+    pub(crate) fn from_lanes(
+        meta: &ColumnChunkMeta,
+        tags: &[u8],
+        numbers: Option<&Float64Array>,
+        text: Option<&StringArray>,
+    ) -> Self {
+        let mut zone = ZoneMap {
+            has_blank: meta.non_null_num
+                + meta.non_null_bool
+                + meta.non_null_text
+                + meta.non_null_err
+                < meta.len,
+            has_bool: meta.non_null_bool > 0,
+            has_text: meta.non_null_text > 0,
+            has_error: meta.non_null_err > 0,
+            numbers_ascending: false,
+            ..ZoneMap::EMPTY
+        };
+        if let Some(numbers) = numbers {
+            zone.include_numbers(numbers);
+            zone.numbers_ascending = meta.non_null_num == meta.len
+                && tags.iter().all(|&t| t == TypeTag::Number as u8)
+                && numbers.values().windows(2).all(|w| w[0] <= w[1]);
+        }
+        if let Some(text) = text {
+            for s in text.iter().flatten() {
+                zone.include_text(s);
+            }
+        }
+        zone
+    }
+
+    #[inline]
+    fn bloom_bits(lowered: &str) -> u64 {
+        let h = crate::rng::fnv1a64(lowered.as_bytes());
+        (1u64 << (h & 63)) | (1u64 << ((h >> 6) & 63))
+    }
+
+    #[inline]
+    fn include_number(&mut self, n: f64) {
+        self.num_min = self.num_min.min(n);
+        self.num_max = self.num_max.max(n);
+    }
+
+    fn include_numbers(&mut self, numbers: &Float64Array) {
+        if let Some(min) = arrow::compute::kernels::aggregate::min(numbers) {
+            self.num_min = self.num_min.min(min);
+        }
+        if let Some(max) = arrow::compute::kernels::aggregate::max(numbers) {
+            self.num_max = self.num_max.max(max);
+        }
+    }
+
+    /// Add a text value; case folding matches `criteria_match`.
+    pub(crate) fn include_text(&mut self, s: &str) {
+        if s.bytes().any(|b| !b.is_ascii() || b.is_ascii_uppercase()) {
+            self.include_lowered_text(&s.to_lowercase());
+        } else {
+            self.include_lowered_text(s);
+        }
+    }
+
+    pub(crate) fn include_lowered_text(&mut self, lowered: &str) {
+        self.has_text = true;
+        self.numbers_ascending = false;
+        self.text_bloom |= Self::bloom_bits(lowered);
+    }
+
+    pub(crate) fn include_blank(&mut self) {
+        self.has_blank = true;
+        self.numbers_ascending = false;
+    }
+
+    /// Add one value written out of row order (an overlay entry).
+    pub(crate) fn include_value(&mut self, value: &OverlayValue) {
+        self.numbers_ascending = false;
+        match value {
+            OverlayValue::Empty | OverlayValue::Pending => self.has_blank = true,
+            OverlayValue::Number(n) | OverlayValue::DateTime(n) | OverlayValue::Duration(n) => {
+                self.include_number(*n)
+            }
+            OverlayValue::Boolean(_) => self.has_bool = true,
+            OverlayValue::Text(s) => self.include_text(s),
+            OverlayValue::Error(_) => self.has_error = true,
+        }
+    }
+
+    /// Widen by `other`. For `numbers_ascending`, `other` is taken to follow `self` in
+    /// row order (or to overlay it, in which case it is empty or not ascending).
+    pub fn merge(&mut self, other: &ZoneMap) {
+        self.numbers_ascending =
+            self.numbers_ascending && other.numbers_ascending && self.num_max <= other.num_min;
+        self.num_min = self.num_min.min(other.num_min);
+        self.num_max = self.num_max.max(other.num_max);
+        self.text_bloom |= other.text_bloom;
+        self.has_blank |= other.has_blank;
+        self.has_bool |= other.has_bool;
+        self.has_text |= other.has_text;
+        self.has_error |= other.has_error;
+    }
+
+    #[inline]
+    pub fn has_numbers(&self) -> bool {
+        self.num_min <= self.num_max
+    }
+
+    /// Bounds of every value that coerces leniently to a number: the numeric lane, blanks
+    /// (0) and booleans (0/1). `None` when text is present, since numeric text can coerce
+    /// to anything. An empty range (`min > max`) means nothing coerces.
+    pub fn coerced_number_range(&self) -> Option<(f64, f64)> {
+        if self.has_text {
+            return None;
+        }
+        let (mut lo, mut hi) = (self.num_min, self.num_max);
+        if self.has_blank || self.has_bool {
+            lo = lo.min(0.0);
+            hi = hi.max(if self.has_bool { 1.0 } else { 0.0 });
+        }
+        Some((lo, hi))
+    }
+
+    /// Whether a text value equal (case-insensitively) to `lowered` may be present.
+    #[inline]
+    pub fn may_contain_text(&self, lowered: &str) -> bool {
+        self.has_text && {
+            let bits = Self::bloom_bits(lowered);
+            self.text_bloom & bits == bits
+        }
+    }
+}
+
+/// Largest dictionary the ingest builder keeps for one column before falling back to
+/// plain Utf8 text lanes.
+pub const TEXT_DICTIONARY_MAX_VALUES: usize = 1 << 16;
+/// A column stays dictionary-encoded only while every distinct string appears, on average,
+/// at least this many times among the column's text cells.
+pub const TEXT_DICTIONARY_MIN_REPEATS: usize = 2;
+
+/// Column-wide dictionary for low-cardinality text lanes.
+///
+/// Chunks of the same column share one dictionary through an `Arc`, so a code means the
+/// same string in every chunk. Case-insensitive comparisons use the lowered dictionary:
+/// each code maps to an id into `lowered_values`, and codes that differ only by case share
+/// an id.
+#[derive(Debug)]
+pub struct TextDictionary {
+    values: StringArray,
+    lowered_values: StringArray,
+    lowered_ids: Vec<u32>,
+    lookup: FxHashMap<Box<str>, u32>,
+    lowered_lookup: FxHashMap<Box<str>, u32>,
+}
+
+impl TextDictionary {
+    fn from_values(values: Vec<Box<str>>, lookup: FxHashMap<Box<str>, u32>) -> Self {
+        let mut lowered_lookup: FxHashMap<Box<str>, u32> = FxHashMap::default();
+        let mut lowered: Vec<Box<str>> = Vec::new();
+        let lowered_ids = values
+            .iter()
+            .map(|v| {
+                let key: Box<str> = v.to_lowercase().into();
+                *lowered_lookup.entry(key).or_insert_with_key(|key| {
+                    lowered.push(key.clone());
+                    (lowered.len() - 1) as u32
+                })
+            })
+            .collect();
+        Self {
+            values: StringArray::from_iter_values(values.iter().map(|v| v.as_ref())),
+            lowered_values: StringArray::from_iter_values(lowered.iter().map(|v| v.as_ref())),
+            lowered_ids,
+            lookup,
+            lowered_lookup,
+        }
+    }
+
+    #[inline]
+    pub fn len(&self) -> usize {
+        self.values.len()
+    }
+
+    #[inline]
+    pub fn is_empty(&self) -> bool {
+        self.values.is_empty()
+    }
+
+    /// Distinct strings, indexed by code.
+    #[inline]
+    pub fn values(&self) -> &StringArray {
+        &self.values
+    }
+
+    #[inline]
+    pub fn value(&self, code: u32) -> &str {
+        self.values.value(code as usize)
+    }
+
+    /// Distinct lowercased strings, indexed by lowered id.
+    #[inline]
+    pub fn lowered_values(&self) -> &StringArray {
+        &self.lowered_values
+    }
+
+    #[inline]
+    pub fn lowered_id(&self, code: u32) -> u32 {
+        self.lowered_ids[code as usize]
+    }
+
+    #[inline]
+    pub fn lowered_value(&self, code: u32) -> &str {
+        self.lowered_values.value(self.lowered_id(code) as usize)
+    }
+
+    #[inline]
+    pub fn code_of(&self, value: &str) -> Option<u32> {
+        self.lookup.get(value).copied()
+    }
+
+    /// Lowered id of an already-lowercased string.
+    #[inline]
+    pub fn lowered_id_of(&self, lowered: &str) -> Option<u32> {
+        self.lowered_lookup.get(lowered).copied()
+    }
+
+    /// Encode a Utf8 lane with this dictionary; `None` when any value is missing from it.
+    pub fn encode(&self, lane: &StringArray) -> Option<UInt32Array> {
+        let mut codes = UInt32Builder::with_capacity(lane.len());
+        for i in 0..lane.len() {
+            if lane.is_null(i) {
+                codes.append_null();
+            } else {
+                codes.append_value(self.code_of(lane.value(i))?);
+            }
+        }
+        Some(codes.finish())
+    }
+
+    /// Decode codes back into a Utf8 lane (nulls preserved).
+    pub fn decode(&self, codes: &UInt32Array) -> ArrayRef {
+        crate::compute_prelude::take_array(&self.values, codes, None)
+            .expect("dictionary codes in bounds")
+    }
+
+    /// Decode codes into the lowercased Utf8 lane (nulls preserved).
+    pub fn decode_lowered(&self, codes: &UInt32Array) -> ArrayRef {
+        let ids: UInt32Array = codes
+            .iter()
+            .map(|code| code.map(|code| self.lowered_id(code)))
+            .collect();
+        crate::compute_prelude::take_array(&self.lowered_values, &ids, None)
+            .expect("lowered dictionary ids in bounds")
+    }
+}
+
+/// Per-column dictionary under construction during ingest.
+#[derive(Debug, Default)]
+struct TextDictionaryBuilder {
+    values: Vec<Box<str>>,
+    lookup: FxHashMap<Box<str>, u32>,
+    text_cells: usize,
+    disabled: bool,
+}
+
+impl TextDictionaryBuilder {
+    /// Encode one finished chunk lane. Returns `None`, leaves the dictionary as it was, and
+    /// stops encoding further chunks once the column stops looking low-cardinality.
+    fn encode_chunk(&mut self, lane: &StringArray, n_text: usize) -> Option<UInt32Array> {
+        if self.disabled {
+            return None;
+        }
+        let seen = self.text_cells + n_text;
+        let before = self.values.len();
+        let mut codes = UInt32Builder::with_capacity(lane.len());
+        for i in 0..lane.len() {
+            if lane.is_null(i) {
+                codes.append_null();
+                continue;
+            }
+            let value = lane.value(i);
+            let code = match self.lookup.get(value) {
+                Some(&code) => code,
+                None => {
+                    let next = self.values.len() + 1;
+                    if next > TEXT_DICTIONARY_MAX_VALUES
+                        || next.saturating_mul(TEXT_DICTIONARY_MIN_REPEATS) > seen
+                    {
+                        for v in self.values.drain(before..) {
+                            self.lookup.remove(&v);
+                        }
+                        self.disabled = true;
+                        return None;
+                    }
+                    let code = self.values.len() as u32;
+                    self.values.push(value.into());
+                    self.lookup.insert(value.into(), code);
+                    code
+                }
+            };
+            codes.append_value(code);
+        }
+        self.text_cells = seen;
+        Some(codes.finish())
+    }
+
+    fn finish(self) -> Option<Arc<TextDictionary>> {
+        (!self.values.is_empty())
+            .then(|| Arc::new(TextDictionary::from_values(self.values, self.lookup)))
+    }
+}
+
+/// Dictionary codes for one column segment of a `RangeView`.
+#[derive(Debug, Clone)]
+pub struct TextCodes {
+    pub dict: Arc<TextDictionary>,
+    /// One code per row; null where the row holds no text.
+    pub codes: UInt32Array,
+}
+
+impl TextCodes {
+    /// Per-row mask from a mask over `dict.lowered_values()`. Rows without text are null,
+    /// matching what the same kernel yields on the lowered Utf8 lane.
+    pub fn mask_from_lowered(&self, lowered_mask: &BooleanArray) -> BooleanArray {
+        let by_code: Vec<Option<bool>> = (0..self.dict.len() as u32)
+            .map(|code| {
+                let id = self.dict.lowered_id(code) as usize;
+                lowered_mask.is_valid(id).then(|| lowered_mask.value(id))
+            })
+            .collect();
+        self.codes
+            .iter()
+            .map(|code| code.and_then(|code| by_code[code as usize]))
+            .collect()
+    }
+
+    /// Rows whose text equals `lowered` case-insensitively; rows without text are false.
+    pub fn eq_lowered(&self, lowered: &str) -> BooleanArray {
+        let target = self.dict.lowered_id_of(lowered);
+        let by_code: Vec<bool> = (0..self.dict.len() as u32)
+            .map(|code| Some(self.dict.lowered_id(code)) == target)
+            .collect();
+        let mut out = BooleanBuilder::with_capacity(self.codes.len());
+        for code in self.codes.iter() {
+            out.append_value(code.is_some_and(|code| by_code[code as usize]));
+        }
+        out.finish()
+    }
+}
+
+/// Smallest average run length at which the ingest builder stores a chunk run-end encoded.
+pub const RUN_ENCODING_MIN_AVG_RUN: usize = 16;
+
+/// Run-end encoded chunk rows. Run `i` covers rows `run_ends[i - 1]..run_ends[i]` and holds
+/// `values[i]`; a constant chunk is a single run.
+///
+/// Run-encoded chunks keep no dense lanes. The `ColumnChunk` accessors decode the rows a
+/// reader asks for, and `RangeView::numeric_segments` hands the runs to reductions as-is.
+#[derive(Debug, Clone)]
+pub struct ChunkRuns {
+    run_ends: Vec<u32>,
+    values: Vec<OverlayValue>,
+}
+
+impl ChunkRuns {
+    /// `len` rows of `value`.
+    pub fn constant(value: OverlayValue, len: usize) -> Self {
+        if len == 0 {
+            return Self {
+                run_ends: Vec::new(),
+                values: Vec::new(),
+            };
+        }
+        Self {
+            run_ends: vec![u32::try_from(len).expect("chunk length fits in u32")],
+            values: vec![value],
+        }
+    }
+
+    /// Run-end encode dense lanes when their runs average at least
+    /// `RUN_ENCODING_MIN_AVG_RUN` rows; `None` otherwise.
+    fn from_lanes(
+        tags: &UInt8Array,
+        numbers: Option<&Float64Array>,
+        booleans: Option<&BooleanArray>,
+        text: Option<&StringArray>,
+        errors: Option<&UInt8Array>,
+    ) -> Option<Self> {
+        let len = tags.len();
+        let max_runs = len / RUN_ENCODING_MIN_AVG_RUN;
+        if max_runs == 0 {
+            return None;
+        }
+        let same = |a: usize, b: usize| {
+            tags.value(a) == tags.value(b)
+                && numbers.is_none_or(|n| {
+                    n.is_valid(a) == n.is_valid(b)
+                        && (n.is_null(a) || n.value(a).to_bits() == n.value(b).to_bits())
+                })
+                && booleans.is_none_or(|v| {
+                    v.is_valid(a) == v.is_valid(b) && (v.is_null(a) || v.value(a) == v.value(b))
+                })
+                && text.is_none_or(|v| {
+                    v.is_valid(a) == v.is_valid(b) && (v.is_null(a) || v.value(a) == v.value(b))
+                })
+                && errors.is_none_or(|v| {
+                    v.is_valid(a) == v.is_valid(b) && (v.is_null(a) || v.value(a) == v.value(b))
+                })
+        };
+        let mut starts = vec![0usize];
+        for i in 1..len {
+            if !same(i - 1, i) {
+                if starts.len() == max_runs {
+                    return None;
+                }
+                starts.push(i);
+            }
+        }
+
+        // A tag whose lane slot is null reads as empty, as on the dense path.
+        let value_at = |i: usize| -> OverlayValue {
+            let valid_number = || numbers.filter(|n| n.is_valid(i)).map(|n| n.value(i));
+            let value = match TypeTag::from_u8(tags.value(i)) {
+                TypeTag::Empty => None,
+                TypeTag::Number => valid_number().map(OverlayValue::Number),
+                TypeTag::DateTime => valid_number().map(OverlayValue::DateTime),
+                TypeTag::Duration => valid_number().map(OverlayValue::Duration),
+                TypeTag::Boolean => booleans
+                    .filter(|v| v.is_valid(i))
+                    .map(|v| OverlayValue::Boolean(v.value(i))),
+                TypeTag::Text => text
+                    .filter(|v| v.is_valid(i))
+                    .map(|v| OverlayValue::Text(Arc::from(v.value(i)))),
+                TypeTag::Error => errors
+                    .filter(|v| v.is_valid(i))
+                    .map(|v| OverlayValue::Error(v.value(i))),
+                TypeTag::Pending => Some(OverlayValue::Pending),
+            };
+            value.unwrap_or(OverlayValue::Empty)
+        };
+        let mut runs = Self {
+            run_ends: Vec::with_capacity(starts.len()),
+            values: Vec::with_capacity(starts.len()),
+        };
+        for (idx, &start) in starts.iter().enumerate() {
+            let end = starts.get(idx + 1).copied().unwrap_or(len);
+            runs.push_run(value_at(start), end - start);
+        }
+        Some(runs)
+    }
+
+    #[inline]
+    pub fn len(&self) -> usize {
+        self.run_ends.last().map_or(0, |end| *end as usize)
+    }
+
+    #[inline]
+    pub fn is_empty(&self) -> bool {
+        self.len() == 0
+    }
+
+    #[inline]
+    pub fn run_count(&self) -> usize {
+        self.values.len()
+    }
+
+    #[inline]
+    pub fn is_constant(&self) -> bool {
+        self.values.len() == 1
+    }
+
+    /// Value at row `idx`.
+    #[inline]
+    pub fn value_at(&self, idx: usize) -> &OverlayValue {
+        let run = self.run_ends.partition_point(|end| *end as usize <= idx);
+        &self.values[run.min(self.values.len() - 1)]
+    }
+
+    /// `(rows, value)` for each run that intersects `off..off + len`, clipped to that range.
+    pub fn runs_in(
+        &self,
+        off: usize,
+        len: usize,
+    ) -> impl Iterator<Item = (usize, &OverlayValue)> + '_ {
+        let end = off + len;
+        let first = self.run_ends.partition_point(|e| *e as usize <= off);
+        let mut start = off;
+        self.run_ends[first..]
+            .iter()
+            .zip(&self.values[first..])
+            .map_while(move |(run_end, value)| {
+                if start >= end {
+                    return None;
+                }
+                let stop = (*run_end as usize).min(end);
+                let rows = stop - start;
+                start = stop;
+                Some((rows, value))
+            })
+    }
+
+    /// Rows `off..off + len` as their own run list.
+    pub fn slice(&self, off: usize, len: usize) -> Self {
+        let mut out = Self {
+            run_ends: Vec::new(),
+            values: Vec::new(),
+        };
+        for (rows, value) in self.runs_in(off, len) {
+            out.push_run(value.clone(), rows);
+        }
+        out
+    }
+
+    /// Append `rows` copies of `value`, extending the last run when it holds the same value.
+    fn push_run(&mut self, value: OverlayValue, rows: usize) {
+        if rows == 0 {
+            return;
+        }
+        let end = u32::try_from(self.len() + rows).expect("chunk length fits in u32");
+        match (self.values.last(), self.run_ends.last_mut()) {
+            (Some(last), Some(last_end)) if *last == value => *last_end = end,
+            _ => {
+                self.run_ends.push(end);
+                self.values.push(value);
+            }
+        }
+    }
+
+    /// Rows holding a value of each lane: (numbers, booleans, text, errors).
+    pub fn zone_map(&self) -> ZoneMap {
+        let mut zone = ZoneMap::EMPTY;
+        for value in &self.values {
+            zone.include_value(value);
+        }
+        zone.numbers_ascending = self
+            .values
+            .iter()
+            .all(|value| matches!(value, OverlayValue::Number(_)))
+            && self.values.windows(2).all(|w| match (&w[0], &w[1]) {
+                (OverlayValue::Number(a), OverlayValue::Number(b)) => a <= b,
+                _ => false,
+            });
+        zone
+    }
+
+    fn lane_counts(&self) -> (usize, usize, usize, usize) {
+        let mut counts = (0, 0, 0, 0);
+        for (rows, value) in self.runs_in(0, self.len()) {
+            match value {
+                OverlayValue::Number(_) | OverlayValue::DateTime(_) | OverlayValue::Duration(_) => {
+                    counts.0 += rows
+                }
+                OverlayValue::Boolean(_) => counts.1 += rows,
+                OverlayValue::Text(_) => counts.2 += rows,
+                OverlayValue::Error(_) => counts.3 += rows,
+                OverlayValue::Empty | OverlayValue::Pending => {}
+            }
+        }
+        counts
+    }
+
+    /// Tag of every row when all runs share one, e.g. numeric runs of different values.
+    pub fn uniform_type_tag(&self) -> Option<TypeTag> {
+        let tag = self.values.first()?.type_tag();
+        self.values
+            .iter()
+            .all(|v| v.type_tag() == tag)
+            .then_some(tag)
+    }
+
+    pub fn type_tags(&self, off: usize, len: usize) -> UInt8Array {
+        if let Some(tag) = self.uniform_type_tag() {
+            return uniform_tags(tag, len.min(self.len().saturating_sub(off)));
+        }
+        let mut b = UInt8Builder::with_capacity(len);
+        for (rows, value) in self.runs_in(off, len) {
+            b.append_value_n(value.type_tag() as u8, rows);
+        }
+        b.finish()
+    }
+
+    pub fn numbers(&self, off: usize, len: usize) -> Float64Array {
+        let mut b = Float64Builder::with_capacity(len);
+        for (rows, value) in self.runs_in(off, len) {
+            match value.numeric_lane_value() {
+                Some(n) => b.append_value_n(n, rows),
+                None => b.append_nulls(rows),
+            }
+        }
+        b.finish()
+    }
+
+    pub fn booleans(&self, off: usize, len: usize) -> BooleanArray {
+        let mut b = BooleanBuilder::with_capacity(len);
+        for (rows, value) in self.runs_in(off, len) {
+            match value.boolean_lane_value() {
+                Some(v) => b.append_n(rows, v),
+                None => b.append_nulls(rows),
+            }
+        }
+        b.finish()
+    }
+
+    pub fn text(&self, off: usize, len: usize) -> StringArray {
+        self.text_with(off, len, |s| s.to_string())
+    }
+
+    pub fn lowered_text(&self, off: usize, len: usize) -> StringArray {
+        self.text_with(off, len, str::to_lowercase)
+    }
+
+    fn text_with(&self, off: usize, len: usize, map: impl Fn(&str) -> String) -> StringArray {
+        let mut b = StringBuilder::with_capacity(len, 0);
+        for (rows, value) in self.runs_in(off, len) {
+            match value.text_lane_value() {
+                Some(s) => {
+                    let s = map(s);
+                    for _ in 0..rows {
+                        b.append_value(&s);
+                    }
+                }
+                None => {
+                    for _ in 0..rows {
+                        b.append_null();
+                    }
+                }
+            }
+        }
+        b.finish()
+    }
+
+    pub fn errors(&self, off: usize, len: usize) -> UInt8Array {
+        let mut b = UInt8Builder::with_capacity(len);
+        for (rows, value) in self.runs_in(off, len) {
+            match value.error_lane_value() {
+                Some(code) => b.append_value_n(code, rows),
+                None => b.append_nulls(rows),
+            }
+        }
+        b.finish()
+    }
+
+    fn estimated_bytes(&self) -> usize {
+        self.run_ends.len() * core::mem::size_of::<u32>()
+            + self.values.len() * core::mem::size_of::<OverlayValue>()
+            + self
+                .values
+                .iter()
+                .map(OverlayValue::estimated_payload_bytes)
+                .sum::<usize>()
+    }
+}
+
+/// One of a chunk's two overlays.
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
+pub enum OverlayLayer {
+    /// User edits (`ColumnChunk::overlay`).
+    User,
+    /// Formula and spill outputs (`ColumnChunk::computed_overlay`).
+    Computed,
+}
+
+/// Base lanes rebuilt with one overlay layer folded in; see
+/// `ColumnChunk::build_compacted_lanes`.
+#[derive(Debug)]
+pub struct CompactedLanes {
+    layer: OverlayLayer,
+    len: usize,
+    tags: Arc<UInt8Array>,
+    numbers: Option<Arc<Float64Array>>,
+    booleans: Option<Arc<BooleanArray>>,
+    text: Option<ArrayRef>,
+    errors: Option<Arc<UInt8Array>>,
+    non_num: usize,
+    non_bool: usize,
+    non_text: usize,
+    non_err: usize,
+}
+
+impl CompactedLanes {
+    #[inline]
+    pub fn layer(&self) -> OverlayLayer {
+        self.layer
+    }
 }
 
 #[derive(Debug, Clone)]
 pub struct ColumnChunk {
     pub numbers: Option<Arc<Float64Array>>,
     pub booleans: Option<Arc<BooleanArray>>,
-    pub text: Option<ArrayRef>,          // Utf8 for Phase A
+    /// Plain Utf8 text lane. `None` for dictionary-encoded chunks; see `text_codes`.
+    pub text: Option<ArrayRef>,
+    /// Dictionary codes into `text_dict` when the ingest builder dictionary-encoded this
+    /// chunk's text. Read text through `text_or_null`/`text_at` to cover both encodings.
+    pub text_codes: Option<Arc<UInt32Array>>,
+    pub text_dict: Option<Arc<TextDictionary>>,
     pub errors: Option<Arc<UInt8Array>>, // compact error code (UInt8)
+    /// Dense type tags. Empty when `runs` holds the chunk.
     pub type_tag: Arc<UInt8Array>,
+    /// Run-end encoding of the whole chunk. When set, the dense lanes above are unused and
+    /// readers go through the accessors below.
+    pub runs: Option<Arc<ChunkRuns>>,
     pub formula_id: Option<Arc<UInt32Array>>, // reserved for Phase A+
     pub meta: ColumnChunkMeta,
     // Lazy null providers (per-chunk)
@@ -85,16 +854,60 @@ pub struct ColumnChunk {
     lazy_null_errors: OnceCell<Arc<UInt8Array>>,
     // Cache: lowered text lane, nulls preserved
     lowered_text: OnceCell<ArrayRef>,
+    // Cache: Utf8 lane decoded from dictionary codes
+    decoded_text: OnceCell<ArrayRef>,
     // Phase C: per-chunk overlay (delta edits since last compaction)
     pub overlay: Overlay,
     // Phase 0/1: separate computed overlay (formula/spill outputs)
     pub computed_overlay: Overlay,
+    // Last read epoch, for choosing which chunks to spill.
+    access: ChunkAccess,
+    // Type-tag lane installed by the last spill. While it is still the chunk's lane, the
+    // base lanes are backed by a memory-mapped file rather than the heap.
+    cold_type_tag: Option<Arc<UInt8Array>>,
 }
 
 impl ColumnChunk {
+    /// Chunk stored as `runs`, with no dense lanes and no overlay entries.
+    pub fn from_runs(runs: ChunkRuns) -> Self {
+        let (non_null_num, non_null_bool, non_null_text, non_null_err) = runs.lane_counts();
+        ColumnChunk {
+            numbers: None,
+            booleans: None,
+            text: None,
+            text_codes: None,
+            text_dict: None,
+            errors: None,
+            type_tag: Arc::new(UInt8Array::from(Vec::<u8>::new())),
+            formula_id: None,
+            meta: ColumnChunkMeta {
+                len: runs.len(),
+                non_null_num,
+                non_null_bool,
+                non_null_text,
+                non_null_err,
+                zone: runs.zone_map(),
+            },
+            runs: Some(Arc::new(runs)),
+            lazy_null_numbers: OnceCell::new(),
+            lazy_null_booleans: OnceCell::new(),
+            lazy_null_text: OnceCell::new(),
+            lazy_null_errors: OnceCell::new(),
+            lowered_text: OnceCell::new(),
+            decoded_text: OnceCell::new(),
+            overlay: Overlay::new(),
+            computed_overlay: Overlay::new(),
+            access: ChunkAccess::default(),
+            cold_type_tag: None,
+        }
+    }
+
     #[inline]
     pub fn len(&self) -> usize {
-        self.type_tag.len()
+        match &self.runs {
+            Some(runs) => runs.len(),
+            None => self.type_tag.len(),
+        }
     }
     #[inline]
     pub fn is_empty(&self) -> bool {
@@ -102,6 +915,9 @@ impl ColumnChunk {
     }
     #[inline]
     pub fn numbers_or_null(&self) -> Arc<Float64Array> {
+        if let Some(runs) = &self.runs {
+            return Arc::new(runs.numbers(0, runs.len()));
+        }
         if let Some(a) = &self.numbers {
             return a.clone();
         }
@@ -114,6 +930,9 @@ impl ColumnChunk {
     }
     #[inline]
     pub fn booleans_or_null(&self) -> Arc<BooleanArray> {
+        if let Some(runs) = &self.runs {
+            return Arc::new(runs.booleans(0, runs.len()));
+        }
         if let Some(a) = &self.booleans {
             return a.clone();
         }
@@ -126,6 +945,9 @@ impl ColumnChunk {
     }
     #[inline]
     pub fn errors_or_null(&self) -> Arc<UInt8Array> {
+        if let Some(runs) = &self.runs {
+            return Arc::new(runs.errors(0, runs.len()));
+        }
         if let Some(a) = &self.errors {
             return a.clone();
         }
@@ -138,19 +960,348 @@ impl ColumnChunk {
     }
     #[inline]
     pub fn text_or_null(&self) -> ArrayRef {
+        if let Some(runs) = &self.runs {
+            return Arc::new(runs.text(0, runs.len()));
+        }
         if let Some(a) = &self.text {
             return a.clone();
         }
-        self.lazy_null_text
-            .get_or_init(|| new_null_array(&DataType::Utf8, self.len()))
-            .clone()
+        if let Some((codes, dict)) = self.dictionary_text() {
+            return self.decoded_text.get_or_init(|| dict.decode(codes)).clone();
+        }
+        self.lazy_null_text
+            .get_or_init(|| new_null_array(&DataType::Utf8, self.len()))
+            .clone()
+    }
+
+    /// Dictionary codes and their dictionary when this chunk's text is dictionary-encoded.
+    #[inline]
+    pub fn dictionary_text(&self) -> Option<(&Arc<UInt32Array>, &Arc<TextDictionary>)> {
+        self.text_codes.as_ref().zip(self.text_dict.as_ref())
+    }
+
+    /// Statistics of the chunk's current values: the base lanes widened by both overlays.
+    pub fn zone_map(&self) -> ZoneMap {
+        let mut zone = self.meta.zone;
+        zone.merge(self.overlay.zone_map());
+        zone.merge(self.computed_overlay.zone_map());
+        zone
+    }
+
+    /// Recompute `meta.zone` from the base lanes after they were rebuilt.
+    pub(crate) fn refresh_zone_map(&mut self) {
+        if let Some(runs) = &self.runs {
+            self.meta.zone = runs.zone_map();
+            return;
+        }
+        let text = self
+            .text
+            .as_ref()
+            .and_then(|t| t.as_any().downcast_ref::<StringArray>());
+        let mut zone = ZoneMap::from_lanes(
+            &self.meta,
+            self.type_tag.values(),
+            self.numbers.as_deref(),
+            text,
+        );
+        if let Some((codes, dict)) = self.dictionary_text() {
+            for code in codes.iter().flatten() {
+                zone.include_lowered_text(dict.lowered_value(code));
+            }
+        }
+        self.meta.zone = zone;
+    }
+
+    /// Overlay cascade for reading a segment of this chunk; also records the read for the
+    /// cold tier and the rebalancer.
+    #[inline]
+    pub(crate) fn overlay_cascade(&self) -> OverlayCascade<'_> {
+        self.access.record_scan();
+        OverlayCascade::new(&self.overlay, &self.computed_overlay)
+    }
+
+    /// Overlay cascade for reading a single cell of this chunk.
+    #[inline]
+    pub(crate) fn point_overlay_cascade(&self) -> OverlayCascade<'_> {
+        self.access.record_point();
+        OverlayCascade::new(&self.overlay, &self.computed_overlay)
+    }
+
+    /// Read epoch of the last overlay cascade on this chunk (0 if never read).
+    #[inline]
+    pub fn last_access_epoch(&self) -> u64 {
+        self.access.get()
+    }
+
+    /// Number of read epochs with a segment scan and with a single-cell read of this chunk.
+    #[inline]
+    pub fn read_epochs(&self) -> (u32, u32) {
+        self.access.counts()
+    }
+
+    /// Whether the base lanes are served from a memory-mapped spill file.
+    #[inline]
+    pub fn is_cold(&self) -> bool {
+        self.cold_type_tag
+            .as_ref()
+            .is_some_and(|tags| Arc::ptr_eq(tags, &self.type_tag))
+    }
+
+    /// Heap bytes held by the base lanes; 0 while the chunk is cold.
+    pub fn resident_lane_bytes(&self) -> usize {
+        if self.is_cold() {
+            return 0;
+        }
+        let lanes = [
+            self.numbers.as_deref().map(|a| a as &dyn Array),
+            self.booleans.as_deref().map(|a| a as &dyn Array),
+            self.text.as_deref(),
+            self.text_codes.as_deref().map(|a| a as &dyn Array),
+            self.errors.as_deref().map(|a| a as &dyn Array),
+        ];
+        let runs = self.runs.as_deref().map_or(0, ChunkRuns::estimated_bytes);
+        lanes
+            .into_iter()
+            .flatten()
+            .map(Array::get_array_memory_size)
+            .fold(
+                runs.saturating_add(self.type_tag_bytes()),
+                usize::saturating_add,
+            )
+    }
+
+    /// The overlay for `layer`.
+    #[inline]
+    pub fn overlay_layer(&self, layer: OverlayLayer) -> &Overlay {
+        match layer {
+            OverlayLayer::User => &self.overlay,
+            OverlayLayer::Computed => &self.computed_overlay,
+        }
+    }
+
+    #[inline]
+    fn overlay_layer_mut(&mut self, layer: OverlayLayer) -> &mut Overlay {
+        match layer {
+            OverlayLayer::User => &mut self.overlay,
+            OverlayLayer::Computed => &mut self.computed_overlay,
+        }
+    }
+
+    /// User-overlay size past which it is folded into the base lanes: `len / frac_den` or
+    /// `abs_threshold`, whichever is smaller.
+    #[inline]
+    pub fn overlay_compaction_threshold(&self, abs_threshold: usize, frac_den: usize) -> usize {
+        (self.len() / frac_den.max(1)).min(abs_threshold)
+    }
+
+    /// Whether `self` still holds the base lanes of `snapshot`.
+    fn same_base_lanes(&self, snapshot: &ColumnChunk) -> bool {
+        fn same<T: ?Sized>(a: &Option<Arc<T>>, b: &Option<Arc<T>>) -> bool {
+            match (a, b) {
+                (Some(a), Some(b)) => Arc::ptr_eq(a, b),
+                (None, None) => true,
+                _ => false,
+            }
+        }
+        self.meta.len == snapshot.meta.len
+            && Arc::ptr_eq(&self.type_tag, &snapshot.type_tag)
+            && same(&self.runs, &snapshot.runs)
+            && same(&self.numbers, &snapshot.numbers)
+            && same(&self.booleans, &snapshot.booleans)
+            && same(&self.text, &snapshot.text)
+            && same(&self.text_codes, &snapshot.text_codes)
+            && same(&self.errors, &snapshot.errors)
+    }
+
+    /// Dense base lanes with `layer` folded in, merging row by row. Reads only `self`, so
+    /// it can run on a snapshot away from the evaluating thread. `None` for an empty chunk.
+    pub fn build_compacted_lanes(&self, layer: OverlayLayer) -> Option<CompactedLanes> {
+        let len = self.len();
+        if len == 0 {
+            return None;
+        }
+        let overlay = self.overlay_layer(layer);
+        let mut b = LaneRowBuilders::with_capacity(len);
+        for i in 0..len {
+            // If overlay present, use it. Otherwise, use base tag+lane.
+            match overlay.get_scalar(i) {
+                Some(ov) => b.append_value(&ov.to_overlay_value()),
+                None => b.append_base_row(self, i),
+            }
+        }
+        Some(b.finish(layer, len))
+    }
+
+    /// Swap in lanes from `build_compacted_lanes` and clear the overlay layer they fold.
+    /// Returns the overlay bytes freed.
+    pub fn install_compacted_lanes(&mut self, lanes: CompactedLanes) -> usize {
+        self.type_tag = lanes.tags;
+        self.runs = None;
+        self.numbers = lanes.numbers;
+        self.booleans = lanes.booleans;
+        self.set_text_lane(lanes.text);
+        self.errors = lanes.errors;
+        let freed = match lanes.layer {
+            OverlayLayer::User => self.overlay.clear(),
+            OverlayLayer::Computed => self.computed_overlay.clear(),
+        };
+        self.meta.len = lanes.len;
+        self.meta.non_null_num = lanes.non_num;
+        self.meta.non_null_bool = lanes.non_bool;
+        self.meta.non_null_text = lanes.non_text;
+        self.meta.non_null_err = lanes.non_err;
+        self.refresh_zone_map();
+        freed
+    }
+
+    /// Install lanes built from `snapshot`, a copy of this chunk taken earlier. Entries
+    /// written to the folded overlay after the snapshot stay in it; the rest are dropped.
+    /// Returns the change in that overlay's estimated bytes, or `None` without installing
+    /// when the base lanes have moved on or an entry the lanes fold was removed since.
+    pub fn install_compacted_snapshot(
+        &mut self,
+        snapshot: &ColumnChunk,
+        lanes: CompactedLanes,
+    ) -> Option<isize> {
+        if !self.same_base_lanes(snapshot) {
+            return None;
+        }
+        let layer = lanes.layer;
+        let folded = snapshot.overlay_layer(layer);
+        let current = self.overlay_layer(layer);
+        if current.generation() == folded.generation() {
+            return Some(-(self.install_compacted_lanes(lanes) as isize));
+        }
+        if folded
+            .iter()
+            .any(|(off, _)| current.get_scalar(off).is_none())
+        {
+            return None;
+        }
+        let before = current.estimated_bytes();
+        let mut rest = Overlay::new();
+        for (off, value) in current.iter() {
+            if folded.get(off).as_ref() != Some(&value) {
+                let _ = rest.set_scalar(off, value);
+            }
+        }
+        let after = rest.estimated_bytes();
+        self.install_compacted_lanes(lanes);
+        *self.overlay_layer_mut(layer) = rest;
+        Some(after as isize - before as isize)
+    }
+
+    /// Tag shared by every base row (overlays excluded) of a homogeneous chunk. O(1).
+    #[inline]
+    pub fn uniform_type_tag(&self) -> Option<TypeTag> {
+        match &self.runs {
+            Some(runs) => runs.uniform_type_tag(),
+            None => uniform_type_tag(&self.type_tag),
+        }
+    }
+
+    /// Heap bytes of the tag lane; shared uniform lanes belong to no chunk.
+    fn type_tag_bytes(&self) -> usize {
+        if uniform_type_tag(&self.type_tag).is_some() {
+            0
+        } else {
+            self.type_tag.get_array_memory_size()
+        }
+    }
+
+    /// Type tags for the whole chunk; decoded for run-encoded chunks.
+    pub fn type_tags(&self) -> Arc<UInt8Array> {
+        match &self.runs {
+            Some(runs) => Arc::new(runs.type_tags(0, runs.len())),
+            None => self.type_tag.clone(),
+        }
+    }
+
+    /// Base value at `idx` of a run-encoded chunk.
+    #[inline]
+    pub fn run_value_at(&self, idx: usize) -> Option<&OverlayValue> {
+        self.runs.as_ref().map(|runs| runs.value_at(idx))
+    }
+
+    /// Approximate bytes held by the base lanes or runs (overlays excluded).
+    pub fn estimated_base_bytes(&self) -> usize {
+        if let Some(runs) = &self.runs {
+            return runs.estimated_bytes();
+        }
+        self.type_tag_bytes()
+            + self
+                .numbers
+                .as_ref()
+                .map_or(0, |a| a.get_array_memory_size())
+            + self
+                .booleans
+                .as_ref()
+                .map_or(0, |a| a.get_array_memory_size())
+            + self.text.as_ref().map_or(0, |a| a.get_array_memory_size())
+            + self
+                .text_codes
+                .as_ref()
+                .map_or(0, |a| a.get_array_memory_size())
+            + self
+                .errors
+                .as_ref()
+                .map_or(0, |a| a.get_array_memory_size())
+    }
+
+    /// Text at `idx` without materializing a decoded lane.
+    #[inline]
+    pub fn text_at(&self, idx: usize) -> Option<&str> {
+        if let Some(runs) = &self.runs {
+            return runs.value_at(idx).text_lane_value();
+        }
+        if let Some(a) = &self.text {
+            let sa = a.as_any().downcast_ref::<StringArray>()?;
+            return (!sa.is_null(idx)).then(|| sa.value(idx));
+        }
+        let (codes, dict) = self.dictionary_text()?;
+        (!codes.is_null(idx)).then(|| dict.value(codes.value(idx)))
+    }
+
+    /// Replace the base text lane, re-encoding it with this chunk's dictionary when every
+    /// value is already in it. Drops the text caches.
+    pub fn set_text_lane(&mut self, text: Option<ArrayRef>) {
+        let codes = match (&text, &self.text_dict) {
+            (Some(lane), Some(dict)) => lane
+                .as_any()
+                .downcast_ref::<StringArray>()
+                .and_then(|sa| dict.encode(sa)),
+            _ => None,
+        };
+        if let Some(codes) = codes {
+            self.text = None;
+            self.text_codes = Some(Arc::new(codes));
+        } else {
+            // A lane with strings outside the dictionary stays plain Utf8.
+            if text.is_some() {
+                self.text_dict = None;
+            }
+            self.text = text;
+            self.text_codes = None;
+        }
+        self.decoded_text = OnceCell::new();
+        self.lowered_text = OnceCell::new();
     }
 
     /// Lowercased text lane, with nulls preserved. Cached per chunk.
     pub fn text_lower_or_null(&self) -> ArrayRef {
+        if let Some(runs) = &self.runs {
+            return Arc::new(runs.lowered_text(0, runs.len()));
+        }
         if let Some(a) = self.lowered_text.get() {
             return a.clone();
         }
+        // Dictionary chunks gather from the lowered dictionary instead of lowering each row.
+        if let Some((codes, dict)) = self.dictionary_text() {
+            return self
+                .lowered_text
+                .get_or_init(|| dict.decode_lowered(codes))
+                .clone();
+        }
         // Lowercase when text present; else return null Utf8
         let out: ArrayRef = if let Some(txt) = &self.text {
             let sa = txt.as_any().downcast_ref::<StringArray>().unwrap();
@@ -180,11 +1331,17 @@ impl ColumnChunk {
         if new_len <= old_len {
             return;
         }
+        if let Some(runs) = &mut self.runs {
+            Arc::make_mut(runs).push_run(OverlayValue::Empty, new_len - old_len);
+            self.meta.len = new_len;
+            self.meta.zone.include_blank();
+            return;
+        }
 
         // Grow type tags (pad with Empty).
         let mut tags: Vec<u8> = self.type_tag.values().to_vec();
         tags.resize(new_len, TypeTag::Empty as u8);
-        self.type_tag = Arc::new(UInt8Array::from(tags));
+        self.type_tag = share_uniform_tags(UInt8Array::from(tags));
 
         // Grow lanes when present; append nulls for new rows.
         if let Some(a) = &self.numbers {
@@ -248,6 +1405,14 @@ impl ColumnChunk {
             }
             self.text = Some(Arc::new(b.finish()) as ArrayRef);
         }
+        if let Some(a) = &self.text_codes {
+            let mut b = UInt32Builder::with_capacity(new_len);
+            for code in a.iter() {
+                b.append_option(code);
+            }
+            b.append_nulls(new_len - old_len);
+            self.text_codes = Some(Arc::new(b.finish()));
+        }
 
         // Length-dependent caches must be dropped.
         self.lazy_null_numbers = OnceCell::new();
@@ -255,8 +1420,10 @@ impl ColumnChunk {
         self.lazy_null_text = OnceCell::new();
         self.lazy_null_errors = OnceCell::new();
         self.lowered_text = OnceCell::new();
+        self.decoded_text = OnceCell::new();
 
         self.meta.len = new_len;
+        self.meta.zone.include_blank();
     }
 }
 
@@ -346,6 +1513,9 @@ pub struct IngestBuilder {
     // Per-column per-lane non-null counters for current chunk
     lane_counts: Vec<LaneCounts>,
 
+    // Per-column text dictionaries shared by every dictionary-encoded chunk
+    text_dicts: Vec<TextDictionaryBuilder>,
+
     // Accumulated chunks
     chunks: Vec<Vec<ColumnChunk>>, // indexed by col
     row_in_chunk: usize,
@@ -390,6 +1560,9 @@ impl IngestBuilder {
                 .map(|_| UInt8Builder::with_capacity(chunk_rows))
                 .collect(),
             lane_counts: vec![LaneCounts::default(); ncols],
+            text_dicts: (0..ncols)
+                .map(|_| TextDictionaryBuilder::default())
+                .collect(),
             chunks,
             row_in_chunk: 0,
             total_rows: 0,
@@ -651,66 +1824,101 @@ impl IngestBuilder {
         Ok(())
     }
 
+    /// Re-init column `c`'s builders for the next chunk.
+    fn reset_builders(&mut self, c: usize) {
+        self.num_builders[c] = Float64Builder::with_capacity(self.chunk_rows);
+        self.bool_builders[c] = BooleanBuilder::with_capacity(self.chunk_rows);
+        self.text_builders[c] = StringBuilder::with_capacity(self.chunk_rows, self.chunk_rows * 12);
+        self.err_builders[c] = UInt8Builder::with_capacity(self.chunk_rows);
+        self.tag_builders[c] = UInt8Builder::with_capacity(self.chunk_rows);
+        self.lane_counts[c] = LaneCounts::default();
+    }
+
     fn finish_chunk(&mut self) {
         if self.row_in_chunk == 0 {
             return;
         }
         for c in 0..self.ncols {
             let len = self.row_in_chunk;
-            let numbers_arc: Option<Arc<Float64Array>> = if self.lane_counts[c].n_num == 0 {
-                None
-            } else {
-                Some(Arc::new(self.num_builders[c].finish()))
-            };
-            let booleans_arc: Option<Arc<BooleanArray>> = if self.lane_counts[c].n_bool == 0 {
-                None
-            } else {
-                Some(Arc::new(self.bool_builders[c].finish()))
-            };
-            let text_ref: Option<ArrayRef> = if self.lane_counts[c].n_text == 0 {
-                None
-            } else {
-                Some(Arc::new(self.text_builders[c].finish()))
-            };
-            let errors_arc: Option<Arc<UInt8Array>> = if self.lane_counts[c].n_err == 0 {
-                None
-            } else {
-                Some(Arc::new(self.err_builders[c].finish()))
+            let counts = self.lane_counts[c];
+            let meta = ColumnChunkMeta {
+                len,
+                non_null_num: counts.n_num,
+                non_null_bool: counts.n_bool,
+                non_null_text: counts.n_text,
+                non_null_err: counts.n_err,
+                zone: ZoneMap::EMPTY,
             };
             let tags: UInt8Array = self.tag_builders[c].finish();
+            let numbers = self.num_builders[c].finish();
+            let booleans = self.bool_builders[c].finish();
+            let text = self.text_builders[c].finish();
+            let errors = self.err_builders[c].finish();
+            self.reset_builders(c);
+
+            // Long runs of one value (padding, flags, empty regions) keep only their runs.
+            if let Some(runs) = ChunkRuns::from_lanes(
+                &tags,
+                (counts.n_num > 0).then_some(&numbers),
+                (counts.n_bool > 0).then_some(&booleans),
+                (counts.n_text > 0).then_some(&text),
+                (counts.n_err > 0).then_some(&errors),
+            ) {
+                let mut chunk = ColumnChunk::from_runs(runs);
+                chunk.meta = ColumnChunkMeta {
+                    zone: chunk.meta.zone,
+                    ..meta
+                };
+                self.chunks[c].push(chunk);
+                continue;
+            }
+            let meta = ColumnChunkMeta {
+                zone: ZoneMap::from_lanes(
+                    &meta,
+                    tags.values(),
+                    (counts.n_num > 0).then_some(&numbers),
+                    (counts.n_text > 0).then_some(&text),
+                ),
+                ..meta
+            };
+
+            let numbers_arc = (counts.n_num > 0).then(|| Arc::new(numbers));
+            let booleans_arc = (counts.n_bool > 0).then(|| Arc::new(booleans));
+            let (text_ref, text_codes): (Option<ArrayRef>, Option<Arc<UInt32Array>>) =
+                if counts.n_text == 0 {
+                    (None, None)
+                } else {
+                    match self.text_dicts[c].encode_chunk(&text, counts.n_text) {
+                        Some(codes) => (None, Some(Arc::new(codes))),
+                        None => (Some(Arc::new(text) as ArrayRef), None),
+                    }
+                };
+            let errors_arc = (counts.n_err > 0).then(|| Arc::new(errors));
 
             let chunk = ColumnChunk {
                 numbers: numbers_arc,
                 booleans: booleans_arc,
                 text: text_ref,
+                text_codes,
+                // Shared dictionary is attached in `finish` once every chunk is encoded.
+                text_dict: None,
                 errors: errors_arc,
-                type_tag: Arc::new(tags),
+                type_tag: share_uniform_tags(tags),
+                runs: None,
                 formula_id: None,
-                meta: ColumnChunkMeta {
-                    len,
-                    non_null_num: self.lane_counts[c].n_num,
-                    non_null_bool: self.lane_counts[c].n_bool,
-                    non_null_text: self.lane_counts[c].n_text,
-                    non_null_err: self.lane_counts[c].n_err,
-                },
+                meta,
                 lazy_null_numbers: OnceCell::new(),
                 lazy_null_booleans: OnceCell::new(),
                 lazy_null_text: OnceCell::new(),
                 lazy_null_errors: OnceCell::new(),
                 lowered_text: OnceCell::new(),
+                decoded_text: OnceCell::new(),
                 overlay: Overlay::new(),
                 computed_overlay: Overlay::new(),
+                access: ChunkAccess::default(),
+                cold_type_tag: None,
             };
             self.chunks[c].push(chunk);
-
-            // re-init builders for next chunk
-            self.num_builders[c] = Float64Builder::with_capacity(self.chunk_rows);
-            self.bool_builders[c] = BooleanBuilder::with_capacity(self.chunk_rows);
-            self.text_builders[c] =
-                StringBuilder::with_capacity(self.chunk_rows, self.chunk_rows * 12);
-            self.err_builders[c] = UInt8Builder::with_capacity(self.chunk_rows);
-            self.tag_builders[c] = UInt8Builder::with_capacity(self.chunk_rows);
-            self.lane_counts[c] = LaneCounts::default();
         }
         self.row_in_chunk = 0;
     }
@@ -722,7 +1930,12 @@ impl IngestBuilder {
         }
 
         let mut columns = Vec::with_capacity(self.ncols);
-        for (idx, chunks) in self.chunks.into_iter().enumerate() {
+        for (idx, (mut chunks, dict)) in self.chunks.into_iter().zip(self.text_dicts).enumerate() {
+            if let Some(dict) = dict.finish() {
+                for ch in chunks.iter_mut().filter(|ch| ch.text_codes.is_some()) {
+                    ch.text_dict = Some(dict.clone());
+                }
+            }
             columns.push(ArrowColumn {
                 chunks,
                 sparse_chunks: FxHashMap::default(),
@@ -745,9 +1958,9 @@ impl IngestBuilder {
             }
             let mut cur = 0usize;
             for i in 0..chunks_len0 {
-                let len_i = col0.chunks[i].type_tag.len();
+                let len_i = col0.chunks[i].len();
                 for (ci, col) in columns.iter().enumerate() {
-                    let got = col.chunks[i].type_tag.len();
+                    let got = col.chunks[i].len();
                     if got != len_i {
                         panic!(
                             "ArrowSheet chunk row-length misalignment at chunk {i}: col {ci} len={got} != {len_i}"
@@ -963,18 +2176,12 @@ impl OverlayValue {
 }
 
 #[derive(Debug, Clone)]
-pub(crate) enum OverlayScalar<'a> {
-    Borrowed(&'a OverlayValue),
-    Owned(OverlayValue),
-}
+pub(crate) struct OverlayScalar(OverlayValue);
 
-impl<'a> OverlayScalar<'a> {
+impl OverlayScalar {
     #[inline]
     fn as_value(&self) -> &OverlayValue {
-        match self {
-            OverlayScalar::Borrowed(value) => value,
-            OverlayScalar::Owned(value) => value,
-        }
+        &self.0
     }
 
     #[inline]
@@ -1021,7 +2228,6 @@ impl<'a> OverlayScalar<'a> {
     }
 }
 
-const OVERLAY_ENTRY_BASE_BYTES: usize = 32;
 const OVERLAY_FRAGMENT_BASE_BYTES: usize = 48;
 
 #[allow(dead_code)]
@@ -1134,8 +2340,8 @@ impl OverlayFragmentPayload {
     }
 
     #[inline]
-    fn get_scalar(&self, idx: usize) -> Option<OverlayScalar<'_>> {
-        self.overlay_value(idx).map(OverlayScalar::Owned)
+    fn get_scalar(&self, idx: usize) -> Option<OverlayScalar> {
+        self.overlay_value(idx).map(OverlayScalar)
     }
 
     #[inline]
@@ -1174,6 +2380,34 @@ impl OverlayFragmentPayload {
     fn estimated_bytes(&self) -> usize {
         self.estimated_bytes
     }
+
+    fn zone_map(&self) -> ZoneMap {
+        let mut zone = ZoneMap {
+            numbers_ascending: false,
+            ..ZoneMap::EMPTY
+        };
+        for tag in self.type_tags.iter().flatten() {
+            match TypeTag::from_u8(tag) {
+                TypeTag::Empty | TypeTag::Pending => zone.has_blank = true,
+                TypeTag::Boolean => zone.has_bool = true,
+                TypeTag::Error => zone.has_error = true,
+                _ => {}
+            }
+        }
+        if let Some(numbers) = &self.numbers {
+            zone.include_numbers(numbers);
+        }
+        if let Some(text) = self
+            .text
+            .as_ref()
+            .and_then(|t| t.as_any().downcast_ref::<StringArray>())
+        {
+            for s in text.iter().flatten() {
+                zone.include_text(s);
+            }
+        }
+        zone
+    }
 }
 #[derive(Debug, Clone)]
 pub(crate) enum OverlayFragment {
@@ -1304,6 +2538,15 @@ impl OverlayFragment {
         })
     }
 
+    #[inline]
+    fn payload(&self) -> &OverlayFragmentPayload {
+        match self {
+            OverlayFragment::SparseOffsets { payload, .. }
+            | OverlayFragment::DenseRange { payload, .. }
+            | OverlayFragment::RunRange { payload, .. } => payload,
+        }
+    }
+
     #[inline]
     fn estimated_bytes(&self) -> usize {
         match self {
@@ -1444,7 +2687,7 @@ impl OverlayFragment {
         self.get_scalar(off).is_some()
     }
 
-    fn get_scalar(&self, off: usize) -> Option<OverlayScalar<'_>> {
+    fn get_scalar(&self, off: usize) -> Option<OverlayScalar> {
         match self {
             OverlayFragment::SparseOffsets { offsets, payload } => {
                 let off = u32::try_from(off).ok()?;
@@ -1809,7 +3052,8 @@ impl OverlayFragment {
         }
     }
 
-    fn slice(&self, off: usize, len: usize) -> Option<OverlayFragment> {
+    /// The part of this fragment covering `off..off + len`, moved to start at `at`.
+    fn slice_to(&self, off: usize, len: usize, at: usize) -> Option<OverlayFragment> {
         let end = off.saturating_add(len);
         if len == 0 {
             return None;
@@ -1822,7 +3066,7 @@ impl OverlayFragment {
                 let hi = offsets.partition_point(|candidate| (*candidate as usize) < end);
                 let cells: Vec<_> = (lo..hi)
                     .filter_map(|idx| {
-                        let rebased = (offsets[idx] as usize).saturating_sub(off);
+                        let rebased = (offsets[idx] as usize).saturating_sub(off) + at;
                         payload.overlay_value(idx).map(|value| (rebased, value))
                     })
                     .collect();
@@ -1835,7 +3079,7 @@ impl OverlayFragment {
                 if seg_start >= seg_end {
                     return None;
                 }
-                self.dense_segment_with_start(seg_start - off, seg_start, seg_end)
+                self.dense_segment_with_start(seg_start - off + at, seg_start, seg_end)
             }
             OverlayFragment::RunRange { .. } => {
                 let own = self.interval_coverage()?;
@@ -1844,37 +3088,563 @@ impl OverlayFragment {
                 if seg_start >= seg_end {
                     return None;
                 }
-                self.run_segment_with_start(seg_start - off, seg_start, seg_end)
+                self.run_segment_with_start(seg_start - off + at, seg_start, seg_end)
             }
         }
     }
 }
-#[derive(Debug, Default, Clone)]
+/// Lane bytes per point entry: offset, type tag, number and code.
+const OVERLAY_POINT_LANE_BYTES: usize = 17;
+
+/// Point entries of an overlay in flat form: a presence bit per chunk offset plus typed
+/// value lanes. A sparse set keeps its lanes in offset order beside a sorted offset list;
+/// once the entries fill a quarter of the bitset window the lanes are laid out densely
+/// over that window and indexed by offset instead.
+#[derive(Debug, Clone, Default)]
+struct OverlayPoints {
+    /// Presence bits for offsets `first_word * 64..(first_word + present.len()) * 64`.
+    first_word: usize,
+    present: Vec<u64>,
+    count: usize,
+    dense: bool,
+    /// Offset of each lane slot, ascending. Empty in the dense layout.
+    offsets: Vec<u32>,
+    tags: Vec<u8>,
+    /// Number, date/time or duration payload; 0.0 under other tags.
+    numbers: Vec<f64>,
+    /// Boolean (0/1), error code, or index into `strings`, by tag.
+    codes: Vec<u32>,
+    strings: Vec<Arc<str>>,
+    /// `strings` entries no slot refers to any more.
+    dead_strings: usize,
+}
+
+impl OverlayPoints {
+    /// Dense layout once `count * DENSE_DEN >= window`, sparse again below a quarter of that.
+    const DENSE_DEN: usize = 4;
+
+    #[inline]
+    fn len(&self) -> usize {
+        self.count
+    }
+
+    #[inline]
+    fn is_empty(&self) -> bool {
+        self.count == 0
+    }
+
+    #[inline]
+    fn window_start(&self) -> usize {
+        self.first_word * 64
+    }
+
+    #[inline]
+    fn window_len(&self) -> usize {
+        self.present.len() * 64
+    }
+
+    #[inline]
+    fn contains(&self, off: usize) -> bool {
+        (off / 64)
+            .checked_sub(self.first_word)
+            .and_then(|w| self.present.get(w))
+            .is_some_and(|bits| bits & (1u64 << (off % 64)) != 0)
+    }
+
+    /// Lane slot of an offset whose presence bit is set.
+    #[inline]
+    fn slot(&self, off: usize) -> usize {
+        if self.dense {
+            off - self.window_start()
+        } else {
+            self.offsets.partition_point(|&o| (o as usize) < off)
+        }
+    }
+
+    #[inline]
+    fn get(&self, off: usize) -> Option<OverlayValue> {
+        self.contains(off).then(|| self.value_at(self.slot(off)))
+    }
+
+    fn value_at(&self, slot: usize) -> OverlayValue {
+        let number = self.numbers[slot];
+        let code = self.codes[slot];
+        match TypeTag::from_u8(self.tags[slot]) {
+            TypeTag::Empty => OverlayValue::Empty,
+            TypeTag::Number => OverlayValue::Number(number),
+            TypeTag::DateTime => OverlayValue::DateTime(number),
+            TypeTag::Duration => OverlayValue::Duration(number),
+            TypeTag::Boolean => OverlayValue::Boolean(code != 0),
+            TypeTag::Text => OverlayValue::Text(self.strings[code as usize].clone()),
+            TypeTag::Error => OverlayValue::Error(code as u8),
+            TypeTag::Pending => OverlayValue::Pending,
+        }
+    }
+
+    #[inline]
+    fn tag_at(&self, slot: usize) -> TypeTag {
+        TypeTag::from_u8(self.tags[slot])
+    }
+
+    #[inline]
+    fn number_at(&self, slot: usize) -> Option<f64> {
+        matches!(
+            self.tag_at(slot),
+            TypeTag::Number | TypeTag::DateTime | TypeTag::Duration
+        )
+        .then(|| self.numbers[slot])
+    }
+
+    #[inline]
+    fn boolean_at(&self, slot: usize) -> Option<bool> {
+        (self.tag_at(slot) == TypeTag::Boolean).then(|| self.codes[slot] != 0)
+    }
+
+    #[inline]
+    fn text_at(&self, slot: usize) -> Option<&str> {
+        (self.tag_at(slot) == TypeTag::Text).then(|| &*self.strings[self.codes[slot] as usize])
+    }
+
+    #[inline]
+    fn error_at(&self, slot: usize) -> Option<u8> {
+        (self.tag_at(slot) == TypeTag::Error).then(|| self.codes[slot] as u8)
+    }
+
+    /// Insert or replace the entry at `off`, returning the value it replaced.
+    fn insert(&mut self, off: usize, value: OverlayValue) -> Option<OverlayValue> {
+        let tag = value.type_tag() as u8;
+        let (number, code) = match value {
+            OverlayValue::Number(n) | OverlayValue::DateTime(n) | OverlayValue::Duration(n) => {
+                (n, 0)
+            }
+            OverlayValue::Boolean(b) => (0.0, u32::from(b)),
+            OverlayValue::Error(code) => (0.0, u32::from(code)),
+            OverlayValue::Text(s) => {
+                self.strings.push(s);
+                (0.0, (self.strings.len() - 1) as u32)
+            }
+            OverlayValue::Empty | OverlayValue::Pending => (0.0, 0),
+        };
+
+        if self.contains(off) {
+            let slot = self.slot(off);
+            let old = self.value_at(slot);
+            self.release(slot);
+            self.tags[slot] = tag;
+            self.numbers[slot] = number;
+            self.codes[slot] = code;
+            self.collect_strings();
+            return Some(old);
+        }
+
+        self.cover(off);
+        self.present[off / 64 - self.first_word] |= 1u64 << (off % 64);
+        self.count += 1;
+        let slot = self.slot(off);
+        if self.dense {
+            self.tags[slot] = tag;
+            self.numbers[slot] = number;
+            self.codes[slot] = code;
+        } else {
+            self.offsets.insert(slot, off as u32);
+            self.tags.insert(slot, tag);
+            self.numbers.insert(slot, number);
+            self.codes.insert(slot, code);
+        }
+        self.relayout();
+        None
+    }
+
+    fn remove(&mut self, off: usize) -> Option<OverlayValue> {
+        if !self.contains(off) {
+            return None;
+        }
+        let slot = self.slot(off);
+        let old = self.value_at(slot);
+        self.release(slot);
+        self.present[off / 64 - self.first_word] &= !(1u64 << (off % 64));
+        self.count -= 1;
+        if self.count == 0 {
+            self.clear();
+            return Some(old);
+        }
+        if !self.dense {
+            self.offsets.remove(slot);
+            self.tags.remove(slot);
+            self.numbers.remove(slot);
+            self.codes.remove(slot);
+        }
+        self.collect_strings();
+        self.relayout();
+        Some(old)
+    }
+
+    /// Remove every entry in `range`, returning the removed values.
+    fn remove_range(&mut self, range: core::ops::Range<usize>) -> Vec<OverlayValue> {
+        let mut offsets = Vec::new();
+        self.for_each_slot_in(range, |off, _| offsets.push(off));
+        offsets
+            .into_iter()
+            .filter_map(|off| self.remove(off))
+            .collect()
+    }
+
+    fn clear(&mut self) {
+        *self = Self::default();
+    }
+
+    fn has_any_in_range(&self, range: core::ops::Range<usize>) -> bool {
+        let mut any = false;
+        self.for_each_word_in(range, |_, bits| {
+            any |= bits != 0;
+            !any
+        });
+        any
+    }
+
+    /// Visit `(offset, slot)` for each entry in `range`, in offset order.
+    fn for_each_slot_in(&self, range: core::ops::Range<usize>, mut f: impl FnMut(usize, usize)) {
+        if self.count == 0 || range.is_empty() {
+            return;
+        }
+        if !self.dense {
+            let lo = self
+                .offsets
+                .partition_point(|&o| (o as usize) < range.start);
+            for (slot, &off) in self.offsets.iter().enumerate().skip(lo) {
+                let off = off as usize;
+                if off >= range.end {
+                    break;
+                }
+                f(off, slot);
+            }
+            return;
+        }
+        let base = self.window_start();
+        self.for_each_word_in(range, |word_start, mut bits| {
+            while bits != 0 {
+                let off = word_start + bits.trailing_zeros() as usize;
+                f(off, off - base);
+                bits &= bits - 1;
+            }
+            true
+        });
+    }
+
+    /// Visit the presence words overlapping `range` with bits outside it masked off, as
+    /// `(first offset of the word, bits)`. Stops when `f` returns false.
+    fn for_each_word_in(
+        &self,
+        range: core::ops::Range<usize>,
+        mut f: impl FnMut(usize, u64) -> bool,
+    ) {
+        let base = self.window_start();
+        let start = range.start.max(base);
+        let end = range.end.min(base + self.window_len());
+        if start >= end {
+            return;
+        }
+        for w in (start - base) / 64..=(end - 1 - base) / 64 {
+            let word_start = base + w * 64;
+            let mut bits = self.present[w];
+            if word_start < start {
+                bits &= !0u64 << (start - word_start);
+            }
+            if end - word_start < 64 {
+                bits &= (1u64 << (end - word_start)) - 1;
+            }
+            if !f(word_start, bits) {
+                return;
+            }
+        }
+    }
+
+    /// Grow the presence window (and dense lanes) to include `off`.
+    fn cover(&mut self, off: usize) {
+        let word = off / 64;
+        if self.present.is_empty() {
+            self.first_word = word;
+            self.present.push(0);
+            if self.dense {
+                self.resize_dense_lanes(0);
+            }
+            return;
+        }
+        if word < self.first_word {
+            let grow = self.first_word - word;
+            self.present.splice(0..0, std::iter::repeat_n(0, grow));
+            self.first_word = word;
+            if self.dense {
+                self.resize_dense_lanes(grow * 64);
+            }
+        } else if word >= self.first_word + self.present.len() {
+            self.present.resize(word - self.first_word + 1, 0);
+            if self.dense {
+                self.resize_dense_lanes(0);
+            }
+        }
+    }
+
+    /// Fit dense lanes to the window after it grew by `prepended` slots at the front.
+    fn resize_dense_lanes(&mut self, prepended: usize) {
+        let len = self.window_len();
+        if prepended > 0 {
+            self.tags.splice(0..0, std::iter::repeat_n(0, prepended));
+            self.numbers
+                .splice(0..0, std::iter::repeat_n(0.0, prepended));
+            self.codes.splice(0..0, std::iter::repeat_n(0, prepended));
+        }
+        self.tags.resize(len, 0);
+        self.numbers.resize(len, 0.0);
+        self.codes.resize(len, 0);
+    }
+
+    /// Switch between sorted and dense lanes as the fill of the window changes.
+    fn relayout(&mut self) {
+        let window = self.window_len();
+        let fill = self.count * Self::DENSE_DEN;
+        if !self.dense && fill >= window {
+            let base = self.window_start();
+            let offsets = std::mem::take(&mut self.offsets);
+            let tags = std::mem::replace(&mut self.tags, vec![0; window]);
+            let numbers = std::mem::replace(&mut self.numbers, vec![0.0; window]);
+            let codes = std::mem::replace(&mut self.codes, vec![0; window]);
+            for (i, off) in offsets.into_iter().enumerate() {
+                let slot = off as usize - base;
+                self.tags[slot] = tags[i];
+                self.numbers[slot] = numbers[i];
+                self.codes[slot] = codes[i];
+            }
+            self.dense = true;
+        } else if self.dense && fill * Self::DENSE_DEN < window {
+            let mut offsets = Vec::with_capacity(self.count);
+            let mut tags = Vec::with_capacity(self.count);
+            let mut numbers = Vec::with_capacity(self.count);
+            let mut codes = Vec::with_capacity(self.count);
+            self.for_each_slot_in(0..usize::MAX, |off, slot| {
+                offsets.push(off as u32);
+                tags.push(self.tags[slot]);
+                numbers.push(self.numbers[slot]);
+                codes.push(self.codes[slot]);
+            });
+            self.offsets = offsets;
+            self.tags = tags;
+            self.numbers = numbers;
+            self.codes = codes;
+            self.dense = false;
+        }
+    }
+
+    #[inline]
+    fn release(&mut self, slot: usize) {
+        if self.tag_at(slot) == TypeTag::Text {
+            self.dead_strings += 1;
+        }
+    }
+
+    /// Drop unreferenced strings once they outnumber the live ones.
+    fn collect_strings(&mut self) {
+        if self.dead_strings < 16 || self.dead_strings * 2 < self.strings.len() {
+            return;
+        }
+        let mut live = Vec::with_capacity(self.strings.len() - self.dead_strings);
+        let mut text_slots = Vec::new();
+        self.for_each_slot_in(0..usize::MAX, |_, slot| {
+            if self.tags[slot] == TypeTag::Text as u8 {
+                text_slots.push(slot);
+            }
+        });
+        for slot in text_slots {
+            live.push(self.strings[self.codes[slot] as usize].clone());
+            self.codes[slot] = (live.len() - 1) as u32;
+        }
+        self.strings = live;
+        self.dead_strings = 0;
+    }
+}
+
+/// Source of `Overlay::generation` values, unique across every overlay in the process.
+static NEXT_OVERLAY_GENERATION: AtomicU64 = AtomicU64::new(1);
+
+#[inline]
+fn next_overlay_generation() -> u64 {
+    NEXT_OVERLAY_GENERATION.fetch_add(1, Ordering::Relaxed)
+}
+
+/// Saturating count of reads that had to consult a non-empty overlay. Compaction uses it
+/// as a priority hint: folding a hot overlay saves the most merge work.
+#[derive(Debug, Default)]
+pub struct OverlayReadHeat(AtomicU32);
+
+impl OverlayReadHeat {
+    const MAX: u32 = 1 << 20;
+
+    #[inline]
+    pub fn get(&self) -> u32 {
+        self.0.load(Ordering::Relaxed)
+    }
+
+    #[inline]
+    fn record(&self) {
+        // Racy increments are fine for a hint; a saturated counter stops writing.
+        let heat = self.get();
+        if heat < Self::MAX {
+            self.0.store(heat + 1, Ordering::Relaxed);
+        }
+    }
+}
+
+impl Clone for OverlayReadHeat {
+    fn clone(&self) -> Self {
+        Self(AtomicU32::new(self.get()))
+    }
+}
+
+/// Process-wide read epoch; the engine advances it once per evaluation request.
+static CHUNK_ACCESS_EPOCH: AtomicU64 = AtomicU64::new(1);
+
+/// Start a new chunk read epoch.
+pub(crate) fn advance_chunk_access_epoch() -> u64 {
+    CHUNK_ACCESS_EPOCH.fetch_add(1, Ordering::Relaxed) + 1
+}
+
+/// How a chunk has been read: the last epoch with a segment scan or a single-cell read,
+/// and how many epochs saw each. The cold tier spills the least recently read chunks
+/// first; the rebalancer sizes chunks from the scan/point mix.
+#[derive(Debug, Default)]
+struct ChunkAccess {
+    last_scan: AtomicU64,
+    last_point: AtomicU64,
+    scan_epochs: AtomicU32,
+    point_epochs: AtomicU32,
+}
+
+impl ChunkAccess {
+    #[inline]
+    fn get(&self) -> u64 {
+        self.last_scan
+            .load(Ordering::Relaxed)
+            .max(self.last_point.load(Ordering::Relaxed))
+    }
+
+    #[inline]
+    fn record_scan(&self) {
+        Self::record(&self.last_scan, &self.scan_epochs);
+    }
+
+    #[inline]
+    fn record_point(&self) {
+        Self::record(&self.last_point, &self.point_epochs);
+    }
+
+    #[inline]
+    fn record(last: &AtomicU64, epochs: &AtomicU32) {
+        // Store only on the first read of an epoch, so hot chunks stay read-shared. Racing
+        // first reads may both count; the counts only steer chunk sizing.
+        let epoch = CHUNK_ACCESS_EPOCH.load(Ordering::Relaxed);
+        if last.load(Ordering::Relaxed) != epoch {
+            last.store(epoch, Ordering::Relaxed);
+            let n = epochs.load(Ordering::Relaxed);
+            epochs.store(n.saturating_add(1), Ordering::Relaxed);
+        }
+    }
+
+    /// `(scan epochs, point epochs)`.
+    #[inline]
+    fn counts(&self) -> (u32, u32) {
+        (
+            self.scan_epochs.load(Ordering::Relaxed),
+            self.point_epochs.load(Ordering::Relaxed),
+        )
+    }
+
+    /// Access of a chunk rebuilt from `parts`, each `(access, rows taken, rows in chunk)`:
+    /// latest epochs, and epoch counts in proportion to the rows taken.
+    fn combine<'a>(parts: impl IntoIterator<Item = (&'a ChunkAccess, usize, usize)>) -> Self {
+        let out = Self::default();
+        let (mut scans, mut points) = (0u64, 0u64);
+        for (access, take, len) in parts {
+            out.last_scan
+                .fetch_max(access.last_scan.load(Ordering::Relaxed), Ordering::Relaxed);
+            out.last_point
+                .fetch_max(access.last_point.load(Ordering::Relaxed), Ordering::Relaxed);
+            let (s, p) = access.counts();
+            let len = len.max(1) as u64;
+            scans += (u64::from(s) * take as u64).div_ceil(len);
+            points += (u64::from(p) * take as u64).div_ceil(len);
+        }
+        out.scan_epochs
+            .store(u32::try_from(scans).unwrap_or(u32::MAX), Ordering::Relaxed);
+        out.point_epochs
+            .store(u32::try_from(points).unwrap_or(u32::MAX), Ordering::Relaxed);
+        out
+    }
+}
+
+impl Clone for ChunkAccess {
+    fn clone(&self) -> Self {
+        Self::combine([(self, 1, 1)])
+    }
+}
+
+#[derive(Debug, Clone)]
 pub struct Overlay {
-    points: HashMap<usize, OverlayValue>,
+    points: OverlayPoints,
     fragments: Vec<OverlayFragment>,
+    // Statistics of every value written since the last clear. Removals do not narrow it.
+    zone: ZoneMap,
+    // Changes on every mutation; a compaction built from a snapshot installs only if the
+    // generation still matches.
+    generation: u64,
+    read_heat: OverlayReadHeat,
     // Deterministic (and intentionally approximate) accounting of overlay memory.
     // This is used for budget enforcement/observability; it does not attempt to reflect
     // the allocator's exact overhead.
     estimated_bytes: usize,
 }
 
-impl Overlay {
-    // Deterministic estimate per entry to keep budget enforcement stable across platforms.
-    // Includes key + map/node overhead (approx) and value payload bytes.
-    const ENTRY_BASE_BYTES: usize = OVERLAY_ENTRY_BASE_BYTES;
+impl Default for Overlay {
+    fn default() -> Self {
+        Self::new()
+    }
+}
 
+impl Overlay {
     pub fn new() -> Self {
         Self {
-            points: HashMap::new(),
+            points: OverlayPoints::default(),
             fragments: Vec::new(),
+            zone: ZoneMap::EMPTY,
+            generation: next_overlay_generation(),
+            read_heat: OverlayReadHeat::default(),
             estimated_bytes: 0,
         }
     }
 
+    #[inline]
+    pub fn zone_map(&self) -> &ZoneMap {
+        &self.zone
+    }
+
+    #[inline]
+    pub fn generation(&self) -> u64 {
+        self.generation
+    }
+
+    /// Reads that consulted this overlay since it was last cleared.
+    #[inline]
+    pub fn read_heat(&self) -> u32 {
+        self.read_heat.get()
+    }
+
+    // Deterministic estimate per entry to keep budget enforcement stable across platforms:
+    // the point lanes plus string bytes, which live outside them.
     #[inline]
     fn point_estimate(v: &OverlayValue) -> usize {
-        Self::ENTRY_BASE_BYTES + v.estimated_payload_bytes()
+        match v {
+            OverlayValue::Text(s) => OVERLAY_POINT_LANE_BYTES + s.len(),
+            _ => OVERLAY_POINT_LANE_BYTES,
+        }
     }
 
     #[inline]
@@ -1887,10 +3657,10 @@ impl Overlay {
     }
 
     #[inline]
-    pub(crate) fn get_scalar(&self, off: usize) -> Option<OverlayScalar<'_>> {
+    pub(crate) fn get_scalar(&self, off: usize) -> Option<OverlayScalar> {
         self.points
-            .get(&off)
-            .map(OverlayScalar::Borrowed)
+            .get(off)
+            .map(OverlayScalar)
             .or_else(|| self.fragments.iter().rev().find_map(|f| f.get_scalar(off)))
     }
 
@@ -1903,6 +3673,8 @@ impl Overlay {
     pub(crate) fn set_scalar(&mut self, off: usize, v: OverlayValue) -> isize {
         let removed = self.remove_scalar(off);
         let new_est = Self::point_estimate(&v);
+        self.generation = next_overlay_generation();
+        self.zone.include_value(&v);
         self.points.insert(off, v);
         self.adjust_estimated_bytes(new_est as isize);
         removed.saturating_add(new_est as isize)
@@ -1918,6 +3690,8 @@ impl Overlay {
         delta = delta.saturating_add(self.remove_fragments_covered_by_fragment(&fragment));
 
         let fragment_est = fragment.estimated_bytes();
+        self.generation = next_overlay_generation();
+        self.zone.merge(&fragment.payload().zone_map());
         self.fragments.push(fragment);
         self.adjust_estimated_bytes(fragment_est as isize);
         delta.saturating_add(fragment_est as isize)
@@ -1928,23 +3702,15 @@ impl Overlay {
         match fragment {
             OverlayFragment::SparseOffsets { offsets, .. } => {
                 for off in offsets.iter().copied() {
-                    if let Some(old) = self.points.remove(&(off as usize)) {
+                    if let Some(old) = self.points.remove(off as usize) {
                         removed = removed.saturating_add(Self::point_estimate(&old));
                     }
                 }
             }
             OverlayFragment::DenseRange { .. } | OverlayFragment::RunRange { .. } => {
                 if let Some(range) = fragment.interval_coverage() {
-                    let keys: Vec<_> = self
-                        .points
-                        .keys()
-                        .copied()
-                        .filter(|off| range.contains(off))
-                        .collect();
-                    for off in keys {
-                        if let Some(old) = self.points.remove(&off) {
-                            removed = removed.saturating_add(Self::point_estimate(&old));
-                        }
+                    for old in self.points.remove_range(range) {
+                        removed = removed.saturating_add(Self::point_estimate(&old));
                     }
                 }
             }
@@ -1982,8 +3748,9 @@ impl Overlay {
 
     #[inline]
     pub(crate) fn remove_scalar(&mut self, off: usize) -> isize {
+        self.generation = next_overlay_generation();
         let mut delta = 0isize;
-        if let Some(old) = self.points.remove(&off) {
+        if let Some(old) = self.points.remove(off) {
             let old_est = Self::point_estimate(&old);
             self.estimated_bytes = self.estimated_bytes.saturating_sub(old_est);
             delta = delta.saturating_sub(old_est as isize);
@@ -2023,19 +3790,12 @@ impl Overlay {
             return 0;
         }
 
+        self.generation = next_overlay_generation();
         let mut delta = 0isize;
-        let removed_points: Vec<_> = self
-            .points
-            .keys()
-            .copied()
-            .filter(|off| range.contains(off))
-            .collect();
-        for off in removed_points {
-            if let Some(old) = self.points.remove(&off) {
-                let old_est = Self::point_estimate(&old);
-                self.estimated_bytes = self.estimated_bytes.saturating_sub(old_est);
-                delta = delta.saturating_sub(old_est as isize);
-            }
+        for old in self.points.remove_range(range.clone()) {
+            let old_est = Self::point_estimate(&old);
+            self.estimated_bytes = self.estimated_bytes.saturating_sub(old_est);
+            delta = delta.saturating_sub(old_est as isize);
         }
 
         if !self.fragments.is_empty() {
@@ -2064,6 +3824,9 @@ impl Overlay {
         let freed = self.estimated_bytes;
         self.points.clear();
         self.fragments.clear();
+        self.zone = ZoneMap::EMPTY;
+        self.generation = next_overlay_generation();
+        self.read_heat = OverlayReadHeat::default();
         self.estimated_bytes = 0;
         freed
     }
@@ -2095,7 +3858,7 @@ impl Overlay {
 
     #[inline]
     pub(crate) fn has_any_in_range(&self, range: core::ops::Range<usize>) -> bool {
-        self.points.keys().any(|k| range.contains(k))
+        self.points.has_any_in_range(range.clone())
             || self
                 .fragments
                 .iter()
@@ -2109,18 +3872,22 @@ impl Overlay {
 
     pub(crate) fn slice(&self, off: usize, len: usize) -> Overlay {
         let mut out = Overlay::new();
+        out.extend_from_slice(self, off, len, 0);
+        out
+    }
+
+    /// Copy the entries of `src` at `off..off + len` to `at..at + len`. The target rows
+    /// must hold no entries yet.
+    pub(crate) fn extend_from_slice(&mut self, src: &Overlay, off: usize, len: usize, at: usize) {
         let end = off.saturating_add(len);
-        for fragment in &self.fragments {
-            if let Some(sliced) = fragment.slice(off, len) {
-                let _ = out.apply_fragment(sliced);
-            }
-        }
-        for (k, v) in self.points.iter() {
-            if *k >= off && *k < end {
-                let _ = out.set_scalar(*k - off, v.clone());
+        for fragment in &src.fragments {
+            if let Some(sliced) = fragment.slice_to(off, len, at) {
+                let _ = self.apply_fragment(sliced);
             }
         }
-        out
+        src.points.for_each_slot_in(off..end, |k, slot| {
+            let _ = self.set_scalar(k - off + at, src.points.value_at(slot));
+        });
     }
 
     /// Iterate over logical `(offset, value)` pairs in the overlay.
@@ -2131,16 +3898,11 @@ impl Overlay {
                 cells.insert(off, value);
             }
         }
-        for (off, value) in &self.points {
-            cells.insert(*off, value.clone());
-        }
+        self.points.for_each_slot_in(0..usize::MAX, |off, slot| {
+            cells.insert(off, self.points.value_at(slot));
+        });
         cells.into_iter()
     }
-
-    /// Iterate over physical point entries only.
-    pub(crate) fn iter_points(&self) -> impl Iterator<Item = (&usize, &OverlayValue)> {
-        self.points.iter()
-    }
 }
 
 #[cfg(test)]
@@ -2173,10 +3935,12 @@ impl Overlay {
 
     pub(crate) fn debug_is_normalized(&self) -> bool {
         let mut covered = std::collections::HashSet::new();
-        for off in self.points.keys().copied() {
-            if !covered.insert(off) {
-                return false;
-            }
+        let mut points_ok = true;
+        self.points.for_each_slot_in(0..usize::MAX, |off, _| {
+            points_ok &= covered.insert(off);
+        });
+        if !points_ok {
+            return false;
         }
         for fragment in &self.fragments {
             for (off, _) in fragment.cells() {
@@ -2189,11 +3953,11 @@ impl Overlay {
     }
 
     pub(crate) fn debug_recomputed_estimated_bytes(&self) -> usize {
-        let point_bytes = self
-            .points
-            .values()
-            .map(Self::point_estimate)
-            .fold(0usize, usize::saturating_add);
+        let mut point_bytes = 0usize;
+        self.points.for_each_slot_in(0..usize::MAX, |_, slot| {
+            point_bytes =
+                point_bytes.saturating_add(Self::point_estimate(&self.points.value_at(slot)));
+        });
         let fragment_bytes = self
             .fragments
             .iter()
@@ -2281,6 +4045,27 @@ impl<T> OverlaySlots<T> {
     }
 }
 
+/// One overlay entry as seen by the numeric and error lanes.
+#[derive(Clone, Copy, Debug, PartialEq)]
+pub struct NumericEdit {
+    /// Row within the selected range.
+    pub row: usize,
+    pub number: Option<f64>,
+    pub error: Option<u8>,
+}
+
+/// Overlay entries over a row range as a sparse correction to the base numeric and error
+/// lanes: `rows` marks the rows the overlay replaces, and `entries` holds their values in
+/// row order.
+#[derive(Clone, Debug)]
+pub struct NumericEdits {
+    pub rows: BooleanBuffer,
+    pub entries: Vec<NumericEdit>,
+}
+
+/// Largest share of a range (1 / n) [`OverlayCascade::numeric_edits`] keeps sparse.
+const SPARSE_EDIT_RATIO: usize = 8;
+
 pub(crate) struct OverlayCascade<'a> {
     user: &'a Overlay,
     computed: &'a Overlay,
@@ -2289,11 +4074,16 @@ pub(crate) struct OverlayCascade<'a> {
 impl<'a> OverlayCascade<'a> {
     #[inline]
     pub(crate) fn new(user: &'a Overlay, computed: &'a Overlay) -> Self {
+        for overlay in [user, computed] {
+            if !overlay.is_empty() {
+                overlay.read_heat.record();
+            }
+        }
         Self { user, computed }
     }
 
     #[inline]
-    pub(crate) fn get_scalar(&self, off: usize) -> Option<OverlayScalar<'a>> {
+    pub(crate) fn get_scalar(&self, off: usize) -> Option<OverlayScalar> {
         self.user
             .get_scalar(off)
             .or_else(|| self.computed.get_scalar(off))
@@ -2536,6 +4326,71 @@ impl<'a> OverlayCascade<'a> {
         )
     }
 
+    /// The overlay entries in `range` as a [`NumericEdits`] correction, for reductions that
+    /// fold the base lanes with a kernel instead of materialising the merged lanes.
+    ///
+    /// `None` when an overlay fragment covers the whole range or more than one row in
+    /// [`SPARSE_EDIT_RATIO`] is edited; `select_numbers` / `select_errors` serve those.
+    pub(crate) fn numeric_edits(&self, range: core::ops::Range<usize>) -> Option<NumericEdits> {
+        let len = range.end.saturating_sub(range.start);
+        for layer in [self.user, self.computed] {
+            if layer.full_cover_dense_fragment(range.clone()).is_some()
+                || layer.full_cover_run_fragment(range.clone()).is_some()
+            {
+                return None;
+            }
+        }
+
+        // Computed first, then user, each fragments before points: later entries win.
+        let mut found = Vec::new();
+        for layer in [self.computed, self.user] {
+            for fragment in &layer.fragments {
+                if !fragment.has_any_in_range(range.clone()) {
+                    continue;
+                }
+                Self::for_each_fragment_payload_index(
+                    fragment,
+                    range.clone(),
+                    |row, payload, idx| {
+                        found.push(NumericEdit {
+                            row,
+                            number: payload.number_at(idx),
+                            error: payload.error_at(idx),
+                        });
+                    },
+                );
+            }
+            layer.points.for_each_slot_in(range.clone(), |off, slot| {
+                found.push(NumericEdit {
+                    row: off - range.start,
+                    number: layer.points.number_at(slot),
+                    error: layer.points.error_at(slot),
+                });
+            });
+            if found.len() * SPARSE_EDIT_RATIO > len {
+                return None;
+            }
+        }
+
+        found.sort_by_key(|edit| edit.row);
+        let mut entries: Vec<NumericEdit> = Vec::with_capacity(found.len());
+        for edit in found {
+            match entries.last_mut() {
+                Some(last) if last.row == edit.row => *last = edit,
+                _ => entries.push(edit),
+            }
+        }
+        let mut rows = BooleanBufferBuilder::new(len);
+        rows.append_n(len, false);
+        for edit in &entries {
+            rows.set_bit(edit.row, true);
+        }
+        Some(NumericEdits {
+            rows: rows.finish(),
+            entries,
+        })
+    }
+
     pub(crate) fn select_type_tags(
         &self,
         range: core::ops::Range<usize>,
@@ -2991,12 +4846,7 @@ impl<'a> OverlayCascade<'a> {
         Self::apply_fragment_layer(layer, range.clone(), slots, |payload, idx| {
             payload.number_at(idx)
         });
-        for (off, value) in layer.iter_points() {
-            if range.contains(off) {
-                slots.set(*off - range.start, value.numeric_lane_value());
-                record_overlay_select_stats(|stats| stats.point_entries_applied += 1);
-            }
-        }
+        Self::apply_point_layer(layer, range, slots, |points, slot| points.number_at(slot));
     }
 
     fn apply_boolean_layer(
@@ -3007,12 +4857,7 @@ impl<'a> OverlayCascade<'a> {
         Self::apply_fragment_layer(layer, range.clone(), slots, |payload, idx| {
             payload.boolean_at(idx)
         });
-        for (off, value) in layer.iter_points() {
-            if range.contains(off) {
-                slots.set(*off - range.start, value.boolean_lane_value());
-                record_overlay_select_stats(|stats| stats.point_entries_applied += 1);
-            }
-        }
+        Self::apply_point_layer(layer, range, slots, |points, slot| points.boolean_at(slot));
     }
 
     fn apply_text_layer(
@@ -3023,15 +4868,9 @@ impl<'a> OverlayCascade<'a> {
         Self::apply_fragment_layer(layer, range.clone(), slots, |payload, idx| {
             payload.text_at(idx).map(ToString::to_string)
         });
-        for (off, value) in layer.iter_points() {
-            if range.contains(off) {
-                slots.set(
-                    *off - range.start,
-                    value.text_lane_value().map(ToString::to_string),
-                );
-                record_overlay_select_stats(|stats| stats.point_entries_applied += 1);
-            }
-        }
+        Self::apply_point_layer(layer, range, slots, |points, slot| {
+            points.text_at(slot).map(ToString::to_string)
+        });
     }
 
     fn apply_error_layer(
@@ -3042,12 +4881,7 @@ impl<'a> OverlayCascade<'a> {
         Self::apply_fragment_layer(layer, range.clone(), slots, |payload, idx| {
             payload.error_at(idx)
         });
-        for (off, value) in layer.iter_points() {
-            if range.contains(off) {
-                slots.set(*off - range.start, value.error_lane_value());
-                record_overlay_select_stats(|stats| stats.point_entries_applied += 1);
-            }
-        }
+        Self::apply_point_layer(layer, range, slots, |points, slot| points.error_at(slot));
     }
 
     fn apply_type_tag_layer(
@@ -3058,12 +4892,9 @@ impl<'a> OverlayCascade<'a> {
         Self::apply_fragment_layer(layer, range.clone(), slots, |payload, idx| {
             payload.type_tag_at(idx).map(|tag| tag as u8)
         });
-        for (off, value) in layer.iter_points() {
-            if range.contains(off) {
-                slots.set(*off - range.start, Some(value.type_tag() as u8));
-                record_overlay_select_stats(|stats| stats.point_entries_applied += 1);
-            }
-        }
+        Self::apply_point_layer(layer, range, slots, |points, slot| {
+            Some(points.tag_at(slot) as u8)
+        });
     }
 
     fn apply_lowered_text_layer(
@@ -3072,12 +4903,22 @@ impl<'a> OverlayCascade<'a> {
         slots: &mut OverlaySlots<String>,
     ) {
         Self::apply_fragment_layer(layer, range.clone(), slots, Self::payload_lowered_text_at);
-        for (off, value) in layer.iter_points() {
-            if range.contains(off) {
-                slots.set(*off - range.start, value.lowered_text_value());
-                record_overlay_select_stats(|stats| stats.point_entries_applied += 1);
-            }
-        }
+        Self::apply_point_layer(layer, range, slots, |points, slot| {
+            points.value_at(slot).lowered_text_value()
+        });
+    }
+
+    fn apply_point_layer<T>(
+        layer: &Overlay,
+        range: core::ops::Range<usize>,
+        slots: &mut OverlaySlots<T>,
+        mut value_at: impl FnMut(&OverlayPoints, usize) -> Option<T>,
+    ) {
+        let start = range.start;
+        layer.points.for_each_slot_in(range, |off, slot| {
+            slots.set(off - start, value_at(&layer.points, slot));
+            record_overlay_select_stats(|stats| stats.point_entries_applied += 1);
+        });
     }
 
     fn apply_fragment_layer<T>(
@@ -3249,7 +5090,7 @@ impl Overlay {
         range: core::ops::Range<usize>,
         shape: OverlayFragmentShape,
     ) -> Option<&OverlayFragment> {
-        if range.is_empty() || self.points.keys().any(|off| range.contains(off)) {
+        if range.is_empty() || self.points.has_any_in_range(range.clone()) {
             return None;
         }
         let mut found = None;
@@ -3354,6 +5195,155 @@ fn append_overlay_value_to_lane_builders(
     }
 }
 
+/// Row-at-a-time builders for a chunk's dense lanes.
+struct LaneRowBuilders {
+    tag_b: UInt8Builder,
+    nb: Float64Builder,
+    bb: BooleanBuilder,
+    sb: StringBuilder,
+    eb: UInt8Builder,
+    non_num: usize,
+    non_bool: usize,
+    non_text: usize,
+    non_err: usize,
+}
+
+impl LaneRowBuilders {
+    fn with_capacity(len: usize) -> Self {
+        Self {
+            tag_b: UInt8Builder::with_capacity(len),
+            nb: Float64Builder::with_capacity(len),
+            bb: BooleanBuilder::with_capacity(len),
+            sb: StringBuilder::with_capacity(len, len * 8),
+            eb: UInt8Builder::with_capacity(len),
+            non_num: 0,
+            non_bool: 0,
+            non_text: 0,
+            non_err: 0,
+        }
+    }
+
+    fn append_value(&mut self, value: &OverlayValue) {
+        append_overlay_value_to_lane_builders(
+            value,
+            &mut self.tag_b,
+            &mut self.nb,
+            &mut self.bb,
+            &mut self.sb,
+            &mut self.eb,
+            &mut self.non_num,
+            &mut self.non_bool,
+            &mut self.non_text,
+            &mut self.non_err,
+        );
+    }
+
+    /// Append base row `i` of `ch`, ignoring its overlays.
+    fn append_base_row(&mut self, ch: &ColumnChunk, i: usize) {
+        if let Some(value) = ch.run_value_at(i) {
+            self.append_value(value);
+            return;
+        }
+        let tag = TypeTag::from_u8(ch.type_tag.value(i));
+        match tag {
+            TypeTag::Empty => {
+                self.tag_b.append_value(TypeTag::Empty as u8);
+                self.nb.append_null();
+                self.bb.append_null();
+                self.sb.append_null();
+                self.eb.append_null();
+            }
+            TypeTag::Number | TypeTag::DateTime | TypeTag::Duration => {
+                self.tag_b.append_value(tag as u8);
+                if let Some(fa) = &ch.numbers {
+                    if fa.is_null(i) {
+                        self.nb.append_null();
+                    } else {
+                        self.nb.append_value(fa.value(i));
+                        self.non_num += 1;
+                    }
+                } else {
+                    self.nb.append_null();
+                }
+                self.bb.append_null();
+                self.sb.append_null();
+                self.eb.append_null();
+            }
+            TypeTag::Boolean => {
+                self.tag_b.append_value(TypeTag::Boolean as u8);
+                self.nb.append_null();
+                if let Some(ba) = &ch.booleans {
+                    if ba.is_null(i) {
+                        self.bb.append_null();
+                    } else {
+                        self.bb.append_value(ba.value(i));
+                        self.non_bool += 1;
+                    }
+                } else {
+                    self.bb.append_null();
+                }
+                self.sb.append_null();
+                self.eb.append_null();
+            }
+            TypeTag::Text => {
+                self.tag_b.append_value(TypeTag::Text as u8);
+                self.nb.append_null();
+                self.bb.append_null();
+                if let Some(text) = ch.text_at(i) {
+                    self.sb.append_value(text);
+                    self.non_text += 1;
+                } else {
+                    self.sb.append_null();
+                }
+                self.eb.append_null();
+            }
+            TypeTag::Error => {
+                self.tag_b.append_value(TypeTag::Error as u8);
+                self.nb.append_null();
+                self.bb.append_null();
+                self.sb.append_null();
+                if let Some(ea) = &ch.errors {
+                    if ea.is_null(i) {
+                        self.eb.append_null();
+                    } else {
+                        self.eb.append_value(ea.value(i));
+                        self.non_err += 1;
+                    }
+                } else {
+                    self.eb.append_null();
+                }
+            }
+            TypeTag::Pending => {
+                self.tag_b.append_value(TypeTag::Pending as u8);
+                self.nb.append_null();
+                self.bb.append_null();
+                self.sb.append_null();
+                self.eb.append_null();
+            }
+        }
+    }
+
+    fn finish(mut self, layer: OverlayLayer, len: usize) -> CompactedLanes {
+        let numbers = self.nb.finish();
+        let booleans = self.bb.finish();
+        let text = self.sb.finish();
+        let errors = self.eb.finish();
+        CompactedLanes {
+            layer,
+            len,
+            tags: share_uniform_tags(self.tag_b.finish()),
+            numbers: (self.non_num > 0).then(|| Arc::new(numbers)),
+            booleans: (self.non_bool > 0).then(|| Arc::new(booleans)),
+            text: (self.non_text > 0).then(|| Arc::new(text) as ArrayRef),
+            errors: (self.non_err > 0).then(|| Arc::new(errors)),
+            non_num: self.non_num,
+            non_bool: self.non_bool,
+            non_text: self.non_text,
+            non_err: self.non_err,
+        }
+    }
+}
+
 impl ArrowSheet {
     /// Create a logical sheet whose cells are initially implicit empty values.
     ///
@@ -3483,10 +5473,13 @@ impl ArrowSheet {
         };
 
         // Overlay takes precedence: user edits over computed over base.
-        let cascade = OverlayCascade::new(&ch.overlay, &ch.computed_overlay);
+        let cascade = ch.point_overlay_cascade();
         if let Some(ov) = cascade.get_scalar(in_off) {
             return ov.to_literal_for(self.date_system);
         }
+        if let Some(value) = ch.run_value_at(in_off) {
+            return value.to_literal_for(self.date_system);
+        }
 
         // Read tag and route to lane.
         let tag_u8 = ch.type_tag.value(in_off);
@@ -3536,20 +5529,10 @@ impl ArrowSheet {
                     LiteralValue::Empty
                 }
             }
-            TypeTag::Text => {
-                if let Some(arr) = &ch.text {
-                    if arr.is_null(in_off) {
-                        return LiteralValue::Empty;
-                    }
-                    let sa = arr
-                        .as_any()
-                        .downcast_ref::<arrow_array::StringArray>()
-                        .unwrap();
-                    LiteralValue::Text(sa.value(in_off).to_string())
-                } else {
-                    LiteralValue::Empty
-                }
-            }
+            TypeTag::Text => ch
+                .text_at(in_off)
+                .map(|s| LiteralValue::Text(s.to_string()))
+                .unwrap_or(LiteralValue::Empty),
             TypeTag::Error => {
                 if let Some(arr) = &ch.errors {
                     if arr.is_null(in_off) {
@@ -3585,12 +5568,7 @@ impl ArrowSheet {
 
         // Extend chunk starts only when `target_rows` crosses a chunk boundary.
         // Example: chunk_size=3, target_rows=6 => chunk_starts=[0,3]
-        let mut next_start = self
-            .chunk_starts
-            .last()
-            .copied()
-            .unwrap_or(0)
-            .saturating_add(chunk_size);
+        let mut next_start = self.next_growth_chunk_start();
         while next_start < target_rows {
             self.chunk_starts.push(next_start);
             next_start = next_start.saturating_add(chunk_size);
@@ -3629,6 +5607,19 @@ impl ArrowSheet {
         }
     }
 
+    /// First row of the chunk that growth past `nrows` opens after the last chunk.
+    ///
+    /// The last chunk grows up to `chunk_rows`; one that is already longer (after
+    /// rebalancing) keeps its length and growth starts a new chunk at `nrows`.
+    pub fn next_growth_chunk_start(&self) -> usize {
+        self.chunk_starts
+            .last()
+            .copied()
+            .unwrap_or(0)
+            .saturating_add(self.chunk_rows.max(1))
+            .max(self.nrows as usize)
+    }
+
     /// Ensure a mutable chunk for a given column/chunk index.
     ///
     /// If the chunk is beyond the column's dense chunk vector, it is stored in `sparse_chunks`.
@@ -3676,37 +5667,22 @@ impl ArrowSheet {
             let mut cur = 0usize;
             for ch in &col0.chunks {
                 self.chunk_starts.push(cur);
-                cur += ch.type_tag.len();
+                cur += ch.len();
             }
         }
     }
 
     fn make_empty_chunk(len: usize) -> ColumnChunk {
-        ColumnChunk {
-            numbers: None,
-            booleans: None,
-            text: None,
-            errors: None,
-            type_tag: Arc::new(UInt8Array::from(vec![TypeTag::Empty as u8; len])),
-            formula_id: None,
-            meta: ColumnChunkMeta {
-                len,
-                non_null_num: 0,
-                non_null_bool: 0,
-                non_null_text: 0,
-                non_null_err: 0,
-            },
-            lazy_null_numbers: OnceCell::new(),
-            lazy_null_booleans: OnceCell::new(),
-            lazy_null_text: OnceCell::new(),
-            lazy_null_errors: OnceCell::new(),
-            lowered_text: OnceCell::new(),
-            overlay: Overlay::new(),
-            computed_overlay: Overlay::new(),
-        }
+        ColumnChunk::from_runs(ChunkRuns::constant(OverlayValue::Empty, len))
     }
 
     fn slice_chunk(ch: &ColumnChunk, off: usize, len: usize) -> ColumnChunk {
+        if let Some(runs) = &ch.runs {
+            let mut out = ColumnChunk::from_runs(runs.slice(off, len));
+            out.overlay = ch.overlay.slice(off, len);
+            out.computed_overlay = ch.computed_overlay.slice(off, len);
+            return out;
+        }
         // Slice type tags
         use arrow_array::Array;
         let type_tag: Arc<UInt8Array> = Arc::new(
@@ -3739,6 +5715,15 @@ impl ArrowSheet {
                 Some(Arc::new(sa) as ArrayRef)
             }
         });
+        // Dictionary-encoded slices keep sharing the column dictionary.
+        let text_codes: Option<Arc<UInt32Array>> = ch.text_codes.as_ref().and_then(|a| {
+            let ca = a.slice(off, len);
+            if ca.null_count() == len {
+                None
+            } else {
+                Some(Arc::new(ca))
+            }
+        });
         let errors: Option<Arc<UInt8Array>> = ch.errors.as_ref().and_then(|a| {
             let sl = Array::slice(a.as_ref(), off, len);
             let ea = sl.as_any().downcast_ref::<UInt8Array>().unwrap().clone();
@@ -3750,14 +5735,21 @@ impl ArrowSheet {
         let computed_overlay = ch.computed_overlay.slice(off, len);
         let non_null_num = numbers.as_ref().map(|a| len - a.null_count()).unwrap_or(0);
         let non_null_bool = booleans.as_ref().map(|a| len - a.null_count()).unwrap_or(0);
-        let non_null_text = text.as_ref().map(|a| len - a.null_count()).unwrap_or(0);
+        let non_null_text = text
+            .as_ref()
+            .map(|a| len - a.null_count())
+            .or_else(|| text_codes.as_ref().map(|a| len - a.null_count()))
+            .unwrap_or(0);
         let non_null_err = errors.as_ref().map(|a| len - a.null_count()).unwrap_or(0);
         ColumnChunk {
             numbers: numbers.clone(),
             booleans: booleans.clone(),
             text: text.clone(),
+            text_codes,
+            text_dict: ch.text_dict.clone(),
             errors: errors.clone(),
             type_tag,
+            runs: None,
             formula_id: None,
             meta: ColumnChunkMeta {
                 len,
@@ -3765,411 +5757,65 @@ impl ArrowSheet {
                 non_null_bool,
                 non_null_text,
                 non_null_err,
+                // The parent's statistics cover any slice of it.
+                zone: ch.meta.zone,
             },
             lazy_null_numbers: OnceCell::new(),
-            lazy_null_booleans: OnceCell::new(),
-            lazy_null_text: OnceCell::new(),
-            lazy_null_errors: OnceCell::new(),
-            lowered_text: OnceCell::new(),
-            overlay,
-            computed_overlay,
-        }
-    }
-
-    /// Heuristic compaction: rebuilds a chunk's base arrays by applying its overlay when
-    /// overlay density crosses thresholds. Returns true if a rebuild occurred.
-    pub fn maybe_compact_chunk(
-        &mut self,
-        col_idx: usize,
-        ch_idx: usize,
-        abs_threshold: usize,
-        frac_den: usize,
-    ) -> usize {
-        if col_idx >= self.columns.len() {
-            return 0;
-        }
-
-        let (len, tags, numbers, booleans, text, errors, non_num, non_bool, non_text, non_err) = {
-            let Some(ch_ref) = self.columns[col_idx].chunk(ch_idx) else {
-                return 0;
-            };
-            let len = ch_ref.type_tag.len();
-            if len == 0 {
-                return 0;
-            }
-
-            let ov_len = ch_ref.overlay.len();
-            let den = frac_den.max(1);
-            let trig = ov_len > (len / den) || ov_len > abs_threshold;
-            if !trig {
-                return 0;
-            }
-
-            // Rebuild: merge base lanes with overlays row-by-row.
-            let mut tag_b = UInt8Builder::with_capacity(len);
-            let mut nb = Float64Builder::with_capacity(len);
-            let mut bb = BooleanBuilder::with_capacity(len);
-            let mut sb = StringBuilder::with_capacity(len, len * 8);
-            let mut eb = UInt8Builder::with_capacity(len);
-            let mut non_num = 0usize;
-            let mut non_bool = 0usize;
-            let mut non_text = 0usize;
-            let mut non_err = 0usize;
-
-            for i in 0..len {
-                // If overlay present, use it. Otherwise, use base tag+lane.
-                if let Some(ov) = ch_ref.overlay.get_scalar(i) {
-                    let ov = ov.to_overlay_value();
-                    append_overlay_value_to_lane_builders(
-                        &ov,
-                        &mut tag_b,
-                        &mut nb,
-                        &mut bb,
-                        &mut sb,
-                        &mut eb,
-                        &mut non_num,
-                        &mut non_bool,
-                        &mut non_text,
-                        &mut non_err,
-                    );
-                } else {
-                    let tag = TypeTag::from_u8(ch_ref.type_tag.value(i));
-                    match tag {
-                        TypeTag::Empty => {
-                            tag_b.append_value(TypeTag::Empty as u8);
-                            nb.append_null();
-                            bb.append_null();
-                            sb.append_null();
-                            eb.append_null();
-                        }
-                        TypeTag::Number | TypeTag::DateTime | TypeTag::Duration => {
-                            tag_b.append_value(tag as u8);
-                            if let Some(a) = &ch_ref.numbers {
-                                let fa = a.as_any().downcast_ref::<Float64Array>().unwrap();
-                                if fa.is_null(i) {
-                                    nb.append_null();
-                                } else {
-                                    nb.append_value(fa.value(i));
-                                    non_num += 1;
-                                }
-                            } else {
-                                nb.append_null();
-                            }
-                            bb.append_null();
-                            sb.append_null();
-                            eb.append_null();
-                        }
-                        TypeTag::Boolean => {
-                            tag_b.append_value(TypeTag::Boolean as u8);
-                            nb.append_null();
-                            if let Some(a) = &ch_ref.booleans {
-                                let ba = a.as_any().downcast_ref::<BooleanArray>().unwrap();
-                                if ba.is_null(i) {
-                                    bb.append_null();
-                                } else {
-                                    bb.append_value(ba.value(i));
-                                    non_bool += 1;
-                                }
-                            } else {
-                                bb.append_null();
-                            }
-                            sb.append_null();
-                            eb.append_null();
-                        }
-                        TypeTag::Text => {
-                            tag_b.append_value(TypeTag::Text as u8);
-                            nb.append_null();
-                            bb.append_null();
-                            if let Some(a) = &ch_ref.text {
-                                let sa = a.as_any().downcast_ref::<StringArray>().unwrap();
-                                if sa.is_null(i) {
-                                    sb.append_null();
-                                } else {
-                                    sb.append_value(sa.value(i));
-                                    non_text += 1;
-                                }
-                            } else {
-                                sb.append_null();
-                            }
-                            eb.append_null();
-                        }
-                        TypeTag::Error => {
-                            tag_b.append_value(TypeTag::Error as u8);
-                            nb.append_null();
-                            bb.append_null();
-                            sb.append_null();
-                            if let Some(a) = &ch_ref.errors {
-                                let ea = a.as_any().downcast_ref::<UInt8Array>().unwrap();
-                                if ea.is_null(i) {
-                                    eb.append_null();
-                                } else {
-                                    eb.append_value(ea.value(i));
-                                    non_err += 1;
-                                }
-                            } else {
-                                eb.append_null();
-                            }
-                        }
-                        TypeTag::Pending => {
-                            tag_b.append_value(TypeTag::Pending as u8);
-                            nb.append_null();
-                            bb.append_null();
-                            sb.append_null();
-                            eb.append_null();
-                        }
-                    }
-                }
-            }
-
-            let tags = Arc::new(tag_b.finish());
-            let numbers = {
-                let a = nb.finish();
-                if non_num == 0 {
-                    None
-                } else {
-                    Some(Arc::new(a))
-                }
-            };
-            let booleans = {
-                let a = bb.finish();
-                if non_bool == 0 {
-                    None
-                } else {
-                    Some(Arc::new(a))
-                }
-            };
-            let text = {
-                let a = sb.finish();
-                if non_text == 0 {
-                    None
-                } else {
-                    Some(Arc::new(a) as ArrayRef)
-                }
-            };
-            let errors = {
-                let a = eb.finish();
-                if non_err == 0 {
-                    None
-                } else {
-                    Some(Arc::new(a))
-                }
-            };
-
-            (
-                len, tags, numbers, booleans, text, errors, non_num, non_bool, non_text, non_err,
-            )
-        };
-
-        let Some(ch_mut) = self.columns[col_idx].chunk_mut(ch_idx) else {
-            return 0;
-        };
-
-        ch_mut.type_tag = tags;
-        ch_mut.numbers = numbers;
-        ch_mut.booleans = booleans;
-        ch_mut.text = text;
-        ch_mut.errors = errors;
-        let freed = ch_mut.overlay.clear();
-        ch_mut.lowered_text = OnceCell::new();
-        ch_mut.meta.len = len;
-        ch_mut.meta.non_null_num = non_num;
-        ch_mut.meta.non_null_bool = non_bool;
-        ch_mut.meta.non_null_text = non_text;
-        ch_mut.meta.non_null_err = non_err;
-        freed
-    }
-
-    /// Compact a dense chunk's computed overlay into its base arrays, freeing overlay memory
-    /// while preserving the data. Returns the number of bytes freed.
-    ///
-    /// This is the computed-overlay counterpart of `maybe_compact_chunk` (which compacts
-    /// user-edit overlays). The read cascade is `overlay → computed_overlay → base`, so
-    /// folding computed overlay entries into base arrays is transparent: the `overlay` layer
-    /// (user edits) is left untouched and still takes precedence on reads.
-    pub fn compact_computed_overlay_chunk(&mut self, col_idx: usize, ch_idx: usize) -> usize {
-        if col_idx >= self.columns.len() {
-            return 0;
-        }
-
-        let (len, tags, numbers, booleans, text, errors, non_num, non_bool, non_text, non_err) = {
-            let Some(ch_ref) = self.columns[col_idx].chunk(ch_idx) else {
-                return 0;
-            };
-            let len = ch_ref.type_tag.len();
-            if len == 0 || ch_ref.computed_overlay.is_empty() {
-                return 0;
-            }
-
-            let mut tag_b = UInt8Builder::with_capacity(len);
-            let mut nb = Float64Builder::with_capacity(len);
-            let mut bb = BooleanBuilder::with_capacity(len);
-            let mut sb = StringBuilder::with_capacity(len, len * 8);
-            let mut eb = UInt8Builder::with_capacity(len);
-            let mut non_num = 0usize;
-            let mut non_bool = 0usize;
-            let mut non_text = 0usize;
-            let mut non_err = 0usize;
-
-            for i in 0..len {
-                if let Some(ov) = ch_ref.computed_overlay.get_scalar(i) {
-                    let ov = ov.to_overlay_value();
-                    append_overlay_value_to_lane_builders(
-                        &ov,
-                        &mut tag_b,
-                        &mut nb,
-                        &mut bb,
-                        &mut sb,
-                        &mut eb,
-                        &mut non_num,
-                        &mut non_bool,
-                        &mut non_text,
-                        &mut non_err,
-                    );
-                } else {
-                    let tag = TypeTag::from_u8(ch_ref.type_tag.value(i));
-                    match tag {
-                        TypeTag::Empty => {
-                            tag_b.append_value(TypeTag::Empty as u8);
-                            nb.append_null();
-                            bb.append_null();
-                            sb.append_null();
-                            eb.append_null();
-                        }
-                        TypeTag::Number | TypeTag::DateTime | TypeTag::Duration => {
-                            tag_b.append_value(tag as u8);
-                            if let Some(a) = &ch_ref.numbers {
-                                let fa = a.as_any().downcast_ref::<Float64Array>().unwrap();
-                                if fa.is_null(i) {
-                                    nb.append_null();
-                                } else {
-                                    nb.append_value(fa.value(i));
-                                    non_num += 1;
-                                }
-                            } else {
-                                nb.append_null();
-                            }
-                            bb.append_null();
-                            sb.append_null();
-                            eb.append_null();
-                        }
-                        TypeTag::Boolean => {
-                            tag_b.append_value(TypeTag::Boolean as u8);
-                            nb.append_null();
-                            if let Some(a) = &ch_ref.booleans {
-                                let ba = a.as_any().downcast_ref::<BooleanArray>().unwrap();
-                                if ba.is_null(i) {
-                                    bb.append_null();
-                                } else {
-                                    bb.append_value(ba.value(i));
-                                    non_bool += 1;
-                                }
-                            } else {
-                                bb.append_null();
-                            }
-                            sb.append_null();
-                            eb.append_null();
-                        }
-                        TypeTag::Text => {
-                            tag_b.append_value(TypeTag::Text as u8);
-                            nb.append_null();
-                            bb.append_null();
-                            if let Some(a) = &ch_ref.text {
-                                let sa = a.as_any().downcast_ref::<StringArray>().unwrap();
-                                if sa.is_null(i) {
-                                    sb.append_null();
-                                } else {
-                                    sb.append_value(sa.value(i));
-                                    non_text += 1;
-                                }
-                            } else {
-                                sb.append_null();
-                            }
-                            eb.append_null();
-                        }
-                        TypeTag::Error => {
-                            tag_b.append_value(TypeTag::Error as u8);
-                            nb.append_null();
-                            bb.append_null();
-                            sb.append_null();
-                            if let Some(a) = &ch_ref.errors {
-                                let ea = a.as_any().downcast_ref::<UInt8Array>().unwrap();
-                                if ea.is_null(i) {
-                                    eb.append_null();
-                                } else {
-                                    eb.append_value(ea.value(i));
-                                    non_err += 1;
-                                }
-                            } else {
-                                eb.append_null();
-                            }
-                        }
-                        TypeTag::Pending => {
-                            tag_b.append_value(TypeTag::Pending as u8);
-                            nb.append_null();
-                            bb.append_null();
-                            sb.append_null();
-                            eb.append_null();
-                        }
-                    }
-                }
-            }
-
-            let tags = Arc::new(tag_b.finish());
-            let numbers = {
-                let a = nb.finish();
-                if non_num == 0 {
-                    None
-                } else {
-                    Some(Arc::new(a))
-                }
-            };
-            let booleans = {
-                let a = bb.finish();
-                if non_bool == 0 {
-                    None
-                } else {
-                    Some(Arc::new(a))
-                }
-            };
-            let text = {
-                let a = sb.finish();
-                if non_text == 0 {
-                    None
-                } else {
-                    Some(Arc::new(a) as ArrayRef)
-                }
-            };
-            let errors = {
-                let a = eb.finish();
-                if non_err == 0 {
-                    None
-                } else {
-                    Some(Arc::new(a))
-                }
-            };
+            lazy_null_booleans: OnceCell::new(),
+            lazy_null_text: OnceCell::new(),
+            lazy_null_errors: OnceCell::new(),
+            lowered_text: OnceCell::new(),
+            decoded_text: OnceCell::new(),
+            overlay,
+            computed_overlay,
+            access: ChunkAccess::default(),
+            cold_type_tag: None,
+        }
+    }
 
-            (
-                len, tags, numbers, booleans, text, errors, non_num, non_bool, non_text, non_err,
-            )
+    /// Heuristic compaction: rebuilds a chunk's base arrays by applying its overlay when
+    /// overlay density crosses thresholds. Returns true if a rebuild occurred.
+    pub fn maybe_compact_chunk(
+        &mut self,
+        col_idx: usize,
+        ch_idx: usize,
+        abs_threshold: usize,
+        frac_den: usize,
+    ) -> usize {
+        let Some(ch_ref) = self.columns.get(col_idx).and_then(|col| col.chunk(ch_idx)) else {
+            return 0;
         };
-
-        let Some(ch_mut) = self.columns[col_idx].chunk_mut(ch_idx) else {
+        if ch_ref.overlay.len() <= ch_ref.overlay_compaction_threshold(abs_threshold, frac_den) {
+            return 0;
+        }
+        let Some(lanes) = ch_ref.build_compacted_lanes(OverlayLayer::User) else {
             return 0;
         };
+        self.columns[col_idx]
+            .chunk_mut(ch_idx)
+            .map_or(0, |ch| ch.install_compacted_lanes(lanes))
+    }
 
-        ch_mut.type_tag = tags;
-        ch_mut.numbers = numbers;
-        ch_mut.booleans = booleans;
-        ch_mut.text = text;
-        ch_mut.errors = errors;
-        let freed = ch_mut.computed_overlay.clear();
-        ch_mut.lowered_text = OnceCell::new();
-        ch_mut.meta.len = len;
-        ch_mut.meta.non_null_num = non_num;
-        ch_mut.meta.non_null_bool = non_bool;
-        ch_mut.meta.non_null_text = non_text;
-        ch_mut.meta.non_null_err = non_err;
-        freed
+    /// Compact a dense chunk's computed overlay into its base arrays, freeing overlay memory
+    /// while preserving the data. Returns the number of bytes freed.
+    ///
+    /// This is the computed-overlay counterpart of `maybe_compact_chunk` (which compacts
+    /// user-edit overlays). The read cascade is `overlay → computed_overlay → base`, so
+    /// folding computed overlay entries into base arrays is transparent: the `overlay` layer
+    /// (user edits) is left untouched and still takes precedence on reads.
+    pub fn compact_computed_overlay_chunk(&mut self, col_idx: usize, ch_idx: usize) -> usize {
+        let Some(ch_ref) = self.columns.get(col_idx).and_then(|col| col.chunk(ch_idx)) else {
+            return 0;
+        };
+        if ch_ref.computed_overlay.is_empty() {
+            return 0;
+        }
+        let Some(lanes) = ch_ref.build_compacted_lanes(OverlayLayer::Computed) else {
+            return 0;
+        };
+        self.columns[col_idx]
+            .chunk_mut(ch_idx)
+            .map_or(0, |ch| ch.install_compacted_lanes(lanes))
     }
 
     /// Compact a sparse chunk's computed overlay into its base arrays.
@@ -4230,7 +5876,7 @@ impl ArrowSheet {
                         new_chunks.push(col.chunks[i].clone());
                     } else {
                         let orig = &col.chunks[i];
-                        let len = orig.type_tag.len();
+                        let len = orig.len();
                         if split_off > 0 {
                             new_chunks.push(Self::slice_chunk(orig, 0, split_off));
                         }
@@ -4343,7 +5989,7 @@ impl ArrowSheet {
                     PlanItem::Empty { .. } => None,
                     PlanItem::Slice { old_idx, off, len } => match get_old(old_idx) {
                         Some(orig) => {
-                            if off == 0 && len == orig.type_tag.len() {
+                            if off == 0 && len == orig.len() {
                                 Some(orig.clone())
                             } else {
                                 Some(Self::slice_chunk(orig, off, len))
@@ -4403,7 +6049,7 @@ impl ArrowSheet {
                 let mut new_chunks: Vec<ColumnChunk> = Vec::new();
                 let mut cur_start = 0usize;
                 for ch in &col.chunks {
-                    let len = ch.type_tag.len();
+                    let len = ch.len();
                     let ch_end = cur_start + len;
                     // No overlap
                     if ch_end <= start || cur_start >= end {
@@ -4531,7 +6177,7 @@ impl ArrowSheet {
                 let produced: Option<ColumnChunk> = match *item {
                     PlanItem::Slice { old_idx, off, len } => match get_old(old_idx) {
                         Some(orig) => {
-                            if off == 0 && len == orig.type_tag.len() {
+                            if off == 0 && len == orig.len() {
                                 Some(orig.clone())
                             } else {
                                 Some(Self::slice_chunk(orig, off, len))
@@ -4582,11 +6228,7 @@ impl ArrowSheet {
                 .all(|c| c.sparse_chunks.is_empty() && c.chunks.len() == self.chunk_starts.len());
 
         let lens: Vec<usize> = if dense_aligned {
-            self.columns[0]
-                .chunks
-                .iter()
-                .map(|c| c.type_tag.len())
-                .collect()
+            self.columns[0].chunks.iter().map(|c| c.len()).collect()
         } else if self.columns.is_empty() {
             // No columns: single chunk matching nrows if any
             if self.nrows > 0 {
@@ -5163,6 +6805,527 @@ mod tests {
         assert_eq!(nums[1].1, 1);
     }
 
+    #[test]
+    fn ingest_dictionary_encodes_low_cardinality_text() {
+        let regions = ["East", "west", "EAST"];
+        let mut b = IngestBuilder::new("S", 2, 8, crate::engine::DateSystem::Excel1900);
+        for i in 0..16 {
+            let region = if i % 5 == 4 {
+                LiteralValue::Empty
+            } else {
+                LiteralValue::Text(regions[i % regions.len()].into())
+            };
+            b.append_row(&[region, LiteralValue::Text(format!("id-{i}"))])
+                .unwrap();
+        }
+        let sheet = b.finish();
+
+        let regions_col = &sheet.columns[0];
+        let dict = regions_col.chunks[0].text_dict.clone().expect("dictionary");
+        for ch in &regions_col.chunks {
+            assert!(ch.text.is_none());
+            assert!(Arc::ptr_eq(ch.text_dict.as_ref().unwrap(), &dict));
+        }
+        assert_eq!(dict.len(), 3);
+        assert_eq!(dict.lowered_values().len(), 2);
+        assert_eq!(dict.lowered_id(0), dict.lowered_id(2));
+
+        // Unique ids stay plain Utf8.
+        assert!(
+            sheet.columns[1]
+                .chunks
+                .iter()
+                .all(|ch| ch.text_codes.is_none())
+        );
+
+        let rv = sheet.range_view(0, 0, 15, 0);
+        assert_eq!(rv.get_cell(2, 0), LiteralValue::Text("EAST".into()));
+        assert_eq!(rv.get_cell(4, 0), LiteralValue::Empty);
+        let lowered: Vec<Option<String>> = rv
+            .lowered_text_slices()
+            .flat_map(|res| {
+                let (_, _, cols) = res.unwrap();
+                cols[0]
+                    .iter()
+                    .map(|v| v.map(str::to_string))
+                    .collect::<Vec<_>>()
+            })
+            .collect();
+        assert_eq!(lowered[0].as_deref(), Some("east"));
+        assert_eq!(lowered[2].as_deref(), Some("east"));
+        assert_eq!(lowered[4], None);
+
+        let codes = rv.slice_text_codes(0, 16).pop().unwrap().expect("codes");
+        let east = codes.eq_lowered("east");
+        let hits: Vec<usize> = (0..16).filter(|&i| east.value(i)).collect();
+        assert_eq!(hits, vec![0, 2, 3, 5, 6, 8, 11, 12, 15]);
+    }
+
+    #[test]
+    fn compaction_keeps_dictionary_codes_until_a_new_string_arrives() {
+        let mut b = IngestBuilder::new("S", 1, 8, crate::engine::DateSystem::Excel1900);
+        for i in 0..8 {
+            let v = if i % 2 == 0 { "Yes" } else { "No" };
+            b.append_row(&[LiteralValue::Text(v.into())]).unwrap();
+        }
+        let mut sheet = b.finish();
+
+        sheet.columns[0].chunks[0]
+            .overlay
+            .set(1, OverlayValue::Text(Arc::from("Yes")));
+        assert!(sheet.range_view(0, 0, 7, 0).slice_text_codes(0, 8)[0].is_none());
+        assert!(sheet.maybe_compact_chunk(0, 0, 0, 1) > 0);
+        let ch = &sheet.columns[0].chunks[0];
+        assert!(ch.text.is_none() && ch.text_codes.is_some());
+        assert_eq!(ch.text_at(1), Some("Yes"));
+
+        sheet.columns[0].chunks[0]
+            .overlay
+            .set(3, OverlayValue::Text(Arc::from("Maybe")));
+        assert!(sheet.maybe_compact_chunk(0, 0, 0, 1) > 0);
+        let ch = &sheet.columns[0].chunks[0];
+        assert!(ch.text_codes.is_none());
+        assert_eq!(
+            sheet.get_cell_value(3, 0),
+            LiteralValue::Text("Maybe".into())
+        );
+        assert_eq!(sheet.get_cell_value(1, 0), LiteralValue::Text("Yes".into()));
+    }
+
+    #[test]
+    fn ingest_run_encodes_constant_and_repetitive_chunks() {
+        let mut b = IngestBuilder::new("S", 3, 64, crate::engine::DateSystem::Excel1900);
+        for i in 0..128 {
+            let flag = if i < 100 { "Y" } else { "N" };
+            b.append_row(&[
+                LiteralValue::Number(7.5),
+                LiteralValue::Text(flag.into()),
+                LiteralValue::Number(f64::from(i)),
+            ])
+            .unwrap();
+        }
+        let sheet = b.finish();
+
+        let constant = &sheet.columns[0].chunks[0];
+        assert!(constant.runs.as_ref().is_some_and(|r| r.is_constant()));
+        assert_eq!(constant.len(), 64);
+        assert_eq!(constant.meta.non_null_num, 64);
+        let dense = &sheet.columns[2].chunks[0];
+        assert!(dense.runs.is_none());
+        assert!(constant.estimated_base_bytes() * 10 < dense.estimated_base_bytes());
+        assert_eq!(
+            sheet.columns[1].chunks[1]
+                .runs
+                .as_ref()
+                .unwrap()
+                .run_count(),
+            2
+        );
+
+        assert_eq!(sheet.get_cell_value(70, 0), LiteralValue::Number(7.5));
+        assert_eq!(sheet.get_cell_value(99, 1), LiteralValue::Text("Y".into()));
+        assert_eq!(sheet.get_cell_value(100, 1), LiteralValue::Text("N".into()));
+
+        let view = sheet.range_view(10, 0, 120, 1);
+        let mut sum = 0.0;
+        for (_, _, cols) in view.numeric_segments().map(|r| r.unwrap()) {
+            for col in &cols {
+                assert!(matches!(
+                    col,
+                    crate::engine::range_view::NumericSegment::Runs { .. }
+                ));
+                sum += col.sum();
+            }
+        }
+        assert_eq!(sum, 7.5 * 111.0);
+        let text: Vec<_> = view.text_slices().map(|r| r.unwrap()).collect();
+        let second = text[1].2[1].as_any().downcast_ref::<StringArray>().unwrap();
+        assert_eq!(second.value(35), "Y");
+        assert_eq!(second.value(36), "N");
+    }
+
+    #[test]
+    fn run_encoded_chunks_survive_row_edits_and_compaction() {
+        let mut b = IngestBuilder::new("S", 1, 32, crate::engine::DateSystem::Excel1900);
+        for _ in 0..32 {
+            b.append_row(&[LiteralValue::Boolean(true)]).unwrap();
+        }
+        let mut sheet = b.finish();
+        assert!(sheet.columns[0].chunks[0].runs.is_some());
+
+        sheet.insert_rows(10, 2);
+        assert_eq!(sheet.get_cell_value(9, 0), LiteralValue::Boolean(true));
+        assert_eq!(sheet.get_cell_value(10, 0), LiteralValue::Empty);
+        assert_eq!(sheet.get_cell_value(12, 0), LiteralValue::Boolean(true));
+        assert!(sheet.columns[0].chunks.iter().all(|ch| ch.runs.is_some()));
+
+        let (ch_idx, off) = sheet.chunk_of_row(12).unwrap();
+        sheet.columns[0].chunks[ch_idx]
+            .overlay
+            .set(off, OverlayValue::Number(3.0));
+        assert!(sheet.maybe_compact_chunk(0, ch_idx, 0, 1) > 0);
+        let ch = &sheet.columns[0].chunks[ch_idx];
+        assert!(ch.runs.is_none());
+        assert_eq!(ch.meta.non_null_num, 1);
+        assert_eq!(sheet.get_cell_value(12, 0), LiteralValue::Number(3.0));
+        assert_eq!(sheet.get_cell_value(13, 0), LiteralValue::Boolean(true));
+    }
+
+    #[test]
+    fn zone_maps_track_ingest_overlay_and_compaction() {
+        let mut b = IngestBuilder::new("S", 2, 4, crate::engine::DateSystem::Excel1900);
+        for i in 0..8 {
+            let text = if i < 4 {
+                LiteralValue::Text(if i % 2 == 0 { "East" } else { "west" }.into())
+            } else {
+                LiteralValue::Empty
+            };
+            b.append_row(&[LiteralValue::Number(f64::from(i) * 10.0), text])
+                .unwrap();
+        }
+        let mut sheet = b.finish();
+
+        let nums = &sheet.columns[0].chunks;
+        assert_eq!(
+            (nums[0].meta.zone.num_min, nums[0].meta.zone.num_max),
+            (0.0, 30.0)
+        );
+        assert_eq!(
+            (nums[1].meta.zone.num_min, nums[1].meta.zone.num_max),
+            (40.0, 70.0)
+        );
+        assert!(nums.iter().all(|ch| ch.zone_map().numbers_ascending));
+        assert!(!nums[0].zone_map().has_blank && !nums[0].zone_map().has_text);
+
+        let text = sheet.columns[1].chunks[0].zone_map();
+        assert!(text.has_text && !text.has_blank && !text.has_numbers());
+        assert!(text.may_contain_text("east") && text.may_contain_text("west"));
+        assert_eq!(text.coerced_number_range(), None);
+        let blank = sheet.columns[1].chunks[1].zone_map();
+        assert!(blank.has_blank && !blank.has_text);
+        assert_eq!(blank.coerced_number_range(), Some((0.0, 0.0)));
+
+        // Overlay writes widen the chunk's statistics until compaction recomputes them.
+        sheet.columns[0].chunks[1]
+            .overlay
+            .set(1, OverlayValue::Number(-5.0));
+        let widened = sheet.columns[0].chunks[1].zone_map();
+        assert_eq!((widened.num_min, widened.num_max), (-5.0, 70.0));
+        assert!(!widened.numbers_ascending);
+        sheet.columns[0].chunks[1]
+            .overlay
+            .set(1, OverlayValue::Number(45.0));
+        assert_eq!(sheet.columns[0].chunks[1].zone_map().num_min, -5.0);
+
+        assert!(sheet.maybe_compact_chunk(0, 1, 0, 1) > 0);
+        let compacted = sheet.columns[0].chunks[1].zone_map();
+        assert_eq!((compacted.num_min, compacted.num_max), (40.0, 70.0));
+        assert!(compacted.numbers_ascending);
+    }
+
+    fn fragmented_sheet() -> ArrowSheet {
+        let mut b = IngestBuilder::new("S", 2, 4, crate::engine::DateSystem::Excel1900);
+        for r in 0..32 {
+            b.append_row(&[
+                LiteralValue::Number(r as f64),
+                if r % 3 == 0 {
+                    LiteralValue::Empty
+                } else {
+                    LiteralValue::Text(format!("t{r}"))
+                },
+            ])
+            .unwrap();
+        }
+        let mut sheet = b.finish();
+        for at in [1, 5, 9, 14, 20] {
+            sheet.insert_rows(at, 1);
+        }
+        sheet.delete_rows(25, 2);
+        sheet
+    }
+
+    fn sheet_values(sheet: &ArrowSheet) -> Vec<LiteralValue> {
+        (0..sheet.nrows as usize)
+            .flat_map(|r| (0..sheet.columns.len()).map(move |c| (r, c)))
+            .map(|(r, c)| sheet.get_cell_value(r, c))
+            .collect()
+    }
+
+    #[test]
+    fn rebalancing_merges_fragmented_chunks_and_keeps_values() {
+        let mut sheet = fragmented_sheet();
+        let (ch_idx, off) = sheet.chunk_of_row(6).unwrap();
+        sheet.columns[0].chunks[ch_idx]
+            .overlay
+            .set(off, OverlayValue::Number(-6.0));
+        let (ch_idx, off) = sheet.chunk_of_row(22).unwrap();
+        sheet.columns[1].chunks[ch_idx]
+            .computed_overlay
+            .set(off, OverlayValue::Text("calc".into()));
+        let before = sheet_values(&sheet);
+        let chunks_before = sheet.chunk_starts.len();
+
+        assert!(sheet.rebalance_chunks(4));
+        assert!(sheet.chunk_starts.len() < chunks_before);
+        let lens = sheet.chunk_lens();
+        let interior = &lens[..lens.len() - 1];
+        assert!(
+            interior.iter().all(|&len| (2..=8).contains(&len)),
+            "{lens:?}"
+        );
+        for col in &sheet.columns {
+            let col_lens: Vec<usize> = col.chunks.iter().map(ColumnChunk::len).collect();
+            assert_eq!(col_lens, lens);
+        }
+        assert_eq!(sheet_values(&sheet), before);
+        assert_eq!(sheet.get_cell_value(6, 0), LiteralValue::Number(-6.0));
+        assert!(!sheet.rebalance_chunks(4));
+
+        // Growth after rebalancing still lines chunks up with `chunk_starts`.
+        sheet.ensure_row_capacity(sheet.nrows as usize + 9);
+        let lens = sheet.chunk_lens();
+        assert_eq!(lens.iter().sum::<usize>(), sheet.nrows as usize);
+        assert!(lens.iter().all(|&len| len > 0));
+        for (ch, &len) in sheet.columns[0].chunks.iter().zip(&lens) {
+            assert_eq!(ch.len(), len);
+        }
+    }
+
+    #[test]
+    fn stale_rebalance_is_not_installed() {
+        let mut sheet = fragmented_sheet();
+        let job = sheet.rebalance_job(4).unwrap();
+        sheet.insert_rows(3, 1);
+        let before = sheet.chunk_starts.clone();
+        assert!(sheet.install_rebalanced(job.run()).is_none());
+        assert_eq!(sheet.chunk_starts, before);
+    }
+
+    #[test]
+    fn scan_heavy_sheets_target_longer_chunks() {
+        let sheet = fragmented_sheet();
+        assert_eq!(sheet.target_chunk_rows(), 4);
+        for _ in 0..3 {
+            advance_chunk_access_epoch();
+            for ch in &sheet.columns[0].chunks {
+                let _ = ch.overlay_cascade();
+            }
+        }
+        assert_eq!(sheet.target_chunk_rows(), 16);
+        for _ in 0..40 {
+            advance_chunk_access_epoch();
+            for ch in &sheet.columns[1].chunks {
+                let _ = ch.point_overlay_cascade();
+            }
+        }
+        assert_eq!(sheet.target_chunk_rows(), 4);
+    }
+
+    #[test]
+    fn sparse_overlay_edits_fold_as_a_kernel_correction() {
+        use crate::engine::range_view::NumericSegment;
+
+        let mut b = IngestBuilder::new("S", 1, 256, crate::engine::DateSystem::Excel1900);
+        for i in 0..200 {
+            let v = if i % 7 == 3 {
+                LiteralValue::Text("t".into())
+            } else {
+                LiteralValue::Number(f64::from(i) - 80.0)
+            };
+            b.append_row(&[v]).unwrap();
+        }
+        let mut sheet = b.finish();
+        let ch = &mut sheet.columns[0].chunks[0];
+        ch.computed_overlay.set(10, OverlayValue::Number(500.0));
+        ch.computed_overlay.set(11, OverlayValue::Number(1.0));
+        ch.overlay
+            .set(11, OverlayValue::Text(Arc::from("user wins")));
+        ch.overlay.set(17, OverlayValue::Number(-900.0));
+        ch.overlay.set(150, OverlayValue::DateTime(45_000.0));
+
+        let numbers: Vec<f64> = (0..200)
+            .filter_map(|row| match sheet.get_cell_value(row, 0) {
+                LiteralValue::Number(n) => Some(n),
+                LiteralValue::Date(_) | LiteralValue::DateTime(_) => Some(45_000.0),
+                _ => None,
+            })
+            .collect();
+        let view = sheet.range_view(0, 0, 199, 0);
+        let segments: Vec<_> = view.numeric_segments().map(|r| r.unwrap()).collect();
+        let col = &segments[0].2[0];
+        assert!(matches!(col, NumericSegment::Dense { edits: Some(_), .. }));
+        assert_eq!(col.count(), numbers.len());
+        assert_eq!(col.sum(), numbers.iter().sum::<f64>());
+        assert_eq!(col.min_max(), Some((-900.0, 45_000.0)));
+        assert_eq!(col.first_error(), None);
+        let moments = col.moments();
+        let mean = moments.mean().unwrap();
+        let devsq: f64 = numbers.iter().map(|n| (n - mean) * (n - mean)).sum();
+        assert!((moments.devsq() - devsq).abs() < 1e-6 * devsq);
+
+        // Errors report in row order across base rows and edits.
+        let ch = &mut sheet.columns[0].chunks[0];
+        ch.overlay
+            .set(40, OverlayValue::Error(map_error_code(ExcelErrorKind::Na)));
+        ch.overlay
+            .set(30, OverlayValue::Error(map_error_code(ExcelErrorKind::Div)));
+        let view = sheet.range_view(0, 0, 199, 0);
+        let segments: Vec<_> = view.numeric_segments().map(|r| r.unwrap()).collect();
+        assert_eq!(
+            segments[0].2[0].first_error(),
+            Some(map_error_code(ExcelErrorKind::Div))
+        );
+    }
+
+    #[test]
+    fn homogeneous_chunks_share_uniform_tag_lanes() {
+        let mut b = IngestBuilder::new("S", 2, 4, crate::engine::DateSystem::Excel1900);
+        for i in 0..8 {
+            let mixed = if i == 5 {
+                LiteralValue::Text("x".into())
+            } else {
+                LiteralValue::Number(f64::from(i))
+            };
+            b.append_row(&[LiteralValue::Number(f64::from(i) * 1.5), mixed])
+                .unwrap();
+        }
+        let mut sheet = b.finish();
+
+        let nums = &sheet.columns[0].chunks;
+        assert!(
+            nums.iter()
+                .all(|ch| ch.uniform_type_tag() == Some(TypeTag::Number))
+        );
+        assert_eq!(
+            nums[0].type_tag.values().as_ptr(),
+            nums[1].type_tag.values().as_ptr()
+        );
+        // Shared lanes are not charged to any chunk.
+        assert_eq!(
+            nums[0].estimated_base_bytes(),
+            nums[0].numbers.as_ref().unwrap().get_array_memory_size()
+        );
+
+        let mixed = &sheet.columns[1].chunks;
+        assert_eq!(mixed[0].uniform_type_tag(), Some(TypeTag::Number));
+        assert_eq!(mixed[1].uniform_type_tag(), None);
+        // A lane a chunk owns is never taken for a shared one, even when its rows agree.
+        assert_eq!(uniform_type_tag(&UInt8Array::from(vec![1u8; 4])), None);
+        // Lanes longer than the smallest shared buffer, and slices of them, are shared too.
+        let long = uniform_tags(TypeTag::Boolean, 300_000);
+        assert_eq!(uniform_type_tag(&long), Some(TypeTag::Boolean));
+        assert_eq!(
+            uniform_type_tag(&long.slice(200_000, 90_000)),
+            Some(TypeTag::Boolean)
+        );
+        let text = tag_mask(&mixed[1].type_tag, TypeTag::Text);
+        assert_eq!(text.iter().collect::<Vec<_>>(), [false, true, false, false]);
+        assert_eq!(
+            tag_mask(&nums[0].type_tag, TypeTag::Number).count_set_bits(),
+            4
+        );
+        assert_eq!(
+            tag_mask(&nums[0].type_tag, TypeTag::Empty).count_set_bits(),
+            0
+        );
+
+        // Compacting an edit that removes the only text row makes the chunk uniform.
+        sheet.columns[1].chunks[1]
+            .overlay
+            .set(1, OverlayValue::Number(5.0));
+        assert!(sheet.maybe_compact_chunk(1, 1, 0, 1) > 0);
+        assert_eq!(
+            sheet.columns[1].chunks[1].uniform_type_tag(),
+            Some(TypeTag::Number)
+        );
+    }
+
+    #[test]
+    fn compacted_snapshot_keeps_later_overlay_writes() {
+        let mut b = IngestBuilder::new("S", 1, 8, crate::engine::DateSystem::Excel1900);
+        for i in 0..8 {
+            b.append_row(&[LiteralValue::Number(f64::from(i))]).unwrap();
+        }
+        let mut sheet = b.finish();
+        let ch = &mut sheet.columns[0].chunks[0];
+        ch.overlay.set(1, OverlayValue::Number(10.0));
+        ch.overlay.set(2, OverlayValue::Text(Arc::from("x")));
+
+        let snapshot = ch.clone();
+        let lanes = snapshot.build_compacted_lanes(OverlayLayer::User).unwrap();
+        // Written after the snapshot: one new cell, one overwrite of a folded cell.
+        ch.overlay.set(5, OverlayValue::Boolean(true));
+        ch.overlay.set(1, OverlayValue::Number(11.0));
+        assert!(ch.install_compacted_snapshot(&snapshot, lanes).is_some());
+
+        assert_eq!(ch.overlay.len(), 2);
+        assert_eq!(ch.meta.non_null_text, 1);
+        assert_eq!(sheet.get_cell_value(1, 0), LiteralValue::Number(11.0));
+        assert_eq!(sheet.get_cell_value(2, 0), LiteralValue::Text("x".into()));
+        assert_eq!(sheet.get_cell_value(5, 0), LiteralValue::Boolean(true));
+        assert_eq!(sheet.get_cell_value(6, 0), LiteralValue::Number(6.0));
+
+        // A folded entry removed since the snapshot cannot be rebased; nothing installs.
+        let ch = &mut sheet.columns[0].chunks[0];
+        let snapshot = ch.clone();
+        let lanes = snapshot.build_compacted_lanes(OverlayLayer::User).unwrap();
+        ch.overlay.remove(5);
+        assert!(ch.install_compacted_snapshot(&snapshot, lanes).is_none());
+        assert_eq!(sheet.get_cell_value(5, 0), LiteralValue::Number(5.0));
+    }
+
+    #[cfg(not(target_arch = "wasm32"))]
+    #[test]
+    fn spilled_chunks_read_the_same_and_reheap_on_rewrite() {
+        let mut b = IngestBuilder::new("S", 2, 8, crate::engine::DateSystem::Excel1900);
+        for i in 0..16 {
+            let second = match i % 3 {
+                0 => LiteralValue::Text(format!("t{i}")),
+                1 => LiteralValue::Boolean(i % 2 == 0),
+                _ => LiteralValue::Empty,
+            };
+            b.append_row(&[LiteralValue::Number(f64::from(i) * 1.5), second])
+                .unwrap();
+        }
+        let mut sheet = b.finish();
+        let before: Vec<LiteralValue> = (0..16)
+            .flat_map(|r| [sheet.get_cell_value(r, 0), sheet.get_cell_value(r, 1)])
+            .collect();
+        let resident: usize = sheet
+            .columns
+            .iter()
+            .flat_map(|c| c.chunks.iter())
+            .map(ColumnChunk::resident_lane_bytes)
+            .sum();
+
+        let chunks: Vec<&mut ColumnChunk> = sheet
+            .columns
+            .iter_mut()
+            .flat_map(|c| c.chunks.iter_mut())
+            .collect();
+        let outcome = cold::spill(chunks);
+        assert_eq!((outcome.chunks, outcome.errors), (4, 0));
+        assert_eq!(outcome.freed, resident);
+        for ch in sheet.columns.iter().flat_map(|c| c.chunks.iter()) {
+            assert!(ch.is_cold());
+            assert_eq!(ch.resident_lane_bytes(), 0);
+        }
+        let after: Vec<LiteralValue> = (0..16)
+            .flat_map(|r| [sheet.get_cell_value(r, 0), sheet.get_cell_value(r, 1)])
+            .collect();
+        assert_eq!(before, after);
+
+        // Folding an edit rewrites the lanes on the heap.
+        sheet.columns[0].chunks[1]
+            .overlay
+            .set(0, OverlayValue::Number(-1.0));
+        assert!(sheet.maybe_compact_chunk(0, 1, 0, 1) > 0);
+        assert!(!sheet.columns[0].chunks[1].is_cold());
+        assert!(sheet.columns[0].chunks[0].is_cold());
+        assert_eq!(sheet.get_cell_value(8, 0), LiteralValue::Number(-1.0));
+        assert_eq!(sheet.get_cell_value(9, 0), LiteralValue::Number(13.5));
+    }
+
     #[test]
     fn overlay_precedence_user_over_computed() {
         let mut b = IngestBuilder::new("S", 1, 8, crate::engine::DateSystem::Excel1900);
@@ -5781,7 +7944,72 @@ mod tests {
                 (5, OverlayValue::Text(Arc::from("point"))),
             ]
         );
-        assert_eq!(overlay.iter_points().count(), 1);
+        assert_eq!(overlay.debug_stats().points, 1);
+    }
+
+    #[test]
+    fn overlay_points_match_a_map_across_layouts() {
+        let mut points = OverlayPoints::default();
+        let mut model: BTreeMap<usize, OverlayValue> = BTreeMap::new();
+        let value = |i: usize| match i % 5 {
+            0 => OverlayValue::Number(i as f64),
+            1 => OverlayValue::Text(Arc::from(format!("t{}", i % 7))),
+            2 => OverlayValue::Boolean(i % 2 == 0),
+            3 => OverlayValue::Error(i as u8),
+            _ => OverlayValue::Empty,
+        };
+        let check = |points: &OverlayPoints, model: &BTreeMap<usize, OverlayValue>| {
+            let mut seen = Vec::new();
+            points.for_each_slot_in(0..usize::MAX, |off, slot| {
+                seen.push((off, points.value_at(slot)))
+            });
+            let expected: Vec<_> = model.iter().map(|(k, v)| (*k, v.clone())).collect();
+            assert_eq!(seen, expected);
+            assert_eq!(points.len(), model.len());
+            for off in [0, 63, 64, 500, 999, 1000, 4000] {
+                assert_eq!(points.get(off), model.get(&off).cloned(), "offset {off}");
+                assert_eq!(
+                    points.has_any_in_range(off..off + 70),
+                    model.range(off..off + 70).next().is_some()
+                );
+            }
+        };
+
+        // Scattered writes stay sorted; filling the window switches to dense lanes.
+        for i in 0..40 {
+            let off = (i * 7919) % 1000;
+            assert_eq!(points.insert(off, value(i)), model.insert(off, value(i)));
+        }
+        assert!(!points.dense);
+        check(&points, &model);
+        for off in (0..1000).rev() {
+            assert_eq!(
+                points.insert(off, value(off)),
+                model.insert(off, value(off))
+            );
+        }
+        assert!(points.dense);
+        check(&points, &model);
+
+        // Overwrites retire strings; a window that grows past the entries falls back to
+        // sorted lanes.
+        for off in 0..1000 {
+            points.insert(off, OverlayValue::Number(1.0));
+            model.insert(off, OverlayValue::Number(1.0));
+        }
+        assert!(points.strings.len() < 100);
+        let removed = points.remove_range(100..1000);
+        assert_eq!(removed.len(), 900);
+        model.retain(|k, _| *k < 100);
+        check(&points, &model);
+        points.insert(4000, value(1));
+        model.insert(4000, value(1));
+        assert!(!points.dense);
+        check(&points, &model);
+        for off in model.keys().copied().collect::<Vec<_>>() {
+            assert_eq!(points.remove(off), model.remove(&off));
+        }
+        assert!(points.is_empty() && points.present.is_empty());
     }
 
     #[test]
@@ -6318,13 +8546,9 @@ mod tests {
         // chunk_starts should be [0,2,4]
         assert_eq!(sheet.chunk_starts, vec![0, 2, 4]);
         // All columns must share per-chunk lengths equal to [2,2,1]
-        let lens0: Vec<usize> = sheet.columns[0]
-            .chunks
-            .iter()
-            .map(|ch| ch.type_tag.len())
-            .collect();
+        let lens0: Vec<usize> = sheet.columns[0].chunks.iter().map(|ch| ch.len()).collect();
         for col in &sheet.columns[1..] {
-            let lens: Vec<usize> = col.chunks.iter().map(|ch| ch.type_tag.len()).collect();
+            let lens: Vec<usize> = col.chunks.iter().map(|ch| ch.len()).collect();
             assert_eq!(lens, lens0);
         }
     }
@@ -6410,23 +8634,15 @@ mod tests {
         let av2 = sheet.range_view(0, 0, (sheet.nrows - 1) as usize, 0);
         assert_eq!(av2.get_cell(3, 0), LiteralValue::Number(40.0));
         // All columns share chunk lengths; chunk_starts monotonic and cover nrows
-        let lens0: Vec<usize> = sheet.columns[0]
-            .chunks
-            .iter()
-            .map(|ch| ch.type_tag.len())
-            .collect();
+        let lens0: Vec<usize> = sheet.columns[0].chunks.iter().map(|ch| ch.len()).collect();
         for col in &sheet.columns {
-            let lens: Vec<usize> = col.chunks.iter().map(|ch| ch.type_tag.len()).collect();
+            let lens: Vec<usize> = col.chunks.iter().map(|ch| ch.len()).collect();
             assert_eq!(lens, lens0);
         }
         // chunk_starts should be monotonic and final chunk end == nrows
         assert!(sheet.chunk_starts.windows(2).all(|w| w[0] < w[1]));
         let last_start = *sheet.chunk_starts.last().unwrap_or(&0);
-        let last_len = sheet.columns[0]
-            .chunks
-            .last()
-            .map(|c| c.type_tag.len())
-            .unwrap_or(0);
+        let last_len = sheet.columns[0].chunks.last().map(|c| c.len()).unwrap_or(0);
         assert_eq!(last_start + last_len, sheet.nrows as usize);
     }
 
@@ -6555,16 +8771,12 @@ mod tests {
         }
         let mut sheet = b.finish();
         // Record reference chunk lengths of first column
-        let ref_lens: Vec<usize> = sheet.columns[0]
-            .chunks
-            .iter()
-            .map(|ch| ch.type_tag.len())
-            .collect();
+        let ref_lens: Vec<usize> = sheet.columns[0].chunks.iter().map(|ch| ch.len()).collect();
         // Insert 2 columns before index 1
         sheet.insert_columns(1, 2);
         assert_eq!(sheet.columns.len(), 5);
         for col in &sheet.columns {
-            let lens: Vec<usize> = col.chunks.iter().map(|ch| ch.type_tag.len()).collect();
+            let lens: Vec<usize> = col.chunks.iter().map(|ch| ch.len()).collect();
             assert_eq!(lens, ref_lens);
         }
         let starts_before = sheet.chunk_starts.clone();
@@ -6572,7 +8784,7 @@ mod tests {
         sheet.delete_columns(2, 2);
         assert_eq!(sheet.columns.len(), 3);
         for col in &sheet.columns {
-            let lens: Vec<usize> = col.chunks.iter().map(|ch| ch.type_tag.len()).collect();
+            let lens: Vec<usize> = col.chunks.iter().map(|ch| ch.len()).collect();
             assert_eq!(lens, ref_lens);
         }
         // chunk_starts unchanged by column operations
@@ -6644,23 +8856,15 @@ mod tests {
         assert_eq!(av3.get_cell(9, 0), LiteralValue::Empty);
 
         // Alignment checks
-        let lens0: Vec<usize> = sheet.columns[0]
-            .chunks
-            .iter()
-            .map(|ch| ch.type_tag.len())
-            .collect();
+        let lens0: Vec<usize> = sheet.columns[0].chunks.iter().map(|ch| ch.len()).collect();
         for col in &sheet.columns {
-            let lens: Vec<usize> = col.chunks.iter().map(|ch| ch.type_tag.len()).collect();
+            let lens: Vec<usize> = col.chunks.iter().map(|ch| ch.len()).collect();
             assert_eq!(lens, lens0);
         }
         // chunk_starts monotonically increasing and cover nrows
         assert!(sheet.chunk_starts.windows(2).all(|w| w[0] < w[1]));
         let last_start = *sheet.chunk_starts.last().unwrap_or(&0);
-        let last_len = sheet.columns[0]
-            .chunks
-            .last()
-            .map(|c| c.type_tag.len())
-            .unwrap_or(0);
+        let last_len = sheet.columns[0].chunks.last().map(|c| c.len()).unwrap_or(0);
         assert_eq!(last_start + last_len, sheet.nrows as usize);
     }
 
@@ -6673,17 +8877,13 @@ mod tests {
                 .unwrap();
         }
         let mut sheet = b.finish();
-        let ref_lens: Vec<usize> = sheet.columns[0]
-            .chunks
-            .iter()
-            .map(|ch| ch.type_tag.len())
-            .collect();
+        let ref_lens: Vec<usize> = sheet.columns[0].chunks.iter().map(|ch| ch.len()).collect();
         // Insert 1 at start, then 2 at index 2 → columns = 5
         sheet.insert_columns(0, 1);
         sheet.insert_columns(2, 2);
         assert_eq!(sheet.columns.len(), 5);
         for col in &sheet.columns {
-            let lens: Vec<usize> = col.chunks.iter().map(|ch| ch.type_tag.len()).collect();
+            let lens: Vec<usize> = col.chunks.iter().map(|ch| ch.len()).collect();
             assert_eq!(lens, ref_lens);
         }
         let starts_before = sheet.chunk_starts.clone();
@@ -6694,7 +8894,7 @@ mod tests {
             sheet.delete_columns(remain - 2, 2);
         }
         for col in &sheet.columns {
-            let lens: Vec<usize> = col.chunks.iter().map(|ch| ch.type_tag.len()).collect();
+            let lens: Vec<usize> = col.chunks.iter().map(|ch| ch.len()).collect();
             assert_eq!(lens, ref_lens);
         }
         assert_eq!(sheet.chunk_starts, starts_before);
@@ -6750,13 +8950,9 @@ mod tests {
         assert_eq!(av2.get_cell(4, 1), LiteralValue::Boolean(false));
 
         // Alignment preserved
-        let lens0: Vec<usize> = sheet.columns[0]
-            .chunks
-            .iter()
-            .map(|ch| ch.type_tag.len())
-            .collect();
+        let lens0: Vec<usize> = sheet.columns[0].chunks.iter().map(|ch| ch.len()).collect();
         for col in &sheet.columns {
-            let lens: Vec<usize> = col.chunks.iter().map(|ch| ch.type_tag.len()).collect();
+            let lens: Vec<usize> = col.chunks.iter().map(|ch| ch.len()).collect();
             assert_eq!(lens, lens0);
         }
     }
@@ -0,0 +1,448 @@
+//! Chunk rebalancing: move a sheet's row-chunk boundaries back toward a target length.
+//!
+//! `insert_rows`/`delete_rows` split the chunk at the edit point and never join chunks
+//! again, so a sheet that takes many structural edits ends up with runs of tiny chunks
+//! and the occasional oversized one, and every range read pays per-chunk overhead for
+//! them. [`ArrowSheet::rebalance_job`] plans new boundaries: chunks longer than twice the
+//! target are split, runs of short chunks are merged, and chunks already in range keep
+//! their lanes. The target comes from [`ArrowSheet::target_chunk_rows`], which lets every
+//! read column vote for longer chunks when it is mostly scanned and for `chunk_rows` when
+//! it is mostly read cell by cell; boundaries are shared by all columns, so the sheet
+//! takes the size with the most read epochs behind it.
+//!
+//! Merged chunks are built from copies of the base lanes ([`RebalanceJob::run`]), so the
+//! work can run away from the evaluating thread. [`ArrowSheet::install_rebalanced`] swaps
+//! the new chunks in if the old layout and base lanes are unchanged, moving the current
+//! overlay entries of the old chunks onto the new ones.
+
+use std::cmp::Reverse;
+use std::sync::Arc;
+
+use once_cell::sync::OnceCell;
+use rustc_hash::FxHashMap;
+
+use super::{
+    ArrowSheet, ChunkAccess, ColumnChunk, LaneRowBuilders, Overlay, OverlayLayer, OverlayValue,
+};
+
+/// Longest target chunk length [`ArrowSheet::target_chunk_rows`] picks.
+pub const MAX_TARGET_CHUNK_ROWS: usize = 256 * 1024;
+
+/// Target multiples of `chunk_rows` a column can vote for: mostly cell reads, mixed, and
+/// mostly scans.
+const TARGET_FACTORS: [usize; 3] = [1, 2, 4];
+
+/// Rows of one old chunk that end up in a new chunk.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+struct Piece {
+    old: usize,
+    off: usize,
+    len: usize,
+}
+
+/// New boundaries for a sheet and the old rows behind each new chunk.
+#[derive(Debug, Clone)]
+struct RebalancePlan {
+    old_starts: Vec<usize>,
+    nrows: usize,
+    new_starts: Vec<usize>,
+    /// Per new chunk, its pieces in row order.
+    pieces: Vec<Vec<Piece>>,
+}
+
+/// A planned rebalance with copies of the base lanes it merges.
+pub struct RebalanceJob {
+    sheet: Arc<str>,
+    plan: RebalancePlan,
+    /// Per column, base-lane copies of the old chunks that merged chunks read.
+    sources: Vec<FxHashMap<usize, ColumnChunk>>,
+}
+
+/// Merged chunks built by [`RebalanceJob::run`], ready for [`ArrowSheet::install_rebalanced`].
+pub struct RebalancedChunks {
+    sheet: Arc<str>,
+    plan: RebalancePlan,
+    sources: Vec<FxHashMap<usize, ColumnChunk>>,
+    /// Per column, merged chunks by new chunk index.
+    merged: Vec<FxHashMap<usize, ColumnChunk>>,
+}
+
+impl RebalancedChunks {
+    /// Sheet the chunks were built for.
+    #[inline]
+    pub fn sheet(&self) -> &Arc<str> {
+        &self.sheet
+    }
+}
+
+/// Chunk lengths for `lens` rebalanced toward `target`; every chunk but the last ends up
+/// between `target / 2` and `2 * target` rows.
+fn plan_lengths(lens: &[usize], target: usize) -> Vec<usize> {
+    let target = target.max(1);
+    let (min, max) = (target.div_ceil(2), target.saturating_mul(2));
+    let mut out = Vec::new();
+    let mut group = 0usize;
+    for &len in lens.iter().filter(|&&len| len > 0) {
+        // Oversized chunks become near-equal parts of at most `target` rows.
+        let parts = if len > max { len.div_ceil(target) } else { 1 };
+        for k in 0..parts {
+            let piece = len * (k + 1) / parts - len * k / parts;
+            if group == 0 {
+                group = piece;
+            } else if group + piece <= target || (group.min(piece) < min && group + piece <= max) {
+                group += piece;
+            } else if group < min {
+                // A short group before a long piece: share their rows evenly.
+                let total = group + piece;
+                out.push(total / 2);
+                group = total - total / 2;
+            } else {
+                out.push(group);
+                group = piece;
+            }
+        }
+    }
+    if group > 0 {
+        out.push(group);
+    }
+    out
+}
+
+/// Whether a sheet with chunk lengths `lens` has chunks out of range for `target`. A
+/// short last chunk is fine: growth fills it.
+fn is_unbalanced(lens: &[usize], target: usize) -> bool {
+    let target = target.max(1);
+    let (min, max) = (target.div_ceil(2), target.saturating_mul(2));
+    let interior = lens.len().saturating_sub(1);
+    lens.iter().any(|&len| len > max) || lens[..interior].iter().any(|&len| len < min)
+}
+
+/// Copy of `ch` with its base lanes and no overlay entries.
+fn base_lanes_of(ch: &ColumnChunk) -> ColumnChunk {
+    ColumnChunk {
+        numbers: ch.numbers.clone(),
+        booleans: ch.booleans.clone(),
+        text: ch.text.clone(),
+        text_codes: ch.text_codes.clone(),
+        text_dict: ch.text_dict.clone(),
+        errors: ch.errors.clone(),
+        type_tag: ch.type_tag.clone(),
+        runs: ch.runs.clone(),
+        formula_id: None,
+        meta: ch.meta,
+        lazy_null_numbers: OnceCell::new(),
+        lazy_null_booleans: OnceCell::new(),
+        lazy_null_text: OnceCell::new(),
+        lazy_null_errors: OnceCell::new(),
+        lowered_text: OnceCell::new(),
+        decoded_text: OnceCell::new(),
+        overlay: Overlay::new(),
+        computed_overlay: Overlay::new(),
+        access: ChunkAccess::default(),
+        cold_type_tag: None,
+    }
+}
+
+/// Base rows of `pieces` as one dense chunk, or `None` when none of their chunks exist.
+fn merge_pieces(pieces: &[Piece], sources: &FxHashMap<usize, ColumnChunk>) -> Option<ColumnChunk> {
+    let mut present = pieces.iter().filter_map(|p| sources.get(&p.old)).peekable();
+    present.peek()?;
+    let text_dict = present.find_map(|ch| ch.text_dict.clone());
+    let len = pieces.iter().map(|p| p.len).sum();
+    let mut b = LaneRowBuilders::with_capacity(len);
+    for p in pieces {
+        match sources.get(&p.old) {
+            Some(ch) => (p.off..p.off + p.len).for_each(|i| b.append_base_row(ch, i)),
+            None => (0..p.len).for_each(|_| b.append_value(&OverlayValue::Empty)),
+        }
+    }
+    let mut out = ArrowSheet::make_empty_chunk(len);
+    // Text that fits the column dictionary is stored as codes again.
+    out.text_dict = text_dict;
+    out.install_compacted_lanes(b.finish(OverlayLayer::User, len));
+    Some(out)
+}
+
+impl RebalanceJob {
+    /// Build the merged chunks. Reads only the job, so it can run on any thread.
+    pub fn run(self) -> RebalancedChunks {
+        let merged: Vec<FxHashMap<usize, ColumnChunk>> = self
+            .sources
+            .iter()
+            .map(|sources| {
+                self.plan
+                    .pieces
+                    .iter()
+                    .enumerate()
+                    .filter(|(_, pieces)| pieces.len() > 1)
+                    .filter_map(|(idx, pieces)| Some((idx, merge_pieces(pieces, sources)?)))
+                    .collect()
+            })
+            .collect();
+        RebalancedChunks {
+            sheet: self.sheet,
+            plan: self.plan,
+            sources: self.sources,
+            merged,
+        }
+    }
+}
+
+impl ArrowSheet {
+    /// Row count of each chunk, from `chunk_starts`.
+    pub(super) fn chunk_lens(&self) -> Vec<usize> {
+        let nrows = self.nrows as usize;
+        (0..self.chunk_starts.len())
+            .map(|i| {
+                let end = self.chunk_starts.get(i + 1).copied().unwrap_or(nrows);
+                end.saturating_sub(self.chunk_starts[i])
+            })
+            .collect()
+    }
+
+    /// Chunk length to rebalance toward, from how the sheet's chunks have been read.
+    ///
+    /// Each column votes, weighted by its read epochs, for `chunk_rows` times 1 (mostly
+    /// single-cell reads), 2 (mixed) or 4 (at least three quarters segment scans); the
+    /// factor with the most weight wins, the smaller on a tie. Unread sheets keep
+    /// `chunk_rows`. Capped at [`MAX_TARGET_CHUNK_ROWS`] unless `chunk_rows` is larger.
+    pub fn target_chunk_rows(&self) -> usize {
+        let base = self.chunk_rows.max(1);
+        let mut votes = [0u64; TARGET_FACTORS.len()];
+        for col in &self.columns {
+            let (scans, points) = col
+                .chunks
+                .iter()
+                .chain(col.sparse_chunks.values())
+                .map(ColumnChunk::read_epochs)
+                .fold((0u64, 0u64), |(s, p), (cs, cp)| {
+                    (s + u64::from(cs), p + u64::from(cp))
+                });
+            let total = scans + points;
+            if total == 0 {
+                continue;
+            }
+            let vote = if scans * 4 >= total * 3 {
+                2
+            } else if scans * 4 >= total {
+                1
+            } else {
+                0
+            };
+            votes[vote] += total;
+        }
+        let best = (0..TARGET_FACTORS.len())
+            .max_by_key(|&i| (votes[i], Reverse(i)))
+            .unwrap_or(0);
+        base.saturating_mul(TARGET_FACTORS[best])
+            .min(MAX_TARGET_CHUNK_ROWS.max(base))
+    }
+
+    /// Plan a rebalance toward `target` rows per chunk and copy the base lanes it merges;
+    /// `None` when every chunk is already in range.
+    pub fn rebalance_job(&self, target: usize) -> Option<RebalanceJob> {
+        let lens = self.chunk_lens();
+        if lens.is_empty() || !is_unbalanced(&lens, target) {
+            return None;
+        }
+        let new_lens = plan_lengths(&lens, target);
+
+        let mut new_starts = Vec::with_capacity(new_lens.len());
+        let mut pieces = Vec::with_capacity(new_lens.len());
+        let (mut old, mut off) = (0usize, 0usize);
+        let mut row = 0usize;
+        for &len in &new_lens {
+            new_starts.push(row);
+            row += len;
+            let mut chunk = Vec::new();
+            let mut need = len;
+            while need > 0 {
+                let take = (lens[old] - off).min(need);
+                if take > 0 {
+                    chunk.push(Piece {
+                        old,
+                        off,
+                        len: take,
+                    });
+                }
+                need -= take;
+                off += take;
+                if off == lens[old] {
+                    old += 1;
+                    off = 0;
+                }
+            }
+            pieces.push(chunk);
+        }
+        if new_starts == self.chunk_starts {
+            return None;
+        }
+
+        let sources: Vec<FxHashMap<usize, ColumnChunk>> = self
+            .columns
+            .iter()
+            .map(|col| {
+                pieces
+                    .iter()
+                    .filter(|chunk| chunk.len() > 1)
+                    .flatten()
+                    .filter_map(|p| Some((p.old, base_lanes_of(col.chunk(p.old)?))))
+                    .collect()
+            })
+            .collect();
+        Some(RebalanceJob {
+            sheet: self.name.clone(),
+            plan: RebalancePlan {
+                old_starts: self.chunk_starts.clone(),
+                nrows: self.nrows as usize,
+                new_starts,
+                pieces,
+            },
+            sources,
+        })
+    }
+
+    /// Swap in chunks built by [`RebalanceJob::run`]. Overlay entries of the old chunks
+    /// move to the new ones. Returns the change in computed-overlay bytes, or `None`
+    /// without changing anything when the layout, the columns, or the base lanes of a
+    /// merged chunk moved on since the job was planned.
+    pub fn install_rebalanced(&mut self, done: RebalancedChunks) -> Option<isize> {
+        let RebalancedChunks {
+            plan,
+            sources,
+            mut merged,
+            ..
+        } = done;
+        if self.chunk_starts != plan.old_starts
+            || self.nrows as usize != plan.nrows
+            || self.columns.len() != sources.len()
+        {
+            return None;
+        }
+        for (col, sources) in self.columns.iter().zip(&sources) {
+            let stale = plan
+                .pieces
+                .iter()
+                .filter(|chunk| chunk.len() > 1)
+                .flatten()
+                .any(|p| match (col.chunk(p.old), sources.get(&p.old)) {
+                    (Some(live), Some(source)) => !live.same_base_lanes(source),
+                    (None, None) => false,
+                    _ => true,
+                });
+            if stale {
+                return None;
+            }
+        }
+
+        let mut computed_delta = 0isize;
+        for (col, merged) in self.columns.iter_mut().zip(&mut merged) {
+            let old_dense = std::mem::take(&mut col.chunks);
+            let old_sparse = std::mem::take(&mut col.sparse_chunks);
+            let get_old = |idx: usize| -> Option<&ColumnChunk> {
+                if idx < old_dense.len() {
+                    Some(&old_dense[idx])
+                } else {
+                    old_sparse.get(&idx)
+                }
+            };
+            let before = old_dense
+                .iter()
+                .chain(old_sparse.values())
+                .map(|ch| ch.computed_overlay.estimated_bytes())
+                .sum::<usize>();
+
+            let mut dense: Vec<ColumnChunk> = Vec::new();
+            let mut sparse: FxHashMap<usize, ColumnChunk> = FxHashMap::default();
+            let mut dense_prefix = true;
+            for (new_idx, pieces) in plan.pieces.iter().enumerate() {
+                let produced = match pieces.as_slice() {
+                    [p] => get_old(p.old).map(|orig| {
+                        if p.off == 0 && p.len == orig.len() {
+                            orig.clone()
+                        } else {
+                            let mut ch = Self::slice_chunk(orig, p.off, p.len);
+                            ch.access = ChunkAccess::combine([(&orig.access, p.len, orig.len())]);
+                            ch
+                        }
+                    }),
+                    _ => merged.remove(&new_idx).map(|mut ch| {
+                        let mut at = 0usize;
+                        for p in pieces {
+                            if let Some(orig) = get_old(p.old) {
+                                ch.overlay
+                                    .extend_from_slice(&orig.overlay, p.off, p.len, at);
+                                ch.computed_overlay.extend_from_slice(
+                                    &orig.computed_overlay,
+                                    p.off,
+                                    p.len,
+                                    at,
+                                );
+                            }
+                            at += p.len;
+                        }
+                        ch.access = ChunkAccess::combine(pieces.iter().filter_map(|p| {
+                            get_old(p.old).map(|orig| (&orig.access, p.len, orig.len()))
+                        }));
+                        ch
+                    }),
+                };
+
+                if let Some(ch) = produced {
+                    if dense_prefix && new_idx == dense.len() {
+                        dense.push(ch);
+                    } else {
+                        sparse.insert(new_idx, ch);
+                        dense_prefix = false;
+                    }
+                } else if dense_prefix && new_idx == dense.len() {
+                    dense_prefix = false;
+                }
+            }
+
+            let after = dense
+                .iter()
+                .chain(sparse.values())
+                .map(|ch| ch.computed_overlay.estimated_bytes())
+                .sum::<usize>();
+            computed_delta = computed_delta.saturating_add(after as isize - before as isize);
+            col.chunks = dense;
+            col.sparse_chunks = sparse;
+        }
+        self.chunk_starts = plan.new_starts;
+        Some(computed_delta)
+    }
+
+    /// Rebalance toward `target` rows per chunk on the calling thread. Returns whether
+    /// the layout changed.
+    pub fn rebalance_chunks(&mut self, target: usize) -> bool {
+        match self.rebalance_job(target) {
+            Some(job) => self.install_rebalanced(job.run()).is_some(),
+            None => false,
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::{is_unbalanced, plan_lengths};
+
+    #[test]
+    fn planned_lengths_stay_in_range() {
+        let cases: &[(&[usize], usize)] = &[
+            (&[1, 1, 1, 1, 1, 1, 1, 1, 1, 1], 4),
+            (&[4, 1, 3, 4, 2, 2, 9, 1], 4),
+            (&[1, 7, 1, 7, 1], 4),
+            (&[40], 4),
+            (&[4, 4, 4, 4, 4, 4], 16),
+            (&[3, 8, 1], 4),
+        ];
+        for &(lens, target) in cases {
+            let out = plan_lengths(lens, target);
+            assert_eq!(out.iter().sum::<usize>(), lens.iter().sum::<usize>());
+            assert!(!is_unbalanced(&out, target), "{lens:?} -> {out:?}");
+        }
+        assert_eq!(plan_lengths(&[1, 7, 1, 7, 1], 4), vec![8, 8, 1]);
+        assert_eq!(plan_lengths(&[40], 16), vec![13, 13, 14]);
+    }
+}
@@ -0,0 +1,1146 @@
+//! On-disk workbook snapshots: sheet store lanes plus the metadata needed to restart.
+//!
+//! A snapshot holds every sheet of a [`SheetStore`] with both overlay layers folded into
+//! the base lanes, an image of the formula AST arena (see [`SnapshotFormulas`]), and the
+//! defined names. Dense chunk lanes are written as Arrow IPC files (one per lane layout,
+//! see `ipc`); everything else goes into a compact little-endian metadata block. Opening
+//! maps the file and builds each chunk over zero-copy arrays, so loading cell data is
+//! proportional to the number of sheets and chunks rather than cells. Formulas are
+//! rebuilt from the arena image without parsing, but the dependency graph is still built
+//! per formula.
+//!
+//! File layout:
+//!
+//! ```text
+//! "FZSNAP\0\0" | version: u32 | reserved: u32
+//! lane files, each starting on a 64-byte boundary
+//! metadata block
+//! metadata offset: u64 | metadata length: u64 | "FZSNAP\0\0"
+//! ```
+//!
+//! Snapshots are written to a temporary file next to the target and renamed into place,
+//! so a workbook opened from the previous snapshot keeps reading its own mapping.
+
+use std::collections::BTreeMap;
+use std::fs::File;
+use std::io::{Seek, Write};
+use std::path::Path;
+use std::sync::Arc;
+
+use arrow::buffer::Buffer;
+use rustc_hash::FxHashMap;
+
+use formualizer_common::LiteralValue;
+
+use super::ipc::{self, DecodedLanes, LaneLayout, MappedFile, io_error};
+use super::{
+    ArrowColumn, ArrowSheet, ChunkRuns, ColumnChunk, ColumnChunkMeta, OverlayLayer, OverlayValue,
+    SheetStore, TextDictionary, ZoneMap,
+};
+use crate::engine::DateSystem;
+
+/// Bumped whenever the layout changes; older or newer snapshots are rejected.
+pub const SNAPSHOT_FORMAT_VERSION: u32 = 2;
+
+const MAGIC: &[u8; 8] = b"FZSNAP\0\0";
+const HEADER_LEN: u64 = 16;
+const TRAILER_LEN: usize = 24;
+const LANE_FILE_ALIGN: u64 = 64;
+
+/// The workbook's formulas as an image of the engine's AST arena.
+///
+/// Arena ids are engine-local, so nodes are renumbered by their position in `nodes`,
+/// with children always before their parents, and strings and sheets are named through
+/// `strings`. A formula copied across a region is stored once, as its template root, and
+/// each cell names that root with the anchor its relative references are written for.
+#[derive(Debug, Clone, Default, PartialEq)]
+pub struct SnapshotFormulas {
+    /// Operators, function names, reference text, defined names and sheet names.
+    pub strings: Vec<String>,
+    pub nodes: Vec<SnapshotAstNode>,
+    pub sheets: Vec<SnapshotSheetFormulas>,
+}
+
+/// Formula cells of one sheet.
+#[derive(Debug, Clone, Default, PartialEq, Eq)]
+pub struct SnapshotSheetFormulas {
+    pub sheet: String,
+    pub cells: Vec<SnapshotPlacement>,
+}
+
+/// One formula cell, 1-based: the root node of its formula and the cell that root's
+/// relative references are written for.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct SnapshotPlacement {
+    pub row: u32,
+    pub col: u32,
+    pub root: u32,
+    pub anchor_row: u32,
+    pub anchor_col: u32,
+}
+
+/// An arena node. Children and strings are indices into [`SnapshotFormulas`].
+#[derive(Debug, Clone, PartialEq)]
+pub enum SnapshotAstNode {
+    Literal(LiteralValue),
+    Reference {
+        original: u32,
+        reference: SnapshotReference,
+    },
+    Unary {
+        op: u32,
+        expr: u32,
+    },
+    Binary {
+        op: u32,
+        left: u32,
+        right: u32,
+    },
+    Function {
+        name: u32,
+        args: Vec<u32>,
+    },
+    Array {
+        rows: u16,
+        cols: u16,
+        elements: Vec<u32>,
+    },
+    /// A whole formula the image does not model (table or external-workbook references,
+    /// formulas still staged as text), as text with a leading `=`; parsed on open.
+    Text(String),
+}
+
+/// A reference in arena form: rows and columns are 1-based, unbounded range edges keep the
+/// arena's `0` / `u32::MAX` sentinels, and sheets are string indices.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum SnapshotReference {
+    Cell {
+        sheet: Option<u32>,
+        row: u32,
+        col: u32,
+        row_abs: bool,
+        col_abs: bool,
+    },
+    Range {
+        sheet: Option<u32>,
+        start_row: u32,
+        start_col: u32,
+        end_row: u32,
+        end_col: u32,
+        /// Absolute flags of start row, start column, end row and end column.
+        abs: [bool; 4],
+    },
+    Named(u32),
+    Cell3D {
+        sheet_first: u32,
+        sheet_last: u32,
+        row: u32,
+        col: u32,
+        row_abs: bool,
+        col_abs: bool,
+    },
+    Range3D {
+        sheet_first: u32,
+        sheet_last: u32,
+        start_row: u32,
+        start_col: u32,
+        end_row: u32,
+        end_col: u32,
+        abs: [bool; 4],
+    },
+}
+
+/// A defined name.
+#[derive(Debug, Clone, PartialEq)]
+pub struct SnapshotName {
+    pub name: String,
+    /// Sheet of a sheet-scoped name; `None` for workbook scope.
+    pub scope_sheet: Option<String>,
+    pub target: SnapshotNameTarget,
+}
+
+#[derive(Debug, Clone, PartialEq)]
+pub enum SnapshotNameTarget {
+    /// A cell or range, 1-based and inclusive.
+    Range {
+        sheet: String,
+        start_row: u32,
+        start_col: u32,
+        end_row: u32,
+        end_col: u32,
+    },
+    Literal(LiteralValue),
+    /// Canonical formula text with a leading `=`.
+    Formula(String),
+}
+
+/// Contents of an opened snapshot. Dense chunk lanes point into the mapped file.
+#[derive(Debug, Clone)]
+pub struct Snapshot {
+    pub date_system: DateSystem,
+    pub sheets: Vec<ArrowSheet>,
+    pub formulas: SnapshotFormulas,
+    pub names: Vec<SnapshotName>,
+}
+
+/// Write `store`, `formulas` and `names` to a snapshot at `path`, replacing any file there.
+pub fn write_snapshot(
+    path: &Path,
+    store: &SheetStore,
+    date_system: DateSystem,
+    formulas: &SnapshotFormulas,
+    names: &[SnapshotName],
+) -> std::io::Result<()> {
+    let file_name = path
+        .file_name()
+        .ok_or_else(|| io_error("snapshot path has no file name"))?;
+    let mut tmp_name = file_name.to_os_string();
+    tmp_name.push(format!(".{}.tmp", std::process::id()));
+    let tmp = path.with_file_name(tmp_name);
+    let written = File::create(&tmp).and_then(|mut file| {
+        write_to(&mut file, store, date_system, formulas, names)?;
+        file.sync_all()
+    });
+    match written.and_then(|()| std::fs::rename(&tmp, path)) {
+        Ok(()) => Ok(()),
+        Err(error) => {
+            let _ = std::fs::remove_file(&tmp);
+            Err(error)
+        }
+    }
+}
+
+/// Map the snapshot at `path` and rebuild its sheets over the mapping.
+pub fn read_snapshot(path: &Path) -> std::io::Result<Snapshot> {
+    let file = File::open(path)?;
+    let mapped = MappedFile::map(&file, None)?;
+    drop(file);
+    let buffer = mapped.buffer()?;
+    drop(mapped);
+    read_from(&buffer)
+}
+
+/// How a chunk is stored: by lane file and batch, or as runs in the metadata.
+enum ChunkRecord<'a> {
+    Lanes {
+        file: usize,
+        batch: usize,
+        meta: ColumnChunkMeta,
+        dict: Option<usize>,
+        uniform_tags: bool,
+    },
+    Runs(&'a ChunkRuns),
+}
+
+/// A chunk with its overlays folded into the base lanes.
+fn folded(ch: &ColumnChunk) -> std::borrow::Cow<'_, ColumnChunk> {
+    if ch.overlay.is_empty() && ch.computed_overlay.is_empty() {
+        return std::borrow::Cow::Borrowed(ch);
+    }
+    let mut ch = ch.clone();
+    // Computed values sit under user edits, so they are folded first.
+    for layer in [OverlayLayer::Computed, OverlayLayer::User] {
+        if !ch.overlay_layer(layer).is_empty()
+            && let Some(lanes) = ch.build_compacted_lanes(layer)
+        {
+            ch.install_compacted_lanes(lanes);
+        }
+    }
+    std::borrow::Cow::Owned(ch)
+}
+
+fn write_to(
+    file: &mut File,
+    store: &SheetStore,
+    date_system: DateSystem,
+    formulas: &SnapshotFormulas,
+    names: &[SnapshotName],
+) -> std::io::Result<()> {
+    // Fold every chunk first so lane files can be grouped by layout.
+    let folded_sheets: Vec<Vec<Vec<(usize, std::borrow::Cow<'_, ColumnChunk>)>>> = store
+        .sheets
+        .iter()
+        .map(|sheet| {
+            sheet
+                .columns
+                .iter()
+                .map(|column| {
+                    let sparse: BTreeMap<usize, &ColumnChunk> = column
+                        .sparse_chunks
+                        .iter()
+                        .map(|(&i, ch)| (i, ch))
+                        .collect();
+                    column
+                        .chunks
+                        .iter()
+                        .enumerate()
+                        .chain(sparse)
+                        .map(|(i, ch)| (i, folded(ch)))
+                        .collect()
+                })
+                .collect()
+        })
+        .collect();
+
+    let mut layouts: FxHashMap<LaneLayout, usize> = FxHashMap::default();
+    let mut lane_files: Vec<(LaneLayout, Vec<&ColumnChunk>)> = Vec::new();
+    let mut records: Vec<Vec<Vec<ChunkRecord<'_>>>> = Vec::with_capacity(folded_sheets.len());
+    let mut dicts: Vec<Vec<Vec<Arc<TextDictionary>>>> = Vec::with_capacity(folded_sheets.len());
+    for columns in &folded_sheets {
+        let mut sheet_records = Vec::with_capacity(columns.len());
+        let mut sheet_dicts = Vec::with_capacity(columns.len());
+        for chunks in columns {
+            let mut column_records = Vec::with_capacity(chunks.len());
+            let mut column_dicts: Vec<Arc<TextDictionary>> = Vec::new();
+            for (_, ch) in chunks {
+                let ch: &ColumnChunk = ch;
+                if let Some(runs) = &ch.runs {
+                    column_records.push(ChunkRecord::Runs(runs));
+                    continue;
+                }
+                let dict = ch.dictionary_text().map(|(_, dict)| {
+                    match column_dicts.iter().position(|d| Arc::ptr_eq(d, dict)) {
+                        Some(idx) => idx,
+                        None => {
+                            column_dicts.push(dict.clone());
+                            column_dicts.len() - 1
+                        }
+                    }
+                });
+                let layout = LaneLayout::of(ch);
+                let file = *layouts.entry(layout.clone()).or_insert_with(|| {
+                    lane_files.push((layout, Vec::new()));
+                    lane_files.len() - 1
+                });
+                let batch = lane_files[file].1.len();
+                lane_files[file].1.push(ch);
+                column_records.push(ChunkRecord::Lanes {
+                    file,
+                    batch,
+                    meta: ch.meta,
+                    dict,
+                    uniform_tags: ch.uniform_type_tag().is_some(),
+                });
+            }
+            sheet_records.push(column_records);
+            sheet_dicts.push(column_dicts);
+        }
+        records.push(sheet_records);
+        dicts.push(sheet_dicts);
+    }
+
+    file.write_all(MAGIC)?;
+    file.write_all(&SNAPSHOT_FORMAT_VERSION.to_le_bytes())?;
+    file.write_all(&0u32.to_le_bytes())?;
+    let mut pos = HEADER_LEN;
+    let mut extents = Vec::with_capacity(lane_files.len());
+    for (layout, chunks) in &lane_files {
+        let pad = pos.next_multiple_of(LANE_FILE_ALIGN) - pos;
+        file.write_all(&[0u8; LANE_FILE_ALIGN as usize][..pad as usize])?;
+        let start = pos + pad;
+        ipc::write_lane_file(&mut *file, layout, chunks.iter().copied())?;
+        pos = file.stream_position()?;
+        extents.push((start, pos - start));
+    }
+
+    let mut enc = Enc::default();
+    enc.date_system(date_system);
+    enc.len(extents.len());
+    for &(start, len) in &extents {
+        enc.u64(start);
+        enc.u64(len);
+    }
+    enc.len(store.sheets.len());
+    for ((sheet, columns), (sheet_records, sheet_dicts)) in store
+        .sheets
+        .iter()
+        .zip(&folded_sheets)
+        .zip(records.iter().zip(&dicts))
+    {
+        enc.str(&sheet.name);
+        enc.date_system(sheet.date_system);
+        enc.u32(sheet.nrows);
+        enc.len(sheet.chunk_rows);
+        enc.len(sheet.chunk_starts.len());
+        for &start in &sheet.chunk_starts {
+            enc.len(start);
+        }
+        enc.len(sheet.columns.len());
+        for (((column, chunks), column_records), column_dicts) in sheet
+            .columns
+            .iter()
+            .zip(columns)
+            .zip(sheet_records)
+            .zip(sheet_dicts)
+        {
+            enc.u32(column.index);
+            enc.len(column_dicts.len());
+            for dict in column_dicts {
+                enc.len(dict.len());
+                for value in dict.values().iter() {
+                    enc.str(value.unwrap_or_default());
+                }
+            }
+            enc.len(column.chunks.len());
+            enc.len(chunks.len());
+            for ((idx, _), record) in chunks.iter().zip(column_records) {
+                enc.len(*idx);
+                enc.chunk(record);
+            }
+        }
+    }
+    enc.formulas(formulas, date_system);
+    enc.len(names.len());
+    for name in names {
+        enc.name(name, date_system);
+    }
+
+    let pad = pos.next_multiple_of(8) - pos;
+    file.write_all(&[0u8; 8][..pad as usize])?;
+    let meta_start = pos + pad;
+    file.write_all(&enc.0)?;
+    file.write_all(&meta_start.to_le_bytes())?;
+    file.write_all(&(enc.0.len() as u64).to_le_bytes())?;
+    file.write_all(MAGIC)?;
+    Ok(())
+}
+
+fn read_from(buffer: &Buffer) -> std::io::Result<Snapshot> {
+    let bytes: &[u8] = buffer;
+    if bytes.len() < HEADER_LEN as usize + TRAILER_LEN || &bytes[..8] != MAGIC {
+        return Err(io_error("not a formualizer snapshot"));
+    }
+    let version = u32::from_le_bytes(bytes[8..12].try_into().map_err(io_error)?);
+    if version != SNAPSHOT_FORMAT_VERSION {
+        return Err(io_error(format!(
+            "snapshot format version {version} is not supported (expected {SNAPSHOT_FORMAT_VERSION})"
+        )));
+    }
+    let trailer = &bytes[bytes.len() - TRAILER_LEN..];
+    if &trailer[16..] != MAGIC {
+        return Err(io_error("snapshot trailer is damaged"));
+    }
+    let meta_start = u64::from_le_bytes(trailer[..8].try_into().map_err(io_error)?);
+    let meta_len = u64::from_le_bytes(trailer[8..16].try_into().map_err(io_error)?);
+    let meta_range = usize::try_from(meta_start)
+        .ok()
+        .zip(usize::try_from(meta_len).ok())
+        .and_then(|(start, len)| Some(start..start.checked_add(len)?))
+        .filter(|range| range.end <= bytes.len() - TRAILER_LEN)
+        .ok_or_else(|| io_error("snapshot metadata out of range"))?;
+    let mut dec = Dec {
+        buf: &bytes[meta_range],
+        pos: 0,
+    };
+
+    let date_system = dec.date_system()?;
+    let file_count = dec.count(16)?;
+    let mut batches: Vec<Vec<Option<arrow::record_batch::RecordBatch>>> =
+        Vec::with_capacity(file_count);
+    for _ in 0..file_count {
+        let start = dec.len()?;
+        let len = dec.len()?;
+        if start.checked_add(len).is_none_or(|end| end > bytes.len()) {
+            return Err(io_error("snapshot lane file out of range"));
+        }
+        let lanes = ipc::read_lane_file(&buffer.slice_with_length(start, len))?;
+        batches.push(lanes.into_iter().map(Some).collect());
+    }
+
+    let sheet_count = dec.count(8)?;
+    let mut sheets = Vec::with_capacity(sheet_count);
+    for _ in 0..sheet_count {
+        let name: Arc<str> = Arc::from(dec.str()?);
+        let sheet_date_system = dec.date_system()?;
+        let nrows = dec.u32()?;
+        let chunk_rows = dec.len()?;
+        let starts = dec.count(8)?;
+        let chunk_starts = (0..starts)
+            .map(|_| dec.len())
+            .collect::<std::io::Result<Vec<_>>>()?;
+        let ncols = dec.count(12)?;
+        let mut columns = Vec::with_capacity(ncols);
+        for _ in 0..ncols {
+            let index = dec.u32()?;
+            let dict_count = dec.count(8)?;
+            let mut column_dicts = Vec::with_capacity(dict_count);
+            for _ in 0..dict_count {
+                let count = dec.count(8)?;
+                let mut values: Vec<Box<str>> = Vec::with_capacity(count);
+                let mut lookup = FxHashMap::default();
+                for code in 0..count {
+                    let value: Box<str> = dec.str()?.into();
+                    lookup.insert(value.clone(), code as u32);
+                    values.push(value);
+                }
+                column_dicts.push(Arc::new(TextDictionary::from_values(values, lookup)));
+            }
+            let dense = dec.count(9)?;
+            let total = dec.count(9)?;
+            let mut column = ArrowColumn {
+                chunks: Vec::with_capacity(dense),
+                sparse_chunks: FxHashMap::default(),
+                index,
+            };
+            for n in 0..total {
+                let idx = dec.len()?;
+                let ch = dec.chunk(&mut batches, &column_dicts)?;
+                if n < dense {
+                    column.chunks.push(ch);
+                } else {
+                    column.sparse_chunks.insert(idx, ch);
+                }
+            }
+            columns.push(column);
+        }
+        sheets.push(ArrowSheet {
+            name,
+            date_system: sheet_date_system,
+            columns,
+            nrows,
+            chunk_starts,
+            chunk_rows,
+        });
+    }
+
+    let formulas = dec.formulas(date_system)?;
+    let name_count = dec.count(8)?;
+    let mut names = Vec::with_capacity(name_count);
+    for _ in 0..name_count {
+        names.push(dec.name(date_system)?);
+    }
+    Ok(Snapshot {
+        date_system,
+        sheets,
+        formulas,
+        names,
+    })
+}
+
+#[derive(Default)]
+struct Enc(Vec<u8>);
+
+impl Enc {
+    fn u8(&mut self, v: u8) {
+        self.0.push(v);
+    }
+    fn u32(&mut self, v: u32) {
+        self.0.extend_from_slice(&v.to_le_bytes());
+    }
+    fn u64(&mut self, v: u64) {
+        self.0.extend_from_slice(&v.to_le_bytes());
+    }
+    fn f64(&mut self, v: f64) {
+        self.0.extend_from_slice(&v.to_le_bytes());
+    }
+    fn len(&mut self, v: usize) {
+        self.u64(v as u64);
+    }
+    fn str(&mut self, v: &str) {
+        self.len(v.len());
+        self.0.extend_from_slice(v.as_bytes());
+    }
+    fn date_system(&mut self, v: DateSystem) {
+        self.u8(match v {
+            DateSystem::Excel1900 => 0,
+            DateSystem::Excel1904 => 1,
+        });
+    }
+
+    fn value(&mut self, v: &OverlayValue) {
+        match v {
+            OverlayValue::Empty => self.u8(0),
+            OverlayValue::Number(n) => {
+                self.u8(1);
+                self.f64(*n);
+            }
+            OverlayValue::DateTime(n) => {
+                self.u8(2);
+                self.f64(*n);
+            }
+            OverlayValue::Duration(n) => {
+                self.u8(3);
+                self.f64(*n);
+            }
+            OverlayValue::Boolean(b) => {
+                self.u8(4);
+                self.u8(u8::from(*b));
+            }
+            OverlayValue::Text(s) => {
+                self.u8(5);
+                self.str(s);
+            }
+            OverlayValue::Error(code) => {
+                self.u8(6);
+                self.u8(*code);
+            }
+            OverlayValue::Pending => self.u8(7),
+        }
+    }
+
+    /// A formula literal. Integers and error messages survive, unlike cell values.
+    fn literal(&mut self, v: &LiteralValue, date_system: DateSystem) {
+        match v {
+            LiteralValue::Int(i) => {
+                self.u8(8);
+                self.u64(*i as u64);
+            }
+            LiteralValue::Error(e) => {
+                self.u8(9);
+                self.u8(super::map_error_code(e.kind));
+                self.str(e.message.as_deref().unwrap_or_default());
+            }
+            other => self.value(&OverlayValue::from_literal_value(other, date_system)),
+        }
+    }
+
+    fn formulas(&mut self, formulas: &SnapshotFormulas, date_system: DateSystem) {
+        self.len(formulas.strings.len());
+        for s in &formulas.strings {
+            self.str(s);
+        }
+        self.len(formulas.nodes.len());
+        for node in &formulas.nodes {
+            self.ast_node(node, date_system);
+        }
+        self.len(formulas.sheets.len());
+        for sheet in &formulas.sheets {
+            self.str(&sheet.sheet);
+            self.len(sheet.cells.len());
+            for cell in &sheet.cells {
+                for v in [
+                    cell.row,
+                    cell.col,
+                    cell.root,
+                    cell.anchor_row,
+                    cell.anchor_col,
+                ] {
+                    self.u32(v);
+                }
+            }
+        }
+    }
+
+    fn ast_node(&mut self, node: &SnapshotAstNode, date_system: DateSystem) {
+        match node {
+            SnapshotAstNode::Literal(value) => {
+                self.u8(0);
+                self.literal(value, date_system);
+            }
+            SnapshotAstNode::Reference {
+                original,
+                reference,
+            } => {
+                self.u8(1);
+                self.u32(*original);
+                self.reference(reference);
+            }
+            SnapshotAstNode::Unary { op, expr } => {
+                self.u8(2);
+                self.u32(*op);
+                self.u32(*expr);
+            }
+            SnapshotAstNode::Binary { op, left, right } => {
+                self.u8(3);
+                self.u32(*op);
+                self.u32(*left);
+                self.u32(*right);
+            }
+            SnapshotAstNode::Function { name, args } => {
+                self.u8(4);
+                self.u32(*name);
+                self.ids(args);
+            }
+            SnapshotAstNode::Array {
+                rows,
+                cols,
+                elements,
+            } => {
+                self.u8(5);
+                self.u32(u32::from(*rows));
+                self.u32(u32::from(*cols));
+                self.ids(elements);
+            }
+            SnapshotAstNode::Text(text) => {
+                self.u8(6);
+                self.str(text);
+            }
+        }
+    }
+
+    fn ids(&mut self, ids: &[u32]) {
+        self.len(ids.len());
+        for id in ids {
+            self.u32(*id);
+        }
+    }
+
+    fn flags(&mut self, flags: &[bool]) {
+        let bits = flags
+            .iter()
+            .enumerate()
+            .fold(0u8, |bits, (i, &flag)| bits | (u8::from(flag) << i));
+        self.u8(bits);
+    }
+
+    fn sheet(&mut self, sheet: Option<u32>) {
+        // 0 for none, string index + 1 otherwise.
+        self.u32(sheet.map_or(0, |s| s + 1));
+    }
+
+    fn reference(&mut self, reference: &SnapshotReference) {
+        match *reference {
+            SnapshotReference::Cell {
+                sheet,
+                row,
+                col,
+                row_abs,
+                col_abs,
+            } => {
+                self.u8(0);
+                self.sheet(sheet);
+                self.u32(row);
+                self.u32(col);
+                self.flags(&[row_abs, col_abs]);
+            }
+            SnapshotReference::Range {
+                sheet,
+                start_row,
+                start_col,
+                end_row,
+                end_col,
+                abs,
+            } => {
+                self.u8(1);
+                self.sheet(sheet);
+                for v in [start_row, start_col, end_row, end_col] {
+                    self.u32(v);
+                }
+                self.flags(&abs);
+            }
+            SnapshotReference::Named(name) => {
+                self.u8(2);
+                self.u32(name);
+            }
+            SnapshotReference::Cell3D {
+                sheet_first,
+                sheet_last,
+                row,
+                col,
+                row_abs,
+                col_abs,
+            } => {
+                self.u8(3);
+                for v in [sheet_first, sheet_last, row, col] {
+                    self.u32(v);
+                }
+                self.flags(&[row_abs, col_abs]);
+            }
+            SnapshotReference::Range3D {
+                sheet_first,
+                sheet_last,
+                start_row,
+                start_col,
+                end_row,
+                end_col,
+                abs,
+            } => {
+                self.u8(4);
+                for v in [
+                    sheet_first,
+                    sheet_last,
+                    start_row,
+                    start_col,
+                    end_row,
+                    end_col,
+                ] {
+                    self.u32(v);
+                }
+                self.flags(&abs);
+            }
+        }
+    }
+
+    fn chunk(&mut self, record: &ChunkRecord<'_>) {
+        match record {
+            ChunkRecord::Lanes {
+                file,
+                batch,
+                meta,
+                dict,
+                uniform_tags,
+            } => {
+                self.u8(0);
+                self.len(*file);
+                self.len(*batch);
+                self.len(dict.map_or(0, |d| d + 1));
+                self.len(meta.len);
+                self.len(meta.non_null_num);
+                self.len(meta.non_null_bool);
+                self.len(meta.non_null_text);
+                self.len(meta.non_null_err);
+                let zone = &meta.zone;
+                self.f64(zone.num_min);
+                self.f64(zone.num_max);
+                self.u64(zone.text_bloom);
+                self.u8(u8::from(zone.has_blank)
+                    | u8::from(zone.has_bool) << 1
+                    | u8::from(zone.has_text) << 2
+                    | u8::from(zone.has_error) << 3
+                    | u8::from(zone.numbers_ascending) << 4
+                    | u8::from(*uniform_tags) << 5);
+            }
+            ChunkRecord::Runs(runs) => {
+                self.u8(1);
+                self.len(runs.run_ends.len());
+                for (end, value) in runs.run_ends.iter().zip(&runs.values) {
+                    self.u32(*end);
+                    self.value(value);
+                }
+            }
+        }
+    }
+
+    fn name(&mut self, name: &SnapshotName, date_system: DateSystem) {
+        self.str(&name.name);
+        match &name.scope_sheet {
+            Some(sheet) => {
+                self.u8(1);
+                self.str(sheet);
+            }
+            None => self.u8(0),
+        }
+        match &name.target {
+            SnapshotNameTarget::Range {
+                sheet,
+                start_row,
+                start_col,
+                end_row,
+                end_col,
+            } => {
+                self.u8(0);
+                self.str(sheet);
+                for v in [start_row, start_col, end_row, end_col] {
+                    self.u32(*v);
+                }
+            }
+            SnapshotNameTarget::Literal(value) => {
+                self.u8(1);
+                self.value(&OverlayValue::from_literal_value(value, date_system));
+            }
+            SnapshotNameTarget::Formula(text) => {
+                self.u8(2);
+                self.str(text);
+            }
+        }
+    }
+}
+
+struct Dec<'a> {
+    buf: &'a [u8],
+    pos: usize,
+}
+
+impl<'a> Dec<'a> {
+    fn take(&mut self, n: usize) -> std::io::Result<&'a [u8]> {
+        let end = self
+            .pos
+            .checked_add(n)
+            .filter(|&end| end <= self.buf.len())
+            .ok_or_else(|| io_error("snapshot metadata is truncated"))?;
+        let out = &self.buf[self.pos..end];
+        self.pos = end;
+        Ok(out)
+    }
+    fn u8(&mut self) -> std::io::Result<u8> {
+        Ok(self.take(1)?[0])
+    }
+    fn u32(&mut self) -> std::io::Result<u32> {
+        Ok(u32::from_le_bytes(self.take(4)?.try_into().unwrap()))
+    }
+    fn u64(&mut self) -> std::io::Result<u64> {
+        Ok(u64::from_le_bytes(self.take(8)?.try_into().unwrap()))
+    }
+    fn f64(&mut self) -> std::io::Result<f64> {
+        Ok(f64::from_le_bytes(self.take(8)?.try_into().unwrap()))
+    }
+    fn len(&mut self) -> std::io::Result<usize> {
+        usize::try_from(self.u64()?).map_err(io_error)
+    }
+    /// A length prefix for elements that each take at least `min_size`
+    /// bytes, checked against what is left so a corrupt count fails here
+    /// instead of reserving a huge vector.
+    fn count(&mut self, min_size: usize) -> std::io::Result<usize> {
+        let count = self.len()?;
+        if count.saturating_mul(min_size) > self.buf.len() - self.pos {
+            return Err(io_error("snapshot metadata is truncated"));
+        }
+        Ok(count)
+    }
+    fn str(&mut self) -> std::io::Result<&'a str> {
+        let len = self.len()?;
+        std::str::from_utf8(self.take(len)?).map_err(io_error)
+    }
+    fn date_system(&mut self) -> std::io::Result<DateSystem> {
+        match self.u8()? {
+            0 => Ok(DateSystem::Excel1900),
+            1 => Ok(DateSystem::Excel1904),
+            other => Err(io_error(format!("unknown date system {other}"))),
+        }
+    }
+
+    fn value(&mut self) -> std::io::Result<OverlayValue> {
+        let tag = self.u8()?;
+        self.value_with_tag(tag)
+    }
+
+    fn value_with_tag(&mut self, tag: u8) -> std::io::Result<OverlayValue> {
+        Ok(match tag {
+            0 => OverlayValue::Empty,
+            1 => OverlayValue::Number(self.f64()?),
+            2 => OverlayValue::DateTime(self.f64()?),
+            3 => OverlayValue::Duration(self.f64()?),
+            4 => OverlayValue::Boolean(self.u8()? != 0),
+            5 => OverlayValue::Text(Arc::from(self.str()?)),
+            6 => OverlayValue::Error(self.u8()?),
+            7 => OverlayValue::Pending,
+            other => return Err(io_error(format!("unknown value tag {other}"))),
+        })
+    }
+
+    fn literal(&mut self, date_system: DateSystem) -> std::io::Result<LiteralValue> {
+        Ok(match self.u8()? {
+            8 => LiteralValue::Int(self.u64()? as i64),
+            9 => {
+                let kind = super::unmap_error_code(self.u8()?);
+                let message = self.str()?;
+                let error = formualizer_common::ExcelError::new(kind);
+                LiteralValue::Error(if message.is_empty() {
+                    error
+                } else {
+                    error.with_message(message.to_string())
+                })
+            }
+            tag => self.value_with_tag(tag)?.to_literal_for(date_system),
+        })
+    }
+
+    fn formulas(&mut self, date_system: DateSystem) -> std::io::Result<SnapshotFormulas> {
+        let count = self.count(8)?;
+        let strings = (0..count)
+            .map(|_| self.str().map(str::to_string))
+            .collect::<std::io::Result<Vec<_>>>()?;
+        let count = self.count(1)?;
+        let mut nodes = Vec::with_capacity(count);
+        for _ in 0..count {
+            nodes.push(self.ast_node(date_system)?);
+        }
+        let count = self.count(16)?;
+        let mut sheets = Vec::with_capacity(count);
+        for _ in 0..count {
+            let sheet = self.str()?.to_string();
+            let cells = (0..self.count(20)?)
+                .map(|_| {
+                    Ok(SnapshotPlacement {
+                        row: self.u32()?,
+                        col: self.u32()?,
+                        root: self.u32()?,
+                        anchor_row: self.u32()?,
+                        anchor_col: self.u32()?,
+                    })
+                })
+                .collect::<std::io::Result<Vec<_>>>()?;
+            sheets.push(SnapshotSheetFormulas { sheet, cells });
+        }
+        Ok(SnapshotFormulas {
+            strings,
+            nodes,
+            sheets,
+        })
+    }
+
+    fn ast_node(&mut self, date_system: DateSystem) -> std::io::Result<SnapshotAstNode> {
+        Ok(match self.u8()? {
+            0 => SnapshotAstNode::Literal(self.literal(date_system)?),
+            1 => SnapshotAstNode::Reference {
+                original: self.u32()?,
+                reference: self.reference()?,
+            },
+            2 => SnapshotAstNode::Unary {
+                op: self.u32()?,
+                expr: self.u32()?,
+            },
+            3 => SnapshotAstNode::Binary {
+                op: self.u32()?,
+                left: self.u32()?,
+                right: self.u32()?,
+            },
+            4 => SnapshotAstNode::Function {
+                name: self.u32()?,
+                args: self.ids()?,
+            },
+            5 => SnapshotAstNode::Array {
+                rows: u16::try_from(self.u32()?).map_err(io_error)?,
+                cols: u16::try_from(self.u32()?).map_err(io_error)?,
+                elements: self.ids()?,
+            },
+            6 => SnapshotAstNode::Text(self.str()?.to_string()),
+            other => return Err(io_error(format!("unknown formula node {other}"))),
+        })
+    }
+
+    fn ids(&mut self) -> std::io::Result<Vec<u32>> {
+        (0..self.count(4)?).map(|_| self.u32()).collect()
+    }
+
+    fn flags<const N: usize>(&mut self) -> std::io::Result<[bool; N]> {
+        let bits = self.u8()?;
+        Ok(std::array::from_fn(|i| bits & (1 << i) != 0))
+    }
+
+    fn sheet(&mut self) -> std::io::Result<Option<u32>> {
+        Ok(self.u32()?.checked_sub(1))
+    }
+
+    fn reference(&mut self) -> std::io::Result<SnapshotReference> {
+        Ok(match self.u8()? {
+            0 => {
+                let sheet = self.sheet()?;
+                let (row, col) = (self.u32()?, self.u32()?);
+                let [row_abs, col_abs] = self.flags()?;
+                SnapshotReference::Cell {
+                    sheet,
+                    row,
+                    col,
+                    row_abs,
+                    col_abs,
+                }
+            }
+            1 => SnapshotReference::Range {
+                sheet: self.sheet()?,
+                start_row: self.u32()?,
+                start_col: self.u32()?,
+                end_row: self.u32()?,
+                end_col: self.u32()?,
+                abs: self.flags()?,
+            },
+            2 => SnapshotReference::Named(self.u32()?),
+            3 => {
+                let (sheet_first, sheet_last) = (self.u32()?, self.u32()?);
+                let (row, col) = (self.u32()?, self.u32()?);
+                let [row_abs, col_abs] = self.flags()?;
+                SnapshotReference::Cell3D {
+                    sheet_first,
+                    sheet_last,
+                    row,
+                    col,
+                    row_abs,
+                    col_abs,
+                }
+            }
+            4 => SnapshotReference::Range3D {
+                sheet_first: self.u32()?,
+                sheet_last: self.u32()?,
+                start_row: self.u32()?,
+                start_col: self.u32()?,
+                end_row: self.u32()?,
+                end_col: self.u32()?,
+                abs: self.flags()?,
+            },
+            other => return Err(io_error(format!("unknown reference kind {other}"))),
+        })
+    }
+
+    fn chunk(
+        &mut self,
+        batches: &mut [Vec<Option<arrow::record_batch::RecordBatch>>],
+        dicts: &[Arc<TextDictionary>],
+    ) -> std::io::Result<ColumnChunk> {
+        match self.u8()? {
+            0 => {
+                let file = self.len()?;
+                let batch = self.len()?;
+                let dict = match self.len()? {
+                    0 => None,
+                    d => Some(
+                        dicts
+                            .get(d - 1)
+                            .cloned()
+                            .ok_or_else(|| io_error("snapshot dictionary out of range"))?,
+                    ),
+                };
+                let mut meta = ColumnChunkMeta {
+                    len: self.len()?,
+                    non_null_num: self.len()?,
+                    non_null_bool: self.len()?,
+                    non_null_text: self.len()?,
+                    non_null_err: self.len()?,
+                    zone: ZoneMap::EMPTY,
+                };
+                meta.zone.num_min = self.f64()?;
+                meta.zone.num_max = self.f64()?;
+                meta.zone.text_bloom = self.u64()?;
+                let flags = self.u8()?;
+                meta.zone.has_blank = flags & 1 != 0;
+                meta.zone.has_bool = flags & 2 != 0;
+                meta.zone.has_text = flags & 4 != 0;
+                meta.zone.has_error = flags & 8 != 0;
+                meta.zone.numbers_ascending = flags & 16 != 0;
+
+                let batch = batches
+                    .get_mut(file)
+                    .and_then(|f| f.get_mut(batch))
+                    .and_then(Option::take)
+                    .ok_or_else(|| io_error("snapshot chunk batch missing or reused"))?;
+                let layout = LaneLayout::of_batch(&batch);
+                let mut lanes = DecodedLanes::from_batch(&layout, &batch)?;
+                if lanes.len() != meta.len {
+                    return Err(io_error("snapshot chunk length mismatch"));
+                }
+                if flags & 32 != 0 {
+                    lanes = lanes.with_uniform_tags();
+                }
+                Ok(lanes.into_chunk(meta, dict))
+            }
+            1 => {
+                let count = self.count(5)?;
+                let mut run_ends = Vec::with_capacity(count);
+                let mut values = Vec::with_capacity(count);
+                for _ in 0..count {
+                    run_ends.push(self.u32()?);
+                    values.push(self.value()?);
+                }
+                if run_ends.windows(2).any(|w| w[0] >= w[1]) || run_ends.first() == Some(&0) {
+                    return Err(io_error("snapshot runs are not increasing"));
+                }
+                Ok(ColumnChunk::from_runs(ChunkRuns { run_ends, values }))
+            }
+            other => Err(io_error(format!("unknown chunk encoding {other}"))),
+        }
+    }
+
+    fn name(&mut self, date_system: DateSystem) -> std::io::Result<SnapshotName> {
+        let name = self.str()?.to_string();
+        let scope_sheet = match self.u8()? {
+            0 => None,
+            _ => Some(self.str()?.to_string()),
+        };
+        let target = match self.u8()? {
+            0 => SnapshotNameTarget::Range {
+                sheet: self.str()?.to_string(),
+                start_row: self.u32()?,
+                start_col: self.u32()?,
+                end_row: self.u32()?,
+                end_col: self.u32()?,
+            },
+            1 => SnapshotNameTarget::Literal(self.value()?.to_literal_for(date_system)),
+            2 => SnapshotNameTarget::Formula(self.str()?.to_string()),
+            other => return Err(io_error(format!("unknown name target {other}"))),
+        };
+        Ok(SnapshotName {
+            name,
+            scope_sheet,
+            target,
+        })
+    }
+}
@@ -0,0 +1,106 @@
+//! Type tag lanes: shared lanes for homogeneous chunks and packed tag masks.
+//!
+//! Most chunks hold one kind of value: a column of amounts is all numbers, a padding
+//! region all empty. Such chunks do not own a tag lane; their `type_tag` is a slice of a
+//! process-wide buffer holding only that tag. [`uniform_type_tag`] recognises these
+//! slices by address, without locking, so readers can handle a homogeneous segment as a
+//! whole instead of checking its tags row by row. Mixed chunks keep their own lane, and
+//! [`tag_mask`] turns it into a packed bitmap 64 rows at a time.
+
+use std::sync::{Arc, OnceLock};
+
+use arrow_array::{Array, UInt8Array};
+use arrow_buffer::{BooleanBuffer, Buffer, ScalarBuffer};
+
+use super::TypeTag;
+
+const TAG_COUNT: usize = TypeTag::Pending as usize + 1;
+
+/// Smallest shared buffer; chunks are usually at most this long.
+const MIN_SHARED_LEN: usize = 64 * 1024;
+
+/// Shared buffer sizes per tag: class `k` holds `MIN_SHARED_LEN << k` rows.
+const SIZE_CLASSES: usize = (usize::BITS - MIN_SHARED_LEN.trailing_zeros()) as usize;
+
+/// Rows compared per step when checking a lane for uniformity; the inner comparison has
+/// no early exit so it compiles to wide vector compares.
+const UNIFORM_SCAN_BLOCK: usize = 64;
+
+/// Shared buffers per tag and size class, allocated on first use and never replaced,
+/// so lookups only read initialised cells.
+static SHARED: [[OnceLock<Buffer>; SIZE_CLASSES]; TAG_COUNT] =
+    [const { [const { OnceLock::new() }; SIZE_CLASSES] }; TAG_COUNT];
+
+/// Smallest size class holding `len` rows.
+fn size_class(len: usize) -> usize {
+    len.div_ceil(MIN_SHARED_LEN)
+        .next_power_of_two()
+        .trailing_zeros() as usize
+}
+
+/// `len` rows of `tag`, backed by the shared buffer for `tag`.
+pub fn uniform_tags(tag: TypeTag, len: usize) -> UInt8Array {
+    let class = size_class(len);
+    let buf = SHARED[tag as usize][class]
+        .get_or_init(|| Buffer::from_vec(vec![tag as u8; MIN_SHARED_LEN << class]));
+    UInt8Array::new(ScalarBuffer::new(buf.clone(), 0, len), None)
+}
+
+/// The tag of every row when `tags` is a slice of a shared lane from [`uniform_tags`].
+///
+/// Returns `None` for lanes a chunk owns even if their rows happen to agree, and for
+/// empty lanes.
+pub fn uniform_type_tag(tags: &UInt8Array) -> Option<TypeTag> {
+    if tags.is_empty() || tags.null_count() > 0 {
+        return None;
+    }
+    let first = tags.value(0);
+    let bufs_idx = usize::from(first);
+    if bufs_idx >= TAG_COUNT {
+        return None;
+    }
+    let start = tags.values().as_ptr() as usize;
+    let end = start + tags.len();
+    // Only buffers at least as long as the lane can contain it.
+    SHARED[bufs_idx][size_class(tags.len())..]
+        .iter()
+        .filter_map(OnceLock::get)
+        .any(|buf| {
+            let base = buf.as_ptr() as usize;
+            base <= start && end <= base + buf.len()
+        })
+        .then(|| TypeTag::from_u8(first))
+}
+
+/// `tags` as a shared lane when every row carries the same tag, otherwise as is.
+pub(crate) fn share_uniform_tags(tags: UInt8Array) -> Arc<UInt8Array> {
+    if tags.null_count() == 0
+        && let Some(&first) = tags.values().first()
+        && usize::from(first) < TAG_COUNT
+        && tags
+            .values()
+            .chunks(UNIFORM_SCAN_BLOCK)
+            .all(|block| block.iter().fold(true, |all, &t| all & (t == first)))
+    {
+        return Arc::new(uniform_tags(TypeTag::from_u8(first), tags.len()));
+    }
+    Arc::new(tags)
+}
+
+/// Rows of `tags` equal to `tag`, as a packed bitmap. Null rows are unset.
+pub fn tag_mask(tags: &UInt8Array, tag: TypeTag) -> BooleanBuffer {
+    if let Some(uniform) = uniform_type_tag(tags) {
+        return if uniform == tag {
+            BooleanBuffer::new_set(tags.len())
+        } else {
+            BooleanBuffer::new_unset(tags.len())
+        };
+    }
+    let values = tags.values();
+    let wanted = tag as u8;
+    let mask = BooleanBuffer::collect_bool(values.len(), |i| values[i] == wanted);
+    match tags.nulls() {
+        Some(nulls) => &mask & nulls.inner(),
+        None => mask,
+    }
+}
@@ -24,7 +24,7 @@
 //! - Multiple columns in same row have AND relationship
 //! - Supports comparison operators (>, <, >=, <=, <>), wildcards (*, ?)
 
-use super::utils::{ARG_ANY_ONE, coerce_num, criteria_match};
+use super::utils::{ARG_ANY_ONE, coerce_num, criteria_match, criteria_may_match};
 use crate::args::{ArgSchema, CriteriaPredicate, parse_criteria};
 use crate::function::Function;
 use crate::traits::{ArgumentHandle, CalcValue, FunctionContext};
@@ -182,6 +182,31 @@ fn row_matches_criteria(
     false
 }
 
+/// Data rows (1-based within the view) that may match `criteria_rows`. Chunks whose zone
+/// maps rule out every criteria row are skipped without reading their cells.
+fn candidate_rows(
+    db_view: &crate::engine::range_view::RangeView<'_>,
+    criteria_rows: &[Vec<(usize, CriteriaPredicate)>],
+) -> Result<impl Iterator<Item = usize>, ExcelError> {
+    let mut ranges = Vec::new();
+    for (start, len) in db_view.row_chunk_bounds()? {
+        let (start, end) = (start.max(1), start + len);
+        if start >= end {
+            continue;
+        }
+        let may_match = criteria_rows.is_empty()
+            || criteria_rows.iter().any(|crit_row| {
+                crit_row.iter().all(|(col_idx, pred)| {
+                    criteria_may_match(pred, &db_view.zone_map(start, end - start, *col_idx))
+                })
+            });
+        if may_match {
+            ranges.push(start..end);
+        }
+    }
+    Ok(ranges.into_iter().flatten())
+}
+
 /// Core evaluation function for all D-functions.
 fn eval_d_function<'a, 'b>(
     args: &[ArgumentHandle<'a, 'b>],
@@ -256,7 +281,7 @@ fn eval_d_function<'a, 'b>(
     let mut values: Vec<f64> = Vec::new();
 
     // Iterate over data rows (starting from row 1, skipping header)
-    for row in 1..db_rows {
+    for row in candidate_rows(&db_view, &criteria_rows)? {
         if row_matches_criteria(&db_view, row, &criteria_rows) {
             let cell_val = db_view.get_cell(row, field_idx);
 
@@ -418,7 +443,7 @@ fn eval_d_stat_function<'a, 'b>(
     // Collect matching numeric values from the field column
     let mut values: Vec<f64> = Vec::new();
 
-    for row in 1..db_rows {
+    for row in candidate_rows(&db_view, &criteria_rows)? {
         if row_matches_criteria(&db_view, row, &criteria_rows) {
             let cell_val = db_view.get_cell(row, field_idx);
 
@@ -441,38 +466,17 @@ fn eval_d_stat_function<'a, 'b>(
         }
     }
 
-    // Compute statistical result
-    let result = match stat_op {
-        DStatOp::VarSample | DStatOp::StdevSample => {
-            // Sample variance/stdev requires at least 2 values
-            if values.len() < 2 {
-                LiteralValue::Error(ExcelError::new_div())
-            } else {
-                let n = values.len() as f64;
-                let mean = values.iter().sum::<f64>() / n;
-                let variance = values.iter().map(|x| (x - mean).powi(2)).sum::<f64>() / (n - 1.0);
-                if matches!(stat_op, DStatOp::VarSample) {
-                    LiteralValue::Number(variance)
-                } else {
-                    LiteralValue::Number(variance.sqrt())
-                }
-            }
-        }
-        DStatOp::VarPop | DStatOp::StdevPop => {
-            // Population variance/stdev requires at least 1 value
-            if values.is_empty() {
-                LiteralValue::Error(ExcelError::new_div())
-            } else {
-                let n = values.len() as f64;
-                let mean = values.iter().sum::<f64>() / n;
-                let variance = values.iter().map(|x| (x - mean).powi(2)).sum::<f64>() / n;
-                if matches!(stat_op, DStatOp::VarPop) {
-                    LiteralValue::Number(variance)
-                } else {
-                    LiteralValue::Number(variance.sqrt())
-                }
-            }
-        }
+    // Compute statistical result: sample statistics need at least 2 values, population
+    // statistics at least 1
+    let moments = crate::arrow_store::kernels::moments(&values, None);
+    let variance = match stat_op {
+        DStatOp::VarSample | DStatOp::StdevSample => moments.variance_sample(),
+        DStatOp::VarPop | DStatOp::StdevPop => moments.variance_population(),
+    };
+    let result = match (stat_op, variance) {
+        (_, None) => LiteralValue::Error(ExcelError::new_div()),
+        (DStatOp::VarSample | DStatOp::VarPop, Some(v)) => LiteralValue::Number(v),
+        (DStatOp::StdevSample | DStatOp::StdevPop, Some(v)) => LiteralValue::Number(v.sqrt()),
     };
 
     Ok(CalcValue::Scalar(result))
@@ -544,12 +548,17 @@ fn eval_dget<'a, 'b>(
     // Parse criteria
     let criteria_rows = parse_criteria_range(&crit_view, &headers)?;
 
-    // Find matching values
-    let mut matching_values: Vec<LiteralValue> = Vec::new();
+    // Find the matching row; a second match settles the result.
+    let mut matching_row = None;
+    let mut multiple = false;
 
-    for row in 1..db_rows {
+    for row in candidate_rows(&db_view, &criteria_rows)? {
         if row_matches_criteria(&db_view, row, &criteria_rows) {
-            matching_values.push(db_view.get_cell(row, field_idx));
+            if matching_row.is_some() {
+                multiple = true;
+                break;
+            }
+            matching_row = Some(row);
         }
     }
 
@@ -557,14 +566,14 @@ fn eval_dget<'a, 'b>(
     // - #VALUE! if no match
     // - #NUM! if more than one match
     // - The single value if exactly one match
-    let result = if matching_values.is_empty() {
-        LiteralValue::Error(ExcelError::new_value().with_message("No record matches criteria"))
-    } else if matching_values.len() > 1 {
-        LiteralValue::Error(
+    let result = match matching_row {
+        None => {
+            LiteralValue::Error(ExcelError::new_value().with_message("No record matches criteria"))
+        }
+        Some(_) if multiple => LiteralValue::Error(
             ExcelError::new_num().with_message("More than one record matches criteria"),
-        )
-    } else {
-        matching_values.into_iter().next().unwrap()
+        ),
+        Some(row) => db_view.get_cell(row, field_idx),
     };
 
     Ok(CalcValue::Scalar(result))
@@ -639,7 +648,7 @@ fn eval_dcounta<'a, 'b>(
     // Count non-blank cells in matching rows
     let mut count = 0;
 
-    for row in 1..db_rows {
+    for row in candidate_rows(&db_view, &criteria_rows)? {
         if row_matches_criteria(&db_view, row, &criteria_rows) {
             let cell_val = db_view.get_cell(row, field_idx);
 
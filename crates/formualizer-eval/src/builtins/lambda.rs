@@ -1,3 +1,5 @@
+use crate::engine::DateSystem;
+use crate::engine::range_view::RangeView;
 use crate::function::{FnCaps, Function};
 use crate::function_contract::{
     FunctionArgumentDependencyContract, FunctionArityRule, FunctionDependencyClass,
@@ -24,26 +26,47 @@ fn local_name_from_ast(node: &ASTNode) -> Result<String, ExcelError> {
     }
 }
 
-fn binding_from_calc_value(cv: CalcValue<'_>) -> LocalBinding {
+fn binding_from_calc_value(cv: CalcValue<'_>, date_system: DateSystem) -> LocalBinding {
     match cv {
-        CalcValue::Scalar(v) => LocalBinding::Value(v),
+        CalcValue::Scalar(v) => binding_from_value(v, date_system),
         CalcValue::Range(rv) => {
             let (rows, cols) = rv.dims();
             if rows == 1 && cols == 1 {
-                LocalBinding::Value(rv.get_cell(0, 0))
-            } else {
-                let mut data = Vec::with_capacity(rows);
-                let _ = rv.for_each_row(&mut |row| {
-                    data.push(row.to_vec());
-                    Ok(())
-                });
-                LocalBinding::Value(LiteralValue::Array(data))
+                return LocalBinding::Value(rv.get_cell(0, 0));
+            }
+            // Arrays produced by functions are already owned: bind the view.
+            // Views over workbook cells borrow the sheet and are copied once
+            // into an owned view, so reads share it instead of cloning rows.
+            match rv.into_owned() {
+                Ok(owned) => LocalBinding::Range(owned),
+                Err(rv) => {
+                    let mut data = Vec::with_capacity(rows);
+                    let _ = rv.for_each_row(&mut |row| {
+                        // owned-range: the binding outlives the borrowed sheet.
+                        data.push(row.to_vec());
+                        Ok(())
+                    });
+                    LocalBinding::Range(RangeView::from_owned_rows(data, date_system))
+                }
             }
         }
         CalcValue::Callable(c) => LocalBinding::Callable(c),
     }
 }
 
+/// Multi-cell arrays are bound as owned views; a `LiteralValue::Array`
+/// binding would be deep-cloned on every read.
+fn binding_from_value(v: LiteralValue, date_system: DateSystem) -> LocalBinding {
+    match v {
+        LiteralValue::Array(rows)
+            if rows.len() > 1 || rows.first().is_some_and(|r| r.len() > 1) =>
+        {
+            LocalBinding::Range(RangeView::from_owned_rows(rows, date_system))
+        }
+        other => LocalBinding::Value(other),
+    }
+}
+
 #[derive(Debug)]
 pub struct LetFn;
 
@@ -148,7 +171,7 @@ impl Function for LetFn {
     fn eval<'a, 'b, 'c>(
         &self,
         args: &'c [ArgumentHandle<'a, 'b>],
-        _ctx: &dyn FunctionContext<'b>,
+        ctx: &dyn FunctionContext<'b>,
     ) -> Result<CalcValue<'b>, ExcelError> {
         if args.len() < 3 || args.len().is_multiple_of(2) {
             return Ok(CalcValue::Scalar(LiteralValue::Error(value_error(
@@ -165,7 +188,12 @@ impl Function for LetFn {
             };
 
             let bound = args[pair_idx + 1].value_with_env(env.clone())?;
-            env = env.with_binding(&name, binding_from_calc_value(bound));
+            // The clone handed to the value expression is gone by now unless a
+            // LAMBDA captured it, so this push normally extends `env` in place.
+            env.push_binding(
+                LocalEnv::slot_name(&name),
+                binding_from_calc_value(bound, ctx.date_system()),
+            );
         }
 
         args[args.len() - 1].value_with_env(env)
@@ -174,7 +202,8 @@ impl Function for LetFn {
 
 #[derive(Clone)]
 struct LambdaClosure {
-    params: Vec<String>,
+    /// Parameter slot names, normalized once at definition.
+    params: Vec<Arc<str>>,
     body: ASTNode,
     captured_env: LocalEnv,
 }
@@ -199,9 +228,10 @@ impl CustomCallable for LambdaClosure {
             ))));
         }
 
+        let date_system = interp.context.date_system();
         let mut env = self.captured_env.clone();
         for (name, value) in self.params.iter().zip(args.iter()) {
-            env = env.with_binding(name, LocalBinding::Value(value.clone()));
+            env.push_binding(name.clone(), binding_from_value(value.clone(), date_system));
         }
 
         let scoped = interp.with_local_env(env);
@@ -324,13 +354,13 @@ impl Function for LambdaFn {
                 Ok(name) => name,
                 Err(e) => return Ok(CalcValue::Scalar(LiteralValue::Error(e))),
             };
-            let key = name.to_ascii_uppercase();
-            if !seen.insert(key) {
+            let key = LocalEnv::slot_name(&name);
+            if !seen.insert(key.clone()) {
                 return Ok(CalcValue::Scalar(LiteralValue::Error(value_error(
                     "LAMBDA parameter names must be unique",
                 ))));
             }
-            params.push(name);
+            params.push(key);
         }
 
         let closure = LambdaClosure {
@@ -378,6 +408,49 @@ mod tests {
         interp.evaluate_ast(&ast).map(|v| v.into_literal())
     }
 
+    #[test]
+    fn range_bound_names_share_one_copy_across_reads() {
+        use crate::arrow_store::IngestBuilder;
+        use crate::engine::range_view::RangeBacking;
+
+        let mut ib = IngestBuilder::new("Sheet1", 1, 1024, DateSystem::Excel1900);
+        for r in 0..5000 {
+            ib.append_row(&[LiteralValue::Number(r as f64)]).unwrap();
+        }
+        let sheet = ib.finish();
+        // A view borrowing workbook cells is copied once, at bind time.
+        let borrowed = RangeView::new(RangeBacking::Borrowed(&sheet), 0, 0, 4999, 0, 5000, 1);
+        let binding = binding_from_calc_value(CalcValue::Range(borrowed), DateSystem::Excel1900);
+        let LocalBinding::Range(bound) = &binding else {
+            panic!("expected an owned range binding");
+        };
+        let bound_sheet: *const _ = bound.sheet();
+
+        let wb = test_wb();
+        let interp = wb
+            .interpreter()
+            .with_local_env(LocalEnv::default().with_binding("x", binding.clone()));
+        let ast = parse("=x").unwrap();
+        for _ in 0..3 {
+            match interp.evaluate_ast(&ast).unwrap() {
+                CalcValue::Range(rv) => {
+                    assert!(std::ptr::eq(rv.sheet(), bound_sheet));
+                    assert_eq!(rv.dims(), (5000, 1));
+                }
+                _ => panic!("expected the bound range view"),
+            }
+        }
+    }
+
+    #[test]
+    fn let_binds_array_literals_as_ranges() {
+        crate::builtins::load_builtins();
+        assert_eq!(
+            eval("=LET(x,{1,2;3,4},SUM(x)+ROWS(x)+COLUMNS(x))"),
+            LiteralValue::Number(14.0)
+        );
+    }
+
     #[test]
     fn let_binds_values() {
         assert_eq!(eval("=LET(x,2,x+3)"), LiteralValue::Number(5.0));
@@ -471,6 +544,26 @@ mod tests {
         );
     }
 
+    #[test]
+    fn local_env_pushes_copy_on_write() {
+        let base = LocalEnv::default().with_binding("a", LocalBinding::Value(LiteralValue::Int(1)));
+        let mut inner = base.clone();
+        inner.push_binding(
+            LocalEnv::slot_name("a"),
+            LocalBinding::Value(LiteralValue::Int(2)),
+        );
+        assert_eq!((base.depth(), inner.depth()), (1, 2));
+        assert!(matches!(
+            base.get("A"),
+            Some(LocalBinding::Value(LiteralValue::Int(1)))
+        ));
+        assert!(matches!(
+            inner.get("a"),
+            Some(LocalBinding::Value(LiteralValue::Int(2)))
+        ));
+        assert!(inner.get("b").is_none());
+    }
+
     #[test]
     fn let_undefined_symbol_before_binding_errors() {
         let err = eval_result("=LET(x,y,y,2,x)").expect_err("expected #NAME?");
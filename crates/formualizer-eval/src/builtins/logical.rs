@@ -6,6 +6,7 @@ use crate::function::Function;
 use crate::traits::{ArgumentHandle, FunctionContext};
 use formualizer_common::{ExcelError, LiteralValue};
 use formualizer_macros::func_caps;
+use std::ops::ControlFlow;
 
 /* ─────────────────────────── TRUE() ─────────────────────────────── */
 
@@ -209,38 +210,27 @@ impl Function for AndFn {
     ) -> Result<crate::traits::CalcValue<'b>, ExcelError> {
         let mut first_error: Option<LiteralValue> = None;
         for h in args {
-            let it = h.lazy_values_owned()?;
-            for v in it {
+            let flow = h.for_each_value(&mut |v| {
                 match v {
                     LiteralValue::Error(_) => {
                         if first_error.is_none() {
-                            first_error = Some(v);
+                            first_error = Some(v.clone());
                         }
                     }
-                    LiteralValue::Empty => {
-                        return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Boolean(
-                            false,
-                        )));
-                    }
+                    LiteralValue::Empty => return ControlFlow::Break(()),
                     LiteralValue::Boolean(b) => {
                         if !b {
-                            return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Boolean(
-                                false,
-                            )));
+                            return ControlFlow::Break(());
                         }
                     }
                     LiteralValue::Number(n) => {
-                        if n == 0.0 {
-                            return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Boolean(
-                                false,
-                            )));
+                        if *n == 0.0 {
+                            return ControlFlow::Break(());
                         }
                     }
                     LiteralValue::Int(i) => {
-                        if i == 0 {
-                            return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Boolean(
-                                false,
-                            )));
+                        if *i == 0 {
+                            return ControlFlow::Break(());
                         }
                     }
                     _ => {
@@ -253,6 +243,13 @@ impl Function for AndFn {
                         }
                     }
                 }
+                ControlFlow::Continue(())
+            })?;
+            // A decisive FALSE wins over any error seen so far.
+            if flow.is_break() {
+                return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Boolean(
+                    false,
+                )));
             }
         }
         if let Some(err) = first_error {
@@ -334,36 +331,29 @@ impl Function for OrFn {
     ) -> Result<crate::traits::CalcValue<'b>, ExcelError> {
         let mut first_error: Option<LiteralValue> = None;
         for h in args {
-            let it = h.lazy_values_owned()?;
-            for v in it {
+            let flow = h.for_each_value(&mut |v| {
                 match v {
                     LiteralValue::Error(_) => {
                         if first_error.is_none() {
-                            first_error = Some(v);
+                            first_error = Some(v.clone());
                         }
                     }
                     LiteralValue::Empty => {
                         // ignored
                     }
                     LiteralValue::Boolean(b) => {
-                        if b {
-                            return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Boolean(
-                                true,
-                            )));
+                        if *b {
+                            return ControlFlow::Break(());
                         }
                     }
                     LiteralValue::Number(n) => {
-                        if n != 0.0 {
-                            return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Boolean(
-                                true,
-                            )));
+                        if *n != 0.0 {
+                            return ControlFlow::Break(());
                         }
                     }
                     LiteralValue::Int(i) => {
-                        if i != 0 {
-                            return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Boolean(
-                                true,
-                            )));
+                        if *i != 0 {
+                            return ControlFlow::Break(());
                         }
                     }
                     _ => {
@@ -376,6 +366,13 @@ impl Function for OrFn {
                         }
                     }
                 }
+                ControlFlow::Continue(())
+            })?;
+            // A decisive TRUE wins over any error seen so far.
+            if flow.is_break() {
+                return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Boolean(
+                    true,
+                )));
             }
         }
         if let Some(err) = first_error {
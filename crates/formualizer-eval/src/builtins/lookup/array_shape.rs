@@ -112,22 +112,6 @@ fn schema() -> &'static [ArgSchema] {
     &SCHEMA
 }
 
-fn materialize_arg<'b>(arg: &ArgumentHandle<'_, 'b>) -> Result<Vec<Vec<LiteralValue>>, ExcelError> {
-    if let Ok(view) = arg.range_view() {
-        let mut rows = Vec::new();
-        view.for_each_row(&mut |row| {
-            rows.push(row.to_vec());
-            Ok(())
-        })?;
-        return Ok(rows);
-    }
-
-    Ok(match arg.value()?.into_literal() {
-        LiteralValue::Array(rows) => rows,
-        v => vec![vec![v]],
-    })
-}
-
 fn ignore_mode<'b>(args: &[ArgumentHandle<'_, 'b>]) -> Result<i64, ExcelError> {
     if args.len() < 2 {
         return Ok(0);
@@ -169,27 +153,35 @@ fn flatten_array<'b>(args: &[ArgumentHandle<'_, 'b>]) -> Result<Vec<LiteralValue
     if args.is_empty() || args.len() > 3 {
         return Err(ExcelError::new(ExcelErrorKind::Value));
     }
-    let data = materialize_arg(&args[0])?;
+    // Ranges and arrays are read in place; anything else is a 1x1 grid.
+    let view = args[0].range_view().ok();
+    let scalar = match view {
+        Some(_) => LiteralValue::Empty,
+        None => args[0].value()?.into_literal(),
+    };
     let ignore = ignore_mode(args)?;
     let scan_by_col = scan_by_column(args)?;
 
-    let rows = data.len();
-    let cols = data.iter().map(Vec::len).max().unwrap_or(0);
+    let (rows, cols) = view.as_ref().map_or((1, 1), |view| view.dims());
+    let cell = |r: usize, c: usize| match &view {
+        Some(view) => view.get_cell(r, c),
+        None => scalar.clone(),
+    };
     let mut flat = Vec::with_capacity(rows.saturating_mul(cols));
 
     if scan_by_col {
         for c in 0..cols {
-            for row in &data {
-                let v = row.get(c).cloned().unwrap_or(LiteralValue::Empty);
+            for r in 0..rows {
+                let v = cell(r, c);
                 if include_cell(&v, ignore) {
                     flat.push(v);
                 }
             }
         }
     } else {
-        for row in &data {
+        for r in 0..rows {
             for c in 0..cols {
-                let v = row.get(c).cloned().unwrap_or(LiteralValue::Empty);
+                let v = cell(r, c);
                 if include_cell(&v, ignore) {
                     flat.push(v);
                 }
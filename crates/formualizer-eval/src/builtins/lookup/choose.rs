@@ -153,28 +153,6 @@ impl Function for ChooseFn {
 
 /* ───────────────────────── CHOOSECOLS() / CHOOSEROWS() ───────────────────────── */
 
-fn materialize_rows_2d<'b>(
-    arg: &ArgumentHandle<'_, 'b>,
-    ctx: &dyn FunctionContext<'b>,
-) -> Result<Vec<Vec<formualizer_common::LiteralValue>>, ExcelError> {
-    if let Ok(r) = arg.as_reference_or_eval() {
-        let mut rows: Vec<Vec<LiteralValue>> = Vec::new();
-        let sheet = ctx.current_sheet();
-        let rv = ctx.resolve_range_view(&r, sheet)?;
-        rv.for_each_row(&mut |row| {
-            rows.push(row.to_vec());
-            Ok(())
-        })?;
-        Ok(rows)
-    } else {
-        let v = arg.value()?.into_literal();
-        match v {
-            LiteralValue::Array(a) => Ok(a),
-            other => Ok(vec![vec![other]]),
-        }
-    }
-}
-
 /// Returns selected columns from an array or range.
 ///
 /// `CHOOSECOLS` builds a new spilled array containing only the requested columns, in the
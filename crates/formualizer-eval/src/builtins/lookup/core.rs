@@ -4,12 +4,15 @@
 //! - MATCH supports match_type: 0 exact, 1 approximate (largest <= lookup), -1 approximate (smallest >= lookup)
 //! - Approximate modes assume data sorted ascending (1) or descending (-1); unsorted leads to #N/A like Excel (we don't yet detect unsorted reliably, TODO)
 //! - Binary search used for approximate modes for efficiency; linear scan for exact or when data small (<8 elements) to avoid overhead.
+//! - Ascending approximate lookups over columns that zone maps prove sorted and numeric search only the target chunk.
 //! - VLOOKUP/HLOOKUP wrap MATCH logic; VLOOKUP: vertical first column; HLOOKUP: horizontal first row.
 //! - Error propagation: if lookup_value is error -> propagate. If table/range contains errors in non-deciding positions, they don't matter unless selected.
 //! - Type coercion: current simple: numbers vs numeric text coerced; text comparison case-insensitive? Excel is case-insensitive for MATCH (without wildcards). We implement case-insensitive for now.
 //!   TODO(excel-nuance): refine boolean/text/number coercion differences.
 
-use super::lookup_utils::{cmp_for_lookup, find_exact_index, is_sorted_ascending};
+use super::lookup_utils::{
+    approximate_number_in_ascending_view, cmp_for_lookup, find_exact_index, is_sorted_ascending,
+};
 use crate::args::{ArgSchema, CoercionPolicy, ShapeKind};
 use crate::engine::lookup_index_cache::LookupAxis;
 use crate::function::Function;
@@ -18,6 +21,15 @@ use formualizer_common::ArgKind;
 use formualizer_common::{ExcelError, ExcelErrorKind, LiteralValue};
 use formualizer_macros::func_caps;
 
+/// Numeric lookup value for the zone-map approximate path.
+fn approximate_needle(lookup_value: &LiteralValue) -> Option<f64> {
+    match lookup_value {
+        LiteralValue::Number(n) => Some(*n),
+        LiteralValue::Int(i) => Some(*i as f64),
+        _ => None,
+    }
+}
+
 fn binary_search_match(slice: &[LiteralValue], needle: &LiteralValue, mode: i32) -> Option<usize> {
     if mode == 0 || slice.is_empty() {
         return None;
@@ -247,6 +259,16 @@ impl Function for MatchFn {
                         )));
                     }
 
+                    if mt == 1
+                        && let Some(n) = approximate_needle(&lookup_value)
+                        && let Some(found) = approximate_number_in_ascending_view(&rv, n)?
+                    {
+                        return Ok(crate::traits::CalcValue::Scalar(match found {
+                            Some(i) => LiteralValue::Int((i + 1) as i64),
+                            None => LiteralValue::Error(ExcelError::new(ExcelErrorKind::Na)),
+                        }));
+                    }
+
                     // Fallback for approximate match modes (handled via materialization for now)
                     let mut values: Vec<LiteralValue> = Vec::new();
                     if let Err(e) = rv.for_each_cell(&mut |v| {
@@ -528,6 +550,10 @@ impl Function for VLookupFn {
                         wildcard_mode,
                     )?
                 }
+            } else if let Some(n) = approximate_needle(&lookup_value)
+                && let Some(found) = approximate_number_in_ascending_view(&first_col_view, n)?
+            {
+                found
             } else {
                 // Fallback for approximate mode (requires materializing first column for now)
                 let mut first_col: Vec<LiteralValue> = Vec::new();
@@ -781,6 +807,7 @@ impl Function for HLookupFn {
                 let mut first_row: Vec<LiteralValue> = Vec::with_capacity(cols);
                 first_row_view.for_each_row(&mut |row| {
                     if first_row.is_empty() {
+                        // owned-range: one header row for the binary search.
                         first_row.extend_from_slice(row);
                     }
                     Ok(())
@@ -16,6 +16,7 @@
 
 use super::lookup_utils::cmp_for_lookup;
 use crate::args::{ArgSchema, CoercionPolicy, ShapeKind};
+use crate::engine::range_view::RangeView;
 use crate::function::Function;
 use crate::traits::{ArgumentHandle, CalcValue, FunctionContext};
 use formualizer_common::{ArgKind, ExcelError, ExcelErrorKind, LiteralValue};
@@ -188,24 +189,27 @@ impl Function for LookupFn {
 
         let has_result_vector = args.len() >= 3;
 
-        // --- Materialise lookup vector / array ---
-        let lookup_data = materialise_range(&args[1], ctx)?;
-        let (l_rows, l_cols) = dims(&lookup_data);
+        // --- Read lookup vector / array through a view ---
+        let lookup_view = range_or_scalar_view(&args[1], ctx)?;
+        let (l_rows, l_cols) = lookup_view.dims();
 
-        // Determine search orientation and build the search slice.
+        // Determine search orientation and copy out only the searched axis.
         let (search_vec, is_row_search) = if has_result_vector {
-            // Vector form: lookup_data must be 1-D
-            flatten_1d(&lookup_data, l_rows, l_cols)
+            // Vector form: lookup_view must be 1-D
+            (flatten_1d(&lookup_view), l_rows == 1)
         } else if l_rows == 1 && l_cols == 1 {
             // Single cell – trivially a column search
-            (vec![lookup_data[0][0].clone()], false)
+            (vec![lookup_view.get_cell(0, 0)], false)
         } else if l_cols > l_rows {
             // Array form: wider than tall → search first row
-            (lookup_data[0].clone(), true)
+            (
+                (0..l_cols).map(|c| lookup_view.get_cell(0, c)).collect(),
+                true,
+            )
         } else {
             // Array form: tall or square → search first column
             (
-                lookup_data.iter().map(|r| r[0].clone()).collect::<Vec<_>>(),
+                (0..l_rows).map(|r| lookup_view.get_cell(r, 0)).collect(),
                 false,
             )
         };
@@ -223,36 +227,25 @@ impl Function for LookupFn {
 
         // --- Retrieve result ---
         if has_result_vector {
-            let result_data = materialise_range(&args[2], ctx)?;
-            let (r_rows, r_cols) = dims(&result_data);
-            let result_vec = flatten_1d_vec(&result_data, r_rows, r_cols);
-            let val = result_vec
-                .get(match_idx)
-                .cloned()
-                .unwrap_or(LiteralValue::Empty);
-            Ok(CalcValue::Scalar(materialise_empty(val)))
+            let result_view = range_or_scalar_view(&args[2], ctx)?;
+            Ok(CalcValue::Scalar(materialise_empty(flat_cell(
+                &result_view,
+                match_idx,
+            ))))
         } else if l_rows == 1 && l_cols == 1 {
             Ok(CalcValue::Scalar(materialise_empty(
-                lookup_data[0][0].clone(),
+                lookup_view.get_cell(0, 0),
             )))
         } else if is_row_search {
             // Return from last row at matched column
-            let last_row = l_rows - 1;
-            let val = lookup_data
-                .get(last_row)
-                .and_then(|r| r.get(match_idx))
-                .cloned()
-                .unwrap_or(LiteralValue::Empty);
-            Ok(CalcValue::Scalar(materialise_empty(val)))
+            Ok(CalcValue::Scalar(materialise_empty(
+                lookup_view.get_cell(l_rows - 1, match_idx),
+            )))
         } else {
             // Return from last column at matched row
-            let last_col = l_cols - 1;
-            let val = lookup_data
-                .get(match_idx)
-                .and_then(|r| r.get(last_col))
-                .cloned()
-                .unwrap_or(LiteralValue::Empty);
-            Ok(CalcValue::Scalar(materialise_empty(val)))
+            Ok(CalcValue::Scalar(materialise_empty(
+                lookup_view.get_cell(match_idx, l_cols - 1),
+            )))
         }
     }
 }
@@ -261,57 +254,42 @@ impl Function for LookupFn {
 // Helpers
 // ---------------------------------------------------------------------------
 
-/// Materialise a range argument into a 2-D Vec grid.
-fn materialise_range<'a, 'b>(
-    arg: &ArgumentHandle<'a, 'b>,
+/// View a range argument, or a scalar argument as a 1x1 range.
+fn range_or_scalar_view<'b>(
+    arg: &ArgumentHandle<'_, 'b>,
     ctx: &dyn FunctionContext<'b>,
-) -> Result<Vec<Vec<LiteralValue>>, ExcelError> {
-    if let Ok(r) = arg.as_reference_or_eval() {
-        let current_sheet = ctx.current_sheet();
-        let rv = ctx.resolve_range_view(&r, current_sheet)?;
-        let (rows, cols) = rv.dims();
-        let mut data = Vec::with_capacity(rows);
-        rv.for_each_row(&mut |row| {
-            let mut owned = Vec::with_capacity(cols);
-            owned.extend_from_slice(row);
-            data.push(owned);
-            Ok(())
-        })?;
-        Ok(data)
-    } else {
-        let v = arg.value()?.into_literal();
-        match v {
-            LiteralValue::Array(rows) => Ok(rows),
-            other => Ok(vec![vec![other]]),
-        }
+) -> Result<RangeView<'b>, ExcelError> {
+    if let Ok(view) = arg.range_view() {
+        return Ok(view);
     }
+    let v = arg.value()?.into_literal();
+    Ok(RangeView::from_owned_rows(vec![vec![v]], ctx.date_system()))
 }
 
-fn dims(data: &[Vec<LiteralValue>]) -> (usize, usize) {
-    let rows = data.len();
-    let cols = data.first().map(|r| r.len()).unwrap_or(0);
-    (rows, cols)
+/// Flatten a 1-D view into a vector.  If only one row → use it; if only one
+/// column → use it; otherwise flatten row-major.
+fn flatten_1d(view: &RangeView<'_>) -> Vec<LiteralValue> {
+    let (rows, cols) = view.dims();
+    (0..rows * cols).map(|i| flat_cell(view, i)).collect()
 }
 
-/// Flatten a 2-D grid into a 1-D vector.  If only one row → use it; if only
-/// one column → extract first element of each row; otherwise flatten row-major.
-fn flatten_1d(data: &[Vec<LiteralValue>], rows: usize, cols: usize) -> (Vec<LiteralValue>, bool) {
+/// Element `index` of a view flattened as in [`flatten_1d`]; `Empty` past
+/// the end.
+fn flat_cell(view: &RangeView<'_>, index: usize) -> LiteralValue {
+    let (rows, cols) = view.dims();
     if rows == 1 {
-        (data[0].clone(), true)
+        view.get_cell(0, index)
     } else if cols == 1 {
-        (data.iter().map(|r| r[0].clone()).collect(), false)
+        view.get_cell(index, 0)
+    } else if cols == 0 {
+        LiteralValue::Empty
     } else {
-        // Multi-dimensional – flatten row-major (uncommon for LOOKUP but
-        // required for robustness).
-        (data.iter().flat_map(|r| r.iter().cloned()).collect(), false)
+        // Multi-dimensional – row-major (uncommon for LOOKUP but required
+        // for robustness).
+        view.get_cell(index / cols, index % cols)
     }
 }
 
-/// Like `flatten_1d` but returns just the vec (for result vector).
-fn flatten_1d_vec(data: &[Vec<LiteralValue>], rows: usize, cols: usize) -> Vec<LiteralValue> {
-    flatten_1d(data, rows, cols).0
-}
-
 /// Excel materialises empty lookup results as 0.
 fn materialise_empty(v: LiteralValue) -> LiteralValue {
     match v {
@@ -357,16 +357,52 @@ pub fn find_exact_index_in_view(
     }
 }
 
+/// Approximate ascending match (largest value `<= n`) in a single-column view, answered
+/// from zone maps when the column is provably plain numbers in ascending order: the
+/// target chunk is located from chunk minimums and only that chunk is binary-searched.
+///
+/// Returns `Ok(None)` when the statistics cannot prove the order; callers then take the
+/// materializing path, which also reports unsorted data.
+pub fn approximate_number_in_ascending_view(
+    view: &RangeView<'_>,
+    n: f64,
+) -> Result<Option<Option<usize>>, ExcelError> {
+    let (rows, cols) = view.dims();
+    if cols != 1 || rows == 0 || !view.zone_map(0, rows, 0).numbers_ascending {
+        return Ok(None);
+    }
+    // `cmp_for_lookup` treats values within 1e-12 of the needle as equal.
+    let at_most_needle = |v: f64| v - n < 1e-12;
+    let mut target = None;
+    for (row_start, row_len) in view.row_chunk_bounds()? {
+        if !at_most_needle(view.zone_map(row_start, row_len, 0).num_min) {
+            break;
+        }
+        target = Some((row_start, row_len));
+    }
+    let Some((row_start, row_len)) = target else {
+        return Ok(Some(None));
+    };
+    let Some(Some(numbers)) = view.slice_numbers(row_start, row_len).into_iter().next() else {
+        return Ok(None);
+    };
+    let below = numbers.values().partition_point(|&v| at_most_needle(v));
+    Ok(Some(below.checked_sub(1).map(|i| row_start + i)))
+}
+
 fn find_exact_number_in_view(
     view: &RangeView<'_>,
     n: f64,
     vertical: bool,
 ) -> Result<Option<usize>, ExcelError> {
     if vertical {
-        for res in view.numbers_slices() {
-            let (row_start, _row_len, cols) = res?;
-            if !cols.is_empty() {
-                let arr = &cols[0];
+        for (row_start, row_len) in view.row_chunk_bounds()? {
+            // Skip chunks whose numeric range cannot hold the needle.
+            let zone = view.zone_map(row_start, row_len, 0);
+            if !(zone.has_numbers() && n > zone.num_min - 1e-12 && n < zone.num_max + 1e-12) {
+                continue;
+            }
+            if let Some(Some(arr)) = view.slice_numbers(row_start, row_len).into_iter().next() {
                 for i in 0..arr.len() {
                     if !arr.is_null(i) && (arr.value(i) - n).abs() < 1e-12 {
                         return Ok(Some(row_start + i));
@@ -407,10 +443,19 @@ fn find_exact_text_in_view(
         .then(|| CompiledWildcardPattern::from_folded(&needle_folded));
 
     if vertical {
-        for res in view.lowered_text_slices() {
-            let (row_start, _row_len, cols) = res?;
-            if !cols.is_empty() {
-                let arr = &cols[0];
+        for (row_start, row_len) in view.row_chunk_bounds()? {
+            // Skip chunks without text, or whose bloom bits rule out an exact needle.
+            let zone = view.zone_map(row_start, row_len, 0);
+            if !zone.has_text
+                || (compiled_wildcard.is_none() && !zone.may_contain_text(&needle_folded))
+            {
+                continue;
+            }
+            if let Some(Some(arr)) = view
+                .slice_lowered_text(row_start, row_len)
+                .into_iter()
+                .next()
+            {
                 for i in 0..arr.len() {
                     if !arr.is_null(i) {
                         let val = arr.value(i);
@@ -482,12 +527,10 @@ fn find_exact_empty_in_view(
     if vertical {
         for res in view.type_tags_slices() {
             let (row_start, _row_len, cols) = res?;
-            if !cols.is_empty() {
-                let arr = &cols[0];
-                for i in 0..arr.len() {
-                    if !arr.is_null(i) && arr.value(i) == crate::arrow_store::TypeTag::Empty as u8 {
-                        return Ok(Some(row_start + i));
-                    }
+            if let Some(arr) = cols.first() {
+                let empty = crate::arrow_store::tag_mask(arr, crate::arrow_store::TypeTag::Empty);
+                if let Some(i) = empty.set_indices().next() {
+                    return Ok(Some(row_start + i));
                 }
             }
         }
@@ -22,29 +22,6 @@ pub struct HStackFn;
 #[derive(Debug)]
 pub struct VStackFn;
 
-fn materialize_arg<'b>(
-    arg: &ArgumentHandle<'_, 'b>,
-    ctx: &dyn FunctionContext<'b>,
-) -> Result<Vec<Vec<LiteralValue>>, ExcelError> {
-    // Similar helper to dynamic.rs (avoid cyclic import). Minimal duplication; consider refactor later.
-    if let Ok(r) = arg.as_reference_or_eval() {
-        let mut rows: Vec<Vec<LiteralValue>> = Vec::new();
-        let sheet = ctx.current_sheet();
-        let rv = ctx.resolve_range_view(&r, sheet)?;
-        rv.for_each_row(&mut |row| {
-            rows.push(row.to_vec());
-            Ok(())
-        })?;
-        Ok(rows)
-    } else {
-        let cv = arg.value()?;
-        match cv.into_literal() {
-            LiteralValue::Array(a) => Ok(a),
-            v => Ok(vec![vec![v]]),
-        }
-    }
-}
-
 /// Concatenates arrays horizontally into a single spilled array.
 ///
 /// `HSTACK` appends columns from each argument left-to-right.
@@ -343,6 +320,7 @@ impl Function for VStackFn {
             match entry {
                 VStackEntry::View(v) => {
                     let _ = v.for_each_row(&mut |row| {
+                        // owned-range: rows are copied into the stacked result.
                         result.push(row.to_vec());
                         Ok(())
                     });
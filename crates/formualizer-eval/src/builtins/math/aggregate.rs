@@ -92,30 +92,17 @@ impl Function for SumFn {
         for arg in args {
             match resolve_aggregate_argument(arg, ctx)? {
                 AggregateArgument::Range(view) => {
+                    let segments = view.numeric_segments().collect::<Result<Vec<_>, _>>()?;
+                    let cols = || segments.iter().flat_map(|(_, _, cols)| cols);
                     // Propagate errors from range first
-                    for res in view.errors_slices() {
-                        let (_, _, err_cols) = res?;
-                        for col in err_cols {
-                            if col.null_count() < col.len() {
-                                for i in 0..col.len() {
-                                    if !col.is_null(i) {
-                                        return Ok(crate::traits::CalcValue::Scalar(
-                                            LiteralValue::Error(ExcelError::new(
-                                                crate::arrow_store::unmap_error_code(col.value(i)),
-                                            )),
-                                        ));
-                                    }
-                                }
-                            }
-                        }
+                    if let Some(code) = cols().find_map(|col| col.first_error()) {
+                        return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(
+                            ExcelError::new(crate::arrow_store::unmap_error_code(code)),
+                        )));
                     }
 
-                    for res in view.numbers_slices() {
-                        let (_, _, num_cols) = res?;
-                        for col in num_cols {
-                            total += arrow::compute::kernels::aggregate::sum(col.as_ref())
-                                .unwrap_or(0.0);
-                        }
+                    for col in cols() {
+                        total += col.sum();
                     }
                 }
                 AggregateArgument::ReferenceError(e) => {
@@ -218,10 +205,10 @@ impl Function for CountFn {
         for arg in args {
             match resolve_aggregate_argument(arg, ctx)? {
                 AggregateArgument::Range(view) => {
-                    for res in view.numbers_slices() {
+                    for res in view.numeric_segments() {
                         let (_, _, num_cols) = res?;
                         for col in num_cols {
-                            count += (col.len() - col.null_count()) as i64;
+                            count += col.count() as i64;
                         }
                     }
                 }
@@ -335,31 +322,18 @@ impl Function for AverageFn {
         for arg in args {
             match resolve_aggregate_argument(arg, ctx)? {
                 AggregateArgument::Range(view) => {
+                    let segments = view.numeric_segments().collect::<Result<Vec<_>, _>>()?;
+                    let cols = || segments.iter().flat_map(|(_, _, cols)| cols);
                     // Propagate errors from range first
-                    for res in view.errors_slices() {
-                        let (_, _, err_cols) = res?;
-                        for col in err_cols {
-                            if col.null_count() < col.len() {
-                                for i in 0..col.len() {
-                                    if !col.is_null(i) {
-                                        return Ok(crate::traits::CalcValue::Scalar(
-                                            LiteralValue::Error(ExcelError::new(
-                                                crate::arrow_store::unmap_error_code(col.value(i)),
-                                            )),
-                                        ));
-                                    }
-                                }
-                            }
-                        }
+                    if let Some(code) = cols().find_map(|col| col.first_error()) {
+                        return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(
+                            ExcelError::new(crate::arrow_store::unmap_error_code(code)),
+                        )));
                     }
 
-                    for res in view.numbers_slices() {
-                        let (_, _, num_cols) = res?;
-                        for col in num_cols {
-                            sum += arrow::compute::kernels::aggregate::sum(col.as_ref())
-                                .unwrap_or(0.0);
-                            cnt += (col.len() - col.null_count()) as i64;
-                        }
+                    for col in cols() {
+                        sum += col.sum();
+                        cnt += col.count() as i64;
                     }
                 }
                 AggregateArgument::ReferenceError(e) => {
@@ -482,32 +456,37 @@ impl Function for SumProductFn {
             return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Number(0.0)));
         }
 
-        // Helper: materialize an argument to a 2D array of LiteralValue
-        let to_array = |ah: &ArgumentHandle<'_, 'b>| -> Result<Vec<Vec<LiteralValue>>, ExcelError> {
+        // Ranges are read in place through their view; array and scalar
+        // values are already owned.
+        enum Operand<'v> {
+            View(crate::engine::range_view::RangeView<'v>),
+            Rows(Vec<Vec<LiteralValue>>),
+        }
+        let to_operand = |ah: &ArgumentHandle<'_, 'b>| -> Result<Operand<'b>, ExcelError> {
             match resolve_aggregate_argument(ah, ctx)? {
-                AggregateArgument::Range(rv) => {
-                    let mut rows: Vec<Vec<LiteralValue>> = Vec::new();
-                    rv.for_each_row(&mut |row| {
-                        rows.push(row.to_vec());
-                        Ok(())
-                    })?;
-                    Ok(rows)
-                }
+                AggregateArgument::Range(rv) => Ok(Operand::View(rv)),
                 AggregateArgument::ReferenceError(error) => Err(error),
-                AggregateArgument::Scalar(v) => Ok(match v {
+                AggregateArgument::Scalar(v) => Ok(Operand::Rows(match v {
                     LiteralValue::Array(arr) => arr,
                     other => vec![vec![other]],
-                }),
+                })),
             }
         };
 
-        // Collect arrays and shapes
-        let mut arrays: Vec<Vec<Vec<LiteralValue>>> = Vec::with_capacity(args.len());
+        // Collect operands and shapes
+        let mut arrays: Vec<Operand<'b>> = Vec::with_capacity(args.len());
         let mut shapes: Vec<(usize, usize)> = Vec::with_capacity(args.len());
         for a in args.iter() {
-            let arr = to_array(a)?;
-            let shape = (arr.len(), arr.first().map(|r| r.len()).unwrap_or(0));
-            arrays.push(arr);
+            let operand = to_operand(a)?;
+            let shape = match &operand {
+                // An empty view has no first row to take a width from.
+                Operand::View(rv) => match rv.dims() {
+                    (0, _) => (0, 0),
+                    dims => dims,
+                },
+                Operand::Rows(arr) => (arr.len(), arr.first().map(|r| r.len()).unwrap_or(0)),
+            };
+            arrays.push(operand);
             shapes.push(shape);
         }
 
@@ -528,11 +507,14 @@ impl Function for SumProductFn {
                 let mut prod = 1.0f64;
                 for (arr, &shape) in arrays.iter().zip(shapes.iter()) {
                     let (rr, cc) = project_index((r, c), shape);
-                    let lv = arr
-                        .get(rr)
-                        .and_then(|row| row.get(cc))
-                        .cloned()
-                        .unwrap_or(LiteralValue::Empty);
+                    let lv = match arr {
+                        Operand::View(rv) => rv.get_cell(rr, cc),
+                        Operand::Rows(rows) => rows
+                            .get(rr)
+                            .and_then(|row| row.get(cc))
+                            .cloned()
+                            .unwrap_or(LiteralValue::Empty),
+                    };
                     match lv {
                         LiteralValue::Error(e) => {
                             return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(e)));
@@ -1,4 +1,4 @@
-use super::super::utils::{ARG_ANY_ONE, coerce_num, criteria_match};
+use super::super::utils::{ARG_ANY_ONE, coerce_num, criteria_match, criteria_may_match};
 use super::{AggregateArgument, resolve_aggregate_argument};
 use crate::args::ArgSchema;
 use crate::compute_prelude::{boolean, cmp, filter_array};
@@ -85,6 +85,16 @@ fn range_or_scalar<'a, 'b>(
     })
 }
 
+/// Text criteria that match exactly the case-insensitively equal text cells. Those can be
+/// answered from dictionary codes; empty or numeric-looking text also matches blanks or
+/// numbers and takes the per-cell path.
+fn is_dictionary_text_criterion(t: &str) -> bool {
+    !t.is_empty()
+        && crate::locale::Locale::invariant()
+            .parse_number_invariant(t)
+            .is_none()
+}
+
 fn eval_if_family<'a, 'b>(
     args: &[ArgumentHandle<'a, 'b>],
     ctx: &dyn FunctionContext<'b>,
@@ -234,16 +244,30 @@ fn eval_if_family<'a, 'b>(
                 continue;
             }
 
+            // Zone maps rule out columns whose criteria cannot match anywhere in this segment.
+            let pruned: Vec<bool> = (0..dims.1)
+                .map(|c| {
+                    crit_specs.iter().any(|(rv, pred, _)| {
+                        rv.as_ref().is_some_and(|v| {
+                            !criteria_may_match(pred, &v.zone_map(row_start, row_len, c))
+                        })
+                    })
+                })
+                .collect();
+            if pruned.iter().all(|&p| p) {
+                continue;
+            }
+
             // Get slices for all criteria and sum range
             let mut crit_num_slices = Vec::with_capacity(crit_specs.len());
-            let mut crit_text_slices = Vec::with_capacity(crit_specs.len());
+            let mut crit_text_codes = Vec::with_capacity(crit_specs.len());
             for (rv, _, _) in &crit_specs {
                 if let Some(v) = rv {
                     crit_num_slices.push(Some(v.slice_numbers(row_start, row_len)));
-                    crit_text_slices.push(Some(v.slice_lowered_text(row_start, row_len)));
+                    crit_text_codes.push(Some(v.slice_text_codes(row_start, row_len)));
                 } else {
                     crit_num_slices.push(None);
-                    crit_text_slices.push(None);
+                    crit_text_codes.push(None);
                 }
             }
 
@@ -252,6 +276,9 @@ fn eval_if_family<'a, 'b>(
                 .map(|v| v.slice_numbers(row_start, row_len));
 
             for c in 0..dims.1 {
+                if pruned[c] {
+                    continue;
+                }
                 let mut mask_opt: Option<BooleanArray> = None;
                 let mut impossible = false;
 
@@ -328,7 +355,7 @@ fn eval_if_family<'a, 'b>(
                     let num_col = crit_num_slices[j]
                         .as_ref()
                         .and_then(|cols| cols.get(c).and_then(|a| a.as_ref()));
-                    let text_col = crit_text_slices[j]
+                    let text_col = crit_text_codes[j]
                         .as_ref()
                         .and_then(|cols| cols.get(c).and_then(|a| a.as_ref()));
 
@@ -434,6 +461,12 @@ fn eval_if_family<'a, 'b>(
                                         bb.finish()
                                     }
                                 }
+                                LiteralValue::Text(t)
+                                    if tc.is_some() && is_dictionary_text_criterion(t) =>
+                                {
+                                    // Dictionary-encoded text: one integer compare per row.
+                                    tc.unwrap().eq_lowered(&t.to_lowercase())
+                                }
                                 _ => {
                                     // Use fallback for text and other types to ensure Excel parity (e.g. blank matching)
                                     let mut bb =
@@ -532,6 +565,11 @@ fn eval_if_family<'a, 'b>(
                                     bb.finish()
                                 }
                             }
+                            LiteralValue::Text(t)
+                                if tc.is_some() && is_dictionary_text_criterion(t) =>
+                            {
+                                boolean::not(&tc.unwrap().eq_lowered(&t.to_lowercase())).unwrap()
+                            }
                             _ => {
                                 let mut bb =
                                     arrow_array::builder::BooleanBuilder::with_capacity(row_len);
@@ -1390,11 +1428,16 @@ impl Function for CountAFn {
                     for res in view.type_tags_slices() {
                         let (_, _, tag_cols) = res?;
                         for col in tag_cols {
-                            for i in 0..col.len() {
-                                if col.value(i) != crate::arrow_store::TypeTag::Empty as u8 {
-                                    cnt += 1;
-                                }
-                            }
+                            let empty = match crate::arrow_store::uniform_type_tag(&col) {
+                                Some(crate::arrow_store::TypeTag::Empty) => col.len(),
+                                Some(_) => 0,
+                                None => crate::arrow_store::tag_mask(
+                                    &col,
+                                    crate::arrow_store::TypeTag::Empty,
+                                )
+                                .count_set_bits(),
+                            };
+                            cnt += (col.len() - empty) as i64;
                         }
                     }
                 }
@@ -1502,6 +1545,14 @@ impl Function for CountBlankFn {
                         let (_, _, text_cols) = text_res?;
 
                         for (tc, xc) in tag_cols.into_iter().zip(text_cols.into_iter()) {
+                            match crate::arrow_store::uniform_type_tag(&tc) {
+                                Some(crate::arrow_store::TypeTag::Empty) => {
+                                    cnt += tc.len() as i64;
+                                    continue;
+                                }
+                                Some(crate::arrow_store::TypeTag::Text) | None => {}
+                                Some(_) => continue,
+                            }
                             let text_arr = xc
                                 .as_any()
                                 .downcast_ref::<arrow_array::StringArray>()
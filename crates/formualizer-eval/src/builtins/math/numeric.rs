@@ -8,6 +8,7 @@ use crate::function_contract::FunctionDependencyContract;
 use crate::traits::{ArgumentHandle, FunctionContext};
 use formualizer_common::{ExcelError, LiteralValue};
 use formualizer_macros::func_caps;
+use std::ops::ControlFlow;
 
 #[derive(Debug)]
 pub struct AbsFn;
@@ -1905,19 +1906,30 @@ impl Function for MultinomialFn {
     ) -> Result<crate::traits::CalcValue<'b>, ExcelError> {
         let mut values: Vec<i64> = Vec::new();
         for arg in args {
-            for value in arg.lazy_values_owned()? {
+            let mut failure: Option<Result<LiteralValue, ExcelError>> = None;
+            arg.for_each_value(&mut |value| {
                 let n = match value {
                     LiteralValue::Error(e) => {
-                        return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(e)));
+                        failure = Some(Ok(LiteralValue::Error(e.clone())));
+                        return ControlFlow::Break(());
                     }
-                    other => coerce_num(&other)?.trunc() as i64,
+                    other => match coerce_num(other) {
+                        Ok(n) => n.trunc() as i64,
+                        Err(e) => {
+                            failure = Some(Err(e));
+                            return ControlFlow::Break(());
+                        }
+                    },
                 };
                 if n < 0 {
-                    return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(
-                        ExcelError::new_num(),
-                    )));
+                    failure = Some(Ok(LiteralValue::Error(ExcelError::new_num())));
+                    return ControlFlow::Break(());
                 }
                 values.push(n);
+                ControlFlow::Continue(())
+            })?;
+            if let Some(failure) = failure {
+                return failure.map(crate::traits::CalcValue::Scalar);
             }
         }
 
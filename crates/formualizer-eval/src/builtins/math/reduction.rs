@@ -4,7 +4,6 @@ use crate::args::ArgSchema;
 use crate::function::Function;
 use crate::function_contract::FunctionDependencyContract;
 use crate::traits::{ArgumentHandle, FunctionContext};
-use arrow_array::Array;
 use formualizer_common::{ExcelError, LiteralValue};
 use formualizer_macros::func_caps;
 
@@ -93,30 +92,18 @@ impl Function for MinFn {
         for a in args {
             match resolve_aggregate_argument(a, ctx)? {
                 AggregateArgument::Range(view) => {
+                    let segments = view.numeric_segments().collect::<Result<Vec<_>, _>>()?;
+                    let cols = || segments.iter().flat_map(|(_, _, cols)| cols);
                     // Propagate errors from range first
-                    for res in view.errors_slices() {
-                        let (_, _, err_cols) = res?;
-                        for col in err_cols {
-                            if col.null_count() < col.len() {
-                                for i in 0..col.len() {
-                                    if !col.is_null(i) {
-                                        return Ok(crate::traits::CalcValue::Scalar(
-                                            LiteralValue::Error(ExcelError::new(
-                                                crate::arrow_store::unmap_error_code(col.value(i)),
-                                            )),
-                                        ));
-                                    }
-                                }
-                            }
-                        }
+                    if let Some(code) = cols().find_map(|col| col.first_error()) {
+                        return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(
+                            ExcelError::new(crate::arrow_store::unmap_error_code(code)),
+                        )));
                     }
 
-                    for res in view.numbers_slices() {
-                        let (_, _, num_cols) = res?;
-                        for col in num_cols {
-                            if let Some(n) = arrow::compute::kernels::aggregate::min(col.as_ref()) {
-                                mv = Some(mv.map(|m| m.min(n)).unwrap_or(n));
-                            }
+                    for col in cols() {
+                        if let Some(n) = col.min() {
+                            mv = Some(mv.map(|m| m.min(n)).unwrap_or(n));
                         }
                     }
                 }
@@ -226,30 +213,18 @@ impl Function for MaxFn {
         for a in args {
             match resolve_aggregate_argument(a, ctx)? {
                 AggregateArgument::Range(view) => {
+                    let segments = view.numeric_segments().collect::<Result<Vec<_>, _>>()?;
+                    let cols = || segments.iter().flat_map(|(_, _, cols)| cols);
                     // Propagate errors from range first
-                    for res in view.errors_slices() {
-                        let (_, _, err_cols) = res?;
-                        for col in err_cols {
-                            if col.null_count() < col.len() {
-                                for i in 0..col.len() {
-                                    if !col.is_null(i) {
-                                        return Ok(crate::traits::CalcValue::Scalar(
-                                            LiteralValue::Error(ExcelError::new(
-                                                crate::arrow_store::unmap_error_code(col.value(i)),
-                                            )),
-                                        ));
-                                    }
-                                }
-                            }
-                        }
+                    if let Some(code) = cols().find_map(|col| col.first_error()) {
+                        return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(
+                            ExcelError::new(crate::arrow_store::unmap_error_code(code)),
+                        )));
                     }
 
-                    for res in view.numbers_slices() {
-                        let (_, _, num_cols) = res?;
-                        for col in num_cols {
-                            if let Some(n) = arrow::compute::kernels::aggregate::max(col.as_ref()) {
-                                mv = Some(mv.map(|m| m.max(n)).unwrap_or(n));
-                            }
+                    for col in cols() {
+                        if let Some(n) = col.max() {
+                            mv = Some(mv.map(|m| m.max(n)).unwrap_or(n));
                         }
                     }
                 }
@@ -21,11 +21,15 @@
 
 use super::super::builtins::utils::{ARG_RANGE_NUM_LENIENT_ONE, coerce_num};
 use crate::args::ArgSchema;
+use crate::arrow_store::{self, Moments};
+use crate::engine::range_view::RangeView;
 use crate::function::Function;
 use crate::function_contract::FunctionDependencyContract;
+use crate::scratch;
 use crate::traits::{ArgumentHandle, FunctionContext};
 use formualizer_common::{ExcelError, LiteralValue};
 // use std::collections::BTreeMap; // removed unused import
+use bumpalo::{Bump, collections::Vec as BumpVec};
 use formualizer_macros::func_caps;
 
 fn scalar_like_value(arg: &ArgumentHandle<'_, '_>) -> Result<LiteralValue, ExcelError> {
@@ -44,53 +48,144 @@ fn scalar_like_value(arg: &ArgumentHandle<'_, '_>) -> Result<LiteralValue, Excel
 /// - Direct scalar arguments: attempt numeric coercion (so TRUE/FALSE, numeric text are included if
 ///   coerce_num succeeds). Non-numeric text is ignored (Excel would treat a direct non-numeric text
 ///   argument as #VALUE! in some contexts; covered by TODO for finer parity).
-fn collect_numeric_stats(args: &[ArgumentHandle]) -> Result<Vec<f64>, ExcelError> {
-    let mut out = Vec::new();
+fn for_each_numeric_stat(
+    args: &[ArgumentHandle],
+    out: &mut impl FnMut(f64),
+) -> Result<(), ExcelError> {
     for a in args {
-        // Special-case: inline array literal argument should be treated like a list of direct scalar
-        // arguments (not a by-ref range). This allows boolean/text coercion per element akin to
-        // passing multiple scalars to the function.
-        if let Some(arr) = a.inline_array_literal()? {
-            for row in arr.into_iter() {
-                for cell in row.into_iter() {
-                    match cell {
-                        LiteralValue::Error(e) => return Err(e),
-                        other => {
-                            if let Ok(n) = coerce_num(&other) {
-                                out.push(n);
-                            }
+        if let Some(view) = numeric_stat_arg(a, out)? {
+            for_each_range_stat(&view, out)?;
+        }
+    }
+    Ok(())
+}
+
+/// One argument of [`for_each_numeric_stat`]: scalars and array literals are visited, a
+/// range reference is handed back for the caller to reduce.
+fn numeric_stat_arg<'b>(
+    a: &ArgumentHandle<'_, 'b>,
+    out: &mut impl FnMut(f64),
+) -> Result<Option<RangeView<'b>>, ExcelError> {
+    // Special-case: inline array literal argument should be treated like a list of direct scalar
+    // arguments (not a by-ref range). This allows boolean/text coercion per element akin to
+    // passing multiple scalars to the function.
+    if let Some(arr) = a.inline_array_literal()? {
+        for row in arr.into_iter() {
+            for cell in row.into_iter() {
+                match cell {
+                    LiteralValue::Error(e) => return Err(e),
+                    other => {
+                        if let Ok(n) = coerce_num(&other) {
+                            out(n);
                         }
                     }
                 }
             }
+        }
+        return Ok(None);
+    }
+
+    if let Ok(view) = a.range_view() {
+        return Ok(Some(view));
+    }
+    let v = scalar_like_value(a)?;
+    match v {
+        LiteralValue::Error(e) => return Err(e),
+        other => {
+            if let Ok(n) = coerce_num(&other) {
+                out(n);
+            }
+        }
+    }
+    Ok(None)
+}
+
+/// Numeric cells of a range reference, in row-major order.
+fn for_each_range_stat(view: &RangeView<'_>, out: &mut impl FnMut(f64)) -> Result<(), ExcelError> {
+    view.for_each_cell(&mut |v| {
+        match v {
+            LiteralValue::Error(e) => return Err(e.clone()),
+            LiteralValue::Number(n) => out(*n),
+            LiteralValue::Int(i) => out(*i as f64),
+            _ => {}
+        }
+        Ok(())
+    })
+}
+
+/// [`for_each_numeric_stat`] folded into [`Moments`]. Range references run the moments
+/// kernel over their numeric lanes, except ranges holding dates or durations (the lanes
+/// carry them as numbers, but statistics skip them) or errors (reported in row-major
+/// order), which visit their cells.
+fn numeric_stat_moments(args: &[ArgumentHandle]) -> Result<Moments, ExcelError> {
+    let mut total = Moments::default();
+    for a in args {
+        let Some(view) = numeric_stat_arg(a, &mut |n| total.push(n))? else {
             continue;
+        };
+        match range_moments(&view)? {
+            Some(moments) => total.merge(moments),
+            None => for_each_range_stat(&view, &mut |n| total.push(n))?,
         }
+    }
+    Ok(total)
+}
 
-        if let Ok(view) = a.range_view() {
-            view.for_each_cell(&mut |v| {
-                match v {
-                    LiteralValue::Error(e) => return Err(e.clone()),
-                    LiteralValue::Number(n) => out.push(*n),
-                    LiteralValue::Int(i) => out.push(*i as f64),
-                    _ => {}
-                }
-                Ok(())
-            })?;
-        } else {
-            let v = scalar_like_value(a)?;
-            match v {
-                LiteralValue::Error(e) => return Err(e),
-                other => {
-                    if let Ok(n) = coerce_num(&other) {
-                        out.push(n);
-                    }
-                }
+/// Moments of a range from its numeric lanes; `None` when it holds a date, duration or
+/// error.
+fn range_moments(view: &RangeView<'_>) -> Result<Option<Moments>, ExcelError> {
+    let temporal = |tag: u8| {
+        tag == arrow_store::TypeTag::DateTime as u8 || tag == arrow_store::TypeTag::Duration as u8
+    };
+    for res in view.type_tags_slices() {
+        let (_, _, cols) = res?;
+        for tags in &cols {
+            let has_temporal = match arrow_store::uniform_type_tag(tags) {
+                Some(tag) => temporal(tag as u8),
+                None => tags.values().iter().any(|&tag| temporal(tag)),
+            };
+            if has_temporal {
+                return Ok(None);
+            }
+        }
+    }
+    let mut total = Moments::default();
+    for res in view.numeric_segments() {
+        let (_, _, cols) = res?;
+        for col in &cols {
+            if col.first_error().is_some() {
+                return Ok(None);
             }
+            total.merge(col.moments());
         }
     }
+    Ok(Some(total))
+}
+
+fn collect_numeric_stats(args: &[ArgumentHandle]) -> Result<Vec<f64>, ExcelError> {
+    let mut out = Vec::new();
+    for_each_numeric_stat(args, &mut |n| out.push(n))?;
     Ok(out)
 }
 
+/// [`collect_numeric_stats`] into the evaluation scratch arena, for order
+/// statistics that only reorder the buffer before reducing it to a scalar.
+fn collect_numeric_stats_in<'s>(
+    args: &[ArgumentHandle],
+    bump: &'s Bump,
+) -> Result<BumpVec<'s, f64>, ExcelError> {
+    let mut out = BumpVec::new_in(bump);
+    for_each_numeric_stat(args, &mut |n| out.push(n))?;
+    Ok(out)
+}
+
+/// Run a builtin body with the evaluation scratch arena.
+fn with_stats_scratch<'b>(
+    f: impl FnOnce(&Bump) -> Result<crate::traits::CalcValue<'b>, ExcelError>,
+) -> Result<crate::traits::CalcValue<'b>, ExcelError> {
+    scratch::with_scratch(f)
+}
+
 /* ─────────────── order-statistic selection (quickselect) ───────────────
  *
  * LARGE/SMALL/MEDIAN and the PERCENTILE/QUARTILE family need at most two
@@ -506,16 +601,18 @@ impl Function for LARGE {
                 ExcelError::new_num(),
             )));
         }
-        let mut nums = collect_numeric_stats(&args[..args.len() - 1])?;
-        if nums.is_empty() || k as usize > nums.len() {
-            return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(
-                ExcelError::new_num(),
-            )));
-        }
-        // k-th largest == (n-k)-th smallest: quickselect instead of full sort.
-        let idx = nums.len() - k as usize;
-        let v = nth_smallest(&mut nums, idx);
-        Ok(crate::traits::CalcValue::Scalar(LiteralValue::Number(v)))
+        with_stats_scratch(|bump| {
+            let mut nums = collect_numeric_stats_in(&args[..args.len() - 1], bump)?;
+            if nums.is_empty() || k as usize > nums.len() {
+                return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(
+                    ExcelError::new_num(),
+                )));
+            }
+            // k-th largest == (n-k)-th smallest: quickselect instead of full sort.
+            let idx = nums.len() - k as usize;
+            let v = nth_smallest(&mut nums, idx);
+            Ok(crate::traits::CalcValue::Scalar(LiteralValue::Number(v)))
+        })
     }
 }
 
@@ -606,15 +703,17 @@ impl Function for SMALL {
                 ExcelError::new_num(),
             )));
         }
-        let mut nums = collect_numeric_stats(&args[..args.len() - 1])?;
-        if nums.is_empty() || k as usize > nums.len() {
-            return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(
-                ExcelError::new_num(),
-            )));
-        }
-        // k-th smallest: quickselect instead of full sort.
-        let v = nth_smallest(&mut nums, k as usize - 1);
-        Ok(crate::traits::CalcValue::Scalar(LiteralValue::Number(v)))
+        with_stats_scratch(|bump| {
+            let mut nums = collect_numeric_stats_in(&args[..args.len() - 1], bump)?;
+            if nums.is_empty() || k as usize > nums.len() {
+                return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(
+                    ExcelError::new_num(),
+                )));
+            }
+            // k-th smallest: quickselect instead of full sort.
+            let v = nth_smallest(&mut nums, k as usize - 1);
+            Ok(crate::traits::CalcValue::Scalar(LiteralValue::Number(v)))
+        })
     }
 }
 
@@ -686,22 +785,24 @@ impl Function for MEDIAN {
         args: &'c [ArgumentHandle<'a, 'b>],
         _ctx: &dyn FunctionContext<'b>,
     ) -> Result<crate::traits::CalcValue<'b>, ExcelError> {
-        let mut nums = collect_numeric_stats(args)?;
-        if nums.is_empty() {
-            return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(
-                ExcelError::new_num(),
-            )));
-        }
-        // Middle one/two order statistics: quickselect instead of full sort.
-        let n = nums.len();
-        let mid = n / 2;
-        let med = if n % 2 == 1 {
-            nth_smallest(&mut nums, mid)
-        } else {
-            let (lo, hi) = adjacent_smallest(&mut nums, mid - 1);
-            (lo + hi) / 2.0
-        };
-        Ok(crate::traits::CalcValue::Scalar(LiteralValue::Number(med)))
+        with_stats_scratch(|bump| {
+            let mut nums = collect_numeric_stats_in(args, bump)?;
+            if nums.is_empty() {
+                return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(
+                    ExcelError::new_num(),
+                )));
+            }
+            // Middle one/two order statistics: quickselect instead of full sort.
+            let n = nums.len();
+            let mid = n / 2;
+            let med = if n % 2 == 1 {
+                nth_smallest(&mut nums, mid)
+            } else {
+                let (lo, hi) = adjacent_smallest(&mut nums, mid - 1);
+                (lo + hi) / 2.0
+            };
+            Ok(crate::traits::CalcValue::Scalar(LiteralValue::Number(med)))
+        })
     }
 }
 
@@ -775,21 +876,13 @@ impl Function for StdevSample {
         args: &'c [ArgumentHandle<'a, 'b>],
         _ctx: &dyn FunctionContext<'b>,
     ) -> Result<crate::traits::CalcValue<'b>, ExcelError> {
-        let nums = collect_numeric_stats(args)?;
-        let n = nums.len();
-        if n < 2 {
+        let Some(variance) = numeric_stat_moments(args)?.variance_sample() else {
             return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(
                 ExcelError::from_error_string("#DIV/0!"),
             )));
-        }
-        let mean = nums.iter().sum::<f64>() / (n as f64);
-        let mut ss = 0.0;
-        for &v in &nums {
-            let d = v - mean;
-            ss += d * d;
-        }
+        };
         Ok(crate::traits::CalcValue::Scalar(LiteralValue::Number(
-            (ss / ((n - 1) as f64)).sqrt(),
+            variance.sqrt(),
         )))
     }
 }
@@ -864,21 +957,13 @@ impl Function for StdevPop {
         args: &'c [ArgumentHandle<'a, 'b>],
         _ctx: &dyn FunctionContext<'b>,
     ) -> Result<crate::traits::CalcValue<'b>, ExcelError> {
-        let nums = collect_numeric_stats(args)?;
-        let n = nums.len();
-        if n == 0 {
+        let Some(variance) = numeric_stat_moments(args)?.variance_population() else {
             return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(
                 ExcelError::from_error_string("#DIV/0!"),
             )));
-        }
-        let mean = nums.iter().sum::<f64>() / (n as f64);
-        let mut ss = 0.0;
-        for &v in &nums {
-            let d = v - mean;
-            ss += d * d;
-        }
+        };
         Ok(crate::traits::CalcValue::Scalar(LiteralValue::Number(
-            (ss / (n as f64)).sqrt(),
+            variance.sqrt(),
         )))
     }
 }
@@ -953,21 +1038,13 @@ impl Function for VarSample {
         args: &'c [ArgumentHandle<'a, 'b>],
         _ctx: &dyn FunctionContext<'b>,
     ) -> Result<crate::traits::CalcValue<'b>, ExcelError> {
-        let nums = collect_numeric_stats(args)?;
-        let n = nums.len();
-        if n < 2 {
+        let Some(variance) = numeric_stat_moments(args)?.variance_sample() else {
             return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(
                 ExcelError::from_error_string("#DIV/0!"),
             )));
-        }
-        let mean = nums.iter().sum::<f64>() / (n as f64);
-        let mut ss = 0.0;
-        for &v in &nums {
-            let d = v - mean;
-            ss += d * d;
-        }
+        };
         Ok(crate::traits::CalcValue::Scalar(LiteralValue::Number(
-            ss / ((n - 1) as f64),
+            variance,
         )))
     }
 }
@@ -1042,21 +1119,13 @@ impl Function for VarPop {
         args: &'c [ArgumentHandle<'a, 'b>],
         _ctx: &dyn FunctionContext<'b>,
     ) -> Result<crate::traits::CalcValue<'b>, ExcelError> {
-        let nums = collect_numeric_stats(args)?;
-        let n = nums.len();
-        if n == 0 {
+        let Some(variance) = numeric_stat_moments(args)?.variance_population() else {
             return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(
                 ExcelError::from_error_string("#DIV/0!"),
             )));
-        }
-        let mean = nums.iter().sum::<f64>() / (n as f64);
-        let mut ss = 0.0;
-        for &v in &nums {
-            let d = v - mean;
-            ss += d * d;
-        }
+        };
         Ok(crate::traits::CalcValue::Scalar(LiteralValue::Number(
-            ss / (n as f64),
+            variance,
         )))
     }
 }
@@ -1134,42 +1203,44 @@ impl Function for ModeSingleFn {
         args: &'c [ArgumentHandle<'a, 'b>],
         _ctx: &dyn FunctionContext<'b>,
     ) -> Result<crate::traits::CalcValue<'b>, ExcelError> {
-        let mut nums = collect_numeric_stats(args)?;
-        if nums.is_empty() {
-            return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(
-                ExcelError::new_na(),
-            )));
-        }
-        nums.sort_by(|a, b| a.partial_cmp(b).unwrap());
-        let mut best_val = nums[0];
-        let mut best_cnt = 1usize;
-        let mut cur_val = nums[0];
-        let mut cur_cnt = 1usize;
-        for &v in &nums[1..] {
-            if (v - cur_val).abs() < 1e-12 {
-                cur_cnt += 1;
-            } else {
-                if cur_cnt > best_cnt {
-                    best_cnt = cur_cnt;
-                    best_val = cur_val;
+        with_stats_scratch(|bump| {
+            let mut nums = collect_numeric_stats_in(args, bump)?;
+            if nums.is_empty() {
+                return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(
+                    ExcelError::new_na(),
+                )));
+            }
+            nums.sort_by(|a, b| a.partial_cmp(b).unwrap());
+            let mut best_val = nums[0];
+            let mut best_cnt = 1usize;
+            let mut cur_val = nums[0];
+            let mut cur_cnt = 1usize;
+            for &v in &nums[1..] {
+                if (v - cur_val).abs() < 1e-12 {
+                    cur_cnt += 1;
+                } else {
+                    if cur_cnt > best_cnt {
+                        best_cnt = cur_cnt;
+                        best_val = cur_val;
+                    }
+                    cur_val = v;
+                    cur_cnt = 1;
                 }
-                cur_val = v;
-                cur_cnt = 1;
             }
-        }
-        if cur_cnt > best_cnt {
-            best_cnt = cur_cnt;
-            best_val = cur_val;
-        }
-        if best_cnt <= 1 {
-            Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(
-                ExcelError::new_na(),
-            )))
-        } else {
-            Ok(crate::traits::CalcValue::Scalar(LiteralValue::Number(
-                best_val,
-            )))
-        }
+            if cur_cnt > best_cnt {
+                best_cnt = cur_cnt;
+                best_val = cur_val;
+            }
+            if best_cnt <= 1 {
+                Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(
+                    ExcelError::new_na(),
+                )))
+            } else {
+                Ok(crate::traits::CalcValue::Scalar(LiteralValue::Number(
+                    best_val,
+                )))
+            }
+        })
     }
 }
 
@@ -1244,38 +1315,40 @@ impl Function for ModeMultiFn {
         args: &'c [ArgumentHandle<'a, 'b>],
         _ctx: &dyn FunctionContext<'b>,
     ) -> Result<crate::traits::CalcValue<'b>, ExcelError> {
-        let mut nums = collect_numeric_stats(args)?;
-        if nums.is_empty() {
-            return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(
-                ExcelError::new_na(),
-            )));
-        }
-        nums.sort_by(|a, b| a.partial_cmp(b).unwrap());
-        let mut runs: Vec<(f64, usize)> = Vec::new();
-        let mut cur_val = nums[0];
-        let mut cur_cnt = 1usize;
-        for &v in &nums[1..] {
-            if (v - cur_val).abs() < 1e-12 {
-                cur_cnt += 1;
-            } else {
-                runs.push((cur_val, cur_cnt));
-                cur_val = v;
-                cur_cnt = 1;
+        with_stats_scratch(|bump| {
+            let mut nums = collect_numeric_stats_in(args, bump)?;
+            if nums.is_empty() {
+                return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(
+                    ExcelError::new_na(),
+                )));
             }
-        }
-        runs.push((cur_val, cur_cnt));
-        let max_freq = runs.iter().map(|r| r.1).max().unwrap_or(0);
-        if max_freq <= 1 {
-            return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(
-                ExcelError::new_na(),
-            )));
-        }
-        let rows: Vec<Vec<LiteralValue>> = runs
-            .into_iter()
-            .filter(|&(_, c)| c == max_freq)
-            .map(|(v, _)| vec![LiteralValue::Number(v)])
-            .collect();
-        Ok(crate::traits::CalcValue::Scalar(LiteralValue::Array(rows)))
+            nums.sort_by(|a, b| a.partial_cmp(b).unwrap());
+            let mut runs: Vec<(f64, usize)> = Vec::new();
+            let mut cur_val = nums[0];
+            let mut cur_cnt = 1usize;
+            for &v in &nums[1..] {
+                if (v - cur_val).abs() < 1e-12 {
+                    cur_cnt += 1;
+                } else {
+                    runs.push((cur_val, cur_cnt));
+                    cur_val = v;
+                    cur_cnt = 1;
+                }
+            }
+            runs.push((cur_val, cur_cnt));
+            let max_freq = runs.iter().map(|r| r.1).max().unwrap_or(0);
+            if max_freq <= 1 {
+                return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(
+                    ExcelError::new_na(),
+                )));
+            }
+            let rows: Vec<Vec<LiteralValue>> = runs
+                .into_iter()
+                .filter(|&(_, c)| c == max_freq)
+                .map(|(v, _)| vec![LiteralValue::Number(v)])
+                .collect();
+            Ok(crate::traits::CalcValue::Scalar(LiteralValue::Array(rows)))
+        })
     }
 }
 
@@ -1365,16 +1438,18 @@ impl Function for PercentileInc {
                 )));
             }
         };
-        let mut nums = collect_numeric_stats(&args[..args.len() - 1])?;
-        if nums.is_empty() {
-            return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(
-                ExcelError::new_num(),
-            )));
-        }
-        match percentile_inc(&mut nums, p) {
-            Ok(v) => Ok(crate::traits::CalcValue::Scalar(LiteralValue::Number(v))),
-            Err(e) => Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(e))),
-        }
+        with_stats_scratch(|bump| {
+            let mut nums = collect_numeric_stats_in(&args[..args.len() - 1], bump)?;
+            if nums.is_empty() {
+                return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(
+                    ExcelError::new_num(),
+                )));
+            }
+            match percentile_inc(&mut nums, p) {
+                Ok(v) => Ok(crate::traits::CalcValue::Scalar(LiteralValue::Number(v))),
+                Err(e) => Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(e))),
+            }
+        })
     }
 }
 
@@ -1461,16 +1536,18 @@ impl Function for PercentileExc {
                 )));
             }
         };
-        let mut nums = collect_numeric_stats(&args[..args.len() - 1])?;
-        if nums.is_empty() {
-            return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(
-                ExcelError::new_num(),
-            )));
-        }
-        match percentile_exc(&mut nums, p) {
-            Ok(v) => Ok(crate::traits::CalcValue::Scalar(LiteralValue::Number(v))),
-            Err(e) => Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(e))),
-        }
+        with_stats_scratch(|bump| {
+            let mut nums = collect_numeric_stats_in(&args[..args.len() - 1], bump)?;
+            if nums.is_empty() {
+                return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(
+                    ExcelError::new_num(),
+                )));
+            }
+            match percentile_exc(&mut nums, p) {
+                Ok(v) => Ok(crate::traits::CalcValue::Scalar(LiteralValue::Number(v))),
+                Err(e) => Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(e))),
+            }
+        })
     }
 }
 
@@ -1566,35 +1643,37 @@ impl Function for QuartileInc {
                 ExcelError::new_num(),
             )));
         }
-        let mut nums = collect_numeric_stats(&args[..args.len() - 1])?;
-        if nums.is_empty() {
-            return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(
-                ExcelError::new_num(),
-            )));
-        }
-        let p = match q_i {
-            0 => {
-                let v = nth_smallest(&mut nums, 0);
-                return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Number(v)));
-            }
-            4 => {
-                let idx = nums.len() - 1;
-                let v = nth_smallest(&mut nums, idx);
-                return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Number(v)));
-            }
-            1 => 0.25,
-            2 => 0.5,
-            3 => 0.75,
-            _ => {
+        with_stats_scratch(|bump| {
+            let mut nums = collect_numeric_stats_in(&args[..args.len() - 1], bump)?;
+            if nums.is_empty() {
                 return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(
                     ExcelError::new_num(),
                 )));
             }
-        };
-        match percentile_inc(&mut nums, p) {
-            Ok(v) => Ok(crate::traits::CalcValue::Scalar(LiteralValue::Number(v))),
-            Err(e) => Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(e))),
-        }
+            let p = match q_i {
+                0 => {
+                    let v = nth_smallest(&mut nums, 0);
+                    return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Number(v)));
+                }
+                4 => {
+                    let idx = nums.len() - 1;
+                    let v = nth_smallest(&mut nums, idx);
+                    return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Number(v)));
+                }
+                1 => 0.25,
+                2 => 0.5,
+                3 => 0.75,
+                _ => {
+                    return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(
+                        ExcelError::new_num(),
+                    )));
+                }
+            };
+            match percentile_inc(&mut nums, p) {
+                Ok(v) => Ok(crate::traits::CalcValue::Scalar(LiteralValue::Number(v))),
+                Err(e) => Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(e))),
+            }
+        })
     }
 }
 
@@ -1691,26 +1770,28 @@ impl Function for QuartileExc {
                 ExcelError::new_num(),
             )));
         }
-        let mut nums = collect_numeric_stats(&args[..args.len() - 1])?;
-        if nums.len() < 2 {
-            return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(
-                ExcelError::new_num(),
-            )));
-        }
-        let p = match q_i {
-            1 => 0.25,
-            2 => 0.5,
-            3 => 0.75,
-            _ => {
+        with_stats_scratch(|bump| {
+            let mut nums = collect_numeric_stats_in(&args[..args.len() - 1], bump)?;
+            if nums.len() < 2 {
                 return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(
                     ExcelError::new_num(),
                 )));
             }
-        };
-        match percentile_exc(&mut nums, p) {
-            Ok(v) => Ok(crate::traits::CalcValue::Scalar(LiteralValue::Number(v))),
-            Err(e) => Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(e))),
-        }
+            let p = match q_i {
+                1 => 0.25,
+                2 => 0.5,
+                3 => 0.75,
+                _ => {
+                    return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(
+                        ExcelError::new_num(),
+                    )));
+                }
+            };
+            match percentile_exc(&mut nums, p) {
+                Ok(v) => Ok(crate::traits::CalcValue::Scalar(LiteralValue::Number(v))),
+                Err(e) => Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(e))),
+            }
+        })
     }
 }
 
@@ -1784,11 +1865,15 @@ impl Function for ProductFn {
         args: &'c [ArgumentHandle<'a, 'b>],
         _ctx: &dyn FunctionContext<'b>,
     ) -> Result<crate::traits::CalcValue<'b>, ExcelError> {
-        let nums = collect_numeric_stats(args)?;
-        if nums.is_empty() {
+        let mut count = 0usize;
+        let mut result = 1.0;
+        for_each_numeric_stat(args, &mut |n| {
+            count += 1;
+            result *= n;
+        })?;
+        if count == 0 {
             return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Number(0.0)));
         }
-        let result = nums.iter().product::<f64>();
         Ok(crate::traits::CalcValue::Scalar(LiteralValue::Number(
             result,
         )))
@@ -2087,7 +2172,7 @@ pub struct DevsqFn;
 
 /* ─────────────────────────── MAXIFS / MINIFS ──────────────────────────── */
 
-use super::utils::{ARG_ANY_ONE, criteria_match};
+use super::utils::{ARG_ANY_ONE, criteria_match, criteria_may_match};
 
 /// Returns the maximum numeric value in a range that meets all criteria.
 ///
@@ -2311,7 +2396,7 @@ fn eval_maxminifs<'a, 'b>(
         }
     };
 
-    let (rows, cols) = target_view.dims();
+    let cols = target_view.dims().1;
 
     // Parse all criteria
     let mut criteria_ranges = Vec::new();
@@ -2326,60 +2411,89 @@ fn eval_maxminifs<'a, 'b>(
     // Iterate through all cells and find max/min where all criteria match
     let mut result: Option<f64> = None;
 
-    for r in 0..rows {
-        for c in 0..cols {
-            // Check all criteria
-            let mut all_match = true;
-            for (crit_idx, pred) in predicates.iter().enumerate() {
-                let crit_val = match &criteria_ranges[crit_idx] {
-                    Some(view) => {
-                        let (cr, cc) = view.dims();
-                        if r < cr && c < cc {
-                            view.get_cell(r, c)
-                        } else {
-                            LiteralValue::Empty
+    for (row_start, row_len) in target_view.row_chunk_bounds()? {
+        // Zone maps skip a column of this block when a criterion cannot match there, or when
+        // it holds no error and no value that could improve on the current result.
+        let skip: Vec<bool> = (0..cols)
+            .map(|c| {
+                let excluded = predicates.iter().zip(&criteria_ranges).any(|(pred, view)| {
+                    view.as_ref().is_some_and(|v| {
+                        !criteria_may_match(pred, &v.zone_map(row_start, row_len, c))
+                    })
+                });
+                excluded
+                    || result.is_some_and(|curr| {
+                        let zone = target_view.zone_map(row_start, row_len, c);
+                        !zone.has_error
+                            && if is_max {
+                                zone.num_max <= curr
+                            } else {
+                                zone.num_min >= curr
+                            }
+                    })
+            })
+            .collect();
+        if skip.iter().all(|&s| s) {
+            continue;
+        }
+        for r in row_start..row_start + row_len {
+            for c in 0..cols {
+                if skip[c] {
+                    continue;
+                }
+                // Check all criteria
+                let mut all_match = true;
+                for (crit_idx, pred) in predicates.iter().enumerate() {
+                    let crit_val = match &criteria_ranges[crit_idx] {
+                        Some(view) => {
+                            let (cr, cc) = view.dims();
+                            if r < cr && c < cc {
+                                view.get_cell(r, c)
+                            } else {
+                                LiteralValue::Empty
+                            }
                         }
+                        None => LiteralValue::Empty,
+                    };
+                    if !criteria_match(pred, &crit_val) {
+                        all_match = false;
+                        break;
                     }
-                    None => LiteralValue::Empty,
-                };
-                if !criteria_match(pred, &crit_val) {
-                    all_match = false;
-                    break;
                 }
-            }
 
-            if all_match {
-                let target_val = target_view.get_cell(r, c);
-                match target_val {
-                    LiteralValue::Error(e) => {
-                        return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(e)));
-                    }
-                    LiteralValue::Number(n) => {
-                        result = Some(match result {
-                            None => n,
-                            Some(curr) => {
-                                if is_max {
-                                    curr.max(n)
-                                } else {
-                                    curr.min(n)
+                if all_match {
+                    let target_val = target_view.get_cell(r, c);
+                    match target_val {
+                        LiteralValue::Error(e) => {
+                            return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(e)));
+                        }
+                        LiteralValue::Number(n) => {
+                            result = Some(match result {
+                                None => n,
+                                Some(curr) => {
+                                    if is_max {
+                                        curr.max(n)
+                                    } else {
+                                        curr.min(n)
+                                    }
                                 }
-                            }
-                        });
-                    }
-                    LiteralValue::Int(i) => {
-                        let n = i as f64;
-                        result = Some(match result {
-                            None => n,
-                            Some(curr) => {
-                                if is_max {
-                                    curr.max(n)
-                                } else {
-                                    curr.min(n)
+                            });
+                        }
+                        LiteralValue::Int(i) => {
+                            let n = i as f64;
+                            result = Some(match result {
+                                None => n,
+                                Some(curr) => {
+                                    if is_max {
+                                        curr.max(n)
+                                    } else {
+                                        curr.min(n)
+                                    }
                                 }
-                            }
-                        });
+                            });
+                        }
+                        _ => {} // Skip non-numeric
                     }
-                    _ => {} // Skip non-numeric
                 }
             }
         }
@@ -2451,44 +2565,46 @@ impl Function for TrimmeanFn {
         args: &'c [ArgumentHandle<'a, 'b>],
         _ctx: &dyn FunctionContext<'b>,
     ) -> Result<crate::traits::CalcValue<'b>, ExcelError> {
-        let mut nums = collect_numeric_stats(&args[0..1])?;
-        if nums.is_empty() {
-            return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(
-                ExcelError::new_num(),
-            )));
-        }
-
-        let percent = match args[1].value()?.into_literal() {
-            LiteralValue::Error(e) => {
-                return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(e)));
+        with_stats_scratch(|bump| {
+            let mut nums = collect_numeric_stats_in(&args[0..1], bump)?;
+            if nums.is_empty() {
+                return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(
+                    ExcelError::new_num(),
+                )));
             }
-            other => coerce_num(&other)?,
-        };
 
-        // Percent must be between 0 and 1 (exclusive of 1)
-        if !(0.0..1.0).contains(&percent) {
-            return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(
-                ExcelError::new_num(),
-            )));
-        }
+            let percent = match args[1].value()?.into_literal() {
+                LiteralValue::Error(e) => {
+                    return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(e)));
+                }
+                other => coerce_num(&other)?,
+            };
 
-        nums.sort_by(|a, b| a.partial_cmp(b).unwrap_or(std::cmp::Ordering::Equal));
+            // Percent must be between 0 and 1 (exclusive of 1)
+            if !(0.0..1.0).contains(&percent) {
+                return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(
+                    ExcelError::new_num(),
+                )));
+            }
 
-        let n = nums.len();
-        // Number of values to exclude from each end
-        let exclude = ((n as f64 * percent) / 2.0).floor() as usize;
+            nums.sort_by(|a, b| a.partial_cmp(b).unwrap_or(std::cmp::Ordering::Equal));
 
-        if 2 * exclude >= n {
-            return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(
-                ExcelError::new_num(),
-            )));
-        }
+            let n = nums.len();
+            // Number of values to exclude from each end
+            let exclude = ((n as f64 * percent) / 2.0).floor() as usize;
+
+            if 2 * exclude >= n {
+                return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(
+                    ExcelError::new_num(),
+                )));
+            }
 
-        let trimmed = &nums[exclude..n - exclude];
-        let sum: f64 = trimmed.iter().sum();
-        let mean = sum / trimmed.len() as f64;
+            let trimmed = &nums[exclude..n - exclude];
+            let sum: f64 = trimmed.iter().sum();
+            let mean = sum / trimmed.len() as f64;
 
-        Ok(crate::traits::CalcValue::Scalar(LiteralValue::Number(mean)))
+            Ok(crate::traits::CalcValue::Scalar(LiteralValue::Number(mean)))
+        })
     }
 }
 
@@ -2816,16 +2932,14 @@ impl Function for DevsqFn {
         args: &'c [ArgumentHandle<'a, 'b>],
         _ctx: &dyn FunctionContext<'b>,
     ) -> Result<crate::traits::CalcValue<'b>, ExcelError> {
-        let nums = collect_numeric_stats(args)?;
-        if nums.is_empty() {
+        let moments = numeric_stat_moments(args)?;
+        if moments.count == 0 {
             return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(
                 ExcelError::new_num(),
             )));
         }
-        let mean = nums.iter().sum::<f64>() / nums.len() as f64;
-        let devsq = nums.iter().map(|x| (x - mean).powi(2)).sum::<f64>();
         Ok(crate::traits::CalcValue::Scalar(LiteralValue::Number(
-            devsq,
+            moments.devsq(),
         )))
     }
 }
@@ -7411,56 +7525,58 @@ impl Function for PercentRankIncFn {
         };
 
         // Collect and sort the data array
-        let mut nums = collect_numeric_stats(&args[0..1])?;
-        if nums.is_empty() {
-            return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(
-                ExcelError::new_num(),
-            )));
-        }
-        nums.sort_by(|a, b| a.partial_cmp(b).unwrap());
+        with_stats_scratch(|bump| {
+            let mut nums = collect_numeric_stats_in(&args[0..1], bump)?;
+            if nums.is_empty() {
+                return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(
+                    ExcelError::new_num(),
+                )));
+            }
+            nums.sort_by(|a, b| a.partial_cmp(b).unwrap());
 
-        let n = nums.len();
+            let n = nums.len();
 
-        // Check if x is outside the range
-        if x < nums[0] || x > nums[n - 1] {
-            return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(
-                ExcelError::new_na(),
-            )));
-        }
+            // Check if x is outside the range
+            if x < nums[0] || x > nums[n - 1] {
+                return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(
+                    ExcelError::new_na(),
+                )));
+            }
 
-        // Find the rank using linear interpolation
-        // For PERCENTRANK.INC, the formula is: rank = (position) / (n-1)
-        // where position is 0-based and uses linear interpolation
-        let rank = if n == 1 {
-            // Single element - rank is 0 (or 1.0 if we want, but Excel returns 0)
-            0.0
-        } else {
-            let mut rank_val = 0.0;
-            for i in 0..n - 1 {
-                if (nums[i] - x).abs() < 1e-12 {
-                    // Exact match at position i
-                    rank_val = (i as f64) / ((n - 1) as f64);
-                    break;
-                } else if nums[i] < x && x < nums[i + 1] {
-                    // Interpolate between positions i and i+1
-                    let frac = (x - nums[i]) / (nums[i + 1] - nums[i]);
-                    rank_val = ((i as f64) + frac) / ((n - 1) as f64);
-                    break;
-                } else if i == n - 2 && (nums[n - 1] - x).abs() < 1e-12 {
-                    // Exact match at last position
-                    rank_val = 1.0;
+            // Find the rank using linear interpolation
+            // For PERCENTRANK.INC, the formula is: rank = (position) / (n-1)
+            // where position is 0-based and uses linear interpolation
+            let rank = if n == 1 {
+                // Single element - rank is 0 (or 1.0 if we want, but Excel returns 0)
+                0.0
+            } else {
+                let mut rank_val = 0.0;
+                for i in 0..n - 1 {
+                    if (nums[i] - x).abs() < 1e-12 {
+                        // Exact match at position i
+                        rank_val = (i as f64) / ((n - 1) as f64);
+                        break;
+                    } else if nums[i] < x && x < nums[i + 1] {
+                        // Interpolate between positions i and i+1
+                        let frac = (x - nums[i]) / (nums[i + 1] - nums[i]);
+                        rank_val = ((i as f64) + frac) / ((n - 1) as f64);
+                        break;
+                    } else if i == n - 2 && (nums[n - 1] - x).abs() < 1e-12 {
+                        // Exact match at last position
+                        rank_val = 1.0;
+                    }
                 }
-            }
-            rank_val
-        };
+                rank_val
+            };
 
-        // Truncate to significance decimal places
-        let multiplier = 10_f64.powi(significance as i32);
-        let truncated = (rank * multiplier).trunc() / multiplier;
+            // Truncate to significance decimal places
+            let multiplier = 10_f64.powi(significance as i32);
+            let truncated = (rank * multiplier).trunc() / multiplier;
 
-        Ok(crate::traits::CalcValue::Scalar(LiteralValue::Number(
-            truncated,
-        )))
+            Ok(crate::traits::CalcValue::Scalar(LiteralValue::Number(
+                truncated,
+            )))
+        })
     }
 }
 
@@ -7553,50 +7669,52 @@ impl Function for PercentRankExcFn {
         };
 
         // Collect and sort the data array
-        let mut nums = collect_numeric_stats(&args[0..1])?;
-        if nums.is_empty() {
-            return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(
-                ExcelError::new_num(),
-            )));
-        }
-        nums.sort_by(|a, b| a.partial_cmp(b).unwrap());
+        with_stats_scratch(|bump| {
+            let mut nums = collect_numeric_stats_in(&args[0..1], bump)?;
+            if nums.is_empty() {
+                return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(
+                    ExcelError::new_num(),
+                )));
+            }
+            nums.sort_by(|a, b| a.partial_cmp(b).unwrap());
 
-        let n = nums.len();
+            let n = nums.len();
 
-        // Check if x is outside the range
-        if x < nums[0] || x > nums[n - 1] {
-            return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(
-                ExcelError::new_na(),
-            )));
-        }
+            // Check if x is outside the range
+            if x < nums[0] || x > nums[n - 1] {
+                return Ok(crate::traits::CalcValue::Scalar(LiteralValue::Error(
+                    ExcelError::new_na(),
+                )));
+            }
 
-        // For PERCENTRANK.EXC, the formula is: rank = position / (n+1)
-        // where position is 1-based and uses linear interpolation
-        let rank = {
-            let mut rank_val = 0.0;
-            for i in 0..n {
-                if (nums[i] - x).abs() < 1e-12 {
-                    // Exact match at position i (1-based: i+1)
-                    rank_val = ((i + 1) as f64) / ((n + 1) as f64);
-                    break;
-                } else if i < n - 1 && nums[i] < x && x < nums[i + 1] {
-                    // Interpolate between positions i and i+1 (1-based: i+1 and i+2)
-                    let frac = (x - nums[i]) / (nums[i + 1] - nums[i]);
-                    let position = ((i + 1) as f64) + frac;
-                    rank_val = position / ((n + 1) as f64);
-                    break;
+            // For PERCENTRANK.EXC, the formula is: rank = position / (n+1)
+            // where position is 1-based and uses linear interpolation
+            let rank = {
+                let mut rank_val = 0.0;
+                for i in 0..n {
+                    if (nums[i] - x).abs() < 1e-12 {
+                        // Exact match at position i (1-based: i+1)
+                        rank_val = ((i + 1) as f64) / ((n + 1) as f64);
+                        break;
+                    } else if i < n - 1 && nums[i] < x && x < nums[i + 1] {
+                        // Interpolate between positions i and i+1 (1-based: i+1 and i+2)
+                        let frac = (x - nums[i]) / (nums[i + 1] - nums[i]);
+                        let position = ((i + 1) as f64) + frac;
+                        rank_val = position / ((n + 1) as f64);
+                        break;
+                    }
                 }
-            }
-            rank_val
-        };
+                rank_val
+            };
 
-        // Truncate to significance decimal places
-        let multiplier = 10_f64.powi(significance as i32);
-        let truncated = (rank * multiplier).trunc() / multiplier;
+            // Truncate to significance decimal places
+            let multiplier = 10_f64.powi(significance as i32);
+            let truncated = (rank * multiplier).trunc() / multiplier;
 
-        Ok(crate::traits::CalcValue::Scalar(LiteralValue::Number(
-            truncated,
-        )))
+            Ok(crate::traits::CalcValue::Scalar(LiteralValue::Number(
+                truncated,
+            )))
+        })
     }
 }
 
@@ -4,6 +4,7 @@ use crate::function::Function;
 use crate::traits::{ArgumentHandle, CalcValue, FunctionContext, ResolvedArgument};
 use formualizer_common::{ExcelError, ExcelErrorKind, LiteralValue};
 use formualizer_macros::func_caps;
+use std::borrow::Cow;
 use std::sync::LazyLock;
 
 static ARG_ANY_RANGE_ONE: LazyLock<Vec<ArgSchema>> = LazyLock::new(|| {
@@ -662,18 +663,14 @@ impl Function for TextJoinFn {
                         }
                     }
                     value => {
-                        let s = match value {
-                            LiteralValue::Text(t) => t.clone(),
+                        let s: Cow<'_, str> = match value {
+                            LiteralValue::Text(t) => Cow::Borrowed(t),
                             LiteralValue::Boolean(b) => {
-                                if *b {
-                                    "TRUE".to_string()
-                                } else {
-                                    "FALSE".to_string()
-                                }
+                                Cow::Borrowed(if *b { "TRUE" } else { "FALSE" })
                             }
-                            LiteralValue::Int(i) => i.to_string(),
-                            LiteralValue::Number(f) => f.to_string(),
-                            _ => value.to_string(),
+                            LiteralValue::Int(i) => Cow::Owned(i.to_string()),
+                            LiteralValue::Number(f) => Cow::Owned(f.to_string()),
+                            _ => Cow::Owned(value.to_string()),
                         };
                         if !ignore_empty || !s.is_empty() {
                             if has_item {
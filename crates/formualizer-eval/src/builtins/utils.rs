@@ -329,6 +329,47 @@ pub fn criteria_match(pred: &crate::args::CriteriaPredicate, v: &LiteralValue) -
     }
 }
 
+/// Whether any value summarized by `zone` can satisfy `pred` under `criteria_match`.
+///
+/// Conservative: `true` whenever the statistics cannot rule a match out, so a `false`
+/// lets callers skip the whole chunk.
+pub fn criteria_may_match(
+    pred: &crate::args::CriteriaPredicate,
+    zone: &crate::arrow_store::ZoneMap,
+) -> bool {
+    use crate::args::CriteriaPredicate as P;
+    let range = zone.coerced_number_range();
+    let may_equal_number = |x: f64| {
+        range.is_none_or(|(lo, hi)| x >= lo - EQUALITY_EPSILON && x <= hi + EQUALITY_EPSILON)
+    };
+    match pred {
+        P::Gt(n) => range.is_none_or(|(_, hi)| hi > *n),
+        P::Ge(n) => range.is_none_or(|(_, hi)| hi >= *n),
+        P::Lt(n) => range.is_none_or(|(lo, _)| lo < *n),
+        P::Le(n) => range.is_none_or(|(lo, _)| lo <= *n),
+        P::Eq(v) => match v {
+            LiteralValue::Number(x) => may_equal_number(*x),
+            LiteralValue::Int(x) => may_equal_number(*x as f64),
+            LiteralValue::Boolean(b) => zone.has_bool || may_equal_number(f64::from(u8::from(*b))),
+            LiteralValue::Text(t) if t.is_empty() => zone.has_blank || zone.has_text,
+            LiteralValue::Text(t) => {
+                zone.may_contain_text(&t.to_lowercase())
+                    || value_to_number(v).is_ok_and(may_equal_number)
+            }
+            LiteralValue::Empty => zone.has_blank || zone.has_text,
+            other => other.as_serial_number().is_none_or(may_equal_number),
+        },
+        P::IsBlank => zone.has_blank,
+        P::IsText => zone.has_text,
+        P::IsLogical => zone.has_bool,
+        P::IsNumber => range.is_none_or(|(lo, hi)| lo <= hi),
+        P::Ne(_) | P::TextLike { .. } => true,
+    }
+}
+
+/// Absolute tolerance of criteria equality between numbers.
+const EQUALITY_EPSILON: f64 = 1e-12;
+
 fn value_to_number(v: &LiteralValue) -> Result<f64, ExcelError> {
     crate::coercion::to_number_lenient(v)
 }
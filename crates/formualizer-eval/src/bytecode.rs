@@ -0,0 +1,626 @@
+//! Register bytecode for arena-stored formulas.
+//!
+//! [`compile`] lowers a formula rooted in the `AstArena` into a flat
+//! [`Program`]: literals move into a constant pool, cell references keep their
+//! sheet key and 1-based coordinates, and function calls carry the
+//! `Arc<dyn Function>` resolved at compile time instead of a name looked up
+//! through the `FunctionProvider` on every evaluation. [`Program::run`]
+//! executes three-address instructions over a per-thread register file using
+//! the interpreter's own operator helpers, so results match the tree walk by
+//! construction.
+//!
+//! Binary operators carry a feedback slot. While a site keeps seeing plain
+//! numbers it runs a specialised f64 kernel (arithmetic and comparisons with
+//! no coercion, broadcasting, or `LiteralValue` dispatch), guarded on both
+//! operand tags; a guard failure takes the generic helper for that
+//! evaluation, and a site that keeps missing stops trying.
+//!
+//! Lowering is deliberately partial. Function arguments stay lazy arena
+//! handles (functions own by-ref, short-circuit, and range semantics), and
+//! operand subtrees the VM does not model (non-cell references, `:`, `@`,
+//! array literals, unresolved names) run as `Tree` instructions on the
+//! interpreter. A root that would itself need `Tree` is not compiled; callers
+//! fall back to `Interpreter::evaluate_arena_ast`.
+
+use std::cell::RefCell;
+use std::hash::BuildHasherDefault;
+use std::sync::Arc;
+use std::sync::atomic::{AtomicU8, AtomicU64, Ordering};
+
+use dashmap::DashMap;
+use formualizer_common::{ExcelError, ExcelErrorKind, LiteralValue};
+use rustc_hash::FxHasher;
+
+use crate::SheetId;
+use crate::engine::arena::{AstNodeData, AstNodeId, CompactRefType, DataStore, SheetKey, StringId};
+use crate::engine::const_fold::ConstantFoldSettings;
+use crate::engine::sheet_registry::SheetRegistry;
+use crate::function::Function;
+use crate::interpreter::Interpreter;
+use crate::traits::{CalcValue, EvaluationContext};
+
+type Reg = u16;
+
+/// Guard misses after which a binary site skips its numeric kernel.
+const GENERIC_AFTER_MISSES: u8 = 16;
+
+/// A plain numeric operand; `Int` widens exactly as lenient coercion does.
+#[inline]
+fn as_f64(value: &LiteralValue) -> Option<f64> {
+    match *value {
+        LiteralValue::Number(n) => Some(n),
+        LiteralValue::Int(i) => Some(i as f64),
+        _ => None,
+    }
+}
+
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+enum UnaryOp {
+    Plus,
+    Neg,
+    Percent,
+}
+
+impl UnaryOp {
+    fn parse(op: &str) -> Option<Self> {
+        Some(match op {
+            "+" => Self::Plus,
+            "-" => Self::Neg,
+            "%" => Self::Percent,
+            _ => return None,
+        })
+    }
+
+    fn as_str(self) -> &'static str {
+        match self {
+            Self::Plus => "+",
+            Self::Neg => "-",
+            Self::Percent => "%",
+        }
+    }
+}
+
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+enum BinaryOp {
+    Add,
+    Sub,
+    Mul,
+    Div,
+    Pow,
+    Concat,
+    Eq,
+    Ne,
+    Gt,
+    Lt,
+    Ge,
+    Le,
+}
+
+impl BinaryOp {
+    fn parse(op: &str) -> Option<Self> {
+        Some(match op {
+            "+" => Self::Add,
+            "-" => Self::Sub,
+            "*" => Self::Mul,
+            "/" => Self::Div,
+            "^" => Self::Pow,
+            "&" => Self::Concat,
+            "=" => Self::Eq,
+            "<>" => Self::Ne,
+            ">" => Self::Gt,
+            "<" => Self::Lt,
+            ">=" => Self::Ge,
+            "<=" => Self::Le,
+            _ => return None,
+        })
+    }
+
+    fn as_str(self) -> &'static str {
+        match self {
+            Self::Add => "+",
+            Self::Sub => "-",
+            Self::Mul => "*",
+            Self::Div => "/",
+            Self::Pow => "^",
+            Self::Concat => "&",
+            Self::Eq => "=",
+            Self::Ne => "<>",
+            Self::Gt => ">",
+            Self::Lt => "<",
+            Self::Ge => ">=",
+            Self::Le => "<=",
+        }
+    }
+
+    /// The operator over two plain numbers, or `None` when the generic helper
+    /// must decide: concatenation, division by zero, a negative base with a
+    /// fractional exponent, or a non-finite result (`#NUM!`).
+    #[inline]
+    fn eval_f64(self, a: f64, b: f64) -> Option<LiteralValue> {
+        let n = match self {
+            Self::Add => a + b,
+            Self::Sub => a - b,
+            Self::Mul => a * b,
+            Self::Div if b != 0.0 => a / b,
+            Self::Pow if a >= 0.0 || b.fract() == 0.0 => a.powf(b),
+            Self::Eq => return Some(LiteralValue::Boolean(a == b)),
+            Self::Ne => return Some(LiteralValue::Boolean(a != b)),
+            Self::Gt => return Some(LiteralValue::Boolean(a > b)),
+            Self::Lt => return Some(LiteralValue::Boolean(a < b)),
+            Self::Ge => return Some(LiteralValue::Boolean(a >= b)),
+            Self::Le => return Some(LiteralValue::Boolean(a <= b)),
+            Self::Div | Self::Pow | Self::Concat => return None,
+        };
+        n.is_finite().then_some(LiteralValue::Number(n))
+    }
+}
+
+/// Sheet of a pre-resolved cell load. Registry ids are resolved to names at
+/// run time so sheet renames never stale a cached program.
+#[derive(Debug, Clone, Copy)]
+enum CellSheet {
+    Current,
+    Id(SheetId),
+    Name(StringId),
+}
+
+#[derive(Debug, Clone, Copy)]
+enum Instr {
+    Const {
+        dst: Reg,
+        index: u32,
+    },
+    LoadCell {
+        dst: Reg,
+        sheet: CellSheet,
+        row: u32,
+        col: u32,
+    },
+    Unary {
+        dst: Reg,
+        op: UnaryOp,
+        src: Reg,
+    },
+    Binary {
+        dst: Reg,
+        op: BinaryOp,
+        lhs: Reg,
+        rhs: Reg,
+        /// Index into `Program::feedback`.
+        site: u32,
+    },
+    Call {
+        dst: Reg,
+        function: u32,
+        node: AstNodeId,
+    },
+    Tree {
+        dst: Reg,
+        node: AstNodeId,
+    },
+}
+
+/// A compiled formula. Cheap to share across evaluation threads.
+pub(crate) struct Program {
+    code: Vec<Instr>,
+    constants: Vec<LiteralValue>,
+    functions: Vec<Arc<dyn Function>>,
+    registers: usize,
+    /// Numeric guard misses per binary site, saturating at
+    /// [`GENERIC_AFTER_MISSES`]. Shared by every thread running the program.
+    feedback: Box<[AtomicU8]>,
+    /// The root is a function call; its `CalcValue` (possibly a range) is
+    /// returned as-is rather than materialized into a register.
+    root_call: Option<(u32, AstNodeId)>,
+}
+
+impl std::fmt::Debug for Program {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("Program")
+            .field("code", &self.code)
+            .field("constants", &self.constants.len())
+            .field("functions", &self.functions.len())
+            .field("registers", &self.registers)
+            .field("binary_sites", &self.feedback.len())
+            .finish()
+    }
+}
+
+thread_local! {
+    /// Reusable register file. Taken for the duration of a run, so a nested
+    /// run on the same thread simply starts from an empty vector.
+    static REGISTERS: RefCell<Vec<LiteralValue>> = const { RefCell::new(Vec::new()) };
+}
+
+impl Program {
+    pub(crate) fn instruction_count(&self) -> usize {
+        self.code.len() + usize::from(self.root_call.is_some())
+    }
+
+    pub(crate) fn run<'a>(
+        &self,
+        interp: &Interpreter<'a>,
+        data_store: &DataStore,
+        sheet_registry: &SheetRegistry,
+    ) -> Result<CalcValue<'a>, ExcelError> {
+        if let Some((function, node)) = self.root_call {
+            return self.call(function, node, interp, data_store, sheet_registry);
+        }
+        let mut regs = REGISTERS.with(|cell| cell.take());
+        regs.resize(self.registers, LiteralValue::Empty);
+        let result = self.execute(&mut regs, interp, data_store, sheet_registry);
+        let value = result.map(|()| std::mem::replace(&mut regs[0], LiteralValue::Empty));
+        regs.clear();
+        REGISTERS.with(|cell| cell.replace(regs));
+        value.map(CalcValue::Scalar)
+    }
+
+    fn execute(
+        &self,
+        regs: &mut [LiteralValue],
+        interp: &Interpreter<'_>,
+        data_store: &DataStore,
+        sheet_registry: &SheetRegistry,
+    ) -> Result<(), ExcelError> {
+        for instr in &self.code {
+            match *instr {
+                Instr::Const { dst, index } => {
+                    regs[dst as usize] = self.constants[index as usize].clone();
+                }
+                Instr::LoadCell {
+                    dst,
+                    sheet,
+                    row,
+                    col,
+                } => {
+                    let sheet_name = match sheet {
+                        CellSheet::Current => None,
+                        CellSheet::Id(id) => Some(sheet_registry.name(id)),
+                        CellSheet::Name(name_id) => Some(data_store.resolve_ast_string(name_id)),
+                    };
+                    regs[dst as usize] = interp.context.resolve_cell_reference_value(
+                        sheet_name,
+                        row,
+                        col,
+                        interp.current_sheet(),
+                    )?;
+                }
+                Instr::Unary { dst, op, src } => {
+                    let v = std::mem::replace(&mut regs[src as usize], LiteralValue::Empty);
+                    regs[dst as usize] = interp.apply_unary_op(op.as_str(), v)?;
+                }
+                Instr::Binary {
+                    dst,
+                    op,
+                    lhs,
+                    rhs,
+                    site,
+                } => {
+                    let misses = &self.feedback[site as usize];
+                    if misses.load(Ordering::Relaxed) < GENERIC_AFTER_MISSES {
+                        if let (Some(a), Some(b)) =
+                            (as_f64(&regs[lhs as usize]), as_f64(&regs[rhs as usize]))
+                            && let Some(value) = op.eval_f64(a, b)
+                        {
+                            regs[dst as usize] = value;
+                            continue;
+                        }
+                        misses.fetch_add(1, Ordering::Relaxed);
+                    }
+                    let left = std::mem::replace(&mut regs[lhs as usize], LiteralValue::Empty);
+                    let right = std::mem::replace(&mut regs[rhs as usize], LiteralValue::Empty);
+                    regs[dst as usize] = interp.apply_binary_op(op.as_str(), left, right)?;
+                }
+                Instr::Call {
+                    dst,
+                    function,
+                    node,
+                } => {
+                    regs[dst as usize] = self
+                        .call(function, node, interp, data_store, sheet_registry)?
+                        .into_literal();
+                }
+                Instr::Tree { dst, node } => {
+                    regs[dst as usize] = interp
+                        .evaluate_arena_ast(node, data_store, sheet_registry)?
+                        .into_literal();
+                }
+            }
+        }
+        Ok(())
+    }
+
+    /// Binary sites whose numeric guard kept missing.
+    fn generic_sites(&self) -> usize {
+        self.feedback
+            .iter()
+            .filter(|misses| misses.load(Ordering::Relaxed) >= GENERIC_AFTER_MISSES)
+            .count()
+    }
+
+    fn call<'a>(
+        &self,
+        function: u32,
+        node: AstNodeId,
+        interp: &Interpreter<'a>,
+        data_store: &DataStore,
+        sheet_registry: &SheetRegistry,
+    ) -> Result<CalcValue<'a>, ExcelError> {
+        interp.with_shared_subexpression(node, data_store, || {
+            let args = data_store.get_args(node).ok_or_else(|| {
+                ExcelError::new(ExcelErrorKind::Value).with_message("Missing function args")
+            })?;
+            interp.dispatch_arena_function(
+                &self.functions[function as usize],
+                args,
+                data_store,
+                sheet_registry,
+            )
+        })
+    }
+}
+
+struct Compiler<'d> {
+    data_store: &'d DataStore,
+    context: &'d dyn EvaluationContext,
+    code: Vec<Instr>,
+    constants: Vec<LiteralValue>,
+    functions: Vec<Arc<dyn Function>>,
+    registers: usize,
+    binary_sites: u32,
+}
+
+impl Compiler<'_> {
+    fn resolve_function(&mut self, node: AstNodeId) -> Option<u32> {
+        let AstNodeData::Function { name_id, .. } = self.data_store.get_node(node)? else {
+            return None;
+        };
+        let name = self.data_store.resolve_ast_string(*name_id);
+        let function = self.context.get_function("", name)?;
+        self.functions.push(function);
+        u32::try_from(self.functions.len() - 1).ok()
+    }
+
+    /// Scalar value `node` was folded to at ingest, if any.
+    fn folded_scalar(&self, node: AstNodeId) -> Option<LiteralValue> {
+        self.data_store
+            .constants()
+            .scalar(node, ConstantFoldSettings::of(self.context))
+    }
+
+    /// Lower `node` into register `dst`; later registers are scratch.
+    fn expr(&mut self, node: AstNodeId, dst: Reg) -> Option<()> {
+        self.registers = self.registers.max(dst as usize + 1);
+        if let Some(value) = self.folded_scalar(node) {
+            self.constants.push(value);
+            self.code.push(Instr::Const {
+                dst,
+                index: u32::try_from(self.constants.len() - 1).ok()?,
+            });
+            return Some(());
+        }
+        let instr = match self.data_store.get_node(node)? {
+            AstNodeData::Literal(vref) => {
+                self.constants.push(self.data_store.retrieve_value(*vref));
+                Instr::Const {
+                    dst,
+                    index: u32::try_from(self.constants.len() - 1).ok()?,
+                }
+            }
+            AstNodeData::Reference {
+                ref_type:
+                    CompactRefType::Cell {
+                        sheet, row, col, ..
+                    },
+                ..
+            } if *row > 0 && *col > 0 => Instr::LoadCell {
+                dst,
+                sheet: match sheet {
+                    None => CellSheet::Current,
+                    Some(SheetKey::Id(id)) => CellSheet::Id(*id),
+                    Some(SheetKey::Name(name_id)) => CellSheet::Name(*name_id),
+                },
+                row: *row,
+                col: *col,
+            },
+            AstNodeData::UnaryOp { op_id, expr_id } => {
+                match UnaryOp::parse(self.data_store.resolve_ast_string(*op_id)) {
+                    Some(op) => {
+                        self.expr(*expr_id, dst)?;
+                        Instr::Unary { dst, op, src: dst }
+                    }
+                    None => Instr::Tree { dst, node },
+                }
+            }
+            AstNodeData::BinaryOp {
+                op_id,
+                left_id,
+                right_id,
+            } => match BinaryOp::parse(self.data_store.resolve_ast_string(*op_id)) {
+                Some(op) => {
+                    let rhs = dst.checked_add(1)?;
+                    self.expr(*left_id, dst)?;
+                    self.expr(*right_id, rhs)?;
+                    let site = self.binary_sites;
+                    self.binary_sites += 1;
+                    Instr::Binary {
+                        dst,
+                        op,
+                        lhs: dst,
+                        rhs,
+                        site,
+                    }
+                }
+                None => Instr::Tree { dst, node },
+            },
+            AstNodeData::Function { .. } => match self.resolve_function(node) {
+                Some(function) => Instr::Call {
+                    dst,
+                    function,
+                    node,
+                },
+                None => Instr::Tree { dst, node },
+            },
+            _ => Instr::Tree { dst, node },
+        };
+        self.code.push(instr);
+        Some(())
+    }
+}
+
+/// Compile the formula rooted at `root`. `None` when the root itself cannot
+/// be lowered (it would only run as a single `Tree` instruction).
+pub(crate) fn compile(
+    root: AstNodeId,
+    data_store: &DataStore,
+    context: &dyn EvaluationContext,
+) -> Option<Program> {
+    let mut compiler = Compiler {
+        data_store,
+        context,
+        code: Vec::new(),
+        constants: Vec::new(),
+        functions: Vec::new(),
+        registers: 0,
+        binary_sites: 0,
+    };
+    if matches!(data_store.get_node(root)?, AstNodeData::Function { .. })
+        && compiler.folded_scalar(root).is_none()
+    {
+        let function = compiler.resolve_function(root)?;
+        return Some(Program {
+            code: Vec::new(),
+            constants: Vec::new(),
+            functions: compiler.functions,
+            registers: 0,
+            feedback: Box::default(),
+            root_call: Some((function, root)),
+        });
+    }
+    compiler.expr(root, 0)?;
+    if matches!(compiler.code.last(), Some(Instr::Tree { .. })) {
+        return None;
+    }
+    Some(Program {
+        code: compiler.code,
+        constants: compiler.constants,
+        functions: compiler.functions,
+        registers: compiler.registers,
+        feedback: (0..compiler.binary_sites)
+            .map(|_| AtomicU8::new(0))
+            .collect(),
+        root_call: None,
+    })
+}
+
+/// Counters for [`ProgramCache`] (see `Engine::bytecode_stats`).
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct BytecodeStats {
+    /// Formula roots compiled to a program.
+    pub compiled: u64,
+    /// Formula roots that could not be lowered and use the tree interpreter.
+    pub uncompiled: u64,
+    /// Evaluations executed by the VM.
+    pub vm_evals: u64,
+    /// Evaluations that fell back to the tree interpreter.
+    pub tree_evals: u64,
+    /// Binary operator sites in cached programs.
+    pub binary_sites: u64,
+    /// Binary sites that saw non-numeric operands (or out-of-domain results)
+    /// often enough to stop trying the numeric kernel.
+    pub generic_binary_sites: u64,
+}
+
+struct CachedProgram {
+    /// Function-provider revision the program's resolved calls were bound at.
+    revision: Option<u64>,
+    program: Option<Arc<Program>>,
+}
+
+/// Programs by formula root, shared by every evaluation thread. Arena node
+/// ids are never reused, so entries only go stale when the function provider
+/// revision moves (registered functions change), which forces a recompile.
+#[derive(Default)]
+pub(crate) struct ProgramCache {
+    programs: DashMap<AstNodeId, CachedProgram, BuildHasherDefault<FxHasher>>,
+    compiled: AtomicU64,
+    uncompiled: AtomicU64,
+    vm_evals: AtomicU64,
+    tree_evals: AtomicU64,
+}
+
+impl std::fmt::Debug for ProgramCache {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("ProgramCache")
+            .field("programs", &self.programs.len())
+            .field("stats", &self.stats())
+            .finish()
+    }
+}
+
+impl ProgramCache {
+    /// Program for `root`, compiling on first use. Providers without a
+    /// semantic revision cannot prove resolved calls current, so programs
+    /// that bind functions are not cached for them.
+    pub(crate) fn program(
+        &self,
+        root: AstNodeId,
+        data_store: &DataStore,
+        context: &dyn EvaluationContext,
+    ) -> Option<Arc<Program>> {
+        let revision = context.planning_semantic_revision();
+        if let Some(entry) = self.programs.get(&root)
+            && entry.revision == revision
+        {
+            return entry.program.clone();
+        }
+        let program = compile(root, data_store, context)
+            .filter(|program| revision.is_some() || program.functions.is_empty())
+            .map(Arc::new);
+        let counter = if program.is_some() {
+            &self.compiled
+        } else {
+            &self.uncompiled
+        };
+        counter.fetch_add(1, Ordering::Relaxed);
+        self.programs.insert(
+            root,
+            CachedProgram {
+                revision,
+                program: program.clone(),
+            },
+        );
+        program
+    }
+
+    /// Drop every program, e.g. when constants folded into them go stale.
+    pub(crate) fn clear(&self) {
+        self.programs.clear();
+    }
+
+    pub(crate) fn note_vm_eval(&self) {
+        self.vm_evals.fetch_add(1, Ordering::Relaxed);
+    }
+
+    pub(crate) fn note_tree_eval(&self) {
+        self.tree_evals.fetch_add(1, Ordering::Relaxed);
+    }
+
+    pub(crate) fn stats(&self) -> BytecodeStats {
+        let (mut binary_sites, mut generic_binary_sites) = (0, 0);
+        for entry in self.programs.iter() {
+            if let Some(program) = &entry.program {
+                binary_sites += program.feedback.len() as u64;
+                generic_binary_sites += program.generic_sites() as u64;
+            }
+        }
+        BytecodeStats {
+            compiled: self.compiled.load(Ordering::Relaxed),
+            uncompiled: self.uncompiled.load(Ordering::Relaxed),
+            vm_evals: self.vm_evals.load(Ordering::Relaxed),
+            tree_evals: self.tree_evals.load(Ordering::Relaxed),
+            binary_sites,
+            generic_binary_sites,
+        }
+    }
+}
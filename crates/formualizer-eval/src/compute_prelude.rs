@@ -5,6 +5,7 @@ pub use arrow_cast::cast::cast_with_options;
 
 pub use arrow_select::concat::concat as concat_arrays;
 pub use arrow_select::filter::filter as filter_array;
+pub use arrow_select::take::take as take_array;
 pub use arrow_select::zip::zip as zip_select;
 
 pub use arrow_array::ArrayRef;
@@ -3,6 +3,7 @@ pub mod ast;
 pub(crate) mod canonical;
 pub mod data_store;
 pub mod error_arena;
+pub(crate) mod image;
 /// Arena-based storage for values and AST nodes
 /// Phase 1 of the SoA implementation plan
 pub mod scalar;
@@ -14,7 +15,7 @@ pub use array::{ArrayArena, ArrayRef};
 pub use ast::{AstArena, AstNodeData, AstNodeId, CompactRefType, SheetKey};
 #[allow(unused_imports)]
 pub(crate) use ast::{AstNodeEntry, AstNodeMetadata, CanonicalLabels};
-pub use data_store::{DataStore, DataStoreStats};
+pub use data_store::{DataStore, DataStoreStats, RangeMaterializationStats};
 pub use error_arena::{ErrorArena, ErrorRef};
 pub use scalar::{ScalarArena, ScalarRef};
 pub use string_interner::{StringId, StringInterner};
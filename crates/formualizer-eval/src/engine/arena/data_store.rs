@@ -6,11 +6,14 @@ use super::error_arena::{ErrorArena, ErrorRef};
 use super::scalar::ScalarArena;
 use super::string_interner::{StringId, StringInterner};
 use super::value_ref::ValueRef;
+use crate::engine::const_fold::ConstantIndex;
+use crate::engine::cse::SubexpressionIndex;
 use crate::engine::sheet_registry::SheetRegistry;
 use formualizer_common::{ExcelError, ExcelErrorKind, LiteralValue};
 use formualizer_parse::parser::{
     ASTNode, ASTNodeType, ExternalBookRef, ExternalReference, ReferenceType, TableReference,
 };
+use std::sync::atomic::{AtomicU64, Ordering};
 
 /// Centralized data storage using arenas
 #[derive(Debug)]
@@ -29,6 +32,16 @@ pub struct DataStore {
 
     /// Error storage with message preservation
     errors: ErrorArena,
+
+    /// Occurrence counts of shareable AST subtrees (workbook-wide CSE)
+    subexpressions: SubexpressionIndex,
+
+    /// Values of constant subtrees folded at ingest
+    constants: ConstantIndex,
+
+    /// Range cells copied into owned values by `ArgumentHandle::range` and
+    /// `ArgumentHandle::lazy_values_owned`
+    materialized_cells: AtomicU64,
 }
 
 impl DataStore {
@@ -39,6 +52,9 @@ impl DataStore {
             arrays: ArrayArena::new(),
             asts: AstArena::new(),
             errors: ErrorArena::new(),
+            subexpressions: SubexpressionIndex::default(),
+            constants: ConstantIndex::default(),
+            materialized_cells: AtomicU64::new(0),
         }
     }
 
@@ -81,6 +97,9 @@ impl DataStore {
             arrays: ArrayArena::with_capacity(estimated_cells / 100),
             asts: AstArena::with_capacity(estimated_cells / 2),
             errors: ErrorArena::with_capacity(estimated_cells / 20),
+            subexpressions: SubexpressionIndex::default(),
+            constants: ConstantIndex::default(),
+            materialized_cells: AtomicU64::new(0),
         }
     }
 
@@ -341,6 +360,39 @@ impl DataStore {
         self.asts.get_array_elements_info(id)
     }
 
+    pub fn subexpressions(&self) -> &SubexpressionIndex {
+        &self.subexpressions
+    }
+
+    pub(crate) fn subexpressions_mut(&mut self) -> &mut SubexpressionIndex {
+        &mut self.subexpressions
+    }
+
+    pub fn constants(&self) -> &ConstantIndex {
+        &self.constants
+    }
+
+    pub(crate) fn constants_mut(&mut self) -> &mut ConstantIndex {
+        &mut self.constants
+    }
+
+    pub(crate) fn asts_mut(&mut self) -> &mut AstArena {
+        &mut self.asts
+    }
+
+    /// Record range cells a builtin copied into owned values.
+    pub fn note_materialized_cells(&self, cells: usize) {
+        if cells > 0 {
+            self.materialized_cells
+                .fetch_add(cells as u64, Ordering::Relaxed);
+        }
+    }
+
+    /// Range cells copied into owned values since the store was created.
+    pub fn materialized_cells(&self) -> u64 {
+        self.materialized_cells.load(Ordering::Relaxed)
+    }
+
     pub fn ast_needs_structural_rewrite(&self, id: AstNodeId) -> bool {
         let mut stack = vec![id];
         while let Some(node_id) = stack.pop() {
@@ -867,6 +919,8 @@ impl DataStore {
         self.arrays.clear();
         self.asts.clear();
         self.errors.clear();
+        self.subexpressions.clear();
+        self.constants.clear();
     }
 }
 
@@ -891,6 +945,16 @@ pub struct DataStoreStats {
     pub total_errors: usize,
 }
 
+/// Range cells copied into owned values by builtins (see
+/// `Engine::range_materialization_stats`).
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct RangeMaterializationStats {
+    /// Cells copied since the engine was created.
+    pub total_cells: u64,
+    /// Cells copied since the start of the most recent evaluation request.
+    pub last_recalc_cells: u64,
+}
+
 impl DataStoreStats {
     pub fn total_bytes(&self) -> usize {
         self.scalar_bytes + self.string_bytes + self.array_bytes + self.ast_bytes + self.error_bytes
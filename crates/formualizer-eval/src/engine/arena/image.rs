@@ -0,0 +1,709 @@
+//! Conversion between the AST arena and the engine-independent image stored in
+//! snapshots ([`SnapshotFormulas`]).
+//!
+//! Arena ids, string ids and sheet ids only mean something inside one engine, so the
+//! writer renumbers every reachable node in post-order and names strings and sheets
+//! through a string table; the reader inserts the nodes back in that order. Neither side
+//! goes through `ASTNode`, so a snapshot restores formulas without parsing them.
+
+use formualizer_common::{ExcelError, ExcelErrorKind, LiteralValue};
+use rustc_hash::FxHashMap;
+
+use super::ast::{AstNodeData, AstNodeId, CompactRefType, SheetKey};
+use super::data_store::DataStore;
+use crate::arrow_store::snapshot::{SnapshotAstNode, SnapshotFormulas, SnapshotReference};
+use crate::engine::sheet_registry::SheetRegistry;
+
+/// Collects arena nodes into a [`SnapshotFormulas`] image.
+pub(crate) struct ArenaImageWriter<'a> {
+    data_store: &'a DataStore,
+    sheet_registry: &'a SheetRegistry,
+    strings: Vec<String>,
+    string_ids: FxHashMap<String, u32>,
+    nodes: Vec<SnapshotAstNode>,
+    /// Image index of each exported arena node; `None` when the subtree cannot be
+    /// represented (table and external-workbook references, array-valued literals).
+    exported: FxHashMap<AstNodeId, Option<u32>>,
+}
+
+impl<'a> ArenaImageWriter<'a> {
+    pub(crate) fn new(data_store: &'a DataStore, sheet_registry: &'a SheetRegistry) -> Self {
+        Self {
+            data_store,
+            sheet_registry,
+            strings: Vec::new(),
+            string_ids: FxHashMap::default(),
+            nodes: Vec::new(),
+            exported: FxHashMap::default(),
+        }
+    }
+
+    /// Export the subtree rooted at `id`, returning its image index. Shared subtrees are
+    /// written once.
+    pub(crate) fn node(&mut self, id: AstNodeId) -> Option<u32> {
+        if let Some(&done) = self.exported.get(&id) {
+            return done;
+        }
+        let exported = self.convert(id);
+        self.exported.insert(id, exported);
+        exported
+    }
+
+    /// Export a span template with its literal slots replaced by one placement's binding,
+    /// using the slot order of `substitute_literal_slots_for_template_placement`. The
+    /// literal-free subtrees are shared with every other export.
+    pub(crate) fn node_with_literals(
+        &mut self,
+        id: AstNodeId,
+        binding: &[LiteralValue],
+    ) -> Option<u32> {
+        let mut next = 0usize;
+        self.bind(id, binding, &mut next)
+    }
+
+    /// Add a formula the image does not model, as text with a leading `=`.
+    pub(crate) fn text(&mut self, formula: String) -> u32 {
+        self.push(SnapshotAstNode::Text(formula))
+    }
+
+    pub(crate) fn finish(self) -> SnapshotFormulas {
+        SnapshotFormulas {
+            strings: self.strings,
+            nodes: self.nodes,
+            sheets: Vec::new(),
+        }
+    }
+
+    fn convert(&mut self, id: AstNodeId) -> Option<u32> {
+        let data_store = self.data_store;
+        let node = match data_store.get_node(id)? {
+            AstNodeData::Literal(value_ref) => match data_store.retrieve_value(*value_ref) {
+                LiteralValue::Array(_) => return None,
+                value => SnapshotAstNode::Literal(value),
+            },
+            AstNodeData::Reference {
+                original_id,
+                ref_type,
+            } => SnapshotAstNode::Reference {
+                original: self.string(data_store.resolve_ast_string(*original_id)),
+                reference: self.reference(ref_type)?,
+            },
+            AstNodeData::UnaryOp { op_id, expr_id } => SnapshotAstNode::Unary {
+                expr: self.node(*expr_id)?,
+                op: self.string(data_store.resolve_ast_string(*op_id)),
+            },
+            AstNodeData::BinaryOp {
+                op_id,
+                left_id,
+                right_id,
+            } => SnapshotAstNode::Binary {
+                left: self.node(*left_id)?,
+                right: self.node(*right_id)?,
+                op: self.string(data_store.resolve_ast_string(*op_id)),
+            },
+            AstNodeData::Function { name_id, .. } => {
+                let args = data_store
+                    .get_args(id)?
+                    .iter()
+                    .map(|&arg| self.node(arg))
+                    .collect::<Option<Vec<_>>>()?;
+                SnapshotAstNode::Function {
+                    name: self.string(data_store.resolve_ast_string(*name_id)),
+                    args,
+                }
+            }
+            AstNodeData::Array { .. } => {
+                let (rows, cols, elements) = data_store.get_array_elems(id)?;
+                let elements = elements
+                    .iter()
+                    .map(|&element| self.node(element))
+                    .collect::<Option<Vec<_>>>()?;
+                SnapshotAstNode::Array {
+                    rows,
+                    cols,
+                    elements,
+                }
+            }
+        };
+        Some(self.push(node))
+    }
+
+    fn bind(&mut self, id: AstNodeId, binding: &[LiteralValue], next: &mut usize) -> Option<u32> {
+        let data_store = self.data_store;
+        let node = match data_store.get_node(id)? {
+            AstNodeData::Literal(_) => {
+                let value = binding.get(*next).cloned().unwrap_or(LiteralValue::Empty);
+                *next = next.saturating_add(1);
+                if matches!(value, LiteralValue::Array(_)) {
+                    return None;
+                }
+                SnapshotAstNode::Literal(value)
+            }
+            // Literals inside array constants are not slots.
+            AstNodeData::Reference { .. } | AstNodeData::Array { .. } => return self.node(id),
+            AstNodeData::UnaryOp { op_id, expr_id } => SnapshotAstNode::Unary {
+                expr: self.bind(*expr_id, binding, next)?,
+                op: self.string(data_store.resolve_ast_string(*op_id)),
+            },
+            AstNodeData::BinaryOp {
+                op_id,
+                left_id,
+                right_id,
+            } => SnapshotAstNode::Binary {
+                left: self.bind(*left_id, binding, next)?,
+                right: self.bind(*right_id, binding, next)?,
+                op: self.string(data_store.resolve_ast_string(*op_id)),
+            },
+            AstNodeData::Function { name_id, .. } => {
+                let args = data_store
+                    .get_args(id)?
+                    .iter()
+                    .map(|&arg| self.bind(arg, binding, next))
+                    .collect::<Option<Vec<_>>>()?;
+                SnapshotAstNode::Function {
+                    name: self.string(data_store.resolve_ast_string(*name_id)),
+                    args,
+                }
+            }
+        };
+        Some(self.push(node))
+    }
+
+    fn reference(&mut self, ref_type: &CompactRefType) -> Option<SnapshotReference> {
+        let data_store = self.data_store;
+        Some(match *ref_type {
+            CompactRefType::Cell {
+                sheet,
+                row,
+                col,
+                row_abs,
+                col_abs,
+            } => SnapshotReference::Cell {
+                sheet: sheet.map(|sheet| self.sheet(sheet)),
+                row,
+                col,
+                row_abs,
+                col_abs,
+            },
+            CompactRefType::Range {
+                sheet,
+                start_row,
+                start_col,
+                end_row,
+                end_col,
+                start_row_abs,
+                start_col_abs,
+                end_row_abs,
+                end_col_abs,
+            } => SnapshotReference::Range {
+                sheet: sheet.map(|sheet| self.sheet(sheet)),
+                start_row,
+                start_col,
+                end_row,
+                end_col,
+                abs: [start_row_abs, start_col_abs, end_row_abs, end_col_abs],
+            },
+            CompactRefType::NamedRange(name) => {
+                SnapshotReference::Named(self.string(data_store.resolve_ast_string(name)))
+            }
+            CompactRefType::Cell3D {
+                sheet_first,
+                sheet_last,
+                row,
+                col,
+                row_abs,
+                col_abs,
+            } => SnapshotReference::Cell3D {
+                sheet_first: self.string(data_store.resolve_ast_string(sheet_first)),
+                sheet_last: self.string(data_store.resolve_ast_string(sheet_last)),
+                row,
+                col,
+                row_abs,
+                col_abs,
+            },
+            CompactRefType::Range3D {
+                sheet_first,
+                sheet_last,
+                start_row,
+                start_col,
+                end_row,
+                end_col,
+                start_row_abs,
+                start_col_abs,
+                end_row_abs,
+                end_col_abs,
+            } => SnapshotReference::Range3D {
+                sheet_first: self.string(data_store.resolve_ast_string(sheet_first)),
+                sheet_last: self.string(data_store.resolve_ast_string(sheet_last)),
+                start_row,
+                start_col,
+                end_row,
+                end_col,
+                abs: [start_row_abs, start_col_abs, end_row_abs, end_col_abs],
+            },
+            CompactRefType::External { .. } | CompactRefType::Table { .. } => return None,
+        })
+    }
+
+    fn sheet(&mut self, sheet: SheetKey) -> u32 {
+        let (data_store, sheet_registry) = (self.data_store, self.sheet_registry);
+        match sheet {
+            SheetKey::Id(id) => self.string(sheet_registry.name(id)),
+            SheetKey::Name(name) => self.string(data_store.resolve_ast_string(name)),
+        }
+    }
+
+    fn string(&mut self, s: &str) -> u32 {
+        if let Some(&id) = self.string_ids.get(s) {
+            return id;
+        }
+        let id = self.strings.len() as u32;
+        self.strings.push(s.to_string());
+        self.string_ids.insert(s.to_string(), id);
+        id
+    }
+
+    fn push(&mut self, node: SnapshotAstNode) -> u32 {
+        self.nodes.push(node);
+        (self.nodes.len() - 1) as u32
+    }
+}
+
+/// Arena ids of the nodes of an imported image.
+pub(crate) struct ArenaImageReader {
+    /// `None` for [`SnapshotAstNode::Text`] nodes.
+    nodes: Vec<Option<AstNodeId>>,
+}
+
+impl ArenaImageReader {
+    /// Insert every node of `image` into the arena. Sheet names resolve against
+    /// `sheet_registry` the same way `DataStore::store_ast` resolves them.
+    pub(crate) fn import(
+        data_store: &mut DataStore,
+        sheet_registry: &SheetRegistry,
+        image: &SnapshotFormulas,
+    ) -> Result<Self, ExcelError> {
+        let mut nodes: Vec<Option<AstNodeId>> = Vec::with_capacity(image.nodes.len());
+        let string = |idx: u32| {
+            image
+                .strings
+                .get(idx as usize)
+                .map(String::as_str)
+                .ok_or_else(malformed_image)
+        };
+        for node in &image.nodes {
+            // Children always precede their parents, so this only looks backwards.
+            let child = |idx: u32| nodes.get(idx as usize).copied().flatten();
+            let child = |idx: u32| child(idx).ok_or_else(malformed_image);
+            let id = match node {
+                SnapshotAstNode::Literal(value) => {
+                    let value_ref = data_store.store_value(value.clone());
+                    data_store.asts_mut().insert_literal(value_ref)
+                }
+                SnapshotAstNode::Reference {
+                    original,
+                    reference,
+                } => {
+                    let ref_type = import_reference(data_store, sheet_registry, reference, string)?;
+                    data_store
+                        .asts_mut()
+                        .insert_reference(string(*original)?, ref_type)
+                }
+                SnapshotAstNode::Unary { op, expr } => {
+                    let expr = child(*expr)?;
+                    data_store.asts_mut().insert_unary_op(string(*op)?, expr)
+                }
+                SnapshotAstNode::Binary { op, left, right } => {
+                    let (left, right) = (child(*left)?, child(*right)?);
+                    data_store
+                        .asts_mut()
+                        .insert_binary_op(string(*op)?, left, right)
+                }
+                SnapshotAstNode::Function { name, args } => {
+                    let args = args
+                        .iter()
+                        .map(|&arg| child(arg))
+                        .collect::<Result<Vec<_>, _>>()?;
+                    data_store.asts_mut().insert_function(string(*name)?, args)
+                }
+                SnapshotAstNode::Array {
+                    rows,
+                    cols,
+                    elements,
+                } => {
+                    if elements.len() != usize::from(*rows) * usize::from(*cols) {
+                        return Err(malformed_image());
+                    }
+                    let elements = elements
+                        .iter()
+                        .map(|&element| child(element))
+                        .collect::<Result<Vec<_>, _>>()?;
+                    data_store.asts_mut().insert_array(*rows, *cols, elements)
+                }
+                SnapshotAstNode::Text(_) => {
+                    nodes.push(None);
+                    continue;
+                }
+            };
+            nodes.push(Some(id));
+        }
+        Ok(Self { nodes })
+    }
+
+    /// Arena id of image node `idx`. Text nodes have none; callers parse those instead.
+    pub(crate) fn root(&self, idx: u32) -> Result<AstNodeId, ExcelError> {
+        self.nodes
+            .get(idx as usize)
+            .copied()
+            .flatten()
+            .ok_or_else(malformed_image)
+    }
+}
+
+fn import_reference<'s>(
+    data_store: &mut DataStore,
+    sheet_registry: &SheetRegistry,
+    reference: &SnapshotReference,
+    string: impl Fn(u32) -> Result<&'s str, ExcelError>,
+) -> Result<CompactRefType, ExcelError> {
+    let mut sheet = |idx: Option<u32>| -> Result<Option<SheetKey>, ExcelError> {
+        let Some(idx) = idx else {
+            return Ok(None);
+        };
+        let name = string(idx)?;
+        Ok(Some(match sheet_registry.get_id(name) {
+            Some(id) => SheetKey::Id(id),
+            None => SheetKey::Name(data_store.asts_mut().strings_mut().intern(name)),
+        }))
+    };
+    Ok(match *reference {
+        SnapshotReference::Cell {
+            sheet: sheet_idx,
+            row,
+            col,
+            row_abs,
+            col_abs,
+        } => CompactRefType::Cell {
+            sheet: sheet(sheet_idx)?,
+            row,
+            col,
+            row_abs,
+            col_abs,
+        },
+        SnapshotReference::Range {
+            sheet: sheet_idx,
+            start_row,
+            start_col,
+            end_row,
+            end_col,
+            abs: [start_row_abs, start_col_abs, end_row_abs, end_col_abs],
+        } => CompactRefType::Range {
+            sheet: sheet(sheet_idx)?,
+            start_row,
+            start_col,
+            end_row,
+            end_col,
+            start_row_abs,
+            start_col_abs,
+            end_row_abs,
+            end_col_abs,
+        },
+        SnapshotReference::Named(name) => {
+            CompactRefType::NamedRange(data_store.asts_mut().strings_mut().intern(string(name)?))
+        }
+        SnapshotReference::Cell3D {
+            sheet_first,
+            sheet_last,
+            row,
+            col,
+            row_abs,
+            col_abs,
+        } => {
+            let strings = data_store.asts_mut().strings_mut();
+            CompactRefType::Cell3D {
+                sheet_first: strings.intern(string(sheet_first)?),
+                sheet_last: strings.intern(string(sheet_last)?),
+                row,
+                col,
+                row_abs,
+                col_abs,
+            }
+        }
+        SnapshotReference::Range3D {
+            sheet_first,
+            sheet_last,
+            start_row,
+            start_col,
+            end_row,
+            end_col,
+            abs: [start_row_abs, start_col_abs, end_row_abs, end_col_abs],
+        } => {
+            let strings = data_store.asts_mut().strings_mut();
+            CompactRefType::Range3D {
+                sheet_first: strings.intern(string(sheet_first)?),
+                sheet_last: strings.intern(string(sheet_last)?),
+                start_row,
+                start_col,
+                end_row,
+                end_col,
+                start_row_abs,
+                start_col_abs,
+                end_row_abs,
+                end_col_abs,
+            }
+        }
+    })
+}
+
+/// Shift the relative references of the formula rooted at `id` by a placement offset,
+/// inserting new nodes only along the paths that change. Mirrors
+/// `relocate_ast_for_template_placement` on the arena: absolute axes and unbounded range
+/// edges stay put, and table, 3D and external references cannot be relocated.
+pub(crate) fn relocate(
+    data_store: &mut DataStore,
+    id: AstNodeId,
+    row_delta: i64,
+    col_delta: i64,
+) -> Result<AstNodeId, ExcelError> {
+    if row_delta == 0 && col_delta == 0 {
+        return Ok(id);
+    }
+    let mut moved = FxHashMap::default();
+    relocate_node(data_store, id, row_delta, col_delta, &mut moved)
+}
+
+fn relocate_node(
+    data_store: &mut DataStore,
+    id: AstNodeId,
+    row_delta: i64,
+    col_delta: i64,
+    moved: &mut FxHashMap<AstNodeId, AstNodeId>,
+) -> Result<AstNodeId, ExcelError> {
+    if let Some(&done) = moved.get(&id) {
+        return Ok(done);
+    }
+    let mut relocate_all =
+        |data_store: &mut DataStore, ids: Vec<AstNodeId>| -> Result<_, ExcelError> {
+            let shifted = ids
+                .iter()
+                .map(|&child| relocate_node(data_store, child, row_delta, col_delta, moved))
+                .collect::<Result<Vec<_>, _>>()?;
+            Ok((shifted != ids).then_some(shifted))
+        };
+    let node = data_store
+        .get_node(id)
+        .cloned()
+        .ok_or_else(malformed_image)?;
+    let relocated = match node {
+        AstNodeData::Literal(_) => id,
+        AstNodeData::Reference {
+            original_id,
+            ref_type,
+        } => {
+            let shifted = relocate_reference(ref_type, row_delta, col_delta)?;
+            if shifted == ref_type {
+                id
+            } else {
+                data_store.asts_mut().insert(AstNodeData::Reference {
+                    original_id,
+                    ref_type: shifted,
+                })
+            }
+        }
+        AstNodeData::UnaryOp { op_id, expr_id } => match relocate_all(data_store, vec![expr_id])? {
+            Some(expr) => data_store.asts_mut().insert(AstNodeData::UnaryOp {
+                op_id,
+                expr_id: expr[0],
+            }),
+            None => id,
+        },
+        AstNodeData::BinaryOp {
+            op_id,
+            left_id,
+            right_id,
+        } => match relocate_all(data_store, vec![left_id, right_id])? {
+            Some(sides) => data_store.asts_mut().insert(AstNodeData::BinaryOp {
+                op_id,
+                left_id: sides[0],
+                right_id: sides[1],
+            }),
+            None => id,
+        },
+        AstNodeData::Function { name_id, .. } => {
+            let args = data_store.get_args(id).unwrap_or_default().to_vec();
+            match relocate_all(data_store, args)? {
+                Some(args) => {
+                    let name = data_store.resolve_ast_string(name_id).to_string();
+                    data_store.asts_mut().insert_function(&name, args)
+                }
+                None => id,
+            }
+        }
+        AstNodeData::Array { rows, cols, .. } => {
+            let elements = data_store
+                .get_array_elems(id)
+                .map(|(_, _, elements)| elements.to_vec())
+                .unwrap_or_default();
+            match relocate_all(data_store, elements)? {
+                Some(elements) => data_store.asts_mut().insert_array(rows, cols, elements),
+                None => id,
+            }
+        }
+    };
+    moved.insert(id, relocated);
+    Ok(relocated)
+}
+
+fn relocate_reference(
+    ref_type: CompactRefType,
+    row_delta: i64,
+    col_delta: i64,
+) -> Result<CompactRefType, ExcelError> {
+    match ref_type {
+        CompactRefType::Cell {
+            sheet,
+            row,
+            col,
+            row_abs,
+            col_abs,
+        } => Ok(CompactRefType::Cell {
+            sheet,
+            row: shift_axis(row, row_delta, row_abs)?,
+            col: shift_axis(col, col_delta, col_abs)?,
+            row_abs,
+            col_abs,
+        }),
+        CompactRefType::Range {
+            sheet,
+            start_row,
+            start_col,
+            end_row,
+            end_col,
+            start_row_abs,
+            start_col_abs,
+            end_row_abs,
+            end_col_abs,
+        } => Ok(CompactRefType::Range {
+            sheet,
+            start_row: shift_bound(start_row, 0, row_delta, start_row_abs)?,
+            start_col: shift_bound(start_col, 0, col_delta, start_col_abs)?,
+            end_row: shift_bound(end_row, u32::MAX, row_delta, end_row_abs)?,
+            end_col: shift_bound(end_col, u32::MAX, col_delta, end_col_abs)?,
+            start_row_abs,
+            start_col_abs,
+            end_row_abs,
+            end_col_abs,
+        }),
+        CompactRefType::NamedRange(_) => Ok(ref_type),
+        CompactRefType::External { .. }
+        | CompactRefType::Table { .. }
+        | CompactRefType::Cell3D { .. }
+        | CompactRefType::Range3D { .. } => Err(unsupported_relocation()),
+    }
+}
+
+/// Shift a range edge, leaving the unbounded sentinel alone.
+fn shift_bound(
+    value: u32,
+    unbounded: u32,
+    delta: i64,
+    is_absolute: bool,
+) -> Result<u32, ExcelError> {
+    if value == unbounded {
+        return Ok(value);
+    }
+    shift_axis(value, delta, is_absolute)
+}
+
+fn shift_axis(value: u32, delta: i64, is_absolute: bool) -> Result<u32, ExcelError> {
+    if is_absolute {
+        return Ok(value);
+    }
+    let shifted = i64::from(value) + delta;
+    if shifted < 1 || shifted > i64::from(u32::MAX) {
+        return Err(unsupported_relocation());
+    }
+    Ok(shifted as u32)
+}
+
+fn unsupported_relocation() -> ExcelError {
+    ExcelError::new(ExcelErrorKind::Ref).with_message("Unsupported reference relocation")
+}
+
+fn malformed_image() -> ExcelError {
+    ExcelError::new(ExcelErrorKind::Value).with_message("Malformed formula image in snapshot")
+}
+
+#[cfg(test)]
+mod tests {
+    use formualizer_parse::parser::parse;
+    use formualizer_parse::pretty::canonical_formula;
+
+    use super::*;
+
+    fn round_trip(formula: &str) -> String {
+        let mut registry = SheetRegistry::new();
+        registry.id_for("Sheet1");
+        registry.id_for("Data");
+        let mut source = DataStore::new();
+        let root = source.store_ast(&parse(formula).unwrap(), &registry);
+        let mut writer = ArenaImageWriter::new(&source, &registry);
+        let idx = writer.node(root).expect("formula has an image");
+        let image = writer.finish();
+
+        // A fresh registry with the sheets in another order: ids must not leak through.
+        let mut other = SheetRegistry::new();
+        other.id_for("Data");
+        other.id_for("Sheet1");
+        let mut target = DataStore::new();
+        let reader = ArenaImageReader::import(&mut target, &other, &image).unwrap();
+        let id = reader.root(idx).unwrap();
+        canonical_formula(&target.retrieve_ast(id, &other).unwrap())
+    }
+
+    #[test]
+    fn images_round_trip_without_parsing() {
+        for formula in [
+            "=SUM(Data!A1:B10)*2+A$1",
+            "=IF(-A1>0,\"yes\",{1,2;3,4})",
+            "=SUM(A:A)+MyName+#DIV/0!",
+        ] {
+            let expected = canonical_formula(&parse(formula).unwrap());
+            assert_eq!(round_trip(formula), expected, "{formula}");
+        }
+    }
+
+    #[test]
+    fn literal_bindings_replace_slots_outside_arrays() {
+        let registry = SheetRegistry::new();
+        let mut source = DataStore::new();
+        let root = source.store_ast(&parse("=A1*1+SUM({1,2})-\"x\"").unwrap(), &registry);
+        let mut writer = ArenaImageWriter::new(&source, &registry);
+        let binding = [LiteralValue::Int(7), LiteralValue::Text("y".into())];
+        let idx = writer.node_with_literals(root, &binding).unwrap();
+        let image = writer.finish();
+
+        let mut target = DataStore::new();
+        let reader = ArenaImageReader::import(&mut target, &registry, &image).unwrap();
+        let id = reader.root(idx).unwrap();
+        assert_eq!(
+            canonical_formula(&target.retrieve_ast(id, &registry).unwrap()),
+            canonical_formula(&parse("=A1*7+SUM({1,2})-\"y\"").unwrap())
+        );
+    }
+
+    #[test]
+    fn relocation_shifts_relative_axes_only() {
+        let registry = SheetRegistry::new();
+        let mut store = DataStore::new();
+        let root = store.store_ast(&parse("=A1+$A1+SUM(B:B)+C1:D$5").unwrap(), &registry);
+        let moved = relocate(&mut store, root, 2, 1).unwrap();
+        let expected = canonical_formula(&parse("=B3+$A3+SUM(C:C)+D3:E$5").unwrap());
+        assert_eq!(
+            canonical_formula(&store.retrieve_ast(moved, &registry).unwrap()),
+            expected
+        );
+        assert_eq!(relocate(&mut store, root, 0, 0).unwrap(), root);
+        assert!(relocate(&mut store, root, -1, 0).is_err());
+    }
+}
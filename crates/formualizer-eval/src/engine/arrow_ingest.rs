@@ -120,7 +120,7 @@ impl<'e, R: EvaluationContext> ArrowBulkUpdateBuilder<'e, R> {
                     let Some(ch) = sheet.ensure_column_chunk_mut(col0, ch_idx) else {
                         continue;
                     };
-                    let len = ch.type_tag.len();
+                    let len = ch.len();
                     // heuristic: rebuild if > 2% or > 1024 updates in this chunk
                     let rebuild = items.len() > len / 50 || items.len() > 1024;
                     if !rebuild {
@@ -200,6 +200,8 @@ impl<'e, R: EvaluationContext> ArrowBulkUpdateBuilder<'e, R> {
                             };
                             let val = if let Some(v) = upd {
                                 v
+                            } else if let Some(value) = ch.run_value_at(i) {
+                                value.to_literal_for(date_system)
                             } else {
                                 // read from base tag/lane
                                 let t = crate::arrow_store::TypeTag::from_u8(ch.type_tag.value(i));
@@ -277,21 +279,10 @@ impl<'e, R: EvaluationContext> ArrowBulkUpdateBuilder<'e, R> {
                                             LiteralValue::Empty
                                         }
                                     }
-                                    crate::arrow_store::TypeTag::Text => {
-                                        if let Some(a) = &ch.text {
-                                            let sa = a
-                                                .as_any()
-                                                .downcast_ref::<arrow_array::StringArray>()
-                                                .unwrap();
-                                            if sa.is_null(i) {
-                                                LiteralValue::Empty
-                                            } else {
-                                                LiteralValue::Text(sa.value(i).to_string())
-                                            }
-                                        } else {
-                                            LiteralValue::Empty
-                                        }
-                                    }
+                                    crate::arrow_store::TypeTag::Text => ch
+                                        .text_at(i)
+                                        .map(|s| LiteralValue::Text(s.to_string()))
+                                        .unwrap_or(LiteralValue::Empty),
                                     crate::arrow_store::TypeTag::Error => {
                                         if let Some(a) = &ch.errors {
                                             let ea = a
@@ -424,7 +415,8 @@ impl<'e, R: EvaluationContext> ArrowBulkUpdateBuilder<'e, R> {
                                 }
                             }
                         }
-                        ch.type_tag = Arc::new(tag_b.finish());
+                        ch.type_tag = crate::arrow_store::share_uniform_tags(tag_b.finish());
+                        ch.runs = None;
                         ch.numbers = if non_num == 0 {
                             None
                         } else {
@@ -435,11 +427,11 @@ impl<'e, R: EvaluationContext> ArrowBulkUpdateBuilder<'e, R> {
                         } else {
                             Some(Arc::new(bb.finish()))
                         };
-                        ch.text = if non_text == 0 {
+                        ch.set_text_lane(if non_text == 0 {
                             None
                         } else {
                             Some(Arc::new(sb.finish()))
-                        };
+                        });
                         ch.errors = if non_err == 0 {
                             None
                         } else {
@@ -450,6 +442,7 @@ impl<'e, R: EvaluationContext> ArrowBulkUpdateBuilder<'e, R> {
                         ch.meta.non_null_bool = non_bool;
                         ch.meta.non_null_text = non_text;
                         ch.meta.non_null_err = non_err;
+                        ch.refresh_zone_map();
                         let _ = ch.overlay.clear();
                     }
                 }
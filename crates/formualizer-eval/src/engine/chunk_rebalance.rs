@@ -0,0 +1,86 @@
+//! Background chunk rebalancing (`EvalConfig::adaptive_chunk_rebalancing`).
+//!
+//! At each evaluation boundary the engine installs rebalances that finished since the
+//! previous boundary, then checks every sheet's chunk lengths against its
+//! `ArrowSheet::target_chunk_rows`. Sheets with chunks out of range get a
+//! `RebalanceJob` that builds the merged chunks on the engine thread pool while
+//! evaluation goes on. Installing checks that the sheet's layout and the merged base
+//! lanes are unchanged; a stale rebalance is dropped and planned again from the current
+//! layout at the next boundary.
+
+use std::sync::{Arc, Mutex};
+
+use rustc_hash::FxHashSet;
+
+use crate::arrow_store::{RebalancedChunks, SheetStore};
+
+/// Counters for background chunk rebalancing.
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct ChunkRebalanceStats {
+    /// Rebalances started from a snapshot.
+    pub started: u64,
+    /// Rebalances swapped into their sheet.
+    pub installed: u64,
+    /// Rebalances dropped because the sheet's layout or base lanes changed first.
+    pub discarded: u64,
+}
+
+#[derive(Default)]
+pub(crate) struct ChunkRebalancer {
+    in_flight: FxHashSet<Arc<str>>,
+    finished: Arc<Mutex<Vec<RebalancedChunks>>>,
+    stats: ChunkRebalanceStats,
+}
+
+impl ChunkRebalancer {
+    #[inline]
+    pub(crate) fn stats(&self) -> ChunkRebalanceStats {
+        self.stats
+    }
+
+    /// Swap finished rebalances into their sheets. Returns the change in computed-overlay
+    /// bytes.
+    pub(crate) fn install_finished(&mut self, sheets: &mut SheetStore) -> isize {
+        let finished = std::mem::take(&mut *self.finished.lock().unwrap());
+        let mut computed_delta = 0isize;
+        for done in finished {
+            self.in_flight.remove(done.sheet());
+            let installed = sheets
+                .sheet_mut(done.sheet())
+                .and_then(|sheet| sheet.install_rebalanced(done));
+            match installed {
+                Some(delta) => {
+                    self.stats.installed += 1;
+                    computed_delta = computed_delta.saturating_add(delta);
+                }
+                None => self.stats.discarded += 1,
+            }
+        }
+        computed_delta
+    }
+
+    /// Start a rebalance for every unbalanced sheet without one in flight: on `pool` when
+    /// given, otherwise on the calling thread, in which case it finishes before this
+    /// returns.
+    pub(crate) fn dispatch(&mut self, sheets: &SheetStore, pool: Option<&rayon::ThreadPool>) {
+        for sheet in &sheets.sheets {
+            if self.in_flight.contains(&sheet.name) {
+                continue;
+            }
+            let Some(job) = sheet.rebalance_job(sheet.target_chunk_rows()) else {
+                continue;
+            };
+            self.in_flight.insert(sheet.name.clone());
+            self.stats.started += 1;
+            let finished = Arc::clone(&self.finished);
+            let job = move || {
+                let done = job.run();
+                finished.lock().unwrap().push(done);
+            };
+            match pool {
+                Some(pool) => pool.spawn(job),
+                None => job(),
+            }
+        }
+    }
+}
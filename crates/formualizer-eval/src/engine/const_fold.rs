@@ -0,0 +1,427 @@
+//! Ahead-of-time constant folding of interned formula ASTs.
+//!
+//! Imported workbooks are full of constant subexpressions, such as the rate
+//! factor in `=A1*(1+0.05/12)^12`, and of inline arrays like `{1,2,3}` that
+//! the interpreter would otherwise rebuild from their element nodes on every
+//! evaluation. At ingest, [`fold_constants`] finds the largest subtrees of a
+//! formula built only from literals, value operators, and calls to pure
+//! functions of their arguments alone. It evaluates each once and records the
+//! value in the [`ConstantIndex`] kept by the [`DataStore`]. Because the
+//! arena hash-conses subtrees, a constant shared by many formulas is folded
+//! once. Array values are kept as shared immutable [`RangeView`]s, so every
+//! evaluation hands out the same Arrow-backed array instead of a fresh one.
+//!
+//! The arena itself is not rewritten. Formula text, canonical templates and
+//! literal slots keep seeing the original tree. Folding runs under the
+//! engine's date system and locale, and values folded under other settings
+//! are ignored. The engine drops the index when the function registry
+//! changes. Evaluations with bound template literal slots never consult it.
+
+use std::sync::Arc;
+use std::sync::atomic::{AtomicU64, Ordering};
+
+use formualizer_common::{DateSystem, ExcelError, ExcelErrorKind, LiteralValue};
+use formualizer_parse::parser::TableReference;
+use rustc_hash::FxHashMap;
+
+use crate::engine::arena::{AstNodeData, AstNodeId, DataStore};
+use crate::engine::range_view::RangeView;
+use crate::engine::sheet_registry::SheetRegistry;
+use crate::function::Function;
+use crate::function_contract::FunctionContextDependence;
+use crate::interpreter::Interpreter;
+use crate::locale::Locale;
+use crate::traits::{
+    CalcValue, EvaluationContext, FunctionProvider, NamedRangeResolver, Range, RangeResolver,
+    ReferenceResolver, Resolver, SourceResolver, Table, TableResolver,
+};
+
+/// Binary operators folded over constant operands. Reference operators
+/// (`:`, intersection, union) never are.
+const FOLDABLE_BINARY_OPS: &[&str] = &[
+    "+", "-", "*", "/", "^", "&", "=", "<>", "<", ">", "<=", ">=",
+];
+
+/// Unary operators folded over a constant operand; implicit intersection
+/// (`@`) is left to the interpreter.
+const FOLDABLE_UNARY_OPS: &[&str] = &["+", "-", "%"];
+
+/// Evaluation settings a folded value depends on.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub(crate) struct ConstantFoldSettings {
+    pub(crate) date_system: DateSystem,
+    pub(crate) locale: Locale,
+}
+
+impl ConstantFoldSettings {
+    /// Settings `context` evaluates under.
+    pub(crate) fn of(context: &(impl EvaluationContext + ?Sized)) -> Self {
+        Self {
+            date_system: context.date_system(),
+            locale: context.locale(),
+        }
+    }
+}
+
+/// The value of a folded subtree.
+#[derive(Debug, Clone)]
+pub(crate) enum FoldedConstant {
+    Scalar(LiteralValue),
+    /// An array shared by every evaluation of the subtree.
+    Array(RangeView<'static>),
+}
+
+impl FoldedConstant {
+    fn to_calc_value<'a>(&self) -> CalcValue<'a> {
+        match self {
+            FoldedConstant::Scalar(value) => CalcValue::Scalar(value.clone()),
+            FoldedConstant::Array(view) => CalcValue::Range(view.clone()),
+        }
+    }
+}
+
+/// Counters for the [`ConstantIndex`] (see `Engine::constant_fold_stats`).
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct ConstantFoldStats {
+    /// Subtrees folded to a value at ingest.
+    pub folded_nodes: u64,
+    /// Folded subtrees whose value is an array.
+    pub array_constants: u64,
+    /// Tree-walk evaluations answered by a folded value. Bytecode programs
+    /// take folded scalars into their constant pool once, when compiled.
+    pub reuses: u64,
+}
+
+/// Ingest-time values of constant subtrees, kept by the [`DataStore`]
+/// alongside the arena whose ids they cover.
+#[derive(Debug, Default)]
+pub struct ConstantIndex {
+    folded: FxHashMap<AstNodeId, FoldedConstant>,
+    /// Settings every entry was folded under.
+    settings: Option<ConstantFoldSettings>,
+    reuses: AtomicU64,
+}
+
+impl ConstantIndex {
+    #[inline]
+    pub(crate) fn is_empty(&self) -> bool {
+        self.folded.is_empty()
+    }
+
+    /// Folded value of `node`, when it was folded under `settings`.
+    #[inline]
+    pub(crate) fn get<'a>(
+        &self,
+        node: AstNodeId,
+        settings: ConstantFoldSettings,
+    ) -> Option<CalcValue<'a>> {
+        let folded = self.folded.get(&node)?;
+        if self.settings != Some(settings) {
+            return None;
+        }
+        self.reuses.fetch_add(1, Ordering::Relaxed);
+        Some(folded.to_calc_value())
+    }
+
+    /// Folded scalar value of `node`, for the bytecode constant pool.
+    pub(crate) fn scalar(
+        &self,
+        node: AstNodeId,
+        settings: ConstantFoldSettings,
+    ) -> Option<LiteralValue> {
+        if self.settings != Some(settings) {
+            return None;
+        }
+        match self.folded.get(&node)? {
+            FoldedConstant::Scalar(value) => Some(value.clone()),
+            FoldedConstant::Array(_) => None,
+        }
+    }
+
+    fn contains(&self, node: AstNodeId) -> bool {
+        self.folded.contains_key(&node)
+    }
+
+    fn insert(&mut self, node: AstNodeId, value: FoldedConstant, settings: ConstantFoldSettings) {
+        if self.settings != Some(settings) {
+            self.folded.clear();
+            self.settings = Some(settings);
+        }
+        self.folded.insert(node, value);
+    }
+
+    /// Folded nodes, in no particular order.
+    pub(crate) fn nodes(&self) -> impl Iterator<Item = AstNodeId> + '_ {
+        self.folded.keys().copied()
+    }
+
+    pub(crate) fn remove(&mut self, nodes: &[AstNodeId]) {
+        for node in nodes {
+            self.folded.remove(node);
+        }
+    }
+
+    pub(crate) fn clear(&mut self) {
+        self.folded.clear();
+        self.settings = None;
+    }
+
+    pub(crate) fn stats(&self) -> ConstantFoldStats {
+        ConstantFoldStats {
+            folded_nodes: self.folded.len() as u64,
+            array_constants: self
+                .folded
+                .values()
+                .filter(|value| matches!(value, FoldedConstant::Array(_)))
+                .count() as u64,
+            reuses: self.reuses.load(Ordering::Relaxed),
+        }
+    }
+}
+
+/// Fold every maximal constant subtree under `root` that is not folded yet.
+pub(crate) fn fold_constants(
+    root: AstNodeId,
+    sheet: &str,
+    data_store: &mut DataStore,
+    sheet_registry: &SheetRegistry,
+    functions: &dyn FunctionProvider,
+    settings: ConstantFoldSettings,
+) {
+    let mut found = Vec::new();
+    if visit(root, data_store, functions, &mut found) && !is_literal(root, data_store) {
+        found.push(root);
+    }
+    let settings_changed = data_store.constants().settings != Some(settings);
+    found.retain(|&node| settings_changed || !data_store.constants().contains(node));
+    if found.is_empty() {
+        return;
+    }
+
+    let context = FoldContext {
+        functions,
+        settings,
+    };
+    let interpreter = Interpreter::new(&context, sheet);
+    let values: Vec<_> = found
+        .into_iter()
+        .filter_map(|node| {
+            let value = match interpreter.evaluate_arena_ast(node, data_store, sheet_registry) {
+                Ok(CalcValue::Scalar(value)) => FoldedConstant::Scalar(value),
+                Ok(CalcValue::Range(view)) => FoldedConstant::Array(view.into_owned().ok()?),
+                // Runtime failures (not error values) are left to evaluation.
+                Ok(CalcValue::Callable(_)) | Err(_) => return None,
+            };
+            Some((node, value))
+        })
+        .collect();
+    let index = data_store.constants_mut();
+    for (node, value) in values {
+        index.insert(node, value, settings);
+    }
+}
+
+fn is_literal(node: AstNodeId, data_store: &DataStore) -> bool {
+    matches!(data_store.get_node(node), Some(AstNodeData::Literal(_)))
+}
+
+/// Whether `node` is constant. Constant, non-literal children of a node that
+/// is not constant itself are pushed onto `found`.
+fn visit(
+    node: AstNodeId,
+    data_store: &DataStore,
+    functions: &dyn FunctionProvider,
+    found: &mut Vec<AstNodeId>,
+) -> bool {
+    let Some(data) = data_store.get_node(node) else {
+        return false;
+    };
+    let mark = found.len();
+    let child = |child: AstNodeId, found: &mut Vec<AstNodeId>| {
+        let constant = visit(child, data_store, functions, found);
+        if constant && !is_literal(child, data_store) {
+            found.push(child);
+        }
+        constant
+    };
+    let constant = match data {
+        AstNodeData::Literal(_) => return true,
+        AstNodeData::Reference { .. } => return false,
+        AstNodeData::UnaryOp { op_id, expr_id } => {
+            child(*expr_id, found)
+                && FOLDABLE_UNARY_OPS.contains(&data_store.resolve_ast_string(*op_id))
+        }
+        AstNodeData::BinaryOp {
+            op_id,
+            left_id,
+            right_id,
+        } => {
+            let left = child(*left_id, found);
+            let right = child(*right_id, found);
+            left && right && FOLDABLE_BINARY_OPS.contains(&data_store.resolve_ast_string(*op_id))
+        }
+        AstNodeData::Array { .. } => {
+            let elements = data_store
+                .get_array_elems(node)
+                .map_or(&[][..], |(_, _, elements)| elements);
+            let mut constant = true;
+            for &element in elements {
+                constant &= child(element, found);
+            }
+            constant
+        }
+        AstNodeData::Function { name_id, .. } => {
+            let args = data_store.get_args(node).unwrap_or(&[]);
+            let mut constant = true;
+            for &arg in args {
+                constant &= child(arg, found);
+            }
+            let name = data_store.resolve_ast_string(*name_id);
+            // Zero-argument calls (ROW(), NA()) are left alone with the rest.
+            constant
+                && !args.is_empty()
+                && functions
+                    .get_function("", name)
+                    .is_some_and(|fun| is_foldable(fun.as_ref(), args.len()))
+        }
+    };
+    if constant {
+        // The whole subtree folds; its constant children need no entry.
+        found.truncate(mark);
+    }
+    constant
+}
+
+/// True when a call's value depends on its argument values and at most the
+/// date system and locale. Functions that read the workbook's sheets, the
+/// calling cell, or a local environment are excluded with the capabilities
+/// that rule out memoization.
+fn is_foldable(fun: &dyn Function, arity: usize) -> bool {
+    crate::engine::pure_memo::is_memoizable(fun.caps())
+        && fun.semantic_contract(arity).is_none_or(|contract| {
+            matches!(
+                contract.context,
+                FunctionContextDependence::None | FunctionContextDependence::LocaleOrConfiguration
+            )
+        })
+}
+
+/// Evaluation context for folding: functions and settings, no cells.
+struct FoldContext<'a> {
+    functions: &'a dyn FunctionProvider,
+    settings: ConstantFoldSettings,
+}
+
+fn no_cells() -> ExcelError {
+    ExcelError::new(ExcelErrorKind::Ref).with_message("Constant folding reads no cells")
+}
+
+impl ReferenceResolver for FoldContext<'_> {
+    fn resolve_cell_reference(
+        &self,
+        _sheet: Option<&str>,
+        _row: u32,
+        _col: u32,
+    ) -> Result<LiteralValue, ExcelError> {
+        Err(no_cells())
+    }
+}
+
+impl RangeResolver for FoldContext<'_> {
+    fn resolve_range_reference(
+        &self,
+        _sheet: Option<&str>,
+        _sr: Option<u32>,
+        _sc: Option<u32>,
+        _er: Option<u32>,
+        _ec: Option<u32>,
+    ) -> Result<Box<dyn Range>, ExcelError> {
+        Err(no_cells())
+    }
+}
+
+impl NamedRangeResolver for FoldContext<'_> {
+    fn resolve_named_range_reference(
+        &self,
+        _name: &str,
+    ) -> Result<Vec<Vec<LiteralValue>>, ExcelError> {
+        Err(no_cells())
+    }
+}
+
+impl TableResolver for FoldContext<'_> {
+    fn resolve_table_reference(
+        &self,
+        _tref: &TableReference,
+    ) -> Result<Box<dyn Table>, ExcelError> {
+        Err(no_cells())
+    }
+}
+
+impl SourceResolver for FoldContext<'_> {}
+
+impl Resolver for FoldContext<'_> {}
+
+impl FunctionProvider for FoldContext<'_> {
+    fn planning_semantic_revision(&self) -> Option<u64> {
+        self.functions.planning_semantic_revision()
+    }
+
+    fn get_function(&self, ns: &str, name: &str) -> Option<Arc<dyn Function>> {
+        self.functions.get_function(ns, name)
+    }
+}
+
+impl EvaluationContext for FoldContext<'_> {
+    fn locale(&self) -> Locale {
+        self.settings.locale
+    }
+
+    fn date_system(&self) -> DateSystem {
+        self.settings.date_system
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn settings(date_system: DateSystem) -> ConstantFoldSettings {
+        ConstantFoldSettings {
+            date_system,
+            locale: Locale::invariant(),
+        }
+    }
+
+    #[test]
+    fn folded_values_are_keyed_on_every_fold_setting() {
+        let node = AstNodeId::from_u32(7);
+        let folded = settings(DateSystem::Excel1900);
+        let mut index = ConstantIndex::default();
+        index.insert(
+            node,
+            FoldedConstant::Scalar(LiteralValue::Number(2.0)),
+            folded,
+        );
+        assert_eq!(index.scalar(node, folded), Some(LiteralValue::Number(2.0)));
+
+        // `Locale` only has the invariant value today, so only the date system
+        // can differ here; the index compares the whole settings value.
+        let other = settings(DateSystem::Excel1904);
+        assert_eq!(index.scalar(node, other), None);
+        assert!(index.get(node, other).is_none());
+
+        // Folding under new settings replaces every entry folded under the old.
+        let refolded = settings(DateSystem::Excel1904);
+        index.insert(
+            AstNodeId::from_u32(8),
+            FoldedConstant::Scalar(LiteralValue::Number(3.0)),
+            refolded,
+        );
+        assert_eq!(index.scalar(node, refolded), None);
+        assert_eq!(
+            index.scalar(AstNodeId::from_u32(8), refolded),
+            Some(LiteralValue::Number(3.0))
+        );
+    }
+}
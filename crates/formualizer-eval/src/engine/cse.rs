@@ -0,0 +1,256 @@
+//! Workbook-wide common subexpression elimination.
+//!
+//! The AST arena hash-conses structurally identical subtrees, so every
+//! occurrence of `SUM(Data!$B$2:$B$100000)` across the workbook, or of one
+//! `VLOOKUP($A5,...)` repeated inside a cell's nested IFs, is a single
+//! [`AstNodeId`]. At ingest, [`record_shared_candidates`] counts the
+//! occurrences of pure function subtrees whose value does not depend on the
+//! evaluating cell. A node seen at least twice is *shared*. Its value is then
+//! computed once per evaluation pass and reused by every other reader on the
+//! same sheet through [`SharedSubexpressionCache`].
+//!
+//! No hidden vertices are added to the dependency graph. Every reader already
+//! depends on everything the shared subtree reads, so all readers within one
+//! schedule observe the same inputs. The engine clears the cache whenever that
+//! stops holding: at each evaluation request, each schedule build, and around
+//! cyclic SCC units. Entries are also tagged with the data snapshot.
+
+use std::hash::BuildHasherDefault;
+use std::sync::atomic::{AtomicU64, Ordering};
+
+use dashmap::DashMap;
+use formualizer_common::LiteralValue;
+use rustc_hash::{FxHashMap, FxHasher};
+
+use crate::engine::arena::{AstNodeData, AstNodeId, CompactRefType, DataStore};
+use crate::function::FnCaps;
+use crate::traits::FunctionProvider;
+
+/// Capabilities that make a function's value depend on more than its
+/// arguments' values, or make it unsuitable for a scalar cache.
+const UNSHAREABLE_CAPS: FnCaps = FnCaps::VOLATILE
+    .union(FnCaps::RETURNS_REFERENCE)
+    .union(FnCaps::DYNAMIC_DEPENDENCY)
+    .union(FnCaps::LOCAL_ENVIRONMENT)
+    .union(FnCaps::MAY_SPILL);
+
+/// Ingest-time occurrence counts of shareable subtrees, kept by the
+/// [`DataStore`] alongside the arena whose ids they count.
+///
+/// Counts are never decremented when formulas are replaced. A stale count only
+/// keeps a node cache-eligible, and caching such a node is harmless.
+#[derive(Debug, Default)]
+pub struct SubexpressionIndex {
+    occurrences: FxHashMap<AstNodeId, u32>,
+}
+
+impl SubexpressionIndex {
+    /// True when `node` occurred in at least two places at ingest.
+    #[inline]
+    pub fn is_shared(&self, node: AstNodeId) -> bool {
+        !self.occurrences.is_empty() && self.occurrences.get(&node).is_some_and(|&n| n >= 2)
+    }
+
+    /// Number of shared nodes.
+    pub fn shared_count(&self) -> usize {
+        self.occurrences.values().filter(|&&n| n >= 2).count()
+    }
+
+    fn record(&mut self, node: AstNodeId) {
+        let count = self.occurrences.entry(node).or_insert(0);
+        *count = count.saturating_add(1);
+    }
+
+    pub(crate) fn clear(&mut self) {
+        self.occurrences.clear();
+    }
+}
+
+/// Count every shareable subtree occurrence under `root`, including repeats
+/// within the same formula.
+pub(crate) fn record_shared_candidates(
+    root: AstNodeId,
+    data_store: &mut DataStore,
+    functions: &dyn FunctionProvider,
+) {
+    let mut found = Vec::new();
+    visit(root, data_store, functions, &mut found);
+    let index = data_store.subexpressions_mut();
+    for node in found {
+        index.record(node);
+    }
+}
+
+/// What a subtree's value depends on, bottom-up.
+#[derive(Clone, Copy)]
+struct Shape {
+    /// Value depends only on cell contents and the current sheet, not on the
+    /// evaluating cell, reference offsets, or local bindings.
+    independent: bool,
+    /// Reads a range, which makes caching worthwhile.
+    reads_range: bool,
+}
+
+impl Shape {
+    const OPAQUE: Shape = Shape {
+        independent: false,
+        reads_range: false,
+    };
+
+    fn join(self, other: Shape) -> Shape {
+        Shape {
+            independent: self.independent && other.independent,
+            reads_range: self.reads_range || other.reads_range,
+        }
+    }
+}
+
+fn visit(
+    node: AstNodeId,
+    data_store: &DataStore,
+    functions: &dyn FunctionProvider,
+    found: &mut Vec<AstNodeId>,
+) -> Shape {
+    let Some(data) = data_store.get_node(node) else {
+        return Shape::OPAQUE;
+    };
+    match data {
+        AstNodeData::Literal(_) => Shape {
+            independent: true,
+            reads_range: false,
+        },
+        AstNodeData::Reference { ref_type, .. } => match ref_type {
+            CompactRefType::Cell { .. } | CompactRefType::Cell3D { .. } => Shape {
+                independent: true,
+                reads_range: false,
+            },
+            CompactRefType::Range { .. } | CompactRefType::Range3D { .. } => Shape {
+                independent: true,
+                reads_range: true,
+            },
+            // Names may be LET/LAMBDA locals; tables may carry `[@Col]`.
+            CompactRefType::NamedRange(_)
+            | CompactRefType::Table { .. }
+            | CompactRefType::External { .. } => Shape::OPAQUE,
+        },
+        AstNodeData::UnaryOp { op_id, expr_id } => {
+            let inner = visit(*expr_id, data_store, functions, found);
+            if data_store.resolve_ast_string(*op_id) == "@" {
+                Shape::OPAQUE
+            } else {
+                inner
+            }
+        }
+        AstNodeData::BinaryOp {
+            op_id,
+            left_id,
+            right_id,
+        } => {
+            let shape = visit(*left_id, data_store, functions, found)
+                .join(visit(*right_id, data_store, functions, found));
+            if data_store.resolve_ast_string(*op_id) == ":" {
+                Shape::OPAQUE
+            } else {
+                shape
+            }
+        }
+        AstNodeData::Array { .. } => {
+            let mut shape = Shape {
+                independent: true,
+                reads_range: false,
+            };
+            if let Some((_, _, elements)) = data_store.get_array_elems(node) {
+                for &element in elements {
+                    shape = shape.join(visit(element, data_store, functions, found));
+                }
+            }
+            shape
+        }
+        AstNodeData::Function { name_id, .. } => {
+            let args = data_store.get_args(node).unwrap_or(&[]);
+            let mut shape = Shape {
+                // Zero-argument calls (ROW(), COLUMN()) read the current cell.
+                independent: !args.is_empty(),
+                reads_range: false,
+            };
+            for &arg in args {
+                shape = shape.join(visit(arg, data_store, functions, found));
+            }
+            let name = data_store.resolve_ast_string(*name_id);
+            let shareable = functions
+                .function_capabilities("", name)
+                .is_some_and(|caps| {
+                    caps.contains(FnCaps::PURE) && !caps.intersects(UNSHAREABLE_CAPS)
+                });
+            shape.independent &= shareable;
+            if shape.independent && shape.reads_range {
+                found.push(node);
+            }
+            shape
+        }
+    }
+}
+
+/// Counters for [`SharedSubexpressionCache`] (see
+/// `Engine::shared_subexpression_stats`).
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct SharedSubexpressionStats {
+    /// Nodes that occurred at least twice at ingest.
+    pub shared_nodes: u64,
+    /// Shared subtree evaluations that filled the cache.
+    pub evaluations: u64,
+    /// Evaluations saved by reusing a cached value.
+    pub reuses: u64,
+}
+
+/// Per-pass values of shared subexpressions, keyed by node and current sheet
+/// (unqualified references resolve against it).
+#[derive(Default)]
+pub struct SharedSubexpressionCache {
+    entries: DashMap<AstNodeId, Vec<CachedValue>, BuildHasherDefault<FxHasher>>,
+    evaluations: AtomicU64,
+    reuses: AtomicU64,
+}
+
+struct CachedValue {
+    sheet: Box<str>,
+    snapshot: u64,
+    value: LiteralValue,
+}
+
+impl SharedSubexpressionCache {
+    pub(crate) fn get(&self, node: AstNodeId, sheet: &str, snapshot: u64) -> Option<LiteralValue> {
+        let entry = self.entries.get(&node)?;
+        let hit = entry
+            .iter()
+            .find(|cached| cached.snapshot == snapshot && &*cached.sheet == sheet)?;
+        self.reuses.fetch_add(1, Ordering::Relaxed);
+        Some(hit.value.clone())
+    }
+
+    pub(crate) fn insert(&self, node: AstNodeId, sheet: &str, snapshot: u64, value: LiteralValue) {
+        self.evaluations.fetch_add(1, Ordering::Relaxed);
+        let mut entry = self.entries.entry(node).or_default();
+        entry.retain(|cached| &*cached.sheet != sheet);
+        entry.push(CachedValue {
+            sheet: sheet.into(),
+            snapshot,
+            value,
+        });
+    }
+
+    /// Drop every cached value; counters are kept.
+    pub(crate) fn invalidate(&self) {
+        if !self.entries.is_empty() {
+            self.entries.clear();
+        }
+    }
+
+    pub(crate) fn stats(&self, shared_nodes: usize) -> SharedSubexpressionStats {
+        SharedSubexpressionStats {
+            shared_nodes: shared_nodes as u64,
+            evaluations: self.evaluations.load(Ordering::Relaxed),
+            reuses: self.reuses.load(Ordering::Relaxed),
+        }
+    }
+}
@@ -1,6 +1,10 @@
 use crate::SheetId;
+use crate::arrow_store::snapshot::{SnapshotAstNode, SnapshotFormulas};
 use crate::arrow_store::{OverlayFragment, OverlayValue, SheetStore};
 use crate::engine::arena::AstNodeId;
+use crate::engine::arena::image::{
+    ArenaImageReader, ArenaImageWriter, relocate as relocate_arena_ast,
+};
 use crate::engine::eval_delta::{
     DeltaCollector, DeltaMode, EvalDelta, EvalDeltaCompatibilityPolicy,
 };
@@ -62,7 +66,9 @@ use crate::formula_plane::scheduler::{NativeExactScheduleError, schedule_dirty_w
 #[cfg(test)]
 use crate::formula_plane::span_eval::SpanEvalReport;
 use crate::formula_plane::span_eval::{SpanComputedWriteSink, SpanEvalTask, SpanEvaluator};
-use crate::formula_plane::structural::relocate_ast_for_template_placement;
+use crate::formula_plane::structural::{
+    relocate_ast_for_template_placement, substitute_literal_slots_for_template_placement,
+};
 use crate::formula_plane::structural_shift::{SpanShiftPlan, StructuralOp, classify_span_for_op};
 use crate::function::FnCaps;
 use crate::interpreter::Interpreter;
@@ -74,7 +80,6 @@ use formualizer_common::{
 };
 use formualizer_parse::parser::ReferenceType;
 use formualizer_parse::{ASTNode, ASTNodeType, ExcelError, ExcelErrorKind};
-use rayon::ThreadPoolBuilder;
 use rustc_hash::{FxHashMap, FxHashSet};
 use std::collections::{BTreeMap, BTreeSet, VecDeque};
 use std::sync::Arc;
@@ -898,6 +903,10 @@ pub struct Engine<R> {
     /// one recalc — including SCC iteration passes — agree (spec §7.11).
     clock: crate::timezone::SnapshotClock,
     thread_pool: Option<Arc<rayon::ThreadPool>>,
+    /// Per-node pools under `ThreadPlacement::PerNode`; `thread_pool` is node 0.
+    node_pools: Option<crate::engine::numa::NodePools>,
+    /// Base NUMA node per sheet, assigned when the sheet gains Arrow storage.
+    sheet_node_owners: crate::engine::numa::SheetNodeOwnership,
     pub recalc_epoch: u64,
     snapshot_id: std::sync::atomic::AtomicU64,
     topology_epoch: u64,
@@ -914,6 +923,15 @@ pub struct Engine<R> {
     has_edited: bool,
     /// Overlay compaction counter (Phase C instrumentation)
     overlay_compactions: u64,
+    /// Queued and in-flight overlay rebuilds (`EvalConfig::background_overlay_compaction`).
+    overlay_compactor: crate::engine::overlay_compaction::OverlayCompactor,
+    /// In-flight chunk rebalances (`EvalConfig::adaptive_chunk_rebalancing`).
+    chunk_rebalancer: crate::engine::chunk_rebalance::ChunkRebalancer,
+    /// Resident/spilled chunk counters (`RetainedResourceBudget::resident_chunk_bytes`).
+    cold_tier_stats: crate::arrow_store::ColdTierStats,
+    /// Chunk read epoch started by the last evaluation request (`u64::MAX` before the
+    /// first). The epoch counter is process-wide, so other engines advance it too.
+    request_chunk_epoch: u64,
 
     // Overlay memory observability / budget (ticket 503)
     computed_overlay_bytes_estimate: usize,
@@ -931,6 +949,10 @@ pub struct Engine<R> {
     source_formula_token: Arc<()>,
     /// Dedicated identity binding for reusable recalculation plans.
     recalc_plan_token: Arc<()>,
+    /// Viewport regions evaluated ahead of the rest of the dirty set.
+    priority_regions: Vec<crate::engine::EvaluationTarget>,
+    /// Retained target plan for `priority_regions`; rebuilt when it goes stale.
+    priority_plan: Option<RecalcPlan>,
     /// Staged formulas by sheet when `defer_graph_building` is enabled.
     staged_formulas: StagedFormulaMap,
     /// Presence and generation authority for ordinary staged formula discovery.
@@ -978,6 +1000,24 @@ pub struct Engine<R> {
     // Phase 3b virtual-dependency convergence telemetry
     last_virtual_dep_telemetry: VirtualDepTelemetry,
     virtual_dep_fallback_activations: u64,
+    /// Last resolved formula reads per dynamic-reference vertex; the speculation
+    /// set for its next pass when `speculative_dynamic_refs` is enabled.
+    speculative_dynamic_deps: FxHashMap<VertexId, Vec<VertexId>>,
+    speculation_stats: SpeculationStats,
+    /// Compiled bytecode per formula root (`EvalConfig::enable_bytecode_vm`).
+    bytecode_programs: crate::bytecode::ProgramCache,
+    /// Per-pass values of shared subexpressions
+    /// (`EvalConfig::enable_shared_subexpressions`).
+    shared_subexpressions: crate::engine::cse::SharedSubexpressionCache,
+    /// Compiled span kernels and their tier-up counts
+    /// (`EvalConfig::enable_span_jit`).
+    span_jit: crate::formula_plane::span_jit::SpanJitCache,
+    /// Scratch-arena resets and interpreter array allocation counts.
+    eval_allocations: crate::scratch::AllocationCounters,
+    /// Memoized pure function call results (`EvalConfig::enable_pure_call_memo`).
+    pure_call_memo: crate::engine::pure_memo::PureCallMemo,
+    /// `DataStore::materialized_cells` at the start of the current request.
+    materialized_cells_at_request: u64,
 
     // Runtime-cycle SCC evaluation telemetry (RFC #112, Stage 2)
     last_cycle_telemetry: CycleTelemetry,
@@ -1067,7 +1107,16 @@ pub struct Engine<R> {
 /// `Engine` edit methods and does not create changelog boundaries or implement rollback.
 impl<R: EvaluationContext> Engine<R> {
     pub(crate) fn ingest_pipeline(&mut self) -> crate::engine::ingest_pipeline::IngestPipeline<'_> {
-        self.graph.ingest_pipeline(&self.resolver)
+        let constant_folding = self.config.enable_constant_folding.then(|| {
+            crate::engine::const_fold::ConstantFoldSettings {
+                date_system: self.config.date_system,
+                locale: EvaluationContext::locale(self),
+            }
+        });
+        self.graph
+            .ingest_pipeline(&self.resolver)
+            .with_shared_subexpressions(self.config.enable_shared_subexpressions)
+            .with_constant_folding(constant_folding)
     }
 }
 
@@ -1619,6 +1668,19 @@ pub struct EvalResult {
     pub elapsed: std::time::Duration,
 }
 
+/// Outcome of a viewport-first [`Engine::evaluate_priority_first`] request.
+///
+/// `hot` covers the transitive precedents of the registered priority regions and
+/// is always complete when the request returns `Ok`. `background` is `None` when
+/// the remaining dirty set was cancelled (or never started); those vertices stay
+/// dirty and are picked up by the next full or priority recalculation.
+#[derive(Debug)]
+pub struct PriorityEvalResult {
+    pub hot: EvalResult,
+    pub background: Option<EvalResult>,
+    pub background_cancelled: bool,
+}
+
 #[derive(Clone, Debug, PartialEq, Eq)]
 pub struct TableMetadata {
     pub name: String,
@@ -1678,6 +1740,35 @@ pub struct VirtualDepTelemetry {
     pub changed_vdeps_total: usize,
     pub bailout_reason: Option<&'static str>,
     pub fallback_mode_activations: u64,
+    /// Speculative dynamic-reference scheduling counters for this request
+    /// (`EvalConfig::speculative_dynamic_refs`).
+    pub speculation: SpeculationStats,
+}
+
+/// Counters for speculative scheduling of dynamic-reference formulas.
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct SpeculationStats {
+    /// Dynamic vertices scheduled against their previously resolved dependency set.
+    pub speculated: u64,
+    /// Validated dynamic vertices whose in-pass reads were all ordered before them.
+    pub hits: u64,
+    /// Validated dynamic vertices re-run because a read was evaluated concurrently
+    /// with or after them.
+    pub misses: u64,
+}
+
+impl SpeculationStats {
+    /// Fraction of validated dynamic vertices that did not need re-execution.
+    pub fn hit_rate(&self) -> Option<f64> {
+        let validated = self.hits + self.misses;
+        (validated > 0).then(|| self.hits as f64 / validated as f64)
+    }
+
+    fn accumulate(&mut self, other: SpeculationStats) {
+        self.speculated += other.speculated;
+        self.hits += other.hits;
+        self.misses += other.misses;
+    }
 }
 
 /// Per-recalc telemetry for SCC evaluation under `CycleDetection::Runtime`
@@ -1735,6 +1826,7 @@ struct ScheduleBuildMeta {
     used_virtual_schedule: bool,
     schedule_cache_hit: bool,
     schedule_cache_eligible: bool,
+    speculated_vertices: usize,
 }
 
 #[derive(Debug, Clone)]
@@ -2331,6 +2423,11 @@ fn compute_criteria_mask(
     let ne_matches_blank = text_kind == 1 && !text_pat.is_empty();
     let pat = StringArray::new_scalar(text_pat);
     let mut bool_parts: Vec<BooleanArray> = Vec::new();
+    // Pattern result per distinct lowered string of the current column dictionary.
+    let mut dict_mask: Option<(
+        std::sync::Arc<crate::arrow_store::TextDictionary>,
+        BooleanArray,
+    )> = None;
 
     for res in view.iter_row_chunks() {
         let cs = res.ok()?;
@@ -2340,6 +2437,36 @@ fn compute_criteria_mask(
         #[cfg(test)]
         criteria_mask_test_hooks::inc_total();
 
+        // Dictionary-encoded segments run the kernel once per distinct lowered string and
+        // gather the result by code.
+        if let Some(Some(codes)) = view
+            .slice_text_codes(cs.row_start, cs.row_len)
+            .into_iter()
+            .nth(col_in_view)
+        {
+            let stale = dict_mask
+                .as_ref()
+                .is_none_or(|(dict, _)| !std::sync::Arc::ptr_eq(dict, &codes.dict));
+            if stale {
+                let lowered = codes.dict.lowered_values();
+                let m = match text_kind {
+                    0 | 2 => ilike(lowered, &pat).ok()?,
+                    1 => nilike(lowered, &pat).ok()?,
+                    _ => return None,
+                };
+                dict_mask = Some((codes.dict.clone(), m));
+            }
+            let mut m = codes.mask_from_lowered(&dict_mask.as_ref()?.1);
+            if ((text_kind == 0 && empty_special) || ne_matches_blank)
+                && codes.codes.null_count() > 0
+            {
+                let nulls: BooleanArray = codes.codes.iter().map(|c| Some(c.is_none())).collect();
+                m = boolean::or_kleene(&m, &nulls).ok()?;
+            }
+            bool_parts.push(m);
+            continue;
+        }
+
         let slices = view.slice_lowered_text(cs.row_start, cs.row_len);
         if col_in_view >= slices.len() {
             return None;
@@ -2462,22 +2589,23 @@ where
             }
         });
 
-        // Initialize thread pool based on config
-        let thread_pool = if config.enable_parallel {
-            let mut builder = ThreadPoolBuilder::new();
-            if let Some(max_threads) = config.max_threads {
-                builder = builder.num_threads(max_threads);
-            }
-
-            match builder.build() {
-                Ok(pool) => Some(Arc::new(pool)),
-                Err(_) => {
-                    // Fall back to sequential evaluation if thread pool creation fails
-                    None
-                }
-            }
+        // Initialize thread pool(s) based on config. A failed build falls back
+        // to sequential evaluation.
+        let (thread_pool, node_pools) = if config.enable_parallel {
+            let topology = match config.thread_placement {
+                crate::engine::ThreadPlacement::Unpinned => crate::engine::NumaTopology::single(),
+                _ => config
+                    .numa_topology
+                    .clone()
+                    .unwrap_or_else(crate::engine::NumaTopology::detect),
+            };
+            crate::engine::numa::build_thread_pools(
+                config.max_threads,
+                config.thread_placement,
+                &topology,
+            )
         } else {
-            None
+            (None, None)
         };
 
         // C1a retained/cache budgets are observational; cache defaults stay explicit.
@@ -2490,6 +2618,8 @@ where
             workbook_load_limits: crate::engine::WorkbookLoadLimits::default(),
             clock: crate::timezone::SnapshotClock::new(clock),
             thread_pool,
+            node_pools,
+            sheet_node_owners: Default::default(),
             recalc_epoch: 0,
             snapshot_id: std::sync::atomic::AtomicU64::new(1),
             topology_epoch: 0,
@@ -2503,6 +2633,10 @@ where
             arrow_sheets: SheetStore::default(),
             has_edited: false,
             overlay_compactions: 0,
+            overlay_compactor: Default::default(),
+            chunk_rebalancer: Default::default(),
+            cold_tier_stats: Default::default(),
+            request_chunk_epoch: u64::MAX,
             computed_overlay_bytes_estimate: 0,
             computed_overlay_mirroring_disabled: false,
             force_materialize_range_views: false,
@@ -2512,6 +2646,8 @@ where
             source_cache: Arc::new(std::sync::RwLock::new(SourceCache::default())),
             source_formula_token: Arc::new(()),
             recalc_plan_token: Arc::new(()),
+            priority_regions: Vec::new(),
+            priority_plan: None,
             staged_formulas: std::collections::HashMap::new(),
             staged_formula_index: StagedFormulaIndex::default(),
             row_visibility: FxHashMap::default(),
@@ -2527,6 +2663,14 @@ where
             action_depth: 0,
             last_virtual_dep_telemetry: VirtualDepTelemetry::default(),
             virtual_dep_fallback_activations: 0,
+            speculative_dynamic_deps: FxHashMap::default(),
+            speculation_stats: SpeculationStats::default(),
+            bytecode_programs: Default::default(),
+            shared_subexpressions: Default::default(),
+            span_jit: Default::default(),
+            eval_allocations: Default::default(),
+            pure_call_memo: Default::default(),
+            materialized_cells_at_request: 0,
             last_cycle_telemetry: CycleTelemetry::default(),
             next_evaluation_resource_request_id: 1,
             evaluation_resource_request_depth: 0,
@@ -2576,6 +2720,12 @@ where
         engine.config.arrow_storage_enabled = true;
         engine.config.delta_overlay_enabled = true;
         engine.config.write_formula_overlay_enabled = true;
+        engine
+            .pure_call_memo
+            .set_budget(engine.config.pure_call_memo_bytes);
+        engine
+            .graph
+            .set_dirty_propagation_pool(engine.thread_pool.clone());
         let default_sheet = engine.graph.default_sheet_name().to_string();
         engine.ensure_arrow_sheet(&default_sheet);
         engine
@@ -2625,6 +2775,8 @@ where
             workbook_load_limits: crate::engine::WorkbookLoadLimits::default(),
             clock: crate::timezone::SnapshotClock::new(clock),
             thread_pool: Some(thread_pool),
+            node_pools: None,
+            sheet_node_owners: Default::default(),
             recalc_epoch: 0,
             snapshot_id: std::sync::atomic::AtomicU64::new(1),
             topology_epoch: 0,
@@ -2638,6 +2790,10 @@ where
             arrow_sheets: SheetStore::default(),
             has_edited: false,
             overlay_compactions: 0,
+            overlay_compactor: Default::default(),
+            chunk_rebalancer: Default::default(),
+            cold_tier_stats: Default::default(),
+            request_chunk_epoch: u64::MAX,
             computed_overlay_bytes_estimate: 0,
             computed_overlay_mirroring_disabled: false,
             force_materialize_range_views: false,
@@ -2647,6 +2803,8 @@ where
             source_cache: Arc::new(std::sync::RwLock::new(SourceCache::default())),
             source_formula_token: Arc::new(()),
             recalc_plan_token: Arc::new(()),
+            priority_regions: Vec::new(),
+            priority_plan: None,
             staged_formulas: std::collections::HashMap::new(),
             staged_formula_index: StagedFormulaIndex::default(),
             row_visibility: FxHashMap::default(),
@@ -2662,6 +2820,14 @@ where
             action_depth: 0,
             last_virtual_dep_telemetry: VirtualDepTelemetry::default(),
             virtual_dep_fallback_activations: 0,
+            speculative_dynamic_deps: FxHashMap::default(),
+            speculation_stats: SpeculationStats::default(),
+            bytecode_programs: Default::default(),
+            shared_subexpressions: Default::default(),
+            span_jit: Default::default(),
+            eval_allocations: Default::default(),
+            pure_call_memo: Default::default(),
+            materialized_cells_at_request: 0,
             last_cycle_telemetry: CycleTelemetry::default(),
             next_evaluation_resource_request_id: 1,
             evaluation_resource_request_depth: 0,
@@ -2711,6 +2877,12 @@ where
         engine.config.arrow_storage_enabled = true;
         engine.config.delta_overlay_enabled = true;
         engine.config.write_formula_overlay_enabled = true;
+        engine
+            .pure_call_memo
+            .set_budget(engine.config.pure_call_memo_bytes);
+        engine
+            .graph
+            .set_dirty_propagation_pool(engine.thread_pool.clone());
         let default_sheet = engine.graph.default_sheet_name().to_string();
         engine.ensure_arrow_sheet(&default_sheet);
         engine
@@ -3348,6 +3520,16 @@ where
         // read within this request (including SCC iteration passes) observes
         // this sample.
         self.clock.refresh();
+        // Between passes: nothing reads the Arrow store, so finished rebuilds swap in here.
+        self.run_overlay_compaction_boundary();
+        self.run_chunk_rebalance_boundary();
+        self.enforce_resident_chunk_budget();
+        // Edits that overflowed the PK visit budget only marked the order stale;
+        // pay for the single rebuild here rather than once per edit.
+        self.graph.refresh_dynamic_topo();
+        self.shared_subexpressions.invalidate();
+        self.pure_call_memo.invalidate_cell_reads();
+        self.materialized_cells_at_request = self.graph.data_store().materialized_cells();
     }
 
     /// End-of-recalc redirty: volatile vertices (as always) plus members of
@@ -3388,6 +3570,11 @@ where
         self.virtual_dep_fallback_activations
     }
 
+    /// Cumulative speculative dynamic-reference scheduling counters.
+    pub fn speculation_stats(&self) -> SpeculationStats {
+        self.speculation_stats
+    }
+
     pub(crate) fn last_lookup_index_cache_report(&self) -> LookupIndexCacheReport {
         self.lookup_index_cache.report()
     }
@@ -3782,6 +3969,11 @@ where
         if self.arrow_sheets.sheet(name).is_some() {
             return;
         }
+        if let Some(pools) = self.node_pools.as_ref()
+            && let Some(sheet_id) = self.graph.sheet_id(name)
+        {
+            self.sheet_node_owners.assign(sheet_id, pools.len());
+        }
         self.arrow_sheets
             .sheets
             .push(crate::arrow_store::ArrowSheet {
@@ -3803,6 +3995,7 @@ where
             .map_err(Self::editor_error_to_excel)?;
         self.graph.remove_sheet(sheet_id)?;
         self.arrow_sheets.sheets.retain(|s| s.name.as_ref() != name);
+        self.sheet_node_owners.remove(sheet_id);
         // Sheet removal can change cross-sheet refs, names, and default-sheet
         // resolution. Until those domains have a complete exact dependency
         // proof, retain the documented graph-owned global invalidation.
@@ -11952,8 +12145,29 @@ where
         if !global_changed && !provider_changed {
             return Ok(false);
         }
+        // Cached results may come from a function that was just replaced.
+        self.pure_call_memo.clear();
 
         let changed = changes.keys.into_iter().collect::<BTreeSet<_>>();
+        // So may constants folded at ingest, and the programs holding them.
+        let stale_constants: Vec<AstNodeId> = if provider_changed || !changes.complete {
+            self.graph.data_store().constants().nodes().collect()
+        } else {
+            let data_store = self.graph.data_store();
+            data_store
+                .constants()
+                .nodes()
+                .filter(|&node| {
+                    data_store
+                        .reconstruct_ast_node(node, self.graph.sheet_reg())
+                        .is_none_or(|ast| Self::ast_uses_changed_function(&ast, &changed))
+                })
+                .collect()
+        };
+        if !stale_constants.is_empty() {
+            self.graph.remove_folded_constants(&stale_constants);
+            self.bytecode_programs.clear();
+        }
         let sheets: BTreeSet<_> = self
             .graph
             .formula_authority()
@@ -12452,69 +12666,6 @@ where
             placements: Vec<(u32, u32)>,
         }
 
-        fn substitute_literal_slots_for_template_placement(
-            ast: &ASTNode,
-            binding: &[LiteralValue],
-        ) -> ASTNode {
-            fn clone_with_slots(
-                ast: &ASTNode,
-                binding: &[LiteralValue],
-                next: &mut usize,
-                in_array: bool,
-            ) -> ASTNode {
-                let node_type = match &ast.node_type {
-                    ASTNodeType::Literal(_) if !in_array => {
-                        let value = binding.get(*next).cloned().unwrap_or(LiteralValue::Empty);
-                        *next = next.saturating_add(1);
-                        ASTNodeType::Literal(value)
-                    }
-                    ASTNodeType::Literal(value) => ASTNodeType::Literal(value.clone()),
-                    ASTNodeType::Reference {
-                        original,
-                        reference,
-                    } => ASTNodeType::Reference {
-                        original: original.clone(),
-                        reference: reference.clone(),
-                    },
-                    ASTNodeType::UnaryOp { op, expr } => ASTNodeType::UnaryOp {
-                        op: op.clone(),
-                        expr: Box::new(clone_with_slots(expr, binding, next, in_array)),
-                    },
-                    ASTNodeType::BinaryOp { op, left, right } => ASTNodeType::BinaryOp {
-                        op: op.clone(),
-                        left: Box::new(clone_with_slots(left, binding, next, in_array)),
-                        right: Box::new(clone_with_slots(right, binding, next, in_array)),
-                    },
-                    ASTNodeType::Function { name, args } => ASTNodeType::Function {
-                        name: name.clone(),
-                        args: args
-                            .iter()
-                            .map(|arg| clone_with_slots(arg, binding, next, in_array))
-                            .collect(),
-                    },
-                    ASTNodeType::Call { callee, args } => ASTNodeType::Call {
-                        callee: Box::new(clone_with_slots(callee, binding, next, in_array)),
-                        args: args
-                            .iter()
-                            .map(|arg| clone_with_slots(arg, binding, next, in_array))
-                            .collect(),
-                    },
-                    ASTNodeType::Array(rows) => ASTNodeType::Array(
-                        rows.iter()
-                            .map(|row| {
-                                row.iter()
-                                    .map(|cell| clone_with_slots(cell, binding, next, true))
-                                    .collect()
-                            })
-                            .collect(),
-                    ),
-                };
-                ASTNode::new(node_type, ast.source_token.clone())
-            }
-            let mut next = 0usize;
-            clone_with_slots(ast, binding, &mut next, false)
-        }
-
         let span_refs = self.indexed_structural_candidate_span_refs(affected_region)?;
         self.formula_plane_structural_span_candidates = self
             .formula_plane_structural_span_candidates
@@ -13834,66 +13985,6 @@ where
             return Err(FormulaSpanDemotionError::Injected(fault));
         }
 
-        fn substitute_literal_slots(ast: &ASTNode, binding: &[LiteralValue]) -> ASTNode {
-            fn visit(
-                ast: &ASTNode,
-                binding: &[LiteralValue],
-                next: &mut usize,
-                in_array: bool,
-            ) -> ASTNode {
-                let node_type = match &ast.node_type {
-                    ASTNodeType::Literal(_) if !in_array => {
-                        let value = binding.get(*next).cloned().unwrap_or(LiteralValue::Empty);
-                        *next = next.saturating_add(1);
-                        ASTNodeType::Literal(value)
-                    }
-                    ASTNodeType::Literal(value) => ASTNodeType::Literal(value.clone()),
-                    ASTNodeType::Reference {
-                        original,
-                        reference,
-                    } => ASTNodeType::Reference {
-                        original: original.clone(),
-                        reference: reference.clone(),
-                    },
-                    ASTNodeType::UnaryOp { op, expr } => ASTNodeType::UnaryOp {
-                        op: op.clone(),
-                        expr: Box::new(visit(expr, binding, next, in_array)),
-                    },
-                    ASTNodeType::BinaryOp { op, left, right } => ASTNodeType::BinaryOp {
-                        op: op.clone(),
-                        left: Box::new(visit(left, binding, next, in_array)),
-                        right: Box::new(visit(right, binding, next, in_array)),
-                    },
-                    ASTNodeType::Function { name, args } => ASTNodeType::Function {
-                        name: name.clone(),
-                        args: args
-                            .iter()
-                            .map(|arg| visit(arg, binding, next, in_array))
-                            .collect(),
-                    },
-                    ASTNodeType::Call { callee, args } => ASTNodeType::Call {
-                        callee: Box::new(visit(callee, binding, next, in_array)),
-                        args: args
-                            .iter()
-                            .map(|arg| visit(arg, binding, next, in_array))
-                            .collect(),
-                    },
-                    ASTNodeType::Array(rows) => ASTNodeType::Array(
-                        rows.iter()
-                            .map(|row| {
-                                row.iter()
-                                    .map(|cell| visit(cell, binding, next, true))
-                                    .collect()
-                            })
-                            .collect(),
-                    ),
-                };
-                ASTNode::new(node_type, ast.source_token.clone())
-            }
-            let mut next = 0;
-            visit(ast, binding, &mut next, false)
-        }
-
         struct SpanMaterialization {
             span_ref: FormulaSpanRef,
             sheet_id: SheetId,
@@ -14055,7 +14146,7 @@ where
                         let binding = binding_set
                             .literal_bindings_for_placement(&span.domain, placement)
                             .ok_or(FormulaSpanDemotionError::InvalidSpan)?;
-                        substitute_literal_slots(&plan.ast, binding.as_ref())
+                        substitute_literal_slots_for_template_placement(&plan.ast, binding.as_ref())
                     }
                 } else {
                     plan.ast.clone()
@@ -14575,7 +14666,8 @@ where
         // Min: scan dense chunks first, then sparse chunks in ascending index order.
         let mut min_r0: Option<u32> = None;
         for (chunk_idx, chunk) in col.chunks.iter().enumerate() {
-            let tags = chunk.type_tag.values();
+            let tags = chunk.type_tags();
+            let tags = tags.values();
             for (off, &t) in tags.iter().enumerate() {
                 let overlay_non_empty = chunk
                     .overlay
@@ -14610,7 +14702,8 @@ where
                 let Some(&chunk_start) = a.chunk_starts.get(chunk_idx) else {
                     continue;
                 };
-                let tags = chunk.type_tag.values();
+                let tags = chunk.type_tags();
+                let tags = tags.values();
                 for (off, &t) in tags.iter().enumerate() {
                     let overlay_non_empty = chunk
                         .overlay
@@ -14646,7 +14739,8 @@ where
                 let Some(&chunk_start) = a.chunk_starts.get(chunk_idx) else {
                     continue;
                 };
-                let tags = chunk.type_tag.values();
+                let tags = chunk.type_tags();
+                let tags = tags.values();
                 for (rev_idx, &t) in tags.iter().enumerate().rev() {
                     let overlay_non_empty = chunk
                         .overlay
@@ -14671,7 +14765,8 @@ where
         }
         if max_r0.is_none() {
             for (chunk_idx, chunk) in col.chunks.iter().enumerate().rev() {
-                let tags = chunk.type_tag.values();
+                let tags = chunk.type_tags();
+                let tags = tags.values();
                 for (rev_idx, &t) in tags.iter().enumerate().rev() {
                     let overlay_non_empty = chunk
                         .overlay
@@ -14729,7 +14824,7 @@ where
                 let Some(&chunk_start) = a.chunk_starts.get(chunk_idx) else {
                     return false;
                 };
-                let chunk_len = chunk.type_tag.len();
+                let chunk_len = chunk.len();
                 if chunk_len == 0 {
                     return false;
                 }
@@ -14740,7 +14835,8 @@ where
                 }
                 let start_off = sr0.max(chunk_start) - chunk_start;
                 let end_off = er0.min(chunk_end) - chunk_start;
-                let tags = chunk.type_tag.values();
+                let tags = chunk.type_tags();
+                let tags = tags.values();
                 for off in start_off..=end_off {
                     let overlay_non_empty = chunk
                         .overlay
@@ -14949,7 +15045,12 @@ where
             // Heuristic compaction: > len/50 or > 1024
             let abs_threshold = 1024usize;
             let frac_den = 50usize;
-            let freed = asheet.maybe_compact_chunk(col0, ch_idx, abs_threshold, frac_den);
+            let freed = if self.config.background_overlay_compaction {
+                self.overlay_compactor
+                    .note_user_edit(asheet, col0, ch_idx, abs_threshold, frac_den)
+            } else {
+                asheet.maybe_compact_chunk(col0, ch_idx, abs_threshold, frac_den)
+            };
             if freed > 0 {
                 self.overlay_compactions = self.overlay_compactions.saturating_add(1);
             }
@@ -15740,9 +15841,11 @@ where
 
         let mut chunk_idx = sheet.chunk_starts.len().saturating_sub(1);
         let mut chunk_start = sheet.chunk_starts[chunk_idx];
-        while chunk_start.saturating_add(chunk_rows) <= row0 {
+        let mut next_start = sheet.next_growth_chunk_start();
+        while next_start <= row0 {
             chunk_idx = chunk_idx.saturating_add(1);
-            chunk_start = chunk_start.saturating_add(chunk_rows);
+            chunk_start = next_start;
+            next_start = next_start.saturating_add(chunk_rows);
         }
         (
             chunk_idx,
@@ -16066,12 +16169,108 @@ where
             .saturating_sub(freed_total);
     }
 
-    fn disable_computed_overlay_mirroring_due_to_budget(&mut self, _cap: usize) {
+    fn disable_computed_overlay_mirroring_due_to_budget(&mut self, cap: usize) {
         // Phase 1 (ticket 610): Arrow-truth is the only supported mode.
         // Handle budget pressure by compacting computed overlays into base lanes.
+        if self.config.background_overlay_compaction {
+            // Defer to the next evaluation boundary unless usage runs far past the cap.
+            if self.computed_overlay_bytes_estimate <= cap.saturating_mul(2) {
+                self.overlay_compactor.request_computed_compaction();
+                return;
+            }
+            self.overlay_compactor.note_inline();
+        }
         self.compact_all_computed_overlays();
     }
 
+    /// Evaluation boundary for background overlay compaction: swap in rebuilds that
+    /// finished since the last boundary, then start rebuilds of the highest-priority
+    /// queued chunks on the engine pool.
+    fn run_overlay_compaction_boundary(&mut self) {
+        if !self.config.background_overlay_compaction || self.overlay_compactor.is_idle() {
+            return;
+        }
+        self.install_finished_overlay_compactions();
+        self.overlay_compactor
+            .dispatch(&self.arrow_sheets, self.thread_pool.as_deref());
+        if self.thread_pool.is_none() {
+            // Rebuilt on this thread; install them now rather than a pass later.
+            self.install_finished_overlay_compactions();
+        }
+    }
+
+    fn install_finished_overlay_compactions(&mut self) {
+        let (installed, computed_delta) = self
+            .overlay_compactor
+            .install_finished(&mut self.arrow_sheets);
+        self.overlay_compactions = self.overlay_compactions.saturating_add(installed);
+        self.adjust_computed_overlay_bytes(computed_delta);
+    }
+
+    /// Background overlay compaction counters.
+    pub fn overlay_compaction_stats(&self) -> crate::engine::OverlayCompactionStats {
+        self.overlay_compactor.stats()
+    }
+
+    /// Evaluation boundary for chunk rebalancing: swap in rebalances that finished since
+    /// the last boundary, then start one for each sheet whose chunks drifted out of range
+    /// of its target length.
+    fn run_chunk_rebalance_boundary(&mut self) {
+        if !self.config.adaptive_chunk_rebalancing {
+            return;
+        }
+        let delta = self
+            .chunk_rebalancer
+            .install_finished(&mut self.arrow_sheets);
+        self.adjust_computed_overlay_bytes(delta);
+        self.chunk_rebalancer
+            .dispatch(&self.arrow_sheets, self.thread_pool.as_deref());
+        if self.thread_pool.is_none() {
+            // Built on this thread; install them now rather than a pass later.
+            let delta = self
+                .chunk_rebalancer
+                .install_finished(&mut self.arrow_sheets);
+            self.adjust_computed_overlay_bytes(delta);
+        }
+    }
+
+    /// Background chunk rebalancing counters.
+    pub fn chunk_rebalance_stats(&self) -> crate::engine::ChunkRebalanceStats {
+        self.chunk_rebalancer.stats()
+    }
+
+    /// Start a new chunk access epoch and, when the resident chunk budget is set and
+    /// native disk scratch is allowed, spill the least recently read chunks until the
+    /// resident base lanes fit. Chunks read since the previous request began are kept.
+    fn enforce_resident_chunk_budget(&mut self) {
+        let protected_since = std::mem::replace(
+            &mut self.request_chunk_epoch,
+            crate::arrow_store::advance_chunk_access_epoch(),
+        );
+        let Some(limit) = self
+            .evaluation_resource_budgets
+            .retained
+            .resident_chunk_bytes
+        else {
+            return;
+        };
+        let policy = self.evaluation_resource_budgets.scratch.disk_scratch_policy;
+        if !native_exact_demand_allowed(policy, !cfg!(target_arch = "wasm32")) {
+            return;
+        }
+        crate::arrow_store::spill_cold_chunks(
+            &mut self.arrow_sheets,
+            usize::try_from(limit).unwrap_or(usize::MAX),
+            protected_since,
+            &mut self.cold_tier_stats,
+        );
+    }
+
+    /// Resident and memory-mapped chunk counters as of the last evaluation request.
+    pub fn cold_tier_stats(&self) -> crate::arrow_store::ColdTierStats {
+        self.cold_tier_stats
+    }
+
     /// Fold all computed overlay entries across all sheets into their base arrays.
     /// This preserves data while freeing overlay memory, allowing mirroring to continue.
     fn compact_all_computed_overlays(&mut self) {
@@ -16658,10 +16857,19 @@ where
                 let authority = self.graph.formula_authority();
                 let ast = authority.plane.spans.get(span).and_then(|record| {
                     let relocation = record.ast_relocation;
-                    let ast = self
+                    let mut ast = self
                         .graph
                         .data_store()
                         .retrieve_ast(relocation.ast_id, self.graph.sheet_reg())?;
+                    if let Some(binding_set) = record
+                        .binding_set_id
+                        .and_then(|id| authority.plane.binding_sets.get(id))
+                        .filter(|binding_set| !binding_set.is_single_literal_binding())
+                    {
+                        let binding = binding_set
+                            .literal_bindings_for_placement(&record.domain, placement)?;
+                        ast = substitute_literal_slots_for_template_placement(&ast, &binding);
+                    }
                     let row_delta = i64::from(row) - i64::from(relocation.anchor_row);
                     let col_delta = i64::from(col) - i64::from(relocation.anchor_col);
                     relocate_ast_for_template_placement(&ast, row_delta, col_delta).ok()
@@ -16710,6 +16918,280 @@ where
         }
     }
 
+    /// Image of every formula in the workbook, for [`crate::arrow_store::snapshot`].
+    ///
+    /// Cells resolve the way `get_cell` resolves them: staged text first, then formula
+    /// overlays, spans and legacy vertices, each walked directly rather than probed cell by
+    /// cell. A span contributes its template root once and one placement per cell.
+    /// Formulas the image cannot model are written as canonical text.
+    pub fn formula_snapshot(&self) -> Result<SnapshotFormulas, ExcelError> {
+        use crate::arrow_store::snapshot::{SnapshotPlacement, SnapshotSheetFormulas};
+        use crate::formula_plane::runtime::FormulaOverlayEntryKind;
+        use std::collections::hash_map::Entry;
+
+        let sheet_registry = self.graph.sheet_reg();
+        let data_store = self.graph.data_store();
+        let plane = &self.graph.formula_authority().plane;
+        let mut writer = ArenaImageWriter::new(data_store, sheet_registry);
+        // `binding` is a span placement's literal binding when the span's literals vary.
+        let place = |writer: &mut ArenaImageWriter<'_>,
+                     ast_id: AstNodeId,
+                     binding: Option<&[LiteralValue]>,
+                     row: u32,
+                     col: u32,
+                     anchor: (u32, u32)| {
+            let root = match binding {
+                Some(binding) => writer.node_with_literals(ast_id, binding),
+                None => writer.node(ast_id),
+            };
+            if let Some(root) = root {
+                return Some(SnapshotPlacement {
+                    row,
+                    col,
+                    root,
+                    anchor_row: anchor.0,
+                    anchor_col: anchor.1,
+                });
+            }
+            let mut ast = data_store.retrieve_ast(ast_id, sheet_registry)?;
+            if let Some(binding) = binding {
+                ast = substitute_literal_slots_for_template_placement(&ast, binding);
+            }
+            if anchor != (row, col) {
+                ast = relocate_ast_for_template_placement(
+                    &ast,
+                    i64::from(row) - i64::from(anchor.0),
+                    i64::from(col) - i64::from(anchor.1),
+                )
+                .ok()?;
+            }
+            let root = writer.text(formualizer_parse::pretty::canonical_formula(&ast));
+            Some(SnapshotPlacement {
+                row,
+                col,
+                root,
+                anchor_row: row,
+                anchor_col: col,
+            })
+        };
+        // First claim on a cell wins; `None` is a cell an overlay holds without a formula.
+        let mut claimed: FxHashMap<(SheetId, u32, u32), Option<SnapshotPlacement>> =
+            FxHashMap::default();
+
+        for (sheet, staged) in &self.staged_formulas {
+            let Some(sheet_id) = sheet_registry.get_id(sheet) else {
+                continue;
+            };
+            let mut texts: Vec<(u32, u32, String)> = staged.entries.clone();
+            if let Some(package) = &staged.deferred_package {
+                let mut replay_disposition = crate::engine::FormulaReplayDisposition::default();
+                for partition in package
+                    .partitioned_families
+                    .iter()
+                    .filter(|family| !package.invalidated.contains(&family.source_id))
+                {
+                    replay_disposition
+                        .register_partition(partition, false)
+                        .map_err(|reason| {
+                            ExcelError::new(ExcelErrorKind::Value).with_message(reason)
+                        })?;
+                }
+                replay_disposition
+                    .extend_suppressed_excel_coords(package.suppressed.iter().copied());
+                let replayed = package
+                    .replay
+                    .lock()
+                    .map_err(|_| {
+                        ExcelError::new(ExcelErrorKind::Value)
+                            .with_message("deferred formula spool lock poisoned")
+                    })?
+                    .replay(&replay_disposition)
+                    .map_err(|message| {
+                        ExcelError::new(ExcelErrorKind::Value).with_message(message)
+                    })?;
+                texts.extend(
+                    replayed
+                        .into_iter()
+                        .map(|record| (record.row, record.col, record.text)),
+                );
+            }
+            for (row, col, text) in texts {
+                if text.is_empty() {
+                    continue;
+                }
+                if let Entry::Vacant(slot) = claimed.entry((sheet_id, row, col)) {
+                    let text = if text.starts_with('=') {
+                        text
+                    } else {
+                        format!("={text}")
+                    };
+                    slot.insert(Some(SnapshotPlacement {
+                        row,
+                        col,
+                        root: writer.text(text),
+                        anchor_row: row,
+                        anchor_col: col,
+                    }));
+                }
+            }
+        }
+
+        let overlays: Vec<_> = plane.formula_overlay.active_entries().collect();
+        for (entry, _) in overlays.into_iter().rev() {
+            // An override's template is its formula as written, the way `get_cell`
+            // reports it; overlays carry no literal binding set.
+            let ast_id = match entry.kind {
+                FormulaOverlayEntryKind::FormulaOverride(template_id) => plane
+                    .templates
+                    .get(template_id)
+                    .map(|template| template.ast_id),
+                FormulaOverlayEntryKind::LegacyOwned(vid) => self.graph.get_formula_id(vid),
+                _ => None,
+            };
+            for coord in entry.domain.iter() {
+                let (row, col) = (coord.row + 1, coord.col + 1);
+                if let Entry::Vacant(slot) = claimed.entry((entry.sheet_id, row, col)) {
+                    slot.insert(
+                        ast_id.and_then(|ast_id| {
+                            place(&mut writer, ast_id, None, row, col, (row, col))
+                        }),
+                    );
+                }
+            }
+        }
+
+        let spans: Vec<_> = plane.spans.active_spans().collect();
+        for span in spans.into_iter().rev() {
+            let relocation = span.ast_relocation;
+            let anchor = (relocation.anchor_row, relocation.anchor_col);
+            // Spans whose literals vary by placement write one root per cell with that
+            // cell's literals; the others share the template root.
+            let binding_set = span
+                .binding_set_id
+                .and_then(|id| plane.binding_sets.get(id))
+                .filter(|binding_set| !binding_set.is_single_literal_binding());
+            for coord in span.domain.iter() {
+                let (row, col) = (coord.row + 1, coord.col + 1);
+                let Entry::Vacant(slot) = claimed.entry((span.sheet_id, row, col)) else {
+                    continue;
+                };
+                let placement = match binding_set {
+                    Some(binding_set) => {
+                        let binding = binding_set
+                            .literal_bindings_for_placement(&span.domain, coord)
+                            .ok_or_else(|| {
+                                ExcelError::new(ExcelErrorKind::Value).with_message(
+                                    "FormulaPlane span has no literal binding for a placement",
+                                )
+                            })?;
+                        place(
+                            &mut writer,
+                            relocation.ast_id,
+                            Some(binding.as_ref()),
+                            row,
+                            col,
+                            anchor,
+                        )
+                    }
+                    None => place(&mut writer, relocation.ast_id, None, row, col, anchor),
+                };
+                slot.insert(placement);
+            }
+        }
+
+        for vid in self.graph.vertices_with_formulas() {
+            let Some(ast_id) = self.graph.get_formula_id(vid) else {
+                continue;
+            };
+            let coord = self.graph.vertex_coord(vid);
+            let (row, col) = (coord.row() + 1, coord.col() + 1);
+            let sheet_id = self.graph.get_vertex_sheet_id(vid);
+            if let Entry::Vacant(slot) = claimed.entry((sheet_id, row, col)) {
+                slot.insert(place(&mut writer, ast_id, None, row, col, (row, col)));
+            }
+        }
+
+        let mut by_sheet: FxHashMap<SheetId, Vec<SnapshotPlacement>> = FxHashMap::default();
+        for ((sheet_id, _, _), placement) in claimed {
+            if let Some(placement) = placement {
+                by_sheet.entry(sheet_id).or_default().push(placement);
+            }
+        }
+        let mut image = writer.finish();
+        for (sheet_id, sheet) in sheet_registry.all_sheets() {
+            let Some(mut cells) = by_sheet.remove(&sheet_id) else {
+                continue;
+            };
+            cells.sort_unstable_by_key(|cell| (cell.row, cell.col));
+            image.sheets.push(SnapshotSheetFormulas { sheet, cells });
+        }
+        Ok(image)
+    }
+
+    /// Rebuild the formulas of an image written by [`Engine::formula_snapshot`].
+    ///
+    /// Nodes go straight into the arena and each placement's root is relocated to its
+    /// cell, so nothing is parsed except formulas the image holds as text; those are
+    /// staged instead when `defer_graph_building` is set. Graph construction still runs
+    /// for every formula.
+    pub fn ingest_formula_snapshot(
+        &mut self,
+        formulas: &SnapshotFormulas,
+    ) -> Result<(), ExcelError> {
+        let reader = {
+            let (data_store, sheet_registry) = self.graph.arena_parts_mut();
+            ArenaImageReader::import(data_store, sheet_registry, formulas)?
+        };
+        let mut batches = Vec::with_capacity(formulas.sheets.len());
+        for sheet in &formulas.sheets {
+            let mut records = Vec::with_capacity(sheet.cells.len());
+            for cell in &sheet.cells {
+                let Some(SnapshotAstNode::Text(text)) = formulas.nodes.get(cell.root as usize)
+                else {
+                    let (data_store, _) = self.graph.arena_parts_mut();
+                    let ast_id = relocate_arena_ast(
+                        data_store,
+                        reader.root(cell.root)?,
+                        i64::from(cell.row) - i64::from(cell.anchor_row),
+                        i64::from(cell.col) - i64::from(cell.anchor_col),
+                    )?;
+                    records.push(FormulaIngestRecord::new(cell.row, cell.col, ast_id, None));
+                    continue;
+                };
+                if self.config.defer_graph_building {
+                    self.stage_formula_text(&sheet.sheet, cell.row, cell.col, text.clone());
+                    continue;
+                }
+                let ast = match formualizer_parse::parser::parse(text) {
+                    Ok(parsed) => Some(parsed),
+                    Err(error) => self.handle_formula_parse_error(
+                        &sheet.sheet,
+                        cell.row,
+                        cell.col,
+                        text,
+                        error.to_string(),
+                    )?,
+                };
+                if let Some(ast) = ast {
+                    let ast_id = self.intern_formula_ast(&ast);
+                    records.push(FormulaIngestRecord::new(
+                        cell.row,
+                        cell.col,
+                        ast_id,
+                        Some(Arc::<str>::from(text.as_str())),
+                    ));
+                }
+            }
+            if !records.is_empty() {
+                batches.push(FormulaIngestBatch::new(sheet.sheet.clone(), records));
+            }
+        }
+        if !batches.is_empty() {
+            self.ingest_formula_batches(batches)?;
+        }
+        Ok(())
+    }
+
     /// Begin batch operations - defer CSR rebuilds for better performance
     pub fn begin_batch(&mut self) {
         self.graph.begin_batch();
@@ -16875,8 +17357,7 @@ where
             .expect("cell ref for vertex");
         let interpreter = Interpreter::new_with_cell(self, sheet_name, cell_ref);
 
-        let result =
-            interpreter.evaluate_arena_ast(ast_id, self.graph.data_store(), self.graph.sheet_reg());
+        let result = self.evaluate_formula_root(&interpreter, ast_id);
 
         // If array result, perform spill from the anchor cell
         match result {
@@ -17910,6 +18391,94 @@ where
         self.evaluate_recalc_plan_with_controls(plan, Some(cancel_flag), None)
     }
 
+    /// Register the "hot" regions (typically the visible viewport) whose transitive
+    /// precedents [`Self::evaluate_priority_first`] evaluates before the rest of the
+    /// dirty set. Replaces any previously registered regions.
+    pub fn set_priority_regions(&mut self, regions: Vec<crate::engine::EvaluationTarget>) {
+        self.priority_regions = regions;
+        self.priority_plan = None;
+    }
+
+    pub fn priority_regions(&self) -> &[crate::engine::EvaluationTarget] {
+        &self.priority_regions
+    }
+
+    pub fn clear_priority_regions(&mut self) {
+        self.priority_regions.clear();
+        self.priority_plan = None;
+    }
+
+    /// Evaluate only the precedent cone of the registered priority regions.
+    ///
+    /// The target plan is retained across value edits and rebuilt only when its
+    /// planning revisions go stale, so repeated interactive edits pay preparation
+    /// once. Vertices outside the cone are left dirty.
+    pub fn evaluate_priority_regions(
+        &mut self,
+        cancel_flag: Option<Arc<AtomicBool>>,
+    ) -> Result<EvalResult, ExcelError> {
+        if self.priority_regions.is_empty() {
+            return Ok(EvalResult {
+                computed_vertices: 0,
+                cycle_errors: 0,
+                elapsed: std::time::Duration::ZERO,
+            });
+        }
+        self.graph.flush_pending_edge_deltas();
+        let plan = match self.priority_plan.take() {
+            Some(plan) if self.validate_recalc_plan_key(&plan.key).is_ok() => plan,
+            _ => {
+                let regions = std::mem::take(&mut self.priority_regions);
+                let built = self.build_recalc_plan_for_targets(&regions);
+                self.priority_regions = regions;
+                built?
+            }
+        };
+        let result = self.evaluate_recalc_plan_with_controls(&plan, cancel_flag, None);
+        self.priority_plan = Some(plan);
+        result
+    }
+
+    /// Viewport-first recalculation: evaluate the priority regions' precedent cone,
+    /// hand the engine to `publish` so visible values can be pushed to the UI, then
+    /// finish the remaining dirty set under `cancel_flag`.
+    ///
+    /// Callers typically run this on a worker thread and raise `cancel_flag` when a
+    /// new edit arrives. Cancelling the background phase is not an error: the
+    /// unfinished vertices stay dirty and `background_cancelled` is set. A cancel
+    /// observed before the hot phase completes is reported as `Cancelled`.
+    pub fn evaluate_priority_first<F>(
+        &mut self,
+        cancel_flag: Arc<AtomicBool>,
+        publish: F,
+    ) -> Result<PriorityEvalResult, ExcelError>
+    where
+        F: FnOnce(&Self, &EvalResult),
+    {
+        let hot = self.evaluate_priority_regions(Some(Arc::clone(&cancel_flag)))?;
+        publish(&*self, &hot);
+        if cancel_flag.load(Ordering::Relaxed) {
+            return Ok(PriorityEvalResult {
+                hot,
+                background: None,
+                background_cancelled: true,
+            });
+        }
+        match self.evaluate_all_cancellable(cancel_flag) {
+            Ok(background) => Ok(PriorityEvalResult {
+                hot,
+                background: Some(background),
+                background_cancelled: false,
+            }),
+            Err(err) if err.kind == ExcelErrorKind::Cancelled => Ok(PriorityEvalResult {
+                hot,
+                background: None,
+                background_cancelled: true,
+            }),
+            Err(err) => Err(err),
+        }
+    }
+
     fn evaluate_recalc_plan_unobserved(
         &mut self,
         plan: &RecalcPlan,
@@ -18365,14 +18934,21 @@ where
                             };
                             let current_sheet = self.graph.sheet_name(sheet_id);
                             let authority = self.graph.formula_authority();
-                            let evaluator = SpanEvaluator::new_with_cancel(
+                            let mut evaluator = SpanEvaluator::new_with_cancel(
                                 &authority.plane,
                                 self,
                                 current_sheet,
                                 self.graph.data_store(),
                                 self.graph.sheet_reg(),
                                 self.active_cancel_flag.as_deref(),
-                            );
+                            )
+                            .with_columnar(self.config.enable_columnar_spans);
+                            if self.config.enable_span_jit {
+                                evaluator = evaluator.with_jit(
+                                    &self.span_jit,
+                                    self.config.span_jit_tier_up_placements,
+                                );
+                            }
                             #[cfg(test)]
                             let mut last_group_report = None;
                             let mut selected_group_work = 0_u64;
@@ -20047,16 +20623,19 @@ where
             cycle_errors += pass_cycles;
 
             // Check if dynamic dependencies changed
-            let changed_vertices = self.changed_virtual_dep_vertices(&to_evaluate, &old_vdeps);
+            let changed_vertices = self.changed_dynamic_vertices(
+                &to_evaluate,
+                &old_vdeps,
+                &schedule,
+                telemetry.as_mut(),
+            );
             if let Some(t) = telemetry.as_mut() {
                 t.changed_vdeps_total += changed_vertices.len();
             }
 
             self.resource_checkpoint(0)?;
             self.graph.clear_dirty_flags(&to_evaluate);
-            for v in &changed_vertices {
-                self.graph.set_dirty(*v, true);
-            }
+            self.redirty_changed_dynamic_vertices(&to_evaluate, &changed_vertices);
 
             if changed_vertices.is_empty() {
                 if let Some(t) = telemetry.as_mut() {
@@ -20191,15 +20770,18 @@ where
                 }
             }
 
-            let changed_vertices = self.changed_virtual_dep_vertices(&to_evaluate, &old_vdeps);
+            let changed_vertices = self.changed_dynamic_vertices(
+                &to_evaluate,
+                &old_vdeps,
+                &schedule,
+                telemetry.as_mut(),
+            );
             if let Some(t) = telemetry.as_mut() {
                 t.changed_vdeps_total += changed_vertices.len();
             }
             self.resource_checkpoint(0)?;
             self.graph.clear_dirty_flags(&to_evaluate);
-            for v in &changed_vertices {
-                self.graph.set_dirty(*v, true);
-            }
+            self.redirty_changed_dynamic_vertices(&to_evaluate, &changed_vertices);
 
             if changed_vertices.is_empty() {
                 if let Some(t) = telemetry.as_mut() {
@@ -20554,6 +21136,10 @@ where
         // Fold pending edge deltas once per schedule build so traversal uses
         // the zero-allocation CSR slices (#125).
         self.graph.flush_pending_edge_deltas();
+        // A new schedule follows writes made by the previous one (replans,
+        // misspeculation re-runs), so shared values from it may be stale.
+        self.shared_subexpressions.invalidate();
+        self.pure_call_memo.invalidate_cell_reads();
         if self.can_use_static_schedule_cache(to_evaluate) {
             if let Some(cached) = self.cached_static_schedule.as_ref()
                 && cached.topology_epoch == self.topology_epoch
@@ -20567,6 +21153,7 @@ where
                     used_virtual_schedule: false,
                     schedule_cache_hit: true,
                     schedule_cache_eligible: true,
+                    speculated_vertices: 0,
                 };
                 return Ok((cached.schedule.clone(), FxHashMap::default(), meta));
             }
@@ -20588,6 +21175,7 @@ where
         let (schedule, vdeps, mut meta) = self.create_evaluation_schedule_uncached(to_evaluate)?;
         meta.schedule_cache_hit = false;
         meta.schedule_cache_eligible = false;
+        self.speculation_stats.speculated += meta.speculated_vertices as u64;
         Ok((schedule, vdeps, meta))
     }
 
@@ -20596,16 +21184,30 @@ where
         to_evaluate: &[VertexId],
     ) -> Result<ScheduleBuildOutput, ExcelError> {
         let builder = VirtualDepBuilder::new(self);
-        let (vdeps, augmented, builder_elapsed_ms, vdeps_edges) =
+        let build = || {
+            if self.config.speculative_dynamic_refs {
+                builder.build_speculative(to_evaluate, &self.speculative_dynamic_deps)
+            } else {
+                let (vdeps, augmented) = builder.build(to_evaluate);
+                (vdeps, augmented, 0)
+            }
+        };
+        let (vdeps, augmented, speculated_vertices, builder_elapsed_ms, vdeps_edges) =
             if self.config.enable_virtual_dep_telemetry {
                 let build_started = crate::instant::FzInstant::now();
-                let (vdeps, augmented) = builder.build(to_evaluate);
+                let (vdeps, augmented, speculated) = build();
                 let builder_elapsed_ms = build_started.elapsed().as_millis();
                 let vdeps_edges = vdeps.values().map(|deps| deps.len()).sum::<usize>();
-                (vdeps, augmented, builder_elapsed_ms, vdeps_edges)
+                (
+                    vdeps,
+                    augmented,
+                    speculated,
+                    builder_elapsed_ms,
+                    vdeps_edges,
+                )
             } else {
-                let (vdeps, augmented) = builder.build(to_evaluate);
-                (vdeps, augmented, 0, 0)
+                let (vdeps, augmented, speculated) = build();
+                (vdeps, augmented, speculated, 0, 0)
             };
 
         let mut final_evaluate = to_evaluate.to_vec();
@@ -20632,6 +21234,7 @@ where
             used_virtual_schedule: use_virtual,
             schedule_cache_hit: false,
             schedule_cache_eligible: false,
+            speculated_vertices,
         };
 
         Ok((schedule, vdeps, meta))
@@ -20656,6 +21259,7 @@ where
         telemetry.vdeps_vertices_total += meta.vdeps_vertices;
         telemetry.vdeps_edges_total += meta.vdeps_edges;
         telemetry.builder_elapsed_ms_total += meta.builder_elapsed_ms;
+        telemetry.speculation.speculated += meta.speculated_vertices as u64;
         if meta.schedule_cache_eligible {
             if meta.schedule_cache_hit {
                 telemetry.schedule_cache_hits += 1;
@@ -20764,6 +21368,97 @@ where
         changed
     }
 
+    /// Vertices to re-run after a pass over `to_evaluate`. Conservative mode
+    /// compares virtual deps before and after the pass; speculative mode
+    /// validates what each dynamic-reference vertex reads against the schedule
+    /// order and records those reads as its next speculation set.
+    fn changed_dynamic_vertices(
+        &mut self,
+        to_evaluate: &[VertexId],
+        old_vdeps: &FxHashMap<VertexId, Vec<VertexId>>,
+        schedule: &crate::engine::Schedule,
+        telemetry: Option<&mut VirtualDepTelemetry>,
+    ) -> Vec<VertexId> {
+        if !self.config.speculative_dynamic_refs {
+            return self.changed_virtual_dep_vertices(to_evaluate, old_vdeps);
+        }
+        if !to_evaluate.iter().any(|&v| self.graph.is_dynamic(v)) {
+            return Vec::new();
+        }
+
+        let mut position: FxHashMap<VertexId, (usize, bool)> = FxHashMap::default();
+        for (index, &unit) in schedule.units.iter().enumerate() {
+            let (members, is_cycle) = match unit {
+                ScheduleUnit::Cycle(i) => (schedule.unit_cycle(i), true),
+                ScheduleUnit::Layer(i) => (schedule.unit_layer(i).vertices.as_slice(), false),
+            };
+            for &vertex in members {
+                position.insert(vertex, (index, is_cycle));
+            }
+        }
+
+        // A read is safe when the read vertex was not evaluated in this pass or
+        // finished in an earlier unit. Same-layer reads raced; same-cycle reads
+        // belong to the cycle policy.
+        let mut stats = SpeculationStats::default();
+        let mut misses = Vec::new();
+        for &vertex in to_evaluate {
+            if !self.graph.is_dynamic(vertex) {
+                continue;
+            }
+            let Some(&(at, _)) = position.get(&vertex) else {
+                continue;
+            };
+            let reads = DynamicRefVirtualDepProvider::resolved_formula_reads(self, vertex);
+            let ordered = reads.iter().all(|read| match position.get(read) {
+                None => true,
+                Some(&(read_at, is_cycle)) => read_at < at || (read_at == at && is_cycle),
+            });
+            if ordered {
+                stats.hits += 1;
+            } else {
+                stats.misses += 1;
+                misses.push(vertex);
+            }
+            self.speculative_dynamic_deps.insert(vertex, reads);
+        }
+
+        self.speculation_stats.hits += stats.hits;
+        self.speculation_stats.misses += stats.misses;
+        if let Some(telemetry) = telemetry {
+            telemetry.speculation.accumulate(stats);
+        }
+        misses
+    }
+
+    /// Re-dirty vertices reported by [`Self::changed_dynamic_vertices`] after the
+    /// pass cleared its dirty flags. Misspeculated vertices may have published
+    /// wrong values, so speculative mode also re-dirties their dependents and,
+    /// transitively, every dynamic vertex of the pass that read one of them.
+    fn redirty_changed_dynamic_vertices(&mut self, to_evaluate: &[VertexId], changed: &[VertexId]) {
+        if !self.config.speculative_dynamic_refs {
+            for &vertex in changed {
+                self.graph.set_dirty(vertex, true);
+            }
+            return;
+        }
+        let mut affected: FxHashSet<VertexId> = FxHashSet::default();
+        let mut pending = changed.to_vec();
+        while !pending.is_empty() {
+            affected.extend(self.graph.mark_dirty_many(&pending));
+            pending = to_evaluate
+                .iter()
+                .copied()
+                .filter(|vertex| !affected.contains(vertex) && self.graph.is_dynamic(*vertex))
+                .filter(|vertex| {
+                    self.speculative_dynamic_deps
+                        .get(vertex)
+                        .is_some_and(|reads| reads.iter().any(|read| affected.contains(read)))
+                })
+                .collect();
+        }
+    }
+
     /// Build a demand-driven subgraph for the given targets, including ephemeral edges for
     /// compressed ranges, and returning the set of dirty/volatile precedents and virtual deps.
     fn build_demand_subgraph(
@@ -20988,15 +21683,18 @@ where
                 }
             }
 
-            let changed_vertices = self.changed_virtual_dep_vertices(&to_evaluate, &old_vdeps);
+            let changed_vertices = self.changed_dynamic_vertices(
+                &to_evaluate,
+                &old_vdeps,
+                &schedule,
+                telemetry.as_mut(),
+            );
             if let Some(t) = telemetry.as_mut() {
                 t.changed_vdeps_total += changed_vertices.len();
             }
             self.resource_checkpoint(0)?;
             self.graph.clear_dirty_flags(&to_evaluate);
-            for v in &changed_vertices {
-                self.graph.set_dirty(*v, true);
-            }
+            self.redirty_changed_dynamic_vertices(&to_evaluate, &changed_vertices);
 
             if changed_vertices.is_empty() {
                 if let Some(t) = telemetry.as_mut() {
@@ -21581,6 +22279,33 @@ where
         }
     }
 
+    /// Evaluate the formula rooted at `ast_id` through the bytecode VM when it
+    /// is enabled and the formula lowers; otherwise walk the arena tree.
+    fn evaluate_formula_root<'c>(
+        &self,
+        interpreter: &Interpreter<'c>,
+        ast_id: AstNodeId,
+    ) -> Result<crate::traits::CalcValue<'c>, ExcelError> {
+        let data_store = self.graph.data_store();
+        let sheet_reg = self.graph.sheet_reg();
+        let result = if self.config.enable_bytecode_vm
+            && interpreter.is_plain_formula_context()
+            && let Some(program) =
+                self.bytecode_programs
+                    .program(ast_id, data_store, interpreter.context)
+        {
+            self.bytecode_programs.note_vm_eval();
+            program.run(interpreter, data_store, sheet_reg)
+        } else {
+            self.bytecode_programs.note_tree_eval();
+            interpreter.evaluate_arena_ast(ast_id, data_store, sheet_reg)
+        };
+        // Scratch temporaries never outlive the builtin that borrowed them,
+        // so the arena is free to reset once the root has a value.
+        self.eval_allocations.end_vertex();
+        result
+    }
+
     /// Evaluate a single vertex without mutating the graph (for parallel evaluation)
     fn evaluate_vertex_immutable(&self, vertex_id: VertexId) -> Result<LiteralValue, ExcelError> {
         // Check if vertex exists
@@ -21742,8 +22467,7 @@ where
             .expect("cell ref for vertex");
         let interpreter = Interpreter::new_with_cell(self, sheet_name, cell_ref);
 
-        interpreter
-            .evaluate_arena_ast(ast_id, self.graph.data_store(), self.graph.sheet_reg())
+        self.evaluate_formula_root(&interpreter, ast_id)
             .map(|cv| cv.into_literal())
     }
 
@@ -21751,6 +22475,59 @@ where
     pub fn thread_pool(&self) -> Option<&Arc<rayon::ThreadPool>> {
         self.thread_pool.as_ref()
     }
+
+    /// Bytecode compilation and VM/tree evaluation counters.
+    pub fn bytecode_stats(&self) -> crate::bytecode::BytecodeStats {
+        self.bytecode_programs.stats()
+    }
+
+    /// Shared-subexpression counts: nodes found shared at ingest, cache fills,
+    /// and evaluations saved by reuse.
+    pub fn shared_subexpression_stats(&self) -> crate::engine::cse::SharedSubexpressionStats {
+        self.shared_subexpressions
+            .stats(self.graph.data_store().subexpressions().shared_count())
+    }
+
+    /// Constant folding counts: subtrees folded at ingest, how many hold
+    /// arrays, and evaluations answered by a folded value.
+    pub fn constant_fold_stats(&self) -> crate::engine::ConstantFoldStats {
+        self.graph.data_store().constants().stats()
+    }
+
+    /// Span JIT counts: kernels compiled, hot programs left on the lane
+    /// executor, kernel runs, and rows deoptimized to the interpreter.
+    pub fn span_jit_stats(&self) -> crate::formula_plane::span_jit::SpanJitStats {
+        self.span_jit.stats()
+    }
+
+    /// Interpreter allocation counts: vertex evaluations, temporaries served
+    /// from the per-thread scratch arena, and array results allocated afresh
+    /// versus rewritten in place.
+    pub fn eval_allocation_stats(&self) -> crate::scratch::EvalAllocationStats {
+        self.eval_allocations.stats()
+    }
+
+    /// Pure-call memo counts: hits, misses, live entries and bytes, and
+    /// budget evictions.
+    pub fn pure_call_memo_stats(&self) -> crate::engine::pure_memo::PureCallMemoStats {
+        self.pure_call_memo.stats()
+    }
+
+    /// Range cells builtins copied into owned values instead of reading
+    /// them through a `RangeView`.
+    pub fn range_materialization_stats(&self) -> crate::engine::RangeMaterializationStats {
+        let total_cells = self.graph.data_store().materialized_cells();
+        crate::engine::RangeMaterializationStats {
+            total_cells,
+            last_recalc_cells: total_cells.saturating_sub(self.materialized_cells_at_request),
+        }
+    }
+
+    /// Number of NUMA node pools layer work is routed across; 1 unless
+    /// `ThreadPlacement::PerNode` found more than one node.
+    pub fn numa_node_count(&self) -> usize {
+        self.node_pools.as_ref().map_or(1, |pools| pools.len())
+    }
 }
 
 #[derive(Default)]
@@ -22405,6 +23182,18 @@ where
         self.thread_pool.as_ref()
     }
 
+    fn shared_subexpressions(&self) -> Option<&crate::engine::cse::SharedSubexpressionCache> {
+        self.config
+            .enable_shared_subexpressions
+            .then_some(&self.shared_subexpressions)
+    }
+
+    fn pure_call_memo(&self) -> Option<&crate::engine::pure_memo::PureCallMemo> {
+        self.config
+            .enable_pure_call_memo
+            .then_some(&self.pure_call_memo)
+    }
+
     fn cancellation_token(&self) -> Option<Arc<std::sync::atomic::AtomicBool>> {
         self.active_cancel_flag.clone()
     }
@@ -23379,6 +24168,23 @@ where
     /// Returns the number of `#CIRC!`-stamped vertices, so call sites can
     /// keep their `cycle_errors` accounting (`> 0` ⇒ count the unit).
     fn handle_cycle_unit(
+        &mut self,
+        cycle: &[VertexId],
+        delta: Option<&mut DeltaCollector>,
+        dirty_filter: Option<&FxHashSet<VertexId>>,
+        cancel_flag: Option<&AtomicBool>,
+    ) -> Result<usize, ExcelError> {
+        // SCC iterations rewrite member values mid-schedule; keep shared
+        // values computed from intermediate iterates out of either side.
+        self.shared_subexpressions.invalidate();
+        self.pure_call_memo.invalidate_cell_reads();
+        let result = self.handle_cycle_unit_inner(cycle, delta, dirty_filter, cancel_flag);
+        self.shared_subexpressions.invalidate();
+        self.pure_call_memo.invalidate_cell_reads();
+        result
+    }
+
+    fn handle_cycle_unit_inner(
         &mut self,
         cycle: &[VertexId],
         mut delta: Option<&mut DeltaCollector>,
@@ -23994,8 +24800,7 @@ where
                     .get_cell_ref(vertex_id)
                     .expect("cell ref for vertex");
                 let interpreter = Interpreter::new_with_cell(ctx, sheet_name, cell_ref);
-                interpreter
-                    .evaluate_arena_ast(ast_id, self.graph.data_store(), self.graph.sheet_reg())
+                self.evaluate_formula_root(&interpreter, ast_id)
                     .map(|cv| cv.into_literal())
             }
             VertexKind::NamedScalar | VertexKind::NamedArray => {
@@ -24968,13 +25773,67 @@ where
         Ok(layer.vertices.len())
     }
 
+    /// Map `f` over `group` on the engine pool. Under
+    /// `ThreadPlacement::PerNode` each vertex runs on the pool of the NUMA node
+    /// owning its cell (sheet base node, striped by Arrow row chunk); results
+    /// keep `group` order either way.
+    fn par_map_layer_group<T, F>(
+        &self,
+        thread_pool: &rayon::ThreadPool,
+        group: &[VertexId],
+        f: F,
+    ) -> Result<Vec<T>, ExcelError>
+    where
+        T: Send,
+        F: Fn(VertexId) -> Result<T, ExcelError> + Sync,
+    {
+        use rayon::prelude::*;
+
+        let Some(pools) = self.node_pools.as_ref().filter(|pools| pools.len() > 1) else {
+            return thread_pool.install(|| group.par_iter().map(|&vid| f(vid)).collect());
+        };
+        let nodes = pools.len();
+        let mut sheet_routes: FxHashMap<SheetId, (usize, usize)> = FxHashMap::default();
+        let mut parts: Vec<Vec<usize>> = vec![Vec::new(); nodes];
+        for (idx, &vid) in group.iter().enumerate() {
+            let sheet_id = self.graph.get_vertex_sheet_id(vid);
+            let (base, chunk_rows) = *sheet_routes.entry(sheet_id).or_insert_with(|| {
+                let chunk_rows = self
+                    .arrow_sheets
+                    .sheet(self.graph.sheet_name(sheet_id))
+                    .map_or(32 * 1024, |sheet| sheet.chunk_rows);
+                (
+                    self.sheet_node_owners.base_node(sheet_id, nodes),
+                    chunk_rows,
+                )
+            });
+            let row0 = self.graph.vertex_coord(vid).row();
+            parts[crate::engine::numa::owner_node(base, row0, chunk_rows, nodes)].push(idx);
+        }
+
+        let f = &f;
+        let per_node = pools.run_parts(&parts, &|part: &[usize]| {
+            part.par_iter()
+                .map(|&idx| f(group[idx]).map(|value| (idx, value)))
+                .collect::<Result<Vec<_>, ExcelError>>()
+        });
+        let mut ordered: Vec<Option<T>> = (0..group.len()).map(|_| None).collect();
+        for part in per_node.into_iter().flatten() {
+            for (idx, value) in part? {
+                ordered[idx] = Some(value);
+            }
+        }
+        Ok(ordered
+            .into_iter()
+            .map(|value| value.expect("every layer vertex is routed to one node"))
+            .collect())
+    }
+
     /// Evaluate a layer in parallel, applying via effects pipeline.
     fn evaluate_layer_parallel_effects(
         &mut self,
         layer: &super::scheduler::Layer,
     ) -> Result<usize, ExcelError> {
-        use rayon::prelude::*;
-
         let thread_pool = self.thread_pool.as_ref().unwrap().clone();
 
         let mut phase1: Vec<VertexId> = Vec::new();
@@ -24996,17 +25855,12 @@ where
             }
             let mut computed_writes = ComputedWriteBuffer::default();
 
-            let results: Result<Vec<(VertexId, LiteralValue)>, ExcelError> =
-                thread_pool.install(|| {
-                    group
-                        .par_iter()
-                        .map(
-                            |&vertex_id| match self.evaluate_vertex_immutable(vertex_id) {
-                                Ok(v) => Ok((vertex_id, v)),
-                                Err(e) => Ok((vertex_id, LiteralValue::Error(e))),
-                            },
-                        )
-                        .collect()
+            let results: Result<Vec<(VertexId, LiteralValue)>, ExcelError> = self
+                .par_map_layer_group(&thread_pool, group, |vertex_id| {
+                    match self.evaluate_vertex_immutable(vertex_id) {
+                        Ok(v) => Ok((vertex_id, v)),
+                        Err(e) => Ok((vertex_id, LiteralValue::Error(e))),
+                    }
                 });
 
             match results {
@@ -25095,8 +25949,6 @@ where
         layer: &super::scheduler::Layer,
         delta: &mut DeltaCollector,
     ) -> Result<usize, ExcelError> {
-        use rayon::prelude::*;
-
         let thread_pool = self.thread_pool.as_ref().unwrap().clone();
 
         let mut phase1: Vec<VertexId> = Vec::new();
@@ -25117,17 +25969,12 @@ where
                 continue;
             }
             let mut computed_writes = ComputedWriteBuffer::default();
-            let results: Result<Vec<(VertexId, LiteralValue)>, ExcelError> =
-                thread_pool.install(|| {
-                    group
-                        .par_iter()
-                        .map(
-                            |&vertex_id| match self.evaluate_vertex_immutable(vertex_id) {
-                                Ok(v) => Ok((vertex_id, v)),
-                                Err(e) => Ok((vertex_id, LiteralValue::Error(e))),
-                            },
-                        )
-                        .collect()
+            let results: Result<Vec<(VertexId, LiteralValue)>, ExcelError> = self
+                .par_map_layer_group(&thread_pool, group, |vertex_id| {
+                    match self.evaluate_vertex_immutable(vertex_id) {
+                        Ok(v) => Ok((vertex_id, v)),
+                        Err(e) => Ok((vertex_id, LiteralValue::Error(e))),
+                    }
                 });
 
             match results {
@@ -25212,8 +26059,6 @@ where
         layer: &super::scheduler::Layer,
         cancel_flag: &AtomicBool,
     ) -> Result<usize, ExcelError> {
-        use rayon::prelude::*;
-
         let thread_pool = self.thread_pool.as_ref().unwrap().clone();
 
         if cancel_flag.load(Ordering::Relaxed) {
@@ -25240,24 +26085,17 @@ where
             }
             let mut computed_writes = ComputedWriteBuffer::default();
 
-            let results: Result<Vec<(VertexId, LiteralValue)>, ExcelError> =
-                thread_pool.install(|| {
-                    group
-                        .par_iter()
-                        .map(|&vertex_id| {
-                            if cancel_flag.load(Ordering::Relaxed) {
-                                return Err(ExcelError::new(ExcelErrorKind::Cancelled)
-                                    .with_message(
-                                        "Parallel evaluation cancelled during execution"
-                                            .to_string(),
-                                    ));
-                            }
-                            match self.evaluate_vertex_immutable(vertex_id) {
-                                Ok(v) => Ok((vertex_id, v)),
-                                Err(e) => Ok((vertex_id, LiteralValue::Error(e))),
-                            }
-                        })
-                        .collect()
+            let results: Result<Vec<(VertexId, LiteralValue)>, ExcelError> = self
+                .par_map_layer_group(&thread_pool, group, |vertex_id| {
+                    if cancel_flag.load(Ordering::Relaxed) {
+                        return Err(ExcelError::new(ExcelErrorKind::Cancelled).with_message(
+                            "Parallel evaluation cancelled during execution".to_string(),
+                        ));
+                    }
+                    match self.evaluate_vertex_immutable(vertex_id) {
+                        Ok(v) => Ok((vertex_id, v)),
+                        Err(e) => Ok((vertex_id, LiteralValue::Error(e))),
+                    }
                 });
 
             match results {
@@ -25420,15 +26258,18 @@ where
                     }
                 }
 
-                let changed_vertices = self.changed_virtual_dep_vertices(&to_evaluate, &old_vdeps);
+                let changed_vertices = self.changed_dynamic_vertices(
+                    &to_evaluate,
+                    &old_vdeps,
+                    &schedule,
+                    telemetry.as_mut(),
+                );
                 if let Some(t) = telemetry.as_mut() {
                     t.changed_vdeps_total += changed_vertices.len();
                 }
                 self.resource_checkpoint(0)?;
                 self.graph.clear_dirty_flags(&to_evaluate);
-                for v in &changed_vertices {
-                    self.graph.set_dirty(*v, true);
-                }
+                self.redirty_changed_dynamic_vertices(&to_evaluate, &changed_vertices);
 
                 if changed_vertices.is_empty() {
                     if let Some(t) = telemetry.as_mut() {
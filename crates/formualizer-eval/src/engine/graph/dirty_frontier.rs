@@ -0,0 +1,180 @@
+//! Level-synchronous dirty propagation.
+//!
+//! `mark_dirty_many` and `mark_dirty_many_value_cells` seed a frontier and hand
+//! it to [`DependencyGraph::propagate_dirty_frontier`], which expands one BFS
+//! level at a time. A dense `VertexId`-indexed bitset claims each vertex with an
+//! atomic fetch-or, so a level at least
+//! `EvalConfig::parallel_dirty_propagation_threshold` wide is expanded on the
+//! engine pool without a shared seen-set. Expanding a claimed vertex pushes its
+//! direct dependents (CSR in-edges) and its range dependents (stripe index) into
+//! the next level in the same pass.
+
+use super::*;
+use rayon::prelude::*;
+use std::sync::Arc;
+use std::sync::atomic::{AtomicU64, Ordering as AtomicOrdering};
+
+/// Vertices per rayon task when a level is expanded in parallel.
+const FRONTIER_CHUNK: usize = 512;
+
+/// Dense claim bitset indexed by raw `VertexId`. Retained on the graph between
+/// calls; only the words touched by a walk are cleared afterwards.
+#[derive(Debug, Default)]
+pub(super) struct FrontierBitset {
+    words: Vec<AtomicU64>,
+}
+
+impl FrontierBitset {
+    fn ensure_index(&mut self, idx: usize) {
+        let needed = idx / 64 + 1;
+        if self.words.len() < needed {
+            self.words
+                .resize_with(needed.next_power_of_two(), || AtomicU64::new(0));
+        }
+    }
+
+    /// Claim `idx`; returns true only for the first claimant.
+    #[inline]
+    fn claim(&self, idx: usize) -> bool {
+        let bit = 1u64 << (idx % 64);
+        self.words[idx / 64].fetch_or(bit, AtomicOrdering::Relaxed) & bit == 0
+    }
+
+    /// Reset every word holding a claimed bit. Each set bit belongs to a vertex
+    /// in `claimed`, so whole words can be zeroed.
+    fn clear(&mut self, claimed: &[VertexId]) {
+        for id in claimed {
+            *self.words[id.0 as usize / 64].get_mut() = 0;
+        }
+    }
+}
+
+impl DependencyGraph {
+    /// Pool used to expand wide dirty-propagation frontiers. `None` keeps
+    /// propagation on the calling thread.
+    pub(crate) fn set_dirty_propagation_pool(&mut self, pool: Option<Arc<rayon::ThreadPool>>) {
+        self.dirty_propagation_pool = pool;
+    }
+
+    /// Mark every vertex reachable from `frontier` dirty, visiting each at most
+    /// once. Returns the claimed vertices (unordered). Frontier entries are
+    /// claimed themselves, so callers seed formula sources directly and value
+    /// sources only through their dependents.
+    pub(super) fn propagate_dirty_frontier(
+        &mut self,
+        mut frontier: Vec<VertexId>,
+    ) -> Vec<VertexId> {
+        let mut seen = std::mem::take(&mut self.dirty_frontier_seen);
+        let threshold = self.config.parallel_dirty_propagation_threshold.max(1);
+        let pool = self.dirty_propagation_pool.clone();
+        let mut claimed: Vec<VertexId> = Vec::new();
+
+        while !frontier.is_empty() {
+            if let Some(max) = frontier.iter().map(|v| v.0 as usize).max() {
+                seen.ensure_index(max);
+            }
+            let graph = &*self;
+            let seen_ref = &seen;
+            frontier = match pool.as_ref() {
+                Some(pool) if frontier.len() >= threshold => {
+                    let parts: Vec<(Vec<VertexId>, Vec<VertexId>)> = pool.install(|| {
+                        frontier
+                            .par_chunks(FRONTIER_CHUNK)
+                            .map(|chunk| {
+                                let mut level_claimed = Vec::new();
+                                let mut next = Vec::new();
+                                graph.expand_dirty_chunk(
+                                    seen_ref,
+                                    chunk,
+                                    &mut level_claimed,
+                                    &mut next,
+                                );
+                                (level_claimed, next)
+                            })
+                            .collect()
+                    });
+                    let mut next = Vec::with_capacity(parts.iter().map(|(_, n)| n.len()).sum());
+                    for (level_claimed, level_next) in parts {
+                        claimed.extend(level_claimed);
+                        next.extend(level_next);
+                    }
+                    next
+                }
+                _ => {
+                    let mut next = Vec::new();
+                    graph.expand_dirty_chunk(seen_ref, &frontier, &mut claimed, &mut next);
+                    next
+                }
+            };
+        }
+
+        self.dirty_propagation_visits += claimed.len() as u64;
+        seen.clear(&claimed);
+        self.dirty_frontier_seen = seen;
+        claimed
+    }
+
+    fn expand_dirty_chunk(
+        &self,
+        seen: &FrontierBitset,
+        chunk: &[VertexId],
+        claimed: &mut Vec<VertexId>,
+        next: &mut Vec<VertexId>,
+    ) {
+        for &id in chunk {
+            if !seen.claim(id.0 as usize) {
+                continue;
+            }
+            claimed.push(id);
+            self.store.set_dirty(id, true);
+            if let Some(dependents) = self.dependents_slice(id) {
+                next.extend_from_slice(dependents);
+            } else {
+                next.extend(self.get_dependents(id));
+            }
+            self.extend_range_dependents_for_vertex(id, next);
+        }
+    }
+
+    /// Single-cell counterpart of `collect_range_dependents_for_rect` for the
+    /// propagation pass: candidates are pushed straight into `out` without a
+    /// per-vertex set and may repeat; the claim bitset deduplicates them.
+    pub(super) fn extend_range_dependents_for_vertex(
+        &self,
+        vertex_id: VertexId,
+        out: &mut Vec<VertexId>,
+    ) {
+        if self.stripe_to_dependents.is_empty() {
+            return;
+        }
+        if !matches!(
+            self.store.kind(vertex_id),
+            VertexKind::Cell
+                | VertexKind::Empty
+                | VertexKind::FormulaScalar
+                | VertexKind::FormulaArray
+        ) {
+            return;
+        }
+        let view = self.store.view(vertex_id);
+        let (sheet_id, row, col) = (view.sheet_id(), view.row(), view.col());
+
+        let mut push_stripe = |stripe_type: StripeType, index: u32| {
+            let key = StripeKey {
+                sheet_id,
+                stripe_type,
+                index,
+            };
+            if let Some(deps) = self.stripe_to_dependents.get(&key) {
+                out.extend(deps.iter().copied().filter(|&dep| {
+                    self.formula_range_overlaps_rect(dep, sheet_id, row, col, row, col)
+                }));
+            }
+        };
+        push_stripe(StripeType::Column, col);
+        push_stripe(StripeType::Row, row);
+        if self.config.enable_block_stripes {
+            push_stripe(StripeType::Block, block_index(row, col));
+        }
+    }
+}
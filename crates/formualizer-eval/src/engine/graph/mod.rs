@@ -23,6 +23,7 @@ pub struct GraphInstrumentation {
 }
 
 mod ast_utils;
+mod dirty_frontier;
 pub mod editor;
 mod formula_analysis;
 mod formula_dirty;
@@ -44,7 +45,7 @@ use super::vertex::{VertexId, VertexKind};
 use super::vertex_store::{FIRST_NORMAL_VERTEX, VertexStore};
 use crate::engine::topo::{
     GraphAdapter,
-    pk::{DynamicTopo, PkConfig},
+    pk::{DynamicTopo, PkConfig, PkTelemetry},
 };
 use crate::reference::{CellRef, Coord, SharedRangeRef, SharedRef, SharedSheetLocator};
 use formualizer_common::Coord as AbsCoord;
@@ -53,7 +54,6 @@ pub(crate) use formula_dirty::{
     FormulaDirtyEventSnapshot, FormulaDirtyLease, FormulaDirtyStats, FormulaDirtySublease,
     WholeSpanDirtyReason,
 };
-// topo::pk wiring will be integrated behind config.use_dynamic_topo in a follow-up step
 
 struct RegistryFunctionProvider;
 
@@ -200,6 +200,10 @@ pub struct DependencyGraph {
     /// counter used by perf-shape tests to assert propagation work is
     /// O(component), not O(sources × component).
     dirty_propagation_visits: u64,
+    /// Claim bitset reused across propagation walks (see `dirty_frontier`).
+    dirty_frontier_seen: dirty_frontier::FrontierBitset,
+    /// Engine pool for expanding wide dirty frontiers; set by the engine.
+    dirty_propagation_pool: Option<std::sync::Arc<rayon::ThreadPool>>,
 
     /// Nesting depth of active deferred-dirty scopes (`begin_deferred_dirty`
     /// / `end_deferred_dirty`). While > 0, dirty-propagation entry points
@@ -1200,6 +1204,8 @@ impl DependencyGraph {
             load_packed_to_vertex: std::collections::HashMap::with_hasher(CoordBuildHasher),
             formula_dirty: FormulaDirtyState::default(),
             dirty_propagation_visits: 0,
+            dirty_frontier_seen: Default::default(),
+            dirty_propagation_pool: None,
             deferred_dirty_depth: 0,
             deferred_dirty_pending: Vec::new(),
             volatile_vertices: FxHashSet::default(),
@@ -1280,11 +1286,99 @@ impl DependencyGraph {
         )
     }
 
+    /// Layers for `subset` read directly off the maintained PK order, skipping SCC
+    /// detection. `None` when dynamic topology is disabled or the order cannot vouch
+    /// for the subset (stale, or an in-subset edge points backwards, e.g. a cycle).
+    pub(crate) fn pk_ordered_layers_for(
+        &self,
+        subset: &[VertexId],
+    ) -> Option<Vec<crate::engine::Layer>> {
+        let pk = self.pk_order.as_ref()?;
+        let adapter = crate::engine::topo::GraphAdapter { g: self };
+        let layers = pk.ordered_layers_for(&adapter, subset, self.config.max_layer_width)?;
+        Some(
+            layers
+                .into_iter()
+                .map(|mut vs| {
+                    // Same deterministic in-layer order as `Scheduler::build_layers`.
+                    vs.sort_unstable();
+                    crate::engine::Layer { vertices: vs }
+                })
+                .collect(),
+        )
+    }
+
+    /// Rebuild the PK order once if insertions since the last evaluation fell back
+    /// past `pk_visit_budget` (or accepted a cycle-closing edge). Returns true when a
+    /// rebuild ran.
+    pub(crate) fn refresh_dynamic_topo(&mut self) -> bool {
+        let Some(mut pk) = self.pk_order.take() else {
+            return false;
+        };
+        let rebuilt = {
+            let adapter = GraphAdapter { g: self };
+            pk.refresh(&adapter)
+        };
+        self.pk_order = Some(pk);
+        rebuilt
+    }
+
+    /// Cumulative PK maintenance counters when dynamic topology is enabled.
+    pub fn dynamic_topo_telemetry(&self) -> Option<PkTelemetry> {
+        self.pk_order.as_ref().map(DynamicTopo::telemetry)
+    }
+
     #[inline]
     pub(crate) fn dynamic_topo_enabled(&self) -> bool {
         self.pk_order.is_some()
     }
 
+    #[inline]
+    pub(crate) fn pk_rejects_cycle_edges(&self) -> bool {
+        self.pk_order.is_some() && self.config.pk_reject_cycle_edges
+    }
+
+    /// Order `dependency -> dependent` insertions in the PK order before the edges
+    /// are written. Returns the dependencies to skip because they would close a
+    /// cycle and `pk_reject_cycle_edges` is set.
+    fn pk_order_dependency_edges(
+        &mut self,
+        dependent: VertexId,
+        dependencies: &[VertexId],
+    ) -> rustc_hash::FxHashSet<VertexId> {
+        let mut skip_deps = rustc_hash::FxHashSet::default();
+        let Some(mut pk) = self.pk_order.take() else {
+            return skip_deps;
+        };
+        // Place new precedents ahead of a new dependent so the common forward edge
+        // needs no reordering.
+        pk.ensure_nodes(dependencies.iter().copied());
+        pk.ensure_nodes(std::iter::once(dependent));
+        {
+            let adapter = GraphAdapter { g: self };
+            let reject = self.config.pk_reject_cycle_edges;
+            for &dep_id in dependencies {
+                let closes_cycle = match pk.try_add_edge(&adapter, dep_id, dependent) {
+                    Ok(stats) => {
+                        stats.fallback && reject && pk.creates_cycle(&adapter, dep_id, dependent)
+                    }
+                    Err(_cycle) => true,
+                };
+                if closes_cycle {
+                    if reject {
+                        skip_deps.insert(dep_id);
+                    } else {
+                        // The order cannot reflect a cycle; schedule a rebuild and let
+                        // the scheduler's SCC pass handle it meanwhile.
+                        pk.invalidate();
+                    }
+                }
+            }
+        }
+        self.pk_order = Some(pk);
+        skip_deps
+    }
+
     #[cfg(test)]
     pub fn reset_instr(&mut self) {
         if let Ok(mut g) = self.instr.lock() {
@@ -1353,6 +1447,18 @@ impl DependencyGraph {
         &self.data_store
     }
 
+    /// The data store together with the registry its sheet ids refer to, for code that
+    /// writes arena nodes directly instead of storing parsed ASTs.
+    pub(crate) fn arena_parts_mut(&mut self) -> (&mut DataStore, &SheetRegistry) {
+        (&mut self.data_store, &self.sheet_reg)
+    }
+
+    /// Drop constants folded at ingest, e.g. after a function they called
+    /// was replaced.
+    pub(crate) fn remove_folded_constants(&mut self, nodes: &[AstNodeId]) {
+        self.data_store.constants_mut().remove(nodes);
+    }
+
     pub(crate) fn make_ingest_pipeline<'a>(
         &'a mut self,
         function_provider: &'a dyn crate::traits::FunctionProvider,
@@ -2632,8 +2738,7 @@ impl DependencyGraph {
             return vertex_ids.to_vec();
         }
         let mut affected = FxHashSet::default();
-        let mut to_visit = Vec::new();
-        let mut visited_for_propagation = FxHashSet::default();
+        let mut frontier = Vec::new();
 
         for &vertex_id in vertex_ids {
             // Only mark the source vertex as dirty if it's a formula.
@@ -2648,52 +2753,26 @@ impl DependencyGraph {
             );
 
             if is_formula {
-                to_visit.push(vertex_id);
+                frontier.push(vertex_id);
             } else {
                 // Value cells are affected (for tracking) but not marked dirty
                 affected.insert(vertex_id);
             }
 
-            // Initial propagation from direct and range dependents
-            {
-                // Get dependents (vertices that depend on this vertex)
-                if let Some(dependents) = self.dependents_slice(vertex_id) {
-                    to_visit.extend(dependents.iter().copied());
-                } else {
-                    let dependents = self.get_dependents(vertex_id);
-                    to_visit.extend(dependents);
-                }
-
-                if let Some(name_set) = self.cell_to_name_dependents.get(&vertex_id) {
-                    for &name_vertex in name_set {
-                        to_visit.push(name_vertex);
-                    }
-                }
-
-                to_visit.extend(self.collect_range_dependents_for_vertex(vertex_id));
-            }
-        }
-
-        while let Some(id) = to_visit.pop() {
-            if !visited_for_propagation.insert(id) {
-                continue; // Already processed
-            }
-            self.dirty_propagation_visits += 1;
-            affected.insert(id);
-
-            // Mark vertex as dirty
-            self.store.set_dirty(id, true);
-
-            // Add direct dependents to visit list
-            if let Some(dependents) = self.dependents_slice(id) {
-                to_visit.extend(dependents.iter().copied());
+            // Initial propagation from direct, name and range dependents
+            if let Some(dependents) = self.dependents_slice(vertex_id) {
+                frontier.extend_from_slice(dependents);
             } else {
-                let dependents = self.get_dependents(id);
-                to_visit.extend(dependents);
+                frontier.extend(self.get_dependents(vertex_id));
             }
-            to_visit.extend(self.collect_range_dependents_for_vertex(id));
+            if let Some(name_set) = self.cell_to_name_dependents.get(&vertex_id) {
+                frontier.extend(name_set.iter().copied());
+            }
+            self.extend_range_dependents_for_vertex(vertex_id, &mut frontier);
         }
 
+        affected.extend(self.propagate_dirty_frontier(frontier));
+
         // Add to dirty set
         self.formula_dirty.legacy_extend(affected.iter().copied());
 
@@ -2875,31 +2954,8 @@ impl DependencyGraph {
         // Batch to avoid repeated CSR rebuilds and keep reverse edges current
         self.edges.begin_batch();
 
-        // If PK enabled, update order using a short-lived adapter without holding &mut self
         // Track dependencies that should be skipped if rejecting cycle-creating edges
-        let mut skip_deps: rustc_hash::FxHashSet<VertexId> = rustc_hash::FxHashSet::default();
-        if self.pk_order.is_some()
-            && let Some(mut pk) = self.pk_order.take()
-        {
-            pk.ensure_nodes(std::iter::once(dependent));
-            pk.ensure_nodes(dependencies.iter().copied());
-            {
-                let adapter = GraphAdapter { g: self };
-                for &dep_id in dependencies {
-                    match pk.try_add_edge(&adapter, dep_id, dependent) {
-                        Ok(_) => {}
-                        Err(_cycle) => {
-                            if self.config.pk_reject_cycle_edges {
-                                skip_deps.insert(dep_id);
-                            } else {
-                                pk.rebuild_full(&adapter);
-                            }
-                        }
-                    }
-                }
-            } // drop adapter
-            self.pk_order = Some(pk);
-        }
+        let skip_deps = self.pk_order_dependency_edges(dependent, dependencies);
 
         // Now mutate engine edges; if rejecting cycles, re-check and skip those that would create cycles
         for &dep_id in dependencies {
@@ -2920,30 +2976,7 @@ impl DependencyGraph {
 
     /// Like add_dependent_edges, but assumes caller is managing edges.begin_batch/end_batch
     fn add_dependent_edges_nobatch(&mut self, dependent: VertexId, dependencies: &[VertexId]) {
-        // If PK enabled, update order using a short-lived adapter without holding &mut self
-        let mut skip_deps: rustc_hash::FxHashSet<VertexId> = rustc_hash::FxHashSet::default();
-        if self.pk_order.is_some()
-            && let Some(mut pk) = self.pk_order.take()
-        {
-            pk.ensure_nodes(std::iter::once(dependent));
-            pk.ensure_nodes(dependencies.iter().copied());
-            {
-                let adapter = GraphAdapter { g: self };
-                for &dep_id in dependencies {
-                    match pk.try_add_edge(&adapter, dep_id, dependent) {
-                        Ok(_) => {}
-                        Err(_cycle) => {
-                            if self.config.pk_reject_cycle_edges {
-                                skip_deps.insert(dep_id);
-                            } else {
-                                pk.rebuild_full(&adapter);
-                            }
-                        }
-                    }
-                }
-            }
-            self.pk_order = Some(pk);
-        }
+        let skip_deps = self.pk_order_dependency_edges(dependent, dependencies);
 
         for &dep_id in dependencies {
             if self.config.pk_reject_cycle_edges && skip_deps.contains(&dep_id) {
@@ -3155,16 +3188,15 @@ impl DependencyGraph {
             )
             .map_err(crate::engine::ResourceLedgerError::into_excel_error)?;
         }
-        // If PK enabled attempt to add maintaining ordering; fallback to rebuild if cycle
+        // If PK enabled, keep the order current; a cycle-closing edge defers to a rebuild.
         if self.pk_order.is_some()
             && let Some(mut pk) = self.pk_order.take()
         {
-            pk.ensure_nodes(std::iter::once(dependent));
             pk.ensure_nodes(std::iter::once(dependency));
+            pk.ensure_nodes(std::iter::once(dependent));
             let adapter = GraphAdapter { g: self };
             if pk.try_add_edge(&adapter, dependency, dependent).is_err() {
-                // Cycle: rebuild full (conservative)
-                pk.rebuild_full(&adapter);
+                pk.invalidate();
             }
             self.pk_order = Some(pk);
         }
@@ -3712,7 +3744,6 @@ impl DependencyGraph {
 
         let mut affected: FxHashSet<VertexId> = FxHashSet::default();
         let mut to_visit: Vec<VertexId> = Vec::new();
-        let mut visited_for_propagation: FxHashSet<VertexId> = FxHashSet::default();
 
         // Value sources are affected but not marked dirty themselves.
         for &src in vertex_ids {
@@ -3751,40 +3782,12 @@ impl DependencyGraph {
             to_visit.extend(self.collect_range_dependents_for_rect(sid, sr, sc, er, ec));
         }
 
-        while let Some(id) = to_visit.pop() {
-            if !visited_for_propagation.insert(id) {
-                continue;
-            }
-            self.dirty_propagation_visits += 1;
-            affected.insert(id);
-            self.store.set_dirty(id, true);
-            to_visit.extend(self.edges.in_edges(id));
-            to_visit.extend(self.collect_range_dependents_for_vertex(id));
-        }
+        affected.extend(self.propagate_dirty_frontier(to_visit));
 
         self.formula_dirty.legacy_extend(affected.iter().copied());
         affected.into_iter().collect()
     }
 
-    fn collect_range_dependents_for_vertex(&self, vertex_id: VertexId) -> Vec<VertexId> {
-        match self.store.kind(vertex_id) {
-            VertexKind::Cell
-            | VertexKind::Empty
-            | VertexKind::FormulaScalar
-            | VertexKind::FormulaArray => {
-                let view = self.store.view(vertex_id);
-                self.collect_range_dependents_for_rect(
-                    view.sheet_id(),
-                    view.row(),
-                    view.col(),
-                    view.row(),
-                    view.col(),
-                )
-            }
-            _ => Vec::new(),
-        }
-    }
-
     fn collect_range_dependents_for_rect(
         &self,
         sheet_id: SheetId,
@@ -3838,36 +3841,43 @@ impl DependencyGraph {
         }
 
         // Precision check: the dirty rect must overlap at least one of the formula's registered ranges.
-        let mut out: Vec<VertexId> = Vec::new();
-        for dep_id in candidates {
-            let Some(ranges) = self.formula_to_range_deps.get(&dep_id) else {
-                continue;
+        candidates
+            .into_iter()
+            .filter(|&dep_id| {
+                self.formula_range_overlaps_rect(
+                    dep_id, sheet_id, start_row, start_col, end_row, end_col,
+                )
+            })
+            .collect()
+    }
+
+    /// True when one of `dep_id`'s registered range dependencies overlaps the rect.
+    fn formula_range_overlaps_rect(
+        &self,
+        dep_id: VertexId,
+        sheet_id: SheetId,
+        start_row: u32,
+        start_col: u32,
+        end_row: u32,
+        end_col: u32,
+    ) -> bool {
+        let Some(ranges) = self.formula_to_range_deps.get(&dep_id) else {
+            return false;
+        };
+        ranges.iter().any(|range| {
+            let range_sheet_id = match range.sheet {
+                SharedSheetLocator::Id(id) => id,
+                _ => sheet_id,
             };
-            let mut hit = false;
-            for range in ranges {
-                let range_sheet_id = match range.sheet {
-                    SharedSheetLocator::Id(id) => id,
-                    _ => sheet_id,
-                };
-                if range_sheet_id != sheet_id {
-                    continue;
-                }
-                let sr0 = range.start_row.map(|b| b.index).unwrap_or(0);
-                let er0 = range.end_row.map(|b| b.index).unwrap_or(u32::MAX);
-                let sc0 = range.start_col.map(|b| b.index).unwrap_or(0);
-                let ec0 = range.end_col.map(|b| b.index).unwrap_or(u32::MAX);
-                let overlap =
-                    sr0 <= end_row && er0 >= start_row && sc0 <= end_col && ec0 >= start_col;
-                if overlap {
-                    hit = true;
-                    break;
-                }
-            }
-            if hit {
-                out.push(dep_id);
+            if range_sheet_id != sheet_id {
+                return false;
             }
-        }
-        out
+            let sr0 = range.start_row.map(|b| b.index).unwrap_or(0);
+            let er0 = range.end_row.map(|b| b.index).unwrap_or(u32::MAX);
+            let sc0 = range.start_col.map(|b| b.index).unwrap_or(0);
+            let ec0 = range.end_col.map(|b| b.index).unwrap_or(u32::MAX);
+            sr0 <= end_row && er0 >= start_row && sc0 <= end_col && ec0 >= start_col
+        })
     }
 
     /// Check if a vertex exists
@@ -4183,6 +4193,13 @@ impl DependencyGraph {
     #[doc(hidden)]
     pub fn mark_deleted(&mut self, id: VertexId, deleted: bool) {
         self.store.mark_deleted(id, deleted);
+        if let Some(pk) = self.pk_order.as_mut() {
+            if deleted {
+                pk.remove_node(id);
+            } else {
+                pk.ensure_nodes(std::iter::once(id));
+            }
+        }
     }
 
     /// Set vertex kind
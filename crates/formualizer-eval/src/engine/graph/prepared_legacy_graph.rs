@@ -63,7 +63,7 @@ impl std::fmt::Display for PreparedLegacyGraphError {
             Self::DynamicTopologyUnsupported => {
                 write!(
                     f,
-                    "prepared legacy graph plans do not support dynamic topology"
+                    "prepared legacy graph plans do not support cycle-rejecting dynamic topology"
                 )
             }
             #[cfg(test)]
@@ -321,7 +321,9 @@ impl DependencyGraph {
         &self,
         planned: Vec<(SheetId, u32, u32, AstNodeId, DependencyPlanRow)>,
     ) -> Result<PreparedLegacyGraphPlan, PreparedLegacyGraphError> {
-        if self.pk_order.is_some() {
+        // Prepared plans are applied infallibly and must publish every planned edge;
+        // cycle-rejecting dynamic topology could drop some of them.
+        if self.pk_rejects_cycle_edges() {
             return Err(PreparedLegacyGraphError::DynamicTopologyUnsupported);
         }
         let mut sheet_names = BTreeMap::new();
@@ -563,7 +565,7 @@ impl DependencyGraph {
         if self.prepared_legacy_graph_failure_for_test {
             return Err(PreparedLegacyGraphError::InjectedFailure);
         }
-        if self.pk_order.is_some() || self.store.len() != plan.expected_vertex_len {
+        if self.pk_rejects_cycle_edges() || self.store.len() != plan.expected_vertex_len {
             return Err(PreparedLegacyGraphError::Stale);
         }
         for (id, name) in &plan.sheet_names {
@@ -10,6 +10,7 @@ use crate::engine::arena::{
     AstNodeData, AstNodeId, AstNodeMetadata, CanonicalLabels, CompactRefType, DataStore, SheetKey,
     StringId, ValueRef,
 };
+use crate::engine::const_fold::ConstantFoldSettings;
 use crate::engine::graph::DependencyGraph;
 use crate::engine::plan::{DependencyPlan, F_HAS_NAMES, F_HAS_RANGES, F_HAS_TABLES, F_VOLATILE};
 use crate::engine::sheet_registry::SheetRegistry;
@@ -160,6 +161,8 @@ pub(crate) struct IngestPipeline<'a> {
     function_provider: &'a dyn FunctionProvider,
     policy: CollectPolicy,
     function_semantics_enabled: bool,
+    shared_subexpressions_enabled: bool,
+    constant_folding: Option<ConstantFoldSettings>,
 }
 
 impl<'a> IngestPipeline<'a> {
@@ -181,6 +184,8 @@ impl<'a> IngestPipeline<'a> {
             function_provider,
             policy,
             function_semantics_enabled: true,
+            shared_subexpressions_enabled: false,
+            constant_folding: None,
         }
     }
 
@@ -189,6 +194,20 @@ impl<'a> IngestPipeline<'a> {
         self
     }
 
+    /// Count shareable subtrees of each ingested formula for workbook-wide
+    /// common subexpression elimination (see [`crate::engine::cse`]).
+    pub(crate) fn with_shared_subexpressions(mut self, enabled: bool) -> Self {
+        self.shared_subexpressions_enabled = enabled;
+        self
+    }
+
+    /// Fold constant subtrees of each ingested formula under `settings`
+    /// (see [`crate::engine::const_fold`]); `None` leaves formulas unfolded.
+    pub(crate) fn with_constant_folding(mut self, settings: Option<ConstantFoldSettings>) -> Self {
+        self.constant_folding = settings;
+        self
+    }
+
     pub(crate) fn ingest_formula(
         &mut self,
         ast: FormulaAstInput<'_>,
@@ -221,6 +240,23 @@ impl<'a> IngestPipeline<'a> {
             }
             FormulaAstInput::_Lifetime(_) => unreachable!("marker variant is not constructible"),
         };
+        if self.shared_subexpressions_enabled {
+            crate::engine::cse::record_shared_candidates(
+                ast_id,
+                self.data_store,
+                self.function_provider,
+            );
+        }
+        if let Some(settings) = self.constant_folding {
+            crate::engine::const_fold::fold_constants(
+                ast_id,
+                self.sheet_registry.name(placement.sheet_id),
+                self.data_store,
+                self.sheet_registry,
+                self.function_provider,
+                settings,
+            );
+        }
 
         let metadata = compute_tree_metadata(
             &ast_for_oracles,
@@ -2,6 +2,7 @@ use std::hash::{Hash, Hasher};
 use std::sync::atomic::{AtomicUsize, Ordering};
 use std::sync::{Arc, RwLock};
 
+use arrow_array::Array as _;
 use formualizer_common::{ExcelError, LiteralValue, SheetId};
 use rustc_hash::FxHashMap;
 use smallvec::SmallVec;
@@ -131,7 +132,31 @@ impl LookupIndex {
         let mut first_empty = None;
         let mut error_count = 0usize;
 
+        // Dictionary-encoded text columns group rows by lowered dictionary id, so each
+        // distinct string is lowercased and hashed once rather than once per row.
+        let text_codes = match axis {
+            LookupAxis::ColumnInView(col) => view.slice_text_codes(0, len).swap_remove(col),
+            LookupAxis::RowInView(_) => None,
+        };
+        let mut text_groups: FxHashMap<u32, DuplicateIndices> = FxHashMap::default();
+
         for idx in 0..len {
+            if let Some(tc) = &text_codes
+                && tc.codes.is_valid(idx)
+            {
+                let code = tc.codes.value(idx);
+                let dups = text_groups
+                    .entry(tc.dict.lowered_id(code))
+                    .or_insert_with(|| DuplicateIndices {
+                        first: idx,
+                        last: idx,
+                        all: SmallVec::new(),
+                    });
+                dups.last = idx;
+                dups.all.push(idx);
+                cell_values.push(LiteralValue::Text(tc.dict.value(code).to_string()));
+                continue;
+            }
             let value = match axis {
                 LookupAxis::ColumnInView(col) => view.get_cell(idx, col),
                 LookupAxis::RowInView(row) => view.get_cell(row, idx),
@@ -160,6 +185,12 @@ impl LookupIndex {
         if error_count > 0 {
             return Ok(BuildOutcome::ErrorInLookupAxis);
         }
+        if let Some(tc) = &text_codes {
+            let lowered = tc.dict.lowered_values();
+            for (id, dups) in text_groups {
+                entries.insert(LookupHashKey::Text(lowered.value(id as usize).into()), dups);
+            }
+        }
 
         let bytes = estimate_bytes(len, entries.len());
         Ok(BuildOutcome::Built(Self {
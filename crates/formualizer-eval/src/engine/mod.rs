@@ -3,7 +3,10 @@
 //! Provides incremental formula evaluation with dependency tracking.
 
 pub mod arrow_ingest;
+pub mod chunk_rebalance;
+pub mod const_fold;
 pub(crate) mod convergence;
+pub mod cse;
 pub mod effects;
 pub mod eval;
 pub mod eval_delta;
@@ -18,7 +21,10 @@ pub mod journal;
 pub mod live_edges;
 pub mod live_graph;
 pub mod lookup_index_cache;
+pub mod numa;
+pub mod overlay_compaction;
 pub mod plan;
+pub mod pure_memo;
 pub mod range_view;
 pub mod resource_ledger;
 pub mod resource_observability;
@@ -49,10 +55,15 @@ pub mod tuning;
 #[cfg(test)]
 mod tests;
 
-pub use arena::AstNodeId;
+pub use crate::formula_plane::span_jit::SpanJitStats;
+pub use crate::scratch::EvalAllocationStats;
+pub use arena::{AstNodeId, RangeMaterializationStats};
+pub use chunk_rebalance::ChunkRebalanceStats;
+pub use const_fold::ConstantFoldStats;
+pub use cse::SharedSubexpressionStats;
 pub use eval::{
-    CycleTelemetry, Engine, EngineAction, EngineBaselineStats, EvalResult, RecalcPlan,
-    SourceFormulaIngress, TableMetadata, VirtualDepTelemetry,
+    CycleTelemetry, Engine, EngineAction, EngineBaselineStats, EvalResult, PriorityEvalResult,
+    RecalcPlan, SourceFormulaIngress, SpeculationStats, TableMetadata, VirtualDepTelemetry,
 };
 pub use eval_delta::{
     DeltaMode, EvalDelta, EvalDeltaCompatibilityPolicy, EvalDeltaRecord, TARGET_EVAL_DELTA_VERSION,
@@ -71,6 +82,9 @@ pub use formula_source::{
     SourceFamilyMembers, SourceFormulaFamily, SourceFormulaOrder, SourceRect,
 };
 pub use journal::{ActionJournal, ArrowOp, ArrowUndoBatch, GraphUndoBatch};
+pub use numa::{NumaTopology, ThreadPlacement};
+pub use overlay_compaction::OverlayCompactionStats;
+pub use pure_memo::PureCallMemoStats;
 // Use SoA implementation
 pub use formualizer_common::{ResourceExhaustionDetail, ResourceExhaustionReason};
 pub use graph::snapshot::VertexSnapshot;
@@ -706,6 +720,41 @@ impl Default for WorkbookLoadLimits {
 pub struct EvalConfig {
     pub enable_parallel: bool,
     pub max_threads: Option<usize>,
+    /// Worker placement for the evaluation pool (see [`numa`]). Ignored by
+    /// `Engine::with_thread_pool`, which uses the caller's pool as-is.
+    pub thread_placement: ThreadPlacement,
+    /// Topology used by pinned/per-node placement; `None` detects it at
+    /// engine construction.
+    pub numa_topology: Option<NumaTopology>,
+    /// Run arena formulas through the register bytecode VM
+    /// ([`crate::bytecode`]) when they lower, keeping the tree interpreter
+    /// as fallback.
+    pub enable_bytecode_vm: bool,
+    /// Compute pure, position-independent subtrees that occur in several
+    /// formulas once per evaluation pass and reuse the value ([`cse`]).
+    pub enable_shared_subexpressions: bool,
+    /// Fold constant subtrees (literal operands, pure calls, inline arrays)
+    /// to shared values at ingest ([`const_fold`]).
+    pub enable_constant_folding: bool,
+    /// Evaluate FormulaPlane row-run spans of plain arithmetic, comparison,
+    /// `IF`, `ABS` and `SQRT` templates column-wise over input lanes,
+    /// falling back per row to the interpreter.
+    pub enable_columnar_spans: bool,
+    /// Memoize results of pure function calls by function and argument
+    /// values across cells ([`pure_memo`]).
+    pub enable_pure_call_memo: bool,
+    /// Byte budget for the pure-call memo.
+    pub pure_call_memo_bytes: usize,
+    /// Compile columnar span programs that keep getting evaluated to native
+    /// kernels (requires `enable_columnar_spans` and the `jit` cargo feature;
+    /// otherwise the lane program keeps running).
+    pub enable_span_jit: bool,
+    /// Placement evaluations (placements times recalcs) after which a
+    /// columnar program is compiled by the span JIT.
+    pub span_jit_tier_up_placements: u64,
+    /// Minimum BFS frontier width at which dirty propagation expands a level on
+    /// the engine thread pool instead of the calling thread.
+    pub parallel_dirty_propagation_threshold: usize,
     /// Deprecated. Maps to `evaluation_budgets.admission.graph_vertex_hard_limit` only when that
     /// explicit field is unset.
     pub max_vertices: Option<usize>,
@@ -772,9 +821,11 @@ pub struct EvalConfig {
     /// `CycleDetection::Runtime` is opt-in (RFC #112).
     pub cycle: CycleConfig,
 
-    /// Use dynamic topological ordering (Pearce-Kelly algorithm)
+    /// Maintain a dynamic topological order (Pearce-Kelly) across edits so the
+    /// scheduler can skip SCC detection when the order covers the dirty set.
     pub use_dynamic_topo: bool,
-    /// Maximum nodes to visit before falling back to full rebuild
+    /// Maximum nodes a single edge insertion may visit; past it the order is marked
+    /// stale and rebuilt once at the start of the next evaluation.
     pub pk_visit_budget: usize,
     /// Operations between periodic rank compaction
     pub pk_compaction_interval_ops: u64,
@@ -804,6 +855,24 @@ pub struct EvalConfig {
     /// estimated usage exceeds this cap.
     pub max_overlay_memory_bytes: Option<usize>,
 
+    /// Compact overlays at evaluation boundaries instead of inline on the edit path.
+    ///
+    /// Edits and budget overruns only queue their chunks; at the start of the next
+    /// evaluation request finished rebuilds are swapped in and the densest, most-read
+    /// queued chunks are rebuilt from snapshots on the engine thread pool (or inline when
+    /// parallelism is off). The evaluating thread still compacts a chunk whose overlay
+    /// runs far past the threshold, and computed overlays past twice the memory budget.
+    pub background_overlay_compaction: bool,
+
+    /// Rebalance row chunks at evaluation boundaries.
+    ///
+    /// Structural edits leave sheets with short and oversized chunks. When set, each
+    /// evaluation request checks every sheet's chunk lengths against a target picked from
+    /// how its columns are read (longer chunks for scan-heavy sheets) and rebuilds sheets
+    /// that drifted out of range on the engine thread pool, installing the result at the
+    /// next boundary (or inline when parallelism is off).
+    pub adaptive_chunk_rebalancing: bool,
+
     /// Workbook date system: Excel 1900 (default) or 1904.
     pub date_system: DateSystem,
 
@@ -819,6 +888,12 @@ pub struct EvalConfig {
     /// When disabled, the engine avoids per-pass timing/edge-count bookkeeping.
     pub enable_virtual_dep_telemetry: bool,
 
+    /// Schedule dynamic-reference formulas (INDIRECT/OFFSET) against the
+    /// dependency set they resolved on their previous evaluation instead of
+    /// re-interpreting them before every pass. Reads are validated after the
+    /// pass and only misspeculated vertices (plus their dependents) re-run.
+    pub speculative_dynamic_refs: bool,
+
     /// FormulaPlane ingest/planning mode. Defaults to `Off`; span evaluation is
     /// explicitly opt-in while `AuthoritativeExperimental` remains experimental.
     /// `Shadow` may report candidate span opportunities but must still materialize
@@ -840,6 +915,17 @@ impl Default for EvalConfig {
         Self {
             enable_parallel: true,
             max_threads: None,
+            enable_bytecode_vm: true,
+            enable_shared_subexpressions: false,
+            enable_constant_folding: false,
+            enable_columnar_spans: false,
+            enable_pure_call_memo: false,
+            pure_call_memo_bytes: 16 << 20,
+            enable_span_jit: false,
+            span_jit_tier_up_placements: 65_536,
+            thread_placement: ThreadPlacement::Unpinned,
+            numa_topology: None,
+            parallel_dirty_propagation_threshold: 4096,
             max_vertices: None,
             max_eval_time: None,
             max_memory_mb: None,
@@ -872,7 +958,7 @@ impl Default for EvalConfig {
             cycle: CycleConfig::default(),
 
             // Dynamic topology configuration
-            use_dynamic_topo: false, // Disabled by default for compatibility
+            use_dynamic_topo: true,
             pk_visit_budget: 50_000,
             pk_compaction_interval_ops: 100_000,
             max_layer_width: None,
@@ -883,10 +969,13 @@ impl Default for EvalConfig {
             delta_overlay_enabled: true,
             write_formula_overlay_enabled: true,
             max_overlay_memory_bytes: None,
+            background_overlay_compaction: false,
+            adaptive_chunk_rebalancing: false,
             date_system: DateSystem::Excel1900,
             formula_parse_policy: FormulaParsePolicy::Strict,
             defer_graph_building: false,
             enable_virtual_dep_telemetry: false,
+            speculative_dynamic_refs: false,
             formula_plane_mode: FormulaPlaneMode::Off,
             max_formula_plane_cache_candidates: 100_000,
             max_formula_plane_cache_edges: 100_000,
@@ -909,6 +998,84 @@ impl EvalConfig {
         self
     }
 
+    #[inline]
+    pub fn with_background_overlay_compaction(mut self, enable: bool) -> Self {
+        self.background_overlay_compaction = enable;
+        self
+    }
+
+    #[inline]
+    pub fn with_adaptive_chunk_rebalancing(mut self, enable: bool) -> Self {
+        self.adaptive_chunk_rebalancing = enable;
+        self
+    }
+
+    #[inline]
+    pub fn with_bytecode_vm(mut self, enable: bool) -> Self {
+        self.enable_bytecode_vm = enable;
+        self
+    }
+
+    #[inline]
+    pub fn with_shared_subexpressions(mut self, enable: bool) -> Self {
+        self.enable_shared_subexpressions = enable;
+        self
+    }
+
+    #[inline]
+    pub fn with_constant_folding(mut self, enable: bool) -> Self {
+        self.enable_constant_folding = enable;
+        self
+    }
+
+    #[inline]
+    pub fn with_columnar_spans(mut self, enable: bool) -> Self {
+        self.enable_columnar_spans = enable;
+        self
+    }
+
+    #[inline]
+    pub fn with_pure_call_memo(mut self, enable: bool) -> Self {
+        self.enable_pure_call_memo = enable;
+        self
+    }
+
+    #[inline]
+    pub fn with_pure_call_memo_bytes(mut self, bytes: usize) -> Self {
+        self.pure_call_memo_bytes = bytes;
+        self
+    }
+
+    #[inline]
+    pub fn with_span_jit(mut self, enable: bool) -> Self {
+        self.enable_span_jit = enable;
+        self
+    }
+
+    #[inline]
+    pub fn with_span_jit_tier_up_placements(mut self, placements: u64) -> Self {
+        self.span_jit_tier_up_placements = placements;
+        self
+    }
+
+    #[inline]
+    pub fn with_thread_placement(mut self, placement: ThreadPlacement) -> Self {
+        self.thread_placement = placement;
+        self
+    }
+
+    #[inline]
+    pub fn with_numa_topology(mut self, topology: NumaTopology) -> Self {
+        self.numa_topology = Some(topology);
+        self
+    }
+
+    #[inline]
+    pub fn with_parallel_dirty_propagation_threshold(mut self, threshold: usize) -> Self {
+        self.parallel_dirty_propagation_threshold = threshold;
+        self
+    }
+
     #[inline]
     pub fn with_block_stripes(mut self, enable: bool) -> Self {
         self.enable_block_stripes = enable;
@@ -963,6 +1130,12 @@ impl EvalConfig {
         self
     }
 
+    #[inline]
+    pub fn with_speculative_dynamic_refs(mut self, enable: bool) -> Self {
+        self.speculative_dynamic_refs = enable;
+        self
+    }
+
     #[inline]
     pub fn with_formula_plane_mode(mut self, mode: FormulaPlaneMode) -> Self {
         self.formula_plane_mode = mode;
@@ -0,0 +1,406 @@
+//! NUMA- and cache-aware placement for the evaluation thread pool.
+//!
+//! [`ThreadPlacement`] selects how `Engine::new` builds its rayon pool:
+//!
+//! * `Unpinned` — one pool, scheduling left to the OS (the historical default).
+//! * `Pinned` — one pool; worker `i` is pinned to the `i`-th CPU in node-major
+//!   order, so neighbouring workers share a socket and its last-level cache.
+//! * `PerNode` — one pool per NUMA node with workers confined to that node's
+//!   CPUs. Each sheet is assigned a base node when its Arrow storage is
+//!   created; row chunks are striped across nodes from that base, and parallel
+//!   layer work is routed to the pool of the node owning the written cell.
+//!   `max_threads` is split across the pools by CPU count; a cap below the
+//!   node count falls back to `Pinned`.
+//!
+//! Pinning uses `sched_setaffinity` on Linux and is a no-op elsewhere; a worker
+//! that cannot be pinned keeps running unpinned. Page placement is left to the
+//! OS first-touch policy — only compute is routed.
+
+use rayon::{ThreadPool, ThreadPoolBuilder};
+use rustc_hash::FxHashMap;
+use std::sync::{Arc, Mutex};
+
+use crate::SheetId;
+
+/// How evaluation worker threads are placed on the machine.
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub enum ThreadPlacement {
+    /// One pool; the OS schedules workers freely.
+    #[default]
+    Unpinned,
+    /// One pool with each worker pinned to a single CPU, node-major.
+    Pinned,
+    /// One pool per NUMA node; layer work follows sheet/chunk ownership.
+    /// The pools share `max_threads` between them.
+    PerNode,
+}
+
+/// CPU sets of the machine's NUMA nodes.
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct NumaTopology {
+    nodes: Vec<Vec<usize>>,
+}
+
+impl NumaTopology {
+    /// Read `/sys/devices/system/node/node*/cpulist`. Falls back to a single
+    /// node spanning `available_parallelism` CPUs when sysfs is unavailable.
+    pub fn detect() -> Self {
+        #[cfg(target_os = "linux")]
+        if let Some(nodes) = read_sysfs_nodes() {
+            return Self::from_nodes(nodes);
+        }
+        Self::single()
+    }
+
+    /// A topology from explicit per-node CPU lists. Empty nodes are dropped;
+    /// an empty result collapses to [`NumaTopology::single`].
+    pub fn from_nodes(nodes: Vec<Vec<usize>>) -> Self {
+        let nodes: Vec<Vec<usize>> = nodes.into_iter().filter(|n| !n.is_empty()).collect();
+        if nodes.is_empty() {
+            return Self::single();
+        }
+        Self { nodes }
+    }
+
+    /// One node covering every available CPU.
+    pub fn single() -> Self {
+        let cpus = std::thread::available_parallelism()
+            .map(|n| n.get())
+            .unwrap_or(1);
+        Self {
+            nodes: vec![(0..cpus).collect()],
+        }
+    }
+
+    pub fn node_count(&self) -> usize {
+        self.nodes.len()
+    }
+
+    pub fn cpus(&self, node: usize) -> &[usize] {
+        &self.nodes[node]
+    }
+
+    pub fn cpu_count(&self) -> usize {
+        self.nodes.iter().map(Vec::len).sum()
+    }
+
+    fn cpus_node_major(&self) -> Vec<usize> {
+        self.nodes.iter().flatten().copied().collect()
+    }
+}
+
+#[cfg(target_os = "linux")]
+fn read_sysfs_nodes() -> Option<Vec<Vec<usize>>> {
+    let mut nodes: Vec<(usize, Vec<usize>)> = Vec::new();
+    for entry in std::fs::read_dir("/sys/devices/system/node").ok()? {
+        let entry = entry.ok()?;
+        let name = entry.file_name();
+        let Some(index) = name
+            .to_str()
+            .and_then(|n| n.strip_prefix("node"))
+            .and_then(|n| n.parse::<usize>().ok())
+        else {
+            continue;
+        };
+        let list = std::fs::read_to_string(entry.path().join("cpulist")).ok()?;
+        nodes.push((index, parse_cpu_list(&list)?));
+    }
+    if nodes.is_empty() {
+        return None;
+    }
+    nodes.sort_by_key(|(index, _)| *index);
+    Some(nodes.into_iter().map(|(_, cpus)| cpus).collect())
+}
+
+/// Parse a kernel CPU list such as `0-3,8,10-11`.
+pub(crate) fn parse_cpu_list(list: &str) -> Option<Vec<usize>> {
+    let mut cpus = Vec::new();
+    for part in list.trim().split(',').filter(|p| !p.is_empty()) {
+        match part.split_once('-') {
+            Some((lo, hi)) => {
+                let (lo, hi) = (lo.parse::<usize>().ok()?, hi.parse::<usize>().ok()?);
+                if hi < lo {
+                    return None;
+                }
+                cpus.extend(lo..=hi);
+            }
+            None => cpus.push(part.parse().ok()?),
+        }
+    }
+    Some(cpus)
+}
+
+/// Restrict the calling thread to `cpus`. Returns false when the platform
+/// has no affinity support or the kernel rejects the mask.
+fn pin_current_thread(cpus: &[usize]) -> bool {
+    #[cfg(target_os = "linux")]
+    {
+        // SAFETY: `set` is a zeroed, fully owned cpu_set_t; CPU_SET bounds the
+        // index and sched_setaffinity(0, ..) only affects the calling thread.
+        unsafe {
+            let mut set: libc::cpu_set_t = std::mem::zeroed();
+            for &cpu in cpus {
+                if cpu < libc::CPU_SETSIZE as usize {
+                    libc::CPU_SET(cpu, &mut set);
+                }
+            }
+            libc::sched_setaffinity(0, std::mem::size_of::<libc::cpu_set_t>(), &set) == 0
+        }
+    }
+    #[cfg(not(target_os = "linux"))]
+    {
+        let _ = cpus;
+        false
+    }
+}
+
+/// Per-node pools for [`ThreadPlacement::PerNode`]. `pools[0]` doubles as the
+/// engine's general-purpose pool.
+#[derive(Debug)]
+pub(crate) struct NodePools {
+    pools: Vec<Arc<ThreadPool>>,
+}
+
+impl NodePools {
+    pub(crate) fn len(&self) -> usize {
+        self.pools.len()
+    }
+
+    pub(crate) fn pool(&self, node: usize) -> &Arc<ThreadPool> {
+        &self.pools[node]
+    }
+
+    /// Run `job` over each non-empty `parts[node]` on that node's pool and
+    /// return the per-node results (`None` for empty parts).
+    ///
+    /// Jobs are queued from the calling thread, one nested `in_place_scope`
+    /// per node, so all pools work at once and only the caller waits; no
+    /// pool's workers block on another pool.
+    pub(crate) fn run_parts<R, J>(&self, parts: &[Vec<usize>], job: &J) -> Vec<Option<R>>
+    where
+        R: Send,
+        J: Fn(&[usize]) -> R + Sync,
+    {
+        let results: Vec<Mutex<Option<R>>> = parts.iter().map(|_| Mutex::new(None)).collect();
+        self.spawn_parts(0, parts, job, &results);
+        results
+            .into_iter()
+            .map(|slot| slot.into_inner().unwrap())
+            .collect()
+    }
+
+    fn spawn_parts<R, J>(
+        &self,
+        node: usize,
+        parts: &[Vec<usize>],
+        job: &J,
+        results: &[Mutex<Option<R>>],
+    ) where
+        R: Send,
+        J: Fn(&[usize]) -> R + Sync,
+    {
+        let Some(part) = parts.get(node) else {
+            return;
+        };
+        if part.is_empty() {
+            return self.spawn_parts(node + 1, parts, job, results);
+        }
+        self.pools[node].in_place_scope(|scope| {
+            scope.spawn(|_| *results[node].lock().unwrap() = Some(job(part)));
+            self.spawn_parts(node + 1, parts, job, results);
+        });
+    }
+}
+
+/// Build the evaluation pool(s) for `placement`. Returns the general pool
+/// and, for `PerNode` on a multi-node topology, the per-node pools.
+/// `None` for the general pool means pool construction failed and the engine
+/// falls back to sequential evaluation.
+pub(crate) fn build_thread_pools(
+    max_threads: Option<usize>,
+    placement: ThreadPlacement,
+    topology: &NumaTopology,
+) -> (Option<Arc<ThreadPool>>, Option<NodePools>) {
+    match placement {
+        ThreadPlacement::Unpinned => {
+            let mut builder = ThreadPoolBuilder::new();
+            if let Some(max_threads) = max_threads {
+                builder = builder.num_threads(max_threads);
+            }
+            (builder.build().ok().map(Arc::new), None)
+        }
+        ThreadPlacement::Pinned => {
+            let cpus = topology.cpus_node_major();
+            let threads = max_threads.unwrap_or(cpus.len()).max(1);
+            let pool = ThreadPoolBuilder::new()
+                .num_threads(threads)
+                .start_handler(move |idx| {
+                    pin_current_thread(&[cpus[idx % cpus.len()]]);
+                })
+                .build()
+                .ok()
+                .map(Arc::new);
+            (pool, None)
+        }
+        // Every node needs at least one worker of its own.
+        ThreadPlacement::PerNode
+            if topology.node_count() < 2
+                || max_threads.is_some_and(|max| max < topology.node_count()) =>
+        {
+            build_thread_pools(max_threads, ThreadPlacement::Pinned, topology)
+        }
+        ThreadPlacement::PerNode => {
+            let total = max_threads.unwrap_or(topology.cpu_count());
+            let node_cpus: Vec<usize> = (0..topology.node_count())
+                .map(|node| topology.cpus(node).len())
+                .collect();
+            let shares = node_thread_shares(total, &node_cpus);
+            let mut pools = Vec::with_capacity(topology.node_count());
+            for (node, threads) in shares.into_iter().enumerate() {
+                let cpus = topology.cpus(node).to_vec();
+                let built = ThreadPoolBuilder::new()
+                    .num_threads(threads)
+                    .thread_name(move |idx| format!("formualizer-n{node}-{idx}"))
+                    .start_handler(move |_| {
+                        pin_current_thread(&cpus);
+                    })
+                    .build();
+                match built {
+                    Ok(pool) => pools.push(Arc::new(pool)),
+                    Err(_) => return (None, None),
+                }
+            }
+            (Some(pools[0].clone()), Some(NodePools { pools }))
+        }
+    }
+}
+
+/// Split `total` threads (at least one per node) across nodes in proportion to
+/// their CPU counts. Every node gets one, and the shares sum to exactly `total`.
+fn node_thread_shares(total: usize, node_cpus: &[usize]) -> Vec<usize> {
+    let spare = total.saturating_sub(node_cpus.len());
+    let cpu_count = node_cpus.iter().sum::<usize>().max(1);
+    let mut shares: Vec<usize> = node_cpus
+        .iter()
+        .map(|&cpus| 1 + spare * cpus / cpu_count)
+        .collect();
+    // Rounding down leaves fewer spare threads than nodes; hand them out by
+    // largest remainder.
+    let mut left = spare + node_cpus.len() - shares.iter().sum::<usize>();
+    let mut order: Vec<usize> = (0..node_cpus.len()).collect();
+    order.sort_by_key(|&node| std::cmp::Reverse(spare * node_cpus[node] % cpu_count));
+    for node in order {
+        if left == 0 {
+            break;
+        }
+        shares[node] += 1;
+        left -= 1;
+    }
+    shares
+}
+
+/// Sheet → base NUMA node, assigned round-robin as sheets gain Arrow storage.
+#[derive(Debug, Default)]
+pub(crate) struct SheetNodeOwnership {
+    by_sheet: FxHashMap<SheetId, usize>,
+    next: usize,
+}
+
+impl SheetNodeOwnership {
+    /// Assign `sheet` a base node if it has none yet.
+    pub(crate) fn assign(&mut self, sheet: SheetId, nodes: usize) {
+        if nodes < 2 {
+            return;
+        }
+        self.by_sheet.entry(sheet).or_insert_with(|| {
+            let node = self.next % nodes;
+            self.next = self.next.wrapping_add(1);
+            node
+        });
+    }
+
+    pub(crate) fn remove(&mut self, sheet: SheetId) {
+        self.by_sheet.remove(&sheet);
+    }
+
+    /// Base node of `sheet`; sheets created outside `ensure_arrow_sheet` map
+    /// deterministically by id.
+    pub(crate) fn base_node(&self, sheet: SheetId, nodes: usize) -> usize {
+        self.by_sheet
+            .get(&sheet)
+            .copied()
+            .unwrap_or(sheet as usize % nodes.max(1))
+    }
+}
+
+/// Node owning `row` of a sheet whose base node is `base`: consecutive row
+/// chunks are striped across nodes so one large sheet still spreads out.
+#[inline]
+pub(crate) fn owner_node(base: usize, row0: u32, chunk_rows: usize, nodes: usize) -> usize {
+    (base + row0 as usize / chunk_rows.max(1)) % nodes.max(1)
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn parses_kernel_cpu_lists() {
+        assert_eq!(
+            parse_cpu_list("0-3,8,10-11\n"),
+            Some(vec![0, 1, 2, 3, 8, 10, 11])
+        );
+        assert_eq!(parse_cpu_list("5"), Some(vec![5]));
+        assert_eq!(parse_cpu_list(""), Some(vec![]));
+        assert_eq!(parse_cpu_list("3-1"), None);
+        assert_eq!(parse_cpu_list("x"), None);
+    }
+
+    #[test]
+    fn empty_nodes_are_dropped() {
+        let topo = NumaTopology::from_nodes(vec![vec![0, 1], vec![], vec![2]]);
+        assert_eq!(topo.node_count(), 2);
+        assert_eq!(topo.cpu_count(), 3);
+        assert!(NumaTopology::from_nodes(Vec::new()).node_count() >= 1);
+    }
+
+    #[test]
+    fn per_node_threads_respect_the_cap() {
+        assert_eq!(node_thread_shares(8, &[4, 4]), vec![4, 4]);
+        assert_eq!(node_thread_shares(8, &[6, 2]), vec![6, 2]);
+        assert_eq!(node_thread_shares(3, &[1, 1, 1]), vec![1, 1, 1]);
+        assert_eq!(node_thread_shares(3, &[10, 1]), vec![2, 1]);
+        for total in 4..40 {
+            let shares = node_thread_shares(total, &[3, 5, 7, 1]);
+            assert_eq!(shares.iter().sum::<usize>(), total);
+            assert!(shares.iter().all(|&threads| threads >= 1));
+        }
+
+        let topo = NumaTopology::from_nodes(vec![vec![0, 1], vec![2, 3], vec![4, 5]]);
+        let (pool, nodes) = build_thread_pools(Some(4), ThreadPlacement::PerNode, &topo);
+        let pools = nodes.unwrap().pools;
+        assert_eq!(
+            pools.iter().map(|p| p.current_num_threads()).sum::<usize>(),
+            4
+        );
+        assert!(pool.is_some());
+        let (pool, nodes) = build_thread_pools(Some(2), ThreadPlacement::PerNode, &topo);
+        assert!(nodes.is_none());
+        assert_eq!(pool.unwrap().current_num_threads(), 2);
+    }
+
+    #[test]
+    fn sheets_round_robin_and_chunks_stripe() {
+        let mut owners = SheetNodeOwnership::default();
+        owners.assign(7, 2);
+        owners.assign(3, 2);
+        owners.assign(7, 2);
+        assert_eq!(owners.base_node(7, 2), 0);
+        assert_eq!(owners.base_node(3, 2), 1);
+        assert_eq!(owner_node(1, 0, 1024, 2), 1);
+        assert_eq!(owner_node(1, 1024, 1024, 2), 0);
+        assert_eq!(owner_node(1, 2047, 1024, 2), 0);
+        owners.remove(3);
+        assert_eq!(owners.base_node(3, 2), 1);
+    }
+}
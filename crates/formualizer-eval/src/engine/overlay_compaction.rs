@@ -0,0 +1,238 @@
+//! Background overlay compaction (`EvalConfig::background_overlay_compaction`).
+//!
+//! Folding an overlay into its chunk's base lanes rebuilds every lane of the chunk, which
+//! is too slow for the edit path and for the middle of a recalc. [`OverlayCompactor`]
+//! queues such chunks instead. At each evaluation boundary the engine installs rebuilds
+//! that finished since the previous boundary and starts new ones: the queued chunks are
+//! ranked by overlay density and by how often reads had to consult the overlay, cloned
+//! (lanes are shared, overlays copied), and rebuilt from those snapshots on the engine
+//! thread pool while evaluation goes on. Installing checks that the base lanes are the
+//! ones the snapshot saw; overlay writes made since stay in the overlay.
+
+use std::sync::{Arc, Mutex};
+
+use rustc_hash::FxHashSet;
+
+use crate::arrow_store::{ArrowSheet, ColumnChunk, CompactedLanes, OverlayLayer, SheetStore};
+
+/// A user overlay this many times past its compaction threshold is compacted inline, so
+/// a long run of edits without an evaluation cannot grow it without bound.
+pub(crate) const INLINE_BACKLOG_FACTOR: usize = 8;
+
+/// Rebuilds started per boundary; the rest stay queued in priority order.
+const MAX_JOBS_PER_BOUNDARY: usize = 64;
+
+/// A chunk overlay queued for compaction.
+#[derive(Clone, Debug, PartialEq, Eq, Hash)]
+pub(crate) struct CompactionKey {
+    sheet: Arc<str>,
+    col: usize,
+    chunk: usize,
+    layer: OverlayLayer,
+}
+
+/// Lanes rebuilt from `source`, the chunk as it was when the job started.
+struct FinishedCompaction {
+    key: CompactionKey,
+    source: ColumnChunk,
+    lanes: Option<CompactedLanes>,
+}
+
+/// Counters for background compaction.
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct OverlayCompactionStats {
+    /// Rebuilds started from a snapshot.
+    pub started: u64,
+    /// Rebuilds swapped into their chunk.
+    pub installed: u64,
+    /// Rebuilds dropped because the chunk's base lanes changed first.
+    pub discarded: u64,
+    /// Compactions still run on the evaluating thread (backlog or budget overrun).
+    pub inline: u64,
+}
+
+#[derive(Default)]
+pub(crate) struct OverlayCompactor {
+    queued: FxHashSet<CompactionKey>,
+    /// Budget pressure asked for every computed overlay to be folded.
+    computed_requested: bool,
+    in_flight: FxHashSet<CompactionKey>,
+    finished: Arc<Mutex<Vec<FinishedCompaction>>>,
+    stats: OverlayCompactionStats,
+}
+
+impl OverlayCompactor {
+    #[inline]
+    pub(crate) fn stats(&self) -> OverlayCompactionStats {
+        self.stats
+    }
+
+    /// Whether any compaction is queued or running.
+    #[inline]
+    pub(crate) fn is_idle(&self) -> bool {
+        self.queued.is_empty() && !self.computed_requested && self.in_flight.is_empty()
+    }
+
+    /// Called after a user edit to chunk `ch_idx` of column `col`. Queues the chunk once
+    /// its overlay crosses the compaction threshold and compacts inline only past
+    /// `INLINE_BACKLOG_FACTOR` times that. Returns the bytes freed inline.
+    pub(crate) fn note_user_edit(
+        &mut self,
+        sheet: &mut ArrowSheet,
+        col: usize,
+        ch_idx: usize,
+        abs_threshold: usize,
+        frac_den: usize,
+    ) -> usize {
+        let Some(ch) = sheet.columns.get(col).and_then(|c| c.chunk(ch_idx)) else {
+            return 0;
+        };
+        let threshold = ch.overlay_compaction_threshold(abs_threshold, frac_den);
+        let ov_len = ch.overlay.len();
+        if ov_len <= threshold {
+            return 0;
+        }
+        if ov_len > threshold.saturating_mul(INLINE_BACKLOG_FACTOR) {
+            self.stats.inline += 1;
+            return sheet.maybe_compact_chunk(col, ch_idx, abs_threshold, frac_den);
+        }
+        self.queued.insert(CompactionKey {
+            sheet: sheet.name.clone(),
+            col,
+            chunk: ch_idx,
+            layer: OverlayLayer::User,
+        });
+        0
+    }
+
+    /// Queue every non-empty computed overlay for the next boundary.
+    #[inline]
+    pub(crate) fn request_computed_compaction(&mut self) {
+        self.computed_requested = true;
+    }
+
+    /// Count a compaction the engine ran on the evaluating thread.
+    #[inline]
+    pub(crate) fn note_inline(&mut self) {
+        self.stats.inline += 1;
+    }
+
+    /// Swap finished rebuilds into their chunks. A rebuild whose chunk was restructured
+    /// meanwhile is dropped and its chunk queued again. Returns the number installed and
+    /// the change in computed-overlay bytes.
+    pub(crate) fn install_finished(&mut self, sheets: &mut SheetStore) -> (u64, isize) {
+        let finished = std::mem::take(&mut *self.finished.lock().unwrap());
+        let mut installed = 0u64;
+        let mut computed_delta = 0isize;
+        for done in finished {
+            self.in_flight.remove(&done.key);
+            let Some(lanes) = done.lanes else {
+                continue;
+            };
+            let key = done.key;
+            let chunk = sheets
+                .sheet_mut(&key.sheet)
+                .and_then(|sheet| sheet.columns.get_mut(key.col))
+                .and_then(|col| col.chunk_mut(key.chunk));
+            let Some(chunk) = chunk else {
+                self.stats.discarded += 1;
+                continue;
+            };
+            match chunk.install_compacted_snapshot(&done.source, lanes) {
+                Some(delta) => {
+                    installed += 1;
+                    if key.layer == OverlayLayer::Computed {
+                        computed_delta = computed_delta.saturating_add(delta);
+                    }
+                }
+                None => {
+                    self.stats.discarded += 1;
+                    if !chunk.overlay_layer(key.layer).is_empty() {
+                        self.queued.insert(key);
+                    }
+                }
+            }
+        }
+        self.stats.installed += installed;
+        (installed, computed_delta)
+    }
+
+    /// Start rebuilds for the highest-priority queued chunks: on `pool` when given,
+    /// otherwise on the calling thread, in which case they finish before this returns.
+    pub(crate) fn dispatch(&mut self, sheets: &SheetStore, pool: Option<&rayon::ThreadPool>) {
+        if std::mem::take(&mut self.computed_requested) {
+            self.queue_computed_overlays(sheets);
+        }
+        let mut ranked: Vec<(f64, CompactionKey)> = Vec::new();
+        self.queued.retain(|key| {
+            let Some(ch) = chunk_of(sheets, key) else {
+                return false;
+            };
+            let overlay = ch.overlay_layer(key.layer);
+            if overlay.is_empty() {
+                return false;
+            }
+            if !self.in_flight.contains(key) {
+                ranked.push((compaction_priority(ch, key.layer), key.clone()));
+            }
+            true
+        });
+        ranked.sort_by(|a, b| b.0.total_cmp(&a.0));
+
+        for (_, key) in ranked.into_iter().take(MAX_JOBS_PER_BOUNDARY) {
+            let Some(ch) = chunk_of(sheets, &key) else {
+                continue;
+            };
+            self.queued.remove(&key);
+            self.in_flight.insert(key.clone());
+            self.stats.started += 1;
+            let source = ch.clone();
+            let finished = Arc::clone(&self.finished);
+            let job = move || {
+                let lanes = source.build_compacted_lanes(key.layer);
+                finished
+                    .lock()
+                    .unwrap()
+                    .push(FinishedCompaction { key, source, lanes });
+            };
+            match pool {
+                Some(pool) => pool.spawn(job),
+                None => job(),
+            }
+        }
+    }
+
+    fn queue_computed_overlays(&mut self, sheets: &SheetStore) {
+        for sheet in &sheets.sheets {
+            for (col, column) in sheet.columns.iter().enumerate() {
+                let dense = column.chunks.iter().enumerate();
+                let sparse = column.sparse_chunks.iter().map(|(&idx, ch)| (idx, ch));
+                for (chunk, ch) in dense.chain(sparse) {
+                    if !ch.computed_overlay.is_empty() {
+                        self.queued.insert(CompactionKey {
+                            sheet: sheet.name.clone(),
+                            col,
+                            chunk,
+                            layer: OverlayLayer::Computed,
+                        });
+                    }
+                }
+            }
+        }
+    }
+}
+
+fn chunk_of<'s>(sheets: &'s SheetStore, key: &CompactionKey) -> Option<&'s ColumnChunk> {
+    sheets
+        .sheet(&key.sheet)
+        .and_then(|sheet| sheet.columns.get(key.col))
+        .and_then(|col| col.chunk(key.chunk))
+}
+
+/// Overlay density weighted by read heat: dense overlays that reads keep merging save the
+/// most work once folded.
+fn compaction_priority(ch: &ColumnChunk, layer: OverlayLayer) -> f64 {
+    let overlay = ch.overlay_layer(layer);
+    let density = overlay.len() as f64 / ch.len().max(1) as f64;
+    density * (1.0 + f64::from(overlay.read_heat()))
+}
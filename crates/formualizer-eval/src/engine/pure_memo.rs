@@ -0,0 +1,271 @@
+//! Result memoization for pure function calls on the graph path.
+//!
+//! FormulaPlane spans memoize placements by parameter key
+//! (`SpanEvaluator::evaluate_memoized`); ordinary vertices repeat the same
+//! expensive pure calls instead, e.g. `NORM.S.INV(p)` over a handful of
+//! distinct p-values, or `XIRR` over cashflow blocks copied across scenarios.
+//! [`PureCallMemo`] caches such calls by the called function plus the values
+//! of their arguments.
+//!
+//! Scalar arguments are keyed by value, as are single-cell references in
+//! positions the function's schema reads as a plain scalar value, so
+//! `NORM.S.INV(A2)` and `NORM.S.INV(A9)` share an entry when the cells agree.
+//! Literal and constant-array arguments are keyed by their (hash-consed)
+//! arena node. Other cell and range reference arguments are keyed by their
+//! arena node too, which fixes the referenced cells for plain
+//! formula evaluations, and pin the entry to the data snapshot and the
+//! cell-read generation it was computed under. The engine advances that
+//! generation wherever it drops shared subexpression values (each evaluation
+//! request, schedule build, and cyclic unit), since computed cells change
+//! without a snapshot bump. Entries whose arguments are all values stay valid
+//! across recalcs until the function registry changes. The cache is bounded
+//! by a byte budget: stale entries are dropped first, then everything.
+
+use std::hash::{BuildHasherDefault, Hash, Hasher};
+use std::sync::atomic::{AtomicU64, AtomicUsize, Ordering};
+
+use dashmap::DashMap;
+use formualizer_common::LiteralValue;
+use rustc_hash::FxHasher;
+
+use crate::args::ShapeKind;
+use crate::engine::arena::AstNodeId;
+use crate::function::{FnCaps, Function};
+
+/// Capabilities that make a call's value depend on more than its arguments'
+/// values, or that rule out evaluating every argument before the call.
+const UNMEMOIZABLE_CAPS: FnCaps = FnCaps::VOLATILE
+    .union(FnCaps::RETURNS_REFERENCE)
+    .union(FnCaps::DYNAMIC_DEPENDENCY)
+    .union(FnCaps::LOCAL_ENVIRONMENT)
+    .union(FnCaps::MAY_SPILL)
+    .union(FnCaps::SHORT_CIRCUIT);
+
+/// True when calls to a function with `caps` may be memoized.
+#[inline]
+pub(crate) fn is_memoizable(caps: FnCaps) -> bool {
+    caps.contains(FnCaps::PURE) && !caps.intersects(UNMEMOIZABLE_CAPS)
+}
+
+/// True when argument `index` of `fun` is read as a scalar value rather than
+/// a reference, so a cell reference there can be keyed by the cell's value.
+pub(crate) fn reads_scalar_value(fun: &dyn Function, index: usize) -> bool {
+    let schema = fun.arg_schema();
+    let spec = match schema.get(index) {
+        Some(spec) => Some(spec),
+        None if fun.variadic() => schema.last(),
+        None => None,
+    };
+    spec.is_some_and(|spec| !spec.by_ref && spec.shape == ShapeKind::Scalar)
+}
+
+/// One argument of a memoized call.
+#[derive(Debug, Clone, PartialEq, Hash)]
+pub(crate) enum MemoArg {
+    Value(LiteralValue),
+    /// A literal or all-literal array node.
+    Constant(AstNodeId),
+    /// A cell or range reference node, read under the entry's snapshot.
+    Reference(AstNodeId),
+}
+
+/// Identity of a call: the function object, the sheet unqualified
+/// references resolve against, and the arguments.
+#[derive(Debug)]
+pub(crate) struct MemoKey {
+    function: usize,
+    sheet: Box<str>,
+    args: Box<[MemoArg]>,
+    hash: u64,
+}
+
+impl MemoKey {
+    pub(crate) fn new(function: usize, sheet: &str, args: Vec<MemoArg>) -> Self {
+        let mut hasher = FxHasher::default();
+        function.hash(&mut hasher);
+        sheet.hash(&mut hasher);
+        args.hash(&mut hasher);
+        Self {
+            function,
+            sheet: sheet.into(),
+            args: args.into_boxed_slice(),
+            hash: hasher.finish(),
+        }
+    }
+
+    fn reads_cells(&self) -> bool {
+        self.args
+            .iter()
+            .any(|arg| matches!(arg, MemoArg::Reference(_)))
+    }
+
+    fn matches(&self, entry: &MemoEntry) -> bool {
+        entry.function == self.function && *entry.sheet == *self.sheet && *entry.args == *self.args
+    }
+}
+
+/// Counters for [`PureCallMemo`] (see `Engine::pure_call_memo_stats`).
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct PureCallMemoStats {
+    /// Calls answered from the cache.
+    pub hits: u64,
+    /// Memoizable calls that had to be evaluated.
+    pub misses: u64,
+    /// Entries currently cached.
+    pub entries: u64,
+    /// Estimated bytes held by cached entries.
+    pub bytes: u64,
+    /// Times the byte budget forced entries out.
+    pub evictions: u64,
+}
+
+struct MemoEntry {
+    function: usize,
+    sheet: Box<str>,
+    args: Box<[MemoArg]>,
+    /// Data snapshot and cell-read generation the entry was computed under;
+    /// `None` when no argument reads cells.
+    read_at: Option<(u64, u64)>,
+    value: LiteralValue,
+    bytes: usize,
+}
+
+impl MemoEntry {
+    fn is_live(&self, read_at: (u64, u64)) -> bool {
+        self.read_at.is_none_or(|at| at == read_at)
+    }
+}
+
+/// Engine-lifetime memo of pure call results, bounded by a byte budget.
+#[derive(Default)]
+pub struct PureCallMemo {
+    entries: DashMap<u64, Vec<MemoEntry>, BuildHasherDefault<FxHasher>>,
+    budget_bytes: usize,
+    generation: AtomicU64,
+    bytes: AtomicUsize,
+    hits: AtomicU64,
+    misses: AtomicU64,
+    evictions: AtomicU64,
+}
+
+impl PureCallMemo {
+    pub(crate) fn set_budget(&mut self, budget_bytes: usize) {
+        self.budget_bytes = budget_bytes;
+    }
+
+    /// Retire every entry that read cells; value-only entries stay.
+    pub(crate) fn invalidate_cell_reads(&self) {
+        self.generation.fetch_add(1, Ordering::Relaxed);
+    }
+
+    fn read_at(&self, snapshot: u64) -> (u64, u64) {
+        (snapshot, self.generation.load(Ordering::Relaxed))
+    }
+
+    pub(crate) fn get(&self, key: &MemoKey, snapshot: u64) -> Option<LiteralValue> {
+        let read_at = self.read_at(snapshot);
+        let hit = self.entries.get(&key.hash).and_then(|bucket| {
+            bucket
+                .iter()
+                .find(|entry| key.matches(entry) && entry.is_live(read_at))
+                .map(|entry| entry.value.clone())
+        });
+        let counter = if hit.is_some() {
+            &self.hits
+        } else {
+            &self.misses
+        };
+        counter.fetch_add(1, Ordering::Relaxed);
+        hit
+    }
+
+    pub(crate) fn insert(&self, key: MemoKey, snapshot: u64, value: LiteralValue) {
+        let bytes = std::mem::size_of::<MemoEntry>()
+            + key.sheet.len()
+            + key.args.iter().map(arg_bytes).sum::<usize>()
+            + literal_heap_bytes(&value);
+        if bytes > self.budget_bytes {
+            return;
+        }
+        let read_at = self.read_at(snapshot);
+        if self.bytes.load(Ordering::Relaxed) + bytes > self.budget_bytes {
+            self.evict(read_at, bytes);
+        }
+        let read_at = key.reads_cells().then_some(read_at);
+        let mut bucket = self.entries.entry(key.hash).or_default();
+        // A stale entry for the same call is replaced, not kept alongside.
+        bucket.retain(|entry| {
+            let keep = !key.matches(entry);
+            if !keep {
+                self.bytes.fetch_sub(entry.bytes, Ordering::Relaxed);
+            }
+            keep
+        });
+        bucket.push(MemoEntry {
+            function: key.function,
+            sheet: key.sheet,
+            args: key.args,
+            read_at,
+            value,
+            bytes,
+        });
+        self.bytes.fetch_add(bytes, Ordering::Relaxed);
+    }
+
+    /// Make room for `incoming` bytes: drop entries that read cells under an
+    /// older snapshot or generation, then everything if that is not enough.
+    fn evict(&self, read_at: (u64, u64), incoming: usize) {
+        self.evictions.fetch_add(1, Ordering::Relaxed);
+        self.entries.retain(|_, bucket| {
+            bucket.retain(|entry| {
+                let live = entry.is_live(read_at);
+                if !live {
+                    self.bytes.fetch_sub(entry.bytes, Ordering::Relaxed);
+                }
+                live
+            });
+            !bucket.is_empty()
+        });
+        if self.bytes.load(Ordering::Relaxed) + incoming > self.budget_bytes {
+            self.clear();
+        }
+    }
+
+    /// Drop every entry; counters are kept.
+    pub(crate) fn clear(&self) {
+        if !self.entries.is_empty() {
+            self.entries.clear();
+        }
+        self.bytes.store(0, Ordering::Relaxed);
+    }
+
+    pub(crate) fn stats(&self) -> PureCallMemoStats {
+        PureCallMemoStats {
+            hits: self.hits.load(Ordering::Relaxed),
+            misses: self.misses.load(Ordering::Relaxed),
+            entries: self.entries.iter().map(|bucket| bucket.len() as u64).sum(),
+            bytes: self.bytes.load(Ordering::Relaxed) as u64,
+            evictions: self.evictions.load(Ordering::Relaxed),
+        }
+    }
+}
+
+fn arg_bytes(arg: &MemoArg) -> usize {
+    std::mem::size_of::<MemoArg>()
+        + match arg {
+            MemoArg::Value(value) => literal_heap_bytes(value),
+            MemoArg::Constant(_) | MemoArg::Reference(_) => 0,
+        }
+}
+
+fn literal_heap_bytes(value: &LiteralValue) -> usize {
+    match value {
+        LiteralValue::Text(text) => text.len(),
+        LiteralValue::Array(rows) => rows
+            .iter()
+            .flatten()
+            .map(|cell| std::mem::size_of::<LiteralValue>() + literal_heap_bytes(cell))
+            .sum(),
+        _ => 0,
+    }
+}
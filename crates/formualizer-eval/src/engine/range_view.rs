@@ -4,6 +4,7 @@ use crate::stripes::NumericChunk;
 use arrow_array::Array;
 use arrow_schema::DataType;
 use formualizer_common::{CoercionPolicy, DateSystem, ExcelError, LiteralValue};
+use std::ops::ControlFlow;
 use std::sync::Arc;
 use std::sync::atomic::{AtomicBool, Ordering};
 
@@ -59,6 +60,181 @@ pub struct ChunkSlice {
     pub cols: Vec<ChunkCol>,
 }
 
+/// Position of one row segment: the part of the view inside one row chunk.
+#[derive(Copy, Clone, Debug)]
+struct RowSegment {
+    chunk_idx: usize,
+    chunk_off: usize,
+    row_start: usize, // relative to view top
+    row_len: usize,
+}
+
+/// Numeric and error lanes of one column over one row segment, for reductions.
+pub enum NumericSegment {
+    /// Dense lanes. With `edits`, the rows it marks read from the overlay entries it holds
+    /// instead of these lanes; without, overlay edits are already applied.
+    Dense {
+        numbers: Arc<arrow_array::Float64Array>,
+        errors: Arc<arrow_array::UInt8Array>,
+        edits: Option<Arc<arrow_store::NumericEdits>>,
+    },
+    /// A run-end encoded chunk with no overlay edits in the segment: `(rows, value)` per
+    /// numeric run and the first error code in row order.
+    Runs {
+        numbers: Vec<(usize, f64)>,
+        first_error: Option<u8>,
+    },
+}
+
+impl NumericSegment {
+    fn from_runs(runs: &arrow_store::ChunkRuns, off: usize, len: usize) -> Self {
+        let mut numbers = Vec::new();
+        let mut first_error = None;
+        for (rows, value) in runs.runs_in(off, len) {
+            if let Some(n) = value.numeric_lane_value() {
+                numbers.push((rows, n));
+            } else if first_error.is_none() {
+                first_error = value.error_lane_value();
+            }
+        }
+        NumericSegment::Runs {
+            numbers,
+            first_error,
+        }
+    }
+
+    /// Rows of a dense segment the kernels read from the numbers lane: the lane's valid
+    /// rows less the edited ones. `None` means every row.
+    fn base_rows(
+        numbers: &arrow_array::Float64Array,
+        edits: Option<&arrow_store::NumericEdits>,
+    ) -> Option<arrow_buffer::BooleanBuffer> {
+        let valid = numbers.nulls().map(|nulls| nulls.inner());
+        match (valid, edits) {
+            (valid, None) => valid.cloned(),
+            (None, Some(edits)) => Some(!&edits.rows),
+            (Some(valid), Some(edits)) => Some(valid & &!&edits.rows),
+        }
+    }
+
+    /// Numbers among the overlay entries of a dense segment.
+    fn edited_numbers(edits: Option<&arrow_store::NumericEdits>) -> impl Iterator<Item = f64> + '_ {
+        edits
+            .into_iter()
+            .flat_map(|edits| edits.entries.iter().filter_map(|edit| edit.number))
+    }
+
+    /// First error code in row order.
+    pub fn first_error(&self) -> Option<u8> {
+        match self {
+            NumericSegment::Dense { errors, edits, .. } => {
+                let edits = edits.as_deref();
+                let edited = edits.and_then(|edits| {
+                    edits
+                        .entries
+                        .iter()
+                        .find_map(|edit| Some((edit.row, edit.error?)))
+                });
+                if errors.null_count() == errors.len() {
+                    return edited.map(|(_, code)| code);
+                }
+                let base = match (errors.nulls(), edits) {
+                    (None, None) => (!errors.is_empty()).then_some(0),
+                    (Some(valid), None) => valid.valid_indices().next(),
+                    (None, Some(edits)) => (!&edits.rows).set_indices().next(),
+                    (Some(valid), Some(edits)) => {
+                        (valid.inner() & &!&edits.rows).set_indices().next()
+                    }
+                }
+                .map(|row| (row, errors.value(row)));
+                [base, edited]
+                    .into_iter()
+                    .flatten()
+                    .min_by_key(|&(row, _)| row)
+                    .map(|(_, code)| code)
+            }
+            NumericSegment::Runs { first_error, .. } => *first_error,
+        }
+    }
+
+    /// Sum of the numeric rows; a run contributes `value * rows`.
+    pub fn sum(&self) -> f64 {
+        match self {
+            NumericSegment::Dense { numbers, edits, .. } => {
+                let edits = edits.as_deref();
+                let mask = Self::base_rows(numbers, edits);
+                let (sum, _) = arrow_store::kernels::sum_count(numbers.values(), mask.as_ref());
+                Self::edited_numbers(edits).fold(sum, |acc, n| acc + n)
+            }
+            NumericSegment::Runs { numbers, .. } => {
+                numbers.iter().map(|&(rows, n)| n * rows as f64).sum()
+            }
+        }
+    }
+
+    /// Number of numeric rows.
+    pub fn count(&self) -> usize {
+        match self {
+            NumericSegment::Dense { numbers, edits, .. } => {
+                let edits = edits.as_deref();
+                let base = Self::base_rows(numbers, edits)
+                    .map_or(numbers.len(), |rows| rows.count_set_bits());
+                base + Self::edited_numbers(edits).count()
+            }
+            NumericSegment::Runs { numbers, .. } => numbers.iter().map(|&(rows, _)| rows).sum(),
+        }
+    }
+
+    pub fn min(&self) -> Option<f64> {
+        self.min_max().map(|(lo, _)| lo)
+    }
+
+    pub fn max(&self) -> Option<f64> {
+        self.min_max().map(|(_, hi)| hi)
+    }
+
+    /// Smallest and largest numeric rows.
+    pub fn min_max(&self) -> Option<(f64, f64)> {
+        let widen = |acc: Option<(f64, f64)>, n: f64| match acc {
+            Some((lo, hi)) => Some((lo.min(n), hi.max(n))),
+            None => Some((n, n)),
+        };
+        match self {
+            NumericSegment::Dense { numbers, edits, .. } => {
+                let edits = edits.as_deref();
+                let mask = Self::base_rows(numbers, edits);
+                let base = arrow_store::kernels::min_max(numbers.values(), mask.as_ref());
+                Self::edited_numbers(edits).fold(base, widen)
+            }
+            NumericSegment::Runs { numbers, .. } => {
+                numbers.iter().map(|&(_, n)| n).fold(None, widen)
+            }
+        }
+    }
+
+    /// Count, sum and second moment of the numeric rows, for variance-style reductions.
+    pub fn moments(&self) -> arrow_store::Moments {
+        match self {
+            NumericSegment::Dense { numbers, edits, .. } => {
+                let edits = edits.as_deref();
+                let mask = Self::base_rows(numbers, edits);
+                let mut moments = arrow_store::kernels::moments(numbers.values(), mask.as_ref());
+                for n in Self::edited_numbers(edits) {
+                    moments.push(n);
+                }
+                moments
+            }
+            NumericSegment::Runs { numbers, .. } => {
+                let mut moments = arrow_store::Moments::default();
+                for &(rows, n) in numbers {
+                    moments.merge(arrow_store::Moments::repeated(n, rows));
+                }
+                moments
+            }
+        }
+    }
+}
+
 pub struct RowChunkIterator<'a> {
     view: &'a RangeView<'a>,
     current_chunk_idx: usize,
@@ -111,12 +287,10 @@ impl<'a> Iterator for RowChunkIterator<'a> {
                     let booleans = Some(arrow_array::new_null_array(&DataType::Boolean, seg_len));
                     let text = Some(arrow_array::new_null_array(&DataType::Utf8, seg_len));
                     let errors = Some(arrow_array::new_null_array(&DataType::UInt8, seg_len));
-                    let type_tag: arrow_array::ArrayRef =
-                        Arc::new(arrow_array::UInt8Array::from(vec![
-                            arrow_store::TypeTag::Empty
-                                as u8;
-                            seg_len
-                        ]));
+                    let type_tag: arrow_array::ArrayRef = Arc::new(arrow_store::uniform_tags(
+                        arrow_store::TypeTag::Empty,
+                        seg_len,
+                    ));
                     cols.push(ChunkCol {
                         numbers,
                         booleans,
@@ -133,12 +307,10 @@ impl<'a> Iterator for RowChunkIterator<'a> {
                             Some(arrow_array::new_null_array(&DataType::Boolean, seg_len));
                         let text = Some(arrow_array::new_null_array(&DataType::Utf8, seg_len));
                         let errors = Some(arrow_array::new_null_array(&DataType::UInt8, seg_len));
-                        let type_tag: arrow_array::ArrayRef =
-                            Arc::new(arrow_array::UInt8Array::from(vec![
-                                arrow_store::TypeTag::Empty
-                                    as u8;
-                                seg_len
-                            ]));
+                        let type_tag: arrow_array::ArrayRef = Arc::new(arrow_store::uniform_tags(
+                            arrow_store::TypeTag::Empty,
+                            seg_len,
+                        ));
                         cols.push(ChunkCol {
                             numbers,
                             booleans,
@@ -149,6 +321,24 @@ impl<'a> Iterator for RowChunkIterator<'a> {
                         continue;
                     };
 
+                    // Run-encoded chunks decode only this segment's rows.
+                    if let Some(runs) = &ch.runs {
+                        let numbers: arrow_array::ArrayRef =
+                            Arc::new(runs.numbers(rel_off, seg_len));
+                        let booleans: arrow_array::ArrayRef =
+                            Arc::new(runs.booleans(rel_off, seg_len));
+                        let text: arrow_array::ArrayRef = Arc::new(runs.text(rel_off, seg_len));
+                        let errors: arrow_array::ArrayRef = Arc::new(runs.errors(rel_off, seg_len));
+                        cols.push(ChunkCol {
+                            numbers: Some(numbers),
+                            booleans: Some(booleans),
+                            text: Some(text),
+                            errors: Some(errors),
+                            type_tag: Arc::new(runs.type_tags(rel_off, seg_len)),
+                        });
+                        continue;
+                    }
+
                     let numbers_base: arrow_array::ArrayRef = ch.numbers_or_null();
                     let booleans_base: arrow_array::ArrayRef = ch.booleans_or_null();
                     let text_base: arrow_array::ArrayRef = ch.text_or_null();
@@ -278,6 +468,24 @@ impl<'a> RangeView<'a> {
         (self.rows, self.cols)
     }
 
+    /// Detach an owned-backed view from `'a` (an `Arc` clone, no row copy).
+    /// Views borrowing a workbook sheet are handed back unchanged.
+    pub fn into_owned(self) -> Result<RangeView<'static>, RangeView<'a>> {
+        match self.backing {
+            RangeBacking::Owned(sheet) => Ok(RangeView {
+                backing: RangeBacking::Owned(sheet),
+                sr: self.sr,
+                sc: self.sc,
+                er: self.er,
+                ec: self.ec,
+                rows: self.rows,
+                cols: self.cols,
+                cancel_token: self.cancel_token,
+            }),
+            backing => Err(RangeView { backing, ..self }),
+        }
+    }
+
     pub fn expand_to(&self, rows: usize, cols: usize) -> RangeView<'a> {
         let er = self.sr + rows.saturating_sub(1);
         let ec = self.sc + cols.saturating_sub(1);
@@ -410,10 +618,13 @@ impl<'a> RangeView<'a> {
         let row_start = chunk_starts[ch_idx];
         let in_off = abs_row - row_start;
         // Overlay takes precedence: user edits over computed over base.
-        let cascade = arrow_store::OverlayCascade::new(&ch.overlay, &ch.computed_overlay);
+        let cascade = ch.point_overlay_cascade();
         if let Some(ov) = cascade.get_scalar(in_off) {
             return ov.to_literal_for(sheet.date_system);
         }
+        if let Some(value) = ch.run_value_at(in_off) {
+            return value.to_literal_for(sheet.date_system);
+        }
         // Read tag and route to lane
         let tag_u8 = ch.type_tag.value(in_off);
         match arrow_store::TypeTag::from_u8(tag_u8) {
@@ -462,20 +673,10 @@ impl<'a> RangeView<'a> {
                     LiteralValue::Empty
                 }
             }
-            arrow_store::TypeTag::Text => {
-                if let Some(arr) = &ch.text {
-                    if arr.is_null(in_off) {
-                        return LiteralValue::Empty;
-                    }
-                    let sa = arr
-                        .as_any()
-                        .downcast_ref::<arrow_array::StringArray>()
-                        .unwrap();
-                    LiteralValue::Text(sa.value(in_off).to_string())
-                } else {
-                    LiteralValue::Empty
-                }
-            }
+            arrow_store::TypeTag::Text => ch
+                .text_at(in_off)
+                .map(|s| LiteralValue::Text(s.to_string()))
+                .unwrap_or(LiteralValue::Empty),
             arrow_store::TypeTag::Error => {
                 if let Some(arr) = &ch.errors {
                     if arr.is_null(in_off) {
@@ -516,6 +717,25 @@ impl<'a> RangeView<'a> {
         Ok(())
     }
 
+    /// Row-major cell traversal that the visitor can stop early.
+    pub fn try_for_each_cell(
+        &self,
+        f: &mut dyn FnMut(&LiteralValue) -> ControlFlow<()>,
+    ) -> Result<ControlFlow<()>, ExcelError> {
+        for res in self.iter_row_chunks() {
+            let cs = res?;
+            for r in 0..cs.row_len {
+                for c in 0..self.cols {
+                    let tmp = self.get_cell(cs.row_start + r, c);
+                    if f(&tmp).is_break() {
+                        return Ok(ControlFlow::Break(()));
+                    }
+                }
+            }
+        }
+        Ok(ControlFlow::Continue(()))
+    }
+
     /// Visit each row as a borrowed slice (buffered).
     pub fn for_each_row(
         &self,
@@ -685,7 +905,7 @@ impl<'a> RangeView<'a> {
                 };
                 let rel_off = (self.sr + cs.row_start) - chunk_starts[ch_idx];
                 let seg_range = rel_off..(rel_off + cs.row_len);
-                let cascade = arrow_store::OverlayCascade::new(&ch.overlay, &ch.computed_overlay);
+                let cascade = ch.overlay_cascade();
                 if cascade.has_any_in_range(seg_range.clone()) {
                     let base_fa = base
                         .as_any()
@@ -700,6 +920,172 @@ impl<'a> RangeView<'a> {
         })
     }
 
+    /// Row segments of the view, one per row chunk it touches.
+    fn row_segments(&self) -> impl Iterator<Item = Result<RowSegment, ExcelError>> + '_ {
+        let sheet = self.sheet();
+        let sheet_rows = sheet.nrows as usize;
+        let row_end = self.er.min(sheet_rows.saturating_sub(1));
+        let chunk_starts = &sheet.chunk_starts;
+        (0..chunk_starts.len()).filter_map(move |ci| {
+            if let Some(token) = &self.cancel_token
+                && token.load(Ordering::Relaxed)
+            {
+                return Some(Err(ExcelError::new(
+                    formualizer_common::ExcelErrorKind::Cancelled,
+                )));
+            }
+            let start = chunk_starts[ci];
+            let end = chunk_starts.get(ci + 1).copied().unwrap_or(sheet_rows);
+            if end <= start {
+                return None;
+            }
+            let is = start.max(self.sr);
+            let ie = (end - 1).min(row_end);
+            if is > ie {
+                return None;
+            }
+            Some(Ok(RowSegment {
+                chunk_idx: ci,
+                chunk_off: is - start,
+                row_start: is - self.sr,
+                row_len: ie - is + 1,
+            }))
+        })
+    }
+
+    /// Row intervals `(row_start, row_len)` of the view aligned to storage chunks. Every
+    /// row is covered once; rows past the sheet form a final interval.
+    pub fn row_chunk_bounds(&self) -> Result<Vec<(usize, usize)>, ExcelError> {
+        let mut out = self
+            .row_segments()
+            .map(|seg| seg.map(|seg| (seg.row_start, seg.row_len)))
+            .collect::<Result<Vec<_>, _>>()?;
+        let covered = out.last().map_or(0, |&(start, len)| start + len);
+        if covered < self.rows {
+            out.push((covered, self.rows - covered));
+        }
+        Ok(out)
+    }
+
+    /// Zone map of column `col` over `len` rows from `rel_start` (relative to the view).
+    ///
+    /// Merges the statistics of every chunk the interval touches, overlays included; rows
+    /// past the sheet or a missing chunk count as blanks. Callers use it to skip intervals
+    /// that cannot contain a match.
+    pub fn zone_map(&self, rel_start: usize, len: usize, col: usize) -> arrow_store::ZoneMap {
+        let mut zone = arrow_store::ZoneMap::EMPTY;
+        // Rows and columns past the view read as blanks.
+        let len = if rel_start + len > self.rows {
+            zone.include_blank();
+            len.min(self.rows.saturating_sub(rel_start))
+        } else {
+            len
+        };
+        if col >= self.cols {
+            zone.include_blank();
+            return zone;
+        }
+        if len == 0 {
+            return zone;
+        }
+        let sheet = self.sheet();
+        let sheet_rows = sheet.nrows as usize;
+        let abs_start = self.sr + rel_start;
+        let abs_end = (abs_start + len).min(sheet_rows);
+        let Some(column) = sheet.columns.get(self.sc + col) else {
+            zone.include_blank();
+            return zone;
+        };
+        let chunk_starts = &sheet.chunk_starts;
+        let mut ci = match chunk_starts.binary_search(&abs_start) {
+            Ok(i) => i,
+            Err(0) => 0,
+            Err(i) => i - 1,
+        };
+        while ci < chunk_starts.len() && chunk_starts[ci] < abs_end {
+            match column.chunk(ci) {
+                Some(ch) => zone.merge(&ch.zone_map()),
+                None => zone.include_blank(),
+            }
+            ci += 1;
+        }
+        if abs_start + len > sheet_rows {
+            zone.include_blank();
+        }
+        zone
+    }
+
+    /// Numeric and error lanes per row-segment for reductions. Segments of run-end encoded
+    /// chunks without overlay edits stay as runs, so SUM/COUNT/MIN/MAX fold a run in O(1)
+    /// without decoding it; sparse overlay edits stay a correction over the base lanes
+    /// (see `arrow_store::kernels`).
+    pub fn numeric_segments(
+        &self,
+    ) -> impl Iterator<Item = Result<(usize, usize, Vec<NumericSegment>), ExcelError>> + '_ {
+        self.row_segments().map(move |res| {
+            let seg = res?;
+            let sheet = self.sheet();
+            let mut out_cols = Vec::with_capacity(self.cols);
+            for col_idx in self.sc..=self.ec {
+                let Some(ch) = sheet
+                    .columns
+                    .get(col_idx)
+                    .and_then(|col| col.chunk(seg.chunk_idx))
+                else {
+                    out_cols.push(NumericSegment::Runs {
+                        numbers: Vec::new(),
+                        first_error: None,
+                    });
+                    continue;
+                };
+                let seg_range = seg.chunk_off..(seg.chunk_off + seg.row_len);
+                let cascade = ch.overlay_cascade();
+                let edited = cascade.has_any_in_range(seg_range.clone());
+                if let Some(runs) = &ch.runs
+                    && !edited
+                {
+                    out_cols.push(NumericSegment::from_runs(runs, seg.chunk_off, seg.row_len));
+                    continue;
+                }
+                let (numbers, errors) = match &ch.runs {
+                    Some(runs) => (
+                        runs.numbers(seg.chunk_off, seg.row_len),
+                        runs.errors(seg.chunk_off, seg.row_len),
+                    ),
+                    None => (
+                        ch.numbers_or_null().slice(seg.chunk_off, seg.row_len),
+                        ch.errors_or_null().slice(seg.chunk_off, seg.row_len),
+                    ),
+                };
+                // Sparse edits stay a correction over the base lanes; dense or covering
+                // ones are merged into new lanes.
+                let edits = if edited {
+                    cascade.numeric_edits(seg_range.clone())
+                } else {
+                    None
+                };
+                out_cols.push(match edits {
+                    Some(edits) => NumericSegment::Dense {
+                        numbers: Arc::new(numbers),
+                        errors: Arc::new(errors),
+                        edits: Some(Arc::new(edits)),
+                    },
+                    None if edited => NumericSegment::Dense {
+                        numbers: cascade.select_numbers(seg_range.clone(), &numbers),
+                        errors: cascade.select_errors(seg_range, &errors),
+                        edits: None,
+                    },
+                    None => NumericSegment::Dense {
+                        numbers: Arc::new(numbers),
+                        errors: Arc::new(errors),
+                        edits: None,
+                    },
+                });
+            }
+            Ok((seg.row_start, seg.row_len, out_cols))
+        })
+    }
+
     /// Typed boolean slices per row-segment, overlay-aware via zip.
     pub fn booleans_slices(
         &self,
@@ -743,7 +1129,7 @@ impl<'a> RangeView<'a> {
                 };
                 let rel_off = (self.sr + cs.row_start) - chunk_starts[ch_idx];
                 let seg_range = rel_off..(rel_off + cs.row_len);
-                let cascade = arrow_store::OverlayCascade::new(&ch.overlay, &ch.computed_overlay);
+                let cascade = ch.overlay_cascade();
                 if cascade.has_any_in_range(seg_range.clone()) {
                     let base_ba = base
                         .as_any()
@@ -792,7 +1178,7 @@ impl<'a> RangeView<'a> {
                 };
                 let rel_off = (self.sr + cs.row_start) - chunk_starts[ch_idx];
                 let seg_range = rel_off..(rel_off + cs.row_len);
-                let cascade = arrow_store::OverlayCascade::new(&ch.overlay, &ch.computed_overlay);
+                let cascade = ch.overlay_cascade();
                 if cascade.has_any_in_range(seg_range.clone()) {
                     let base_sa = base
                         .as_any()
@@ -846,7 +1232,7 @@ impl<'a> RangeView<'a> {
                     .downcast_ref::<arrow_array::StringArray>()
                     .expect("lowered slice downcast");
 
-                let cascade = arrow_store::OverlayCascade::new(&ch.overlay, &ch.computed_overlay);
+                let cascade = ch.overlay_cascade();
                 if cascade.has_any_in_range(seg_range.clone()) {
                     out_cols.push(cascade.select_lowered_text(seg_range, base_sa));
                 } else {
@@ -897,7 +1283,7 @@ impl<'a> RangeView<'a> {
                 };
                 let rel_off = (self.sr + cs.row_start) - chunk_starts[ch_idx];
                 let seg_range = rel_off..(rel_off + cs.row_len);
-                let cascade = arrow_store::OverlayCascade::new(&ch.overlay, &ch.computed_overlay);
+                let cascade = ch.overlay_cascade();
                 if cascade.has_any_in_range(seg_range.clone()) {
                     let base_ea = base
                         .as_any()
@@ -913,6 +1299,9 @@ impl<'a> RangeView<'a> {
     }
 
     /// Typed type-tag slices per row-segment.
+    ///
+    /// Segments of homogeneous chunks without overlay edits come back as shared uniform
+    /// lanes; check them with `arrow_store::uniform_type_tag` before scanning row by row.
     pub fn type_tags_slices(
         &self,
     ) -> impl Iterator<Item = Result<(usize, usize, Vec<Arc<arrow_array::UInt8Array>>), ExcelError>> + '_
@@ -949,7 +1338,7 @@ impl<'a> RangeView<'a> {
                 };
                 let rel_off = (self.sr + cs.row_start) - chunk_starts[ch_idx];
                 let seg_range = rel_off..(rel_off + cs.row_len);
-                let cascade = arrow_store::OverlayCascade::new(&ch.overlay, &ch.computed_overlay);
+                let cascade = ch.overlay_cascade();
                 if cascade.has_any_in_range(seg_range.clone()) {
                     let base_ta = base
                         .as_any()
@@ -1012,8 +1401,7 @@ impl<'a> RangeView<'a> {
                     if let Some(ch) = col_ref.chunk(ci) {
                         // Overlay-aware lowered segment
                         let seg_range = rel_off..(rel_off + seg_len);
-                        let cascade =
-                            arrow_store::OverlayCascade::new(&ch.overlay, &ch.computed_overlay);
+                        let cascade = ch.overlay_cascade();
                         if cascade.has_any_in_range(seg_range.clone()) {
                             let base_lowered = ch.text_lower_or_null();
                             let base_seg = base_lowered.slice(rel_off, seg_len);
@@ -1103,8 +1491,7 @@ impl<'a> RangeView<'a> {
                         let base_nums = base_nums_arc.as_ref();
 
                         let seg_range = rel_off_in_chunk..(rel_off_in_chunk + seg_len);
-                        let cascade =
-                            arrow_store::OverlayCascade::new(&ch.overlay, &ch.computed_overlay);
+                        let cascade = ch.overlay_cascade();
 
                         let final_arr = if cascade.has_any_in_range(seg_range.clone()) {
                             let base_slice = base_nums.slice(rel_off_in_chunk, seg_len);
@@ -1212,8 +1599,7 @@ impl<'a> RangeView<'a> {
                     if let Some(ch) = col.chunk(ch_idx) {
                         let base_lowered = ch.text_lower_or_null();
                         let seg_range = rel_off_in_chunk..(rel_off_in_chunk + seg_len);
-                        let cascade =
-                            arrow_store::OverlayCascade::new(&ch.overlay, &ch.computed_overlay);
+                        let cascade = ch.overlay_cascade();
 
                         let final_arr = if cascade.has_any_in_range(seg_range.clone()) {
                             let base_slice = base_lowered.slice(rel_off_in_chunk, seg_len);
@@ -1270,6 +1656,95 @@ impl<'a> RangeView<'a> {
         }
         out_cols
     }
+
+    /// Slice dictionary codes for a specific row interval (relative to view).
+    ///
+    /// A column yields `Some` only when every chunk it touches is either dictionary-encoded
+    /// with the same dictionary or holds no text, and no overlay covers the interval; rows
+    /// without text get null codes. Otherwise it yields `None` and callers fall back to the
+    /// Utf8 lanes (`slice_lowered_text`).
+    pub fn slice_text_codes(
+        &self,
+        rel_start: usize,
+        len: usize,
+    ) -> Vec<Option<arrow_store::TextCodes>> {
+        let abs_start = self.sr + rel_start;
+        let abs_end = abs_start + len;
+        let sheet = self.sheet();
+        let chunk_starts = &sheet.chunk_starts;
+
+        let mut out_cols = Vec::with_capacity(self.cols);
+        'cols: for col_idx in self.sc..=self.ec {
+            if col_idx >= sheet.columns.len() {
+                out_cols.push(None);
+                continue;
+            }
+            let col = &sheet.columns[col_idx];
+            let start_ch_idx = match chunk_starts.binary_search(&abs_start) {
+                Ok(i) => i,
+                Err(0) => 0,
+                Err(i) => i - 1,
+            };
+
+            let mut dict: Option<Arc<arrow_store::TextDictionary>> = None;
+            let mut codes = arrow_array::builder::UInt32Builder::with_capacity(len);
+            let mut curr = abs_start;
+            let mut ch_idx = start_ch_idx;
+
+            while curr < abs_end && ch_idx < chunk_starts.len() {
+                let ch_start = chunk_starts[ch_idx];
+                let ch_end = chunk_starts
+                    .get(ch_idx + 1)
+                    .copied()
+                    .unwrap_or(sheet.nrows as usize);
+                let overlap_start = curr.max(ch_start);
+                let overlap_end = ch_end.min(abs_end);
+
+                if overlap_start < overlap_end {
+                    let seg_len = overlap_end - overlap_start;
+                    let rel_off_in_chunk = overlap_start - ch_start;
+
+                    if let Some(ch) = col.chunk(ch_idx) {
+                        let seg_range = rel_off_in_chunk..(rel_off_in_chunk + seg_len);
+                        let cascade = ch.overlay_cascade();
+                        let run_text = ch.runs.is_some() && ch.meta.non_null_text > 0;
+                        if ch.text.is_some() || run_text || cascade.has_any_in_range(seg_range) {
+                            out_cols.push(None);
+                            continue 'cols;
+                        }
+                        if let Some((ch_codes, ch_dict)) = ch.dictionary_text() {
+                            match &dict {
+                                Some(d) if !Arc::ptr_eq(d, ch_dict) => {
+                                    out_cols.push(None);
+                                    continue 'cols;
+                                }
+                                Some(_) => {}
+                                None => dict = Some(ch_dict.clone()),
+                            }
+                            for code in ch_codes.slice(rel_off_in_chunk, seg_len).iter() {
+                                codes.append_option(code);
+                            }
+                        } else {
+                            codes.append_nulls(seg_len);
+                        }
+                    } else {
+                        codes.append_nulls(seg_len);
+                    }
+                    curr += seg_len;
+                }
+                ch_idx += 1;
+            }
+            if curr < abs_end {
+                codes.append_nulls(abs_end - curr);
+            }
+
+            out_cols.push(dict.map(|dict| arrow_store::TextCodes {
+                dict,
+                codes: codes.finish(),
+            }));
+        }
+        out_cols
+    }
 }
 
 #[inline]
@@ -158,6 +158,11 @@ pub struct RetainedResourceBudget {
     pub total_bytes: Option<u64>,
     pub mixed_cache_bytes: Option<u64>,
     pub lookup_cache_bytes: Option<u64>,
+    /// Heap bytes of Arrow base lanes kept resident. Past it, the least recently read
+    /// chunks without overlay entries are spilled to memory-mapped files at the next
+    /// evaluation request. Needs `scratch.disk_scratch_policy` = `NativeTemporary`; not
+    /// derived from a `ResourceEnvelope`, whose retained bytes cover caches only.
+    pub resident_chunk_bytes: Option<u64>,
 }
 
 #[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
@@ -245,6 +250,7 @@ impl ResourceEnvelope {
                 total_bytes: Some(self.retained_bytes),
                 mixed_cache_bytes: Some(mixed_cache),
                 lookup_cache_bytes: Some(lookup_cache),
+                resident_chunk_bytes: None,
             },
             scratch: ScratchResourceBudget {
                 total_bytes: Some(self.request_scratch_bytes),
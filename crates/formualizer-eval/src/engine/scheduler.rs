@@ -69,6 +69,15 @@ impl<'a> Scheduler<'a> {
     pub fn create_schedule(&self, vertices: &[VertexId]) -> Result<Schedule, ExcelError> {
         #[cfg(feature = "tracing")]
         let _span = tracing::info_span!("scheduler", vertices = vertices.len()).entered();
+        // 0. A consistent dynamic (PK) order already proves the subset acyclic, so
+        // its layers can be read off directly without SCC detection. Any cycle,
+        // stale order or unseen connected vertex falls through to Tarjan below.
+        if self.graph.dynamic_topo_enabled()
+            && let Some(layers) = self.graph.pk_ordered_layers_for(vertices)
+        {
+            return Ok(Schedule::from_parts(layers, Vec::new()));
+        }
+
         // 1. Find strongly connected components using Tarjan's algorithm
         #[cfg(feature = "tracing")]
         let _scc_span = tracing::info_span!("tarjan_scc").entered();
@@ -80,34 +89,6 @@ impl<'a> Scheduler<'a> {
         let (cycles, acyclic_sccs) = self.separate_cycles(sccs);
 
         // 3. Topologically sort acyclic components into layers
-        if self.graph.dynamic_topo_enabled() {
-            // Dynamic-topo (PK) branch: pk_layers_for orders only the acyclic
-            // subset, so we cannot interleave Cycle units by condensation
-            // position here. Stay conservative on this experimental path and
-            // emit ALL Cycle units first (matching today's stamp-cycles-first
-            // semantics), then the pk layers as Layer units.
-            let subset: Vec<VertexId> = acyclic_sccs.into_iter().flatten().collect();
-            let layers = if subset.is_empty() {
-                Vec::new()
-            } else {
-                self.graph
-                    .pk_layers_for(&subset)
-                    .unwrap_or(self.build_layers(vec![subset])?)
-            };
-            let mut units = Vec::with_capacity(cycles.len() + layers.len());
-            let mut cycle_order: Vec<usize> = (0..cycles.len()).collect();
-            cycle_order.sort_by_key(|&i| cycles[i].iter().copied().min());
-            for i in cycle_order {
-                units.push(ScheduleUnit::Cycle(i as u32));
-            }
-            units.extend((0..layers.len() as u32).map(ScheduleUnit::Layer));
-            return Ok(Schedule {
-                units,
-                cycles,
-                layers,
-            });
-        }
-
         if cycles.is_empty() {
             // Fast path: byte-for-byte today's layer construction.
             let layers = self.build_layers(acyclic_sccs)?;
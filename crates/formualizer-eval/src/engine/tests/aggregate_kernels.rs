@@ -0,0 +1,148 @@
+//! Aggregates over Arrow ranges with sparse overlay edits.
+//!
+//! SUM/AVERAGE/MIN/MAX/COUNT and the variance family reduce a range's numeric lanes with
+//! `arrow_store::kernels`, folding overlay edits in as a correction; results must match
+//! the cell values.
+
+use super::common::arrow_eval_config;
+use crate::engine::Engine;
+use crate::test_workbook::TestWorkbook;
+use formualizer_common::{ExcelErrorKind, LiteralValue};
+use formualizer_parse::parser::parse;
+
+const ROWS: u32 = 1_000;
+
+fn build() -> Engine<TestWorkbook> {
+    let mut cfg = arrow_eval_config();
+    cfg.enable_parallel = false;
+    let mut engine = Engine::new(TestWorkbook::default(), cfg);
+    {
+        let mut ab = engine.begin_bulk_ingest_arrow();
+        ab.add_sheet("S", 1, 256);
+        for i in 0..ROWS {
+            let v = if i % 9 == 4 {
+                LiteralValue::Text("n/a".into())
+            } else {
+                LiteralValue::Number(f64::from(i % 37) * 0.5 + 1_000.0)
+            };
+            ab.append_row("S", &[v]).unwrap();
+        }
+        ab.finish().unwrap();
+    }
+    // Sparse edits over the base lanes: a number, a number replacing text, text replacing
+    // a number, and a blank.
+    for (row, value) in [
+        (7, LiteralValue::Number(-250.0)),
+        (14, LiteralValue::Number(4_000.0)),
+        (300, LiteralValue::Text("x".into())),
+        (777, LiteralValue::Empty),
+    ] {
+        engine.set_cell_value("S", row, 1, value).unwrap();
+    }
+    engine
+}
+
+fn numbers(engine: &Engine<TestWorkbook>) -> Vec<f64> {
+    (1..=ROWS)
+        .filter_map(|row| match engine.get_cell_value("S", row, 1) {
+            Some(LiteralValue::Number(n)) => Some(n),
+            Some(LiteralValue::Int(n)) => Some(n as f64),
+            _ => None,
+        })
+        .collect()
+}
+
+fn eval(engine: &mut Engine<TestWorkbook>, formula: &str) -> LiteralValue {
+    engine
+        .set_cell_formula("Sheet1", 1, 1, parse(formula).unwrap())
+        .unwrap();
+    engine.evaluate_all().unwrap();
+    engine.get_cell_value("Sheet1", 1, 1).unwrap()
+}
+
+fn number(value: LiteralValue) -> f64 {
+    match value {
+        LiteralValue::Number(n) => n,
+        LiteralValue::Int(n) => n as f64,
+        other => panic!("{other:?}"),
+    }
+}
+
+fn close(actual: f64, expected: f64) {
+    assert!(
+        (actual - expected).abs() <= 1e-9 * expected.abs().max(1.0),
+        "{actual} vs {expected}"
+    );
+}
+
+#[test]
+fn aggregates_fold_overlay_edits_into_kernel_results() {
+    let mut engine = build();
+    let nums = numbers(&engine);
+    let n = nums.len() as f64;
+    let sum: f64 = nums.iter().sum();
+    let mean = sum / n;
+    let devsq: f64 = nums.iter().map(|v| (v - mean) * (v - mean)).sum();
+    let range = format!("S!A1:A{ROWS}");
+
+    close(number(eval(&mut engine, &format!("=SUM({range})"))), sum);
+    close(
+        number(eval(&mut engine, &format!("=AVERAGE({range})"))),
+        mean,
+    );
+    close(number(eval(&mut engine, &format!("=COUNT({range})"))), n);
+    close(number(eval(&mut engine, &format!("=MIN({range})"))), -250.0);
+    close(
+        number(eval(&mut engine, &format!("=MAX({range})"))),
+        4_000.0,
+    );
+    close(
+        number(eval(&mut engine, &format!("=DEVSQ({range})"))),
+        devsq,
+    );
+    close(
+        number(eval(&mut engine, &format!("=VAR.P({range})"))),
+        devsq / n,
+    );
+    close(
+        number(eval(&mut engine, &format!("=STDEV.S({range})"))),
+        (devsq / (n - 1.0)).sqrt(),
+    );
+}
+
+#[test]
+fn variance_skips_dates_and_reports_the_first_error() {
+    let mut engine = build();
+    let before = number(eval(&mut engine, &format!("=VAR.S(S!A1:A{ROWS})")));
+
+    // A date replacing a text cell is skipped by the statistics, as before.
+    let date = chrono::NaiveDate::from_ymd_opt(2024, 1, 2).unwrap();
+    engine
+        .set_cell_value("S", 5, 1, LiteralValue::Date(date))
+        .unwrap();
+    close(
+        number(eval(&mut engine, &format!("=VAR.S(S!A1:A{ROWS})"))),
+        before,
+    );
+
+    engine
+        .set_cell_value(
+            "S",
+            600,
+            1,
+            LiteralValue::Error(formualizer_common::ExcelError::new(ExcelErrorKind::Na)),
+        )
+        .unwrap();
+    engine
+        .set_cell_value(
+            "S",
+            500,
+            1,
+            LiteralValue::Error(formualizer_common::ExcelError::new(ExcelErrorKind::Div)),
+        )
+        .unwrap();
+    match eval(&mut engine, &format!("=STDEV.P(S!A1:A{ROWS})")) {
+        LiteralValue::Error(e) => assert_eq!(e.kind, ExcelErrorKind::Div),
+        other => panic!("{other:?}"),
+    }
+}
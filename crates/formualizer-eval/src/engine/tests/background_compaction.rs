@@ -0,0 +1,136 @@
+//! Background overlay compaction.
+//!
+//! With `background_overlay_compaction`, edits only queue their chunk; the rebuild is
+//! swapped in at the next evaluation boundary, and reads stay correct throughout.
+
+use super::common::arrow_eval_config;
+use crate::engine::Engine;
+use crate::test_workbook::TestWorkbook;
+use formualizer_common::LiteralValue;
+use formualizer_parse::parser::parse;
+
+fn build() -> Engine<TestWorkbook> {
+    let mut cfg = arrow_eval_config().with_background_overlay_compaction(true);
+    cfg.enable_parallel = false;
+    let mut engine = Engine::new(TestWorkbook::default(), cfg);
+    {
+        let mut ab = engine.begin_bulk_ingest_arrow();
+        ab.add_sheet("S", 1, 64);
+        for i in 0..64 {
+            ab.append_row("S", &[LiteralValue::Number(f64::from(i))])
+                .unwrap();
+        }
+        ab.finish().unwrap();
+    }
+    engine
+        .set_cell_formula("Sheet1", 1, 1, parse("=SUM(S!A1:A64)").unwrap())
+        .unwrap();
+    engine.evaluate_all().unwrap();
+    engine
+}
+
+fn overlay_len(engine: &Engine<TestWorkbook>) -> usize {
+    engine.sheet_store().sheet("S").unwrap().columns[0].chunks[0]
+        .overlay
+        .len()
+}
+
+fn total(engine: &Engine<TestWorkbook>) -> f64 {
+    match engine.get_cell_value("Sheet1", 1, 1) {
+        Some(LiteralValue::Number(n)) => n,
+        Some(LiteralValue::Int(n)) => n as f64,
+        other => panic!("{other:?}"),
+    }
+}
+
+#[test]
+fn edits_queue_compaction_until_the_next_evaluation() {
+    let mut engine = build();
+    let base: f64 = (0..64).map(f64::from).sum();
+
+    // Past the inline threshold (len/50 = 1), but compaction waits for a boundary.
+    for row in 1..=3 {
+        engine
+            .set_cell_value("S", row, 1, LiteralValue::Number(100.0))
+            .unwrap();
+    }
+    assert_eq!(overlay_len(&engine), 3);
+
+    engine.evaluate_all().unwrap();
+    assert_eq!(overlay_len(&engine), 0);
+    assert_eq!(total(&engine), base - 3.0 + 300.0);
+    let stats = engine.overlay_compaction_stats();
+    assert_eq!((stats.started, stats.installed, stats.inline), (1, 1, 0));
+    assert_eq!(
+        engine.get_cell_value("S", 2, 1),
+        Some(LiteralValue::Number(100.0))
+    );
+}
+
+#[test]
+fn long_edit_backlog_compacts_inline() {
+    let mut engine = build();
+    // Threshold 1 × backlog factor 8: the ninth edit compacts on the edit path.
+    for row in 1..=9 {
+        engine
+            .set_cell_value("S", row, 1, LiteralValue::Number(-1.0))
+            .unwrap();
+    }
+    assert_eq!(overlay_len(&engine), 0);
+    assert_eq!(engine.overlay_compaction_stats().inline, 1);
+    engine.evaluate_all().unwrap();
+    let base: f64 = (9..64).map(f64::from).sum();
+    assert_eq!(total(&engine), base - 9.0);
+}
+
+#[test]
+fn pool_rebuilds_install_at_a_later_boundary() {
+    let mut cfg = arrow_eval_config().with_background_overlay_compaction(true);
+    cfg.enable_parallel = true;
+    let mut engine = Engine::new(TestWorkbook::default(), cfg);
+    {
+        let mut ab = engine.begin_bulk_ingest_arrow();
+        ab.add_sheet("S", 1, 1000);
+        for _ in 0..1000 {
+            ab.append_row("S", &[LiteralValue::Number(1.0)]).unwrap();
+        }
+        ab.finish().unwrap();
+    }
+    engine
+        .set_cell_formula("Sheet1", 1, 1, parse("=SUM(S!A1:A1000)").unwrap())
+        .unwrap();
+    engine.evaluate_all().unwrap();
+
+    // Threshold len/50 = 20: 25 edits queue the chunk, the next boundary starts its rebuild.
+    let mut want = 1000.0;
+    for row in 1..=25 {
+        engine
+            .set_cell_value("S", row, 1, LiteralValue::Number(2.0))
+            .unwrap();
+        want += 1.0;
+    }
+    engine.evaluate_all().unwrap();
+    assert_eq!(total(&engine), want);
+
+    // Keep editing while the rebuild runs; edits made after its snapshot survive the
+    // swap, so every boundary agrees with the model whether or not it installed.
+    for row in 26..126 {
+        if engine.overlay_compaction_stats().installed > 0 {
+            break;
+        }
+        std::thread::sleep(std::time::Duration::from_millis(2));
+        engine
+            .set_cell_value("S", row, 1, LiteralValue::Number(2.0))
+            .unwrap();
+        want += 1.0;
+        engine.evaluate_all().unwrap();
+        assert_eq!(total(&engine), want);
+    }
+    let stats = engine.overlay_compaction_stats();
+    assert!(stats.installed > 0, "{stats:?}");
+    assert_eq!(stats.inline, 0);
+    assert_eq!(
+        engine.get_cell_value("S", 3, 1),
+        Some(LiteralValue::Number(2.0))
+    );
+}
@@ -0,0 +1,186 @@
+//! Register bytecode VM for arena formulas (`EvalConfig::enable_bytecode_vm`).
+//!
+//! Every formula is evaluated with the VM on and off; results must match the
+//! tree interpreter exactly, including errors and operand subtrees the VM
+//! delegates back to the interpreter.
+
+use crate::engine::{Engine, EvalConfig};
+use crate::test_workbook::TestWorkbook;
+use formualizer_common::LiteralValue;
+use formualizer_parse::parser::parse;
+
+const FORMULAS: &[&str] = &[
+    "=A1*2+B1/4-1",
+    "=-A1%",
+    "=+C1",
+    "=A1&\"-\"&C1",
+    "=A1>=B1",
+    "=(A1+1)^2",
+    "=SUM(A1:B1)+1",
+    "=IF(A1>1,A1,B1)*3",
+    "=Sheet2!A1+A1",
+    "=1/0",
+    "=A1+C1",
+    "=SUM(A1+{1,2})",
+    "=NOSUCHFUNCTION(1)+1",
+    "=ABS(-A1)",
+    "=B1<A1",
+    "=(0-A1)^0.5",
+    "=A1^0.5<>B1",
+    "=TRUE+A1",
+];
+
+fn build(config: EvalConfig) -> Engine<TestWorkbook> {
+    let mut engine = Engine::new(TestWorkbook::new(), config);
+    engine.add_sheet("Sheet2").unwrap();
+    engine
+        .set_cell_value("Sheet1", 1, 1, LiteralValue::Int(3))
+        .unwrap();
+    engine
+        .set_cell_value("Sheet1", 1, 2, LiteralValue::Number(8.0))
+        .unwrap();
+    engine
+        .set_cell_value("Sheet1", 1, 3, LiteralValue::Text("x".to_string()))
+        .unwrap();
+    engine
+        .set_cell_value("Sheet2", 1, 1, LiteralValue::Int(10))
+        .unwrap();
+    for (i, f) in FORMULAS.iter().enumerate() {
+        engine
+            .set_cell_formula("Sheet1", i as u32 + 1, 5, parse(f).expect("parse"))
+            .unwrap();
+    }
+    engine.evaluate_all().unwrap();
+    engine
+}
+
+#[test]
+fn vm_matches_tree_interpreter() {
+    let mut vm = build(EvalConfig::default().with_bytecode_vm(true));
+    let mut tree = build(EvalConfig::default().with_bytecode_vm(false));
+    for round in 0..2 {
+        for (i, f) in FORMULAS.iter().enumerate() {
+            let row = i as u32 + 1;
+            assert_eq!(
+                vm.get_cell_value("Sheet1", row, 5),
+                tree.get_cell_value("Sheet1", row, 5),
+                "{f} (round {round})"
+            );
+        }
+        for engine in [&mut vm, &mut tree] {
+            engine
+                .set_cell_value("Sheet1", 1, 1, LiteralValue::Number(0.5))
+                .unwrap();
+            engine.evaluate_all().unwrap();
+        }
+    }
+    assert_eq!(
+        vm.get_cell_value("Sheet1", 1, 5),
+        Some(LiteralValue::Number(2.0))
+    );
+
+    let stats = vm.bytecode_stats();
+    assert!(stats.compiled >= FORMULAS.len() as u64 - 1);
+    assert!(stats.vm_evals > 0);
+    assert_eq!(tree.bytecode_stats().vm_evals, 0);
+}
+
+#[test]
+fn programs_are_compiled_once_per_formula_root() {
+    let mut engine = build(EvalConfig::default());
+    let first = engine.bytecode_stats();
+    for v in 1..=3 {
+        engine
+            .set_cell_value("Sheet1", 1, 2, LiteralValue::Int(v))
+            .unwrap();
+        engine.evaluate_all().unwrap();
+    }
+    let after = engine.bytecode_stats();
+    assert_eq!(after.compiled, first.compiled);
+    assert!(after.vm_evals > first.vm_evals);
+}
+
+#[test]
+fn reference_roots_fall_back_to_the_tree() {
+    let mut engine = Engine::new(TestWorkbook::new(), EvalConfig::default());
+    engine
+        .set_cell_value("Sheet1", 1, 1, LiteralValue::Int(4))
+        .unwrap();
+    engine
+        .set_cell_formula("Sheet1", 1, 2, parse("=A1").unwrap())
+        .unwrap();
+    engine
+        .set_cell_formula("Sheet1", 2, 2, parse("=@A1:A1").unwrap())
+        .unwrap();
+    engine.evaluate_all().unwrap();
+    let stats = engine.bytecode_stats();
+    assert_eq!(stats.compiled, 1, "=A1 lowers to a single cell load");
+    assert!(stats.uncompiled >= 1, "=@A1:A1 stays on the tree");
+    assert!(stats.tree_evals >= 1);
+}
+
+#[test]
+fn providers_without_a_revision_do_not_cache_resolved_calls() {
+    let mut engine = Engine::new(
+        TestWorkbook::new().without_planning_revision(),
+        EvalConfig::default(),
+    );
+    engine
+        .set_cell_value("Sheet1", 1, 1, LiteralValue::Int(-2))
+        .unwrap();
+    for (row, f) in [(1, "=A1*3"), (2, "=ABS(A1)")] {
+        engine
+            .set_cell_formula("Sheet1", row, 2, parse(f).unwrap())
+            .unwrap();
+    }
+    engine.evaluate_all().unwrap();
+    assert_eq!(
+        engine.get_cell_value("Sheet1", 2, 2),
+        Some(LiteralValue::Number(2.0))
+    );
+    let stats = engine.bytecode_stats();
+    assert_eq!(stats.compiled, 1);
+    assert_eq!(stats.uncompiled, 1);
+}
+
+#[test]
+fn binary_sites_leave_the_numeric_kernel_after_repeated_guard_misses() {
+    let mut engine = Engine::new(TestWorkbook::new(), EvalConfig::default());
+    engine
+        .set_cell_value("Sheet1", 1, 1, LiteralValue::Number(2.0))
+        .unwrap();
+    engine
+        .set_cell_formula("Sheet1", 1, 2, parse("=A1*3>5").unwrap())
+        .unwrap();
+    engine
+        .set_cell_formula("Sheet1", 1, 3, parse("=A1+4").unwrap())
+        .unwrap();
+    engine.evaluate_all().unwrap();
+    let stats = engine.bytecode_stats();
+    assert_eq!(stats.binary_sites, 3);
+    assert_eq!(stats.generic_binary_sites, 0);
+
+    // Text operands miss the numeric guard on both `A1+4` and `A1*3`; the
+    // generic path still coerces them.
+    for round in 0..20 {
+        engine
+            .set_cell_value("Sheet1", 1, 1, LiteralValue::Text(round.to_string()))
+            .unwrap();
+        engine.evaluate_all().unwrap();
+        assert_eq!(
+            engine.get_cell_value("Sheet1", 1, 3),
+            Some(LiteralValue::Number(f64::from(round) + 4.0))
+        );
+    }
+    let stats = engine.bytecode_stats();
+    assert_eq!(stats.generic_binary_sites, 2, "{stats:?}");
+
+    engine
+        .set_cell_value("Sheet1", 1, 1, LiteralValue::Number(1.5))
+        .unwrap();
+    engine.evaluate_all().unwrap();
+    assert_eq!(
+        engine.get_cell_value("Sheet1", 1, 2),
+        Some(LiteralValue::Boolean(false))
+    );
+}
@@ -0,0 +1,96 @@
+//! Background chunk rebalancing.
+//!
+//! With `adaptive_chunk_rebalancing`, structural edits that fragment a sheet's chunks
+//! are merged back toward the target length at the next evaluation boundary, without
+//! changing any value.
+
+use super::common::arrow_eval_config;
+use crate::engine::Engine;
+use crate::test_workbook::TestWorkbook;
+use formualizer_common::LiteralValue;
+use formualizer_parse::parser::parse;
+
+fn build(rebalance: bool) -> Engine<TestWorkbook> {
+    let mut cfg = arrow_eval_config().with_adaptive_chunk_rebalancing(rebalance);
+    cfg.enable_parallel = false;
+    let mut engine = Engine::new(TestWorkbook::default(), cfg);
+    {
+        let mut ab = engine.begin_bulk_ingest_arrow();
+        ab.add_sheet("S", 1, 16);
+        for i in 0..64 {
+            ab.append_row("S", &[LiteralValue::Number(f64::from(i))])
+                .unwrap();
+        }
+        ab.finish().unwrap();
+    }
+    engine
+        .set_cell_formula("Sheet1", 1, 1, parse("=SUM(S!A1:A64)").unwrap())
+        .unwrap();
+    engine.evaluate_all().unwrap();
+    engine
+}
+
+fn fragment(engine: &mut Engine<TestWorkbook>) {
+    for before in [3, 10, 21, 30, 45] {
+        engine.insert_rows("S", before, 1).unwrap();
+    }
+}
+
+fn chunk_lens(engine: &Engine<TestWorkbook>) -> Vec<usize> {
+    engine.sheet_store().sheet("S").unwrap().columns[0]
+        .chunks
+        .iter()
+        .map(|ch| ch.len())
+        .collect()
+}
+
+fn total(engine: &Engine<TestWorkbook>) -> f64 {
+    match engine.get_cell_value("Sheet1", 1, 1) {
+        Some(LiteralValue::Number(n)) => n,
+        Some(LiteralValue::Int(n)) => n as f64,
+        other => panic!("{other:?}"),
+    }
+}
+
+#[test]
+fn fragmented_chunks_are_merged_at_the_next_evaluation() {
+    let mut engine = build(true);
+    let base: f64 = (0..64).map(f64::from).sum();
+    fragment(&mut engine);
+    let fragmented = chunk_lens(&engine);
+    assert!(fragmented.len() > 4, "{fragmented:?}");
+
+    engine.evaluate_all().unwrap();
+    let lens = chunk_lens(&engine);
+    assert!(lens.len() < fragmented.len(), "{lens:?}");
+    assert_eq!(lens.iter().sum::<usize>(), 69);
+    let (last, interior) = lens.split_last().unwrap();
+    // Target is 16, 32 or 64 rows depending on how the SUM's reads were counted.
+    assert!(
+        interior.iter().all(|&len| (8..=128).contains(&len)),
+        "{lens:?}"
+    );
+    assert!(*last <= 128);
+
+    let stats = engine.chunk_rebalance_stats();
+    assert_eq!((stats.started, stats.installed, stats.discarded), (1, 1, 0));
+    assert_eq!(total(&engine), base);
+    assert_eq!(
+        engine.get_cell_value("S", 5, 1),
+        Some(LiteralValue::Number(3.0))
+    );
+
+    engine.evaluate_all().unwrap();
+    assert_eq!(total(&engine), base);
+    assert_eq!(engine.chunk_rebalance_stats().discarded, 0);
+}
+
+#[test]
+fn rebalancing_is_off_by_default() {
+    let mut engine = build(false);
+    fragment(&mut engine);
+    let fragmented = chunk_lens(&engine);
+    engine.evaluate_all().unwrap();
+    assert_eq!(chunk_lens(&engine), fragmented);
+    assert_eq!(engine.chunk_rebalance_stats().started, 0);
+}
@@ -0,0 +1,117 @@
+//! Cold chunk tier.
+//!
+//! With `resident_chunk_bytes` set and native disk scratch allowed, chunks nobody has
+//! read lately are spilled to memory-mapped files at the start of an evaluation request;
+//! formulas and edits over them behave as before.
+
+use super::common::arrow_eval_config;
+use crate::arrow_store::ColumnChunk;
+use crate::engine::{DiskScratchPolicy, Engine, EvaluationBudgets};
+use crate::test_workbook::TestWorkbook;
+use formualizer_common::LiteralValue;
+use formualizer_parse::parser::parse;
+
+fn build(budgets: EvaluationBudgets) -> Engine<TestWorkbook> {
+    let mut cfg = arrow_eval_config();
+    cfg.enable_parallel = false;
+    let mut engine = Engine::new(TestWorkbook::default(), cfg);
+    engine.set_evaluation_resource_budgets(budgets);
+    {
+        let mut ab = engine.begin_bulk_ingest_arrow();
+        ab.add_sheet("Ref", 2, 64);
+        for i in 0..256 {
+            ab.append_row(
+                "Ref",
+                &[
+                    LiteralValue::Number(f64::from(i)),
+                    LiteralValue::Text(format!("k{i}")),
+                ],
+            )
+            .unwrap();
+        }
+        ab.finish().unwrap();
+    }
+    for (row, formula) in [
+        (1, "=SUM(Ref!A1:A256)"),
+        (2, "=VLOOKUP(200,Ref!A1:B256,2,FALSE)"),
+    ] {
+        engine
+            .set_cell_formula("Sheet1", row, 1, parse(formula).unwrap())
+            .unwrap();
+    }
+    engine
+}
+
+fn spill_budgets(policy: Option<DiskScratchPolicy>) -> EvaluationBudgets {
+    let mut budgets = EvaluationBudgets::default();
+    budgets.retained.resident_chunk_bytes = Some(0);
+    budgets.scratch.disk_scratch_policy = policy;
+    budgets
+}
+
+fn value(engine: &Engine<TestWorkbook>, row: u32) -> Option<LiteralValue> {
+    engine.get_cell_value("Sheet1", row, 1)
+}
+
+fn ref_chunks(engine: &Engine<TestWorkbook>) -> impl Iterator<Item = &ColumnChunk> {
+    let sheet = engine.sheet_store().sheet("Ref").unwrap();
+    sheet.columns.iter().flat_map(|c| c.chunks.iter())
+}
+
+#[cfg(not(target_arch = "wasm32"))]
+#[test]
+fn unread_chunks_spill_and_still_evaluate() {
+    let mut engine = build(spill_budgets(Some(DiskScratchPolicy::NativeTemporary)));
+    engine.evaluate_all().unwrap();
+
+    let stats = engine.cold_tier_stats();
+    assert!(stats.spilled_chunks >= 8);
+    assert_eq!(stats.spill_errors, 0);
+    assert!(ref_chunks(&engine).all(|ch| ch.is_cold()));
+    let base: f64 = (0..256).map(f64::from).sum();
+    assert_eq!(value(&engine, 1), Some(LiteralValue::Number(base)));
+    assert_eq!(value(&engine, 2), Some(LiteralValue::Text("k200".into())));
+
+    // Edits over a spilled chunk land in its overlay as usual.
+    engine
+        .set_cell_value("Ref", 201, 2, LiteralValue::Text("edited".into()))
+        .unwrap();
+    engine
+        .set_cell_value("Ref", 1, 1, LiteralValue::Number(1000.0))
+        .unwrap();
+    engine.evaluate_all().unwrap();
+    assert_eq!(value(&engine, 1), Some(LiteralValue::Number(base + 1000.0)));
+    assert_eq!(value(&engine, 2), Some(LiteralValue::Text("edited".into())));
+    assert_eq!(engine.cold_tier_stats().spill_errors, 0);
+}
+
+#[cfg(not(target_arch = "wasm32"))]
+#[test]
+fn chunks_read_since_the_last_request_stay_resident() {
+    let mut engine = build(EvaluationBudgets::default());
+    engine.evaluate_all().unwrap();
+    let sheet = engine.sheet_store().sheet("Ref").unwrap();
+    for ch in &sheet.columns[0].chunks {
+        let _ = ch.overlay_cascade();
+    }
+
+    engine.set_evaluation_resource_budgets(spill_budgets(Some(DiskScratchPolicy::NativeTemporary)));
+    engine.evaluate_all().unwrap();
+    let sheet = engine.sheet_store().sheet("Ref").unwrap();
+    assert!(sheet.columns[0].chunks.iter().all(|ch| !ch.is_cold()));
+    assert!(sheet.columns[1].chunks[0].is_cold());
+
+    // Nothing read them during that request, so the next one spills them.
+    engine.evaluate_all().unwrap();
+    assert!(ref_chunks(&engine).all(|ch| ch.is_cold()));
+    assert_eq!(engine.cold_tier_stats().spill_errors, 0);
+}
+
+#[test]
+fn without_native_disk_scratch_chunks_stay_resident() {
+    let mut engine = build(spill_budgets(None));
+    engine.evaluate_all().unwrap();
+
+    assert_eq!(engine.cold_tier_stats(), Default::default());
+    assert!(ref_chunks(&engine).all(|ch| !ch.is_cold()));
+}
@@ -0,0 +1,117 @@
+//! Ahead-of-time constant folding (`EvalConfig::with_constant_folding`).
+//!
+//! Constant subtrees and inline arrays are evaluated once at ingest and
+//! reused by every formula that shares them. Values must match an engine
+//! without folding, under both date systems and across edits.
+
+use crate::engine::{DateSystem, Engine, EvalConfig};
+use crate::test_workbook::TestWorkbook;
+use formualizer_common::LiteralValue;
+use formualizer_parse::parser::parse;
+
+const ROWS: u32 = 6;
+
+fn formulas(row: u32) -> [String; 5] {
+    [
+        format!("=A{row}*(1+0.05/12)^12"),
+        format!("=SUM({{1,2,3}})*A{row}"),
+        format!("=INDEX({{10,20,30}},1,2)+A{row}"),
+        format!("=DATE(2024,1,1)+A{row}"),
+        format!("=IF(A{row}>3,ROUND(2.345,2),-ABS(-1))"),
+    ]
+}
+
+fn build(folding: bool, date_system: DateSystem) -> Engine<TestWorkbook> {
+    let config = EvalConfig::default()
+        .with_parallel(false)
+        .with_date_system(date_system)
+        .with_constant_folding(folding);
+    let mut engine = Engine::new(TestWorkbook::new(), config);
+    for row in 1..=ROWS {
+        engine
+            .set_cell_value("Sheet1", row, 1, LiteralValue::Number(f64::from(row)))
+            .unwrap();
+        for (i, formula) in formulas(row).iter().enumerate() {
+            engine
+                .set_cell_formula("Sheet1", row, i as u32 + 2, parse(formula).expect("parse"))
+                .unwrap();
+        }
+    }
+    engine.evaluate_all().unwrap();
+    engine
+}
+
+fn assert_same_values(folded: &Engine<TestWorkbook>, plain: &Engine<TestWorkbook>) {
+    for row in 1..=ROWS {
+        for col in 2..=6 {
+            assert_eq!(
+                folded.get_cell_value("Sheet1", row, col),
+                plain.get_cell_value("Sheet1", row, col),
+                "row {row} col {col}"
+            );
+        }
+    }
+}
+
+#[test]
+fn folded_constants_match_unfolded_values_across_edits() {
+    for date_system in [DateSystem::Excel1900, DateSystem::Excel1904] {
+        let mut folded = build(true, date_system);
+        let mut plain = build(false, date_system);
+        assert_same_values(&folded, &plain);
+
+        let stats = folded.constant_fold_stats();
+        // `(1+0.05/12)^12`, `SUM({1,2,3})`, `INDEX(...)`, `DATE(...)`,
+        // `ROUND(...)` and `-ABS(-1)`, each shared by every row.
+        assert_eq!(stats.folded_nodes, 6, "{stats:?}");
+        assert_eq!(plain.constant_fold_stats().folded_nodes, 0);
+
+        for engine in [&mut folded, &mut plain] {
+            engine
+                .set_cell_value("Sheet1", 2, 1, LiteralValue::Number(10.0))
+                .unwrap();
+            engine.evaluate_all().unwrap();
+        }
+        assert_same_values(&folded, &plain);
+    }
+}
+
+#[test]
+fn inline_arrays_fold_to_shared_array_constants() {
+    let config = EvalConfig::default()
+        .with_parallel(false)
+        .with_bytecode_vm(false)
+        .with_constant_folding(true);
+    let mut engine = Engine::new(TestWorkbook::new(), config);
+    for row in 1..=ROWS {
+        engine
+            .set_cell_formula(
+                "Sheet1",
+                row,
+                1,
+                parse("=SUMPRODUCT({1,2,3},{4,5,6})").expect("parse"),
+            )
+            .unwrap();
+    }
+    engine.evaluate_all().unwrap();
+    for row in 1..=ROWS {
+        assert_eq!(
+            engine.get_cell_value("Sheet1", row, 1),
+            Some(LiteralValue::Number(32.0))
+        );
+    }
+    let stats = engine.constant_fold_stats();
+    // The whole call folds; `{1,2,3}` and `{4,5,6}` need no entry of their own.
+    assert_eq!(stats.folded_nodes, 1, "{stats:?}");
+    assert!(stats.reuses > 0, "{stats:?}");
+
+    engine
+        .set_cell_formula("Sheet1", 1, 2, parse("=A1*{1,2,3}").expect("parse"))
+        .unwrap();
+    engine.evaluate_all().unwrap();
+    assert_eq!(engine.constant_fold_stats().array_constants, 1);
+    assert_eq!(
+        engine.get_cell_value("Sheet1", 1, 4),
+        Some(LiteralValue::Number(96.0))
+    );
+}
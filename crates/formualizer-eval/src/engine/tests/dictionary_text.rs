@@ -0,0 +1,126 @@
+//! Dictionary-encoded text lanes.
+//!
+//! Low-cardinality text columns are stored as codes into a per-column dictionary shared
+//! across chunks; criteria and lookups compare codes. Results must match the plain-text
+//! semantics, before and after overlay edits.
+
+use super::common::arrow_eval_config;
+use crate::engine::Engine;
+use crate::test_workbook::TestWorkbook;
+use crate::traits::EvaluationContext;
+use arrow_array::Array as _;
+use formualizer_common::LiteralValue;
+use formualizer_parse::parser::{ReferenceType, parse};
+
+const ROWS: u32 = 300;
+const REGIONS: [&str; 4] = ["East", "west", "NORTH", "east"];
+const FORMULAS: [&str; 7] = [
+    "=COUNTIF(Data!A1:A300,\"EAST\")",
+    "=COUNTIF(Data!A1:A300,\"<>west\")",
+    "=SUMIFS(Data!B1:B300,Data!A1:A300,\"north\")",
+    "=COUNTIFS(Data!A1:A300,\"east\",Data!B1:B300,\">100\")",
+    "=MATCH(\"North\",Data!A1:A300,0)",
+    "=MATCH(\"North\",Data!A1:A300,0)+0",
+    "=XLOOKUP(\"WEST\",Data!A1:A300,Data!B1:B300)",
+];
+
+fn region(i: u32) -> Option<&'static str> {
+    (i % 7 != 3).then(|| REGIONS[(i % 4) as usize])
+}
+
+fn build() -> Engine<TestWorkbook> {
+    let mut cfg = arrow_eval_config();
+    cfg.enable_parallel = false;
+    let mut engine = Engine::new(TestWorkbook::new(), cfg);
+    {
+        let mut ab = engine.begin_bulk_ingest_arrow();
+        ab.add_sheet("Data", 2, 64);
+        for i in 0..ROWS {
+            let text = region(i).map_or(LiteralValue::Empty, |r| LiteralValue::Text(r.into()));
+            ab.append_row("Data", &[text, LiteralValue::Number(f64::from(i))])
+                .unwrap();
+        }
+        ab.finish().unwrap();
+    }
+    for (i, formula) in FORMULAS.iter().enumerate() {
+        engine
+            .set_cell_formula("Sheet1", i as u32 + 1, 1, parse(formula).expect("parse"))
+            .unwrap();
+    }
+    engine.evaluate_all().unwrap();
+    engine
+}
+
+/// The same formulas evaluated directly over `model` (lowercased text per row).
+fn expected(model: &[Option<String>]) -> Vec<f64> {
+    let is = |i: usize, s: &str| model[i].as_deref() == Some(s);
+    let rows = 0..model.len();
+    let first = |s: &str| rows.clone().find(|&i| is(i, s)).unwrap();
+    vec![
+        rows.clone().filter(|&i| is(i, "east")).count() as f64,
+        rows.clone().filter(|&i| !is(i, "west")).count() as f64,
+        rows.clone()
+            .filter(|&i| is(i, "north"))
+            .map(|i| i as f64)
+            .sum(),
+        rows.clone().filter(|&i| is(i, "east") && i > 100).count() as f64,
+        (first("north") + 1) as f64,
+        (first("north") + 1) as f64,
+        first("west") as f64,
+    ]
+}
+
+fn assert_matches_model(engine: &Engine<TestWorkbook>, model: &[Option<String>]) {
+    for (i, want) in expected(model).into_iter().enumerate() {
+        let got = match engine.get_cell_value("Sheet1", i as u32 + 1, 1) {
+            Some(LiteralValue::Number(n)) => n,
+            Some(LiteralValue::Int(n)) => n as f64,
+            other => panic!("{}: {other:?}", FORMULAS[i]),
+        };
+        assert_eq!(got, want, "{}", FORMULAS[i]);
+    }
+}
+
+#[test]
+fn dictionary_text_criteria_and_lookups_match_plain_text() {
+    let mut engine = build();
+    let sheet = engine.sheet_store().sheet("Data").expect("arrow sheet");
+    let regions = &sheet.columns[0];
+    assert!(regions.chunks.iter().all(|ch| ch.text_codes.is_some()));
+    assert!(
+        sheet.columns[1]
+            .chunks
+            .iter()
+            .all(|ch| ch.text_dict.is_none())
+    );
+
+    let mut model: Vec<Option<String>> = (0..ROWS)
+        .map(|i| region(i).map(str::to_lowercase))
+        .collect();
+    assert_matches_model(&engine, &model);
+
+    let rng = ReferenceType::range(
+        Some("Data".to_string()),
+        Some(1),
+        Some(1),
+        Some(ROWS),
+        Some(1),
+    );
+    let view = engine.resolve_range_view(&rng, "Data").unwrap();
+    let pred = crate::args::parse_criteria(&LiteralValue::Text("EAST".into())).unwrap();
+    let mask = engine.build_criteria_mask(&view, 0, &pred).expect("mask");
+    for (i, lowered) in model.iter().enumerate() {
+        match lowered {
+            Some(s) => assert_eq!(mask.value(i), s == "east", "row {i}"),
+            None => assert!(mask.is_null(i), "row {i}"),
+        }
+    }
+
+    // An overlay edit takes the Utf8 path for its chunk until compaction.
+    engine
+        .set_cell_value("Data", 2, 1, LiteralValue::Text("North".into()))
+        .unwrap();
+    engine.evaluate_all().unwrap();
+    model[1] = Some("north".into());
+    assert_matches_model(&engine, &model);
+}
@@ -72,3 +72,88 @@ fn pk_cycle_detection() {
     g.pred.entry(VertexId(1)).or_default().push(VertexId(2));
     assert!(pk.try_add_edge(&g, VertexId(2), VertexId(1)).is_err());
 }
+
+mod engine_default {
+    use crate::engine::{Engine, EvalConfig};
+    use crate::test_workbook::TestWorkbook;
+    use formualizer_common::{ExcelErrorKind, LiteralValue};
+    use formualizer_parse::parser::parse;
+
+    fn make_engine() -> Engine<TestWorkbook> {
+        Engine::new(TestWorkbook::new(), EvalConfig::default())
+    }
+
+    #[test]
+    fn dynamic_topo_is_on_by_default_and_survives_an_edit_storm() {
+        let mut engine = make_engine();
+        assert!(engine.graph.dynamic_topo_telemetry().is_some());
+
+        engine
+            .set_cell_value("Sheet1", 1, 1, LiteralValue::Int(1))
+            .unwrap();
+        for row in 2..=50 {
+            engine
+                .set_cell_formula("Sheet1", row, 1, parse(format!("=A{}+1", row - 1)).unwrap())
+                .unwrap();
+        }
+        engine.evaluate_all().unwrap();
+        assert_eq!(
+            engine.get_cell_value("Sheet1", 50, 1),
+            Some(LiteralValue::Number(50.0))
+        );
+
+        // Re-point every tenth link at the head of the chain; each edit inserts an
+        // edge against the current order.
+        for row in (10..=50).step_by(10) {
+            engine
+                .set_cell_formula("Sheet1", row, 1, parse("=A1+100").unwrap())
+                .unwrap();
+        }
+        engine.evaluate_all().unwrap();
+        assert_eq!(
+            engine.get_cell_value("Sheet1", 50, 1),
+            Some(LiteralValue::Number(101.0))
+        );
+        assert_eq!(
+            engine.get_cell_value("Sheet1", 49, 1),
+            Some(LiteralValue::Number(110.0))
+        );
+
+        let telemetry = engine.graph.dynamic_topo_telemetry().unwrap();
+        assert!(telemetry.edge_inserts > 0);
+        assert_eq!(telemetry.budget_fallbacks, 0);
+        assert!(telemetry.full_rebuilds <= 1);
+    }
+
+    #[test]
+    fn cycles_still_resolve_to_circ_with_dynamic_topo() {
+        let mut engine = make_engine();
+        engine
+            .set_cell_formula("Sheet1", 1, 1, parse("=B1").unwrap())
+            .unwrap();
+        engine
+            .set_cell_formula("Sheet1", 1, 2, parse("=A1").unwrap())
+            .unwrap();
+        engine
+            .set_cell_formula("Sheet1", 1, 3, parse("=A1+1").unwrap())
+            .unwrap();
+        engine.evaluate_all().unwrap();
+
+        for col in 1..=2 {
+            match engine.get_cell_value("Sheet1", 1, col) {
+                Some(LiteralValue::Error(e)) => assert_eq!(e.kind, ExcelErrorKind::Circ),
+                other => panic!("expected #CIRC! at column {col}, got {other:?}"),
+            }
+        }
+
+        // Breaking the cycle lets the ordered fast path take over again.
+        engine
+            .set_cell_value("Sheet1", 1, 2, LiteralValue::Int(5))
+            .unwrap();
+        engine.evaluate_all().unwrap();
+        assert_eq!(
+            engine.get_cell_value("Sheet1", 1, 3),
+            Some(LiteralValue::Number(6.0))
+        );
+    }
+}
@@ -0,0 +1,222 @@
+//! Columnar execution of FormulaPlane row-run spans
+//! (`EvalConfig::enable_columnar_spans`).
+//!
+//! Every family is evaluated with the columnar executor on and off; results
+//! must match the per-placement interpreter exactly, including rows that fall
+//! back because an input is text or the row errors. The span JIT tier
+//! (`EvalConfig::enable_span_jit`) is held to the same results.
+
+use std::sync::Arc;
+
+use formualizer_common::LiteralValue;
+use formualizer_parse::parser::parse;
+
+use crate::engine::{
+    Engine, EvalConfig, FormulaIngestBatch, FormulaIngestRecord, FormulaPlaneMode, SpanJitStats,
+};
+use crate::test_workbook::TestWorkbook;
+
+const SHEET: &str = "Sheet1";
+const ROWS: u32 = 300;
+
+const TEMPLATES: &[&str] = &[
+    "=A{r}*$D$1+B{r}/4-1",
+    "=A{r}/B{r}",
+    "=IF(A{r}>B{r}*20,A{r}-B{r},-(B{r}-A{r}))^2",
+    "=SQRT(A{r}-150)",
+    "=A{r}>=B{r}*40",
+    "=ABS(B{r}-A{r}%)",
+];
+
+fn input_a(row: u32) -> LiteralValue {
+    if row % 50 == 0 {
+        LiteralValue::Text("x".to_string())
+    } else {
+        LiteralValue::Number(f64::from(row))
+    }
+}
+
+fn config(columnar: bool) -> EvalConfig {
+    EvalConfig::default()
+        .with_formula_plane_mode(FormulaPlaneMode::AuthoritativeExperimental)
+        .with_parallel(false)
+        .with_columnar_spans(columnar)
+}
+
+fn build(columnar: bool, templates: &[&str]) -> Engine<TestWorkbook> {
+    build_with(config(columnar), templates)
+}
+
+fn build_with(config: EvalConfig, templates: &[&str]) -> Engine<TestWorkbook> {
+    let mut engine = Engine::new(TestWorkbook::default(), config);
+    engine
+        .set_cell_value(SHEET, 1, 4, LiteralValue::Number(2.0))
+        .unwrap();
+    let mut formulas = Vec::new();
+    for row in 1..=ROWS {
+        engine.set_cell_value(SHEET, row, 1, input_a(row)).unwrap();
+        engine
+            .set_cell_value(SHEET, row, 2, LiteralValue::Int(i64::from(row % 7)))
+            .unwrap();
+        for (i, template) in templates.iter().enumerate() {
+            let formula = template.replace("{r}", &row.to_string());
+            let ast = parse(&formula).unwrap_or_else(|err| panic!("parse {formula}: {err}"));
+            let ast_id = engine.intern_formula_ast(&ast);
+            formulas.push(FormulaIngestRecord::new(
+                row,
+                5 + i as u32,
+                ast_id,
+                Some(Arc::<str>::from(formula)),
+            ));
+        }
+    }
+    engine
+        .ingest_formula_batches(vec![FormulaIngestBatch::new(SHEET, formulas)])
+        .expect("ingest formulas");
+    engine.evaluate_all().unwrap();
+    engine
+}
+
+fn assert_same_results(columnar: &Engine<TestWorkbook>, tree: &Engine<TestWorkbook>, when: &str) {
+    for (i, template) in TEMPLATES.iter().enumerate() {
+        for row in 1..=ROWS {
+            let col = 5 + i as u32;
+            assert_eq!(
+                columnar.get_cell_value(SHEET, row, col),
+                tree.get_cell_value(SHEET, row, col),
+                "{template} at row {row} ({when})"
+            );
+        }
+    }
+}
+
+#[test]
+fn columnar_spans_match_per_placement_results() {
+    let mut columnar = build(true, TEMPLATES);
+    let mut tree = build(false, TEMPLATES);
+    assert_same_results(&columnar, &tree, "initial");
+    assert_eq!(
+        columnar.get_cell_value(SHEET, 3, 5),
+        Some(LiteralValue::Number(5.75))
+    );
+
+    for engine in [&mut columnar, &mut tree] {
+        engine
+            .set_cell_value(SHEET, 1, 4, LiteralValue::Number(-3.0))
+            .unwrap();
+        engine
+            .set_cell_value(SHEET, 10, 1, LiteralValue::Boolean(true))
+            .unwrap();
+        engine
+            .set_cell_value(SHEET, 50, 1, LiteralValue::Number(7.5))
+            .unwrap();
+        engine.evaluate_all().unwrap();
+    }
+    assert_same_results(&columnar, &tree, "after edits");
+}
+
+#[test]
+fn columnar_report_counts_interpreter_fallback_rows() {
+    let engine = build(true, &TEMPLATES[..1]);
+    let report = engine.last_formula_plane_span_eval_report().unwrap();
+    assert_eq!(report.columnar_invocations, 1, "{report:?}");
+    assert_eq!(
+        report.columnar_placement_count,
+        u64::from(ROWS),
+        "{report:?}"
+    );
+    // Only the text rows in column A leave the numeric lanes.
+    assert_eq!(
+        report.columnar_fallback_count,
+        u64::from(ROWS / 50),
+        "{report:?}"
+    );
+    assert_eq!(report.sequential_per_placement_invocations, 0, "{report:?}");
+
+    let tree = build(false, &TEMPLATES[..1]);
+    let report = tree.last_formula_plane_span_eval_report().unwrap();
+    assert_eq!(report.columnar_invocations, 0, "{report:?}");
+}
+
+#[test]
+fn span_jit_tiers_up_after_repeated_recalcs() {
+    let config = config(true)
+        .with_span_jit(true)
+        .with_span_jit_tier_up_placements(2 * u64::from(ROWS));
+    let mut jit = build_with(config, &TEMPLATES[..1]);
+    let mut tree = build(false, &TEMPLATES[..1]);
+    assert_eq!(jit.span_jit_stats(), SpanJitStats::default());
+
+    // Every row reads $D$1, so each edit re-evaluates the whole run.
+    for (recalc, scale) in [4.0, -0.5, 3.0].into_iter().enumerate() {
+        for engine in [&mut jit, &mut tree] {
+            engine
+                .set_cell_value(SHEET, 1, 4, LiteralValue::Number(scale))
+                .unwrap();
+            engine.evaluate_all().unwrap();
+        }
+        for row in 1..=ROWS {
+            assert_eq!(
+                jit.get_cell_value(SHEET, row, 5),
+                tree.get_cell_value(SHEET, row, 5),
+                "row {row} after recalc {recalc}"
+            );
+        }
+    }
+
+    let stats = jit.span_jit_stats();
+    let report = jit.last_formula_plane_span_eval_report().unwrap();
+    if cfg!(all(feature = "jit", not(target_arch = "wasm32"))) {
+        assert_eq!(stats.compiled, 1, "{stats:?}");
+        assert_eq!(stats.kernel_runs, 3, "{stats:?}");
+        assert_eq!(stats.deopt_rows, 3 * u64::from(ROWS / 50), "{stats:?}");
+        assert_eq!(report.jit_invocations, 1, "{report:?}");
+    } else {
+        assert_eq!(stats.unavailable, 1, "{stats:?}");
+        assert_eq!(stats.kernel_runs, 0, "{stats:?}");
+        assert_eq!(report.jit_invocations, 0, "{report:?}");
+    }
+    assert_eq!(
+        report.columnar_fallback_count,
+        u64::from(ROWS / 50),
+        "{report:?}"
+    );
+}
+
+#[test]
+fn span_jit_shares_kernels_across_constants() {
+    // Same program shape, different literals: one kernel serves both spans.
+    let templates = ["=A{r}*$D$1+B{r}/4-1", "=A{r}*$D$1+B{r}/8-3"];
+    let config = config(true)
+        .with_span_jit(true)
+        .with_span_jit_tier_up_placements(u64::from(ROWS));
+    let mut jit = build_with(config, &templates);
+    let mut tree = build(false, &templates);
+
+    for scale in [4.0, -0.5] {
+        for engine in [&mut jit, &mut tree] {
+            engine
+                .set_cell_value(SHEET, 1, 4, LiteralValue::Number(scale))
+                .unwrap();
+            engine.evaluate_all().unwrap();
+        }
+        for (i, template) in templates.iter().enumerate() {
+            for row in 1..=ROWS {
+                let col = 5 + i as u32;
+                assert_eq!(
+                    jit.get_cell_value(SHEET, row, col),
+                    tree.get_cell_value(SHEET, row, col),
+                    "{template} at row {row} (scale {scale})"
+                );
+            }
+        }
+    }
+
+    let stats = jit.span_jit_stats();
+    if cfg!(all(feature = "jit", not(target_arch = "wasm32"))) {
+        assert_eq!(stats.compiled, 1, "{stats:?}");
+        assert!(stats.kernel_runs >= 4, "{stats:?}");
+    } else {
+        assert_eq!(stats.unavailable, 1, "{stats:?}");
+    }
+}
@@ -228,3 +228,38 @@ fn nested_let_lambda_dependency_recalc_engine() {
         Some(LiteralValue::Number(22.0))
     );
 }
+
+#[test]
+fn let_binds_function_arrays_and_sheet_ranges_engine() {
+    let mut engine = Engine::new(TestWorkbook::new(), EvalConfig::default());
+    for r in 1..=3 {
+        engine
+            .set_cell_value("Sheet1", r, 1, LiteralValue::Int(r as i64))
+            .unwrap();
+    }
+    // SEQUENCE is bound as its owned array view; A1:A3 borrows the sheet and
+    // is materialized. Both are read repeatedly and captured by a LAMBDA.
+    for (col, f) in [
+        (2, "=LET(s,SEQUENCE(4),SUM(s)+ROWS(s)+INDEX(s,3))"),
+        (3, "=LET(s,SEQUENCE(3),f,LAMBDA(k,SUM(s)*k),s,1,f(2)+s)"),
+        (4, "=LET(r,A1:A3,SUM(r)*ROWS(r))"),
+    ] {
+        engine
+            .set_cell_formula("Sheet1", 1, col, parse(f).unwrap())
+            .unwrap();
+    }
+    engine.evaluate_all().unwrap();
+
+    assert_eq!(
+        engine.get_cell_value("Sheet1", 1, 2),
+        Some(LiteralValue::Number(17.0))
+    );
+    assert_eq!(
+        engine.get_cell_value("Sheet1", 1, 3),
+        Some(LiteralValue::Number(13.0))
+    );
+    assert_eq!(
+        engine.get_cell_value("Sheet1", 1, 4),
+        Some(LiteralValue::Number(18.0))
+    );
+}
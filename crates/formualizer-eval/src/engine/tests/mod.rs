@@ -5,6 +5,7 @@ mod change_log;
 mod changelog_replay;
 mod clock_snapshot;
 mod common;
+mod constant_folding;
 mod cross_sheet_named_range_first_cell;
 mod cycle_detection;
 mod deferred_dirty;
@@ -24,24 +25,34 @@ mod load_fast_mappings;
 mod mark_dirty_multi_source;
 mod mixed_target_coordinator;
 mod parallel;
+mod parallel_dirty_propagation;
+mod priority_evaluation;
+mod pure_call_memo;
 mod range_dependencies;
+mod range_materialization;
 mod range_property_tests;
 mod recalc_plan;
+mod run_encoded_chunks;
 mod schedule_cache;
 mod schedule_integration;
 mod schedule_units;
 mod sheet_index_integration;
 //mod streaming_evaluation;
 mod bulk_ingest;
+mod bytecode_vm;
 mod column_operations;
 mod debug_vertex_lifecycle;
 mod dynamic_topo;
 mod named_ranges;
+mod numa_placement;
 mod range_operations;
 mod row_operations;
+mod scratch_arena;
+mod shared_subexpressions;
 mod sheet_duplication_named_range_dependents;
 mod sheet_management;
 mod sources;
+mod speculative_dynamic_refs;
 mod staged_formula_scaling;
 mod stripe_streaming_integration;
 mod stripe_tests;
@@ -88,12 +99,16 @@ mod effects_603;
 
 mod implicit_intersection_103;
 
+mod aggregate_kernels;
 mod arrow_bulk_update;
 mod arrow_chunk_growth;
 mod arrow_sparse_compaction;
 mod arrow_sparse_extension;
 mod arrow_sparse_structural_ops;
 mod arrow_sparse_used_bounds;
+mod background_compaction;
+mod chunk_rebalance;
+mod cold_chunks;
 mod compressed_range_scheduler;
 mod computed_array_aggregates;
 mod computed_flush;
@@ -107,6 +122,7 @@ mod criteria_mask_text_chunked;
 mod criteria_ne_blank_extra;
 mod criteria_overlay_parity;
 mod custom_function_registry_compat;
+mod dictionary_text;
 mod dynamic_array_computed_arguments;
 mod dynamic_lookup_arrow;
 mod eval_delta;
@@ -114,6 +130,7 @@ mod eval_flush_recalc_probe;
 mod formula_edit_propagation;
 mod formula_error_propagation;
 mod formula_overlay_writeback;
+mod formula_plane_columnar_span_eval;
 mod formula_plane_coverage_pinning;
 mod formula_plane_cycle_member_exclusion;
 mod formula_plane_demotion_correctness;
@@ -151,6 +168,7 @@ mod sumifs_cached_mask_padding;
 mod sumifs_ne_blank_158;
 mod used_bounds_cache;
 mod whole_column_sumifs;
+mod zone_map_pruning;
 
 mod aggregate_visibility_options;
 mod row_visibility_mask;
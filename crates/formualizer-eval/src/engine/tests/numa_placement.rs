@@ -0,0 +1,92 @@
+//! NUMA-aware thread placement (`EvalConfig::thread_placement`).
+//!
+//! A synthetic two-node topology (both nodes on CPU 0, which always exists)
+//! exercises per-node pools and ownership routing on any machine. Routed
+//! layers must produce exactly the values of a sequential evaluation.
+
+use crate::engine::{Engine, EvalConfig, NumaTopology, ThreadPlacement};
+use crate::test_workbook::TestWorkbook;
+use formualizer_common::LiteralValue;
+use formualizer_parse::parser::parse;
+
+const ROWS: u32 = 200;
+
+fn build(config: EvalConfig) -> Engine<TestWorkbook> {
+    let mut engine = Engine::new(TestWorkbook::new(), config);
+    engine.add_sheet("Sheet2").unwrap();
+    for r in 1..=ROWS {
+        engine
+            .set_cell_value("Sheet1", r, 1, LiteralValue::Int(r as i64))
+            .unwrap();
+        for (sheet, f) in [
+            ("Sheet1", format!("=A{r}*2")),
+            ("Sheet2", format!("=Sheet1!A{r}+Sheet1!B{r}")),
+        ] {
+            engine
+                .set_cell_formula(sheet, r, 2, parse(&f).expect("parse"))
+                .unwrap();
+        }
+    }
+    engine.evaluate_all().unwrap();
+    engine
+}
+
+fn two_node_config() -> EvalConfig {
+    EvalConfig::default()
+        .with_parallel(true)
+        .with_thread_placement(ThreadPlacement::PerNode)
+        .with_numa_topology(NumaTopology::from_nodes(vec![vec![0], vec![0]]))
+}
+
+#[test]
+fn per_node_routing_matches_sequential_results() {
+    let mut routed = build(two_node_config());
+    let mut sequential = build(EvalConfig::default().with_parallel(false));
+    assert_eq!(routed.numa_node_count(), 2);
+    assert_eq!(sequential.numa_node_count(), 1);
+
+    for engine in [&mut routed, &mut sequential] {
+        engine
+            .set_cell_value("Sheet1", 7, 1, LiteralValue::Int(100))
+            .unwrap();
+        engine.evaluate_all().unwrap();
+    }
+    for r in [1, 7, ROWS] {
+        for sheet in ["Sheet1", "Sheet2"] {
+            assert_eq!(
+                routed.get_cell_value(sheet, r, 2),
+                sequential.get_cell_value(sheet, r, 2),
+                "{sheet}!B{r}"
+            );
+        }
+    }
+    assert_eq!(
+        routed.get_cell_value("Sheet2", 7, 2),
+        Some(LiteralValue::Number(300.0))
+    );
+}
+
+#[test]
+fn pinned_and_single_node_placements_keep_one_pool() {
+    let pinned = build(
+        EvalConfig::default()
+            .with_parallel(true)
+            .with_thread_placement(ThreadPlacement::Pinned)
+            .with_numa_topology(NumaTopology::from_nodes(vec![vec![0]])),
+    );
+    assert_eq!(pinned.numa_node_count(), 1);
+    assert!(pinned.thread_pool().is_some());
+    assert_eq!(
+        pinned.get_cell_value("Sheet2", ROWS, 2),
+        Some(LiteralValue::Number(f64::from(3 * ROWS)))
+    );
+
+    // A one-node topology degrades PerNode to a single pinned pool.
+    let single = build(
+        EvalConfig::default()
+            .with_parallel(true)
+            .with_thread_placement(ThreadPlacement::PerNode)
+            .with_numa_topology(NumaTopology::from_nodes(vec![vec![0]])),
+    );
+    assert_eq!(single.numa_node_count(), 1);
+}
@@ -0,0 +1,90 @@
+//! Frontier-based dirty propagation (`graph/dirty_frontier.rs`).
+//!
+//! Levels at least `parallel_dirty_propagation_threshold` wide are expanded on
+//! the engine pool. The parallel walk must claim exactly the vertices the
+//! sequential walk claims; work is asserted via `dirty_propagation_visits`.
+
+use crate::engine::{Engine, EvalConfig};
+use crate::test_workbook::TestWorkbook;
+use formualizer_common::LiteralValue;
+use formualizer_parse::parser::parse;
+
+const FAN_OUT: u32 = 300;
+const TAIL: u32 = 50;
+
+fn set_formula(engine: &mut Engine<TestWorkbook>, row: u32, col: u32, f: &str) {
+    engine
+        .set_cell_formula("Sheet1", row, col, parse(f).expect("parse"))
+        .expect("set formula");
+}
+
+/// A1 feeds B1:B{FAN_OUT} directly, C1 sums that column through a range
+/// dependency, and D1:D{TAIL} read C1.
+fn build(threshold: usize) -> Engine<TestWorkbook> {
+    let config = EvalConfig::default()
+        .with_parallel(true)
+        .with_parallel_dirty_propagation_threshold(threshold);
+    let mut engine = Engine::new(TestWorkbook::new(), config);
+    engine
+        .set_cell_value("Sheet1", 1, 1, LiteralValue::Int(1))
+        .unwrap();
+    for r in 1..=FAN_OUT {
+        set_formula(&mut engine, r, 2, &format!("=A1*{r}"));
+    }
+    set_formula(&mut engine, 1, 3, &format!("=SUM(B1:B{FAN_OUT})"));
+    for r in 1..=TAIL {
+        set_formula(&mut engine, r, 4, &format!("=C1+{r}"));
+    }
+    engine.evaluate_all().unwrap();
+    engine
+}
+
+fn edit_and_count(engine: &mut Engine<TestWorkbook>) -> u64 {
+    let before = engine.graph.dirty_propagation_visits();
+    engine
+        .set_cell_value("Sheet1", 1, 1, LiteralValue::Int(2))
+        .unwrap();
+    engine.graph.dirty_propagation_visits() - before
+}
+
+#[test]
+fn parallel_frontier_claims_the_same_vertices_as_sequential() {
+    let mut sequential = build(usize::MAX);
+    let mut parallel = build(1);
+
+    let seq_visits = edit_and_count(&mut sequential);
+    let par_visits = edit_and_count(&mut parallel);
+    assert_eq!(seq_visits, u64::from(FAN_OUT + 1 + TAIL));
+    assert_eq!(par_visits, seq_visits);
+
+    for engine in [&mut sequential, &mut parallel] {
+        engine.evaluate_all().unwrap();
+        let sum = f64::from(FAN_OUT * (FAN_OUT + 1));
+        assert_eq!(
+            engine.get_cell_value("Sheet1", 1, 3),
+            Some(LiteralValue::Number(sum))
+        );
+        assert_eq!(
+            engine.get_cell_value("Sheet1", TAIL, 4),
+            Some(LiteralValue::Number(sum + f64::from(TAIL)))
+        );
+    }
+}
+
+#[test]
+fn repeated_walks_reuse_the_claim_bitset() {
+    let mut engine = build(1);
+    let first = edit_and_count(&mut engine);
+    engine.evaluate_all().unwrap();
+    // A stale claim bit would hide vertices from the second walk.
+    let before = engine.graph.dirty_propagation_visits();
+    engine
+        .set_cell_value("Sheet1", 1, 1, LiteralValue::Int(3))
+        .unwrap();
+    assert_eq!(engine.graph.dirty_propagation_visits() - before, first);
+    engine.evaluate_all().unwrap();
+    assert_eq!(
+        engine.get_cell_value("Sheet1", FAN_OUT, 2),
+        Some(LiteralValue::Number(f64::from(3 * FAN_OUT)))
+    );
+}
@@ -0,0 +1,121 @@
+//! Viewport-first priority evaluation: the precedent cone of registered hot regions is
+//! evaluated and published before the rest of the dirty set.
+
+use crate::engine::{Engine, EvalConfig, EvaluationTarget};
+use crate::test_workbook::TestWorkbook;
+use formualizer_common::{ExcelError, LiteralValue, RangeAddress};
+use formualizer_parse::parser::parse;
+use std::sync::Arc;
+use std::sync::atomic::{AtomicBool, Ordering};
+
+fn make_engine() -> Engine<TestWorkbook> {
+    Engine::new(
+        TestWorkbook::new(),
+        EvalConfig::default().with_parallel(false),
+    )
+}
+
+/// A1 feeds a visible chain in B1:B2 and an off-screen column D.
+fn setup(engine: &mut Engine<TestWorkbook>) -> Result<(), ExcelError> {
+    engine.set_cell_value("Sheet1", 1, 1, LiteralValue::Int(1))?;
+    engine.set_cell_formula("Sheet1", 1, 2, parse("=A1*10").unwrap())?;
+    engine.set_cell_formula("Sheet1", 2, 2, parse("=B1+1").unwrap())?;
+    for row in 1..=20 {
+        engine.set_cell_formula("Sheet1", row, 4, parse("=A1+100").unwrap())?;
+    }
+    engine.evaluate_all()?;
+    engine.set_priority_regions(vec![EvaluationTarget::Range(
+        RangeAddress::new("Sheet1", 1, 2, 2, 2).unwrap(),
+    )]);
+    Ok(())
+}
+
+#[test]
+fn hot_regions_publish_before_background_completes() -> Result<(), ExcelError> {
+    let mut engine = make_engine();
+    setup(&mut engine)?;
+    engine.set_cell_value("Sheet1", 1, 1, LiteralValue::Int(2))?;
+
+    let mut published = false;
+    let result = engine.evaluate_priority_first(Arc::new(AtomicBool::new(false)), |e, hot| {
+        published = true;
+        assert_eq!(hot.computed_vertices, 2);
+        assert_eq!(
+            e.get_cell_value("Sheet1", 2, 2),
+            Some(LiteralValue::Number(21.0))
+        );
+        // Off-screen dependents have not been recomputed yet.
+        assert_eq!(
+            e.get_cell_value("Sheet1", 5, 4),
+            Some(LiteralValue::Number(101.0))
+        );
+    })?;
+
+    assert!(published);
+    assert!(!result.background_cancelled);
+    assert_eq!(result.background.map(|r| r.computed_vertices), Some(20));
+    assert_eq!(
+        engine.get_cell_value("Sheet1", 5, 4),
+        Some(LiteralValue::Number(102.0))
+    );
+    Ok(())
+}
+
+#[test]
+fn cancelled_background_leaves_remaining_vertices_dirty() -> Result<(), ExcelError> {
+    let mut engine = make_engine();
+    setup(&mut engine)?;
+    engine.set_cell_value("Sheet1", 1, 1, LiteralValue::Int(3))?;
+
+    let cancel = Arc::new(AtomicBool::new(false));
+    let flag = Arc::clone(&cancel);
+    let result = engine.evaluate_priority_first(cancel, move |_, _| {
+        flag.store(true, Ordering::Relaxed);
+    })?;
+    assert!(result.background_cancelled);
+    assert!(result.background.is_none());
+    assert_eq!(
+        engine.get_cell_value("Sheet1", 2, 2),
+        Some(LiteralValue::Number(31.0))
+    );
+    assert_eq!(
+        engine.get_cell_value("Sheet1", 5, 4),
+        Some(LiteralValue::Number(101.0))
+    );
+
+    let finished = engine.evaluate_all()?;
+    assert_eq!(finished.computed_vertices, 20);
+    assert_eq!(
+        engine.get_cell_value("Sheet1", 5, 4),
+        Some(LiteralValue::Number(103.0))
+    );
+    Ok(())
+}
+
+#[test]
+fn priority_plan_survives_value_edits_and_rebuilds_after_topology_edits() -> Result<(), ExcelError>
+{
+    let mut engine = make_engine();
+    setup(&mut engine)?;
+
+    engine.set_cell_value("Sheet1", 1, 1, LiteralValue::Int(4))?;
+    engine.evaluate_priority_regions(None)?;
+    assert_eq!(
+        engine.get_cell_value("Sheet1", 2, 2),
+        Some(LiteralValue::Number(41.0))
+    );
+
+    // Re-point the visible chain: the retained plan is stale and must be rebuilt.
+    engine.set_cell_value("Sheet1", 1, 3, LiteralValue::Int(7))?;
+    engine.set_cell_formula("Sheet1", 1, 2, parse("=C1*10").unwrap())?;
+    engine.evaluate_priority_regions(None)?;
+    assert_eq!(
+        engine.get_cell_value("Sheet1", 2, 2),
+        Some(LiteralValue::Number(71.0))
+    );
+
+    engine.clear_priority_regions();
+    assert!(engine.priority_regions().is_empty());
+    assert_eq!(engine.evaluate_priority_regions(None)?.computed_vertices, 0);
+    Ok(())
+}
@@ -0,0 +1,83 @@
+//! Pure function call memoization (`EvalConfig::with_pure_call_memo`).
+//!
+//! Calls are keyed by function plus argument values, so repeated
+//! `NORM.S.INV` over a few distinct inputs is computed once per input; range
+//! arguments pin entries to the data they read. Values must match an engine
+//! without the memo, before and after edits.
+
+use crate::engine::{Engine, EvalConfig};
+use crate::test_workbook::TestWorkbook;
+use formualizer_common::LiteralValue;
+use formualizer_parse::parser::parse;
+
+const ROWS: u32 = 12;
+
+fn build(memo: bool) -> Engine<TestWorkbook> {
+    let config = EvalConfig::default()
+        .with_parallel(false)
+        .with_pure_call_memo(memo);
+    let mut engine = Engine::new(TestWorkbook::new(), config);
+    for row in 1..=ROWS {
+        let p = [0.1, 0.5, 0.9][(row % 3) as usize];
+        engine
+            .set_cell_value("Sheet1", row, 1, LiteralValue::Number(p))
+            .unwrap();
+        engine
+            .set_cell_formula(
+                "Sheet1",
+                row,
+                2,
+                parse(&format!("=NORM.S.INV(A{row})")).expect("parse"),
+            )
+            .unwrap();
+        engine
+            .set_cell_formula(
+                "Sheet1",
+                row,
+                3,
+                parse("=MEDIAN($A$1:$A$12)+ROUND(2.5,0)").expect("parse"),
+            )
+            .unwrap();
+    }
+    engine.evaluate_all().unwrap();
+    engine
+}
+
+fn assert_same_values(memo: &Engine<TestWorkbook>, plain: &Engine<TestWorkbook>) {
+    for row in 1..=ROWS {
+        for col in 2..=3 {
+            assert_eq!(
+                memo.get_cell_value("Sheet1", row, col),
+                plain.get_cell_value("Sheet1", row, col),
+                "row {row} col {col}"
+            );
+        }
+    }
+}
+
+#[test]
+fn memoized_calls_match_unmemoized_values_across_edits() {
+    let mut memo = build(true);
+    let mut plain = build(false);
+    assert_same_values(&memo, &plain);
+
+    let stats = memo.pure_call_memo_stats();
+    // Three distinct p-values, one MEDIAN range and one ROUND constant call.
+    assert!(stats.hits > 0, "{stats:?}");
+    assert!(stats.entries >= 3, "{stats:?}");
+    assert!(stats.bytes > 0, "{stats:?}");
+    assert_eq!(plain.pure_call_memo_stats().hits, 0);
+
+    for engine in [&mut memo, &mut plain] {
+        engine
+            .set_cell_value("Sheet1", 4, 1, LiteralValue::Number(0.75))
+            .unwrap();
+        engine.evaluate_all().unwrap();
+    }
+    assert_same_values(&memo, &plain);
+    assert_ne!(
+        memo.get_cell_value("Sheet1", 4, 2),
+        memo.get_cell_value("Sheet1", 1, 2)
+    );
+    assert!(memo.pure_call_memo_stats().hits > stats.hits);
+}
@@ -0,0 +1,91 @@
+//! Builtins read range arguments through `RangeView` instead of copying the
+//! referenced cells into owned rows (`Engine::range_materialization_stats`).
+
+use crate::engine::{Engine, EvalConfig};
+use crate::test_workbook::TestWorkbook;
+use formualizer_common::LiteralValue;
+use formualizer_parse::parser::parse;
+
+const FORMULAS: &[(&str, &str)] = &[
+    ("=PRODUCT(A1:A6)", "720"),
+    ("=SUM(MODE.MULT(C1:C6))", "5"),
+    ("=SUM(FREQUENCY(A1:A6,D1:D2))", "6"),
+    ("=INDEX(LINEST(B1:B6,A1:A6),1,1)", "2"),
+    ("=TEXTJOIN(\"-\",TRUE,A1:A3)", "1-2-3"),
+    ("=DSUM(F1:G4,\"Score\",H1:H2)", "40"),
+    ("=DGET(F1:G4,\"Score\",I1:I2)", "20"),
+    ("=AND(A1:A6)", "TRUE"),
+    ("=OR(D1:D2)", "TRUE"),
+    ("=LOOKUP(4,A1:A6,B1:B6)", "9"),
+    ("=SUMPRODUCT(A1:A6,B1:B6)", "203"),
+    ("=MULTINOMIAL(A1:A2)", "3"),
+];
+
+fn build() -> Engine<TestWorkbook> {
+    let mut engine = Engine::new(
+        TestWorkbook::new(),
+        EvalConfig::default().with_parallel(false),
+    );
+    let mut set = |row: u32, col: u32, value: LiteralValue| {
+        engine.set_cell_value("Sheet1", row, col, value).unwrap();
+    };
+    for (i, mode) in [1.0, 2.0, 2.0, 3.0, 3.0, 4.0].into_iter().enumerate() {
+        let row = i as u32 + 1;
+        let x = f64::from(row);
+        set(row, 1, LiteralValue::Number(x));
+        set(row, 2, LiteralValue::Number(2.0 * x + 1.0));
+        set(row, 3, LiteralValue::Number(mode));
+    }
+    set(1, 4, LiteralValue::Number(2.0));
+    set(2, 4, LiteralValue::Number(4.0));
+    let text = |s: &str| LiteralValue::Text(s.into());
+    set(1, 6, text("Name"));
+    set(1, 7, text("Score"));
+    for (row, (name, score)) in [("a", 10.0), ("b", 20.0), ("a", 30.0)]
+        .into_iter()
+        .enumerate()
+    {
+        set(row as u32 + 2, 6, text(name));
+        set(row as u32 + 2, 7, LiteralValue::Number(score));
+    }
+    set(1, 8, text("Name"));
+    set(2, 8, text("a"));
+    set(1, 9, text("Name"));
+    set(2, 9, text("b"));
+
+    for (i, (formula, _)) in FORMULAS.iter().enumerate() {
+        engine
+            .set_cell_formula("Sheet1", i as u32 + 1, 11, parse(formula).expect("parse"))
+            .unwrap();
+    }
+    engine.evaluate_all().unwrap();
+    engine
+}
+
+fn render(value: Option<LiteralValue>) -> String {
+    match value {
+        Some(LiteralValue::Number(n)) => format!("{}", (n * 1e9).round() / 1e9),
+        Some(LiteralValue::Int(n)) => n.to_string(),
+        Some(LiteralValue::Text(s)) => s,
+        Some(LiteralValue::Boolean(b)) => b.to_string().to_uppercase(),
+        other => format!("{other:?}"),
+    }
+}
+
+#[test]
+fn range_builtins_read_cells_without_owned_copies() {
+    let mut engine = build();
+    for (i, (formula, expected)) in FORMULAS.iter().enumerate() {
+        let got = render(engine.get_cell_value("Sheet1", i as u32 + 1, 11));
+        assert_eq!(got, *expected, "{formula}");
+    }
+    let stats = engine.range_materialization_stats();
+    assert_eq!(stats.total_cells, 0, "{stats:?}");
+
+    engine
+        .set_cell_value("Sheet1", 6, 1, LiteralValue::Number(7.0))
+        .unwrap();
+    engine.evaluate_all().unwrap();
+    assert_eq!(render(engine.get_cell_value("Sheet1", 1, 11)), "840");
+    assert_eq!(engine.range_materialization_stats().last_recalc_cells, 0);
+}
@@ -0,0 +1,123 @@
+//! Constant and run-end encoded chunks.
+//!
+//! Repetitive columns are stored as runs at ingest. Reductions fold runs without decoding
+//! them; results must match the per-row model, including after overlay edits.
+
+use super::common::arrow_eval_config;
+use crate::engine::Engine;
+use crate::test_workbook::TestWorkbook;
+use formualizer_common::{ExcelError, LiteralValue};
+use formualizer_parse::parser::parse;
+
+const ROWS: u32 = 256;
+const FORMULAS: [&str; 8] = [
+    "=SUM(Data!A1:A256)",
+    "=COUNT(Data!A1:A256)",
+    "=AVERAGE(Data!B1:B256)",
+    "=MIN(Data!B20:B256)",
+    "=MAX(Data!B1:B256)",
+    "=SUM(Data!C1:C256)",
+    "=COUNTIF(Data!B1:B256,2)",
+    "=SUMIF(Data!B1:B256,\">2\",Data!A1:A256)",
+];
+
+/// Column A is constant, B repeats each value for 50 rows, C is empty but for one cell.
+fn row(i: u32) -> [LiteralValue; 3] {
+    [
+        LiteralValue::Number(2.5),
+        LiteralValue::Number(f64::from(i / 50)),
+        if i == 200 {
+            LiteralValue::Number(9.0)
+        } else {
+            LiteralValue::Empty
+        },
+    ]
+}
+
+fn build() -> Engine<TestWorkbook> {
+    let mut cfg = arrow_eval_config();
+    cfg.enable_parallel = false;
+    let mut engine = Engine::new(TestWorkbook::new(), cfg);
+    {
+        let mut ab = engine.begin_bulk_ingest_arrow();
+        ab.add_sheet("Data", 3, 64);
+        for i in 0..ROWS {
+            ab.append_row("Data", &row(i)).unwrap();
+        }
+        ab.finish().unwrap();
+    }
+    for (i, formula) in FORMULAS.iter().enumerate() {
+        engine
+            .set_cell_formula("Sheet1", i as u32 + 1, 1, parse(formula).expect("parse"))
+            .unwrap();
+    }
+    engine.evaluate_all().unwrap();
+    engine
+}
+
+fn expected(a: &[f64], b: &[f64], c: &[Option<f64>]) -> Vec<f64> {
+    let n = a.len() as f64;
+    vec![
+        a.iter().sum(),
+        n,
+        b.iter().sum::<f64>() / n,
+        b[19..].iter().copied().fold(f64::INFINITY, f64::min),
+        b.iter().copied().fold(f64::NEG_INFINITY, f64::max),
+        c.iter().flatten().sum(),
+        b.iter().filter(|&&v| v == 2.0).count() as f64,
+        a.iter()
+            .zip(b)
+            .filter(|(_, v)| **v > 2.0)
+            .map(|(x, _)| x)
+            .sum(),
+    ]
+}
+
+fn value(engine: &Engine<TestWorkbook>, i: usize) -> f64 {
+    match engine.get_cell_value("Sheet1", i as u32 + 1, 1) {
+        Some(LiteralValue::Number(n)) => n,
+        Some(LiteralValue::Int(n)) => n as f64,
+        other => panic!("{}: {other:?}", FORMULAS[i]),
+    }
+}
+
+#[test]
+fn run_encoded_columns_reduce_like_dense_columns() {
+    let mut engine = build();
+    let sheet = engine.sheet_store().sheet("Data").expect("arrow sheet");
+    for col in &sheet.columns {
+        assert!(col.chunks.iter().all(|ch| ch.runs.is_some()));
+    }
+    assert!(
+        sheet.columns[0]
+            .chunks
+            .iter()
+            .all(|ch| ch.runs.as_ref().unwrap().is_constant())
+    );
+
+    let mut a: Vec<f64> = vec![2.5; ROWS as usize];
+    let b: Vec<f64> = (0..ROWS).map(|i| f64::from(i / 50)).collect();
+    let c: Vec<Option<f64>> = (0..ROWS).map(|i| (i == 200).then_some(9.0)).collect();
+    for (i, want) in expected(&a, &b, &c).into_iter().enumerate() {
+        assert_eq!(value(&engine, i), want, "{}", FORMULAS[i]);
+    }
+
+    // Edited segments fall back to dense lanes with the overlay applied.
+    engine
+        .set_cell_value("Data", 5, 1, LiteralValue::Number(10.0))
+        .unwrap();
+    engine.evaluate_all().unwrap();
+    a[4] = 10.0;
+    for (i, want) in expected(&a, &b, &c).into_iter().enumerate() {
+        assert_eq!(value(&engine, i), want, "{}", FORMULAS[i]);
+    }
+
+    engine
+        .set_cell_value("Data", 3, 3, LiteralValue::Error(ExcelError::new_div()))
+        .unwrap();
+    engine.evaluate_all().unwrap();
+    assert!(matches!(
+        engine.get_cell_value("Sheet1", 6, 1),
+        Some(LiteralValue::Error(_))
+    ));
+}
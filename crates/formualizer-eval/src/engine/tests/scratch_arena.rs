@@ -0,0 +1,81 @@
+//! Per-thread scratch arena and interpreter allocation counters
+//! (`Engine::eval_allocation_stats`).
+//!
+//! Order statistics borrow their buffers from the arena, array operators
+//! rewrite owned operands in place, and only broadcasts that change shape
+//! allocate a fresh array; values must be unaffected.
+
+use crate::engine::{Engine, EvalAllocationStats, EvalConfig};
+use crate::test_workbook::TestWorkbook;
+use formualizer_common::LiteralValue;
+use formualizer_parse::parser::parse;
+
+const FORMULAS: &[(u32, &str, f64)] = &[
+    (1, "=MEDIAN(A1:A5)", 4.0),
+    (2, "=LARGE(A1:A5,2)", 7.0),
+    (3, "=PERCENTILE.INC(A1:A5,0.5)", 4.0),
+    (4, "=SUM({1,2,3}*A1)", 12.0),
+    (5, "=SUM(-{1,2,3}+{1,1,1})", -3.0),
+    (6, "=SUM({1,2}+{10;20})", 66.0),
+];
+
+fn build() -> Engine<TestWorkbook> {
+    // Tree interpreter only, so every operator goes through broadcasting.
+    let config = EvalConfig::default()
+        .with_parallel(false)
+        .with_bytecode_vm(false);
+    let mut engine = Engine::new(TestWorkbook::new(), config);
+    for (row, value) in [2, 7, 1, 9, 4].into_iter().enumerate() {
+        engine
+            .set_cell_value("Sheet1", row as u32 + 1, 1, LiteralValue::Int(value))
+            .unwrap();
+    }
+    for &(row, formula, _) in FORMULAS {
+        engine
+            .set_cell_formula("Sheet1", row, 3, parse(formula).expect("parse"))
+            .unwrap();
+    }
+    engine.evaluate_all().unwrap();
+    engine
+}
+
+#[test]
+fn scratch_backed_builtins_and_in_place_arrays_keep_values() {
+    let mut engine = build();
+    for &(row, formula, expected) in FORMULAS {
+        assert_eq!(
+            engine.get_cell_value("Sheet1", row, 3),
+            Some(LiteralValue::Number(expected)),
+            "{formula}"
+        );
+    }
+
+    let stats = engine.eval_allocation_stats();
+    assert!(stats.vertices >= FORMULAS.len() as u64, "{stats:?}");
+    // MEDIAN, LARGE and PERCENTILE.INC each gather into the arena.
+    assert!(stats.arena_scopes >= 3, "{stats:?}");
+    assert!(stats.arena_peak_bytes > 0, "{stats:?}");
+    // `{1,2,3}*A1`, unary minus, and `+{1,1,1}` reuse their operand; only the
+    // 1x2 + 2x1 broadcast needs a new (2x2) array.
+    assert!(stats.reused_arrays >= 3, "{stats:?}");
+    assert!(stats.heap_arrays >= 1, "{stats:?}");
+    assert_eq!(stats.heap_array_cells, 4 * stats.heap_arrays, "{stats:?}");
+
+    engine
+        .set_cell_value("Sheet1", 1, 1, LiteralValue::Int(20))
+        .unwrap();
+    engine.evaluate_all().unwrap();
+    assert_eq!(
+        engine.get_cell_value("Sheet1", 1, 3),
+        Some(LiteralValue::Number(7.0))
+    );
+    assert_eq!(
+        engine.get_cell_value("Sheet1", 4, 3),
+        Some(LiteralValue::Number(120.0))
+    );
+    assert!(engine.eval_allocation_stats().vertices > stats.vertices);
+    assert_ne!(
+        engine.eval_allocation_stats(),
+        EvalAllocationStats::default()
+    );
+}
@@ -0,0 +1,102 @@
+//! Workbook-wide common subexpression elimination
+//! (`EvalConfig::enable_shared_subexpressions`).
+//!
+//! Shared subtrees must produce exactly the values of an engine without the
+//! cache, before and after edits, while reporting the evaluations they saved.
+
+use crate::engine::{Engine, EvalConfig};
+use crate::test_workbook::TestWorkbook;
+use formualizer_common::LiteralValue;
+use formualizer_parse::parser::parse;
+
+fn build(enabled: bool) -> Engine<TestWorkbook> {
+    // Sequential, so concurrent first readers cannot both miss.
+    let config = EvalConfig::default()
+        .with_parallel(false)
+        .with_shared_subexpressions(enabled);
+    let mut engine = Engine::new(TestWorkbook::new(), config);
+    engine.add_sheet("Sheet2").unwrap();
+    for r in 1..=10 {
+        for (sheet, v) in [("Sheet1", r), ("Sheet2", r * 10)] {
+            engine
+                .set_cell_value(sheet, r, 1, LiteralValue::Int(v as i64))
+                .unwrap();
+        }
+    }
+    let mut formulas = Vec::new();
+    for r in 1..=5 {
+        formulas.push(("Sheet1", r, 3, format!("=SUM($A$1:$A$10)+A{r}")));
+        // ROW() reads the evaluating cell, so this call is never shared.
+        formulas.push(("Sheet1", r, 5, "=SUM(A1:A10,ROW())".to_string()));
+    }
+    formulas.push((
+        "Sheet1",
+        1,
+        4,
+        "=IF(SUM($A$1:$A$10)>50,SUM($A$1:$A$10),0)".to_string(),
+    ));
+    // Unqualified references resolve per sheet.
+    for sheet in ["Sheet1", "Sheet2"] {
+        for r in 1..=2 {
+            formulas.push((sheet, r, 6, "=SUM(A1:A3)*2".to_string()));
+        }
+    }
+    for (sheet, row, col, f) in formulas {
+        engine
+            .set_cell_formula(sheet, row, col, parse(&f).expect("parse"))
+            .unwrap();
+    }
+    engine.evaluate_all().unwrap();
+    engine
+}
+
+fn assert_same(shared: &Engine<TestWorkbook>, plain: &Engine<TestWorkbook>) {
+    for sheet in ["Sheet1", "Sheet2"] {
+        for r in 1..=5 {
+            for c in 3..=6 {
+                assert_eq!(
+                    shared.get_cell_value(sheet, r, c),
+                    plain.get_cell_value(sheet, r, c),
+                    "{sheet}!R{r}C{c}"
+                );
+            }
+        }
+    }
+}
+
+#[test]
+fn shared_subexpressions_match_plain_evaluation() {
+    let mut shared = build(true);
+    let mut plain = build(false);
+    assert_same(&shared, &plain);
+    assert_eq!(
+        shared.get_cell_value("Sheet1", 2, 3),
+        Some(LiteralValue::Number(57.0))
+    );
+    assert_eq!(
+        shared.get_cell_value("Sheet1", 3, 5),
+        Some(LiteralValue::Number(58.0))
+    );
+    assert_eq!(
+        shared.get_cell_value("Sheet2", 1, 6),
+        Some(LiteralValue::Number(120.0))
+    );
+
+    let stats = shared.shared_subexpression_stats();
+    assert!(stats.shared_nodes >= 2, "{stats:?}");
+    assert!(stats.reuses >= 5, "{stats:?}");
+    assert_eq!(plain.shared_subexpression_stats().reuses, 0);
+
+    // Edits invalidate cached values before the next pass.
+    for engine in [&mut shared, &mut plain] {
+        engine
+            .set_cell_value("Sheet1", 2, 1, LiteralValue::Int(100))
+            .unwrap();
+        engine.evaluate_all().unwrap();
+    }
+    assert_same(&shared, &plain);
+    assert_eq!(
+        shared.get_cell_value("Sheet1", 1, 4),
+        Some(LiteralValue::Number(153.0))
+    );
+}
@@ -0,0 +1,125 @@
+//! Speculative scheduling of dynamic-reference formulas
+//! (`EvalConfig::speculative_dynamic_refs`).
+//!
+//! A dynamic vertex is scheduled against the formula vertices it read on its
+//! previous evaluation. After the pass its reads are validated against the
+//! schedule order; only misspeculated vertices (and their dependents) re-run.
+
+use crate::engine::{Engine, EvalConfig};
+use crate::test_workbook::TestWorkbook;
+use formualizer_common::LiteralValue;
+use formualizer_parse::parser::parse;
+
+fn speculative_engine() -> Engine<TestWorkbook> {
+    Engine::new(
+        TestWorkbook::new(),
+        EvalConfig::default()
+            .with_speculative_dynamic_refs(true)
+            .with_virtual_dep_telemetry(true),
+    )
+}
+
+fn set_formula(engine: &mut Engine<TestWorkbook>, row: u32, col: u32, f: &str) {
+    engine
+        .set_cell_formula("Sheet1", row, col, parse(f).expect("parse"))
+        .expect("set formula");
+}
+
+#[test]
+fn stable_target_is_scheduled_from_the_recorded_reads() {
+    let mut engine = speculative_engine();
+    engine
+        .set_cell_value("Sheet1", 1, 1, LiteralValue::Int(2))
+        .unwrap();
+    set_formula(&mut engine, 1, 2, "=A1*10");
+    set_formula(&mut engine, 1, 3, "=INDIRECT(\"B1\")+1");
+    engine.evaluate_all().unwrap();
+    assert_eq!(
+        engine.get_cell_value("Sheet1", 1, 3),
+        Some(LiteralValue::Number(21.0))
+    );
+    let first = engine.speculation_stats();
+    assert_eq!(
+        first.speculated, 0,
+        "no recorded reads before the first pass"
+    );
+
+    engine
+        .set_cell_value("Sheet1", 1, 1, LiteralValue::Int(3))
+        .unwrap();
+    engine.evaluate_all().unwrap();
+    assert_eq!(
+        engine.get_cell_value("Sheet1", 1, 3),
+        Some(LiteralValue::Number(31.0))
+    );
+
+    let stats = engine.speculation_stats();
+    assert!(stats.speculated > first.speculated);
+    assert_eq!(stats.misses, 0);
+    assert_eq!(stats.hit_rate(), Some(1.0));
+    assert!(engine.last_virtual_dep_telemetry().speculation.hits > 0);
+}
+
+#[test]
+fn retargeted_read_is_misspeculated_and_re_executed() {
+    let mut engine = speculative_engine();
+    engine
+        .set_cell_value("Sheet1", 1, 1, LiteralValue::Int(1))
+        .unwrap();
+    engine
+        .set_cell_value("Sheet1", 1, 4, LiteralValue::Text("B1".to_string()))
+        .unwrap();
+    set_formula(&mut engine, 1, 2, "=A1*2");
+    // B2 sits one layer deeper than B1, level with the speculated C1.
+    set_formula(&mut engine, 3, 2, "=A1*3");
+    set_formula(&mut engine, 2, 2, "=B3+1");
+    set_formula(&mut engine, 1, 3, "=INDIRECT(D1)");
+    engine.evaluate_all().unwrap();
+    assert_eq!(
+        engine.get_cell_value("Sheet1", 1, 3),
+        Some(LiteralValue::Number(2.0))
+    );
+
+    engine
+        .set_cell_value("Sheet1", 1, 4, LiteralValue::Text("B2".to_string()))
+        .unwrap();
+    engine
+        .set_cell_value("Sheet1", 1, 1, LiteralValue::Int(5))
+        .unwrap();
+    engine.evaluate_all().unwrap();
+    assert_eq!(
+        engine.get_cell_value("Sheet1", 1, 3),
+        Some(LiteralValue::Number(16.0))
+    );
+    let stats = engine.speculation_stats();
+    assert!(stats.misses >= 1);
+    assert!(stats.hit_rate().is_some_and(|rate| rate < 1.0));
+
+    // The corrected reads are recorded, so the next pass speculates correctly.
+    let before = engine.speculation_stats();
+    engine
+        .set_cell_value("Sheet1", 1, 1, LiteralValue::Int(6))
+        .unwrap();
+    engine.evaluate_all().unwrap();
+    assert_eq!(
+        engine.get_cell_value("Sheet1", 1, 3),
+        Some(LiteralValue::Number(19.0))
+    );
+    assert_eq!(engine.speculation_stats().misses, before.misses);
+}
+
+#[test]
+fn conservative_mode_reports_no_speculation() {
+    let mut engine = Engine::new(TestWorkbook::new(), EvalConfig::default());
+    engine
+        .set_cell_value("Sheet1", 1, 1, LiteralValue::Int(4))
+        .unwrap();
+    set_formula(&mut engine, 1, 2, "=INDIRECT(\"A1\")");
+    engine.evaluate_all().unwrap();
+    engine.evaluate_all().unwrap();
+    assert_eq!(
+        engine.get_cell_value("Sheet1", 1, 2),
+        Some(LiteralValue::Number(4.0))
+    );
+    assert_eq!(engine.speculation_stats(), Default::default());
+}
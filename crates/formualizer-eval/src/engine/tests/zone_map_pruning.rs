@@ -0,0 +1,163 @@
+//! Per-chunk zone maps.
+//!
+//! Criteria aggregates, D-functions and lookups skip chunks whose statistics rule out a
+//! match, and approximate lookups over sorted numbers search only the target chunk.
+//! Results must match a direct evaluation, including after overlay edits widen a chunk.
+
+use super::common::arrow_eval_config;
+use crate::engine::Engine;
+use crate::test_workbook::TestWorkbook;
+use formualizer_common::{ExcelErrorKind, LiteralValue};
+use formualizer_parse::parser::parse;
+
+const ROWS: u32 = 300;
+const FORMULAS: [&str; 11] = [
+    "=SUMIFS(Data!B2:B301,Data!A2:A301,\">=120\",Data!A2:A301,\"<125\")",
+    "=COUNTIF(Data!A2:A301,\">130\")",
+    "=MAXIFS(Data!B2:B301,Data!A2:A301,\"<110\")",
+    "=MINIFS(Data!B2:B301,Data!C2:C301,\"grp3\")",
+    "=SUMIFS(Data!B2:B301,Data!C2:C301,\"GRP2\")",
+    "=DSUM(Data!A1:C301,\"Amount\",E1:E3)",
+    "=MATCH(131,Data!A2:A301,0)",
+    "=XLOOKUP(\"grp4\",Data!C2:C301,Data!B2:B301)",
+    "=MATCH(125,Days!A1:A300,1)",
+    "=VLOOKUP(125.5,Days!A1:B300,2,TRUE)",
+    "=MATCH(99,Days!A1:A300,1)",
+];
+
+/// Day serial of data row `i`; eight rows per day, so 64-row chunks span eight days.
+fn day(i: u32) -> f64 {
+    f64::from(100 + i / 8)
+}
+
+struct Row {
+    day: f64,
+    amount: f64,
+    group: String,
+}
+
+fn build() -> Engine<TestWorkbook> {
+    let mut cfg = arrow_eval_config();
+    cfg.enable_parallel = false;
+    let mut engine = Engine::new(TestWorkbook::new(), cfg);
+    {
+        let mut ab = engine.begin_bulk_ingest_arrow();
+        ab.add_sheet("Data", 3, 64);
+        ab.add_sheet("Days", 2, 64);
+        ab.append_row(
+            "Data",
+            &["Day", "Amount", "Group"].map(|h| LiteralValue::Text(h.into())),
+        )
+        .unwrap();
+        for i in 0..ROWS {
+            ab.append_row(
+                "Data",
+                &[
+                    LiteralValue::Number(day(i)),
+                    LiteralValue::Number(f64::from(i)),
+                    LiteralValue::Text(format!("grp{}", i / 64)),
+                ],
+            )
+            .unwrap();
+            ab.append_row(
+                "Days",
+                &[
+                    LiteralValue::Number(day(i)),
+                    LiteralValue::Number(f64::from(i)),
+                ],
+            )
+            .unwrap();
+        }
+        ab.finish().unwrap();
+    }
+    // DSUM criteria: Day >= 140 OR Day < 102.
+    for (row, text) in [(1, "Day"), (2, ">=140"), (3, "<102")] {
+        engine
+            .set_cell_value("Sheet1", row, 5, LiteralValue::Text(text.into()))
+            .unwrap();
+    }
+    for (i, formula) in FORMULAS.iter().enumerate() {
+        engine
+            .set_cell_formula("Sheet1", i as u32 + 1, 1, parse(formula).expect("parse"))
+            .unwrap();
+    }
+    engine.evaluate_all().unwrap();
+    engine
+}
+
+/// The same formulas evaluated directly over the Data rows (Days is never edited).
+fn expected(model: &[Row]) -> Vec<f64> {
+    let amounts = |f: fn(&Row) -> bool| model.iter().filter(move |r| f(r)).map(|r| r.amount);
+    let first = |f: fn(&Row) -> bool| model.iter().position(f).unwrap();
+    vec![
+        amounts(|r| r.day >= 120.0 && r.day < 125.0).sum::<f64>(),
+        amounts(|r| r.day > 130.0).count() as f64,
+        amounts(|r| r.day < 110.0).fold(f64::NEG_INFINITY, f64::max),
+        amounts(|r| r.group == "grp3").fold(f64::INFINITY, f64::min),
+        amounts(|r| r.group == "grp2").sum::<f64>(),
+        amounts(|r| r.day >= 140.0 || r.day < 102.0).sum::<f64>(),
+        (first(|r| r.day == 131.0) + 1) as f64,
+        model[first(|r| r.group == "grp4")].amount,
+        // Days 125 cover rows 200..208; 125.5 lands on the last of them.
+        208.0,
+        207.0,
+        0.0,
+    ]
+}
+
+fn assert_matches_model(engine: &Engine<TestWorkbook>, model: &[Row]) {
+    let want = expected(model);
+    for (i, formula) in FORMULAS.iter().enumerate() {
+        let got = match engine.get_cell_value("Sheet1", i as u32 + 1, 1) {
+            Some(LiteralValue::Number(n)) => n,
+            Some(LiteralValue::Int(n)) => n as f64,
+            // MATCH below the first key.
+            Some(LiteralValue::Error(e)) if want[i] == 0.0 => {
+                assert_eq!(e.kind, ExcelErrorKind::Na, "{formula}");
+                continue;
+            }
+            other => panic!("{formula}: {other:?}"),
+        };
+        assert_eq!(got, want[i], "{formula}");
+    }
+}
+
+#[test]
+fn zone_map_pruning_matches_direct_evaluation() {
+    let mut engine = build();
+    let days = engine.sheet_store().sheet("Days").expect("arrow sheet");
+    assert!(days.columns[0].chunks.len() > 1);
+    assert!(
+        days.columns[0]
+            .chunks
+            .iter()
+            .all(|ch| ch.zone_map().numbers_ascending)
+    );
+
+    let mut model: Vec<Row> = (0..ROWS)
+        .map(|i| Row {
+            day: day(i),
+            amount: f64::from(i),
+            group: format!("grp{}", i / 64),
+        })
+        .collect();
+    assert_matches_model(&engine, &model);
+
+    // Edits in the first chunk now match criteria its ingest statistics ruled out; the
+    // overlay widens the chunk's zone map so it is scanned again.
+    let edits = [
+        (2, 1, LiteralValue::Number(122.0)),
+        (3, 3, LiteralValue::Text("GRP4".into())),
+        (4, 1, LiteralValue::Number(131.0)),
+        (5, 3, LiteralValue::Text("grp3".into())),
+    ];
+    for (row, col, value) in edits {
+        engine.set_cell_value("Data", row, col, value).unwrap();
+    }
+    engine.evaluate_all().unwrap();
+    model[0].day = 122.0;
+    model[1].group = "grp4".into();
+    model[2].day = 131.0;
+    model[3].group = "grp3".into();
+    assert_matches_model(&engine, &model);
+}
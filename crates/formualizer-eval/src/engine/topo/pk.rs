@@ -1,5 +1,6 @@
 use rustc_hash::{FxHashMap, FxHashSet};
-use std::cmp::Ordering;
+use std::cmp::Reverse;
+use std::collections::BinaryHeap;
 
 /// GraphView abstracts the conceptual DAG over which we maintain order.
 /// Implementations should provide successors (dependents) and predecessors (dependencies)
@@ -20,6 +21,23 @@ pub struct Cycle<N> {
 pub struct PkStats {
     pub relabeled: usize,
     pub dfs_visited: usize,
+    /// The insertion exceeded `visit_budget`; ordering maintenance was suspended
+    /// and the order will be rebuilt once by [`DynamicTopo::refresh`]. No cycle
+    /// check was performed for this edge.
+    pub fallback: bool,
+}
+
+/// Cumulative maintenance counters, observational only.
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct PkTelemetry {
+    pub edge_inserts: u64,
+    pub reorders: u64,
+    pub relabeled_nodes: u64,
+    pub edge_removals: u64,
+    pub node_removals: u64,
+    pub budget_fallbacks: u64,
+    pub full_rebuilds: u64,
+    pub compactions: u64,
 }
 
 #[derive(Debug, Clone, Copy)]
@@ -38,12 +56,23 @@ impl Default for PkConfig {
 }
 
 /// DynamicTopo maintains a deterministic total order (pos) consistent with the conceptual DAG.
+///
+/// Removed nodes leave tombstone slots in `order` (a slot `i` is live iff
+/// `pos[order[i]] == i`); tombstones are dropped by [`Self::compact_ranks`].
 #[derive(Debug)]
 pub struct DynamicTopo<N: Copy + Eq + std::hash::Hash + Ord> {
     pos: FxHashMap<N, u32>,
     order: Vec<N>,
+    tombstones: usize,
+    /// Set when an insertion overran `visit_budget`; the order may be inconsistent
+    /// until the next [`Self::refresh`].
+    stale: bool,
+    /// The last rebuild found a cycle, so some edge necessarily points backwards.
+    /// Edge removals may break that cycle and re-arm a rebuild.
+    cyclic_residue: bool,
     op_count: u64,
     cfg: PkConfig,
+    telemetry: PkTelemetry,
     // scratch
     succ_buf: Vec<N>,
     pred_buf: Vec<N>,
@@ -56,6 +85,7 @@ where
     pub fn new(nodes: impl IntoIterator<Item = N>, cfg: PkConfig) -> Self {
         let mut order: Vec<N> = nodes.into_iter().collect();
         order.sort(); // stable deterministic seed order
+        order.dedup();
         let mut pos = FxHashMap::default();
         for (i, n) in order.iter().enumerate() {
             pos.insert(*n, i as u32);
@@ -63,21 +93,33 @@ where
         Self {
             pos,
             order,
+            tombstones: 0,
+            stale: false,
+            cyclic_residue: false,
             op_count: 0,
             cfg,
+            telemetry: PkTelemetry::default(),
             succ_buf: Vec::new(),
             pred_buf: Vec::new(),
         }
     }
 
+    #[inline]
+    fn is_live_slot(&self, slot: usize, n: N) -> bool {
+        self.pos.get(&n).is_some_and(|&p| p as usize == slot)
+    }
+
     /// Full rebuild via Kahn-style topological sort. Breaks ties by node Ord.
+    ///
+    /// Nodes left over by a cycle in the source graph are appended in Ord order so
+    /// every live node keeps a position.
     pub fn rebuild_full<G: GraphView<N>>(&mut self, graph: &G) {
-        // Collect existing nodes; drop non-existent
         let mut nodes: Vec<N> = self
             .order
             .iter()
-            .copied()
-            .filter(|n| graph.exists(*n))
+            .enumerate()
+            .filter(|&(slot, &n)| self.is_live_slot(slot, n) && graph.exists(n))
+            .map(|(_, &n)| n)
             .collect();
         nodes.sort();
         let set: FxHashSet<N> = nodes.iter().copied().collect();
@@ -88,44 +130,75 @@ where
             self.pred_buf.clear();
             graph.predecessors(n, &mut self.pred_buf);
             for &p in &self.pred_buf {
-                if set.contains(&p) {
+                if p != n && set.contains(&p) {
                     *indeg.get_mut(&n).unwrap() += 1;
                 }
             }
         }
 
-        let mut zero: Vec<N> = indeg
+        let mut zero: BinaryHeap<Reverse<N>> = indeg
             .iter()
-            .filter_map(|(&n, &d)| if d == 0 { Some(n) } else { None })
+            .filter_map(|(&n, &d)| if d == 0 { Some(Reverse(n)) } else { None })
             .collect();
-        // Sort descending so that pop() returns the smallest first
-        zero.sort_by(|a, b| b.cmp(a));
 
         let mut out: Vec<N> = Vec::with_capacity(nodes.len());
-        while let Some(n) = zero.pop() {
+        while let Some(Reverse(n)) = zero.pop() {
             out.push(n);
             self.succ_buf.clear();
             graph.successors(n, &mut self.succ_buf);
             // limited to subset
             for &s in &self.succ_buf {
+                if s == n {
+                    continue;
+                }
                 if let Some(d) = indeg.get_mut(&s) {
                     *d -= 1;
                     if *d == 0 {
-                        zero.push(s);
+                        zero.push(Reverse(s));
                     }
                 }
             }
-            zero.sort_by(|a, b| b.cmp(a)); // maintain pop as smallest
         }
-        // If out length < nodes, there is a cycle in source graph; keep relative sorted order
-        if out.len() != nodes.len() {
-            out = nodes; // fallback deterministic
+        self.cyclic_residue = out.len() != nodes.len();
+        if self.cyclic_residue {
+            // Cycle in source graph: keep the acyclic prefix, then the rest by Ord.
+            let placed: FxHashSet<N> = out.iter().copied().collect();
+            out.extend(nodes.iter().copied().filter(|n| !placed.contains(n)));
         }
         self.order = out;
         self.pos.clear();
         for (i, n) in self.order.iter().enumerate() {
             self.pos.insert(*n, i as u32);
         }
+        self.tombstones = 0;
+        self.stale = false;
+        self.telemetry.full_rebuilds += 1;
+    }
+
+    /// Rebuild the order if an earlier insertion fell back past `visit_budget`.
+    /// Returns true when a rebuild ran.
+    pub fn refresh<G: GraphView<N>>(&mut self, graph: &G) -> bool {
+        if !self.stale {
+            return false;
+        }
+        self.rebuild_full(graph);
+        true
+    }
+
+    #[inline]
+    pub fn is_stale(&self) -> bool {
+        self.stale
+    }
+
+    /// Suspend maintenance until the next [`Self::refresh`]. Used when an edge was
+    /// accepted despite closing a cycle, so the order cannot reflect it.
+    pub fn invalidate(&mut self) {
+        self.stale = true;
+    }
+
+    #[inline]
+    pub fn telemetry(&self) -> PkTelemetry {
+        self.telemetry
     }
 
     pub fn try_add_edge<G: GraphView<N>>(
@@ -137,6 +210,7 @@ where
         if x == y {
             return Err(Cycle { path: vec![x, y] });
         }
+        self.telemetry.edge_inserts += 1;
         let px = match self.pos.get(&x).copied() {
             Some(v) => v,
             None => self.add_missing(x),
@@ -145,6 +219,12 @@ where
             Some(v) => v,
             None => self.add_missing(y),
         };
+        if self.stale {
+            return Ok(PkStats {
+                fallback: true,
+                ..PkStats::default()
+            });
+        }
         if px < py {
             return Ok(PkStats::default());
         }
@@ -154,6 +234,7 @@ where
         let mut parent: FxHashMap<N, N> = FxHashMap::default();
         let mut visited: FxHashSet<N> = FxHashSet::default();
         let mut affected: Vec<N> = Vec::new();
+        let mut low = py;
         let mut visited_cnt = 0usize;
 
         while let Some(u) = stack.pop() {
@@ -162,10 +243,7 @@ where
             }
             visited_cnt += 1;
             if visited_cnt > self.cfg.visit_budget {
-                self.rebuild_full(graph);
-                self.op_count += 1;
-                // After rebuild, re-check quickly, recurse once
-                return self.try_add_edge(graph, x, y);
+                return Ok(self.suspend(visited_cnt));
             }
             if u == x {
                 // build path from y -> ... -> x
@@ -179,6 +257,9 @@ where
                 return Err(Cycle { path });
             }
             affected.push(u);
+            if let Some(&pu) = self.pos.get(&u) {
+                low = low.min(pu);
+            }
             self.succ_buf.clear();
             graph.successors(u, &mut self.succ_buf);
             for &s in &self.succ_buf {
@@ -192,29 +273,79 @@ where
             }
         }
 
-        // splice affected block to just after px in global order, maintaining relative order
-        let relabeled = self.splice_after(px as usize, &affected);
-
-        self.op_count += 1;
-        if self
-            .op_count
-            .is_multiple_of(self.cfg.compaction_interval_ops)
-        {
-            self.compact_ranks();
+        // Relabeling touches only the window [low, px]; treat an oversized window
+        // like an exhausted DFS budget rather than paying O(V) per insertion.
+        if (px - low) as usize > self.cfg.visit_budget {
+            return Ok(self.suspend(visited_cnt));
         }
+        let relabeled = self.reorder_window(low as usize, px as usize, &visited);
+        self.telemetry.reorders += 1;
+        self.telemetry.relabeled_nodes += relabeled as u64;
+
+        self.bump_op();
         Ok(PkStats {
             relabeled,
             dfs_visited: visited_cnt,
+            fallback: false,
         })
     }
 
-    pub fn remove_edge(&mut self, _x: N, _y: N) {
-        // PK does not require reorder on deletion.
-        self.op_count += 1;
-        if self
-            .op_count
-            .is_multiple_of(self.cfg.compaction_interval_ops)
-        {
+    fn suspend(&mut self, dfs_visited: usize) -> PkStats {
+        self.stale = true;
+        self.telemetry.budget_fallbacks += 1;
+        self.bump_op();
+        PkStats {
+            relabeled: 0,
+            dfs_visited,
+            fallback: true,
+        }
+    }
+
+    /// Unbounded reachability check used when an insertion fell back and the caller
+    /// still needs an exact answer (e.g. cycle-rejecting edge insertion).
+    pub fn creates_cycle<G: GraphView<N>>(&self, graph: &G, x: N, y: N) -> bool {
+        if x == y {
+            return true;
+        }
+        let mut stack = vec![y];
+        let mut visited: FxHashSet<N> = FxHashSet::default();
+        let mut succ = Vec::new();
+        while let Some(u) = stack.pop() {
+            if u == x {
+                return true;
+            }
+            if !visited.insert(u) {
+                continue;
+            }
+            succ.clear();
+            graph.successors(u, &mut succ);
+            stack.extend(succ.iter().copied().filter(|s| !visited.contains(s)));
+        }
+        false
+    }
+
+    /// Deleting an edge never invalidates a topological order, so no nodes move.
+    /// If the last rebuild left a cycle behind, the removal may have broken it, so
+    /// the order is re-armed for a rebuild at the next [`Self::refresh`].
+    pub fn remove_edge(&mut self, x: N, y: N) {
+        if x != y && self.pos.contains_key(&x) && self.pos.contains_key(&y) {
+            self.telemetry.edge_removals += 1;
+        }
+        if self.cyclic_residue {
+            self.stale = true;
+        }
+        self.bump_op();
+    }
+
+    /// Drop a node (vertex deletion). Its slot becomes a tombstone that is reclaimed
+    /// by compaction once tombstones outnumber live nodes.
+    pub fn remove_node(&mut self, n: N) {
+        if self.pos.remove(&n).is_none() {
+            return;
+        }
+        self.tombstones += 1;
+        self.telemetry.node_removals += 1;
+        if self.tombstones > self.pos.len() {
             self.compact_ranks();
         }
     }
@@ -226,43 +357,132 @@ where
         adds: &[(N, N)],
     ) -> Result<PkStats, Cycle<N>> {
         for &(x, y) in removes {
-            let _ = (x, y);
             self.remove_edge(x, y);
         }
         let mut stats = PkStats::default();
         for &(x, y) in adds {
-            match self.try_add_edge(graph, x, y) {
-                Ok(s) => {
-                    stats.relabeled += s.relabeled;
-                    stats.dfs_visited += s.dfs_visited;
-                }
-                Err(c) => {
-                    return Err(c);
-                }
-            }
+            let s = self.try_add_edge(graph, x, y)?;
+            stats.relabeled += s.relabeled;
+            stats.dfs_visited += s.dfs_visited;
+            stats.fallback |= s.fallback;
         }
         Ok(stats)
     }
 
+    /// The maintained order. May contain tombstoned (removed) nodes until the next
+    /// [`Self::compact_ranks`].
     #[inline]
     pub fn topo_order(&self) -> &[N] {
         &self.order
     }
 
+    #[inline]
+    pub fn position(&self, n: N) -> Option<u32> {
+        self.pos.get(&n).copied()
+    }
+
+    /// Drop tombstones and renumber positions densely, preserving relative order.
     pub fn compact_ranks(&mut self) {
-        // Re-impose deterministic order: stable sort by (current pos, then N)
-        self.order
-            .sort_by(|a, b| match self.pos[a].cmp(&self.pos[b]) {
-                Ordering::Equal => a.cmp(b),
-                o => o,
-            });
+        let order = std::mem::take(&mut self.order);
+        self.order = order
+            .iter()
+            .enumerate()
+            .filter(|&(slot, &n)| self.is_live_slot(slot, n))
+            .map(|(_, &n)| n)
+            .collect();
         self.pos.clear();
         for (i, n) in self.order.iter().enumerate() {
             self.pos.insert(*n, i as u32);
         }
+        self.tombstones = 0;
+        self.telemetry.compactions += 1;
+    }
+
+    /// Layers for `subset` read directly off the maintained order.
+    ///
+    /// Walks the subset in position order and assigns each node one level past its
+    /// deepest in-subset predecessor, so no in-degree bookkeeping or SCC pass is
+    /// needed. Nodes the order has never seen (no edges yet) are accepted only when
+    /// they have no edge into or out of the subset. Returns `None` when the order
+    /// cannot vouch for the subset: the order is stale, an unseen node is connected,
+    /// or some in-subset edge points backwards (which includes every cycle and
+    /// self-loop).
+    pub fn ordered_layers_for<G: GraphView<N>>(
+        &self,
+        graph: &G,
+        subset: &[N],
+        max_layer_width: Option<usize>,
+    ) -> Option<Vec<Vec<N>>> {
+        if self.stale {
+            return None;
+        }
+        let mut ranked: Vec<(u32, N)> = Vec::with_capacity(subset.len());
+        let mut unseen: Vec<N> = Vec::new();
+        for &n in subset {
+            match self.pos.get(&n) {
+                Some(&p) => ranked.push((p, n)),
+                None => unseen.push(n),
+            }
+        }
+        ranked.sort_unstable();
+        ranked.dedup();
+        unseen.sort_unstable();
+        unseen.dedup();
+
+        let mut level: FxHashMap<N, usize> = FxHashMap::default();
+        level.reserve(ranked.len());
+        for &(_, n) in &ranked {
+            level.insert(n, 0);
+        }
+        let mut layers: Vec<Vec<N>> = Vec::new();
+        let mut pred_buf = Vec::new();
+        for &(pn, n) in &ranked {
+            pred_buf.clear();
+            graph.predecessors(n, &mut pred_buf);
+            let mut depth = 0usize;
+            for p in &pred_buf {
+                if let Some(&lp) = level.get(p) {
+                    if self.pos.get(p).is_none_or(|&pp| pp >= pn) {
+                        return None;
+                    }
+                    depth = depth.max(lp + 1);
+                }
+            }
+            level.insert(n, depth);
+            if layers.len() <= depth {
+                layers.resize_with(depth + 1, Vec::new);
+            }
+            layers[depth].push(n);
+        }
+        if !unseen.is_empty() {
+            let unseen_set: FxHashSet<N> = unseen.iter().copied().collect();
+            let touches_subset = |buf: &[N]| {
+                buf.iter()
+                    .any(|m| level.contains_key(m) || unseen_set.contains(m))
+            };
+            let mut succ_buf = Vec::new();
+            for &n in &unseen {
+                pred_buf.clear();
+                graph.predecessors(n, &mut pred_buf);
+                succ_buf.clear();
+                graph.successors(n, &mut succ_buf);
+                if touches_subset(&pred_buf) || touches_subset(&succ_buf) {
+                    return None;
+                }
+            }
+            if layers.is_empty() {
+                layers.push(Vec::new());
+            }
+            layers[0].extend(unseen);
+        }
+        Some(split_layers(layers, max_layer_width))
     }
 
     /// Build parallel-ready layers for a subset, using maintained order for tie-breaks.
+    ///
+    /// Uses [`Self::ordered_layers_for`] when the order is consistent for the subset
+    /// and falls back to Kahn's algorithm otherwise. Nodes on a cycle are omitted
+    /// (cycles should be caught earlier).
     pub fn layers_for<G: GraphView<N>>(
         &self,
         graph: &G,
@@ -272,40 +492,29 @@ where
         if subset.is_empty() {
             return Vec::new();
         }
-        let subset_set: FxHashSet<N> = subset.iter().copied().collect();
+        if let Some(layers) = self.ordered_layers_for(graph, subset, max_layer_width) {
+            return layers;
+        }
+        let rank = |n: &N| (self.pos.get(n).copied().unwrap_or(u32::MAX), *n);
         let mut indeg: FxHashMap<N, usize> = subset.iter().map(|&n| (n, 0usize)).collect();
         let mut pred_buf = Vec::new();
-        for &n in subset {
+        for &n in indeg.keys().copied().collect::<Vec<_>>().iter() {
             pred_buf.clear();
-            // SAFETY: We don't have &mut self graph; create a temp adapter using trait buffers
-            // but GraphView requires &self; we only need predecessors, pass scratch buffer.
-            // Here we can't call self.graph.predecessors directly because we don't have &mut; it's &self fine.
-            // But GraphView signature already takes &self and &mut Vec.
             graph.predecessors(n, &mut pred_buf);
-            for &p in &pred_buf {
-                if subset_set.contains(&p) {
-                    *indeg.get_mut(&n).unwrap() += 1;
-                }
-            }
+            let count = pred_buf.iter().filter(|p| indeg.contains_key(p)).count();
+            *indeg.get_mut(&n).unwrap() = count;
         }
         let mut zero: Vec<N> = indeg
             .iter()
             .filter_map(|(&n, &d)| if d == 0 { Some(n) } else { None })
             .collect();
         // Deterministic: by current position, then N
-        zero.sort_by(|a, b| self.pos[a].cmp(&self.pos[b]).then_with(|| a.cmp(b)));
+        zero.sort_by_key(rank);
 
         let mut layers: Vec<Vec<N>> = Vec::new();
         let mut succ_buf = Vec::new();
         while !zero.is_empty() {
-            let mut layer = Vec::new();
-            let cap = max_layer_width.unwrap_or(usize::MAX);
-            for _ in 0..zero.len().min(cap) {
-                layer.push(zero.remove(0));
-            }
-            // within layer, sort deterministically
-            layer.sort_by(|a, b| self.pos[a].cmp(&self.pos[b]).then_with(|| a.cmp(b)));
-
+            let layer = std::mem::take(&mut zero);
             for &u in &layer {
                 succ_buf.clear();
                 graph.successors(u, &mut succ_buf);
@@ -318,11 +527,10 @@ where
                     }
                 }
             }
-            zero.sort_by(|a, b| self.pos[a].cmp(&self.pos[b]).then_with(|| a.cmp(b)));
+            zero.sort_by_key(rank);
             layers.push(layer);
         }
-        // Any remaining indeg>0 would be a logic bug (cycles should be caught earlier).
-        layers
+        split_layers(layers, max_layer_width)
     }
 
     #[inline]
@@ -342,42 +550,62 @@ where
         }
     }
 
-    /// Move all nodes in `affected` to just after index `after_pos`, preserving their internal order.
-    /// Returns number of nodes relabeled.
-    fn splice_after(&mut self, after_pos: usize, affected: &[N]) -> usize {
-        if affected.is_empty() {
-            return 0;
+    fn bump_op(&mut self) {
+        self.op_count += 1;
+        if self
+            .op_count
+            .is_multiple_of(self.cfg.compaction_interval_ops.max(1))
+            && self.tombstones > 0
+        {
+            self.compact_ranks();
         }
-        let mark: FxHashSet<N> = affected.iter().copied().collect();
-        // Extract unaffected and affected in original order
-        let mut left: Vec<N> = Vec::with_capacity(self.order.len() - affected.len());
-        let mut block: Vec<N> = Vec::with_capacity(affected.len());
-        for &n in &self.order {
-            if mark.contains(&n) {
-                block.push(n);
+    }
+
+    /// Rewrite slots `lo..=hi` so the `affected` nodes follow every other slot of the
+    /// window, preserving relative order on both sides. Only positions inside the
+    /// window change. Returns the number of affected nodes moved.
+    fn reorder_window(&mut self, lo: usize, hi: usize, affected: &FxHashSet<N>) -> usize {
+        let mut keep: Vec<(N, bool)> = Vec::with_capacity(hi + 1 - lo);
+        let mut moved: Vec<N> = Vec::with_capacity(affected.len());
+        for slot in lo..=hi {
+            let n = self.order[slot];
+            let live = self.is_live_slot(slot, n);
+            if live && affected.contains(&n) {
+                moved.push(n);
             } else {
-                left.push(n);
+                keep.push((n, live));
             }
         }
-        // Build new order by placing block after after_pos in the left vector
-        let mut new_order: Vec<N> = Vec::with_capacity(self.order.len());
-        let mut i = 0usize;
-        while i < left.len() {
-            new_order.push(left[i]);
-            i += 1;
-            if i - 1 == after_pos {
-                new_order.extend(block.iter().copied());
+        let count = moved.len();
+        let rewritten = keep.into_iter().chain(moved.into_iter().map(|n| (n, true)));
+        for (offset, (n, live)) in rewritten.enumerate() {
+            let slot = lo + offset;
+            self.order[slot] = n;
+            if live {
+                self.pos.insert(n, slot as u32);
             }
         }
-        if after_pos >= left.len() {
-            new_order.extend(block.iter().copied());
-        }
-        self.order = new_order;
-        // Recompute positions for moved nodes only; but for simplicity recompute all
-        for (i, &n) in self.order.iter().enumerate() {
-            self.pos.insert(n, i as u32);
+        count
+    }
+}
+
+fn split_layers<N>(layers: Vec<Vec<N>>, max_layer_width: Option<usize>) -> Vec<Vec<N>> {
+    match max_layer_width {
+        Some(cap) if cap > 0 && layers.iter().any(|l| l.len() > cap) => {
+            let mut out = Vec::with_capacity(layers.len());
+            for layer in layers {
+                if layer.len() <= cap {
+                    out.push(layer);
+                    continue;
+                }
+                let mut rest = layer.into_iter().peekable();
+                while rest.peek().is_some() {
+                    out.push(rest.by_ref().take(cap).collect());
+                }
+            }
+            out
         }
-        affected.len()
+        _ => layers,
     }
 }
 
@@ -663,4 +891,106 @@ mod tests {
             assert_eq!(pk.topo_order(), &before);
         }
     }
+
+    #[test]
+    fn backedge_relabels_only_the_affected_window() {
+        let g = SimpleGraph::default();
+        let nodes: Vec<u32> = (0..100).collect();
+        let mut pk = DynamicTopo::new(nodes, PkConfig::default());
+        pk.rebuild_full(&g);
+        let stats = pk.try_add_edge(&g, 12, 10).unwrap();
+        assert_eq!(stats.relabeled, 1);
+        let order = pk.topo_order();
+        assert_eq!(&order[10..13], &[11, 12, 10]);
+        assert_eq!(&order[..10], &(0..10).collect::<Vec<_>>()[..]);
+        assert_eq!(&order[13..], &(13..100).collect::<Vec<_>>()[..]);
+        assert_eq!(pk.position(10), Some(12));
+    }
+
+    #[test]
+    fn budget_overflow_suspends_then_refresh_rebuilds() {
+        // Chain 1 -> 2 -> ... -> 10 plus an isolated 11 ordered last.
+        let mut g = SimpleGraph::default();
+        for n in 1..10u32 {
+            g.add_edge(n, n + 1);
+        }
+        let nodes: Vec<u32> = (1..=11).collect();
+        let mut pk = DynamicTopo::new(
+            nodes.clone(),
+            PkConfig {
+                visit_budget: 2,
+                compaction_interval_ops: 100,
+            },
+        );
+        pk.rebuild_full(&g);
+        assert_eq!(pk.topo_order().last(), Some(&11));
+
+        // 11 -> 1 forces a forward walk over the whole chain, overrunning the budget.
+        g.add_edge(11, 1);
+        let stats = pk.try_add_edge(&g, 11, 1).unwrap();
+        assert!(stats.fallback);
+        assert!(pk.is_stale());
+        assert!(pk.ordered_layers_for(&g, &nodes, None).is_none());
+        assert_eq!(pk.telemetry().budget_fallbacks, 1);
+        // While stale, insertions are deferred rather than re-walking.
+        assert!(pk.try_add_edge(&g, 10, 11).unwrap().fallback);
+        assert!(pk.creates_cycle(&g, 10, 11));
+
+        assert!(pk.refresh(&g));
+        assert!(!pk.is_stale());
+        assert!(!pk.refresh(&g));
+        assert_eq!(pk.topo_order()[0], 11);
+        let layers = pk.ordered_layers_for(&g, &nodes, None).unwrap();
+        assert_eq!(layers.len(), 11);
+    }
+
+    #[test]
+    fn ordered_layers_reject_back_edges_and_self_loops() {
+        let mut g = SimpleGraph::default();
+        g.add_edge(1, 2);
+        let nodes = [1, 2, 3];
+        let mut pk = DynamicTopo::new(nodes, PkConfig::default());
+        pk.rebuild_full(&g);
+        assert!(pk.ordered_layers_for(&g, &nodes, None).is_some());
+        // Edge added behind the orderer's back: 3 -> 1 while 3 is ordered last.
+        g.add_edge(3, 1);
+        assert!(pk.ordered_layers_for(&g, &nodes, None).is_none());
+        // Kahn fallback still produces a valid layering.
+        let layers = pk.layers_for(&g, &nodes, None);
+        assert_eq!(layers, vec![vec![3], vec![1], vec![2]]);
+
+        let mut loops = SimpleGraph::default();
+        loops.add_edge(2, 2);
+        assert!(pk.ordered_layers_for(&loops, &[2], None).is_none());
+    }
+
+    #[test]
+    fn remove_node_tombstones_and_compacts() {
+        let mut g = SimpleGraph::default();
+        g.add_edge(1, 2);
+        let mut pk = DynamicTopo::new([1u32, 2, 3, 4], PkConfig::default());
+        pk.rebuild_full(&g);
+        pk.remove_node(3);
+        assert_eq!(pk.position(3), None);
+        assert_eq!(pk.topo_order().len(), 4);
+        let layers = pk.ordered_layers_for(&g, &[1, 2, 4], None).unwrap();
+        assert_eq!(layers, vec![vec![1, 4], vec![2]]);
+        pk.remove_node(4);
+        pk.remove_node(1);
+        // Tombstones now outnumber live nodes: compaction reclaimed them.
+        assert_eq!(pk.topo_order(), &[2]);
+        assert_eq!(pk.position(2), Some(0));
+        pk.ensure_nodes([3u32]);
+        assert_eq!(pk.position(3), Some(1));
+    }
+
+    #[test]
+    fn ordered_layers_split_by_width() {
+        let g = SimpleGraph::default();
+        let pk = DynamicTopo::new([1u32, 2, 3, 4, 5], PkConfig::default());
+        let layers = pk
+            .ordered_layers_for(&g, &[5, 4, 3, 2, 1], Some(2))
+            .unwrap();
+        assert_eq!(layers, vec![vec![1, 2], vec![3, 4], vec![5]]);
+    }
 }
@@ -18,6 +18,9 @@ pub struct DynamicRefCollector<'a, R: EvaluationContext> {
     pub current_sheet: &'a str,
     pub(crate) collected: Mutex<FxHashSet<VertexId>>,
     pub(crate) collected_regions: Mutex<FxHashSet<Region>>,
+    /// Also collect clean formula vertices in resolved ranges (used to record
+    /// the full resolved dependency set for speculative scheduling).
+    pub(crate) include_clean: bool,
 }
 
 impl<'a, R: EvaluationContext> DynamicRefCollector<'a, R> {
@@ -27,6 +30,7 @@ impl<'a, R: EvaluationContext> DynamicRefCollector<'a, R> {
             current_sheet,
             collected: Mutex::new(FxHashSet::default()),
             collected_regions: Mutex::new(FxHashSet::default()),
+            include_clean: false,
         }
     }
 
@@ -61,7 +65,10 @@ impl<'a, R: EvaluationContext> DynamicRefCollector<'a, R> {
             }
             match self.engine.graph.get_vertex_kind(u) {
                 VertexKind::FormulaScalar | VertexKind::FormulaArray => {
-                    if self.engine.graph.is_dirty(u) || self.engine.graph.is_volatile(u) {
+                    if self.include_clean
+                        || self.engine.graph.is_dirty(u)
+                        || self.engine.graph.is_volatile(u)
+                    {
                         out.insert(u);
                     }
                 }
@@ -434,6 +441,52 @@ impl<'a, R: EvaluationContext> VirtualDepBuilder<'a, R> {
 
         (vdeps, augmented_vertices)
     }
+
+    /// Like [`Self::build`], but dynamic-reference vertices with an entry in
+    /// `resolved` are scheduled against that previously resolved dependency set
+    /// (restricted to vertices dirty or volatile now) instead of being
+    /// re-interpreted. Returns the number of vertices scheduled speculatively.
+    pub(crate) fn build_speculative(
+        &self,
+        candidates: &[VertexId],
+        resolved: &rustc_hash::FxHashMap<VertexId, Vec<VertexId>>,
+    ) -> (
+        rustc_hash::FxHashMap<VertexId, Vec<VertexId>>,
+        Vec<VertexId>,
+        usize,
+    ) {
+        let graph = &self.engine.graph;
+        let mut vdeps: rustc_hash::FxHashMap<VertexId, Vec<VertexId>> =
+            rustc_hash::FxHashMap::default();
+        let mut speculated = 0usize;
+
+        for &v in candidates {
+            let mut deps = RangeVirtualDepProvider::get_virtual_deps(self.engine, v);
+            match resolved.get(&v) {
+                Some(previous) if graph.is_dynamic(v) => {
+                    speculated += 1;
+                    deps.extend(
+                        previous
+                            .iter()
+                            .copied()
+                            .filter(|&u| u != v && (graph.is_dirty(u) || graph.is_volatile(u))),
+                    );
+                }
+                _ => deps.extend(DynamicRefVirtualDepProvider::get_virtual_deps(
+                    self.engine,
+                    v,
+                )),
+            }
+            deps.sort_unstable();
+            deps.dedup();
+
+            if !deps.is_empty() {
+                vdeps.insert(v, deps);
+            }
+        }
+
+        (vdeps, Vec::new(), speculated)
+    }
 }
 
 pub struct DynamicRefVirtualDepProvider;
@@ -442,6 +495,14 @@ impl DynamicRefVirtualDepProvider {
     fn collect<R: EvaluationContext>(
         engine: &Engine<R>,
         v: VertexId,
+    ) -> (Vec<VertexId>, Vec<Region>) {
+        Self::collect_with(engine, v, false)
+    }
+
+    fn collect_with<R: EvaluationContext>(
+        engine: &Engine<R>,
+        v: VertexId,
+        include_clean: bool,
     ) -> (Vec<VertexId>, Vec<Region>) {
         if !engine.graph.is_dynamic(v) {
             return (Vec::new(), Vec::new());
@@ -451,7 +512,8 @@ impl DynamicRefVirtualDepProvider {
         };
         let sheet_id = engine.graph.get_vertex_sheet_id(v);
         let sheet_name = engine.graph.sheet_name(sheet_id);
-        let collector = DynamicRefCollector::new(engine, sheet_name);
+        let mut collector = DynamicRefCollector::new(engine, sheet_name);
+        collector.include_clean = include_clean;
         let cell_ref = engine
             .graph
             .get_cell_ref(v)
@@ -494,6 +556,22 @@ impl DynamicRefVirtualDepProvider {
         Self::collect(engine, v).0
     }
 
+    /// Every formula vertex `v` reads when evaluated against current values,
+    /// dirty or not. Recorded after a pass as the speculation set for the next.
+    pub(crate) fn resolved_formula_reads<R: EvaluationContext>(
+        engine: &Engine<R>,
+        v: VertexId,
+    ) -> Vec<VertexId> {
+        let mut reads = Self::collect_with(engine, v, true).0;
+        reads.retain(|&u| {
+            matches!(
+                engine.graph.get_vertex_kind(u),
+                VertexKind::FormulaScalar | VertexKind::FormulaArray
+            )
+        });
+        reads
+    }
+
     pub(crate) fn get_virtual_regions<R: EvaluationContext>(
         engine: &Engine<R>,
         v: VertexId,
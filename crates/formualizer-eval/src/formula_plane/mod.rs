@@ -21,8 +21,10 @@ pub(crate) mod producer;
 pub(crate) mod region_index;
 pub(crate) mod runtime;
 pub(crate) mod scheduler;
+pub(crate) mod span_columnar;
 pub mod span_counters;
 pub(crate) mod span_eval;
+pub(crate) mod span_jit;
 pub mod span_store;
 #[doc(hidden)]
 pub mod structural;
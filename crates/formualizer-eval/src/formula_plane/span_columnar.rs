@@ -0,0 +1,655 @@
+//! Columnar execution of relocatable span templates.
+//!
+//! A row-run span whose template is plain arithmetic over cell references
+//! (`=A2*$Z$1+B2/4-1`, `=IF(C2>A2,C2-A2,0)`) does not need the tree
+//! interpreter once per placement. [`ColumnarTemplate::compile`] lowers such a
+//! template to a postfix program over `f64` lanes. The span evaluator loads
+//! every row-relative reference once as a column through
+//! `RangeView::numbers_slices`, then runs the program over fixed-size batches
+//! with tight elementwise loops the compiler vectorizes.
+//!
+//! Every lane carries a per-row fallback mask. A row is marked when an input
+//! cell is not a plain number (empty, text, boolean, error, temporal, pending)
+//! or an operation leaves the finite-number domain (division by zero, negative
+//! base with a fractional exponent, SQRT of a negative, overflow). Marked rows
+//! are re-evaluated by the interpreter, so errors and coercions keep their
+//! exact scalar semantics.
+
+use std::hash::{Hash, Hasher};
+
+use arrow_array::Array;
+use formualizer_common::LiteralValue;
+use formualizer_parse::parser::ReferenceType;
+
+use crate::arrow_store::{OverlayValue, TypeTag};
+use crate::engine::arena::{AstNodeData, AstNodeId, CompactRefType, DataStore, SheetKey};
+use crate::engine::sheet_registry::SheetRegistry;
+use crate::interpreter::InterpreterParameterBindings;
+use crate::traits::EvaluationContext;
+
+use super::runtime::PlacementCoord;
+
+/// Rows per kernel pass, small enough that every live lane stays in cache.
+pub(crate) const COLUMNAR_BATCH_ROWS: usize = 1024;
+
+/// Writable placements below which the per-placement paths are cheaper than
+/// loading input columns.
+pub(crate) const COLUMNAR_MIN_PLACEMENTS: usize = 64;
+
+const MAX_LOWER_DEPTH: usize = 64;
+
+/// Static result kind of a lane. Booleans are stored as `0.0`/`1.0`.
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+enum LaneKind {
+    Number,
+    Boolean,
+}
+
+#[derive(Clone, Copy, Debug, PartialEq, Eq, Hash)]
+pub(super) enum CmpOp {
+    Eq,
+    Ne,
+    Gt,
+    Lt,
+    Ge,
+    Le,
+}
+
+#[derive(Clone, Copy, Debug)]
+pub(super) enum Op {
+    Const(f64),
+    Input(usize),
+    Neg,
+    Percent,
+    Add,
+    Sub,
+    Mul,
+    Div,
+    Pow,
+    Cmp(CmpOp),
+    Abs,
+    Sqrt,
+    If,
+}
+
+// Compiled kernels take their constants as arguments, so programs that
+// differ only in constant values compare (and hash) equal and share a kernel.
+impl PartialEq for Op {
+    fn eq(&self, other: &Self) -> bool {
+        match (self, other) {
+            (Op::Input(a), Op::Input(b)) => a == b,
+            (Op::Cmp(a), Op::Cmp(b)) => a == b,
+            _ => std::mem::discriminant(self) == std::mem::discriminant(other),
+        }
+    }
+}
+
+impl Eq for Op {}
+
+impl Hash for Op {
+    fn hash<H: Hasher>(&self, state: &mut H) {
+        std::mem::discriminant(self).hash(state);
+        match self {
+            Op::Input(index) => index.hash(state),
+            Op::Cmp(cmp) => cmp.hash(state),
+            _ => {}
+        }
+    }
+}
+
+/// Cache key for compiled kernels (see [`ColumnarTemplate::kernel_key`]).
+#[derive(Clone, Debug, PartialEq, Eq, Hash)]
+pub(crate) struct KernelKey {
+    pub(super) ops: Box<[Op]>,
+    pub(super) input_count: usize,
+}
+
+/// A template cell reference, in template (origin) coordinates.
+#[derive(Clone, Debug, PartialEq, Eq)]
+struct InputRef {
+    sheet: Option<String>,
+    row: u32,
+    col: u32,
+    row_abs: bool,
+    col_abs: bool,
+}
+
+/// Contiguous zero-based placement rows of one sheet column covered by a
+/// columnar run. Writable placements may leave gaps (overlay punchouts).
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub(crate) struct ColumnarRows {
+    pub(crate) col: u32,
+    pub(crate) first_row: u32,
+    pub(crate) len: usize,
+}
+
+impl ColumnarRows {
+    /// Rows covered by `placements` when they are strictly ascending rows of
+    /// one column and fill at least half of their extent.
+    pub(crate) fn for_placements(placements: &[PlacementCoord]) -> Option<Self> {
+        let first = placements.first()?;
+        let mut previous = first.row;
+        for placement in &placements[1..] {
+            if placement.sheet_id != first.sheet_id
+                || placement.col != first.col
+                || placement.row <= previous
+            {
+                return None;
+            }
+            previous = placement.row;
+        }
+        let len = (previous - first.row) as usize + 1;
+        if len > placements.len().saturating_mul(2) {
+            return None;
+        }
+        Some(Self {
+            col: first.col,
+            first_row: first.row,
+            len,
+        })
+    }
+
+    #[inline]
+    pub(crate) fn index_of(&self, placement: PlacementCoord) -> usize {
+        (placement.row - self.first_row) as usize
+    }
+}
+
+/// One loaded input: a value per covered row, or a single broadcast value.
+pub(crate) struct InputLane {
+    pub(super) values: Vec<f64>,
+    pub(super) fallback: Vec<bool>,
+}
+
+#[derive(Default)]
+struct Lane {
+    values: Vec<f64>,
+    fallback: Vec<bool>,
+}
+
+/// Reusable lane buffers for [`ColumnarTemplate::run_batch`].
+#[derive(Default)]
+pub(crate) struct LaneStack {
+    live: Vec<Lane>,
+    spare: Vec<Lane>,
+}
+
+impl LaneStack {
+    fn push(&mut self, len: usize) -> &mut Lane {
+        let mut lane = self.spare.pop().unwrap_or_default();
+        lane.values.resize(len, 0.0);
+        lane.fallback.resize(len, false);
+        self.live.push(lane);
+        self.live.last_mut().expect("lane just pushed")
+    }
+
+    fn pop(&mut self) -> Lane {
+        self.live.pop().expect("columnar program underflow")
+    }
+
+    fn release(&mut self, lane: Lane) {
+        self.spare.push(lane);
+    }
+
+    fn top(&mut self) -> &mut Lane {
+        self.live.last_mut().expect("columnar program underflow")
+    }
+}
+
+/// A span template lowered for columnar execution.
+#[derive(Debug)]
+pub(crate) struct ColumnarTemplate {
+    pub(super) ops: Vec<Op>,
+    inputs: Vec<InputRef>,
+    kind: LaneKind,
+}
+
+impl ColumnarTemplate {
+    /// Lower `root`, or `None` when any node is outside the supported subset:
+    /// number/boolean literals, single-cell references, unary `-`/`+`/`%`,
+    /// arithmetic and comparison operators, `IF` with three arguments, `ABS`
+    /// and `SQRT`. `parameters` supplies the literal slot values shared by
+    /// every placement of the run.
+    pub(crate) fn compile(
+        root: AstNodeId,
+        data_store: &DataStore,
+        sheet_registry: &SheetRegistry,
+        parameters: Option<InterpreterParameterBindings<'_>>,
+    ) -> Option<Self> {
+        let mut template = Self {
+            ops: Vec::new(),
+            inputs: Vec::new(),
+            kind: LaneKind::Number,
+        };
+        let mut lowering = Lowering {
+            template: &mut template,
+            data_store,
+            sheet_registry,
+            parameters,
+        };
+        let kind = lowering.lower(root, 0)?;
+        template.kind = kind;
+        // Input-free templates are constant-result spans, broadcast elsewhere.
+        if template.inputs.is_empty() {
+            return None;
+        }
+        Some(template)
+    }
+
+    /// Load every input for `rows`, shifted exactly as
+    /// `Interpreter::evaluate_arena_ast_with_offset` shifts reference leaves.
+    /// `None` when a shifted reference leaves the grid or cannot be resolved.
+    pub(crate) fn load_inputs(
+        &self,
+        context: &dyn EvaluationContext,
+        current_sheet: &str,
+        origin_row: u32,
+        origin_col: u32,
+        rows: ColumnarRows,
+    ) -> Option<Vec<InputLane>> {
+        let col_delta = i64::from(rows.col) + 1 - i64::from(origin_col);
+        let row_delta = i64::from(rows.first_row) + 1 - i64::from(origin_row);
+        self.inputs
+            .iter()
+            .map(|input| {
+                let col = if input.col_abs {
+                    input.col
+                } else {
+                    u32::try_from(i64::from(input.col) + col_delta)
+                        .ok()
+                        .filter(|&col| col > 0)?
+                };
+                let (start_row, len) = if input.row_abs {
+                    (input.row, 1)
+                } else {
+                    let start = u32::try_from(i64::from(input.row) + row_delta)
+                        .ok()
+                        .filter(|&row| row > 0)?;
+                    (start, rows.len)
+                };
+                load_column(
+                    context,
+                    current_sheet,
+                    input.sheet.as_deref(),
+                    start_row,
+                    col,
+                    len,
+                )
+            })
+            .collect()
+    }
+
+    /// Evaluate rows `start..start + values.len()` of the run into `values`,
+    /// marking rows the interpreter must re-evaluate in `fallback`.
+    pub(crate) fn run_batch(
+        &self,
+        inputs: &[InputLane],
+        start: usize,
+        values: &mut [f64],
+        fallback: &mut [bool],
+        stack: &mut LaneStack,
+    ) {
+        let len = values.len();
+        for op in &self.ops {
+            match *op {
+                Op::Const(value) => {
+                    let lane = stack.push(len);
+                    lane.values.fill(value);
+                    lane.fallback.fill(false);
+                }
+                Op::Input(index) => {
+                    let input = &inputs[index];
+                    let lane = stack.push(len);
+                    if input.values.len() == 1 {
+                        lane.values.fill(input.values[0]);
+                        lane.fallback.fill(input.fallback[0]);
+                    } else {
+                        lane.values
+                            .copy_from_slice(&input.values[start..start + len]);
+                        lane.fallback
+                            .copy_from_slice(&input.fallback[start..start + len]);
+                    }
+                }
+                Op::Neg => stack.top().values.iter_mut().for_each(|v| *v = -*v),
+                Op::Percent => stack.top().values.iter_mut().for_each(|v| *v /= 100.0),
+                Op::Abs => stack.top().values.iter_mut().for_each(|v| *v = v.abs()),
+                Op::Sqrt => {
+                    let lane = stack.top();
+                    for (f, v) in lane.fallback.iter_mut().zip(&lane.values) {
+                        *f |= *v < 0.0;
+                    }
+                    lane.values.iter_mut().for_each(|v| *v = v.sqrt());
+                }
+                Op::Add => binary(stack, |a, b| a + b),
+                Op::Sub => binary(stack, |a, b| a - b),
+                Op::Mul => binary(stack, |a, b| a * b),
+                Op::Div => {
+                    let right = stack.pop();
+                    let left = stack.top();
+                    for (f, b) in left.fallback.iter_mut().zip(&right.values) {
+                        *f |= *b == 0.0;
+                    }
+                    finish_binary(left, &right, |a, b| a / b);
+                    stack.release(right);
+                }
+                Op::Pow => {
+                    let right = stack.pop();
+                    let left = stack.top();
+                    for ((f, a), b) in left
+                        .fallback
+                        .iter_mut()
+                        .zip(&left.values)
+                        .zip(&right.values)
+                    {
+                        *f |= *a < 0.0 && b.fract() != 0.0;
+                    }
+                    finish_binary(left, &right, f64::powf);
+                    stack.release(right);
+                }
+                Op::Cmp(cmp) => {
+                    let right = stack.pop();
+                    let left = stack.top();
+                    for (a, b) in left.values.iter_mut().zip(&right.values) {
+                        let hit = match cmp {
+                            CmpOp::Eq => *a == *b,
+                            CmpOp::Ne => *a != *b,
+                            CmpOp::Gt => *a > *b,
+                            CmpOp::Lt => *a < *b,
+                            CmpOp::Ge => *a >= *b,
+                            CmpOp::Le => *a <= *b,
+                        };
+                        *a = f64::from(u8::from(hit));
+                    }
+                    for (f, g) in left.fallback.iter_mut().zip(&right.fallback) {
+                        *f |= *g;
+                    }
+                    stack.release(right);
+                }
+                Op::If => {
+                    let otherwise = stack.pop();
+                    let then = stack.pop();
+                    let cond = stack.top();
+                    for i in 0..len {
+                        // Only the taken branch is observed, as in IF itself.
+                        let (value, failed) = if cond.values[i] != 0.0 {
+                            (then.values[i], then.fallback[i])
+                        } else {
+                            (otherwise.values[i], otherwise.fallback[i])
+                        };
+                        cond.values[i] = value;
+                        cond.fallback[i] |= failed;
+                    }
+                    stack.release(then);
+                    stack.release(otherwise);
+                }
+            }
+        }
+        let result = stack.pop();
+        values.copy_from_slice(&result.values);
+        fallback.copy_from_slice(&result.fallback);
+        stack.release(result);
+    }
+
+    /// Identity of the lowered program, independent of which cells feed its
+    /// inputs and of its constant values; spans sharing a key can share one
+    /// compiled kernel.
+    pub(crate) fn kernel_key(&self) -> KernelKey {
+        KernelKey {
+            ops: self.ops.clone().into_boxed_slice(),
+            input_count: self.inputs.len(),
+        }
+    }
+
+    pub(crate) fn input_count(&self) -> usize {
+        self.inputs.len()
+    }
+
+    /// Constant operands in program order, the argument a compiled kernel
+    /// reads them from.
+    pub(crate) fn constants(&self) -> Vec<f64> {
+        self.ops
+            .iter()
+            .filter_map(|op| match *op {
+                Op::Const(value) => Some(value),
+                _ => None,
+            })
+            .collect()
+    }
+
+    /// Overlay value for a row the program computed.
+    #[inline]
+    pub(crate) fn overlay_value(&self, value: f64) -> OverlayValue {
+        match self.kind {
+            LaneKind::Number => OverlayValue::Number(value),
+            LaneKind::Boolean => OverlayValue::Boolean(value != 0.0),
+        }
+    }
+}
+
+/// Recursive lowering state for [`ColumnarTemplate::compile`].
+struct Lowering<'t, 'a> {
+    template: &'t mut ColumnarTemplate,
+    data_store: &'a DataStore,
+    sheet_registry: &'a SheetRegistry,
+    parameters: Option<InterpreterParameterBindings<'a>>,
+}
+
+impl Lowering<'_, '_> {
+    fn lower(&mut self, node: AstNodeId, depth: usize) -> Option<LaneKind> {
+        if depth > MAX_LOWER_DEPTH {
+            return None;
+        }
+        let depth = depth + 1;
+        match self.data_store.get_node(node)? {
+            AstNodeData::Literal(value_ref) => {
+                let literal = match self.parameters.and_then(|parameters| {
+                    let slot = parameters.literal_slots_by_node.get(&node)?;
+                    parameters.literal_values.get(slot.0 as usize)
+                }) {
+                    Some(value) => value.clone(),
+                    None => self.data_store.retrieve_value(*value_ref),
+                };
+                let (value, kind) = match literal {
+                    LiteralValue::Int(i) => (i as f64, LaneKind::Number),
+                    LiteralValue::Number(n) if n.is_finite() => (n, LaneKind::Number),
+                    LiteralValue::Boolean(b) => (f64::from(u8::from(b)), LaneKind::Boolean),
+                    _ => return None,
+                };
+                self.template.ops.push(Op::Const(value));
+                Some(kind)
+            }
+            AstNodeData::Reference {
+                ref_type:
+                    CompactRefType::Cell {
+                        sheet,
+                        row,
+                        col,
+                        row_abs,
+                        col_abs,
+                    },
+                ..
+            } if *row > 0 && *col > 0 => {
+                let input = InputRef {
+                    sheet: match sheet {
+                        Some(SheetKey::Id(id)) => Some(self.sheet_registry.name(*id).to_string()),
+                        Some(SheetKey::Name(name_id)) => {
+                            Some(self.data_store.resolve_ast_string(*name_id).to_string())
+                        }
+                        None => None,
+                    },
+                    row: *row,
+                    col: *col,
+                    row_abs: *row_abs,
+                    col_abs: *col_abs,
+                };
+                let index = match self
+                    .template
+                    .inputs
+                    .iter()
+                    .position(|existing| *existing == input)
+                {
+                    Some(index) => index,
+                    None => {
+                        self.template.inputs.push(input);
+                        self.template.inputs.len() - 1
+                    }
+                };
+                self.template.ops.push(Op::Input(index));
+                Some(LaneKind::Number)
+            }
+            AstNodeData::Reference { .. } | AstNodeData::Array { .. } => None,
+            AstNodeData::UnaryOp { op_id, expr_id } => {
+                let op = match self.data_store.resolve_ast_string(*op_id) {
+                    "+" => return self.lower(*expr_id, depth),
+                    "-" => Op::Neg,
+                    "%" => Op::Percent,
+                    _ => return None,
+                };
+                self.lower_number(*expr_id, depth)?;
+                self.template.ops.push(op);
+                Some(LaneKind::Number)
+            }
+            AstNodeData::BinaryOp {
+                op_id,
+                left_id,
+                right_id,
+            } => {
+                let (op, kind) = match self.data_store.resolve_ast_string(*op_id) {
+                    "+" => (Op::Add, LaneKind::Number),
+                    "-" => (Op::Sub, LaneKind::Number),
+                    "*" => (Op::Mul, LaneKind::Number),
+                    "/" => (Op::Div, LaneKind::Number),
+                    "^" => (Op::Pow, LaneKind::Number),
+                    "=" => (Op::Cmp(CmpOp::Eq), LaneKind::Boolean),
+                    "<>" => (Op::Cmp(CmpOp::Ne), LaneKind::Boolean),
+                    ">" => (Op::Cmp(CmpOp::Gt), LaneKind::Boolean),
+                    "<" => (Op::Cmp(CmpOp::Lt), LaneKind::Boolean),
+                    ">=" => (Op::Cmp(CmpOp::Ge), LaneKind::Boolean),
+                    "<=" => (Op::Cmp(CmpOp::Le), LaneKind::Boolean),
+                    _ => return None,
+                };
+                self.lower_number(*left_id, depth)?;
+                self.lower_number(*right_id, depth)?;
+                self.template.ops.push(op);
+                Some(kind)
+            }
+            AstNodeData::Function { name_id, .. } => {
+                let name = self.data_store.resolve_ast_string(*name_id);
+                let args = self.data_store.get_args(node)?;
+                if name.eq_ignore_ascii_case("IF") && args.len() == 3 {
+                    self.lower(args[0], depth)?;
+                    let then_kind = self.lower(args[1], depth)?;
+                    let else_kind = self.lower(args[2], depth)?;
+                    if then_kind != else_kind {
+                        return None;
+                    }
+                    self.template.ops.push(Op::If);
+                    return Some(then_kind);
+                }
+                let op = if name.eq_ignore_ascii_case("ABS") {
+                    Op::Abs
+                } else if name.eq_ignore_ascii_case("SQRT") {
+                    Op::Sqrt
+                } else {
+                    return None;
+                };
+                let [arg] = args else {
+                    return None;
+                };
+                self.lower_number(*arg, depth)?;
+                self.template.ops.push(op);
+                Some(LaneKind::Number)
+            }
+        }
+    }
+
+    /// Lower an operand that must be numeric. Boolean operands are rejected
+    /// rather than coerced, so the fast path never reimplements coercion.
+    fn lower_number(&mut self, node: AstNodeId, depth: usize) -> Option<()> {
+        (self.lower(node, depth)? == LaneKind::Number).then_some(())
+    }
+}
+
+/// Arithmetic operators: `left = f(left, right)`; rows whose result is not
+/// finite fall back (the interpreter reports `#NUM!`).
+fn binary(stack: &mut LaneStack, f: impl Fn(f64, f64) -> f64) {
+    let right = stack.pop();
+    finish_binary(stack.top(), &right, f);
+    stack.release(right);
+}
+
+fn finish_binary(left: &mut Lane, right: &Lane, f: impl Fn(f64, f64) -> f64) {
+    for (a, b) in left.values.iter_mut().zip(&right.values) {
+        *a = f(*a, *b);
+    }
+    for ((flag, g), v) in left
+        .fallback
+        .iter_mut()
+        .zip(&right.fallback)
+        .zip(&left.values)
+    {
+        *flag |= *g | !v.is_finite();
+    }
+}
+
+/// Read `len` rows of one column starting at 1-based `start_row`. Rows that
+/// are not plain numbers, or lie outside the sheet's stored rows, are marked
+/// for fallback.
+fn load_column(
+    context: &dyn EvaluationContext,
+    current_sheet: &str,
+    sheet: Option<&str>,
+    start_row: u32,
+    col: u32,
+    len: usize,
+) -> Option<InputLane> {
+    let end_row = start_row.checked_add(u32::try_from(len.checked_sub(1)?).ok()?)?;
+    let reference = ReferenceType::Range {
+        sheet: sheet.map(str::to_string),
+        start_row: Some(start_row),
+        start_col: Some(col),
+        end_row: Some(end_row),
+        end_col: Some(col),
+        start_row_abs: true,
+        start_col_abs: true,
+        end_row_abs: true,
+        end_col_abs: true,
+    };
+    let view = context.resolve_range_view(&reference, current_sheet).ok()?;
+    let mut lane = InputLane {
+        values: vec![0.0; len],
+        fallback: vec![true; len],
+    };
+    if view.dims().0 == 0 {
+        return Some(lane);
+    }
+    if view.dims().1 != 1 {
+        return None;
+    }
+    // Offset of the view's first row within the requested rows.
+    let base = view.start_row() as i64 - (i64::from(start_row) - 1);
+    for (numbers, tags) in view.numbers_slices().zip(view.type_tags_slices()) {
+        let (row_start, row_len, numbers) = numbers.ok()?;
+        let (_, _, tags) = tags.ok()?;
+        let (numbers, tags) = (numbers.first()?, tags.first()?);
+        // Homogeneous segments need no per-row tag checks.
+        let all_numbers = match crate::arrow_store::uniform_type_tag(tags) {
+            Some(TypeTag::Number) => true,
+            Some(_) => continue,
+            None => false,
+        };
+        for i in 0..row_len {
+            let Ok(at) = usize::try_from(base + (row_start + i) as i64) else {
+                continue;
+            };
+            if at >= len {
+                break;
+            }
+            if (all_numbers || tags.value(i) == TypeTag::Number as u8) && numbers.is_valid(i) {
+                lane.values[at] = numbers.value(i);
+                lane.fallback[at] = false;
+            }
+        }
+    }
+    Some(lane)
+}
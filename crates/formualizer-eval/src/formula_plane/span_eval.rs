@@ -26,6 +26,10 @@ use super::runtime::{
     FormulaPlane, FormulaSpan, FormulaSpanRef, PlacementCoord, PlacementDomain,
     PlacementDomainIter, SpanBindingSet, TemplateRecord,
 };
+use super::span_columnar::{
+    COLUMNAR_BATCH_ROWS, COLUMNAR_MIN_PLACEMENTS, ColumnarRows, ColumnarTemplate, LaneStack,
+};
+use super::span_jit::SpanJitCache;
 use super::template_canonical::{AxisRef, CanonicalReference, SheetBinding};
 
 #[derive(Clone, Debug, PartialEq, Eq)]
@@ -54,6 +58,14 @@ pub(crate) struct SpanEvalReport {
     pub(crate) parallel_memoized_invocations: u64,
     pub(crate) sequential_per_placement_invocations: u64,
     pub(crate) sequential_memoized_invocations: u64,
+    /// Tasks evaluated by the columnar executor ([`super::span_columnar`]),
+    /// the placements it wrote, and the rows it handed back to the
+    /// interpreter.
+    pub(crate) columnar_invocations: u64,
+    pub(crate) columnar_placement_count: u64,
+    pub(crate) columnar_fallback_count: u64,
+    /// Columnar tasks run by a compiled kernel ([`super::span_jit`]).
+    pub(crate) jit_invocations: u64,
 }
 
 #[derive(Clone, Debug, PartialEq, Eq)]
@@ -174,6 +186,8 @@ pub(crate) struct SpanEvaluator<'a> {
     data_store: &'a DataStore,
     sheet_registry: &'a SheetRegistry,
     cancel: Option<&'a AtomicBool>,
+    columnar: bool,
+    jit: Option<(&'a SpanJitCache, u64)>,
 }
 
 impl<'a> SpanEvaluator<'a> {
@@ -209,9 +223,24 @@ impl<'a> SpanEvaluator<'a> {
             data_store,
             sheet_registry,
             cancel,
+            columnar: false,
+            jit: None,
         }
     }
 
+    /// Route eligible row-run spans through the columnar executor.
+    pub(crate) fn with_columnar(mut self, enabled: bool) -> Self {
+        self.columnar = enabled;
+        self
+    }
+
+    /// Tier hot columnar programs up to native kernels from `cache` once they
+    /// have evaluated `tier_up_placements` placements.
+    pub(crate) fn with_jit(mut self, cache: &'a SpanJitCache, tier_up_placements: u64) -> Self {
+        self.jit = Some((cache, tier_up_placements));
+        self
+    }
+
     fn cancellation_checkpoint(&self, index: usize) -> Result<(), SpanEvalError> {
         if index.is_multiple_of(256) && self.cancel.is_some_and(|flag| flag.load(Ordering::Relaxed))
         {
@@ -337,6 +366,21 @@ impl<'a> SpanEvaluator<'a> {
             .skipped_overlay_punchout_count
             .saturating_add(skipped_overlay);
 
+        if self.try_evaluate_columnar(
+            span,
+            eval_ast_id,
+            eval_origin_row,
+            eval_origin_col,
+            per_placement_binding_set,
+            &writable_placements,
+            sink,
+            &mut report,
+        )? {
+            report.computed_write_buffer_push_count =
+                sink.push_count().saturating_sub(push_count_before);
+            return Ok(report);
+        }
+
         #[cfg(not(target_arch = "wasm32"))]
         if let Some(thread_pool) = self.thread_pool()
             && writable_placements.len() >= PARALLEL_PLACEMENT_THRESHOLD
@@ -475,6 +519,126 @@ impl<'a> SpanEvaluator<'a> {
         Ok(())
     }
 
+    /// Evaluate a row run batch-wise over input columns when the template
+    /// lowers to a [`ColumnarTemplate`], re-running only the rows the program
+    /// could not compute through the interpreter. Returns `false`, having
+    /// written nothing, when the run is not eligible.
+    #[allow(clippy::too_many_arguments)]
+    fn try_evaluate_columnar(
+        &self,
+        span: &FormulaSpan,
+        ast_id: AstNodeId,
+        origin_row: u32,
+        origin_col: u32,
+        binding_set: Option<&SpanBindingSet>,
+        writable_placements: &[PlacementCoord],
+        sink: &mut SpanComputedWriteSink<'_>,
+        report: &mut SpanEvalReport,
+    ) -> Result<bool, SpanEvalError> {
+        if !self.columnar || writable_placements.len() < COLUMNAR_MIN_PLACEMENTS {
+            return Ok(false);
+        }
+        let Some(rows) = ColumnarRows::for_placements(writable_placements) else {
+            return Ok(false);
+        };
+        // Literal slots must hold one value for the whole run; per-placement
+        // literals would need their own lanes.
+        let literals = match binding_set {
+            Some(binding_set) if !binding_set.is_single_literal_binding() => return Ok(false),
+            Some(binding_set) => {
+                match binding_set
+                    .literal_bindings_for_placement(&span.domain, writable_placements[0])
+                {
+                    Some(values) => Some((binding_set, values)),
+                    None => return Ok(false),
+                }
+            }
+            None => None,
+        };
+        let parameters =
+            literals
+                .as_ref()
+                .map(|(binding_set, values)| InterpreterParameterBindings {
+                    literal_slots_by_node: &binding_set
+                        .template_slot_map
+                        .literal_slots_by_arena_node,
+                    literal_values: values.as_ref(),
+                });
+        let Some(template) =
+            ColumnarTemplate::compile(ast_id, self.data_store, self.sheet_registry, parameters)
+        else {
+            return Ok(false);
+        };
+        let Some(inputs) = template.load_inputs(
+            self.context,
+            self.current_sheet,
+            origin_row,
+            origin_col,
+            rows,
+        ) else {
+            return Ok(false);
+        };
+
+        report.columnar_invocations = report.columnar_invocations.saturating_add(1);
+        let mut values = vec![0.0; rows.len];
+        let mut fallback = vec![false; rows.len];
+        let kernel = self.jit.and_then(|(cache, tier_up)| {
+            cache.kernel_for(&template, writable_placements.len(), tier_up)
+        });
+        if let Some(kernel) = &kernel {
+            self.cancellation_checkpoint(0)?;
+            kernel.run(&inputs, &template.constants(), &mut values, &mut fallback);
+            report.jit_invocations = report.jit_invocations.saturating_add(1);
+        } else {
+            let mut stack = LaneStack::default();
+            for start in (0..rows.len).step_by(COLUMNAR_BATCH_ROWS) {
+                self.cancellation_checkpoint(start)?;
+                let end = (start + COLUMNAR_BATCH_ROWS).min(rows.len);
+                template.run_batch(
+                    &inputs,
+                    start,
+                    &mut values[start..end],
+                    &mut fallback[start..end],
+                    &mut stack,
+                );
+            }
+        }
+
+        let mut fallback_rows = 0u64;
+        for (index, placement) in writable_placements.iter().copied().enumerate() {
+            self.cancellation_checkpoint(index)?;
+            let at = rows.index_of(placement);
+            let value = if fallback[at] {
+                fallback_rows = fallback_rows.saturating_add(1);
+                self.evaluate_placement_value(
+                    span,
+                    ast_id,
+                    origin_row,
+                    origin_col,
+                    binding_set,
+                    placement,
+                )?
+            } else {
+                template.overlay_value(values[at])
+            };
+            sink.push_cell(placement, value);
+        }
+        let count = writable_placements.len() as u64;
+        if kernel.is_some()
+            && let Some((cache, _)) = self.jit
+        {
+            cache.record_run(fallback_rows);
+        }
+        report.transient_ast_relocation_count = report
+            .transient_ast_relocation_count
+            .saturating_add(fallback_rows);
+        report.columnar_fallback_count =
+            report.columnar_fallback_count.saturating_add(fallback_rows);
+        report.columnar_placement_count = report.columnar_placement_count.saturating_add(count);
+        report.span_eval_placement_count = report.span_eval_placement_count.saturating_add(count);
+        Ok(true)
+    }
+
     #[cfg(not(target_arch = "wasm32"))]
     #[allow(clippy::too_many_arguments)]
     fn evaluate_per_placement_parallel(
@@ -0,0 +1,448 @@
+//! JIT tier for hot columnar span templates.
+//!
+//! [`super::span_columnar`] runs a lowered template as a lane program, one
+//! kernel pass per operator. A program that keeps getting evaluated is worth
+//! compiling instead: [`SpanJitCache`] counts placement evaluations per
+//! [`KernelKey`] (placements written times recalcs), and once a key crosses the
+//! tier-up threshold its program is compiled into a single native row loop.
+//! Kernels are cached by key, so every span lowering to the same program
+//! shares one kernel whatever cells feed its inputs; constants are passed in
+//! as an argument, so copies differing only in their literals share it too.
+//! Compilation runs outside the cache lock.
+//!
+//! A kernel fills the same value and fallback lanes as the lane program.
+//! Rows it flags (non-numeric input, division by zero, non-finite result)
+//! deoptimize to the interpreter exactly as they do on the columnar path.
+//!
+//! Code generation uses Cranelift and is only built with the `jit` cargo
+//! feature on native targets. Without it the tiering bookkeeping still runs,
+//! but every hot key is recorded as unavailable and the lane program is used.
+
+use std::sync::Arc;
+use std::sync::Mutex;
+use std::sync::atomic::{AtomicU64, Ordering};
+
+use rustc_hash::FxHashMap;
+
+use super::span_columnar::{ColumnarTemplate, InputLane, KernelKey};
+
+/// Counters for the span JIT tier (see `Engine::span_jit_stats`).
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct SpanJitStats {
+    /// Programs compiled to native kernels.
+    pub compiled: u64,
+    /// Hot programs that could not be compiled (or the `jit` feature is off).
+    pub unavailable: u64,
+    /// Span tasks evaluated by a compiled kernel.
+    pub kernel_runs: u64,
+    /// Rows compiled kernels handed back to the interpreter.
+    pub deopt_rows: u64,
+}
+
+enum JitEntry {
+    /// Placement evaluations seen so far.
+    Warming(u64),
+    /// Being compiled by another evaluation, which installs the result.
+    Compiling,
+    Ready(Arc<JitKernel>),
+    Unavailable,
+}
+
+/// Engine-lifetime cache of compiled span kernels.
+#[derive(Default)]
+pub(crate) struct SpanJitCache {
+    entries: Mutex<FxHashMap<KernelKey, JitEntry>>,
+    compiled: AtomicU64,
+    unavailable: AtomicU64,
+    kernel_runs: AtomicU64,
+    deopt_rows: AtomicU64,
+}
+
+impl SpanJitCache {
+    /// Record `placements` evaluations of `template` and return its kernel
+    /// once the key has seen `tier_up_placements` of them.
+    pub(crate) fn kernel_for(
+        &self,
+        template: &ColumnarTemplate,
+        placements: usize,
+        tier_up_placements: u64,
+    ) -> Option<Arc<JitKernel>> {
+        let key = template.kernel_key();
+        {
+            let mut entries = self.entries.lock().unwrap_or_else(|e| e.into_inner());
+            let entry = entries.entry(key.clone()).or_insert(JitEntry::Warming(0));
+            match entry {
+                JitEntry::Ready(kernel) => return Some(kernel.clone()),
+                JitEntry::Compiling | JitEntry::Unavailable => return None,
+                JitEntry::Warming(heat) => {
+                    *heat = heat.saturating_add(placements as u64);
+                    if *heat < tier_up_placements {
+                        return None;
+                    }
+                }
+            }
+            *entry = JitEntry::Compiling;
+        }
+        // Other evaluations keep using the lane program until this lands.
+        let kernel = JitKernel::compile(template).map(Arc::new);
+        let installed = match &kernel {
+            Some(kernel) => {
+                self.compiled.fetch_add(1, Ordering::Relaxed);
+                JitEntry::Ready(kernel.clone())
+            }
+            None => {
+                self.unavailable.fetch_add(1, Ordering::Relaxed);
+                JitEntry::Unavailable
+            }
+        };
+        self.entries
+            .lock()
+            .unwrap_or_else(|e| e.into_inner())
+            .insert(key, installed);
+        kernel
+    }
+
+    pub(crate) fn record_run(&self, deopt_rows: u64) {
+        self.kernel_runs.fetch_add(1, Ordering::Relaxed);
+        self.deopt_rows.fetch_add(deopt_rows, Ordering::Relaxed);
+    }
+
+    pub(crate) fn stats(&self) -> SpanJitStats {
+        SpanJitStats {
+            compiled: self.compiled.load(Ordering::Relaxed),
+            unavailable: self.unavailable.load(Ordering::Relaxed),
+            kernel_runs: self.kernel_runs.load(Ordering::Relaxed),
+            deopt_rows: self.deopt_rows.load(Ordering::Relaxed),
+        }
+    }
+}
+
+/// A compiled row loop:
+/// `(input columns, input fallback masks, constants, rows, values out, fallback out)`.
+#[cfg(all(feature = "jit", not(target_arch = "wasm32")))]
+type KernelFn =
+    unsafe extern "C" fn(*const *const f64, *const *const u8, *const f64, usize, *mut f64, *mut u8);
+
+/// A native kernel for one [`KernelKey`].
+pub(crate) struct JitKernel {
+    #[cfg(all(feature = "jit", not(target_arch = "wasm32")))]
+    code: KernelFn,
+    #[cfg(all(feature = "jit", not(target_arch = "wasm32")))]
+    module: Option<cranelift_jit::JITModule>,
+    input_count: usize,
+    constant_count: usize,
+}
+
+// SAFETY: the finalized code is immutable and the module is only touched
+// again on drop, when no other reference to the kernel remains.
+unsafe impl Send for JitKernel {}
+unsafe impl Sync for JitKernel {}
+
+impl JitKernel {
+    #[cfg(not(all(feature = "jit", not(target_arch = "wasm32"))))]
+    fn compile(_template: &ColumnarTemplate) -> Option<Self> {
+        None
+    }
+
+    #[cfg(all(feature = "jit", not(target_arch = "wasm32")))]
+    fn compile(template: &ColumnarTemplate) -> Option<Self> {
+        let (module, code) = codegen::compile(&template.ops, template.input_count()).ok()?;
+        Some(Self {
+            code,
+            module: Some(module),
+            input_count: template.input_count(),
+            constant_count: template.constants().len(),
+        })
+    }
+
+    /// Evaluate rows `0..values.len()` of the run; `inputs` come from
+    /// [`ColumnarTemplate::load_inputs`] and `constants` from
+    /// [`ColumnarTemplate::constants`] of a template with this kernel's key.
+    pub(crate) fn run(
+        &self,
+        inputs: &[InputLane],
+        constants: &[f64],
+        values: &mut [f64],
+        fallback: &mut [bool],
+    ) {
+        assert_eq!(inputs.len(), self.input_count, "kernel input arity");
+        assert_eq!(constants.len(), self.constant_count, "kernel constants");
+        assert_eq!(values.len(), fallback.len(), "kernel output lanes");
+        #[cfg(all(feature = "jit", not(target_arch = "wasm32")))]
+        {
+            let len = values.len();
+            // Broadcast (absolute-row) inputs are widened to full columns so
+            // the kernel reads every input with the same stride.
+            let widened: Vec<Option<(Vec<f64>, Vec<bool>)>> = inputs
+                .iter()
+                .map(|input| {
+                    (input.values.len() != len)
+                        .then(|| (vec![input.values[0]; len], vec![input.fallback[0]; len]))
+                })
+                .collect();
+            let mut columns = Vec::with_capacity(inputs.len());
+            let mut masks = Vec::with_capacity(inputs.len());
+            for (input, widened) in inputs.iter().zip(&widened) {
+                let (column, mask) = match widened {
+                    Some((column, mask)) => (column.as_slice(), mask.as_slice()),
+                    None => (input.values.as_slice(), input.fallback.as_slice()),
+                };
+                assert_eq!(column.len(), len, "kernel input rows");
+                columns.push(column.as_ptr());
+                masks.push(mask.as_ptr().cast::<u8>());
+            }
+            // SAFETY: every column and mask holds `len` elements, `constants`
+            // holds one value per constant operand, the output lanes hold
+            // `len` elements, and the kernel stores only 0 or 1 into the
+            // `bool` fallback lane.
+            unsafe {
+                (self.code)(
+                    columns.as_ptr(),
+                    masks.as_ptr(),
+                    constants.as_ptr(),
+                    len,
+                    values.as_mut_ptr(),
+                    fallback.as_mut_ptr().cast::<u8>(),
+                );
+            }
+        }
+        #[cfg(not(all(feature = "jit", not(target_arch = "wasm32"))))]
+        {
+            let _ = (inputs, constants, values, fallback);
+            unreachable!("JIT kernels are only built with the `jit` feature");
+        }
+    }
+}
+
+#[cfg(all(feature = "jit", not(target_arch = "wasm32")))]
+impl Drop for JitKernel {
+    fn drop(&mut self) {
+        if let Some(module) = self.module.take() {
+            // SAFETY: `code` points into this module and is dropped with it.
+            unsafe { module.free_memory() };
+        }
+    }
+}
+
+#[cfg(all(feature = "jit", not(target_arch = "wasm32")))]
+mod codegen {
+    use cranelift_codegen::ir::condcodes::{FloatCC, IntCC};
+    use cranelift_codegen::ir::{AbiParam, InstBuilder, MemFlags, Value, types};
+    use cranelift_codegen::settings::{self, Configurable};
+    use cranelift_frontend::{FunctionBuilder, FunctionBuilderContext};
+    use cranelift_jit::{JITBuilder, JITModule};
+    use cranelift_module::{Linkage, Module, default_libcall_names};
+
+    use super::KernelFn;
+    use crate::formula_plane::span_columnar::{CmpOp, Op};
+
+    const POW_SYMBOL: &str = "formualizer_span_jit_pow";
+
+    extern "C" fn span_jit_pow(base: f64, exponent: f64) -> f64 {
+        base.powf(exponent)
+    }
+
+    pub(super) fn compile(ops: &[Op], input_count: usize) -> Result<(JITModule, KernelFn), String> {
+        let mut flags = settings::builder();
+        flags
+            .set("use_colocated_libcalls", "false")
+            .map_err(|e| e.to_string())?;
+        flags.set("is_pic", "false").map_err(|e| e.to_string())?;
+        flags.set("opt_level", "speed").map_err(|e| e.to_string())?;
+        let isa = cranelift_native::builder()
+            .map_err(str::to_string)?
+            .finish(settings::Flags::new(flags))
+            .map_err(|e| e.to_string())?;
+        let mut builder = JITBuilder::with_isa(isa, default_libcall_names());
+        builder.symbol(POW_SYMBOL, span_jit_pow as *const u8);
+        let mut module = JITModule::new(builder);
+        match define(&mut module, ops, input_count) {
+            Ok(code) => Ok((module, code)),
+            Err(err) => {
+                // SAFETY: nothing from this module has been handed out.
+                unsafe { module.free_memory() };
+                Err(err)
+            }
+        }
+    }
+
+    fn define(module: &mut JITModule, ops: &[Op], input_count: usize) -> Result<KernelFn, String> {
+        let ptr = module.target_config().pointer_type();
+        let mut ctx = module.make_context();
+        for _ in 0..6 {
+            ctx.func.signature.params.push(AbiParam::new(ptr));
+        }
+
+        let mut pow_sig = module.make_signature();
+        pow_sig.params.push(AbiParam::new(types::F64));
+        pow_sig.params.push(AbiParam::new(types::F64));
+        pow_sig.returns.push(AbiParam::new(types::F64));
+        let pow_id = module
+            .declare_function(POW_SYMBOL, Linkage::Import, &pow_sig)
+            .map_err(|e| e.to_string())?;
+
+        let mut fn_ctx = FunctionBuilderContext::new();
+        let mut b = FunctionBuilder::new(&mut ctx.func, &mut fn_ctx);
+        let pow = module.declare_func_in_func(pow_id, b.func);
+        let flags = MemFlags::trusted();
+
+        let entry = b.create_block();
+        b.append_block_params_for_function_params(entry);
+        b.switch_to_block(entry);
+        let params = b.block_params(entry).to_vec();
+        let (inputs_ptr, masks_ptr, constants_ptr, len, out, out_fallback) = (
+            params[0], params[1], params[2], params[3], params[4], params[5],
+        );
+        let pointer_bytes = ptr.bytes() as i32;
+        let mut columns = Vec::with_capacity(input_count);
+        for index in 0..input_count {
+            let offset = pointer_bytes * index as i32;
+            let column = b.ins().load(ptr, flags, inputs_ptr, offset);
+            let mask = b.ins().load(ptr, flags, masks_ptr, offset);
+            columns.push((column, mask));
+        }
+        let mut constants = Vec::new();
+        for op in ops {
+            if let Op::Const(_) = op {
+                let offset = 8 * constants.len() as i32;
+                constants.push(b.ins().load(types::F64, flags, constants_ptr, offset));
+            }
+        }
+        let mut constants = constants.into_iter();
+        let zero_row = b.ins().iconst(ptr, 0);
+
+        let header = b.create_block();
+        let row = b.append_block_param(header, ptr);
+        let body = b.create_block();
+        let exit = b.create_block();
+        b.ins().jump(header, &[zero_row.into()]);
+
+        b.switch_to_block(header);
+        let more = b.ins().icmp(IntCC::UnsignedLessThan, row, len);
+        b.ins().brif(more, body, &[], exit, &[]);
+
+        b.switch_to_block(body);
+        let f64_offset = b.ins().ishl_imm(row, 3);
+        let zero = b.ins().f64const(0.0);
+        let one = b.ins().f64const(1.0);
+        let clear = b.ins().iconst(types::I8, 0);
+        // (value, fallback flag as 0/1 i8) per pending operand.
+        let mut stack: Vec<(Value, Value)> = Vec::new();
+        let underflow = || "columnar program underflow".to_string();
+        for op in ops {
+            match *op {
+                Op::Const(_) => {
+                    let value = constants.next().ok_or_else(underflow)?;
+                    stack.push((value, clear));
+                }
+                Op::Input(index) => {
+                    let (column, mask) = *columns.get(index).ok_or_else(underflow)?;
+                    let value_addr = b.ins().iadd(column, f64_offset);
+                    let value = b.ins().load(types::F64, flags, value_addr, 0);
+                    let mask_addr = b.ins().iadd(mask, row);
+                    let failed = b.ins().load(types::I8, flags, mask_addr, 0);
+                    stack.push((value, failed));
+                }
+                Op::Neg | Op::Percent | Op::Abs | Op::Sqrt => {
+                    let (value, failed) = stack.pop().ok_or_else(underflow)?;
+                    let entry = match *op {
+                        Op::Neg => (b.ins().fneg(value), failed),
+                        Op::Percent => {
+                            let hundred = b.ins().f64const(100.0);
+                            (b.ins().fdiv(value, hundred), failed)
+                        }
+                        Op::Abs => (b.ins().fabs(value), failed),
+                        _ => {
+                            let negative = b.ins().fcmp(FloatCC::LessThan, value, zero);
+                            (b.ins().sqrt(value), b.ins().bor(failed, negative))
+                        }
+                    };
+                    stack.push(entry);
+                }
+                Op::Add | Op::Sub | Op::Mul | Op::Div | Op::Pow => {
+                    let (right, right_failed) = stack.pop().ok_or_else(underflow)?;
+                    let (left, left_failed) = stack.pop().ok_or_else(underflow)?;
+                    let mut failed = b.ins().bor(left_failed, right_failed);
+                    let value = match *op {
+                        Op::Add => b.ins().fadd(left, right),
+                        Op::Sub => b.ins().fsub(left, right),
+                        Op::Mul => b.ins().fmul(left, right),
+                        Op::Div => {
+                            let by_zero = b.ins().fcmp(FloatCC::Equal, right, zero);
+                            failed = b.ins().bor(failed, by_zero);
+                            b.ins().fdiv(left, right)
+                        }
+                        _ => {
+                            let negative = b.ins().fcmp(FloatCC::LessThan, left, zero);
+                            let whole = b.ins().trunc(right);
+                            let fractional = b.ins().fcmp(FloatCC::NotEqual, right, whole);
+                            let domain = b.ins().band(negative, fractional);
+                            failed = b.ins().bor(failed, domain);
+                            let call = b.ins().call(pow, &[left, right]);
+                            b.inst_results(call)[0]
+                        }
+                    };
+                    // `v - v` is NaN exactly when `v` is infinite or NaN.
+                    let spread = b.ins().fsub(value, value);
+                    let non_finite = b.ins().fcmp(FloatCC::Unordered, spread, spread);
+                    failed = b.ins().bor(failed, non_finite);
+                    stack.push((value, failed));
+                }
+                Op::Cmp(cmp) => {
+                    let (right, right_failed) = stack.pop().ok_or_else(underflow)?;
+                    let (left, left_failed) = stack.pop().ok_or_else(underflow)?;
+                    let cc = match cmp {
+                        CmpOp::Eq => FloatCC::Equal,
+                        CmpOp::Ne => FloatCC::NotEqual,
+                        CmpOp::Gt => FloatCC::GreaterThan,
+                        CmpOp::Lt => FloatCC::LessThan,
+                        CmpOp::Ge => FloatCC::GreaterThanOrEqual,
+                        CmpOp::Le => FloatCC::LessThanOrEqual,
+                    };
+                    let hit = b.ins().fcmp(cc, left, right);
+                    let value = b.ins().select(hit, one, zero);
+                    let failed = b.ins().bor(left_failed, right_failed);
+                    stack.push((value, failed));
+                }
+                Op::If => {
+                    let (otherwise, otherwise_failed) = stack.pop().ok_or_else(underflow)?;
+                    let (then, then_failed) = stack.pop().ok_or_else(underflow)?;
+                    let (cond, cond_failed) = stack.pop().ok_or_else(underflow)?;
+                    let take = b.ins().fcmp(FloatCC::NotEqual, cond, zero);
+                    let value = b.ins().select(take, then, otherwise);
+                    let branch_failed = b.ins().select(take, then_failed, otherwise_failed);
+                    let failed = b.ins().bor(cond_failed, branch_failed);
+                    stack.push((value, failed));
+                }
+            }
+        }
+        let (value, failed) = stack.pop().ok_or_else(underflow)?;
+        if !stack.is_empty() {
+            return Err("columnar program left extra operands".to_string());
+        }
+        let value_addr = b.ins().iadd(out, f64_offset);
+        b.ins().store(flags, value, value_addr, 0);
+        let failed_addr = b.ins().iadd(out_fallback, row);
+        b.ins().store(flags, failed, failed_addr, 0);
+        let next = b.ins().iadd_imm(row, 1);
+        b.ins().jump(header, &[next.into()]);
+
+        b.switch_to_block(exit);
+        b.ins().return_(&[]);
+        b.seal_all_blocks();
+        b.finalize();
+
+        let id = module
+            .declare_anonymous_function(&ctx.func.signature)
+            .map_err(|e| e.to_string())?;
+        module
+            .define_function(id, &mut ctx)
+            .map_err(|e| e.to_string())?;
+        module.clear_context(&mut ctx);
+        module.finalize_definitions().map_err(|e| e.to_string())?;
+        let code = module.get_finalized_function(id);
+        // SAFETY: the function was defined with exactly `KernelFn`'s six
+        // pointer-sized parameters and no return value.
+        Ok(unsafe { std::mem::transmute::<*const u8, KernelFn>(code) })
+    }
+}
@@ -4,7 +4,7 @@
 //! demoting optimized spans before row/column structural edits.  They materialize
 //! per-placement ASTs without mutating the shared arena AST.
 
-use formualizer_common::{ExcelError, ExcelErrorKind};
+use formualizer_common::{ExcelError, ExcelErrorKind, LiteralValue};
 use formualizer_parse::parser::{ASTNode, ASTNodeType, ReferenceType};
 
 /// Re-anchor a FormulaPlane template AST at a concrete placement.
@@ -82,6 +82,74 @@ pub fn relocate_ast_for_template_placement(
     })
 }
 
+/// Replace a span template's literal slots with one placement's literal binding.
+///
+/// Slots are the literals outside array constants, numbered in pre-order; this is
+/// the order `SpanBindingSet::literal_bindings_for_placement` returns them in.
+#[doc(hidden)]
+pub fn substitute_literal_slots_for_template_placement(
+    ast: &ASTNode,
+    binding: &[LiteralValue],
+) -> ASTNode {
+    fn clone_with_slots(
+        ast: &ASTNode,
+        binding: &[LiteralValue],
+        next: &mut usize,
+        in_array: bool,
+    ) -> ASTNode {
+        let node_type = match &ast.node_type {
+            ASTNodeType::Literal(_) if !in_array => {
+                let value = binding.get(*next).cloned().unwrap_or(LiteralValue::Empty);
+                *next = next.saturating_add(1);
+                ASTNodeType::Literal(value)
+            }
+            ASTNodeType::Literal(value) => ASTNodeType::Literal(value.clone()),
+            ASTNodeType::Reference {
+                original,
+                reference,
+            } => ASTNodeType::Reference {
+                original: original.clone(),
+                reference: reference.clone(),
+            },
+            ASTNodeType::UnaryOp { op, expr } => ASTNodeType::UnaryOp {
+                op: op.clone(),
+                expr: Box::new(clone_with_slots(expr, binding, next, in_array)),
+            },
+            ASTNodeType::BinaryOp { op, left, right } => ASTNodeType::BinaryOp {
+                op: op.clone(),
+                left: Box::new(clone_with_slots(left, binding, next, in_array)),
+                right: Box::new(clone_with_slots(right, binding, next, in_array)),
+            },
+            ASTNodeType::Function { name, args } => ASTNodeType::Function {
+                name: name.clone(),
+                args: args
+                    .iter()
+                    .map(|arg| clone_with_slots(arg, binding, next, in_array))
+                    .collect(),
+            },
+            ASTNodeType::Call { callee, args } => ASTNodeType::Call {
+                callee: Box::new(clone_with_slots(callee, binding, next, in_array)),
+                args: args
+                    .iter()
+                    .map(|arg| clone_with_slots(arg, binding, next, in_array))
+                    .collect(),
+            },
+            ASTNodeType::Array(rows) => ASTNodeType::Array(
+                rows.iter()
+                    .map(|row| {
+                        row.iter()
+                            .map(|cell| clone_with_slots(cell, binding, next, true))
+                            .collect()
+                    })
+                    .collect(),
+            ),
+        };
+        ASTNode::new(node_type, ast.source_token.clone())
+    }
+    let mut next = 0usize;
+    clone_with_slots(ast, binding, &mut next, false)
+}
+
 fn relocate_reference_for_offset(
     reference: &ReferenceType,
     row_delta: i64,
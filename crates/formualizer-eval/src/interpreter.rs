@@ -1,7 +1,7 @@
 use crate::{
     CellRef,
     broadcast::{broadcast_shape, project_index},
-    coercion,
+    coercion, scratch,
     traits::{ArgumentHandle, DefaultFunctionContext, EvaluationContext},
 };
 use formualizer_common::{ExcelError, ExcelErrorKind, LiteralValue};
@@ -10,59 +10,84 @@ use rustc_hash::FxHashMap;
 use std::{borrow::Cow, sync::Arc};
 
 use crate::engine::arena::ast::SheetKey;
-use crate::engine::arena::{AstNodeData, AstNodeId, CompactRefType, DataStore};
+use crate::engine::arena::{AstNodeData, AstNodeId, CompactRefType, DataStore, StringId};
+use crate::engine::const_fold::ConstantFoldSettings;
 use crate::engine::sheet_registry::SheetRegistry;
 use crate::formula_plane::template_canonical::LiteralSlotId;
 
 #[derive(Clone)]
+#[non_exhaustive]
 pub enum LocalBinding {
     Value(LiteralValue),
+    /// Owned, Arrow-backed array (e.g. a dynamic-array function result) bound
+    /// as-is; reads share the backing sheet instead of copying rows.
+    Range(crate::engine::range_view::RangeView<'static>),
     Callable(Arc<dyn crate::traits::CustomCallable>),
 }
 
+/// Lexical `LET`/`LAMBDA` environment: a flat stack of slots, innermost last.
+///
+/// Names are normalized once when bound, so a lookup is an allocation-free
+/// case-insensitive scan from the top (scopes are a handful of slots deep).
+/// The stack is shared copy-on-write: pushing onto an environment that a
+/// captured closure still holds copies the slot vector, never the bound
+/// values, which sit behind their own `Arc`.
 #[derive(Clone, Default)]
 pub struct LocalEnv {
-    head: Option<Arc<EnvFrame>>,
+    slots: Option<Arc<Vec<LocalSlot>>>,
 }
 
 #[derive(Clone)]
-struct EnvFrame {
-    parent: Option<Arc<EnvFrame>>,
-    bindings: FxHashMap<String, LocalBinding>,
+struct LocalSlot {
+    name: Arc<str>,
+    binding: Arc<LocalBinding>,
 }
 
 impl LocalEnv {
     #[inline(always)]
     pub fn is_empty(&self) -> bool {
-        self.head.is_none()
+        self.slots.is_none()
     }
 
-    fn norm(name: &str) -> String {
-        name.to_ascii_uppercase()
+    /// Normalized slot name; callers binding the same name repeatedly (lambda
+    /// parameters) normalize once and use [`LocalEnv::push_binding`].
+    pub fn slot_name(name: &str) -> Arc<str> {
+        Arc::from(name.to_ascii_uppercase())
+    }
+
+    /// Number of bound slots, shadowed ones included.
+    pub fn depth(&self) -> usize {
+        self.slots.as_ref().map_or(0, |slots| slots.len())
+    }
+
+    /// Borrow the innermost binding of `name`.
+    #[inline]
+    pub fn get(&self, name: &str) -> Option<&LocalBinding> {
+        self.slots
+            .as_ref()?
+            .iter()
+            .rev()
+            .find(|slot| slot.name.eq_ignore_ascii_case(name))
+            .map(|slot| &*slot.binding)
     }
 
     pub fn lookup(&self, name: &str) -> Option<LocalBinding> {
-        self.head.as_ref()?;
-        let key = Self::norm(name);
-        let mut cur = self.head.as_ref().cloned();
-        while let Some(frame) = cur {
-            if let Some(v) = frame.bindings.get(&key) {
-                return Some(v.clone());
-            }
-            cur = frame.parent.clone();
-        }
-        None
+        self.get(name).cloned()
     }
 
     pub fn with_binding(&self, name: &str, value: LocalBinding) -> Self {
-        let mut bindings = FxHashMap::default();
-        bindings.insert(Self::norm(name), value);
-        Self {
-            head: Some(Arc::new(EnvFrame {
-                parent: self.head.clone(),
-                bindings,
-            })),
-        }
+        let mut env = self.clone();
+        env.push_binding(Self::slot_name(name), value);
+        env
+    }
+
+    /// Bind `name` in place. Only copies the slot vector while another
+    /// environment still shares it.
+    pub fn push_binding(&mut self, name: Arc<str>, value: LocalBinding) {
+        Arc::make_mut(self.slots.get_or_insert_with(Default::default)).push(LocalSlot {
+            name,
+            binding: Arc::new(value),
+        });
     }
 }
 
@@ -190,9 +215,10 @@ impl<'a> Interpreter<'a> {
             ReferenceType::NamedRange(name) => name,
             _ => return None,
         };
-        match self.local_env.lookup(name)? {
-            LocalBinding::Value(v) => Some(crate::traits::CalcValue::Scalar(v)),
-            LocalBinding::Callable(c) => Some(crate::traits::CalcValue::Callable(c)),
+        match self.local_env.get(name)? {
+            LocalBinding::Value(v) => Some(crate::traits::CalcValue::Scalar(v.clone())),
+            LocalBinding::Range(rv) => Some(crate::traits::CalcValue::Range(rv.clone())),
+            LocalBinding::Callable(c) => Some(crate::traits::CalcValue::Callable(c.clone())),
         }
     }
 
@@ -200,9 +226,9 @@ impl<'a> Interpreter<'a> {
         if self.local_env.is_empty() {
             return None;
         }
-        match self.local_env.lookup(name)? {
-            LocalBinding::Callable(c) => Some(c),
-            LocalBinding::Value(_) => None,
+        match self.local_env.get(name)? {
+            LocalBinding::Callable(c) => Some(c.clone()),
+            LocalBinding::Value(_) | LocalBinding::Range(_) => None,
         }
     }
 
@@ -453,6 +479,20 @@ impl<'a> Interpreter<'a> {
             ExcelError::new(ExcelErrorKind::Value).with_message("Missing AST node")
         })?;
 
+        // Subtrees folded at ingest; bound literal slots may sit inside them.
+        if self.parameter_bindings.is_none()
+            && !data_store.constants().is_empty()
+            && !matches!(
+                node,
+                AstNodeData::Literal(_) | AstNodeData::Reference { .. }
+            )
+            && let Some(value) = data_store
+                .constants()
+                .get(node_id, ConstantFoldSettings::of(self.context))
+        {
+            return Ok(value);
+        }
+
         match node {
             AstNodeData::Literal(vref) => {
                 if let Some(bindings) = self.parameter_bindings
@@ -523,15 +563,8 @@ impl<'a> Interpreter<'a> {
                     return Ok(crate::traits::CalcValue::Scalar(v));
                 }
                 // For now, materialize for operators. Future: virtual range ops.
-                let v = expr.into_literal();
-                match v {
-                    LiteralValue::Array(arr) => self
-                        .map_array(arr, |cell| self.eval_unary_scalar(op, cell))
-                        .map(crate::traits::CalcValue::Scalar),
-                    other => self
-                        .eval_unary_scalar(op, other)
-                        .map(crate::traits::CalcValue::Scalar),
-                }
+                self.apply_unary_op(op, expr.into_literal())
+                    .map(crate::traits::CalcValue::Scalar)
             }
             AstNodeData::BinaryOp {
                 op_id,
@@ -563,39 +596,8 @@ impl<'a> Interpreter<'a> {
                 let right = self
                     .evaluate_arena_ast(*right_id, data_store, sheet_registry)?
                     .into_literal();
-
-                if matches!(op, "=" | "<>" | ">" | "<" | ">=" | "<=") {
-                    return self
-                        .compare(op, left, right)
-                        .map(crate::traits::CalcValue::Scalar);
-                }
-
-                match op {
-                    "+" => self
-                        .add_sub_date_aware('+', left, right)
-                        .map(crate::traits::CalcValue::Scalar),
-                    "-" => self
-                        .add_sub_date_aware('-', left, right)
-                        .map(crate::traits::CalcValue::Scalar),
-                    "*" => self
-                        .numeric_binary(left, right, |a, b| a * b)
-                        .map(crate::traits::CalcValue::Scalar),
-                    "/" => self
-                        .divide(left, right)
-                        .map(crate::traits::CalcValue::Scalar),
-                    "^" => self
-                        .power(left, right)
-                        .map(crate::traits::CalcValue::Scalar),
-                    "&" => Ok(crate::traits::CalcValue::Scalar(LiteralValue::Text(
-                        format!(
-                            "{}{}",
-                            crate::coercion::to_text_invariant(&left),
-                            crate::coercion::to_text_invariant(&right)
-                        ),
-                    ))),
-                    _ => Err(ExcelError::new(ExcelErrorKind::NImpl)
-                        .with_message(format!("Binary op '{op}'"))),
-                }
+                self.apply_binary_op(op, left, right)
+                    .map(crate::traits::CalcValue::Scalar)
             }
             AstNodeData::Array { .. } => {
                 let (rows, cols, elements) =
@@ -628,46 +630,224 @@ impl<'a> Interpreter<'a> {
                 ))
             }
             AstNodeData::Function { name_id, .. } => {
-                let name = data_store.resolve_ast_string(*name_id);
-                let args = data_store.get_args(node_id).ok_or_else(|| {
-                    ExcelError::new(ExcelErrorKind::Value).with_message("Missing function args")
-                })?;
+                self.with_shared_subexpression(node_id, data_store, || {
+                    self.evaluate_arena_function(node_id, *name_id, data_store, sheet_registry)
+                })
+            }
+        }
+    }
 
-                if let Some(fun) = self.context.get_function("", name) {
-                    let handles: Vec<ArgumentHandle> = args
-                        .iter()
-                        .copied()
-                        .map(|arg_id| {
-                            ArgumentHandle::new_arena(arg_id, self, data_store, sheet_registry)
-                        })
-                        .collect();
+    fn evaluate_arena_function(
+        &self,
+        node_id: AstNodeId,
+        name_id: StringId,
+        data_store: &DataStore,
+        sheet_registry: &SheetRegistry,
+    ) -> Result<crate::traits::CalcValue<'a>, ExcelError> {
+        let name = data_store.resolve_ast_string(name_id);
+        let args = data_store.get_args(node_id).ok_or_else(|| {
+            ExcelError::new(ExcelErrorKind::Value).with_message("Missing function args")
+        })?;
 
-                    let fctx = DefaultFunctionContext::new_with_sheet(
-                        self.context,
-                        self.current_cell,
-                        self.current_sheet,
-                    );
+        if let Some(fun) = self.context.get_function("", name) {
+            return self.dispatch_arena_function(&fun, args, data_store, sheet_registry);
+        }
 
-                    return fun.dispatch(&handles, &fctx);
-                }
+        if let Some(callable) = self.resolve_local_callable(name) {
+            let mut eval_args = Vec::with_capacity(args.len());
+            for arg_id in args {
+                eval_args.push(
+                    self.evaluate_arena_ast(*arg_id, data_store, sheet_registry)?
+                        .into_literal(),
+                );
+            }
+            return callable.invoke(self, &eval_args);
+        }
 
-                if let Some(callable) = self.resolve_local_callable(name) {
-                    let mut eval_args = Vec::with_capacity(args.len());
-                    for arg_id in args {
-                        eval_args.push(
-                            self.evaluate_arena_ast(*arg_id, data_store, sheet_registry)?
-                                .into_literal(),
-                        );
-                    }
-                    return callable.invoke(self, &eval_args);
+        Err(ExcelError::new(ExcelErrorKind::Name).with_message(format!("Unknown function: {name}")))
+    }
+
+    /// Call `fun` on the arena arguments `args`, through the engine's
+    /// pure-call memo when it is enabled and the call qualifies. Only plain
+    /// formula evaluations take part, and only scalar results are cached.
+    pub(crate) fn dispatch_arena_function(
+        &self,
+        fun: &Arc<dyn crate::function::Function>,
+        args: &[AstNodeId],
+        data_store: &DataStore,
+        sheet_registry: &SheetRegistry,
+    ) -> Result<crate::traits::CalcValue<'a>, ExcelError> {
+        let handles: Vec<ArgumentHandle> = args
+            .iter()
+            .copied()
+            .map(|arg_id| ArgumentHandle::new_arena(arg_id, self, data_store, sheet_registry))
+            .collect();
+        let fctx = DefaultFunctionContext::new_with_sheet(
+            self.context,
+            self.current_cell,
+            self.current_sheet,
+        );
+
+        let memo = match self.context.pure_call_memo() {
+            Some(memo)
+                if !args.is_empty()
+                    && self.is_plain_formula_context()
+                    && crate::engine::pure_memo::is_memoizable(fun.caps()) =>
+            {
+                memo
+            }
+            _ => return fun.dispatch(&handles, &fctx),
+        };
+        let Some(key) = self.pure_call_key(fun, args, &handles, data_store) else {
+            return fun.dispatch(&handles, &fctx);
+        };
+        let snapshot = self.context.data_snapshot_id();
+        if let Some(value) = memo.get(&key, snapshot) {
+            return Ok(crate::traits::CalcValue::Scalar(value));
+        }
+        let value = fun.dispatch(&handles, &fctx)?;
+        if let crate::traits::CalcValue::Scalar(v) = &value {
+            memo.insert(key, snapshot, v.clone());
+        }
+        Ok(value)
+    }
+
+    /// Memo key for a call, or `None` when an argument has no stable value
+    /// identity (a name, a computed range, a callable, an evaluation error).
+    /// Value arguments are evaluated through their handles, which keep the
+    /// result for the call itself.
+    fn pure_call_key(
+        &self,
+        fun: &Arc<dyn crate::function::Function>,
+        args: &[AstNodeId],
+        handles: &[ArgumentHandle<'_, 'a>],
+        data_store: &DataStore,
+    ) -> Option<crate::engine::pure_memo::MemoKey> {
+        use crate::engine::pure_memo::{MemoArg, MemoKey};
+        let mut key_args = Vec::with_capacity(args.len());
+        for (index, (&arg, handle)) in args.iter().zip(handles).enumerate() {
+            let key_arg = match data_store.get_node(arg)? {
+                AstNodeData::Literal(_) => MemoArg::Constant(arg),
+                AstNodeData::Array { .. }
+                    if data_store
+                        .get_array_elems(arg)
+                        .is_some_and(|(_, _, elems)| {
+                            elems.iter().all(|&elem| {
+                                matches!(data_store.get_node(elem), Some(AstNodeData::Literal(_)))
+                            })
+                        }) =>
+                {
+                    MemoArg::Constant(arg)
                 }
+                AstNodeData::Reference { ref_type, .. } => match ref_type {
+                    CompactRefType::Cell { .. }
+                        if crate::engine::pure_memo::reads_scalar_value(fun.as_ref(), index) =>
+                    {
+                        match handle.value() {
+                            Ok(crate::traits::CalcValue::Scalar(v)) => MemoArg::Value(v),
+                            _ => return None,
+                        }
+                    }
+                    CompactRefType::Cell { .. }
+                    | CompactRefType::Cell3D { .. }
+                    | CompactRefType::Range { .. }
+                    | CompactRefType::Range3D { .. } => MemoArg::Reference(arg),
+                    _ => return None,
+                },
+                _ => match handle.value() {
+                    Ok(crate::traits::CalcValue::Scalar(v)) => MemoArg::Value(v),
+                    _ => return None,
+                },
+            };
+            key_args.push(key_arg);
+        }
+        let function = Arc::as_ptr(fun) as *const () as usize;
+        Some(MemoKey::new(function, self.current_sheet, key_args))
+    }
 
-                Err(ExcelError::new(ExcelErrorKind::Name)
-                    .with_message(format!("Unknown function: {name}")))
+    /// Evaluate `node_id` through the workbook's shared-subexpression cache
+    /// when ingest found it shared; `eval` computes it on a miss. Only plain
+    /// formula evaluations take part, and only scalar results are cached.
+    pub(crate) fn with_shared_subexpression(
+        &self,
+        node_id: AstNodeId,
+        data_store: &DataStore,
+        eval: impl FnOnce() -> Result<crate::traits::CalcValue<'a>, ExcelError>,
+    ) -> Result<crate::traits::CalcValue<'a>, ExcelError> {
+        let Some(cache) = self.context.shared_subexpressions() else {
+            return eval();
+        };
+        if !self.is_plain_formula_context() || !data_store.subexpressions().is_shared(node_id) {
+            return eval();
+        }
+        let snapshot = self.context.data_snapshot_id();
+        if let Some(value) = cache.get(node_id, self.current_sheet, snapshot) {
+            return Ok(crate::traits::CalcValue::Scalar(value));
+        }
+        let value = eval()?;
+        if let crate::traits::CalcValue::Scalar(v) = &value {
+            cache.insert(node_id, self.current_sheet, snapshot, v.clone());
+        }
+        Ok(value)
+    }
+
+    /// Apply a value-context unary operator (not `@`) to an evaluated operand,
+    /// mapping element-wise over arrays.
+    pub(crate) fn apply_unary_op(
+        &self,
+        op: &str,
+        v: LiteralValue,
+    ) -> Result<LiteralValue, ExcelError> {
+        match v {
+            LiteralValue::Array(arr) => {
+                self.map_array(arr, |cell| self.eval_unary_scalar(op, cell))
+            }
+            other => self.eval_unary_scalar(op, other),
+        }
+    }
+
+    /// Apply a value-context binary operator (not `:`) to evaluated operands.
+    pub(crate) fn apply_binary_op(
+        &self,
+        op: &str,
+        left: LiteralValue,
+        right: LiteralValue,
+    ) -> Result<LiteralValue, ExcelError> {
+        if matches!(op, "=" | "<>" | ">" | "<" | ">=" | "<=") {
+            return self.compare(op, left, right);
+        }
+        match op {
+            "+" => self.add_sub_date_aware('+', left, right),
+            "-" => self.add_sub_date_aware('-', left, right),
+            "*" => self.numeric_binary(left, right, |a, b| a * b),
+            "/" => self.divide(left, right),
+            "^" => self.power(left, right),
+            "&" => Ok(LiteralValue::Text(format!(
+                "{}{}",
+                crate::coercion::to_text_invariant(&left),
+                crate::coercion::to_text_invariant(&right)
+            ))),
+            _ => {
+                Err(ExcelError::new(ExcelErrorKind::NImpl)
+                    .with_message(format!("Binary op '{op}'")))
             }
         }
     }
 
+    /// True when this interpreter evaluates a formula exactly as stored: no
+    /// reference offset, LET/LAMBDA bindings, or template parameter slots.
+    /// Only such evaluations may run through the bytecode VM.
+    pub(crate) fn is_plain_formula_context(&self) -> bool {
+        self.local_env.is_empty()
+            && self.parameter_bindings.is_none()
+            && self.reference_row_delta == 0
+            && self.reference_col_delta == 0
+    }
+
+    pub(crate) fn current_cell(&self) -> Option<crate::CellRef> {
+        self.current_cell
+    }
+
     fn evaluate_ast_uncached(
         &self,
         node: &ASTNode,
@@ -1398,22 +1578,46 @@ impl<'a> Interpreter<'a> {
         })
     }
 
-    fn map_array<F>(&self, arr: Vec<Vec<LiteralValue>>, f: F) -> Result<LiteralValue, ExcelError>
+    fn map_array<F>(
+        &self,
+        mut arr: Vec<Vec<LiteralValue>>,
+        f: F,
+    ) -> Result<LiteralValue, ExcelError>
     where
         F: Fn(LiteralValue) -> Result<LiteralValue, ExcelError> + Copy,
     {
-        let mut out = Vec::with_capacity(arr.len());
-        for row in arr {
-            let mut new_row = Vec::with_capacity(row.len());
-            for cell in row {
-                new_row.push(match f(cell) {
-                    Ok(v) => v,
-                    Err(e) => LiteralValue::Error(e),
-                });
+        // The operand is owned and the result has its shape: map in place.
+        for row in &mut arr {
+            for cell in row.iter_mut() {
+                let value = std::mem::replace(cell, LiteralValue::Empty);
+                *cell = f(value).unwrap_or_else(LiteralValue::Error);
             }
-            out.push(new_row);
         }
-        Ok(LiteralValue::Array(out))
+        scratch::note_array_reuse();
+        Ok(LiteralValue::Array(arr))
+    }
+
+    /// Rewrite `own` cell by cell with `g(i, j, cell)` when it is already a
+    /// rectangle of the broadcast `target` shape; hands `own` back otherwise.
+    fn rewrite_in_place<G>(
+        mut own: Vec<Vec<LiteralValue>>,
+        target: (usize, usize),
+        g: G,
+    ) -> Result<LiteralValue, Vec<Vec<LiteralValue>>>
+    where
+        G: Fn(usize, usize, LiteralValue) -> Result<LiteralValue, ExcelError>,
+    {
+        if own.len() != target.0 || own.iter().any(|row| row.len() != target.1) {
+            return Err(own);
+        }
+        for (i, row) in own.iter_mut().enumerate() {
+            for (j, cell) in row.iter_mut().enumerate() {
+                let value = std::mem::replace(cell, LiteralValue::Empty);
+                *cell = g(i, j, value).unwrap_or_else(LiteralValue::Error);
+            }
+        }
+        scratch::note_array_reuse();
+        Ok(LiteralValue::Array(own))
     }
 
     fn combine_arrays<F>(
@@ -1432,7 +1636,25 @@ impl<'a> Interpreter<'a> {
             Ok(s) => s,
             Err(e) => return Ok(LiteralValue::Error(e)),
         };
+        let project = |arr: &[Vec<LiteralValue>], shape, i, j| {
+            let (pi, pj) = project_index((i, j), shape);
+            arr.get(pi)
+                .and_then(|r| r.get(pj))
+                .cloned()
+                .unwrap_or(LiteralValue::Empty)
+        };
+        let l =
+            match Self::rewrite_in_place(l, target, |i, j, lv| f(lv, project(&r, r_shape, i, j))) {
+                Ok(out) => return Ok(out),
+                Err(l) => l,
+            };
+        let r =
+            match Self::rewrite_in_place(r, target, |i, j, rv| f(project(&l, l_shape, i, j), rv)) {
+                Ok(out) => return Ok(out),
+                Err(r) => r,
+            };
 
+        scratch::note_array_alloc(target.0.saturating_mul(target.1));
         let mut out = Vec::with_capacity(target.0);
         for i in 0..target.0 {
             let mut row = Vec::with_capacity(target.1);
@@ -1478,6 +1700,11 @@ impl<'a> Interpreter<'a> {
                     Ok(s) => s,
                     Err(e) => return Ok(LiteralValue::Error(e)),
                 };
+                let arr = match Self::rewrite_in_place(arr, target, |_, _, lv| f(lv, v.clone())) {
+                    Ok(out) => return Ok(out),
+                    Err(arr) => arr,
+                };
+                scratch::note_array_alloc(target.0.saturating_mul(target.1));
                 let mut out = Vec::with_capacity(target.0);
                 for i in 0..target.0 {
                     let mut row = Vec::with_capacity(target.1);
@@ -1504,6 +1731,11 @@ impl<'a> Interpreter<'a> {
                     Ok(s) => s,
                     Err(e) => return Ok(LiteralValue::Error(e)),
                 };
+                let arr = match Self::rewrite_in_place(arr, target, |_, _, rv| f(v.clone(), rv)) {
+                    Ok(out) => return Ok(out),
+                    Err(arr) => arr,
+                };
+                scratch::note_array_alloc(target.0.saturating_mul(target.1));
                 let mut out = Vec::with_capacity(target.0);
                 for i in 0..target.0 {
                     let mut row = Vec::with_capacity(target.1);
@@ -2,6 +2,7 @@
 
 pub mod args;
 pub mod broadcast;
+pub mod bytecode;
 pub mod coercion;
 pub mod error_policy;
 pub mod formula_plane;
@@ -12,6 +13,7 @@ pub mod instant;
 pub mod interpreter;
 pub mod locale;
 pub mod rng;
+pub mod scratch;
 pub mod stripes;
 pub mod timezone;
 pub mod traits;
@@ -0,0 +1,184 @@
+//! Per-thread scratch arena for evaluation temporaries.
+//!
+//! Builtins that gather a temporary buffer only to reduce it to a scalar
+//! (order statistics, percentiles) borrow it from a thread-local
+//! [`bumpalo::Bump`] through [`with_scratch`] instead of the global heap. The
+//! engine resets the arena after each vertex evaluation ([`end_vertex`]), so
+//! steady-state recalculation reuses the same chunk. Nothing allocated in the
+//! arena can escape the closure that borrowed it.
+//!
+//! The same thread-local counters record how often the interpreter had to
+//! allocate a fresh array result versus rewriting an operand array in place,
+//! which the engine folds into [`EvalAllocationStats`].
+
+use std::cell::{Cell, RefCell};
+use std::sync::atomic::{AtomicU64, Ordering};
+
+use bumpalo::Bump;
+
+/// Arena capacity kept across resets; a thread that needed more for one
+/// vertex gives the excess back instead of holding it for the session.
+const SCRATCH_RETAIN_BYTES: usize = 4 << 20;
+
+thread_local! {
+    static SCRATCH: RefCell<Bump> = RefCell::new(Bump::new());
+    static SCRATCH_DEPTH: Cell<u32> = const { Cell::new(0) };
+    static USAGE: Cell<ScratchUsage> = const { Cell::new(ScratchUsage::ZERO) };
+}
+
+/// Allocation activity on one thread since the last [`end_vertex`].
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub(crate) struct ScratchUsage {
+    /// Outermost [`with_scratch`] scopes entered.
+    pub(crate) arena_scopes: u64,
+    /// Arena chunk capacity in bytes at the last reset.
+    pub(crate) arena_bytes: u64,
+    /// Array results the interpreter allocated afresh.
+    pub(crate) heap_arrays: u64,
+    /// Cells in those freshly allocated arrays.
+    pub(crate) heap_array_cells: u64,
+    /// Array results written over an operand array the interpreter owned.
+    pub(crate) reused_arrays: u64,
+}
+
+impl ScratchUsage {
+    const ZERO: ScratchUsage = ScratchUsage {
+        arena_scopes: 0,
+        arena_bytes: 0,
+        heap_arrays: 0,
+        heap_array_cells: 0,
+        reused_arrays: 0,
+    };
+}
+
+fn update_usage(f: impl FnOnce(&mut ScratchUsage)) {
+    USAGE.with(|usage| {
+        let mut current = usage.get();
+        f(&mut current);
+        usage.set(current);
+    });
+}
+
+/// Run `f` with this thread's scratch arena. Scopes nest; the arena is only
+/// reclaimed once no scope is active.
+pub(crate) fn with_scratch<R>(f: impl FnOnce(&Bump) -> R) -> R {
+    let depth = SCRATCH_DEPTH.with(|depth| {
+        let outer = depth.get();
+        depth.set(outer + 1);
+        outer
+    });
+    if depth == 0 {
+        update_usage(|usage| usage.arena_scopes += 1);
+    }
+    struct Exit;
+    impl Drop for Exit {
+        fn drop(&mut self) {
+            SCRATCH_DEPTH.with(|depth| depth.set(depth.get().saturating_sub(1)));
+        }
+    }
+    let _exit = Exit;
+    let result = SCRATCH.with(|scratch| f(&scratch.borrow()));
+    // Callers evaluated outside the engine never reach `end_vertex`; keep
+    // their arena from growing without bound.
+    if depth == 0 {
+        SCRATCH.with(|scratch| {
+            if let Ok(mut bump) = scratch.try_borrow_mut()
+                && bump.allocated_bytes() > SCRATCH_RETAIN_BYTES
+            {
+                *bump = Bump::new();
+            }
+        });
+    }
+    result
+}
+
+/// Record an interpreter array result built in a new allocation.
+#[inline]
+pub(crate) fn note_array_alloc(cells: usize) {
+    update_usage(|usage| {
+        usage.heap_arrays += 1;
+        usage.heap_array_cells += cells as u64;
+    });
+}
+
+/// Record an interpreter array result written over an owned operand.
+#[inline]
+pub(crate) fn note_array_reuse() {
+    update_usage(|usage| usage.reused_arrays += 1);
+}
+
+/// Reset this thread's arena at the end of a vertex evaluation and return the
+/// allocation activity recorded since the previous call.
+pub(crate) fn end_vertex() -> ScratchUsage {
+    let mut usage = USAGE.with(|usage| usage.replace(ScratchUsage::ZERO));
+    if SCRATCH_DEPTH.with(Cell::get) == 0 {
+        SCRATCH.with(|scratch| {
+            if let Ok(mut bump) = scratch.try_borrow_mut() {
+                usage.arena_bytes = bump.allocated_bytes() as u64;
+                if bump.allocated_bytes() > SCRATCH_RETAIN_BYTES {
+                    *bump = Bump::new();
+                } else {
+                    bump.reset();
+                }
+            }
+        });
+    }
+    usage
+}
+
+/// Interpreter allocation counters (see `Engine::eval_allocation_stats`).
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct EvalAllocationStats {
+    /// Vertex evaluations after which a scratch arena was reset.
+    pub vertices: u64,
+    /// Temporary buffers served from the scratch arena instead of the heap.
+    pub arena_scopes: u64,
+    /// Largest scratch arena capacity seen at a reset, in bytes.
+    pub arena_peak_bytes: u64,
+    /// Array results allocated afresh by the interpreter.
+    pub heap_arrays: u64,
+    /// Cells in those arrays.
+    pub heap_array_cells: u64,
+    /// Array results written in place over an operand array.
+    pub reused_arrays: u64,
+}
+
+/// Engine-lifetime accumulation of per-vertex [`ScratchUsage`].
+#[derive(Debug, Default)]
+pub(crate) struct AllocationCounters {
+    vertices: AtomicU64,
+    arena_scopes: AtomicU64,
+    arena_peak_bytes: AtomicU64,
+    heap_arrays: AtomicU64,
+    heap_array_cells: AtomicU64,
+    reused_arrays: AtomicU64,
+}
+
+impl AllocationCounters {
+    /// Reset the calling thread's arena and fold its usage in.
+    pub(crate) fn end_vertex(&self) {
+        let usage = end_vertex();
+        self.vertices.fetch_add(1, Ordering::Relaxed);
+        self.arena_scopes
+            .fetch_add(usage.arena_scopes, Ordering::Relaxed);
+        self.arena_peak_bytes
+            .fetch_max(usage.arena_bytes, Ordering::Relaxed);
+        self.heap_arrays
+            .fetch_add(usage.heap_arrays, Ordering::Relaxed);
+        self.heap_array_cells
+            .fetch_add(usage.heap_array_cells, Ordering::Relaxed);
+        self.reused_arrays
+            .fetch_add(usage.reused_arrays, Ordering::Relaxed);
+    }
+
+    pub(crate) fn stats(&self) -> EvalAllocationStats {
+        EvalAllocationStats {
+            vertices: self.vertices.load(Ordering::Relaxed),
+            arena_scopes: self.arena_scopes.load(Ordering::Relaxed),
+            arena_peak_bytes: self.arena_peak_bytes.load(Ordering::Relaxed),
+            heap_arrays: self.heap_arrays.load(Ordering::Relaxed),
+            heap_array_cells: self.heap_array_cells.load(Ordering::Relaxed),
+            reused_arrays: self.reused_arrays.load(Ordering::Relaxed),
+        }
+    }
+}
@@ -11,6 +11,7 @@ use formualizer_common::{
 use std::any::Any;
 use std::borrow::Cow;
 use std::fmt::Debug;
+use std::ops::ControlFlow;
 use std::sync::Arc;
 
 use formualizer_parse::parser::{ASTNode, ASTNodeType, ReferenceType, TableSpecifier};
@@ -569,6 +570,7 @@ impl<'a, 'b> ArgumentHandle<'a, 'b> {
                         out.push(row_data);
                         Ok(())
                     })?;
+                    self.note_materialized_cells(rows * cols);
                     Ok(Box::new(InMemoryRange::new(out)))
                 }
                 ASTNodeType::Function { .. } | ASTNodeType::BinaryOp { .. } => {
@@ -586,6 +588,7 @@ impl<'a, 'b> ArgumentHandle<'a, 'b> {
                         out.push(row_data);
                         Ok(())
                     })?;
+                    self.note_materialized_cells(rows * cols);
                     Ok(Box::new(InMemoryRange::new(out)))
                 }
                 ASTNodeType::Array(rows) => {
@@ -625,6 +628,7 @@ impl<'a, 'b> ArgumentHandle<'a, 'b> {
                             out.push(row_data);
                             Ok(())
                         })?;
+                        self.note_materialized_cells(rows * cols);
                         Ok(Box::new(InMemoryRange::new(out)))
                     }
                     crate::engine::arena::AstNodeData::Array { .. } => {
@@ -727,6 +731,7 @@ impl<'a, 'b> ArgumentHandle<'a, 'b> {
                         values.push(v.clone());
                         Ok(())
                     })?;
+                    self.note_materialized_cells(values.len());
                     Ok(Box::new(values.into_iter()))
                 }
                 ASTNodeType::Array(rows) => {
@@ -794,6 +799,7 @@ impl<'a, 'b> ArgumentHandle<'a, 'b> {
                             values.push(v.clone());
                             Ok(())
                         })?;
+                        self.note_materialized_cells(values.len());
                         Ok(Box::new(values.into_iter()))
                     }
                     crate::engine::arena::AstNodeData::Array { .. } => {
@@ -848,6 +854,40 @@ impl<'a, 'b> ArgumentHandle<'a, 'b> {
         }
     }
 
+    /// Visit this argument's values in the order of [`Self::lazy_values_owned`]
+    /// without first copying a referenced range into owned values. The
+    /// visitor may stop early; the return value says whether it did.
+    pub fn for_each_value(
+        &'a self,
+        f: &mut dyn FnMut(&LiteralValue) -> ControlFlow<()>,
+    ) -> Result<ControlFlow<()>, ExcelError> {
+        let is_reference = match &self.expr {
+            ArgumentExpr::Ast(node) => matches!(node.node_type, ASTNodeType::Reference { .. }),
+            ArgumentExpr::Arena { id, data_store, .. } => matches!(
+                data_store.get_node(*id),
+                Some(crate::engine::arena::AstNodeData::Reference { .. })
+            ),
+        };
+        if is_reference {
+            return self.range_view()?.try_for_each_cell(f);
+        }
+        for value in self.lazy_values_owned()? {
+            if f(&value).is_break() {
+                return Ok(ControlFlow::Break(()));
+            }
+        }
+        Ok(ControlFlow::Continue(()))
+    }
+
+    /// Count range cells copied into owned values by the legacy
+    /// [`Self::range`] and [`Self::lazy_values_owned`] paths. Only handles
+    /// over arena formulas have a store to report to.
+    fn note_materialized_cells(&self, cells: usize) {
+        if let ArgumentExpr::Arena { data_store, .. } = &self.expr {
+            data_store.note_materialized_cells(cells);
+        }
+    }
+
     pub fn ast(&self) -> &ASTNode {
         match &self.expr {
             ArgumentExpr::Ast(node) => node,
@@ -928,7 +968,7 @@ impl<'a, 'b> ArgumentHandle<'a, 'b> {
     pub fn matches_kind(&self, k: formualizer_common::ArgKind) -> Result<bool, ExcelError> {
         Ok(match k {
             formualizer_common::ArgKind::Any => true,
-            formualizer_common::ArgKind::Range => self.range().is_ok(),
+            formualizer_common::ArgKind::Range => self.range_view().is_ok(),
             formualizer_common::ArgKind::Number => matches!(
                 self.value()?.into_literal(),
                 LiteralValue::Number(_) | LiteralValue::Int(_)
@@ -1449,6 +1489,20 @@ pub trait EvaluationContext: Resolver + FunctionProvider + SourceResolver {
         0
     }
 
+    /// Optional: per-pass cache for workbook-wide shared subexpressions (see
+    /// [`crate::engine::cse`]). Wrapping contexts that record reads must keep
+    /// the default `None` so cached values never hide a read.
+    fn shared_subexpressions(&self) -> Option<&crate::engine::cse::SharedSubexpressionCache> {
+        None
+    }
+
+    /// Optional: memo of pure function call results (see
+    /// [`crate::engine::pure_memo`]). Same restriction as
+    /// [`Self::shared_subexpressions`]: wrapping contexts keep `None`.
+    fn pure_call_memo(&self) -> Option<&crate::engine::pure_memo::PureCallMemo> {
+        None
+    }
+
     /// Backend capability advertisement for IO/adapters.
     fn backend_caps(&self) -> BackendCaps {
         BackendCaps::default()
@@ -1218,6 +1218,169 @@ impl Workbook {
         Ok(bytes)
     }
 
+    /// Write the workbook to a snapshot file at `path` that [`Workbook::open_snapshot`] can
+    /// map back without re-parsing a spreadsheet.
+    ///
+    /// The snapshot holds cell values (pending edits folded in), the formula AST arena
+    /// (one template per copied-down formula plus a placement per cell), and defined
+    /// names. Tables, row visibility, custom functions and load-time calc settings are
+    /// not included.
+    #[cfg(not(target_arch = "wasm32"))]
+    pub fn save_snapshot(&self, path: impl AsRef<std::path::Path>) -> Result<(), IoError> {
+        use formualizer_eval::arrow_store::snapshot::{
+            SnapshotName, SnapshotNameTarget, write_snapshot,
+        };
+
+        let formulas = self.engine.formula_snapshot().map_err(IoError::Engine)?;
+
+        let mut names = Vec::new();
+        for entry in self.engine.named_ranges_snapshot() {
+            let target = match &entry.definition {
+                NamedDefinition::Literal(value) => SnapshotNameTarget::Literal(value.clone()),
+                NamedDefinition::Formula { ast, .. } => {
+                    SnapshotNameTarget::Formula(formualizer_parse::pretty::canonical_formula(ast))
+                }
+                definition => {
+                    let Some(address) = self.named_definition_to_address(definition) else {
+                        continue;
+                    };
+                    SnapshotNameTarget::Range {
+                        sheet: address.sheet,
+                        start_row: address.start_row,
+                        start_col: address.start_col,
+                        end_row: address.end_row,
+                        end_col: address.end_col,
+                    }
+                }
+            };
+            let scope_sheet = match entry.scope {
+                NameScope::Workbook => None,
+                NameScope::Sheet(id) => Some(self.engine.sheet_name(id).to_string()),
+            };
+            names.push(SnapshotName {
+                name: entry.name,
+                scope_sheet,
+                target,
+            });
+        }
+
+        write_snapshot(
+            path.as_ref(),
+            self.engine.sheet_store(),
+            self.engine.config.date_system,
+            &formulas,
+            &names,
+        )
+        .map_err(|e| IoError::from_backend("snapshot", e))
+    }
+
+    /// Open a workbook from a snapshot written by [`Workbook::save_snapshot`].
+    ///
+    /// Cell lanes are read in place from a memory mapping of the file, so loading values
+    /// costs time proportional to the number of chunks rather than cells. Formulas are
+    /// rebuilt from the stored arena without parsing, but each one still goes through
+    /// dependency-graph ingest, so that part of opening scales with the formula count.
+    /// The snapshot's date system overrides `config.eval.date_system`.
+    #[cfg(not(target_arch = "wasm32"))]
+    pub fn open_snapshot(
+        path: impl AsRef<std::path::Path>,
+        mut config: WorkbookConfig,
+    ) -> Result<Self, IoError> {
+        use formualizer_eval::arrow_store::snapshot::{SnapshotNameTarget, read_snapshot};
+        use formualizer_eval::reference::{CellRef, Coord, RangeRef};
+
+        let snapshot =
+            read_snapshot(path.as_ref()).map_err(|e| IoError::from_backend("snapshot", e))?;
+        config.eval.date_system = snapshot.date_system;
+        let mut wb = Self::new_with_config(config);
+        let engine = &mut wb.engine;
+
+        let sheet_names: Vec<String> = snapshot
+            .sheets
+            .iter()
+            .map(|s| s.name.as_ref().to_string())
+            .collect();
+        for sheet in snapshot.sheets {
+            engine.add_sheet(&sheet.name).map_err(IoError::Engine)?;
+            let store = engine.sheet_store_mut();
+            if let Some(pos) = store.sheets.iter().position(|s| s.name == sheet.name) {
+                store.sheets[pos] = sheet;
+            } else {
+                store.sheets.push(sheet);
+            }
+        }
+
+        let prev_index_mode = engine.config.sheet_index_mode;
+        engine.set_sheet_index_mode(formualizer_eval::engine::SheetIndexMode::Lazy);
+        let prev_range_limit = engine.config.range_expansion_limit;
+        engine.config.range_expansion_limit = 0;
+        engine.set_first_load_assume_new(true);
+        engine.reset_ensure_touched();
+
+        let sheet_id = |engine: &formualizer_eval::engine::Engine<WBResolver>, sheet: &str| {
+            engine.sheet_id(sheet).ok_or_else(|| IoError::Backend {
+                backend: "snapshot".to_string(),
+                message: format!("sheet not found: {sheet}"),
+            })
+        };
+
+        // Names go in before formulas so ingest-time name resolution sees them.
+        for name in snapshot.names {
+            let scope = match &name.scope_sheet {
+                Some(sheet) => NameScope::Sheet(sheet_id(engine, sheet)?),
+                None => NameScope::Workbook,
+            };
+            let definition = match name.target {
+                SnapshotNameTarget::Range {
+                    sheet,
+                    start_row,
+                    start_col,
+                    end_row,
+                    end_col,
+                } => {
+                    let id = sheet_id(engine, &sheet)?;
+                    let cell = |row: u32, col: u32| {
+                        CellRef::new(
+                            id,
+                            Coord::new(row.saturating_sub(1), col.saturating_sub(1), true, true),
+                        )
+                    };
+                    if start_row == end_row && start_col == end_col {
+                        NamedDefinition::Cell(cell(start_row, start_col))
+                    } else {
+                        NamedDefinition::Range(RangeRef::new(
+                            cell(start_row, start_col),
+                            cell(end_row, end_col),
+                        ))
+                    }
+                }
+                SnapshotNameTarget::Literal(value) => NamedDefinition::Literal(value),
+                SnapshotNameTarget::Formula(text) => NamedDefinition::Formula {
+                    ast: formualizer_parse::parser::parse(&text)
+                        .map_err(|e| IoError::from_backend("snapshot", e))?,
+                    dependencies: Vec::new(),
+                    range_deps: Vec::new(),
+                },
+            };
+            engine
+                .define_name(&name.name, definition, scope)
+                .map_err(IoError::Engine)?;
+        }
+
+        engine
+            .ingest_formula_snapshot(&snapshot.formulas)
+            .map_err(IoError::Engine)?;
+
+        for sheet in &sheet_names {
+            engine.finalize_sheet_index(sheet);
+        }
+        engine.set_first_load_assume_new(false);
+        engine.reset_ensure_touched();
+        engine.set_sheet_index_mode(prev_index_mode);
+        engine.config.range_expansion_limit = prev_range_limit;
+        Ok(wb)
+    }
+
     pub fn register_custom_function(
         &mut self,
         name: &str,
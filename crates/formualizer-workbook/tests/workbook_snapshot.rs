@@ -0,0 +1,264 @@
+use formualizer_common::{LiteralValue, RangeAddress};
+use formualizer_eval::arrow_store::snapshot::{SnapshotAstNode, read_snapshot};
+use formualizer_eval::engine::named_range::{NameScope, NamedDefinition};
+use formualizer_eval::engine::{DateSystem, FormulaPlaneMode};
+use formualizer_workbook::{Workbook, WorkbookConfig, traits::NamedRangeScope};
+
+fn number(value: Option<LiteralValue>) -> f64 {
+    match value {
+        Some(LiteralValue::Number(n)) => n,
+        Some(LiteralValue::Int(i)) => i as f64,
+        other => panic!("expected a number, got {other:?}"),
+    }
+}
+
+#[test]
+fn snapshot_round_trips_values_formulas_and_names() {
+    let mut wb = Workbook::new();
+    wb.add_sheet("Data").unwrap();
+    wb.add_sheet("Calc").unwrap();
+    let rows: Vec<Vec<LiteralValue>> = (1..=2000)
+        .map(|i| {
+            vec![
+                LiteralValue::Number(i as f64),
+                LiteralValue::Text(["north", "south", "east"][i % 3].into()),
+                LiteralValue::Boolean(i % 2 == 0),
+            ]
+        })
+        .collect();
+    wb.set_values("Data", 1, 1, &rows).unwrap();
+    let inputs = RangeAddress::new("Data", 1, 1, 2000, 1).unwrap();
+    wb.define_named_range("Inputs", &inputs, NamedRangeScope::Workbook)
+        .unwrap();
+    wb.engine_mut()
+        .define_name(
+            "Rate",
+            NamedDefinition::Literal(LiteralValue::Number(0.5)),
+            NameScope::Workbook,
+        )
+        .unwrap();
+    wb.set_formula("Calc", 1, 1, "=SUM(Inputs)*Rate").unwrap();
+    wb.set_formula("Calc", 2, 1, "=COUNTIF(Data!B1:B2000,\"north\")")
+        .unwrap();
+    wb.evaluate_all().unwrap();
+    // An edit that is still sitting in an overlay when the snapshot is taken.
+    wb.set_value("Data", 1, 1, LiteralValue::Number(1001.0))
+        .unwrap();
+
+    let dir = tempfile::tempdir().unwrap();
+    let path = dir.path().join("book.fzsnap");
+    wb.save_snapshot(&path).unwrap();
+
+    let mut opened = Workbook::open_snapshot(&path, WorkbookConfig::interactive()).unwrap();
+    assert_eq!(opened.sheet_names(), vec!["Data", "Calc"]);
+    assert_eq!(opened.sheet_dimensions("Data"), Some((2000, 3)));
+    assert_eq!(number(opened.get_value("Data", 1, 1)), 1001.0);
+    assert_eq!(number(opened.get_value("Data", 1500, 1)), 1500.0);
+    assert_eq!(
+        opened.get_value("Data", 4, 2),
+        Some(LiteralValue::Text("south".into()))
+    );
+    assert_eq!(
+        opened.get_value("Data", 4, 3),
+        Some(LiteralValue::Boolean(true))
+    );
+    assert_eq!(
+        opened.get_formula("Calc", 1, 1),
+        wb.get_formula("Calc", 1, 1)
+    );
+    assert_eq!(opened.named_range_address("Inputs"), Some(inputs));
+    assert_eq!(
+        opened.resolved_name_value("Rate", None),
+        Some(LiteralValue::Number(0.5))
+    );
+
+    opened.evaluate_all().unwrap();
+    let expected = (2000.0 * 2001.0 / 2.0 + 1000.0) * 0.5;
+    assert_eq!(number(opened.get_value("Calc", 1, 1)), expected);
+    assert_eq!(number(opened.get_value("Calc", 2, 1)), 666.0);
+
+    // Edits after opening land in overlays over the mapped lanes.
+    opened
+        .set_value("Data", 2, 1, LiteralValue::Number(0.0))
+        .unwrap();
+    opened.evaluate_all().unwrap();
+    assert_eq!(number(opened.get_value("Calc", 1, 1)), expected - 1.0);
+}
+
+#[test]
+fn snapshot_stores_copied_formulas_as_arena_nodes() {
+    for mode in [
+        FormulaPlaneMode::Off,
+        FormulaPlaneMode::AuthoritativeExperimental,
+    ] {
+        let config = WorkbookConfig::interactive().with_formula_plane_mode(mode);
+        let mut wb = Workbook::new_with_config(config);
+        wb.add_sheet("S").unwrap();
+        let values: Vec<Vec<LiteralValue>> = (1..=300)
+            .map(|i| vec![LiteralValue::Number(i as f64)])
+            .collect();
+        wb.set_values("S", 1, 1, &values).unwrap();
+        let formulas: Vec<Vec<String>> = (1..=300)
+            .map(|i| vec![format!("=A{i}*2+$A$1"), format!("=SUM($A$1:A{i})")])
+            .collect();
+        wb.set_formulas("S", 1, 2, &formulas).unwrap();
+        wb.evaluate_all().unwrap();
+
+        let dir = tempfile::tempdir().unwrap();
+        let path = dir.path().join("copied.fzsnap");
+        wb.save_snapshot(&path).unwrap();
+
+        let snapshot = read_snapshot(&path).unwrap();
+        assert_eq!(snapshot.formulas.sheets.len(), 1, "{mode:?}");
+        assert_eq!(snapshot.formulas.sheets[0].cells.len(), 600, "{mode:?}");
+        assert!(
+            !snapshot
+                .formulas
+                .nodes
+                .iter()
+                .any(|node| matches!(node, SnapshotAstNode::Text(_))),
+            "{mode:?}: formulas fell back to text"
+        );
+
+        let mut opened = Workbook::open_snapshot(
+            &path,
+            WorkbookConfig::interactive().with_formula_plane_mode(mode),
+        )
+        .unwrap();
+        for row in [1, 2, 150, 300] {
+            for col in [2, 3] {
+                assert_eq!(
+                    opened.get_formula("S", row, col),
+                    wb.get_formula("S", row, col),
+                    "{mode:?} at row {row} col {col}"
+                );
+            }
+        }
+        opened.evaluate_all().unwrap();
+        assert_eq!(number(opened.get_value("S", 300, 2)), 601.0, "{mode:?}");
+        assert_eq!(number(opened.get_value("S", 300, 3)), 45150.0, "{mode:?}");
+    }
+}
+
+#[test]
+fn snapshot_keeps_per_row_literals_of_copied_formulas() {
+    for mode in [
+        FormulaPlaneMode::Off,
+        FormulaPlaneMode::AuthoritativeExperimental,
+    ] {
+        let config = WorkbookConfig::interactive().with_formula_plane_mode(mode);
+        let mut wb = Workbook::new_with_config(config);
+        wb.add_sheet("S").unwrap();
+        let values: Vec<Vec<LiteralValue>> = (1..=200)
+            .map(|i| vec![LiteralValue::Number(i as f64)])
+            .collect();
+        wb.set_values("S", 1, 1, &values).unwrap();
+        // The literal steps with the row (affine) in column B and cycles through
+        // three values (dictionary) in column C.
+        let formulas: Vec<Vec<String>> = (1..=200)
+            .map(|i| vec![format!("=A{i}*{i}"), format!("=A{i}+{}", (i % 3) * 10)])
+            .collect();
+        wb.set_formulas("S", 1, 2, &formulas).unwrap();
+        wb.evaluate_all().unwrap();
+
+        let dir = tempfile::tempdir().unwrap();
+        let path = dir.path().join("literals.fzsnap");
+        wb.save_snapshot(&path).unwrap();
+        let mut opened = Workbook::open_snapshot(
+            &path,
+            WorkbookConfig::interactive().with_formula_plane_mode(mode),
+        )
+        .unwrap();
+
+        for (row, texts) in (1..).zip(&formulas) {
+            for (col, text) in (2..).zip(texts) {
+                let expected = formualizer_parse::pretty::pretty_parse_render(text).unwrap();
+                assert_eq!(
+                    opened.get_formula("S", row, col),
+                    Some(expected),
+                    "{mode:?} at row {row} col {col}"
+                );
+            }
+        }
+        opened.evaluate_all().unwrap();
+        for row in [1, 2, 3, 97, 200] {
+            let a = row as f64;
+            assert_eq!(number(opened.get_value("S", row, 2)), a * a, "{mode:?}");
+            let step = ((row % 3) * 10) as f64;
+            assert_eq!(number(opened.get_value("S", row, 3)), a + step, "{mode:?}");
+        }
+    }
+}
+
+#[test]
+fn snapshot_keeps_staged_formulas() {
+    let mut config = WorkbookConfig::interactive();
+    config.eval.defer_graph_building = true;
+    let mut wb = Workbook::new_with_config(config);
+    wb.add_sheet("S").unwrap();
+    wb.set_value("S", 1, 1, LiteralValue::Number(4.0)).unwrap();
+    wb.set_formula("S", 1, 2, "=A1*3").unwrap();
+    assert!(wb.engine().has_staged_formulas());
+
+    let dir = tempfile::tempdir().unwrap();
+    let path = dir.path().join("staged.fzsnap");
+    wb.save_snapshot(&path).unwrap();
+
+    let mut opened = Workbook::open_snapshot(&path, WorkbookConfig::interactive()).unwrap();
+    assert_eq!(opened.get_formula("S", 1, 2), wb.get_formula("S", 1, 2));
+    opened.evaluate_all().unwrap();
+    assert_eq!(number(opened.get_value("S", 1, 2)), 12.0);
+}
+
+#[test]
+fn snapshot_keeps_the_date_system() {
+    let mut config = WorkbookConfig::interactive();
+    config.eval.date_system = DateSystem::Excel1904;
+    let mut wb = Workbook::new_with_config(config);
+    wb.add_sheet("S").unwrap();
+    wb.set_value("S", 1, 1, LiteralValue::Number(42.0)).unwrap();
+
+    let dir = tempfile::tempdir().unwrap();
+    let path = dir.path().join("dates.fzsnap");
+    wb.save_snapshot(&path).unwrap();
+
+    let opened = Workbook::open_snapshot(&path, WorkbookConfig::interactive()).unwrap();
+    assert_eq!(opened.eval_config().date_system, DateSystem::Excel1904);
+    assert_eq!(number(opened.get_value("S", 1, 1)), 42.0);
+}
+
+#[test]
+fn opening_a_non_snapshot_fails_cleanly() {
+    let dir = tempfile::tempdir().unwrap();
+    let path = dir.path().join("not-a-snapshot.fzsnap");
+    std::fs::write(&path, b"definitely not a snapshot file, just some bytes").unwrap();
+    assert!(Workbook::open_snapshot(&path, WorkbookConfig::interactive()).is_err());
+}
+
+#[test]
+fn opening_a_corrupt_snapshot_fails_cleanly() {
+    let mut wb = Workbook::new_with_config(WorkbookConfig::interactive());
+    wb.add_sheet("S").unwrap();
+    wb.set_value("S", 1, 1, LiteralValue::Number(1.0)).unwrap();
+    wb.set_formula("S", 1, 2, "=A1+1").unwrap();
+
+    let dir = tempfile::tempdir().unwrap();
+    let path = dir.path().join("good.fzsnap");
+    wb.save_snapshot(&path).unwrap();
+    let bytes = std::fs::read(&path).unwrap();
+
+    let corrupt = dir.path().join("corrupt.fzsnap");
+    std::fs::write(&corrupt, &bytes[..bytes.len() / 2]).unwrap();
+    assert!(Workbook::open_snapshot(&corrupt, WorkbookConfig::interactive()).is_err());
+
+    // The metadata opens with the date system byte and then the lane file
+    // count; a count far past the file size must not be reserved up front.
+    let trailer = bytes.len() - 24;
+    let meta_start = u64::from_le_bytes(bytes[trailer..trailer + 8].try_into().unwrap()) as usize;
+    for count in [u64::MAX, 1 << 40] {
+        let mut damaged = bytes.clone();
+        damaged[meta_start + 1..meta_start + 9].copy_from_slice(&count.to_le_bytes());
+        std::fs::write(&corrupt, &damaged).unwrap();
+        assert!(Workbook::open_snapshot(&corrupt, WorkbookConfig::interactive()).is_err());
+    }
+}
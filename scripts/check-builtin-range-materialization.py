@@ -0,0 +1,82 @@
+#!/usr/bin/env python3
+"""Flag builtins that copy range arguments into owned values.
+
+Usage:
+    python3 scripts/check-builtin-range-materialization.py [builtins-dir]
+
+Builtins should read range arguments through `ArgumentHandle::range_view()`
+or `ArgumentHandle::for_each_value()`, which borrow the sheet's columnar
+storage. `ArgumentHandle::range()`, `lazy_values_owned()` and row copies out
+of a `RangeView` materialize every referenced cell first. A site that needs
+an owned copy (e.g. to build a result array) is accepted when the flagged
+line, or the line above it, carries an `// owned-range: <reason>` comment.
+Test modules are not checked.
+"""
+
+from __future__ import annotations
+
+import re
+import sys
+from pathlib import Path
+
+DEFAULT_DIR = Path(__file__).resolve().parent.parent / "crates/formualizer-eval/src/builtins"
+MARKER = "// owned-range:"
+PATTERNS = (
+    (re.compile(r"\.range\(\)"), "ArgumentHandle::range() materializes the range"),
+    (re.compile(r"\.lazy_values_owned\("), "lazy_values_owned() clones every cell"),
+    (re.compile(r"\.value_or_range\("), "value_or_range() may box an owned range"),
+    (re.compile(r"\bInMemoryRange\b"), "InMemoryRange holds owned rows"),
+    (re.compile(r"\brow\.to_vec\(\)"), "row copied out of a range view"),
+    (re.compile(r"extend_from_slice\(row\)"), "row copied out of a range view"),
+)
+TEST_MODULE = re.compile(r"^\s*#\[cfg\(test\)\]")
+
+
+def check_file(path: Path) -> list[str]:
+    lines = path.read_text(encoding="utf-8").splitlines()
+    violations = []
+    for idx, line in enumerate(lines):
+        # Test modules sit at the end of builtin files.
+        if TEST_MODULE.match(line):
+            break
+        code = line.split("//", 1)[0]
+        for pattern, reason in PATTERNS:
+            if not pattern.search(code):
+                continue
+            if MARKER in line or (idx > 0 and MARKER in lines[idx - 1]):
+                continue
+            violations.append(f"{path}:{idx + 1}: {reason}\n    {line.strip()}")
+    return violations
+
+
+def main() -> int:
+    if len(sys.argv) > 2:
+        print(
+            "Usage: check-builtin-range-materialization.py [builtins-dir]",
+            file=sys.stderr,
+        )
+        return 2
+
+    root = Path(sys.argv[1]) if len(sys.argv) == 2 else DEFAULT_DIR
+    if not root.is_dir():
+        print(f"builtins directory not found: {root}", file=sys.stderr)
+        return 2
+
+    files = sorted(p for p in root.rglob("*.rs") if p.name not in ("tests.rs", "test.rs"))
+    violations = [v for path in files for v in check_file(path)]
+    if violations:
+        print("[range-materialization] owned range copies found:", file=sys.stderr)
+        for item in violations:
+            print(f"  - {item}", file=sys.stderr)
+        print(
+            f"read through range_view()/for_each_value(), or annotate with `{MARKER} <reason>`",
+            file=sys.stderr,
+        )
+        return 1
+
+    print(f"[range-materialization] {len(files)} builtin files read ranges through views.")
+    return 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())